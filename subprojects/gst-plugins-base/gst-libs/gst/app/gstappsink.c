@@ -60,6 +60,12 @@
  *
  * The eos signal can also be used to be informed when the EOS state is reached
  * to avoid polling.
+ *
+ * Since 1.24, gst_app_sink_try_pull_samples() returns all the queued buffers
+ * that share the same caps and segment at once, in the buffer list of a
+ * single sample, and gst_app_sink_get_pollfd() provides a file descriptor
+ * that can be added to an external event loop to get notified when samples
+ * can be pulled without blocking.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -136,6 +142,11 @@ struct _GstAppSinkPrivate
   Callbacks *callbacks;
 
   GstSample *sample;
+
+  /* Created on demand by gst_app_sink_get_pollfd() */
+  GstPoll *poll;
+  GPollFD pollfd;
+  gboolean poll_ready;
 };
 
 GST_DEBUG_CATEGORY_STATIC (app_sink_debug);
@@ -155,6 +166,7 @@ enum
   SIGNAL_TRY_PULL_PREROLL,
   SIGNAL_TRY_PULL_SAMPLE,
   SIGNAL_TRY_PULL_OBJECT,
+  SIGNAL_TRY_PULL_SAMPLES,
 
   LAST_SIGNAL
 };
@@ -521,6 +533,34 @@ gst_app_sink_class_init (GstAppSinkClass * klass)
       G_STRUCT_OFFSET (GstAppSinkClass, try_pull_object), NULL, NULL, NULL,
       GST_TYPE_MINI_OBJECT, 1, GST_TYPE_CLOCK_TIME);
 
+  /**
+   * GstAppSink::try-pull-samples:
+   * @appsink: the appsink element to emit this signal on
+   * @max_samples: the maximum number of queued buffers to return, or 0 for
+   *     no limit
+   * @timeout: the maximum amount of time to wait for a sample
+   *
+   * This function blocks until a sample or EOS becomes available or the appsink
+   * element is set to the READY/NULL state or the timeout expires.
+   *
+   * It then returns up to @max_samples of the queued buffers in the buffer
+   * list of a single sample. All buffers in the list share the caps and
+   * segment of the sample.
+   *
+   * If an EOS event was received before any buffers or the timeout expires,
+   * this function returns %NULL. Use gst_app_sink_is_eos () to check
+   * for the EOS condition.
+   *
+   * Returns: (nullable): a #GstSample or NULL when the appsink is stopped or EOS or the timeout expires.
+   *
+   * Since: 1.24
+   */
+  gst_app_sink_signals[SIGNAL_TRY_PULL_SAMPLES] =
+      g_signal_new ("try-pull-samples", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_STRUCT_OFFSET (GstAppSinkClass, try_pull_samples), NULL, NULL, NULL,
+      GST_TYPE_SAMPLE, 2, G_TYPE_UINT, GST_TYPE_CLOCK_TIME);
+
   gst_element_class_set_static_metadata (element_class, "AppSink",
       "Generic/Sink", "Allow the application to get access to raw buffer",
       "David Schleef <ds@schleef.org>, Wim Taymans <wim.taymans@gmail.com>");
@@ -545,6 +585,7 @@ gst_app_sink_class_init (GstAppSinkClass * klass)
   klass->try_pull_preroll = gst_app_sink_try_pull_preroll;
   klass->try_pull_sample = gst_app_sink_try_pull_sample;
   klass->try_pull_object = gst_app_sink_try_pull_object;
+  klass->try_pull_samples = gst_app_sink_try_pull_samples;
 }
 
 static void
@@ -610,6 +651,8 @@ gst_app_sink_finalize (GObject * obj)
   g_mutex_clear (&priv->mutex);
   g_cond_clear (&priv->cond);
   gst_queue_array_free (priv->queue);
+  if (priv->poll)
+    gst_poll_free (priv->poll);
 
   G_OBJECT_CLASS (parent_class)->finalize (obj);
 }
@@ -688,6 +731,28 @@ gst_app_sink_get_property (GObject * object, guint prop_id, GValue * value,
   }
 }
 
+/* Keeps the poll fd readable while pulling an object would not block. Called
+ * with the mutex held whenever the queue or the EOS state change. */
+static void
+gst_app_sink_update_pollfd_unlocked (GstAppSink * appsink)
+{
+  GstAppSinkPrivate *priv = appsink->priv;
+  gboolean ready;
+
+  if (!priv->poll)
+    return;
+
+  ready = priv->num_buffers > 0 || priv->num_events > 0 || priv->is_eos;
+  if (ready == priv->poll_ready)
+    return;
+
+  if (ready)
+    gst_poll_write_control (priv->poll);
+  else
+    gst_poll_read_control (priv->poll);
+  priv->poll_ready = ready;
+}
+
 static gboolean
 gst_app_sink_unlock_start (GstBaseSink * bsink)
 {
@@ -732,6 +797,7 @@ gst_app_sink_flush_unlocked (GstAppSink * appsink)
   priv->num_buffers = 0;
   priv->num_events = 0;
   gst_caps_replace (&priv->last_caps, NULL);
+  gst_app_sink_update_pollfd_unlocked (appsink);
   g_cond_signal (&priv->cond);
 }
 
@@ -795,6 +861,7 @@ gst_app_sink_setcaps (GstBaseSink * sink, GstCaps * caps)
   GST_DEBUG_OBJECT (appsink, "receiving CAPS");
   gst_queue_array_push_tail (priv->queue, gst_event_new_caps (caps));
   priv->num_events++;
+  gst_app_sink_update_pollfd_unlocked (appsink);
   if (!priv->preroll_buffer)
     gst_caps_replace (&priv->preroll_caps, caps);
   g_mutex_unlock (&priv->mutex);
@@ -825,6 +892,7 @@ gst_app_sink_event (GstBaseSink * sink, GstEvent * event)
       g_mutex_lock (&priv->mutex);
       GST_DEBUG_OBJECT (appsink, "receiving EOS");
       priv->is_eos = TRUE;
+      gst_app_sink_update_pollfd_unlocked (appsink);
       g_cond_signal (&priv->cond);
       g_mutex_unlock (&priv->mutex);
 
@@ -900,6 +968,7 @@ gst_app_sink_event (GstBaseSink * sink, GstEvent * event)
 
     gst_queue_array_push_tail (priv->queue, gst_event_ref (event));
     priv->num_events++;
+    gst_app_sink_update_pollfd_unlocked (appsink);
 
     g_mutex_unlock (&priv->mutex);
 
@@ -1007,6 +1076,8 @@ dequeue_object (GstAppSink * appsink)
     }
   }
 
+  gst_app_sink_update_pollfd_unlocked (appsink);
+
   return obj;
 }
 
@@ -1092,6 +1163,7 @@ restart:
   /* we need to ref the buffer/list when pushing it in the queue */
   gst_queue_array_push_tail (priv->queue, gst_mini_object_ref (data));
   priv->num_buffers++;
+  gst_app_sink_update_pollfd_unlocked (appsink);
 
   if ((priv->wait_status & APP_WAITING))
     g_cond_signal (&priv->cond);
@@ -1967,6 +2039,231 @@ not_started:
   }
 }
 
+/**
+ * gst_app_sink_pull_samples:
+ * @appsink: a #GstAppSink
+ * @max_samples: the maximum number of queued buffers to return, or 0 for
+ *     no limit
+ *
+ * This function blocks until a sample or EOS becomes available or the appsink
+ * element is set to the READY/NULL state.
+ *
+ * See gst_app_sink_try_pull_samples() for details.
+ *
+ * Returns: (transfer full) (nullable): a #GstSample holding a #GstBufferList
+ *     or NULL when the appsink is stopped or EOS.
+ *          Call gst_sample_unref() after usage.
+ *
+ * Since: 1.24
+ */
+GstSample *
+gst_app_sink_pull_samples (GstAppSink * appsink, guint max_samples)
+{
+  return gst_app_sink_try_pull_samples (appsink, max_samples,
+      GST_CLOCK_TIME_NONE);
+}
+
+static gboolean
+gst_app_sink_head_is_buffer (GstAppSink * appsink)
+{
+  GstMiniObject *obj = gst_queue_array_peek_head (appsink->priv->queue);
+
+  return obj && (GST_IS_BUFFER (obj) || GST_IS_BUFFER_LIST (obj));
+}
+
+/**
+ * gst_app_sink_try_pull_samples:
+ * @appsink: a #GstAppSink
+ * @max_samples: the maximum number of queued buffers to return, or 0 for
+ *     no limit
+ * @timeout: the maximum amount of time to wait for a sample
+ *
+ * This function blocks until a sample or EOS becomes available or the appsink
+ * element is set to the READY/NULL state or the timeout expires.
+ *
+ * It then takes up to @max_samples of the queued buffers (or buffer lists)
+ * at once and returns them in the buffer list of a single sample, stopping
+ * early at the next caps or segment change so that all buffers share the
+ * caps and segment of the sample. Queued events in front of the first buffer
+ * are consumed, just like gst_app_sink_try_pull_sample() does.
+ *
+ * Compared to pulling the buffers one by one, this takes the appsink lock
+ * and wakes up the streaming thread only once per call. As with
+ * gst_app_sink_try_pull_sample(), the sample is reused for the next call if
+ * the application has released it by then.
+ *
+ * If an EOS event was received before any buffers or the timeout expires,
+ * this function returns %NULL. Use gst_app_sink_is_eos () to check for the EOS
+ * condition.
+ *
+ * Returns: (transfer full) (nullable): a #GstSample holding a #GstBufferList
+ *     or NULL when the appsink is stopped or EOS or the timeout expires.
+ *          Call gst_sample_unref() after usage.
+ *
+ * Since: 1.24
+ */
+GstSample *
+gst_app_sink_try_pull_samples (GstAppSink * appsink, guint max_samples,
+    GstClockTime timeout)
+{
+  GstAppSinkPrivate *priv;
+  GstBufferList *list;
+  GstSample *sample;
+  gboolean timeout_valid;
+  gint64 end_time;
+  guint n;
+
+  g_return_val_if_fail (GST_IS_APP_SINK (appsink), NULL);
+
+  timeout_valid = GST_CLOCK_TIME_IS_VALID (timeout);
+
+  if (timeout_valid)
+    end_time =
+        g_get_monotonic_time () + timeout / (GST_SECOND / G_TIME_SPAN_SECOND);
+
+  priv = appsink->priv;
+
+  if (max_samples == 0)
+    max_samples = G_MAXUINT;
+
+  g_mutex_lock (&priv->mutex);
+  gst_buffer_replace (&priv->preroll_buffer, NULL);
+
+  while (TRUE) {
+    GST_DEBUG_OBJECT (appsink, "trying to grab samples");
+    if (!priv->started)
+      goto not_started;
+
+    /* events in front of the first buffer only update caps and segment */
+    while (priv->num_events > 0 && !gst_app_sink_head_is_buffer (appsink))
+      gst_mini_object_unref (dequeue_object (appsink));
+
+    if (priv->num_buffers > 0)
+      break;
+
+    if (priv->is_eos)
+      goto eos;
+
+    /* nothing to return, wait */
+    GST_DEBUG_OBJECT (appsink, "waiting for a sample");
+    priv->wait_status |= APP_WAITING;
+    if (timeout_valid) {
+      if (!g_cond_wait_until (&priv->cond, &priv->mutex, end_time))
+        goto expired;
+    } else {
+      g_cond_wait (&priv->cond, &priv->mutex);
+    }
+    priv->wait_status &= ~APP_WAITING;
+  }
+
+  list = gst_buffer_list_new_sized (MIN (priv->num_buffers, max_samples));
+  for (n = 0; n < max_samples && gst_app_sink_head_is_buffer (appsink); n++) {
+    GstMiniObject *obj = dequeue_object (appsink);
+
+    if (GST_IS_BUFFER (obj)) {
+      gst_buffer_list_add (list, GST_BUFFER_CAST (obj));
+    } else {
+      GstBufferList *l = GST_BUFFER_LIST_CAST (obj);
+      guint i, len = gst_buffer_list_length (l);
+
+      for (i = 0; i < len; i++)
+        gst_buffer_list_add (list, gst_buffer_ref (gst_buffer_list_get (l, i)));
+      gst_buffer_list_unref (l);
+    }
+  }
+  GST_DEBUG_OBJECT (appsink, "pulled %u buffers/lists, %u left", n,
+      priv->num_buffers);
+
+  priv->sample = gst_sample_make_writable (priv->sample);
+  gst_sample_set_buffer (priv->sample, NULL);
+  gst_sample_set_buffer_list (priv->sample, list);
+  gst_buffer_list_unref (list);
+  sample = gst_sample_ref (priv->sample);
+
+  if ((priv->wait_status & STREAM_WAITING))
+    g_cond_signal (&priv->cond);
+
+  g_mutex_unlock (&priv->mutex);
+
+  return sample;
+
+  /* special conditions */
+expired:
+  {
+    GST_DEBUG_OBJECT (appsink, "timeout expired, return NULL");
+    priv->wait_status &= ~APP_WAITING;
+    g_mutex_unlock (&priv->mutex);
+    return NULL;
+  }
+eos:
+  {
+    GST_DEBUG_OBJECT (appsink, "we are EOS, return NULL");
+    g_mutex_unlock (&priv->mutex);
+    return NULL;
+  }
+not_started:
+  {
+    GST_DEBUG_OBJECT (appsink, "we are stopped, return NULL");
+    g_mutex_unlock (&priv->mutex);
+    return NULL;
+  }
+}
+
+/**
+ * gst_app_sink_get_pollfd:
+ * @appsink: a #GstAppSink
+ * @fd: (out): a #GPollFD to fill
+ *
+ * Gets a file descriptor from @appsink which can be used to get notified
+ * about samples being available with functions like g_poll(), and allows
+ * integration into other event loops based on file descriptors.
+ *
+ * The POLLIN / %G_IO_IN event is set while a buffer or a serialized event is
+ * queued or EOS was reached, that is while gst_app_sink_try_pull_object()
+ * with a zero timeout would not return %NULL because of an empty queue.
+ *
+ * Warning: NEVER read or write anything to the returned fd but only use it
+ * for getting notifications via g_poll() or similar and then use the normal
+ * appsink API, e.g. gst_app_sink_try_pull_samples() with a zero timeout.
+ *
+ * Returns: %TRUE if @fd was filled, %FALSE if no file descriptor could be
+ *     created.
+ *
+ * Since: 1.24
+ */
+gboolean
+gst_app_sink_get_pollfd (GstAppSink * appsink, GPollFD * fd)
+{
+  GstAppSinkPrivate *priv;
+
+  g_return_val_if_fail (GST_IS_APP_SINK (appsink), FALSE);
+  g_return_val_if_fail (fd != NULL, FALSE);
+
+  priv = appsink->priv;
+
+  g_mutex_lock (&priv->mutex);
+  if (!priv->poll) {
+    priv->poll = gst_poll_new_timer ();
+    if (!priv->poll)
+      goto no_poll;
+
+    gst_poll_get_read_gpollfd (priv->poll, &priv->pollfd);
+    priv->poll_ready = FALSE;
+    gst_app_sink_update_pollfd_unlocked (appsink);
+  }
+  *fd = priv->pollfd;
+  g_mutex_unlock (&priv->mutex);
+
+  return TRUE;
+
+no_poll:
+  {
+    GST_ERROR_OBJECT (appsink, "could not create a poll fd");
+    g_mutex_unlock (&priv->mutex);
+    return FALSE;
+  }
+}
+
 /**
  * gst_app_sink_set_callbacks: (skip)
  * @appsink: a #GstAppSink
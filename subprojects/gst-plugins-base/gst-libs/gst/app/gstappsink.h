@@ -116,8 +116,17 @@ struct _GstAppSinkClass
    */
   GstMiniObject * (*try_pull_object) (GstAppSink *appsink, GstClockTime timeout);
 
+ /**
+   * GstAppSinkClass::try_pull_samples:
+   *
+   * See #GstAppSink::try-pull-samples: signal.
+   *
+   * Since: 1.24
+   */
+  GstSample *   (*try_pull_samples)  (GstAppSink *appsink, guint max_samples, GstClockTime timeout);
+
   /*< private >*/
-  gpointer     _gst_reserved[GST_PADDING - 3];
+  gpointer     _gst_reserved[GST_PADDING - 4];
 };
 
 GST_APP_API
@@ -180,6 +189,15 @@ GstSample *     gst_app_sink_try_pull_sample  (GstAppSink *appsink, GstClockTime
 GST_APP_API
 GstMiniObject * gst_app_sink_try_pull_object    (GstAppSink *appsink, GstClockTime timeout);
 
+GST_APP_API
+GstSample *     gst_app_sink_pull_samples     (GstAppSink *appsink, guint max_samples);
+
+GST_APP_API
+GstSample *     gst_app_sink_try_pull_samples (GstAppSink *appsink, guint max_samples, GstClockTime timeout);
+
+GST_APP_API
+gboolean        gst_app_sink_get_pollfd       (GstAppSink *appsink, GPollFD *fd);
+
 GST_APP_API
 void            gst_app_sink_set_callbacks    (GstAppSink * appsink,
                                                GstAppSinkCallbacks *callbacks,
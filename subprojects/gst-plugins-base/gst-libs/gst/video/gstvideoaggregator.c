@@ -2138,11 +2138,10 @@ gst_video_aggregator_do_aggregate (GstVideoAggregator * vagg,
   gst_aggregator_selected_samples (agg, GST_BUFFER_PTS (*outbuf),
       GST_BUFFER_DTS (*outbuf), GST_BUFFER_DURATION (*outbuf), NULL);
 
-  /* Convert all the frames the subclass has before aggregating */
-  gst_element_foreach_sink_pad (GST_ELEMENT_CAST (vagg), prepare_frames_start,
-      NULL);
-  gst_element_foreach_sink_pad (GST_ELEMENT_CAST (vagg), prepare_frames_finish,
-      NULL);
+  /* Convert all the frames the subclass has before aggregating, the pads
+   * don't depend on each other so several can be handled at the same time */
+  gst_aggregator_foreach_sink_pad_parallel (agg, prepare_frames_start, NULL);
+  gst_aggregator_foreach_sink_pad_parallel (agg, prepare_frames_finish, NULL);
 
   ret = vagg_klass->aggregate_frames (vagg, *outbuf);
 
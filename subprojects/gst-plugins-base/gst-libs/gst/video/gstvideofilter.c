@@ -28,6 +28,21 @@
  * The videofilter will by default enable QoS on the parent GstBaseTransform
  * to implement frame dropping.
  *
+ * Since 1.24, when consecutive video filters that implement
+ * #GstVideoFilterClass::transform_frame_ip_lines and have #GstVideoFilter:fuse
+ * enabled are linked to each other and negotiated the same format, the first
+ * one runs all of them on each frame a stripe of lines at a time. This keeps
+ * each stripe in the CPU cache while it goes through all the filters instead
+ * of reading and writing the whole frame from memory once per filter. The
+ * following filters then let the frame through untouched.
+ *
+ * Also since 1.24, filters that implement
+ * #GstVideoFilterClass::transform_frame_lines or
+ * #GstVideoFilterClass::transform_frame_ip_lines can have each frame split
+ * into bands of lines that are processed by several threads at once, as
+ * configured with the #GstVideoFilter:max-threads property. Other filters
+ * ignore that property.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -43,14 +58,64 @@
 GST_DEBUG_CATEGORY_STATIC (gst_video_filter_debug);
 #define GST_CAT_DEFAULT gst_video_filter_debug
 
+/* Stripes of this many bytes are processed through all the fused filters
+ * at a time, small enough to stay in L2 cache */
+#define FUSED_STRIPE_SIZE (128 * 1024)
+
+/* Marks the filters that a frame was already processed by */
+#define FUSED_META_NAME "GstVideoFilterFusedMeta"
+
+#define DEFAULT_MAX_THREADS 1
+#define DEFAULT_FUSE FALSE
+
+enum
+{
+  PROP_0,
+  PROP_MAX_THREADS,
+  PROP_FUSE
+};
+
+typedef struct _GstVideoFilterPrivate
+{
+  /* field of the fused meta for this filter */
+  gchar *fused_field;
+
+  /* protected by the object lock */
+  guint max_threads;
+  gboolean fuse;
+
+  /* only used from the streaming thread, freed when stopping */
+  GstVideoParallelRunner *runner;
+  /* the filters linked after this one that it was last fused with, looked
+   * up again when fused_valid is cleared */
+  GPtrArray *fused;
+  gint fused_valid;
+} GstVideoFilterPrivate;
+
+/* One band of lines of a frame, processed by one thread */
+typedef struct
+{
+  GstVideoFilter *filter;
+  /* NULL when processing in place */
+  GstVideoFrame *inframe;
+  GstVideoFrame *outframe;
+  GstVideoFilter **fused;
+  guint n_fused;
+  guint y, height;
+  GstFlowReturn res;
+} GstVideoFilterSlice;
+
 #define gst_video_filter_parent_class parent_class
-G_DEFINE_ABSTRACT_TYPE (GstVideoFilter, gst_video_filter,
+G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (GstVideoFilter, gst_video_filter,
     GST_TYPE_BASE_TRANSFORM);
 
 /* cached quark to avoid contention on the global quark table lock */
 #define META_TAG_VIDEO meta_tag_video_quark
 static GQuark meta_tag_video_quark;
 
+static const gchar *fused_meta_tags[] = { NULL };
+static gint fused_filter_count = 0;
+
 /* Answer the allocation query downstream. */
 static gboolean
 gst_video_filter_propose_allocation (GstBaseTransform * trans,
@@ -205,6 +270,15 @@ gst_video_filter_get_unit_size (GstBaseTransform * btrans, GstCaps * caps,
   return TRUE;
 }
 
+/* Makes the next frame look up the filters to fuse with again */
+static void
+gst_video_filter_invalidate_fused (GstVideoFilter * filter)
+{
+  GstVideoFilterPrivate *priv = gst_video_filter_get_instance_private (filter);
+
+  g_atomic_int_set (&priv->fused_valid, FALSE);
+}
+
 static gboolean
 gst_video_filter_set_caps (GstBaseTransform * trans, GstCaps * incaps,
     GstCaps * outcaps)
@@ -231,13 +305,16 @@ gst_video_filter_set_caps (GstBaseTransform * trans, GstCaps * incaps,
   if (res) {
     filter->in_info = in_info;
     filter->out_info = out_info;
-    if (fclass->transform_frame == NULL)
+    if (fclass->transform_frame == NULL
+        && fclass->transform_frame_lines == NULL)
       gst_base_transform_set_in_place (trans, TRUE);
     if (fclass->transform_frame_ip == NULL)
       GST_BASE_TRANSFORM_CLASS (fclass)->transform_ip_on_passthrough = FALSE;
   }
   filter->negotiated = res;
 
+  gst_video_filter_invalidate_fused (filter);
+
   return res;
 
   /* ERRORS */
@@ -249,6 +326,125 @@ invalid_caps:
   }
 }
 
+/* Bands of lines start at a multiple of this so that they don't share
+ * chroma lines */
+static guint
+gst_video_filter_get_line_align (const GstVideoFrame * frame)
+{
+  const GstVideoFormatInfo *finfo = frame->info.finfo;
+  guint i, align = 1;
+
+  for (i = 0; i < GST_VIDEO_FRAME_N_COMPONENTS (frame); i++)
+    align = MAX (align, 1 << GST_VIDEO_FORMAT_INFO_H_SUB (finfo, i));
+
+  return align;
+}
+
+static void
+gst_video_filter_free_runner (GstVideoFilter * filter)
+{
+  GstVideoFilterPrivate *priv = gst_video_filter_get_instance_private (filter);
+
+  if (priv->runner) {
+    gst_video_parallel_runner_free (priv->runner);
+    priv->runner = NULL;
+  }
+}
+
+/* Returns the number of bands to split a frame of @height lines into and
+ * makes sure the runner has as many threads */
+static guint
+gst_video_filter_get_n_threads (GstVideoFilter * filter, guint height)
+{
+  GstVideoFilterPrivate *priv = gst_video_filter_get_instance_private (filter);
+  guint max_threads, n_threads;
+
+  GST_OBJECT_LOCK (filter);
+  max_threads = priv->max_threads;
+  GST_OBJECT_UNLOCK (filter);
+
+  n_threads = gst_video_parallel_get_n_threads (max_threads, height);
+
+  if (priv->runner && (n_threads == 1
+          || gst_video_parallel_runner_get_n_threads (priv->runner) !=
+          n_threads))
+    gst_video_filter_free_runner (filter);
+  if (n_threads > 1 && priv->runner == NULL) {
+    GST_DEBUG_OBJECT (filter, "processing frames with %u threads", n_threads);
+    priv->runner = gst_video_parallel_runner_new (n_threads, NULL, FALSE);
+  }
+
+  return n_threads;
+}
+
+static GstFlowReturn gst_video_filter_transform_stripes (GstVideoFilter *
+    filter, GstVideoFrame * frame, GstVideoFilter ** fused, guint n_fused,
+    guint y, guint height);
+
+static void
+gst_video_filter_transform_slice (GstVideoFilterSlice * slice)
+{
+  GstVideoFilter *filter = slice->filter;
+  GstVideoFilterClass *fclass = GST_VIDEO_FILTER_GET_CLASS (filter);
+
+  if (slice->height == 0)
+    slice->res = GST_FLOW_OK;
+  else if (slice->n_fused > 0)
+    slice->res = gst_video_filter_transform_stripes (filter, slice->outframe,
+        slice->fused, slice->n_fused, slice->y, slice->height);
+  else if (slice->inframe)
+    slice->res = fclass->transform_frame_lines (filter, slice->inframe,
+        slice->outframe, slice->y, slice->height);
+  else
+    slice->res = fclass->transform_frame_ip_lines (filter, slice->outframe,
+        slice->y, slice->height);
+}
+
+/* Runs the lines vfunc of @filter, or @filter and the @n_fused filters after
+ * it, on all lines of @outframe split into @n_threads bands */
+static GstFlowReturn
+gst_video_filter_transform_slices (GstVideoFilter * filter,
+    GstVideoFrame * inframe, GstVideoFrame * outframe, GstVideoFilter ** fused,
+    guint n_fused, guint n_threads)
+{
+  GstVideoFilterPrivate *priv = gst_video_filter_get_instance_private (filter);
+  GstVideoFilterSlice *slices, **slices_p;
+  guint height = GST_VIDEO_FRAME_HEIGHT (outframe);
+  guint lines, i;
+
+  lines = (height + n_threads - 1) / n_threads;
+  lines = GST_ROUND_UP_N (lines, gst_video_filter_get_line_align (outframe));
+
+  slices = g_newa (GstVideoFilterSlice, n_threads);
+  slices_p = g_newa (GstVideoFilterSlice *, n_threads);
+
+  for (i = 0; i < n_threads; i++) {
+    slices[i].filter = filter;
+    slices[i].inframe = inframe;
+    slices[i].outframe = outframe;
+    slices[i].fused = fused;
+    slices[i].n_fused = n_fused;
+    slices[i].y = MIN (i * lines, height);
+    slices[i].height = MIN (lines, height - slices[i].y);
+    slices[i].res = GST_FLOW_OK;
+    slices_p[i] = &slices[i];
+  }
+
+  if (n_threads > 1)
+    gst_video_parallel_runner_run (priv->runner,
+        (GstVideoParallelFunc) gst_video_filter_transform_slice,
+        (gpointer *) slices_p);
+  else
+    gst_video_filter_transform_slice (&slices[0]);
+
+  for (i = 0; i < n_threads; i++) {
+    if (slices[i].res != GST_FLOW_OK)
+      return slices[i].res;
+  }
+
+  return GST_FLOW_OK;
+}
+
 static GstFlowReturn
 gst_video_filter_transform (GstBaseTransform * trans, GstBuffer * inbuf,
     GstBuffer * outbuf)
@@ -261,8 +457,9 @@ gst_video_filter_transform (GstBaseTransform * trans, GstBuffer * inbuf,
     goto unknown_format;
 
   fclass = GST_VIDEO_FILTER_GET_CLASS (filter);
-  if (fclass->transform_frame) {
+  if (fclass->transform_frame || fclass->transform_frame_lines) {
     GstVideoFrame in_frame, out_frame;
+    guint n_threads = 1;
 
     if (!gst_video_frame_map (&in_frame, &filter->in_info, inbuf,
             GST_MAP_READ | GST_VIDEO_FRAME_MAP_FLAG_NO_REF))
@@ -273,7 +470,16 @@ gst_video_filter_transform (GstBaseTransform * trans, GstBuffer * inbuf,
       gst_video_frame_unmap (&in_frame);
       goto invalid_buffer;
     }
-    res = fclass->transform_frame (filter, &in_frame, &out_frame);
+
+    if (fclass->transform_frame_lines)
+      n_threads = gst_video_filter_get_n_threads (filter,
+          GST_VIDEO_FRAME_HEIGHT (&out_frame));
+
+    if (fclass->transform_frame && n_threads == 1)
+      res = fclass->transform_frame (filter, &in_frame, &out_frame);
+    else
+      res = gst_video_filter_transform_slices (filter, &in_frame, &out_frame,
+          NULL, 0, n_threads);
 
     gst_video_frame_unmap (&out_frame);
     gst_video_frame_unmap (&in_frame);
@@ -299,6 +505,239 @@ invalid_buffer:
   }
 }
 
+static gboolean
+gst_video_filter_get_fuse (GstVideoFilter * filter)
+{
+  GstVideoFilterPrivate *priv = gst_video_filter_get_instance_private (filter);
+  gboolean fuse;
+
+  GST_OBJECT_LOCK (filter);
+  fuse = priv->fuse;
+  GST_OBJECT_UNLOCK (filter);
+
+  return fuse;
+}
+
+/* Whether @filter can be fused after a filter outputting @info */
+static gboolean
+gst_video_filter_can_fuse (GstVideoFilter * filter, const GstVideoInfo * info)
+{
+  GstBaseTransform *trans = GST_BASE_TRANSFORM_CAST (filter);
+
+  return GST_VIDEO_FILTER_GET_CLASS (filter)->transform_frame_ip_lines
+      && gst_video_filter_get_fuse (filter)
+      && filter->negotiated && gst_base_transform_is_in_place (trans)
+      && !gst_base_transform_is_passthrough (trans)
+      && gst_video_info_is_equal (&filter->in_info, info);
+}
+
+/* Returns the sink pad that data pushed on @srcpad ends up in, following
+ * ghost pads into bins and the internal pads of ghost pads out of them */
+static GstPad *
+gst_video_filter_get_next_sink_pad (GstPad * srcpad)
+{
+  GstPad *peer = gst_pad_get_peer (srcpad);
+
+  while (peer && GST_IS_PROXY_PAD (peer)) {
+    GstPad *next;
+
+    if (GST_IS_GHOST_PAD (peer)) {
+      next = gst_ghost_pad_get_target (GST_GHOST_PAD (peer));
+    } else {
+      GstProxyPad *ghost = gst_proxy_pad_get_internal (GST_PROXY_PAD (peer));
+
+      next = NULL;
+      if (ghost) {
+        next = gst_pad_get_peer (GST_PAD_CAST (ghost));
+        gst_object_unref (ghost);
+      }
+    }
+
+    gst_object_unref (peer);
+    peer = next;
+  }
+
+  return peer;
+}
+
+/* Looks up the video filters directly linked after @filter that implement
+ * the in place lines vfunc. Whether they can currently be fused is checked
+ * for each frame. */
+static GPtrArray *
+gst_video_filter_find_fused (GstVideoFilter * filter)
+{
+  GPtrArray *fused = g_ptr_array_new_with_free_func (gst_object_unref);
+  GstPad *srcpad = gst_object_ref (GST_BASE_TRANSFORM_SRC_PAD (filter));
+
+  for (;;) {
+    GstPad *peer = gst_video_filter_get_next_sink_pad (srcpad);
+    GstElement *next = NULL;
+
+    gst_object_unref (srcpad);
+
+    if (peer) {
+      next = gst_pad_get_parent_element (peer);
+      gst_object_unref (peer);
+    }
+
+    if (next == NULL)
+      break;
+
+    if (!GST_IS_VIDEO_FILTER (next)
+        || !GST_VIDEO_FILTER_GET_CLASS (next)->transform_frame_ip_lines) {
+      gst_object_unref (next);
+      break;
+    }
+
+    g_ptr_array_add (fused, next);
+    srcpad = gst_object_ref (GST_BASE_TRANSFORM_SRC_PAD (next));
+  }
+
+  GST_DEBUG_OBJECT (filter, "%u video filters linked after this one",
+      fused->len);
+
+  return fused;
+}
+
+/* Returns how many of the filters linked after @filter can process its
+ * output together with it. The filters are only looked up again after
+ * linking changed downstream, which sends a reconfigure event upstream. */
+static guint
+gst_video_filter_get_n_fused (GstVideoFilter * filter)
+{
+  GstVideoFilterPrivate *priv = gst_video_filter_get_instance_private (filter);
+  guint i;
+
+  if (!gst_video_filter_get_fuse (filter))
+    return 0;
+
+  /* marked valid before looking them up so that changes while doing that
+   * are not lost */
+  if (g_atomic_int_compare_and_exchange (&priv->fused_valid, FALSE, TRUE)) {
+    if (priv->fused)
+      g_ptr_array_unref (priv->fused);
+    priv->fused = gst_video_filter_find_fused (filter);
+  }
+
+  for (i = 0; i < priv->fused->len; i++) {
+    if (!gst_video_filter_can_fuse (g_ptr_array_index (priv->fused, i),
+            &filter->out_info))
+      break;
+  }
+
+  return i;
+}
+
+static void
+gst_video_filter_clear_fused (GstVideoFilter * filter)
+{
+  GstVideoFilterPrivate *priv = gst_video_filter_get_instance_private (filter);
+
+  if (priv->fused) {
+    g_ptr_array_unref (priv->fused);
+    priv->fused = NULL;
+  }
+  g_atomic_int_set (&priv->fused_valid, FALSE);
+}
+
+/* Runs @filter and the @n_fused filters after it on @height lines of @frame
+ * starting at @y, a stripe of lines at a time */
+static GstFlowReturn
+gst_video_filter_transform_stripes (GstVideoFilter * filter,
+    GstVideoFrame * frame, GstVideoFilter ** fused, guint n_fused, guint y,
+    guint height)
+{
+  GstFlowReturn res = GST_FLOW_OK;
+  guint line_size = 0, lines, end = y + height;
+  guint i;
+
+  for (i = 0; i < GST_VIDEO_FRAME_N_PLANES (frame); i++)
+    line_size += ABS (GST_VIDEO_FRAME_PLANE_STRIDE (frame, i));
+
+  lines = MAX (FUSED_STRIPE_SIZE / MAX (line_size, 1), 1);
+  lines = GST_ROUND_UP_N (lines, gst_video_filter_get_line_align (frame));
+
+  for (; y < end && res == GST_FLOW_OK; y += lines) {
+    guint n = MIN (lines, end - y);
+
+    res = GST_VIDEO_FILTER_GET_CLASS (filter)->transform_frame_ip_lines (filter,
+        frame, y, n);
+
+    for (i = 0; i < n_fused && res == GST_FLOW_OK; i++) {
+      res = GST_VIDEO_FILTER_GET_CLASS (fused[i])->transform_frame_ip_lines
+          (fused[i], frame, y, n);
+    }
+  }
+
+  return res;
+}
+
+/* Runs @filter and the @n_fused filters after it on @frame and marks @buf
+ * so that the fused filters let it through */
+static GstFlowReturn
+gst_video_filter_transform_fused (GstVideoFilter * filter,
+    GstVideoFrame * frame, GstBuffer * buf, GstVideoFilter ** fused,
+    guint n_fused, guint n_threads)
+{
+  GstFlowReturn res;
+  GstCustomMeta *meta;
+  GstStructure *s;
+  guint i;
+
+  GST_LOG_OBJECT (filter, "processing %u filters together", n_fused + 1);
+
+  /* sync the controlled properties of the fused filters to this frame */
+  for (i = 0; i < n_fused; i++) {
+    GstBaseTransform *trans = GST_BASE_TRANSFORM_CAST (fused[i]);
+    GstBaseTransformClass *tclass = GST_BASE_TRANSFORM_GET_CLASS (trans);
+
+    if (tclass->before_transform)
+      tclass->before_transform (trans, buf);
+  }
+
+  res = gst_video_filter_transform_slices (filter, NULL, frame, fused,
+      n_fused, n_threads);
+  if (res != GST_FLOW_OK)
+    return res;
+
+  meta = gst_buffer_get_custom_meta (buf, FUSED_META_NAME);
+  if (meta == NULL)
+    meta = gst_buffer_add_custom_meta (buf, FUSED_META_NAME);
+  s = gst_custom_meta_get_structure (meta);
+  for (i = 0; i < n_fused; i++) {
+    GstVideoFilterPrivate *priv =
+        gst_video_filter_get_instance_private (fused[i]);
+
+    gst_structure_set (s, priv->fused_field, G_TYPE_BOOLEAN, TRUE, NULL);
+  }
+
+  return GST_FLOW_OK;
+}
+
+/* Whether @buf was already processed by @filter as part of the filters
+ * before it, in which case the mark is removed */
+static gboolean
+gst_video_filter_take_fused (GstVideoFilter * filter, GstBuffer * buf)
+{
+  GstVideoFilterPrivate *priv = gst_video_filter_get_instance_private (filter);
+  GstCustomMeta *meta;
+  GstStructure *s;
+
+  meta = gst_buffer_get_custom_meta (buf, FUSED_META_NAME);
+  if (G_LIKELY (meta == NULL))
+    return FALSE;
+
+  s = gst_custom_meta_get_structure (meta);
+  if (!gst_structure_has_field (s, priv->fused_field))
+    return FALSE;
+
+  gst_structure_remove_field (s, priv->fused_field);
+  if (gst_structure_n_fields (s) == 0)
+    gst_buffer_remove_meta (buf, (GstMeta *) meta);
+
+  return TRUE;
+}
+
 static GstFlowReturn
 gst_video_filter_transform_ip (GstBaseTransform * trans, GstBuffer * buf)
 {
@@ -310,19 +749,48 @@ gst_video_filter_transform_ip (GstBaseTransform * trans, GstBuffer * buf)
     goto unknown_format;
 
   fclass = GST_VIDEO_FILTER_GET_CLASS (filter);
-  if (fclass->transform_frame_ip) {
+  if (fclass->transform_frame_ip_lines
+      && !gst_base_transform_is_passthrough (trans)
+      && gst_video_filter_take_fused (filter, buf)) {
+    GST_LOG_OBJECT (filter, "frame already processed");
+    return GST_FLOW_OK;
+  }
+
+  if (fclass->transform_frame_ip || fclass->transform_frame_ip_lines) {
+    GstVideoFilterPrivate *priv =
+        gst_video_filter_get_instance_private (filter);
     GstVideoFrame frame;
     GstMapFlags flags;
+    guint n_fused = 0;
+    gboolean lines = FALSE;
+    guint n_threads = 1;
 
     flags = GST_MAP_READ | GST_VIDEO_FRAME_MAP_FLAG_NO_REF;
 
-    if (!gst_base_transform_is_passthrough (trans))
+    if (!gst_base_transform_is_passthrough (trans)) {
       flags |= GST_MAP_WRITE;
+      if (fclass->transform_frame_ip_lines) {
+        n_fused = gst_video_filter_get_n_fused (filter);
+        lines = TRUE;
+      }
+    }
 
     if (!gst_video_frame_map (&frame, &filter->in_info, buf, flags))
       goto invalid_buffer;
 
-    res = fclass->transform_frame_ip (filter, &frame);
+    if (lines)
+      n_threads = gst_video_filter_get_n_threads (filter,
+          GST_VIDEO_FRAME_HEIGHT (&frame));
+
+    if (n_fused > 0) {
+      res = gst_video_filter_transform_fused (filter, &frame, buf,
+          (GstVideoFilter **) priv->fused->pdata, n_fused, n_threads);
+    } else if (fclass->transform_frame_ip && n_threads == 1) {
+      res = fclass->transform_frame_ip (filter, &frame);
+    } else {
+      res = gst_video_filter_transform_slices (filter, NULL, &frame, NULL, 0,
+          n_threads);
+    }
 
     gst_video_frame_unmap (&frame);
   } else {
@@ -347,6 +815,58 @@ invalid_buffer:
   }
 }
 
+static GstFlowReturn
+gst_video_filter_prepare_output_buffer (GstBaseTransform * trans,
+    GstBuffer * inbuf, GstBuffer ** outbuf)
+{
+  GstFlowReturn res;
+
+  res = GST_BASE_TRANSFORM_CLASS (parent_class)->prepare_output_buffer (trans,
+      inbuf, outbuf);
+
+  /* a filter before this one may have processed the frame for it before it
+   * switched to passthrough, don't let the mark through */
+  if (res == GST_FLOW_OK && *outbuf == inbuf
+      && gst_base_transform_is_passthrough (trans)
+      && G_UNLIKELY (gst_buffer_get_custom_meta (inbuf, FUSED_META_NAME))) {
+    if (!gst_buffer_is_writable (inbuf))
+      *outbuf = gst_buffer_copy (inbuf);
+    gst_video_filter_take_fused (GST_VIDEO_FILTER_CAST (trans), *outbuf);
+  }
+
+  return res;
+}
+
+static gboolean
+gst_video_filter_src_event (GstBaseTransform * trans, GstEvent * event)
+{
+  /* sent upstream when linking changed downstream */
+  if (GST_EVENT_TYPE (event) == GST_EVENT_RECONFIGURE)
+    gst_video_filter_invalidate_fused (GST_VIDEO_FILTER_CAST (trans));
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->src_event (trans, event);
+}
+
+static GstStateChangeReturn
+gst_video_filter_change_state (GstElement * element, GstStateChange transition)
+{
+  GstStateChangeReturn ret;
+
+  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+
+  switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      /* don't keep the filters linked after this one alive */
+      gst_video_filter_clear_fused (GST_VIDEO_FILTER_CAST (element));
+      gst_video_filter_free_runner (GST_VIDEO_FILTER_CAST (element));
+      break;
+    default:
+      break;
+  }
+
+  return ret;
+}
+
 static gboolean
 gst_video_filter_transform_meta (GstBaseTransform * trans, GstBuffer * outbuf,
     GstMeta * meta, GstBuffer * inbuf)
@@ -364,15 +884,129 @@ gst_video_filter_transform_meta (GstBaseTransform * trans, GstBuffer * outbuf,
       meta, inbuf);
 }
 
+static void
+gst_video_filter_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstVideoFilterPrivate *priv =
+      gst_video_filter_get_instance_private (GST_VIDEO_FILTER (object));
+
+  switch (prop_id) {
+    case PROP_MAX_THREADS:
+      GST_OBJECT_LOCK (object);
+      priv->max_threads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (object);
+      break;
+    case PROP_FUSE:
+      GST_OBJECT_LOCK (object);
+      priv->fuse = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (object);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_video_filter_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstVideoFilterPrivate *priv =
+      gst_video_filter_get_instance_private (GST_VIDEO_FILTER (object));
+
+  switch (prop_id) {
+    case PROP_MAX_THREADS:
+      GST_OBJECT_LOCK (object);
+      g_value_set_uint (value, priv->max_threads);
+      GST_OBJECT_UNLOCK (object);
+      break;
+    case PROP_FUSE:
+      GST_OBJECT_LOCK (object);
+      g_value_set_boolean (value, priv->fuse);
+      GST_OBJECT_UNLOCK (object);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_video_filter_finalize (GObject * object)
+{
+  GstVideoFilterPrivate *priv =
+      gst_video_filter_get_instance_private (GST_VIDEO_FILTER (object));
+
+  g_free (priv->fused_field);
+  if (priv->fused)
+    g_ptr_array_unref (priv->fused);
+  gst_video_filter_free_runner (GST_VIDEO_FILTER (object));
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
 static void
 gst_video_filter_class_init (GstVideoFilterClass * g_class)
 {
+  GObjectClass *gobject_class;
+  GstElementClass *element_class;
   GstBaseTransformClass *trans_class;
   GstVideoFilterClass *klass;
 
   klass = (GstVideoFilterClass *) g_class;
+  gobject_class = (GObjectClass *) klass;
+  element_class = (GstElementClass *) klass;
   trans_class = (GstBaseTransformClass *) klass;
 
+  gobject_class->set_property = gst_video_filter_set_property;
+  gobject_class->get_property = gst_video_filter_get_property;
+  gobject_class->finalize = gst_video_filter_finalize;
+
+  element_class->change_state =
+      GST_DEBUG_FUNCPTR (gst_video_filter_change_state);
+
+  /**
+   * GstVideoFilter:max-threads:
+   *
+   * Maximum number of threads used to process a frame, 0 for one per CPU.
+   * Each thread gets at least #GST_VIDEO_PARALLEL_MIN_LINES lines.
+   *
+   * This only has an effect on filters that implement
+   * #GstVideoFilterClass::transform_frame_lines or
+   * #GstVideoFilterClass::transform_frame_ip_lines. All other filters ignore
+   * it, including ones with their own threading settings such as the
+   * `n-threads` property of videoconvert.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_THREADS,
+      g_param_spec_uint ("max-threads", "Maximum Threads",
+          "Maximum number of threads used to process a frame, "
+          "0 for one per CPU", 0, G_MAXUINT, DEFAULT_MAX_THREADS,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstVideoFilter:fuse:
+   *
+   * Process frames together with the video filters directly linked after
+   * this one that have this enabled too, see
+   * #GstVideoFilterClass::transform_frame_ip_lines. This filter then
+   * processes each frame for all of them before pushing it, so pad probes
+   * and other elements looking at the data between the fused filters see
+   * it already processed by all of them. Only used by filters that
+   * implement #GstVideoFilterClass::transform_frame_ip_lines.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_FUSE,
+      g_param_spec_boolean ("fuse", "Fuse",
+          "Process frames together with the directly linked video filters "
+          "that have this enabled too", DEFAULT_FUSE,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
   trans_class->set_caps = GST_DEBUG_FUNCPTR (gst_video_filter_set_caps);
   trans_class->propose_allocation =
       GST_DEBUG_FUNCPTR (gst_video_filter_propose_allocation);
@@ -384,6 +1018,9 @@ gst_video_filter_class_init (GstVideoFilterClass * g_class)
       GST_DEBUG_FUNCPTR (gst_video_filter_get_unit_size);
   trans_class->transform = GST_DEBUG_FUNCPTR (gst_video_filter_transform);
   trans_class->transform_ip = GST_DEBUG_FUNCPTR (gst_video_filter_transform_ip);
+  trans_class->prepare_output_buffer =
+      GST_DEBUG_FUNCPTR (gst_video_filter_prepare_output_buffer);
+  trans_class->src_event = GST_DEBUG_FUNCPTR (gst_video_filter_src_event);
   trans_class->transform_meta =
       GST_DEBUG_FUNCPTR (gst_video_filter_transform_meta);
 
@@ -391,16 +1028,25 @@ gst_video_filter_class_init (GstVideoFilterClass * g_class)
       "videofilter");
 
   meta_tag_video_quark = g_quark_from_static_string (GST_META_TAG_VIDEO_STR);
+
+  gst_meta_register_custom (FUSED_META_NAME, fused_meta_tags, NULL, NULL,
+      NULL);
 }
 
 static void
 gst_video_filter_init (GstVideoFilter * instance)
 {
   GstVideoFilter *videofilter = GST_VIDEO_FILTER (instance);
+  GstVideoFilterPrivate *priv =
+      gst_video_filter_get_instance_private (videofilter);
 
   GST_DEBUG_OBJECT (videofilter, "gst_video_filter_init");
 
   videofilter->negotiated = FALSE;
+  priv->max_threads = DEFAULT_MAX_THREADS;
+  priv->fuse = DEFAULT_FUSE;
+  priv->fused_field = g_strdup_printf ("filter-%d",
+      g_atomic_int_add (&fused_filter_count, 1));
   /* enable QoS */
   gst_base_transform_set_qos_enabled (GST_BASE_TRANSFORM (videofilter), TRUE);
 }
@@ -60,6 +60,17 @@ struct _GstVideoFilter {
  * @set_info: function to be called with the negotiated caps and video infos
  * @transform_frame: transform a video frame
  * @transform_frame_ip: transform a video frame in place
+ * @transform_frame_ip_lines: transform @height lines of a video frame in
+ *   place, starting at line @y. Chroma lines are those covered by the luma
+ *   lines. Filters that implement this and are directly linked to each other
+ *   process frames together, a few lines at a time through all of them, so
+ *   that the lines stay in the CPU cache. This can be called from several
+ *   threads at once for different lines, see #GstVideoFilter:max-threads.
+ *   Since: 1.24
+ * @transform_frame_lines: transform the input frame into @height lines of
+ *   the output frame, starting at output line @y. Chroma lines are those
+ *   covered by the luma lines. This can be called from several threads at
+ *   once for different lines, see #GstVideoFilter:max-threads. Since: 1.24
  *
  * The video filter class structure.
  */
@@ -75,8 +86,17 @@ struct _GstVideoFilterClass {
                                        GstVideoFrame *inframe, GstVideoFrame *outframe);
   GstFlowReturn (*transform_frame_ip) (GstVideoFilter *trans, GstVideoFrame *frame);
 
+  GstFlowReturn (*transform_frame_ip_lines) (GstVideoFilter *filter,
+                                             GstVideoFrame *frame,
+                                             guint y, guint height);
+
+  GstFlowReturn (*transform_frame_lines) (GstVideoFilter *filter,
+                                          GstVideoFrame *inframe,
+                                          GstVideoFrame *outframe,
+                                          guint y, guint height);
+
   /*< private >*/
-  gpointer _gst_reserved[GST_PADDING];
+  gpointer _gst_reserved[GST_PADDING-2];
 };
 
 GST_VIDEO_API
@@ -122,175 +122,6 @@ ensure_debug_category (void)
 #define ensure_debug_category() /* NOOP */
 #endif /* GST_DISABLE_GST_DEBUG */
 
-typedef void (*GstParallelizedTaskFunc) (gpointer user_data);
-
-typedef struct _GstParallelizedTaskRunner GstParallelizedTaskRunner;
-typedef struct _GstParallelizedWorkItem GstParallelizedWorkItem;
-
-struct _GstParallelizedWorkItem
-{
-  GstParallelizedTaskRunner *self;
-  GstParallelizedTaskFunc func;
-  gpointer user_data;
-};
-
-struct _GstParallelizedTaskRunner
-{
-  GstTaskPool *pool;
-  gboolean own_pool;
-  guint n_threads;
-
-  GstQueueArray *tasks;
-  GstQueueArray *work_items;
-
-  GMutex lock;
-
-  gboolean async_tasks;
-};
-
-static void
-gst_parallelized_task_thread_func (gpointer data)
-{
-  GstParallelizedTaskRunner *runner = data;
-  GstParallelizedWorkItem *work_item;
-
-  g_mutex_lock (&runner->lock);
-  work_item = gst_queue_array_pop_head (runner->work_items);
-  g_mutex_unlock (&runner->lock);
-
-  g_assert (work_item != NULL);
-  g_assert (work_item->func != NULL);
-
-
-  work_item->func (work_item->user_data);
-  if (runner->async_tasks)
-    g_free (work_item);
-}
-
-static void
-gst_parallelized_task_runner_join (GstParallelizedTaskRunner * self)
-{
-  gboolean joined = FALSE;
-
-  while (!joined) {
-    g_mutex_lock (&self->lock);
-    if (!(joined = gst_queue_array_is_empty (self->tasks))) {
-      gpointer task = gst_queue_array_pop_head (self->tasks);
-      g_mutex_unlock (&self->lock);
-      gst_task_pool_join (self->pool, task);
-    } else {
-      g_mutex_unlock (&self->lock);
-    }
-  }
-}
-
-static void
-gst_parallelized_task_runner_free (GstParallelizedTaskRunner * self)
-{
-  gst_parallelized_task_runner_join (self);
-
-  gst_queue_array_free (self->work_items);
-  gst_queue_array_free (self->tasks);
-  if (self->own_pool)
-    gst_task_pool_cleanup (self->pool);
-  gst_object_unref (self->pool);
-  g_mutex_clear (&self->lock);
-  g_free (self);
-}
-
-static GstParallelizedTaskRunner *
-gst_parallelized_task_runner_new (guint n_threads, GstTaskPool * pool,
-    gboolean async_tasks)
-{
-  GstParallelizedTaskRunner *self;
-
-  if (n_threads == 0)
-    n_threads = g_get_num_processors ();
-
-  self = g_new0 (GstParallelizedTaskRunner, 1);
-
-  if (pool) {
-    self->pool = g_object_ref (pool);
-    self->own_pool = FALSE;
-
-    /* No reason to split up the work between more threads than the
-     * pool can spawn */
-    if (GST_IS_SHARED_TASK_POOL (pool))
-      n_threads =
-          MIN (n_threads,
-          gst_shared_task_pool_get_max_threads (GST_SHARED_TASK_POOL (pool)));
-  } else {
-    self->pool = gst_shared_task_pool_new ();
-    self->own_pool = TRUE;
-    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (self->pool),
-        n_threads);
-    gst_task_pool_prepare (self->pool, NULL);
-  }
-
-  self->tasks = gst_queue_array_new (n_threads);
-  self->work_items = gst_queue_array_new (n_threads);
-
-  self->n_threads = n_threads;
-
-  g_mutex_init (&self->lock);
-
-  /* Set when scheduling a job */
-  self->async_tasks = async_tasks;
-
-  return self;
-}
-
-static void
-gst_parallelized_task_runner_finish (GstParallelizedTaskRunner * self)
-{
-  gst_parallelized_task_runner_join (self);
-}
-
-static void
-gst_parallelized_task_runner_run (GstParallelizedTaskRunner * self,
-    GstParallelizedTaskFunc func, gpointer * task_data)
-{
-  guint n_threads = self->n_threads;
-
-  if (n_threads > 1 || self->async_tasks) {
-    guint i = 0;
-    g_mutex_lock (&self->lock);
-    if (!self->async_tasks) {
-      /* if not async, perform one of the functions in the current thread */
-      i = 1;
-    }
-    for (; i < n_threads; i++) {
-      gpointer task;
-      GstParallelizedWorkItem *work_item;
-
-      if (!self->async_tasks)
-        work_item = g_newa (GstParallelizedWorkItem, 1);
-      else
-        work_item = g_new0 (GstParallelizedWorkItem, 1);
-
-      work_item->self = self;
-      work_item->func = func;
-      work_item->user_data = task_data[i];
-      gst_queue_array_push_tail (self->work_items, work_item);
-
-      task =
-          gst_task_pool_push (self->pool, gst_parallelized_task_thread_func,
-          self, NULL);
-
-      /* The return value of push() is unfortunately nullable, and we can't deal with that */
-      g_assert (task != NULL);
-      gst_queue_array_push_tail (self->tasks, task);
-    }
-    g_mutex_unlock (&self->lock);
-  }
-
-  if (!self->async_tasks) {
-    func (task_data[0]);
-
-    gst_parallelized_task_runner_finish (self);
-  }
-}
-
 typedef struct _GstLineCache GstLineCache;
 
 #define SCALE    (8)
@@ -372,7 +203,9 @@ struct _GstVideoConverter
 
   GstStructure *config;
 
-  GstParallelizedTaskRunner *conversion_runner;
+  GstVideoParallelRunner *conversion_runner;
+  guint n_threads;
+  gboolean async_tasks;
 
   guint16 **tmpline;
 
@@ -2137,7 +1970,7 @@ setup_allocators (GstVideoConverter * convert)
   width = MAX (convert->in_maxwidth, convert->out_maxwidth);
   width += convert->out_x;
 
-  for (i = 0; i < convert->conversion_runner->n_threads; i++) {
+  for (i = 0; i < convert->n_threads; i++) {
     /* start with using dest lines if we can directly write into it */
     if (convert->identity_pack) {
       alloc_line = get_dest_line;
@@ -2461,17 +2294,15 @@ gst_video_converter_new_with_pool (const GstVideoInfo * in_info,
   }
 
   n_threads = get_opt_uint (convert, GST_VIDEO_CONVERTER_OPT_THREADS, 1);
-  if (n_threads == 0 || n_threads > g_get_num_processors ())
-    n_threads = g_get_num_processors ();
-  /* Magic number of 200 lines */
-  if (MAX (convert->out_height, convert->in_height) / n_threads < 200)
-    n_threads = (MAX (convert->out_height, convert->in_height) + 199) / 200;
-  if (n_threads < 1)
-    n_threads = 1;
+  n_threads = gst_video_parallel_get_n_threads (n_threads,
+      MAX (convert->out_height, convert->in_height));
 
   async_tasks = GET_OPT_ASYNC_TASKS (convert);
+  convert->async_tasks = async_tasks;
   convert->conversion_runner =
-      gst_parallelized_task_runner_new (n_threads, pool, async_tasks);
+      gst_video_parallel_runner_new (n_threads, pool, async_tasks);
+  convert->n_threads =
+      gst_video_parallel_runner_get_n_threads (convert->conversion_runner);
 
   if (video_converter_lookup_fastpath (convert))
     goto done;
@@ -2610,7 +2441,7 @@ gst_video_converter_free (GstVideoConverter * convert)
   }
 //CRESTRON_CHANGE_END
 
-  for (i = 0; i < convert->conversion_runner->n_threads; i++) {
+  for (i = 0; i < convert->n_threads; i++) {
     if (convert->upsample_p && convert->upsample_p[i])
       gst_video_chroma_resample_free (convert->upsample_p[i]);
     if (convert->upsample_i && convert->upsample_i[i])
@@ -2672,7 +2503,7 @@ gst_video_converter_free (GstVideoConverter * convert)
   g_free (convert->gamma_enc.gamma_table);
 
   if (convert->tmpline) {
-    for (i = 0; i < convert->conversion_runner->n_threads; i++)
+    for (i = 0; i < convert->n_threads; i++)
       g_free (convert->tmpline[i]);
     g_free (convert->tmpline);
   }
@@ -2683,7 +2514,7 @@ gst_video_converter_free (GstVideoConverter * convert)
     gst_structure_free (convert->config);
 
   for (i = 0; i < 4; i++) {
-    for (j = 0; j < convert->conversion_runner->n_threads; j++) {
+    for (j = 0; j < convert->n_threads; j++) {
       if (convert->fv_scaler[i].scaler)
         gst_video_scaler_free (convert->fv_scaler[i].scaler[j]);
       if (convert->fh_scaler[i].scaler)
@@ -2694,7 +2525,7 @@ gst_video_converter_free (GstVideoConverter * convert)
   }
 
   if (convert->conversion_runner)
-    gst_parallelized_task_runner_free (convert->conversion_runner);
+    gst_video_parallel_runner_free (convert->conversion_runner);
 
   clear_matrix_data (&convert->to_RGB_matrix);
   clear_matrix_data (&convert->convert_matrix);
@@ -2830,9 +2661,9 @@ gst_video_converter_frame_finish (GstVideoConverter * convert)
 {
   g_return_if_fail (convert);
   g_return_if_fail (convert->conversion_runner);
-  g_return_if_fail (convert->conversion_runner->async_tasks);
+  g_return_if_fail (convert->async_tasks);
 
-  gst_parallelized_task_runner_finish (convert->conversion_runner);
+  gst_video_parallel_runner_finish (convert->conversion_runner);
 }
 
 static void
@@ -3339,7 +3170,7 @@ video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
       PACK_FRAME (dest, convert->borderline, i, out_maxwidth);
   }
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (ConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3364,8 +3195,8 @@ video_converter_generic (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_generic_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_generic_task, (gpointer) tasks_p);
 
   if (convert->borderline) {
     for (i = out_y + out_height; i < out_maxheight; i++)
@@ -3450,7 +3281,7 @@ convert_I420_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3472,8 +3303,8 @@ convert_I420_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_I420_YUY2_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_I420_YUY2_task, (gpointer) tasks_p);
 
   /* now handle last lines. For interlaced these are up to 3 */
   if (h2 != height) {
@@ -3527,7 +3358,7 @@ convert_I420_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3549,8 +3380,8 @@ convert_I420_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_I420_UYVY_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_I420_UYVY_task, (gpointer) tasks_p);
 
   /* now handle last lines. For interlaced these are up to 3 */
   if (h2 != height) {
@@ -3729,7 +3560,7 @@ convert_I420_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
     h2 = GST_ROUND_DOWN_2 (height);
 
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3752,8 +3583,8 @@ convert_I420_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_I420_AYUV_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_I420_AYUV_task, (gpointer) tasks_p);
 
   /* now handle last lines. For interlaced these are up to 3 */
   if (h2 != height) {
@@ -3884,7 +3715,7 @@ convert_I420_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3906,8 +3737,8 @@ convert_I420_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_I420_v210_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_I420_v210_task, (gpointer) tasks_p);
 
   /* now handle last lines. For interlaced these are up to 3 */
   if (h2 != height) {
@@ -3967,7 +3798,7 @@ convert_YUY2_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -3989,8 +3820,8 @@ convert_YUY2_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_YUY2_I420_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_YUY2_I420_task, (gpointer) tasks_p);
 
   /* now handle last lines. For interlaced these are up to 3 */
   if (h2 != height) {
@@ -4131,7 +3962,7 @@ convert_v210_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4153,8 +3984,8 @@ convert_v210_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_v210_I420_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_v210_I420_task, (gpointer) tasks_p);
 
   /* now handle last lines. For interlaced these are up to 3 */
   if (h2 != height) {
@@ -4208,7 +4039,7 @@ convert_YUY2_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4231,8 +4062,8 @@ convert_YUY2_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_YUY2_AYUV_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_YUY2_AYUV_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -4315,7 +4146,7 @@ convert_YUY2_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4337,8 +4168,8 @@ convert_YUY2_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_YUY2_v210_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_YUY2_v210_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -4374,7 +4205,7 @@ convert_YUY2_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x >> 1;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4400,8 +4231,8 @@ convert_YUY2_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_YUY2_Y42B_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_YUY2_Y42B_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -4439,7 +4270,7 @@ convert_YUY2_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4465,8 +4296,8 @@ convert_YUY2_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_YUY2_Y444_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_YUY2_Y444_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -4563,7 +4394,7 @@ convert_v210_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x >> 1;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4589,8 +4420,8 @@ convert_v210_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_v210_Y42B_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_v210_Y42B_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -4638,7 +4469,7 @@ convert_UYVY_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
   else
     h2 = GST_ROUND_DOWN_2 (height);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4660,8 +4491,8 @@ convert_UYVY_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_UYVY_I420_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_UYVY_I420_task, (gpointer) tasks_p);
 
   /* now handle last lines. For interlaced these are up to 3 */
   if (h2 != height) {
@@ -4698,7 +4529,7 @@ convert_UYVY_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4721,8 +4552,8 @@ convert_UYVY_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_UYVY_AYUV_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_UYVY_AYUV_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -4805,7 +4636,7 @@ convert_UYVY_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4827,8 +4658,8 @@ convert_UYVY_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_UYVY_v210_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_UYVY_v210_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -4858,7 +4689,7 @@ convert_UYVY_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4880,8 +4711,8 @@ convert_UYVY_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_UYVY_YUY2_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_UYVY_YUY2_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -4971,7 +4802,7 @@ convert_v210_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -4993,8 +4824,8 @@ convert_v210_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_v210_UYVY_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_v210_UYVY_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5084,7 +4915,7 @@ convert_v210_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5106,8 +4937,8 @@ convert_v210_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_v210_YUY2_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_v210_YUY2_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5143,7 +4974,7 @@ convert_UYVY_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x >> 1;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5169,8 +5000,8 @@ convert_UYVY_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_UYVY_Y42B_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_UYVY_Y42B_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5208,7 +5039,7 @@ convert_UYVY_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5234,8 +5065,8 @@ convert_UYVY_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_UYVY_Y444_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_UYVY_Y444_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5264,7 +5095,7 @@ convert_UYVY_GRAY8 (GstVideoConverter * convert, const GstVideoFrame * src,
   s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
   d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5286,8 +5117,8 @@ convert_UYVY_GRAY8 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_UYVY_GRAY8_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_UYVY_GRAY8_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5333,7 +5164,7 @@ convert_AYUV_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
 
   /* only for even width/height */
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5361,8 +5192,8 @@ convert_AYUV_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_I420_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_AYUV_I420_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5393,7 +5224,7 @@ convert_AYUV_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
   /* only for even width */
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5415,8 +5246,8 @@ convert_AYUV_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_YUY2_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_AYUV_YUY2_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5447,7 +5278,7 @@ convert_AYUV_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
   /* only for even width */
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5469,8 +5300,8 @@ convert_AYUV_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_UYVY_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_AYUV_UYVY_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5507,7 +5338,7 @@ convert_AYUV_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
   dv += convert->out_x >> 1;
 
   /* only works for even width */
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5533,8 +5364,8 @@ convert_AYUV_Y42B (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_Y42B_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_AYUV_Y42B_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5570,7 +5401,7 @@ convert_AYUV_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
   dv = FRAME_GET_V_LINE (dest, convert->out_y);
   dv += convert->out_x;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5596,8 +5427,8 @@ convert_AYUV_Y444 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_Y444_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_AYUV_Y444_task, (gpointer) tasks_p);
   convert_fill_border (convert, dest);
 }
 
@@ -5633,7 +5464,7 @@ convert_Y42B_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5659,8 +5490,8 @@ convert_Y42B_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_Y42B_YUY2_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_Y42B_YUY2_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5697,7 +5528,7 @@ convert_Y42B_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5723,8 +5554,8 @@ convert_Y42B_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_Y42B_UYVY_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_Y42B_UYVY_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5764,7 +5595,7 @@ convert_Y42B_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   d += convert->out_x * 4;
 
   /* only for even width */
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5791,8 +5622,8 @@ convert_Y42B_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_Y42B_AYUV_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_Y42B_AYUV_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5882,7 +5713,7 @@ convert_Y42B_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
   sv = FRAME_GET_V_LINE (src, convert->in_y);
   sv += convert->in_x >> 1;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5908,8 +5739,8 @@ convert_Y42B_v210 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_Y42B_v210_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_Y42B_v210_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -5946,7 +5777,7 @@ convert_Y444_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -5972,8 +5803,8 @@ convert_Y444_YUY2 (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_Y444_YUY2_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_Y444_YUY2_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6010,7 +5841,7 @@ convert_Y444_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (GST_ROUND_UP_2 (convert->out_x) * 2);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6036,8 +5867,8 @@ convert_Y444_UYVY (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_Y444_UYVY_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_Y444_UYVY_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6076,7 +5907,7 @@ convert_Y444_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += convert->out_x * 4;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6103,8 +5934,8 @@ convert_Y444_AYUV (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_Y444_AYUV_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_Y444_AYUV_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6138,7 +5969,7 @@ convert_AYUV_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6161,8 +5992,8 @@ convert_AYUV_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_ARGB_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_AYUV_ARGB_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6195,7 +6026,7 @@ convert_AYUV_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6218,8 +6049,8 @@ convert_AYUV_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_BGRA_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_AYUV_BGRA_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6252,7 +6083,7 @@ convert_AYUV_ABGR (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6275,8 +6106,8 @@ convert_AYUV_ABGR (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_ABGR_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_AYUV_ABGR_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6309,7 +6140,7 @@ convert_AYUV_RGBA (GstVideoConverter * convert, const GstVideoFrame * src,
   d = FRAME_GET_LINE (dest, convert->out_y);
   d += (convert->out_x * 4);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertPlaneTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6332,8 +6163,8 @@ convert_AYUV_RGBA (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_AYUV_RGBA_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_AYUV_RGBA_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6383,7 +6214,7 @@ convert_I420_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
   gint n_threads;
   gint lines_per_thread;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6409,8 +6240,8 @@ convert_I420_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_I420_BGRA_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_I420_BGRA_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6459,7 +6290,7 @@ convert_I420_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
   gint n_threads;
   gint lines_per_thread;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6485,8 +6316,8 @@ convert_I420_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_I420_ARGB_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_I420_ARGB_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6545,7 +6376,7 @@ convert_I420_pack_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
   gint n_threads;
   gint lines_per_thread;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6572,8 +6403,8 @@ convert_I420_pack_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_I420_pack_ARGB_task,
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_I420_pack_ARGB_task,
       (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
@@ -6636,7 +6467,7 @@ convert_A420_pack_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
   gint n_threads;
   gint lines_per_thread;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6663,8 +6494,8 @@ convert_A420_pack_ARGB (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_A420_pack_ARGB_task,
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_A420_pack_ARGB_task,
       (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
@@ -6716,7 +6547,7 @@ convert_A420_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
   gint n_threads;
   gint lines_per_thread;
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[0] =
       g_renew (FConvertTask, convert->tasks[0], n_threads);
   tasks_p = convert->tasks_p[0] =
@@ -6742,8 +6573,8 @@ convert_A420_BGRA (GstVideoConverter * convert, const GstVideoFrame * src,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_A420_BGRA_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_A420_BGRA_task, (gpointer) tasks_p);
 
   convert_fill_border (convert, dest);
 }
@@ -6926,7 +6757,7 @@ convert_plane_fill (GstVideoConverter * convert,
   d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane]);
   d += convert->fout_x[plane];
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -6946,8 +6777,8 @@ convert_plane_fill (GstVideoConverter * convert,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_fill_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_plane_fill_task, (gpointer) tasks_p);
 }
 
 static void
@@ -6974,7 +6805,7 @@ convert_plane_h_double (GstVideoConverter * convert,
   d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane]);
   d += convert->fout_x[plane];
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -6996,8 +6827,8 @@ convert_plane_h_double (GstVideoConverter * convert,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_h_double_task,
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_plane_h_double_task,
       (gpointer) tasks_p);
 }
 
@@ -7025,7 +6856,7 @@ convert_plane_h_halve (GstVideoConverter * convert,
   d = FRAME_GET_PLANE_LINE (dest, plane, convert->fout_y[plane]);
   d += convert->fout_x[plane];
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -7047,8 +6878,8 @@ convert_plane_h_halve (GstVideoConverter * convert,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_h_halve_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_plane_h_halve_task, (gpointer) tasks_p);
 }
 
 static void
@@ -7078,7 +6909,7 @@ convert_plane_v_double (GstVideoConverter * convert,
   d2 += convert->fout_x[plane];
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -7102,8 +6933,8 @@ convert_plane_v_double (GstVideoConverter * convert,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_v_double_task,
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_plane_v_double_task,
       (gpointer) tasks_p);
 }
 
@@ -7137,7 +6968,7 @@ convert_plane_v_halve (GstVideoConverter * convert,
   ss = FRAME_GET_PLANE_STRIDE (src, splane);
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -7159,8 +6990,8 @@ convert_plane_v_halve (GstVideoConverter * convert,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_v_halve_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_plane_v_halve_task, (gpointer) tasks_p);
 }
 
 static void
@@ -7192,7 +7023,7 @@ convert_plane_hv_double (GstVideoConverter * convert,
   ss = FRAME_GET_PLANE_STRIDE (src, splane);
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -7216,8 +7047,8 @@ convert_plane_hv_double (GstVideoConverter * convert,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_hv_double_task,
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_plane_hv_double_task,
       (gpointer) tasks_p);
 }
 
@@ -7250,7 +7081,7 @@ convert_plane_hv_halve (GstVideoConverter * convert,
   ss = FRAME_GET_PLANE_STRIDE (src, splane);
   ds = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[plane] =
       g_renew (FSimpleScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -7272,8 +7103,8 @@ convert_plane_hv_halve (GstVideoConverter * convert,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_hv_halve_task,
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_plane_hv_halve_task,
       (gpointer) tasks_p);
 }
 
@@ -7324,7 +7155,7 @@ convert_plane_hv (GstVideoConverter * convert,
   sstride = FRAME_GET_PLANE_STRIDE (src, splane);
   dstride = FRAME_GET_PLANE_STRIDE (dest, plane);
 
-  n_threads = convert->conversion_runner->n_threads;
+  n_threads = convert->n_threads;
   tasks = convert->tasks[plane] =
       g_renew (FScaleTask, convert->tasks[plane], n_threads);
   tasks_p = convert->tasks_p[plane] =
@@ -7355,8 +7186,8 @@ convert_plane_hv (GstVideoConverter * convert,
     tasks_p[i] = &tasks[i];
   }
 
-  gst_parallelized_task_runner_run (convert->conversion_runner,
-      (GstParallelizedTaskFunc) convert_plane_hv_task, (gpointer) tasks_p);
+  gst_video_parallel_runner_run (convert->conversion_runner,
+      (GstVideoParallelFunc) convert_plane_hv_task, (gpointer) tasks_p);
 }
 
 static void
@@ -7536,7 +7367,7 @@ setup_scale (GstVideoConverter * convert)
   const GstVideoFormatInfo *in_finfo, *out_finfo;
   GstVideoFormat in_format, out_format;
   gboolean interlaced;
-  guint n_threads = convert->conversion_runner->n_threads;
+  guint n_threads = convert->n_threads;
 
   in_info = &convert->in_info;
   out_info = &convert->out_info;
@@ -8424,8 +8255,8 @@ video_converter_lookup_fastpath (GstVideoConverter * convert)
       convert->convert = transforms[i].convert;
 
       convert->tmpline =
-          g_new (guint16 *, convert->conversion_runner->n_threads);
-      for (j = 0; j < convert->conversion_runner->n_threads; j++)
+          g_new (guint16 *, convert->n_threads);
+      for (j = 0; j < convert->n_threads; j++)
         convert->tmpline[j] = g_malloc0 (sizeof (guint16) * (width + 8) * 4);
 
       if (!transforms[i].keeps_size)
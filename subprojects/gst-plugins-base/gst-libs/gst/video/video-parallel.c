@@ -0,0 +1,331 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+/**
+ * SECTION:gstvideoparallel
+ * @title: GstVideoParallelRunner
+ * @short_description: Utility object for processing frames in slices
+ *
+ * #GstVideoParallelRunner runs a function over a number of slices of work,
+ * usually horizontal bands of a video frame, on the threads of a
+ * #GstTaskPool. It is the runner used by #GstVideoConverter and it is
+ * shared with elements that want to split their own processing.
+ *
+ * Without async tasks, gst_video_parallel_runner_run() handles one slice in
+ * the calling thread and only returns when all slices are done. With async
+ * tasks all slices are pushed to the pool and
+ * gst_video_parallel_runner_finish() waits for them.
+ *
+ * Since: 1.24
+ */
+
+#include <gst/base/base.h>
+
+#include "video-parallel.h"
+
+typedef struct _GstVideoParallelWorkItem GstVideoParallelWorkItem;
+
+struct _GstVideoParallelWorkItem
+{
+  GstVideoParallelRunner *self;
+  GstVideoParallelFunc func;
+  gpointer user_data;
+};
+
+struct _GstVideoParallelRunner
+{
+  GstTaskPool *pool;
+  gboolean own_pool;
+  guint n_threads;
+
+  GstQueueArray *tasks;
+  GstQueueArray *work_items;
+
+  GMutex lock;
+
+  gboolean async_tasks;
+};
+
+static void
+gst_video_parallel_thread_func (gpointer data)
+{
+  GstVideoParallelRunner *runner = data;
+  GstVideoParallelWorkItem *work_item;
+
+  g_mutex_lock (&runner->lock);
+  work_item = gst_queue_array_pop_head (runner->work_items);
+  g_mutex_unlock (&runner->lock);
+
+  g_assert (work_item != NULL);
+  g_assert (work_item->func != NULL);
+
+  work_item->func (work_item->user_data);
+  if (runner->async_tasks)
+    g_free (work_item);
+}
+
+static void
+gst_video_parallel_runner_join (GstVideoParallelRunner * self)
+{
+  gboolean joined = FALSE;
+
+  while (!joined) {
+    g_mutex_lock (&self->lock);
+    if (!(joined = gst_queue_array_is_empty (self->tasks))) {
+      gpointer task = gst_queue_array_pop_head (self->tasks);
+      g_mutex_unlock (&self->lock);
+      gst_task_pool_join (self->pool, task);
+    } else {
+      g_mutex_unlock (&self->lock);
+    }
+  }
+}
+
+/**
+ * gst_video_parallel_runner_new:
+ * @n_threads: the number of slices to split work into, 0 for one per CPU
+ * @pool: (transfer none) (nullable): a #GstTaskPool to run the slices on
+ * @async_tasks: whether all slices run on @pool and
+ *     gst_video_parallel_runner_run() returns without waiting for them
+ *
+ * Create a new runner. When @pool is %NULL a private #GstSharedTaskPool
+ * with @n_threads threads is created. When @pool is a #GstSharedTaskPool,
+ * @n_threads is limited to the maximum number of threads of the pool.
+ * A pool passed in must already be prepared.
+ *
+ * Returns: (transfer full): a new #GstVideoParallelRunner. Free with
+ *     gst_video_parallel_runner_free().
+ *
+ * Since: 1.24
+ */
+GstVideoParallelRunner *
+gst_video_parallel_runner_new (guint n_threads, GstTaskPool * pool,
+    gboolean async_tasks)
+{
+  GstVideoParallelRunner *self;
+
+  g_return_val_if_fail (pool == NULL || GST_IS_TASK_POOL (pool), NULL);
+
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+
+  self = g_new0 (GstVideoParallelRunner, 1);
+
+  if (pool) {
+    self->pool = g_object_ref (pool);
+    self->own_pool = FALSE;
+
+    /* No reason to split up the work between more threads than the
+     * pool can spawn */
+    if (GST_IS_SHARED_TASK_POOL (pool))
+      n_threads =
+          MIN (n_threads,
+          gst_shared_task_pool_get_max_threads (GST_SHARED_TASK_POOL (pool)));
+  } else {
+    self->pool = gst_shared_task_pool_new ();
+    self->own_pool = TRUE;
+    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (self->pool),
+        n_threads);
+    gst_task_pool_prepare (self->pool, NULL);
+  }
+
+  self->tasks = gst_queue_array_new (n_threads);
+  self->work_items = gst_queue_array_new (n_threads);
+
+  self->n_threads = MAX (n_threads, 1);
+
+  g_mutex_init (&self->lock);
+
+  self->async_tasks = async_tasks;
+
+  return self;
+}
+
+/**
+ * gst_video_parallel_runner_free:
+ * @runner: a #GstVideoParallelRunner
+ *
+ * Wait for all pending slices and free @runner.
+ *
+ * Since: 1.24
+ */
+void
+gst_video_parallel_runner_free (GstVideoParallelRunner * runner)
+{
+  g_return_if_fail (runner != NULL);
+
+  gst_video_parallel_runner_join (runner);
+
+  gst_queue_array_free (runner->work_items);
+  gst_queue_array_free (runner->tasks);
+  if (runner->own_pool)
+    gst_task_pool_cleanup (runner->pool);
+  gst_object_unref (runner->pool);
+  g_mutex_clear (&runner->lock);
+  g_free (runner);
+}
+
+/**
+ * gst_video_parallel_runner_get_n_threads:
+ * @runner: a #GstVideoParallelRunner
+ *
+ * Returns: the number of slices @runner splits work into. The array passed
+ *     to gst_video_parallel_runner_run() must have this many entries.
+ *
+ * Since: 1.24
+ */
+guint
+gst_video_parallel_runner_get_n_threads (GstVideoParallelRunner * runner)
+{
+  g_return_val_if_fail (runner != NULL, 0);
+
+  return runner->n_threads;
+}
+
+/**
+ * gst_video_parallel_runner_run:
+ * @runner: a #GstVideoParallelRunner
+ * @func: (scope call): the function to call for each slice
+ * @task_data: (array): the data for each slice, one entry per thread
+ *
+ * Call @func once for each entry of @task_data, in parallel. Without async
+ * tasks, the first entry is handled in the calling thread and this function
+ * returns when all slices are done. With async tasks, the caller must call
+ * gst_video_parallel_runner_finish() before touching the results or
+ * @task_data again.
+ *
+ * Since: 1.24
+ */
+void
+gst_video_parallel_runner_run (GstVideoParallelRunner * runner,
+    GstVideoParallelFunc func, gpointer * task_data)
+{
+  guint n_threads;
+
+  g_return_if_fail (runner != NULL);
+  g_return_if_fail (func != NULL);
+
+  n_threads = runner->n_threads;
+
+  if (n_threads > 1 || runner->async_tasks) {
+    guint i = 0;
+    g_mutex_lock (&runner->lock);
+    if (!runner->async_tasks) {
+      /* if not async, perform one of the functions in the current thread */
+      i = 1;
+    }
+    for (; i < n_threads; i++) {
+      gpointer task;
+      GstVideoParallelWorkItem *work_item;
+
+      if (!runner->async_tasks)
+        work_item = g_newa (GstVideoParallelWorkItem, 1);
+      else
+        work_item = g_new0 (GstVideoParallelWorkItem, 1);
+
+      work_item->self = runner;
+      work_item->func = func;
+      work_item->user_data = task_data[i];
+      gst_queue_array_push_tail (runner->work_items, work_item);
+
+      task =
+          gst_task_pool_push (runner->pool, gst_video_parallel_thread_func,
+          runner, NULL);
+
+      /* The return value of push() is nullable but NULL is only returned
+       * with the shared task pool when gst_task_pool_prepare() has not been
+       * called and would thus be a programming error that we should
+       * hard-fail on. */
+      g_assert (task != NULL);
+      gst_queue_array_push_tail (runner->tasks, task);
+    }
+    g_mutex_unlock (&runner->lock);
+  }
+
+  if (!runner->async_tasks) {
+    func (task_data[0]);
+
+    gst_video_parallel_runner_join (runner);
+  }
+}
+
+/**
+ * gst_video_parallel_runner_finish:
+ * @runner: a #GstVideoParallelRunner
+ *
+ * Wait for the slices pushed by the last gst_video_parallel_runner_run()
+ * to complete.
+ *
+ * Since: 1.24
+ */
+void
+gst_video_parallel_runner_finish (GstVideoParallelRunner * runner)
+{
+  g_return_if_fail (runner != NULL);
+
+  gst_video_parallel_runner_join (runner);
+}
+
+/**
+ * gst_video_parallel_get_n_threads:
+ * @max_threads: the maximum number of threads, 0 for one per CPU
+ * @n_lines: the number of lines to process
+ *
+ * Get the number of threads worth using to process @n_lines lines.
+ * @max_threads is limited to the number of CPUs, and each thread gets at
+ * least #GST_VIDEO_PARALLEL_MIN_LINES lines.
+ *
+ * For testing, the number of CPUs can be overridden with the
+ * `GST_VIDEO_PARALLEL_N_CPUS` environment variable, so that work is split
+ * the same way on machines with fewer CPUs.
+ *
+ * Returns: the number of threads to use, at least 1
+ *
+ * Since: 1.24
+ */
+guint
+gst_video_parallel_get_n_threads (guint max_threads, guint n_lines)
+{
+  static gsize n_cpus = 0;
+  guint n_threads = max_threads;
+
+  if (g_once_init_enter (&n_cpus)) {
+    const gchar *env = g_getenv ("GST_VIDEO_PARALLEL_N_CPUS");
+    guint64 n = 0;
+
+    if (env)
+      n = g_ascii_strtoull (env, NULL, 10);
+    if (n == 0 || n > G_MAXUINT)
+      n = g_get_num_processors ();
+
+    g_once_init_leave (&n_cpus, n);
+  }
+
+  if (n_threads == 0 || n_threads > n_cpus)
+    n_threads = n_cpus;
+
+  if (n_lines / n_threads < GST_VIDEO_PARALLEL_MIN_LINES)
+    n_threads = (n_lines + GST_VIDEO_PARALLEL_MIN_LINES - 1) /
+        GST_VIDEO_PARALLEL_MIN_LINES;
+
+  return MAX (n_threads, 1);
+}
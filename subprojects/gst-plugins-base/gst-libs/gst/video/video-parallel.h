@@ -0,0 +1,83 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_VIDEO_PARALLEL_H__
+#define __GST_VIDEO_PARALLEL_H__
+
+#include <gst/gst.h>
+#include <gst/video/video-prelude.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GST_VIDEO_PARALLEL_MIN_LINES:
+ *
+ * The minimum number of lines that is worth handing to a separate thread.
+ * Splitting a frame into smaller slices usually costs more in
+ * synchronisation than it gains.
+ *
+ * Since: 1.24
+ */
+#define GST_VIDEO_PARALLEL_MIN_LINES 200
+
+/**
+ * GstVideoParallelFunc:
+ * @user_data: the task data of one slice
+ *
+ * Function called for each slice of work by gst_video_parallel_runner_run().
+ *
+ * Since: 1.24
+ */
+typedef void (*GstVideoParallelFunc) (gpointer user_data);
+
+/**
+ * GstVideoParallelRunner:
+ *
+ * Opaque object that runs a function over a fixed number of slices of work
+ * in parallel on a #GstTaskPool.
+ *
+ * Since: 1.24
+ */
+typedef struct _GstVideoParallelRunner GstVideoParallelRunner;
+
+GST_VIDEO_API
+GstVideoParallelRunner * gst_video_parallel_runner_new     (guint n_threads,
+                                                            GstTaskPool * pool,
+                                                            gboolean async_tasks);
+
+GST_VIDEO_API
+void                     gst_video_parallel_runner_free    (GstVideoParallelRunner * runner);
+
+GST_VIDEO_API
+guint                    gst_video_parallel_runner_get_n_threads (GstVideoParallelRunner * runner);
+
+GST_VIDEO_API
+void                     gst_video_parallel_runner_run     (GstVideoParallelRunner * runner,
+                                                            GstVideoParallelFunc func,
+                                                            gpointer * task_data);
+
+GST_VIDEO_API
+void                     gst_video_parallel_runner_finish  (GstVideoParallelRunner * runner);
+
+GST_VIDEO_API
+guint                    gst_video_parallel_get_n_threads  (guint max_threads,
+                                                            guint n_lines);
+
+G_END_DECLS
+
+#endif /* __GST_VIDEO_PARALLEL_H__ */
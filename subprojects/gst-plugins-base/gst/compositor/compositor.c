@@ -1240,148 +1240,6 @@ _fixate_caps (GstAggregator * agg, GstCaps * caps)
   return ret;
 }
 
-static void
-gst_parallelized_task_thread_func (gpointer data)
-{
-  GstParallelizedTaskRunner *runner = data;
-  gint idx;
-
-  g_mutex_lock (&runner->lock);
-  idx = runner->n_todo--;
-  g_assert (runner->n_todo >= -1);
-  g_mutex_unlock (&runner->lock);
-
-  g_assert (runner->func != NULL);
-
-  runner->func (runner->task_data[idx]);
-}
-
-static void
-gst_parallelized_task_runner_join (GstParallelizedTaskRunner * self)
-{
-  gboolean joined = FALSE;
-
-  while (!joined) {
-    g_mutex_lock (&self->lock);
-    if (!(joined = gst_queue_array_is_empty (self->tasks))) {
-      gpointer task = gst_queue_array_pop_head (self->tasks);
-      g_mutex_unlock (&self->lock);
-      gst_task_pool_join (self->pool, task);
-    } else {
-      g_mutex_unlock (&self->lock);
-    }
-  }
-}
-
-static void
-gst_parallelized_task_runner_free (GstParallelizedTaskRunner * self)
-{
-  gst_parallelized_task_runner_join (self);
-
-  gst_queue_array_free (self->tasks);
-  if (self->own_pool)
-    gst_task_pool_cleanup (self->pool);
-  gst_object_unref (self->pool);
-  g_mutex_clear (&self->lock);
-  g_free (self);
-}
-
-static GstParallelizedTaskRunner *
-gst_parallelized_task_runner_new (guint n_threads, GstTaskPool * pool,
-    gboolean async_tasks)
-{
-  GstParallelizedTaskRunner *self;
-
-  if (n_threads == 0)
-    n_threads = g_get_num_processors ();
-
-  self = g_new0 (GstParallelizedTaskRunner, 1);
-
-  if (pool) {
-    self->pool = g_object_ref (pool);
-    self->own_pool = FALSE;
-
-    /* No reason to split up the work between more threads than the
-     * pool can spawn */
-    if (GST_IS_SHARED_TASK_POOL (pool))
-      n_threads =
-          MIN (n_threads,
-          gst_shared_task_pool_get_max_threads (GST_SHARED_TASK_POOL (pool)));
-  } else {
-    self->pool = gst_shared_task_pool_new ();
-    self->own_pool = TRUE;
-    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (self->pool),
-        n_threads);
-    gst_task_pool_prepare (self->pool, NULL);
-  }
-
-  self->tasks = gst_queue_array_new (n_threads);
-
-  self->n_threads = n_threads;
-
-  self->n_todo = -1;
-  g_mutex_init (&self->lock);
-
-  /* Set when scheduling a job */
-  self->func = NULL;
-  self->task_data = NULL;
-  self->async_tasks = async_tasks;
-
-  return self;
-}
-
-static void
-gst_parallelized_task_runner_finish (GstParallelizedTaskRunner * self)
-{
-  g_return_if_fail (self->func != NULL);
-
-  gst_parallelized_task_runner_join (self);
-
-  self->func = NULL;
-  self->task_data = NULL;
-}
-
-static void
-gst_parallelized_task_runner_run (GstParallelizedTaskRunner * self,
-    GstParallelizedTaskFunc func, gpointer * task_data)
-{
-  guint n_threads = self->n_threads;
-
-  self->func = func;
-  self->task_data = task_data;
-
-  if (n_threads > 1 || self->async_tasks) {
-    guint i = 0;
-    g_mutex_lock (&self->lock);
-    self->n_todo = self->n_threads - 1;
-    if (!self->async_tasks) {
-      /* if not async, perform one of the functions in the current thread */
-      self->n_todo--;
-      i = 1;
-    }
-    for (; i < n_threads; i++) {
-      gpointer task =
-          gst_task_pool_push (self->pool, gst_parallelized_task_thread_func,
-          self, NULL);
-
-      /* The return value of push() is nullable but NULL is only returned
-       * with the shared task pool when gst_task_pool_prepare() has not been
-       * called and would thus be a programming error that we should hard-fail
-       * on.
-       */
-      g_assert (task != NULL);
-      gst_queue_array_push_tail (self->tasks, task);
-    }
-    g_mutex_unlock (&self->lock);
-  }
-
-  if (!self->async_tasks) {
-    self->func (self->task_data[self->n_threads - 1]);
-
-    gst_parallelized_task_runner_finish (self);
-  }
-}
-
 static gboolean
 _negotiated_caps (GstAggregator * agg, GstCaps * caps)
 {
@@ -1438,27 +1296,20 @@ _negotiated_caps (GstAggregator * agg, GstCaps * caps)
         ("Mixing HDR10 and HLG contents would result in color loss"), (NULL));
   }
 
-  if (compositor->max_threads == 0)
-    n_threads = g_get_num_processors ();
-  else
-    n_threads = compositor->max_threads;
-
-  /* Magic number of 200 lines */
-  if (GST_VIDEO_INFO_HEIGHT (&v_info) / n_threads < 200)
-    n_threads = (GST_VIDEO_INFO_HEIGHT (&v_info) + 199) / 200;
-  if (n_threads < 1)
-    n_threads = 1;
+  n_threads = gst_video_parallel_get_n_threads (compositor->max_threads,
+      GST_VIDEO_INFO_HEIGHT (&v_info));
 
   /* XXX: implement better thread count change */
   if (compositor->blend_runner
-      && compositor->blend_runner->n_threads != n_threads) {
-    gst_parallelized_task_runner_free (compositor->blend_runner);
+      && gst_video_parallel_runner_get_n_threads (compositor->blend_runner) !=
+      n_threads) {
+    gst_video_parallel_runner_free (compositor->blend_runner);
     compositor->blend_runner = NULL;
   }
   if (!compositor->blend_runner) {
     GstTaskPool *pool = gst_video_aggregator_get_execution_task_pool (vagg);
     compositor->blend_runner =
-        gst_parallelized_task_runner_new (n_threads, pool, FALSE);
+        gst_video_parallel_runner_new (n_threads, pool, FALSE);
     gst_clear_object (&pool);
   }
 
@@ -1733,7 +1584,8 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
     struct CompositeTask *tasks;
     struct CompositeTask **tasks_p;
 
-    n_threads = compositor->blend_runner->n_threads;
+    n_threads =
+        gst_video_parallel_runner_get_n_threads (compositor->blend_runner);
 
     tasks = g_newa (struct CompositeTask, n_threads);
     tasks_p = g_newa (struct CompositeTask *, n_threads);
@@ -1757,8 +1609,8 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
       tasks_p[i] = &tasks[i];
     }
 
-    gst_parallelized_task_runner_run (compositor->blend_runner,
-        (GstParallelizedTaskFunc) blend_pads, (gpointer *) tasks_p);
+    gst_video_parallel_runner_run (compositor->blend_runner,
+        (GstVideoParallelFunc) blend_pads, (gpointer *) tasks_p);
   }
 
   GST_OBJECT_UNLOCK (vagg);
@@ -1936,7 +1788,7 @@ gst_compositor_finalize (GObject * object)
   GstCompositor *compositor = GST_COMPOSITOR (object);
 
   if (compositor->blend_runner)
-    gst_parallelized_task_runner_free (compositor->blend_runner);
+    gst_video_parallel_runner_free (compositor->blend_runner);
   compositor->blend_runner = NULL;
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
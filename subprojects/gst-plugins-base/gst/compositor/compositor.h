@@ -94,28 +94,6 @@ typedef enum
   COMPOSITOR_SIZING_POLICY_KEEP_ASPECT_RATIO,
 } GstCompositorSizingPolicy;
 
-/* copied from video-converter.c */
-typedef void (*GstParallelizedTaskFunc) (gpointer user_data);
-
-typedef struct _GstParallelizedTaskRunner GstParallelizedTaskRunner;
-
-struct _GstParallelizedTaskRunner
-{
-  GstTaskPool *pool;
-  gboolean own_pool;
-  guint n_threads;
-
-  GstQueueArray *tasks;
-
-  GstParallelizedTaskFunc func;
-  gpointer *task_data;
-
-  GMutex lock;
-  gint n_todo;
-
-  gboolean async_tasks;
-};
-
 /**
  * GstCompositor:
  *
@@ -153,7 +131,7 @@ struct _GstCompositor
   GstVideoInfo intermediate_info;
   GstVideoConverter *intermediate_convert;
 
-  GstParallelizedTaskRunner *blend_runner;
+  GstVideoParallelRunner *blend_runner;
 };
 
 /**
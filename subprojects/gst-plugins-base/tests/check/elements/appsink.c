@@ -714,6 +714,123 @@ GST_START_TEST (test_pull_sample_refcounts)
 
 GST_END_TEST;
 
+GST_START_TEST (test_pull_samples)
+{
+  GstElement *sink;
+  GstBuffer *buffer;
+  GstBufferList *list;
+  GstSample *s;
+  GstCaps *caps;
+  guint i;
+
+  sink = setup_appsink ();
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  for (i = 0; i < 5; i++) {
+    buffer = gst_buffer_new_and_alloc (4 + i);
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  s = gst_app_sink_try_pull_samples (GST_APP_SINK (sink), 3, 0);
+  fail_unless (s != NULL);
+  fail_unless (gst_sample_get_buffer (s) == NULL);
+  fail_unless (gst_sample_get_caps (s) != NULL);
+  list = gst_sample_get_buffer_list (s);
+  fail_unless (list != NULL);
+  fail_unless_equals_int (gst_buffer_list_length (list), 3);
+  for (i = 0; i < 3; i++)
+    fail_unless_equals_int (gst_buffer_get_size (gst_buffer_list_get (list,
+                i)), 4 + i);
+  gst_sample_unref (s);
+
+  /* caps change in the middle of the queue ends the batch */
+  buffer = gst_buffer_new_and_alloc (9);
+  fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  caps = gst_caps_new_simple ("application/x-gst-check", "changed",
+      G_TYPE_BOOLEAN, TRUE, NULL);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_caps (caps)));
+  buffer = gst_buffer_new_and_alloc (10);
+  fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+
+  s = gst_app_sink_try_pull_samples (GST_APP_SINK (sink), 0, 0);
+  fail_unless (s != NULL);
+  list = gst_sample_get_buffer_list (s);
+  fail_unless_equals_int (gst_buffer_list_length (list), 3);
+  fail_unless_equals_int (gst_buffer_get_size (gst_buffer_list_get (list, 2)),
+      9);
+  fail_if (gst_caps_is_equal (gst_sample_get_caps (s), caps));
+  gst_sample_unref (s);
+
+  s = gst_app_sink_try_pull_samples (GST_APP_SINK (sink), 0, 0);
+  fail_unless (s != NULL);
+  list = gst_sample_get_buffer_list (s);
+  fail_unless_equals_int (gst_buffer_list_length (list), 1);
+  fail_unless_equals_int (gst_buffer_get_size (gst_buffer_list_get (list, 0)),
+      10);
+  fail_unless (gst_caps_is_equal (gst_sample_get_caps (s), caps));
+  gst_sample_unref (s);
+  gst_caps_unref (caps);
+
+  /* No waiting */
+  s = gst_app_sink_try_pull_samples (GST_APP_SINK (sink), 0, 0);
+  fail_unless (s == NULL);
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_appsink (sink);
+}
+
+GST_END_TEST;
+
+static gboolean
+pollfd_is_readable (GPollFD * fd)
+{
+  fd->revents = 0;
+  fail_unless (g_poll (fd, 1, 0) >= 0);
+
+  return (fd->revents & G_IO_IN) != 0;
+}
+
+GST_START_TEST (test_pollfd)
+{
+  GstElement *sink;
+  GstBuffer *buffer;
+  GstSample *s;
+  GPollFD fd;
+
+  sink = setup_appsink ();
+  fail_unless (gst_app_sink_get_pollfd (GST_APP_SINK (sink), &fd));
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+  fail_if (pollfd_is_readable (&fd));
+
+  buffer = gst_buffer_new_and_alloc (4);
+  fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  buffer = gst_buffer_new_and_alloc (4);
+  fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  fail_unless (pollfd_is_readable (&fd));
+
+  s = gst_app_sink_pull_sample (GST_APP_SINK (sink));
+  fail_unless (s != NULL);
+  gst_sample_unref (s);
+  fail_unless (pollfd_is_readable (&fd));
+
+  s = gst_app_sink_pull_sample (GST_APP_SINK (sink));
+  fail_unless (s != NULL);
+  gst_sample_unref (s);
+  fail_if (pollfd_is_readable (&fd));
+
+  /* EOS wakes up the application as well */
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+  fail_unless (pollfd_is_readable (&fd));
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  fail_if (pollfd_is_readable (&fd));
+  cleanup_appsink (sink);
+}
+
+GST_END_TEST;
+
 static gboolean
 new_event_cb (GstAppSink * appsink, gpointer callback_data)
 {
@@ -1089,6 +1206,8 @@ appsink_suite (void)
   tcase_add_test (tc_chain, test_pull_preroll);
   tcase_add_test (tc_chain, test_do_not_care_preroll);
   tcase_add_test (tc_chain, test_pull_sample_refcounts);
+  tcase_add_test (tc_chain, test_pull_samples);
+  tcase_add_test (tc_chain, test_pollfd);
   tcase_add_test (tc_chain, test_event_callback);
   tcase_add_test (tc_chain, test_event_signals);
   tcase_add_test (tc_chain, test_event_paused);
@@ -4111,6 +4111,103 @@ GST_START_TEST (test_video_color_primaries_equivalent)
 
 GST_END_TEST;
 
+typedef struct
+{
+  GThread *thread;
+  gint runs;
+} ParallelSlice;
+
+static void
+parallel_slice_func (gpointer user_data)
+{
+  ParallelSlice *slice = user_data;
+
+  slice->thread = g_thread_self ();
+  g_atomic_int_inc (&slice->runs);
+}
+
+static void
+check_parallel_runner (guint n_threads, GstTaskPool * pool,
+    gboolean async_tasks, guint expected_threads)
+{
+  GstVideoParallelRunner *runner;
+  ParallelSlice slices[8] = { {NULL, 0}, };
+  gpointer task_data[8];
+  guint i, round;
+
+  runner = gst_video_parallel_runner_new (n_threads, pool, async_tasks);
+  fail_unless (runner != NULL);
+  fail_unless_equals_int (gst_video_parallel_runner_get_n_threads (runner),
+      expected_threads);
+
+  for (i = 0; i < G_N_ELEMENTS (slices); i++)
+    task_data[i] = &slices[i];
+
+  /* the runner is reused for every frame */
+  for (round = 1; round <= 3; round++) {
+    gst_video_parallel_runner_run (runner, parallel_slice_func, task_data);
+    if (async_tasks)
+      gst_video_parallel_runner_finish (runner);
+
+    for (i = 0; i < expected_threads; i++)
+      fail_unless_equals_int (slices[i].runs, round);
+    for (; i < G_N_ELEMENTS (slices); i++)
+      fail_unless_equals_int (slices[i].runs, 0);
+
+    /* without async tasks the first slice runs in the calling thread and
+     * the others on the pool */
+    for (i = 0; i < expected_threads; i++) {
+      if (i == 0 && !async_tasks)
+        fail_unless (slices[i].thread == g_thread_self ());
+      else
+        fail_unless (slices[i].thread != g_thread_self ());
+    }
+  }
+
+  gst_video_parallel_runner_free (runner);
+}
+
+GST_START_TEST (test_video_parallel_runner)
+{
+  GstTaskPool *pool;
+
+  check_parallel_runner (1, NULL, FALSE, 1);
+  check_parallel_runner (4, NULL, FALSE, 4);
+  check_parallel_runner (4, NULL, TRUE, 4);
+
+  /* limited to the threads of a shared pool */
+  pool = gst_shared_task_pool_new ();
+  gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (pool), 2);
+  gst_task_pool_prepare (pool, NULL);
+  check_parallel_runner (4, pool, FALSE, 2);
+  check_parallel_runner (8, pool, TRUE, 2);
+  gst_task_pool_cleanup (pool);
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_video_parallel_get_n_threads)
+{
+  guint n_cpus = g_get_num_processors ();
+
+  fail_unless_equals_int (gst_video_parallel_get_n_threads (1, 10000), 1);
+
+  /* one per CPU at most */
+  fail_unless_equals_int (gst_video_parallel_get_n_threads (0,
+          n_cpus * GST_VIDEO_PARALLEL_MIN_LINES), n_cpus);
+  fail_unless_equals_int (gst_video_parallel_get_n_threads (n_cpus + 3,
+          (n_cpus + 3) * GST_VIDEO_PARALLEL_MIN_LINES), n_cpus);
+
+  /* and only as many as there are lines for */
+  fail_unless_equals_int (gst_video_parallel_get_n_threads (4,
+          2 * GST_VIDEO_PARALLEL_MIN_LINES), MIN (n_cpus, 2));
+  fail_unless_equals_int (gst_video_parallel_get_n_threads (4, 10), 1);
+  fail_unless_equals_int (gst_video_parallel_get_n_threads (0, 0), 1);
+}
+
+GST_END_TEST;
+
 static Suite *
 video_suite (void)
 {
@@ -4168,6 +4265,8 @@ video_suite (void)
   tcase_add_test (tc_chain, test_video_extrapolate_stride);
   tcase_add_test (tc_chain, test_auto_video_frame_unmap);
   tcase_add_test (tc_chain, test_video_color_primaries_equivalent);
+  tcase_add_test (tc_chain, test_video_parallel_runner);
+  tcase_add_test (tc_chain, test_video_parallel_get_n_threads);
 
   return s;
 }
@@ -146,28 +146,36 @@ GST_STATIC_PAD_TEMPLATE ("sink",
 static GstStaticCaps gst_alpha_alpha_caps =
 GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE ("{ AYUV, ARGB, BGRA, ABGR, RGBA }"));
 
-/* FIXME: why do we need our own lock for this? */
+/* Taken for writing when the parameters change and for reading while
+ * processing a frame, so that all its bands of lines are processed in
+ * parallel with the same parameters */
 #define GST_ALPHA_LOCK(alpha) G_STMT_START { \
   GST_LOG_OBJECT (alpha, "Locking alpha from thread %p", g_thread_self ()); \
-  g_mutex_lock (&alpha->lock); \
+  g_rw_lock_writer_lock (&alpha->lock); \
   GST_LOG_OBJECT (alpha, "Locked alpha from thread %p", g_thread_self ()); \
 } G_STMT_END
 
 #define GST_ALPHA_UNLOCK(alpha) G_STMT_START { \
   GST_LOG_OBJECT (alpha, "Unlocking alpha from thread %p", g_thread_self ()); \
-  g_mutex_unlock (&alpha->lock); \
+  g_rw_lock_writer_unlock (&alpha->lock); \
 } G_STMT_END
 
+#define GST_ALPHA_READ_LOCK(alpha) g_rw_lock_reader_lock (&alpha->lock)
+#define GST_ALPHA_READ_UNLOCK(alpha) g_rw_lock_reader_unlock (&alpha->lock)
+
 static GstCaps *gst_alpha_transform_caps (GstBaseTransform * btrans,
     GstPadDirection direction, GstCaps * caps, GstCaps * filter);
 static void gst_alpha_before_transform (GstBaseTransform * btrans,
     GstBuffer * buf);
+static GstFlowReturn gst_alpha_transform (GstBaseTransform * btrans,
+    GstBuffer * inbuf, GstBuffer * outbuf);
 
 static gboolean gst_alpha_set_info (GstVideoFilter * filter,
     GstCaps * incaps, GstVideoInfo * in_info, GstCaps * outcaps,
     GstVideoInfo * out_info);
-static GstFlowReturn gst_alpha_transform_frame (GstVideoFilter * filter,
-    GstVideoFrame * in_frame, GstVideoFrame * out_frame);
+static GstFlowReturn gst_alpha_transform_frame_lines (GstVideoFilter *
+    filter, GstVideoFrame * in_frame, GstVideoFrame * out_frame, guint y,
+    guint height);
 
 static void gst_alpha_init_params_full (GstAlpha * alpha,
     const GstVideoFormatInfo * in_info, const GstVideoFormatInfo * out_info);
@@ -283,10 +291,11 @@ gst_alpha_class_init (GstAlphaClass * klass)
   btrans_class->before_transform =
       GST_DEBUG_FUNCPTR (gst_alpha_before_transform);
   btrans_class->transform_caps = GST_DEBUG_FUNCPTR (gst_alpha_transform_caps);
+  btrans_class->transform = GST_DEBUG_FUNCPTR (gst_alpha_transform);
 
   vfilter_class->set_info = GST_DEBUG_FUNCPTR (gst_alpha_set_info);
-  vfilter_class->transform_frame =
-      GST_DEBUG_FUNCPTR (gst_alpha_transform_frame);
+  vfilter_class->transform_frame_lines =
+      GST_DEBUG_FUNCPTR (gst_alpha_transform_frame_lines);
 
   gst_type_mark_as_plugin_api (GST_TYPE_ALPHA_METHOD, 0);
 }
@@ -304,7 +313,7 @@ gst_alpha_init (GstAlpha * alpha)
   alpha->black_sensitivity = DEFAULT_BLACK_SENSITIVITY;
   alpha->white_sensitivity = DEFAULT_WHITE_SENSITIVITY;
 
-  g_mutex_init (&alpha->lock);
+  g_rw_lock_init (&alpha->lock);
 }
 
 static void
@@ -312,7 +321,7 @@ gst_alpha_finalize (GObject * object)
 {
   GstAlpha *alpha = GST_ALPHA (object);
 
-  g_mutex_clear (&alpha->lock);
+  g_rw_lock_clear (&alpha->lock);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -2621,19 +2630,57 @@ gst_alpha_before_transform (GstBaseTransform * btrans, GstBuffer * buf)
 }
 
 static GstFlowReturn
-gst_alpha_transform_frame (GstVideoFilter * filter, GstVideoFrame * in_frame,
-    GstVideoFrame * out_frame)
+gst_alpha_transform (GstBaseTransform * btrans, GstBuffer * inbuf,
+    GstBuffer * outbuf)
 {
-  GstAlpha *alpha = GST_ALPHA (filter);
+  GstAlpha *alpha = GST_ALPHA (btrans);
+  GstFlowReturn ret;
 
-  GST_ALPHA_LOCK (alpha);
+  GST_ALPHA_READ_LOCK (alpha);
+  ret = GST_BASE_TRANSFORM_CLASS (parent_class)->transform (btrans, inbuf,
+      outbuf);
+  GST_ALPHA_READ_UNLOCK (alpha);
+
+  return ret;
+}
+
+/* Make @lines a view of @height lines of @frame starting at line @y */
+static void
+gst_alpha_frame_lines (const GstVideoFrame * frame, GstVideoFrame * lines,
+    guint y, guint height)
+{
+  const GstVideoFormatInfo *finfo = frame->info.finfo;
+  guint i;
+
+  *lines = *frame;
+  lines->info.height = height;
 
+  for (i = 0; i < GST_VIDEO_FRAME_N_PLANES (frame); i++) {
+    gint comp[GST_VIDEO_MAX_COMPONENTS];
+
+    gst_video_format_info_component (finfo, i, comp);
+    lines->data[i] = (guint8 *) frame->data[i] +
+        GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, comp[0], y) *
+        GST_VIDEO_FRAME_PLANE_STRIDE (frame, i);
+  }
+}
+
+static GstFlowReturn
+gst_alpha_transform_frame_lines (GstVideoFilter * filter,
+    GstVideoFrame * in_frame, GstVideoFrame * out_frame, guint y,
+    guint height)
+{
+  GstAlpha *alpha = GST_ALPHA (filter);
+  GstVideoFrame in_lines, out_lines;
+
+  /* read-locked by gst_alpha_transform() */
   if (G_UNLIKELY (!alpha->process))
     goto not_negotiated;
 
-  alpha->process (in_frame, out_frame, alpha);
+  gst_alpha_frame_lines (in_frame, &in_lines, y, height);
+  gst_alpha_frame_lines (out_frame, &out_lines, y, height);
 
-  GST_ALPHA_UNLOCK (alpha);
+  alpha->process (&in_lines, &out_lines, alpha);
 
   return GST_FLOW_OK;
 
@@ -2641,7 +2688,6 @@ gst_alpha_transform_frame (GstVideoFilter * filter, GstVideoFrame * in_frame,
 not_negotiated:
   {
     GST_ERROR_OBJECT (alpha, "Not negotiated yet");
-    GST_ALPHA_UNLOCK (alpha);
     return GST_FLOW_NOT_NEGOTIATED;
   }
 }
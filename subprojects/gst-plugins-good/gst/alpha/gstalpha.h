@@ -59,7 +59,7 @@ struct _GstAlpha
   /* <private> */
 
   /* caps */
-  GMutex lock;
+  GRWLock lock;
 
   gboolean in_sdtv, out_sdtv;
 
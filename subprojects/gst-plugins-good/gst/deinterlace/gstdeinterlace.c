@@ -60,6 +60,7 @@ GST_DEBUG_CATEGORY_STATIC (deinterlace_debug);
 #define DEFAULT_LOCKING         GST_DEINTERLACE_LOCKING_NONE
 #define DEFAULT_IGNORE_OBSCURE  TRUE
 #define DEFAULT_DROP_ORPHANS    TRUE
+#define DEFAULT_MAX_THREADS     1
 
 enum
 {
@@ -70,7 +71,8 @@ enum
   PROP_FIELD_LAYOUT,
   PROP_LOCKING,
   PROP_IGNORE_OBSCURE,
-  PROP_DROP_ORPHANS
+  PROP_DROP_ORPHANS,
+  PROP_MAX_THREADS
 };
 
 /* P is progressive, meaning the top and bottom fields belong to
@@ -450,6 +452,7 @@ gst_deinterlace_set_method (GstDeinterlace * self, GstDeinterlaceMethods method)
 
   GST_OBJECT_LOCK (self);
   self->method = g_object_new (method_type, "name", "method", NULL);
+  self->method->max_threads = self->max_threads;
   gst_object_set_parent (GST_OBJECT (self->method), GST_OBJECT (self));
   GST_OBJECT_UNLOCK (self);
 
@@ -635,6 +638,21 @@ gst_deinterlace_class_init (GstDeinterlaceClass * klass)
           "active locking mode.", DEFAULT_DROP_ORPHANS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstDeinterlace:max-threads:
+   *
+   * Maximum number of threads the lines of a frame are split between, 0 for
+   * one per CPU. Only used by the methods that create every output line
+   * independently (linear, linearblend, scalerbob, vfir, greedyl, yadif and
+   * the weave variants).
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_THREADS,
+      g_param_spec_uint ("max-threads", "Maximum Threads",
+          "Maximum number of threads to use (0 = one per CPU)", 0, G_MAXUINT,
+          DEFAULT_MAX_THREADS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   element_class->change_state =
       GST_DEBUG_FUNCPTR (gst_deinterlace_change_state);
 
@@ -706,6 +724,7 @@ gst_deinterlace_init (GstDeinterlace * self)
   self->locking = DEFAULT_LOCKING;
   self->ignore_obscure = DEFAULT_IGNORE_OBSCURE;
   self->drop_orphans = DEFAULT_DROP_ORPHANS;
+  self->max_threads = DEFAULT_MAX_THREADS;
 
   self->low_latency = -1;
   self->pattern = -1;
@@ -947,6 +966,13 @@ gst_deinterlace_set_property (GObject * object, guint prop_id,
     case PROP_DROP_ORPHANS:
       self->drop_orphans = g_value_get_boolean (value);
       break;
+    case PROP_MAX_THREADS:
+      GST_OBJECT_LOCK (self);
+      self->max_threads = g_value_get_uint (value);
+      if (self->method)
+        self->method->max_threads = self->max_threads;
+      GST_OBJECT_UNLOCK (self);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (self, prop_id, pspec);
   }
@@ -983,6 +1009,9 @@ gst_deinterlace_get_property (GObject * object, guint prop_id,
     case PROP_DROP_ORPHANS:
       g_value_set_boolean (value, self->drop_orphans);
       break;
+    case PROP_MAX_THREADS:
+      g_value_set_uint (value, self->max_threads);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (self, prop_id, pspec);
   }
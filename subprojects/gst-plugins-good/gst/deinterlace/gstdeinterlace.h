@@ -183,6 +183,7 @@ struct _GstDeinterlace
   gint low_latency;
   gboolean drop_orphans;
   gboolean ignore_obscure;
+  guint max_threads;
   gboolean pattern_lock;
   gboolean pattern_refresh;
   GstDeinterlaceBufferState buf_states[GST_DEINTERLACE_MAX_BUFFER_STATE_HISTORY];
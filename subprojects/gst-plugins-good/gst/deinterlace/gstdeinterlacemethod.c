@@ -188,6 +188,7 @@ static void
 gst_deinterlace_method_init (GstDeinterlaceMethod * self)
 {
   self->vinfo = NULL;
+  self->max_threads = 1;
 }
 
 void
@@ -374,6 +375,134 @@ get_line (LinesGetter * lg, gint field_offset, guint plane, gint line,
   return data;
 }
 
+typedef struct
+{
+  GstDeinterlaceSimpleMethod *self;
+  GstVideoFrame *dest;
+  LinesGetter *lg;
+  guint cur_field_flags;
+  gint plane;
+  gint width;
+  GstDeinterlaceSimpleMethodFunction copy_scanline;
+  GstDeinterlaceSimpleMethodFunction interpolate_scanline;
+  gint start, end;
+} LinesTask;
+
+static void
+gst_deinterlace_simple_method_lines_task (LinesTask * task)
+{
+  GstDeinterlaceSimpleMethod *self = task->self;
+  GstDeinterlaceScanlineData scanlines;
+  LinesGetter *lg = task->lg;
+  gint plane = task->plane;
+  gint i;
+
+#define LINE(x,i) (((guint8*)GST_VIDEO_FRAME_PLANE_DATA((x),plane)) + i * \
+    GST_VIDEO_FRAME_PLANE_STRIDE((x),plane))
+
+  for (i = task->start; i < task->end; i++) {
+    memset (&scanlines, 0, sizeof (scanlines));
+    scanlines.bottom_field =
+        (task->cur_field_flags == PICTURE_INTERLACED_BOTTOM);
+
+    if (!((i & 1) ^ scanlines.bottom_field)) {
+      /* copying */
+      scanlines.tp = get_line (lg, -1, plane, i, -1);
+      scanlines.bp = get_line (lg, -1, plane, i, 1);
+
+      scanlines.tt0 = get_line (lg, 0, plane, i, -2);
+      scanlines.m0 = get_line (lg, 0, plane, i, 0);
+      scanlines.bb0 = get_line (lg, 0, plane, i, 2);
+
+      scanlines.t1 = get_line (lg, 1, plane, i, -1);
+      scanlines.b1 = get_line (lg, 1, plane, i, 1);
+
+      scanlines.tt2 = get_line (lg, 2, plane, i, -2);
+      scanlines.m2 = get_line (lg, 2, plane, i, 0);
+      scanlines.bb2 = get_line (lg, 2, plane, i, 2);
+
+      task->copy_scanline (self, LINE (task->dest, i), &scanlines,
+          task->width);
+    } else {
+      /* interpolating */
+      scanlines.tp2 = get_line (lg, -2, plane, i, -1);
+      scanlines.bp2 = get_line (lg, -2, plane, i, 1);
+
+      scanlines.ttp = get_line (lg, -1, plane, i, -2);
+      scanlines.mp = get_line (lg, -1, plane, i, 0);
+      scanlines.bbp = get_line (lg, -1, plane, i, 2);
+
+      scanlines.t0 = get_line (lg, 0, plane, i, -1);
+      scanlines.b0 = get_line (lg, 0, plane, i, 1);
+
+      scanlines.tt1 = get_line (lg, 1, plane, i, -2);
+      scanlines.m1 = get_line (lg, 1, plane, i, 0);
+      scanlines.bb1 = get_line (lg, 1, plane, i, 2);
+
+      scanlines.t2 = get_line (lg, 2, plane, i, -1);
+      scanlines.b2 = get_line (lg, 2, plane, i, 1);
+
+      task->interpolate_scanline (self, LINE (task->dest, i), &scanlines,
+          task->width);
+    }
+  }
+#undef LINE
+}
+
+/* Creates the @height lines of @plane, split between up to max-threads
+ * threads. Every output line only depends on the history, so the lines can
+ * be created in any order. */
+static void
+gst_deinterlace_simple_method_deinterlace_lines (GstDeinterlaceSimpleMethod *
+    self, GstVideoFrame * dest, LinesGetter * lg, guint cur_field_flags,
+    gint plane, gint width, GstDeinterlaceSimpleMethodFunction copy_scanline,
+    GstDeinterlaceSimpleMethodFunction interpolate_scanline, gint height)
+{
+  LinesTask *tasks, **tasks_p;
+  guint n_threads, i;
+  gint lines;
+
+  n_threads = gst_video_parallel_get_n_threads (GST_DEINTERLACE_METHOD
+      (self)->max_threads, height);
+
+  if (self->runner
+      && gst_video_parallel_runner_get_n_threads (self->runner) != n_threads) {
+    gst_video_parallel_runner_free (self->runner);
+    self->runner = NULL;
+  }
+  if (n_threads > 1 && !self->runner) {
+    self->runner = gst_video_parallel_runner_new (n_threads, NULL, FALSE);
+    n_threads = gst_video_parallel_runner_get_n_threads (self->runner);
+  }
+
+  lines = (height + n_threads - 1) / n_threads;
+
+  tasks = g_newa (LinesTask, n_threads);
+  tasks_p = g_newa (LinesTask *, n_threads);
+
+  for (i = 0; i < n_threads; i++) {
+    tasks[i].self = self;
+    tasks[i].dest = dest;
+    tasks[i].lg = lg;
+    tasks[i].cur_field_flags = cur_field_flags;
+    tasks[i].plane = plane;
+    tasks[i].width = width;
+    tasks[i].copy_scanline = copy_scanline;
+    tasks[i].interpolate_scanline = interpolate_scanline;
+    tasks[i].start = MIN (i * lines, height);
+    tasks[i].end = MIN ((i + 1) * lines, height);
+
+    tasks_p[i] = &tasks[i];
+  }
+
+  if (n_threads > 1)
+    gst_video_parallel_runner_run (self->runner,
+        (GstVideoParallelFunc) gst_deinterlace_simple_method_lines_task,
+        (gpointer *) tasks_p);
+  else
+    gst_deinterlace_simple_method_lines_task (&tasks[0]);
+}
+
 static void
 gst_deinterlace_simple_method_deinterlace_frame_packed (GstDeinterlaceMethod *
     method, const GstDeinterlaceField * history, guint history_count,
@@ -383,9 +512,7 @@ gst_deinterlace_simple_method_deinterlace_frame_packed (GstDeinterlaceMethod *
 #ifndef G_DISABLE_ASSERT
   GstDeinterlaceMethodClass *dm_class = GST_DEINTERLACE_METHOD_GET_CLASS (self);
 #endif
-  GstDeinterlaceScanlineData scanlines;
   guint cur_field_flags;
-  gint i;
   gint frame_height, frame_width;
   LinesGetter lg = { history, history_count, cur_field_idx };
   GstVideoFrame *framep, *frame0, *frame1, *frame2;
@@ -418,55 +545,9 @@ gst_deinterlace_simple_method_deinterlace_frame_packed (GstDeinterlaceMethod *
   if (frame2)
     frame_width = MIN (frame_width, GST_VIDEO_FRAME_PLANE_STRIDE (frame2, 0));
 
-#define LINE(x,i) (((guint8*)GST_VIDEO_FRAME_PLANE_DATA((x),0)) + i * \
-    GST_VIDEO_FRAME_PLANE_STRIDE((x),0))
-
-  for (i = 0; i < frame_height; i++) {
-    memset (&scanlines, 0, sizeof (scanlines));
-    scanlines.bottom_field = (cur_field_flags == PICTURE_INTERLACED_BOTTOM);
-
-    if (!((i & 1) ^ scanlines.bottom_field)) {
-      /* copying */
-      scanlines.tp = get_line (&lg, -1, 0, i, -1);
-      scanlines.bp = get_line (&lg, -1, 0, i, 1);
-
-      scanlines.tt0 = get_line (&lg, 0, 0, i, -2);
-      scanlines.m0 = get_line (&lg, 0, 0, i, 0);
-      scanlines.bb0 = get_line (&lg, 0, 0, i, 2);
-
-      scanlines.t1 = get_line (&lg, 1, 0, i, -1);
-      scanlines.b1 = get_line (&lg, 1, 0, i, 1);
-
-      scanlines.tt2 = get_line (&lg, 2, 0, i, -2);
-      scanlines.m2 = get_line (&lg, 2, 0, i, 0);
-      scanlines.bb2 = get_line (&lg, 2, 0, i, 2);
-
-      self->copy_scanline_packed (self, LINE (outframe, i), &scanlines,
-          frame_width);
-    } else {
-      /* interpolating */
-      scanlines.tp2 = get_line (&lg, -2, 0, i, -1);
-      scanlines.bp2 = get_line (&lg, -2, 0, i, 1);
-
-      scanlines.ttp = get_line (&lg, -1, 0, i, -2);
-      scanlines.mp = get_line (&lg, -1, 0, i, 0);
-      scanlines.bbp = get_line (&lg, -1, 0, i, 2);
-
-      scanlines.t0 = get_line (&lg, 0, 0, i, -1);
-      scanlines.b0 = get_line (&lg, 0, 0, i, 1);
-
-      scanlines.tt1 = get_line (&lg, 1, 0, i, -2);
-      scanlines.m1 = get_line (&lg, 1, 0, i, 0);
-      scanlines.bb1 = get_line (&lg, 1, 0, i, 2);
-
-      scanlines.t2 = get_line (&lg, 2, 0, i, -1);
-      scanlines.b2 = get_line (&lg, 2, 0, i, 1);
-
-      self->interpolate_scanline_packed (self, LINE (outframe, i), &scanlines,
-          frame_width);
-    }
-#undef LINE
-  }
+  gst_deinterlace_simple_method_deinterlace_lines (self, outframe, &lg,
+      cur_field_flags, 0, frame_width, self->copy_scanline_packed,
+      self->interpolate_scanline_packed, frame_height);
 }
 
 static void
@@ -525,8 +606,6 @@ static void
     GstDeinterlaceSimpleMethodFunction copy_scanline,
     GstDeinterlaceSimpleMethodFunction interpolate_scanline)
 {
-  GstDeinterlaceScanlineData scanlines;
-  gint i;
   gint frame_height, frame_width;
 
   frame_height = GST_VIDEO_FRAME_COMP_HEIGHT (dest, plane);
@@ -536,53 +615,9 @@ static void
   g_assert (interpolate_scanline != NULL);
   g_assert (copy_scanline != NULL);
 
-#define LINE(x,i) (((guint8*)GST_VIDEO_FRAME_PLANE_DATA((x),plane)) + i * \
-    GST_VIDEO_FRAME_PLANE_STRIDE((x),plane))
-
-  for (i = 0; i < frame_height; i++) {
-    memset (&scanlines, 0, sizeof (scanlines));
-    scanlines.bottom_field = (cur_field_flags == PICTURE_INTERLACED_BOTTOM);
-
-    if (!((i & 1) ^ scanlines.bottom_field)) {
-      /* copying */
-      scanlines.tp = get_line (lg, -1, plane, i, -1);
-      scanlines.bp = get_line (lg, -1, plane, i, 1);
-
-      scanlines.tt0 = get_line (lg, 0, plane, i, -2);
-      scanlines.m0 = get_line (lg, 0, plane, i, 0);
-      scanlines.bb0 = get_line (lg, 0, plane, i, 2);
-
-      scanlines.t1 = get_line (lg, 1, plane, i, -1);
-      scanlines.b1 = get_line (lg, 1, plane, i, 1);
-
-      scanlines.tt2 = get_line (lg, 2, plane, i, -2);
-      scanlines.m2 = get_line (lg, 2, plane, i, 0);
-      scanlines.bb2 = get_line (lg, 2, plane, i, 2);
-
-      copy_scanline (self, LINE (dest, i), &scanlines, frame_width);
-    } else {
-      /* interpolating */
-      scanlines.tp2 = get_line (lg, -2, plane, i, -1);
-      scanlines.bp2 = get_line (lg, -2, plane, i, 1);
-
-      scanlines.ttp = get_line (lg, -1, plane, i, -2);
-      scanlines.mp = get_line (lg, -1, plane, i, 0);
-      scanlines.bbp = get_line (lg, -1, plane, i, 2);
-
-      scanlines.t0 = get_line (lg, 0, plane, i, -1);
-      scanlines.b0 = get_line (lg, 0, plane, i, 1);
-
-      scanlines.tt1 = get_line (lg, 1, plane, i, -2);
-      scanlines.m1 = get_line (lg, 1, plane, i, 0);
-      scanlines.bb1 = get_line (lg, 1, plane, i, 2);
-
-      scanlines.t2 = get_line (lg, 2, plane, i, -1);
-      scanlines.b2 = get_line (lg, 2, plane, i, 1);
-
-      interpolate_scanline (self, LINE (dest, i), &scanlines, frame_width);
-    }
-#undef LINE
-  }
+  gst_deinterlace_simple_method_deinterlace_lines (self, dest, lg,
+      cur_field_flags, plane, frame_width, copy_scanline,
+      interpolate_scanline, frame_height);
 }
 
 static void
@@ -748,12 +783,28 @@ gst_deinterlace_simple_method_setup (GstDeinterlaceMethod * method,
   }
 }
 
+static void
+gst_deinterlace_simple_method_finalize (GObject * object)
+{
+  GstDeinterlaceSimpleMethod *self = GST_DEINTERLACE_SIMPLE_METHOD (object);
+
+  if (self->runner)
+    gst_video_parallel_runner_free (self->runner);
+  self->runner = NULL;
+
+  G_OBJECT_CLASS (gst_deinterlace_simple_method_parent_class)->finalize
+      (object);
+}
+
 static void
 gst_deinterlace_simple_method_class_init (GstDeinterlaceSimpleMethodClass
     * klass)
 {
+  GObjectClass *gobject_class = (GObjectClass *) klass;
   GstDeinterlaceMethodClass *dm_class = (GstDeinterlaceMethodClass *) klass;
 
+  gobject_class->finalize = gst_deinterlace_simple_method_finalize;
+
   dm_class->deinterlace_frame_ayuv =
       gst_deinterlace_simple_method_deinterlace_frame_packed;
   dm_class->deinterlace_frame_yuy2 =
@@ -71,6 +71,10 @@ struct _GstDeinterlaceMethod {
 
   GstVideoInfo *vinfo;
 
+  /* Maximum number of threads to split a frame between, 0 for one per CPU.
+   * Set by the element, only used by methods that support it. */
+  guint max_threads;
+
   GstDeinterlaceMethodDeinterlaceFunction deinterlace_frame;
 };
 
@@ -173,6 +177,9 @@ struct _GstDeinterlaceSimpleMethod {
 
   GstDeinterlaceSimpleMethodFunction interpolate_scanline_planar[3];
   GstDeinterlaceSimpleMethodFunction copy_scanline_planar[3];
+
+  /* Only used from the streaming thread */
+  GstVideoParallelRunner *runner;
 };
 
 struct _GstDeinterlaceSimpleMethodClass {
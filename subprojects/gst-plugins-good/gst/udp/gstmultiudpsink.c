@@ -28,6 +28,12 @@
  * multiudpsink is a network sink that sends UDP packets to multiple
  * clients.
  * It can be combined with rtp payload encoders to implement RTP streaming.
+ *
+ * On Linux, #GstMultiUDPSink:gso lets the kernel do the UDP segmentation:
+ * consecutive packets of the same size in a buffer list that go to the same
+ * client are then handed to the kernel in one go, which considerably reduces
+ * the per-packet cost for high bitrate streams. The number of send calls per
+ * client is available in the #GstMultiUDPSink::get-stats structure.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -37,6 +43,7 @@
 #include "gstmultiudpsink.h"
 
 #include <string.h>
+#include <errno.h>
 
 #ifdef HAVE_SYS_SOCKET_H
 #include <sys/socket.h>
@@ -44,6 +51,10 @@
 
 #include <gio/gnetworking.h>
 
+#ifndef G_PLATFORM_WIN32
+#include <netinet/udp.h>
+#endif
+
 #include "gst/net/net.h"
 #include "gst/glib-compat-private.h"
 
@@ -52,6 +63,11 @@ GST_DEBUG_CATEGORY_STATIC (multiudpsink_debug);
 
 #define UDP_MAX_SIZE 65507
 
+/* maximum number of segments the kernel accepts in one GSO send */
+#define UDP_MAX_SEGMENTS 64
+/* maximum number of different segment sizes we keep control messages for */
+#define UDP_MAX_SEGMENT_MESSAGES 16
+
 static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -92,6 +108,7 @@ enum
 #define DEFAULT_BUFFER_SIZE        0
 #define DEFAULT_BIND_ADDRESS       NULL
 #define DEFAULT_BIND_PORT          0
+#define DEFAULT_GSO                FALSE
 
 enum
 {
@@ -114,7 +131,8 @@ enum
   PROP_SEND_DUPLICATES,
   PROP_BUFFER_SIZE,
   PROP_BIND_ADDRESS,
-  PROP_BIND_PORT
+  PROP_BIND_PORT,
+  PROP_GSO
 };
 
 static void gst_multiudpsink_finalize (GObject * object);
@@ -141,6 +159,88 @@ static void gst_multiudpsink_clear_internal (GstMultiUDPSink * sink,
 
 static guint gst_multiudpsink_signals[LAST_SIGNAL] = { 0 };
 
+/* Control message for passing the segment size of GSO sends */
+#ifdef UDP_SEGMENT
+GType gst_udp_segment_message_get_type (void);
+
+#define GST_TYPE_UDP_SEGMENT_MESSAGE          (gst_udp_segment_message_get_type ())
+#define GST_UDP_SEGMENT_MESSAGE(o)            (G_TYPE_CHECK_INSTANCE_CAST ((o), GST_TYPE_UDP_SEGMENT_MESSAGE, GstUDPSegmentMessage))
+#define GST_UDP_SEGMENT_MESSAGE_CLASS(c)      (G_TYPE_CHECK_CLASS_CAST ((c), GST_TYPE_UDP_SEGMENT_MESSAGE, GstUDPSegmentMessageClass))
+#define GST_IS_UDP_SEGMENT_MESSAGE(o)         (G_TYPE_CHECK_INSTANCE_TYPE ((o), GST_TYPE_UDP_SEGMENT_MESSAGE))
+#define GST_IS_UDP_SEGMENT_MESSAGE_CLASS(c)   (G_TYPE_CHECK_CLASS_TYPE ((c), GST_TYPE_UDP_SEGMENT_MESSAGE))
+#define GST_UDP_SEGMENT_MESSAGE_GET_CLASS(o)  (G_TYPE_INSTANCE_GET_CLASS ((o), GST_TYPE_UDP_SEGMENT_MESSAGE, GstUDPSegmentMessageClass))
+
+typedef struct _GstUDPSegmentMessage GstUDPSegmentMessage;
+typedef struct _GstUDPSegmentMessageClass GstUDPSegmentMessageClass;
+
+struct _GstUDPSegmentMessageClass
+{
+  GSocketControlMessageClass parent_class;
+};
+
+struct _GstUDPSegmentMessage
+{
+  GSocketControlMessage parent;
+  guint16 segment_size;
+};
+
+G_DEFINE_TYPE (GstUDPSegmentMessage, gst_udp_segment_message,
+    G_TYPE_SOCKET_CONTROL_MESSAGE);
+
+static gsize
+gst_udp_segment_message_get_size (GSocketControlMessage * message)
+{
+  return sizeof (guint16);
+}
+
+static int
+gst_udp_segment_message_get_level (GSocketControlMessage * message)
+{
+  return IPPROTO_UDP;
+}
+
+static int
+gst_udp_segment_message_get_msg_type (GSocketControlMessage * message)
+{
+  return UDP_SEGMENT;
+}
+
+static void
+gst_udp_segment_message_serialize (GSocketControlMessage * message,
+    gpointer data)
+{
+  GstUDPSegmentMessage *msg = GST_UDP_SEGMENT_MESSAGE (message);
+
+  memcpy (data, &msg->segment_size, sizeof (guint16));
+}
+
+static GSocketControlMessage *
+gst_udp_segment_message_deserialize (gint level,
+    gint type, gsize size, gpointer data)
+{
+  /* only ever sent, never received */
+  return NULL;
+}
+
+static void
+gst_udp_segment_message_init (GstUDPSegmentMessage * message)
+{
+}
+
+static void
+gst_udp_segment_message_class_init (GstUDPSegmentMessageClass * class)
+{
+  GSocketControlMessageClass *scm_class;
+
+  scm_class = G_SOCKET_CONTROL_MESSAGE_CLASS (class);
+  scm_class->get_size = gst_udp_segment_message_get_size;
+  scm_class->get_level = gst_udp_segment_message_get_level;
+  scm_class->get_type = gst_udp_segment_message_get_msg_type;
+  scm_class->serialize = gst_udp_segment_message_serialize;
+  scm_class->deserialize = gst_udp_segment_message_deserialize;
+}
+#endif
+
 #define gst_multiudpsink_parent_class parent_class
 G_DEFINE_TYPE (GstMultiUDPSink, gst_multiudpsink, GST_TYPE_BASE_SINK);
 GST_ELEMENT_REGISTER_DEFINE_WITH_CODE (multiudpsink, "multiudpsink",
@@ -216,7 +316,10 @@ gst_multiudpsink_class_init (GstMultiUDPSinkClass * klass)
    *
    * Returns: a GstStructure: bytes_sent, packets_sent, connect_time
    *           (in epoch nanoseconds), disconnect_time (in epoch
-   *           nanoseconds)
+   *           nanoseconds), send-calls (number of sends the packets were
+   *           handed to the kernel in, less than packets-sent when
+   *           #GstMultiUDPSink:gso coalesced packets; since 1.24) and
+   *           packets-per-send (since 1.24)
    */
   gst_multiudpsink_signals[SIGNAL_GET_STATS] =
       g_signal_new ("get-stats", G_TYPE_FROM_CLASS (klass),
@@ -351,6 +454,22 @@ gst_multiudpsink_class_init (GstMultiUDPSinkClass * klass)
           "Port to bind the socket to", 0, G_MAXUINT16,
           DEFAULT_BIND_PORT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstMultiUDPSink:gso:
+   *
+   * Use UDP Generic Segmentation Offload: runs of consecutive packets of the
+   * same size for the same client are handed to the kernel as one send and
+   * split into separate packets by the kernel or the network card. Falls
+   * back to sending each packet separately if the kernel does not support
+   * it. Only supported on Linux.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_GSO,
+      g_param_spec_boolean ("gso", "Generic Segmentation Offload",
+          "Let the kernel split batches of equally sized packets (Linux only)",
+          DEFAULT_GSO, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class, &sink_template);
 
   gst_element_class_set_static_metadata (gstelement_class, "UDP packet sender",
@@ -371,6 +490,10 @@ gst_multiudpsink_class_init (GstMultiUDPSinkClass * klass)
   klass->get_stats = gst_multiudpsink_get_stats;
 
   GST_DEBUG_CATEGORY_INIT (multiudpsink_debug, "multiudpsink", 0, "UDP sink");
+
+#ifdef UDP_SEGMENT
+  GST_TYPE_UDP_SEGMENT_MESSAGE;
+#endif
 }
 
 static void
@@ -419,6 +542,7 @@ gst_multiudpsink_init (GstMultiUDPSink * sink)
   sink->qos_dscp = DEFAULT_QOS_DSCP;
   sink->send_duplicates = DEFAULT_SEND_DUPLICATES;
   sink->multi_iface = g_strdup (DEFAULT_MULTICAST_IFACE);
+  sink->gso = DEFAULT_GSO;
 
 //CRESTRON BEGIN
   //gst_multiudpsink_create_cancellable (sink);
@@ -437,6 +561,9 @@ gst_multiudpsink_init (GstMultiUDPSink * sink)
 
   sink->n_messages = 1;
   sink->messages = g_new (GstOutputMessage, sink->n_messages);
+  sink->num_segments = g_new (guint8, sink->n_messages);
+
+  sink->segment_messages = g_ptr_array_new_with_free_func (g_object_unref);
 
   /* we assume that the number of memories per buffer can fit into a guint8 */
   g_warn_if_fail (max_mem <= G_MAXUINT8);
@@ -566,6 +693,17 @@ gst_multiudpsink_finalize (GObject * object)
   sink->maps = NULL;
   g_free (sink->messages);
   sink->messages = NULL;
+  g_free (sink->num_segments);
+  sink->num_segments = NULL;
+
+  g_free (sink->gso_messages);
+  sink->gso_messages = NULL;
+  g_free (sink->gso_cmsgs);
+  sink->gso_cmsgs = NULL;
+  g_free (sink->gso_firsts);
+  sink->gso_firsts = NULL;
+  g_ptr_array_unref (sink->segment_messages);
+  sink->segment_messages = NULL;
 
   g_free (sink->bind_address);
   sink->bind_address = NULL;
@@ -723,11 +861,224 @@ gst_multiudpsink_send_messages (GstMultiUDPSink * sink, GSocket * socket,
   return GST_FLOW_OK;
 }
 
+#ifdef UDP_SEGMENT
+static GSocketControlMessage *
+gst_multiudpsink_get_segment_message (GstMultiUDPSink * sink,
+    guint16 segment_size)
+{
+  GstUDPSegmentMessage *msg;
+  guint i;
+
+  for (i = 0; i < sink->segment_messages->len; i++) {
+    msg = g_ptr_array_index (sink->segment_messages, i);
+    if (msg->segment_size == segment_size)
+      return G_SOCKET_CONTROL_MESSAGE (msg);
+  }
+
+  msg = g_object_new (GST_TYPE_UDP_SEGMENT_MESSAGE, NULL);
+  msg->segment_size = segment_size;
+  g_ptr_array_add (sink->segment_messages, msg);
+
+  return G_SOCKET_CONTROL_MESSAGE (msg);
+}
+
+/* Coalesces runs of consecutive messages to the same address into GSO
+ * messages in sink->gso_messages. All but the last message of a run must
+ * have the same size and their vectors must follow each other. The index of
+ * the first message of @messages in coalesced message i is stored in
+ * sink->gso_firsts[i]. Returns the number of coalesced messages. */
+static guint
+gst_multiudpsink_coalesce_messages (GstMultiUDPSink * sink,
+    GstOutputMessage * messages, guint num_messages)
+{
+  guint i, n;
+
+  if (sink->n_gso_messages < num_messages) {
+    sink->n_gso_messages = GST_ROUND_UP_16 (num_messages);
+    g_free (sink->gso_messages);
+    sink->gso_messages = g_new (GstOutputMessage, sink->n_gso_messages);
+    g_free (sink->gso_cmsgs);
+    sink->gso_cmsgs = g_new (GSocketControlMessage *, sink->n_gso_messages);
+    g_free (sink->gso_firsts);
+    sink->gso_firsts = g_new (guint, sink->n_gso_messages + 1);
+  }
+
+  /* only done between sends, none of the messages are referenced anymore */
+  if (sink->segment_messages->len > UDP_MAX_SEGMENT_MESSAGES)
+    g_ptr_array_set_size (sink->segment_messages, 0);
+
+  for (i = 0, n = 0; i < num_messages; n++) {
+    GstOutputMessage *first = &messages[i];
+    gsize segment_size, total_size;
+    guint end, num_vectors;
+
+    segment_size = total_size = gst_udp_calc_message_size (first);
+    num_vectors = first->num_vectors;
+
+    for (end = i + 1; end < num_messages && end - i < UDP_MAX_SEGMENTS; end++) {
+      GstOutputMessage *msg = &messages[end];
+      gsize size;
+
+      if (segment_size == 0 || segment_size > G_MAXUINT16)
+        break;
+      if (msg->address != first->address
+          || msg->vectors != first->vectors + num_vectors)
+        break;
+
+      size = gst_udp_calc_message_size (msg);
+      if (size == 0 || size > segment_size || total_size + size > UDP_MAX_SIZE)
+        break;
+
+      total_size += size;
+      num_vectors += msg->num_vectors;
+
+      /* only the last segment may be shorter */
+      if (size < segment_size) {
+        end++;
+        break;
+      }
+    }
+
+    sink->gso_messages[n] = *first;
+    sink->gso_firsts[n] = i;
+
+    if (end - i > 1) {
+      sink->gso_cmsgs[n] =
+          gst_multiudpsink_get_segment_message (sink, segment_size);
+      sink->gso_messages[n].num_vectors = num_vectors;
+      sink->gso_messages[n].control_messages = &sink->gso_cmsgs[n];
+      sink->gso_messages[n].num_control_messages = 1;
+    }
+
+    i = end;
+  }
+  sink->gso_firsts[n] = num_messages;
+
+  return n;
+}
+
+/* errors that mean UDP_SEGMENT can't be used at all. The GError doesn't
+ * carry the errno and GIO reports EIO and ENOPROTOOPT like any other failure,
+ * so check the errno string GSocket puts at the end of the message */
+static gboolean
+gst_multiudpsink_is_gso_unsupported_error (GError * err)
+{
+  static const gint unsupported_errnos[] =
+      { EIO, EINVAL, ENOPROTOOPT, EOPNOTSUPP };
+  guint i;
+
+  if (err->domain != G_IO_ERROR)
+    return FALSE;
+
+  for (i = 0; i < G_N_ELEMENTS (unsupported_errnos); i++) {
+    if (g_str_has_suffix (err->message, g_strerror (unsupported_errnos[i])))
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
+/* Like gst_multiudpsink_send_messages() but coalesces the messages into GSO
+ * sends. If the kernel rejects a GSO send, GSO is disabled and the remaining
+ * messages are sent one by one. @num_segments receives for each message the
+ * number of packets that were sent along with it, 0 for the ones that were
+ * sent as part of a previous message. */
+static GstFlowReturn
+gst_multiudpsink_send_messages_gso (GstMultiUDPSink * sink, GSocket * socket,
+    GstOutputMessage * messages, guint num_messages, guint8 * num_segments)
+{
+  GstOutputMessage *gso_messages;
+  guint num_gso_messages, sent = 0;
+
+  num_gso_messages =
+      gst_multiudpsink_coalesce_messages (sink, messages, num_messages);
+  gso_messages = sink->gso_messages;
+
+  GST_LOG_OBJECT (sink, "coalesced %u messages into %u", num_messages,
+      num_gso_messages);
+
+  while (sent < num_gso_messages) {
+    GError *err = NULL;
+    guint i, j;
+    gint ret;
+
+    ret = g_socket_send_messages (socket, gso_messages + sent,
+        num_gso_messages - sent, 0, sink->cancellable, &err);
+
+    if (G_UNLIKELY (ret < 0)) {
+      guint first;
+
+      if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        GstFlowReturn flow_ret;
+
+        g_clear_error (&err);
+
+        flow_ret = gst_base_sink_wait_preroll (GST_BASE_SINK (sink));
+
+        if (flow_ret == GST_FLOW_OK)
+          continue;
+
+        return flow_ret;
+      }
+
+      /* The kernel might support UDP_SEGMENT but not for this route, e.g.
+       * when the device can't do checksum offloading. Go back to normal
+       * sends for good then. The error handling in there takes care of
+       * any other kind of error, like unreachable hosts */
+      if (gso_messages[sent].num_control_messages > 0
+          && gst_multiudpsink_is_gso_unsupported_error (err)) {
+        GST_WARNING_OBJECT (sink, "GSO send failed, disabling GSO: %s",
+            err->message);
+        sink->gso_supported = FALSE;
+      }
+      g_clear_error (&err);
+
+      first = sink->gso_firsts[sent];
+      return gst_multiudpsink_send_messages (sink, socket, messages + first,
+          num_messages - first);
+    }
+
+    /* distribute the bytes sent over the original messages */
+    for (i = sent; i < sent + ret; i++) {
+      gsize bytes_sent = gso_messages[i].bytes_sent;
+      guint first = sink->gso_firsts[i], last = sink->gso_firsts[i + 1];
+
+      for (j = first; j < last; j++) {
+        gsize size = gst_udp_calc_message_size (&messages[j]);
+
+        messages[j].bytes_sent = MIN (size, bytes_sent);
+        bytes_sent -= messages[j].bytes_sent;
+        num_segments[j] = 0;
+      }
+      num_segments[first] = last - first;
+    }
+
+    sent += ret;
+  }
+
+  return GST_FLOW_OK;
+}
+#endif
+
+static GstFlowReturn
+gst_multiudpsink_send (GstMultiUDPSink * sink, GSocket * socket,
+    GstOutputMessage * messages, guint num_messages, guint8 * num_segments)
+{
+#ifdef UDP_SEGMENT
+  if (sink->gso && sink->gso_supported && num_messages > 1)
+    return gst_multiudpsink_send_messages_gso (sink, socket, messages,
+        num_messages, num_segments);
+#endif
+
+  return gst_multiudpsink_send_messages (sink, socket, messages, num_messages);
+}
+
 static GstFlowReturn
 gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
     guint num_buffers, guint8 * mem_nums, guint total_mem_num)
 {
   GstOutputMessage *msgs;
+  guint8 *num_segments;
   gboolean send_duplicates;
   GstUDPClient **clients;
   GOutputVector *vecs;
@@ -790,8 +1141,12 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
     sink->n_messages = GST_ROUND_UP_16 (num_msgs);
     g_free (sink->messages);
     sink->messages = g_new (GstOutputMessage, sink->n_messages);
+    g_free (sink->num_segments);
+    sink->num_segments = g_new (guint8, sink->n_messages);
   }
   msgs = sink->messages;
+  num_segments = sink->num_segments;
+  memset (num_segments, 1, num_msgs);
 
   /* populate first num_buffers messages with output vectors for the buffers */
   for (i = 0, mem = 0; i < num_buffers; ++i) {
@@ -821,21 +1176,21 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
 
   /* no IPv4 socket? Send it all from the IPv6 socket then.. */
   if (sink->used_socket == NULL) {
-    flow_ret = gst_multiudpsink_send_messages (sink, sink->used_socket_v6,
-        msgs, num_msgs);
+    flow_ret = gst_multiudpsink_send (sink, sink->used_socket_v6,
+        msgs, num_msgs, num_segments);
   } else {
     guint num_msgs_v4 = num_buffers * num_addr_v4;
     guint num_msgs_v6 = num_buffers * num_addr_v6;
 
     /* our client list is sorted with IPv4 clients first and IPv6 ones last */
-    flow_ret = gst_multiudpsink_send_messages (sink, sink->used_socket,
-        msgs, num_msgs_v4);
+    flow_ret = gst_multiudpsink_send (sink, sink->used_socket,
+        msgs, num_msgs_v4, num_segments);
 
     if (flow_ret != GST_FLOW_OK)
       goto cancelled;
 
-    flow_ret = gst_multiudpsink_send_messages (sink, sink->used_socket_v6,
-        msgs + num_msgs_v4, num_msgs_v6);
+    flow_ret = gst_multiudpsink_send (sink, sink->used_socket_v6,
+        msgs + num_msgs_v4, num_msgs_v6, num_segments + num_msgs_v4);
   }
 
   if (flow_ret != GST_FLOW_OK)
@@ -854,6 +1209,8 @@ gst_multiudpsink_render_buffers (GstMultiUDPSink * sink, GstBuffer ** buffers,
 
       client->bytes_sent += bytes_sent;
       client->packets_sent++;
+      if (num_segments[i * num_buffers + j] > 0)
+        client->send_calls++;
       sink->bytes_served += bytes_sent;
     }
     gst_udp_client_unref (client);
@@ -1103,6 +1460,9 @@ gst_multiudpsink_set_property (GObject * object, guint prop_id,
     case PROP_BIND_PORT:
       udpsink->bind_port = g_value_get_int (value);
       break;
+    case PROP_GSO:
+      udpsink->gso = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1176,6 +1536,9 @@ gst_multiudpsink_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_BIND_PORT:
       g_value_set_int (value, udpsink->bind_port);
       break;
+    case PROP_GSO:
+      g_value_set_boolean (value, udpsink->gso);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1240,6 +1603,27 @@ invalid_family:
   }
 }
 
+#ifdef UDP_SEGMENT
+static gboolean
+gst_multiudpsink_socket_supports_gso (GSocket * socket)
+{
+  GError *err = NULL;
+  gint value;
+
+  if (socket == NULL)
+    return TRUE;
+
+  /* fails with ENOPROTOOPT on kernels without UDP_SEGMENT */
+  if (!g_socket_get_option (socket, IPPROTO_UDP, UDP_SEGMENT, &value, &err)) {
+    GST_DEBUG ("UDP_SEGMENT not supported: %s", err->message);
+    g_clear_error (&err);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+#endif
+
 /* create a socket for sending to remote machine */
 static gboolean
 gst_multiudpsink_start (GstBaseSink * bsink)
@@ -1449,6 +1833,16 @@ gst_multiudpsink_start (GstBaseSink * bsink)
   gst_multiudpsink_setup_qos_dscp (sink, sink->used_socket);
   gst_multiudpsink_setup_qos_dscp (sink, sink->used_socket_v6);
 
+#ifdef UDP_SEGMENT
+  sink->gso_supported =
+      gst_multiudpsink_socket_supports_gso (sink->used_socket) &&
+      gst_multiudpsink_socket_supports_gso (sink->used_socket_v6);
+#else
+  sink->gso_supported = FALSE;
+#endif
+  if (sink->gso && !sink->gso_supported)
+    GST_INFO_OBJECT (sink, "GSO not supported, sending packets separately");
+
   /* look for multicast clients and join multicast groups appropriately
      set also ttl and multicast loopback delivery appropriately  */
   for (clients = sink->clients; clients; clients = g_list_next (clients)) {
@@ -1784,6 +2178,9 @@ gst_multiudpsink_get_stats (GstMultiUDPSink * sink, const gchar * host,
   gst_structure_set (result,
       "bytes-sent", G_TYPE_UINT64, client->bytes_sent,
       "packets-sent", G_TYPE_UINT64, client->packets_sent,
+      "send-calls", G_TYPE_UINT64, client->send_calls,
+      "packets-per-send", G_TYPE_DOUBLE, client->send_calls > 0 ?
+      (gdouble) client->packets_sent / client->send_calls : 0.0,
       "connect-time", G_TYPE_UINT64, client->connect_time,
       "disconnect-time", G_TYPE_UINT64, client->disconnect_time, NULL);
 
@@ -51,6 +51,7 @@ typedef struct {
   /* Per-client stats */
   guint64 bytes_sent;
   guint64 packets_sent;
+  guint64 send_calls;     /* packets_sent minus packets coalesced by GSO */
   guint64 connect_time;
   guint64 disconnect_time;
 } GstUDPClient;
@@ -81,6 +82,15 @@ struct _GstMultiUDPSink {
   guint             n_maps;
   GstOutputMessage *messages;
   guint             n_messages;
+  guint8           *num_segments;  /* per message, packets sent along with it */
+
+  /* UDP segmentation offload scratch space */
+  GstOutputMessage      *gso_messages;
+  GSocketControlMessage **gso_cmsgs;
+  guint                 *gso_firsts;
+  guint                  n_gso_messages;
+  GPtrArray             *segment_messages;
+  gboolean               gso_supported;
 
   /* properties */
   guint64        bytes_to_serve;
@@ -102,6 +112,7 @@ struct _GstMultiUDPSink {
   gint           buffer_size;
   gchar         *bind_address;
   gint           bind_port;
+  gboolean       gso;
 };
 
 struct _GstMultiUDPSinkClass {
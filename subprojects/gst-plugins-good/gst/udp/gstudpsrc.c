@@ -76,6 +76,12 @@
  * The message is typically used to detect that no UDP arrives in the receiver
  * because it is blocked by a firewall.
  *
+ * For high packet rates, #GstUDPSrc:max-batch-size can be set to receive
+ * multiple packets with one system call. They are then pushed downstream
+ * together in a #GstBufferList, with the memory of all packets allocated from
+ * a shared slab. On Linux, #GstUDPSrc:gro additionally lets the kernel
+ * coalesce packets of the same flow.
+ *
  * A custom file descriptor can be configured with the
  * #GstUDPSrc:socket property. The socket will be closed when setting
  * the element to READY by default. This behaviour can be overridden
@@ -125,6 +131,7 @@
  * on non-Windows and can be included after glib.h */
 #ifndef G_PLATFORM_WIN32
 #include <netinet/ip.h>
+#include <netinet/udp.h>
 #endif
 
 /* Control messages for getting the destination address */
@@ -507,6 +514,91 @@ gst_socket_timestamp_message_class_init (GstSocketTimestampMessageClass * class)
 }
 #endif
 
+/* Control message for getting the segment size of GRO coalesced packets */
+#ifdef UDP_GRO
+GType gst_udp_gro_message_get_type (void);
+
+#define GST_TYPE_UDP_GRO_MESSAGE          (gst_udp_gro_message_get_type ())
+#define GST_UDP_GRO_MESSAGE(o)            (G_TYPE_CHECK_INSTANCE_CAST ((o), GST_TYPE_UDP_GRO_MESSAGE, GstUDPGROMessage))
+#define GST_UDP_GRO_MESSAGE_CLASS(c)      (G_TYPE_CHECK_CLASS_CAST ((c), GST_TYPE_UDP_GRO_MESSAGE, GstUDPGROMessageClass))
+#define GST_IS_UDP_GRO_MESSAGE(o)         (G_TYPE_CHECK_INSTANCE_TYPE ((o), GST_TYPE_UDP_GRO_MESSAGE))
+#define GST_IS_UDP_GRO_MESSAGE_CLASS(c)   (G_TYPE_CHECK_CLASS_TYPE ((c), GST_TYPE_UDP_GRO_MESSAGE))
+#define GST_UDP_GRO_MESSAGE_GET_CLASS(o)  (G_TYPE_INSTANCE_GET_CLASS ((o), GST_TYPE_UDP_GRO_MESSAGE, GstUDPGROMessageClass))
+
+typedef struct _GstUDPGROMessage GstUDPGROMessage;
+typedef struct _GstUDPGROMessageClass GstUDPGROMessageClass;
+
+struct _GstUDPGROMessageClass
+{
+  GSocketControlMessageClass parent_class;
+};
+
+struct _GstUDPGROMessage
+{
+  GSocketControlMessage parent;
+  gint segment_size;
+};
+
+G_DEFINE_TYPE (GstUDPGROMessage, gst_udp_gro_message,
+    G_TYPE_SOCKET_CONTROL_MESSAGE);
+
+static gsize
+gst_udp_gro_message_get_size (GSocketControlMessage * message)
+{
+  return sizeof (int);
+}
+
+static int
+gst_udp_gro_message_get_level (GSocketControlMessage * message)
+{
+  return IPPROTO_UDP;
+}
+
+static int
+gst_udp_gro_message_get_msg_type (GSocketControlMessage * message)
+{
+  return UDP_GRO;
+}
+
+static GSocketControlMessage *
+gst_udp_gro_message_deserialize (gint level,
+    gint type, gsize size, gpointer data)
+{
+  GstUDPGROMessage *message;
+  int segment_size;
+
+  if (level != IPPROTO_UDP || type != UDP_GRO)
+    return NULL;
+
+  if (size < sizeof (int))
+    return NULL;
+
+  memcpy (&segment_size, data, sizeof (int));
+
+  message = g_object_new (GST_TYPE_UDP_GRO_MESSAGE, NULL);
+  message->segment_size = segment_size;
+
+  return G_SOCKET_CONTROL_MESSAGE (message);
+}
+
+static void
+gst_udp_gro_message_init (GstUDPGROMessage * message)
+{
+}
+
+static void
+gst_udp_gro_message_class_init (GstUDPGROMessageClass * class)
+{
+  GSocketControlMessageClass *scm_class;
+
+  scm_class = G_SOCKET_CONTROL_MESSAGE_CLASS (class);
+  scm_class->get_size = gst_udp_gro_message_get_size;
+  scm_class->get_level = gst_udp_gro_message_get_level;
+  scm_class->get_type = gst_udp_gro_message_get_msg_type;
+  scm_class->deserialize = gst_udp_gro_message_deserialize;
+}
+#endif
+
 static gboolean
 gst_udpsrc_decide_allocation (GstBaseSrc * bsrc, GstQuery * query)
 {
@@ -547,6 +639,14 @@ gst_udpsrc_decide_allocation (GstBaseSrc * bsrc, GstQuery * query)
 /* not 100% correct, but a good upper bound for memory allocation purposes */
 #define MAX_IPV4_UDP_PACKET_SIZE (65536 - 8)
 
+/* maximum number of messages received with one g_socket_receive_messages() */
+#define UDP_MAX_BATCH_SIZE 64
+/* number of full batches that fit in one receive slab */
+#define UDP_SLAB_BATCHES 4
+/* every pushed buffer keeps its whole slab alive, so don't let the slabs
+ * grow too big with GRO where each message can take 64 KiB */
+#define UDP_MAX_SLAB_SIZE (2 * 1024 * 1024)
+
 GST_DEBUG_CATEGORY_STATIC (udpsrc_debug);
 #define GST_CAT_DEFAULT (udpsrc_debug)
 
@@ -571,6 +671,8 @@ static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
 #define UDP_DEFAULT_LOOP               TRUE
 #define UDP_DEFAULT_RETRIEVE_SENDER_ADDRESS TRUE
 #define UDP_DEFAULT_MTU                (1492)
+#define UDP_DEFAULT_MAX_BATCH_SIZE     1
+#define UDP_DEFAULT_GRO                FALSE
 
 enum
 {
@@ -594,6 +696,8 @@ enum
   PROP_RETRIEVE_SENDER_ADDRESS,
   PROP_MTU,
   PROP_SOCKET_TIMESTAMP,
+  PROP_MAX_BATCH_SIZE,
+  PROP_GRO,
 };
 
 static void gst_udpsrc_uri_handler_init (gpointer g_iface, gpointer iface_data);
@@ -602,6 +706,7 @@ static GstCaps *gst_udpsrc_getcaps (GstBaseSrc * src, GstCaps * filter);
 static gboolean gst_udpsrc_close (GstUDPSrc * src);
 static gboolean gst_udpsrc_unlock (GstBaseSrc * bsrc);
 static gboolean gst_udpsrc_unlock_stop (GstBaseSrc * bsrc);
+static GstFlowReturn gst_udpsrc_create (GstPushSrc * psrc, GstBuffer ** buf);
 static GstFlowReturn gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf);
 
 static void gst_udpsrc_finalize (GObject * object);
@@ -647,6 +752,9 @@ gst_udpsrc_class_init (GstUDPSrcClass * klass)
 #ifdef SO_TIMESTAMPNS
   GST_TYPE_SOCKET_TIMESTAMP_MESSAGE;
 #endif
+#ifdef UDP_GRO
+  GST_TYPE_UDP_GRO_MESSAGE;
+#endif
 
   gobject_class->set_property = gst_udpsrc_set_property;
   gobject_class->get_property = gst_udpsrc_get_property;
@@ -780,6 +888,49 @@ gst_udpsrc_class_init (GstUDPSrcClass * klass)
           GST_SOCKET_TIMESTAMP_MODE, GST_SOCKET_TIMESTAMP_MODE_REALTIME,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstUDPSrc:max-batch-size:
+   *
+   * Maximum number of packets to receive with a single system call. When
+   * bigger than 1, the packets are received into a shared slab of memory
+   * and pushed downstream together as a #GstBufferList.
+   *
+   * Packets bigger than #GstUDPSrc:mtu are dropped in this mode.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_BATCH_SIZE,
+      g_param_spec_uint ("max-batch-size", "Maximum Batch Size",
+          "Maximum number of packets to receive at once and push downstream "
+          "as a buffer list (1 = push each packet separately)",
+          1, UDP_MAX_BATCH_SIZE, UDP_DEFAULT_MAX_BATCH_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstUDPSrc:gro:
+   *
+   * Enable UDP Generic Receive Offload, letting the kernel coalesce
+   * consecutive packets of the same flow into one receive. The packets are
+   * split again into separate buffers and pushed downstream as a
+   * #GstBufferList. Only supported on Linux.
+   *
+   * Every message needs room for a full 64 KiB datagram, so fewer messages
+   * than #GstUDPSrc:max-batch-size might be received at once. The buffers
+   * point into receive slabs of up to 2 MiB, and a single buffer that is
+   * kept downstream keeps its whole slab allocated.
+   *
+   * When GRO can't be enabled on the socket, the property keeps its value
+   * and the packets are received without it.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_GRO,
+      g_param_spec_boolean ("gro", "Generic Receive Offload",
+          "Let the kernel coalesce received packets (Linux only)",
+          UDP_DEFAULT_GRO, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   gst_element_class_add_static_pad_template (gstelement_class, &src_template);
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -795,6 +946,7 @@ gst_udpsrc_class_init (GstUDPSrcClass * klass)
   gstbasesrc_class->get_caps = gst_udpsrc_getcaps;
   gstbasesrc_class->decide_allocation = gst_udpsrc_decide_allocation;
 
+  gstpushsrc_class->create = gst_udpsrc_create;
   gstpushsrc_class->fill = gst_udpsrc_fill;
 
   gst_type_mark_as_plugin_api (GST_TYPE_SOCKET_TIMESTAMP_MODE, 0);
@@ -822,6 +974,8 @@ gst_udpsrc_init (GstUDPSrc * udpsrc)
   udpsrc->loop = UDP_DEFAULT_LOOP;
   udpsrc->retrieve_sender_address = UDP_DEFAULT_RETRIEVE_SENDER_ADDRESS;
   udpsrc->mtu = UDP_DEFAULT_MTU;
+  udpsrc->max_batch_size = UDP_DEFAULT_MAX_BATCH_SIZE;
+  udpsrc->gro = UDP_DEFAULT_GRO;
 
   /* configure basesrc to be a live source */
   gst_base_src_set_live (GST_BASE_SRC (udpsrc), TRUE);
@@ -913,6 +1067,446 @@ gst_udpsrc_free_cancellable (GstUDPSrc * src)
   src->cancellable = NULL;
 }
 
+/* optimization: use messages only in multicast mode and
+ * if we can't let the kernel do the filtering for us */
+static gboolean
+gst_udpsrc_need_control_messages (GstUDPSrc * udpsrc)
+{
+  GInetAddress *iaddr = g_inet_socket_address_get_address (udpsrc->addr);
+  gboolean res;
+
+  res = g_inet_address_get_is_multicast (iaddr);
+#ifdef IP_MULTICAST_ALL
+  if (g_inet_address_get_family (iaddr) == G_SOCKET_FAMILY_IPV4)
+    res = FALSE;
+#endif
+#ifdef SO_TIMESTAMPNS
+  if (udpsrc->socket_timestamp_mode == GST_SOCKET_TIMESTAMP_MODE_REALTIME)
+    res = TRUE;
+#endif
+
+  return res;
+}
+
+/* Goes over the control messages received with a packet. Stores the
+ * timestamp from the socket in @dts and the GRO segment size in
+ * @segment_size if there are any. Returns %TRUE if the packet was not sent
+ * to our multicast address and must be skipped. */
+static gboolean
+gst_udpsrc_parse_control_messages (GstUDPSrc * udpsrc,
+    GSocketControlMessage ** msgs, gint n_msgs, GstClockTime * dts,
+    guint * segment_size)
+{
+  GInetAddress *iaddr = g_inet_socket_address_get_address (udpsrc->addr);
+  gboolean skip_packet = FALSE;
+  gsize iaddr_size = g_inet_address_get_native_size (iaddr);
+  const guint8 *iaddr_bytes = g_inet_address_to_bytes (iaddr);
+  gint i;
+
+  for (i = 0; i < n_msgs && !skip_packet; i++) {
+#ifdef IP_PKTINFO
+    if (GST_IS_IP_PKTINFO_MESSAGE (msgs[i])) {
+      GstIPPktinfoMessage *msg = GST_IP_PKTINFO_MESSAGE (msgs[i]);
+
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
+#endif
+#ifdef IPV6_PKTINFO
+    if (GST_IS_IPV6_PKTINFO_MESSAGE (msgs[i])) {
+      GstIPV6PktinfoMessage *msg = GST_IPV6_PKTINFO_MESSAGE (msgs[i]);
+
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
+#endif
+#ifdef IP_RECVDSTADDR
+    if (GST_IS_IP_RECVDSTADDR_MESSAGE (msgs[i])) {
+      GstIPRecvdstaddrMessage *msg = GST_IP_RECVDSTADDR_MESSAGE (msgs[i]);
+
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
+#endif
+#ifdef UDP_GRO
+    if (GST_IS_UDP_GRO_MESSAGE (msgs[i])) {
+      GstUDPGROMessage *msg = GST_UDP_GRO_MESSAGE (msgs[i]);
+
+      if (segment_size && msg->segment_size > 0)
+        *segment_size = msg->segment_size;
+    }
+#endif
+#ifdef SO_TIMESTAMPNS
+    if (GST_IS_SOCKET_TIMESTAMP_MESSAGE (msgs[i])) {
+      GstSocketTimestampMessage *msg = GST_SOCKET_TIMESTAMP_MESSAGE (msgs[i]);
+      GstClock *clock;
+      GstClockTime socket_ts;
+
+      socket_ts = GST_TIMESPEC_TO_TIME (msg->socket_ts);
+      GST_TRACE_OBJECT (udpsrc,
+          "Got SCM_TIMESTAMPNS %" GST_TIME_FORMAT " in msg",
+          GST_TIME_ARGS (socket_ts));
+
+      clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
+      if (clock != NULL) {
+        gint64 adjust_dts, cur_sys_time, delta;
+        GstClockTime base_time, cur_gst_clk_time, running_time;
+
+        /*
+         * We use g_get_real_time as the time reference for SCM timestamps
+         * is always CLOCK_REALTIME.
+         */
+        cur_sys_time = g_get_real_time () * GST_USECOND;
+        cur_gst_clk_time = gst_clock_get_time (clock);
+
+        delta = (gint64) cur_sys_time - (gint64) socket_ts;
+        if (delta < 0) {
+          /*
+           * The current system time will always be greater than the SCM
+           * timestamp as the packet would have been timestamped at least
+           * some clock cycles before. If it is not, then the system time
+           * was adjusted. Since we cannot rely on the delta calculation in
+           * such a case, set the DTS to current pipeline clock when this
+           * happens.
+           */
+          GST_LOG_OBJECT (udpsrc,
+              "Current system time is behind SCM timestamp, setting DTS to pipeline clock");
+          *dts = cur_gst_clk_time;
+        } else {
+          base_time = gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
+          running_time = cur_gst_clk_time - base_time;
+          adjust_dts = (gint64) running_time - delta;
+          /*
+           * If the system time was adjusted much further ahead, we might
+           * end up with delta > cur_gst_clk_time. Set the DTS to current
+           * pipeline clock for this scenario as well.
+           */
+          if (adjust_dts < 0) {
+            GST_LOG_OBJECT (udpsrc,
+                "Current system time much ahead in time, setting DTS to pipeline clock");
+            *dts = cur_gst_clk_time;
+          } else {
+            *dts = adjust_dts;
+            GST_LOG_OBJECT (udpsrc, "Setting DTS to %" GST_TIME_FORMAT,
+                GST_TIME_ARGS (*dts));
+          }
+        }
+        g_object_unref (clock);
+      } else {
+        GST_ERROR_OBJECT (udpsrc,
+            "Failed to get element clock, not setting DTS");
+      }
+    }
+#endif
+  }
+
+  return skip_packet;
+}
+
+/* Waits until a packet can be read, posts a message when the configured
+ * timeout expires in the meantime */
+static gboolean
+gst_udpsrc_wait_readable (GstUDPSrc * udpsrc, GError ** err)
+{
+  gint64 timeout;
+
+  if (udpsrc->timeout)
+    timeout = udpsrc->timeout / 1000;
+  else
+    timeout = -1;
+
+  while (TRUE) {
+    GST_LOG_OBJECT (udpsrc, "doing select, timeout %" G_GINT64_FORMAT, timeout);
+
+    if (g_socket_condition_timed_wait (udpsrc->used_socket, G_IO_IN | G_IO_PRI,
+            timeout, udpsrc->cancellable, err))
+      return TRUE;
+
+    if (!g_error_matches (*err, G_IO_ERROR, G_IO_ERROR_TIMED_OUT))
+      return FALSE;
+
+    g_clear_error (err);
+    /* timeout, post element message */
+    gst_element_post_message (GST_ELEMENT_CAST (udpsrc),
+        gst_message_new_element (GST_OBJECT_CAST (udpsrc),
+            gst_structure_new ("GstUDPSrcTimeout",
+                "timeout", G_TYPE_UINT64, udpsrc->timeout, NULL)));
+  }
+}
+
+/* Makes sure the receive slab has room for @size more bytes. Buffers that
+ * were pushed keep their part of the previous slab alive. */
+static void
+gst_udpsrc_ensure_slab (GstUDPSrc * udpsrc, gsize size)
+{
+  if (udpsrc->slab != NULL
+      && g_atomic_rc_box_get_size (udpsrc->slab) - udpsrc->slab_offset >= size)
+    return;
+
+  if (udpsrc->slab != NULL)
+    g_atomic_rc_box_release (udpsrc->slab);
+
+  udpsrc->slab =
+      g_atomic_rc_box_alloc (MAX (size, MIN (size * UDP_SLAB_BATCHES,
+              UDP_MAX_SLAB_SIZE)));
+  udpsrc->slab_offset = 0;
+}
+
+static GstBuffer *
+gst_udpsrc_wrap_slab (GstUDPSrc * udpsrc, gsize offset, gsize size)
+{
+  GstBuffer *buf;
+
+  buf = gst_buffer_new ();
+  gst_buffer_append_memory (buf,
+      gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY, udpsrc->slab,
+          g_atomic_rc_box_get_size (udpsrc->slab), offset, size,
+          g_atomic_rc_box_acquire (udpsrc->slab),
+          (GDestroyNotify) g_atomic_rc_box_release));
+
+  return buf;
+}
+
+/* Receives up to max-batch-size packets with one call into the slab and
+ * submits them downstream as a buffer list. With GRO, every received
+ * message can contain multiple packets of the same size. */
+static GstFlowReturn
+gst_udpsrc_create_batch (GstUDPSrc * udpsrc)
+{
+  GInputMessage msgs[UDP_MAX_BATCH_SIZE];
+  GInputVector vecs[UDP_MAX_BATCH_SIZE];
+  GSocketAddress *saddrs[UDP_MAX_BATCH_SIZE];
+  GSocketControlMessage **cmsgs[UDP_MAX_BATCH_SIZE];
+  guint n_cmsgs[UDP_MAX_BATCH_SIZE];
+  GstBufferList *list = NULL;
+  GstClockTime now = GST_CLOCK_TIME_NONE;
+  gboolean need_msgs;
+  gsize slot_size, offset;
+  guint n_slots, skip;
+  GError *err = NULL;
+  gint res, i, j;
+
+  n_slots = udpsrc->max_batch_size;
+  slot_size = udpsrc->use_gro ? MAX_IPV4_UDP_PACKET_SIZE : udpsrc->mtu;
+  n_slots = CLAMP (UDP_MAX_SLAB_SIZE / slot_size, 1, n_slots);
+  need_msgs = udpsrc->use_gro || gst_udpsrc_need_control_messages (udpsrc);
+  skip = udpsrc->skip_first_bytes;
+
+  /* g_socket_receive_messages() only returns early with the packets that
+   * are available if the socket is non-blocking. We always wait for the
+   * socket to become readable before receiving. */
+  if (G_UNLIKELY (g_socket_get_blocking (udpsrc->used_socket)))
+    g_socket_set_blocking (udpsrc->used_socket, FALSE);
+
+retry:
+  gst_udpsrc_ensure_slab (udpsrc, n_slots * slot_size);
+
+  for (i = 0; i < n_slots; i++) {
+    vecs[i].buffer = udpsrc->slab + udpsrc->slab_offset + i * slot_size;
+    vecs[i].size = slot_size;
+    saddrs[i] = NULL;
+    cmsgs[i] = NULL;
+    n_cmsgs[i] = 0;
+
+    msgs[i].address = udpsrc->retrieve_sender_address ? &saddrs[i] : NULL;
+    msgs[i].vectors = &vecs[i];
+    msgs[i].num_vectors = 1;
+    msgs[i].bytes_received = 0;
+    msgs[i].flags = G_SOCKET_MSG_NONE;
+    msgs[i].control_messages = need_msgs ? &cmsgs[i] : NULL;
+    msgs[i].num_control_messages = need_msgs ? &n_cmsgs[i] : NULL;
+  }
+
+  if (!gst_udpsrc_wait_readable (udpsrc, &err)) {
+    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_BUSY)
+        || g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+      goto stopped;
+    goto select_error;
+  }
+
+  /* the socket is non-blocking in this mode, so we get whatever is queued
+   * right now */
+  res =
+      g_socket_receive_messages (udpsrc->used_socket, msgs, n_slots,
+      G_SOCKET_MSG_NONE, udpsrc->cancellable, &err);
+
+  if (G_UNLIKELY (res <= 0)) {
+    /* see gst_udpsrc_fill() for the unreachable errors */
+    if (res == 0 || g_error_matches (err, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK)
+        || g_error_matches (err, G_IO_ERROR, G_IO_ERROR_HOST_UNREACHABLE)
+        || g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CONNECTION_CLOSED)) {
+      g_clear_error (&err);
+      goto retry;
+    }
+    goto receive_error;
+  }
+
+  if (gst_base_src_get_do_timestamp (GST_BASE_SRC_CAST (udpsrc))) {
+    GstClock *clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
+
+    /* basesrc only timestamps the first buffer of a list */
+    if (clock != NULL) {
+      now = gst_clock_get_time (clock) -
+          gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
+      gst_object_unref (clock);
+    }
+  }
+
+  list = gst_buffer_list_new_sized (res);
+
+  for (i = 0; i < res; i++) {
+    GstClockTime dts = now;
+    guint segment_size = 0;
+    gboolean skip_packet = FALSE;
+    gsize size, pos;
+
+    offset = udpsrc->slab_offset + i * slot_size;
+    size = msgs[i].bytes_received;
+
+    if (need_msgs) {
+      skip_packet = gst_udpsrc_parse_control_messages (udpsrc, cmsgs[i],
+          n_cmsgs[i], &dts, &segment_size);
+
+      for (j = 0; j < n_cmsgs[i]; j++)
+        g_object_unref (cmsgs[i][j]);
+      g_free (cmsgs[i]);
+    }
+#ifdef MSG_TRUNC
+    if (msgs[i].flags & MSG_TRUNC) {
+      GST_WARNING_OBJECT (udpsrc, "Dropping packet bigger than the mtu of %u "
+          "bytes", udpsrc->mtu);
+      skip_packet = TRUE;
+    }
+#endif
+
+    if (skip_packet) {
+      GST_DEBUG_OBJECT (udpsrc, "Dropping packet");
+      g_clear_object (&saddrs[i]);
+      continue;
+    }
+
+    if (segment_size == 0 || segment_size > size)
+      segment_size = size;
+
+    pos = 0;
+    do {
+      gsize len = MIN (segment_size, size - pos);
+      GstBuffer *outbuf;
+
+      if (G_UNLIKELY (len < skip)) {
+        g_clear_object (&saddrs[i]);
+        goto skip_error;
+      }
+
+      outbuf = gst_udpsrc_wrap_slab (udpsrc, offset + pos + skip, len - skip);
+      GST_BUFFER_DTS (outbuf) = dts;
+      GST_BUFFER_PTS (outbuf) = dts;
+
+      /* use buffer metadata so receivers can also track the address */
+      if (saddrs[i])
+        gst_buffer_add_net_address_meta (outbuf, saddrs[i]);
+
+      gst_buffer_list_add (list, outbuf);
+      pos += len;
+    } while (pos < size);
+
+    g_clear_object (&saddrs[i]);
+  }
+
+  GST_LOG_OBJECT (udpsrc, "received %d messages, %u packets", res,
+      gst_buffer_list_length (list));
+
+  /* the next batch starts right after the last received packet */
+  udpsrc->slab_offset += (res - 1) * slot_size;
+  udpsrc->slab_offset += GST_ROUND_UP_8 (msgs[res - 1].bytes_received);
+
+  if (gst_buffer_list_length (list) == 0) {
+    gst_buffer_list_unref (list);
+    goto retry;
+  }
+
+  gst_base_src_submit_buffer_list (GST_BASE_SRC_CAST (udpsrc), list);
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+select_error:
+  {
+    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+        ("select error: %s", err->message));
+    g_clear_error (&err);
+    return GST_FLOW_ERROR;
+  }
+stopped:
+  {
+    GST_DEBUG ("stop called");
+    g_clear_error (&err);
+    return GST_FLOW_FLUSHING;
+  }
+receive_error:
+  {
+    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_BUSY) ||
+        g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+      g_clear_error (&err);
+      return GST_FLOW_FLUSHING;
+    } else {
+      GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+          ("receive error %d: %s", res, err->message));
+      g_clear_error (&err);
+      return GST_FLOW_ERROR;
+    }
+  }
+skip_error:
+  {
+    /* free the control messages and addresses we did not look at yet */
+    for (i++; i < res; i++) {
+      if (need_msgs) {
+        for (j = 0; j < n_cmsgs[i]; j++)
+          g_object_unref (cmsgs[i][j]);
+        g_free (cmsgs[i]);
+      }
+      g_clear_object (&saddrs[i]);
+    }
+    gst_buffer_list_unref (list);
+    GST_ELEMENT_ERROR (udpsrc, STREAM, DECODE, (NULL),
+        ("UDP buffer to small to skip header"));
+    return GST_FLOW_ERROR;
+  }
+}
+
+static GstFlowReturn
+gst_udpsrc_create (GstPushSrc * psrc, GstBuffer ** buf)
+{
+  GstUDPSrc *udpsrc = GST_UDPSRC_CAST (psrc);
+  GstBaseSrc *bsrc = GST_BASE_SRC_CAST (psrc);
+  GstBuffer *outbuf = NULL;
+  GstFlowReturn ret;
+
+  if (udpsrc->max_batch_size > 1 || udpsrc->use_gro) {
+    *buf = NULL;
+    return gst_udpsrc_create_batch (udpsrc);
+  }
+
+  /* what GstBaseSrc does by default when we only implement fill */
+  ret = GST_BASE_SRC_GET_CLASS (bsrc)->alloc (bsrc, -1,
+      gst_base_src_get_blocksize (bsrc), &outbuf);
+  if (G_UNLIKELY (ret != GST_FLOW_OK))
+    return ret;
+
+  ret = gst_udpsrc_fill (psrc, outbuf);
+  if (G_UNLIKELY (ret != GST_FLOW_OK)) {
+    gst_buffer_unref (outbuf);
+    return ret;
+  }
+
+  *buf = outbuf;
+
+  return GST_FLOW_OK;
+}
+
 static GstFlowReturn
 gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf)
 {
@@ -920,7 +1514,6 @@ gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf)
   GSocketAddress *saddr = NULL;
   GSocketAddress **p_saddr;
   gint flags = G_SOCKET_MSG_NONE;
-  gboolean try_again;
   GError *err = NULL;
   gssize res;
   gsize offset;
@@ -933,20 +1526,7 @@ gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf)
 
   udpsrc = GST_UDPSRC_CAST (psrc);
 
-  /* optimization: use messages only in multicast mode and
-   * if we can't let the kernel do the filtering for us */
-  p_msgs =
-      (g_inet_address_get_is_multicast (g_inet_socket_address_get_address
-          (udpsrc->addr))) ? &msgs : NULL;
-#ifdef IP_MULTICAST_ALL
-  if (g_inet_address_get_family (g_inet_socket_address_get_address
-          (udpsrc->addr)) == G_SOCKET_FAMILY_IPV4)
-    p_msgs = NULL;
-#endif
-#ifdef SO_TIMESTAMPNS
-  if (udpsrc->socket_timestamp_mode == GST_SOCKET_TIMESTAMP_MODE_REALTIME)
-    p_msgs = &msgs;
-#endif
+  p_msgs = gst_udpsrc_need_control_messages (udpsrc) ? &msgs : NULL;
 
   /* Retrieve sender address unless we've been configured not to do so */
   p_saddr = (udpsrc->retrieve_sender_address) ? &saddr : NULL;
@@ -989,37 +1569,12 @@ retry:
     saddr = NULL;
   }
 
-  do {
-    gint64 timeout;
-
-    try_again = FALSE;
-
-    if (udpsrc->timeout)
-      timeout = udpsrc->timeout / 1000;
-    else
-      timeout = -1;
-
-    GST_LOG_OBJECT (udpsrc, "doing select, timeout %" G_GINT64_FORMAT, timeout);
-
-    if (!g_socket_condition_timed_wait (udpsrc->used_socket, G_IO_IN | G_IO_PRI,
-            timeout, udpsrc->cancellable, &err)) {
-      if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_BUSY)
-          || g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
-        goto stopped;
-      } else if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_TIMED_OUT)) {
-        g_clear_error (&err);
-        /* timeout, post element message */
-        gst_element_post_message (GST_ELEMENT_CAST (udpsrc),
-            gst_message_new_element (GST_OBJECT_CAST (udpsrc),
-                gst_structure_new ("GstUDPSrcTimeout",
-                    "timeout", G_TYPE_UINT64, udpsrc->timeout, NULL)));
-      } else {
-        goto select_error;
-      }
-
-      try_again = TRUE;
-    }
-  } while (G_UNLIKELY (try_again));
+  if (!gst_udpsrc_wait_readable (udpsrc, &err)) {
+    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_BUSY)
+        || g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+      goto stopped;
+    goto select_error;
+  }
 
   res =
       g_socket_receive_message (udpsrc->used_socket, p_saddr, ivec, 2,
@@ -1041,102 +1596,11 @@ retry:
   /* Retry if multicast and the destination address is not ours. We don't want
    * to receive arbitrary packets */
   if (p_msgs) {
-    GInetAddress *iaddr = g_inet_socket_address_get_address (udpsrc->addr);
-    gboolean skip_packet = FALSE;
-    gsize iaddr_size = g_inet_address_get_native_size (iaddr);
-    const guint8 *iaddr_bytes = g_inet_address_to_bytes (iaddr);
-
-    for (i = 0; i < n_msgs && !skip_packet; i++) {
-#ifdef IP_PKTINFO
-      if (GST_IS_IP_PKTINFO_MESSAGE (msgs[i])) {
-        GstIPPktinfoMessage *msg = GST_IP_PKTINFO_MESSAGE (msgs[i]);
-
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
-#endif
-#ifdef IPV6_PKTINFO
-      if (GST_IS_IPV6_PKTINFO_MESSAGE (msgs[i])) {
-        GstIPV6PktinfoMessage *msg = GST_IPV6_PKTINFO_MESSAGE (msgs[i]);
-
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
-#endif
-#ifdef IP_RECVDSTADDR
-      if (GST_IS_IP_RECVDSTADDR_MESSAGE (msgs[i])) {
-        GstIPRecvdstaddrMessage *msg = GST_IP_RECVDSTADDR_MESSAGE (msgs[i]);
-
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
-#endif
-#ifdef SO_TIMESTAMPNS
-      if (GST_IS_SOCKET_TIMESTAMP_MESSAGE (msgs[i])) {
-        GstSocketTimestampMessage *msg = GST_SOCKET_TIMESTAMP_MESSAGE (msgs[i]);
-        GstClock *clock;
-        GstClockTime socket_ts;
-
-        socket_ts = GST_TIMESPEC_TO_TIME (msg->socket_ts);
-        GST_TRACE_OBJECT (udpsrc,
-            "Got SCM_TIMESTAMPNS %" GST_TIME_FORMAT " in msg",
-            GST_TIME_ARGS (socket_ts));
-
-        clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
-        if (clock != NULL) {
-          gint64 adjust_dts, cur_sys_time, delta;
-          GstClockTime base_time, cur_gst_clk_time, running_time;
+    GstClockTime dts = GST_CLOCK_TIME_NONE;
+    gboolean skip_packet;
 
-          /*
-           * We use g_get_real_time as the time reference for SCM timestamps
-           * is always CLOCK_REALTIME.
-           */
-          cur_sys_time = g_get_real_time () * GST_USECOND;
-          cur_gst_clk_time = gst_clock_get_time (clock);
-
-          delta = (gint64) cur_sys_time - (gint64) socket_ts;
-          if (delta < 0) {
-            /*
-             * The current system time will always be greater than the SCM
-             * timestamp as the packet would have been timestamped at least
-             * some clock cycles before. If it is not, then the system time
-             * was adjusted. Since we cannot rely on the delta calculation in
-             * such a case, set the DTS to current pipeline clock when this
-             * happens.
-             */
-            GST_LOG_OBJECT (udpsrc,
-                "Current system time is behind SCM timestamp, setting DTS to pipeline clock");
-            GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
-          } else {
-            base_time = gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
-            running_time = cur_gst_clk_time - base_time;
-            adjust_dts = (gint64) running_time - delta;
-            /*
-             * If the system time was adjusted much further ahead, we might
-             * end up with delta > cur_gst_clk_time. Set the DTS to current
-             * pipeline clock for this scenario as well.
-             */
-            if (adjust_dts < 0) {
-              GST_LOG_OBJECT (udpsrc,
-                  "Current system time much ahead in time, setting DTS to pipeline clock");
-              GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
-            } else {
-              GST_BUFFER_DTS (outbuf) = adjust_dts;
-              GST_LOG_OBJECT (udpsrc, "Setting DTS to %" GST_TIME_FORMAT,
-                  GST_TIME_ARGS (GST_BUFFER_DTS (outbuf)));
-            }
-          }
-          g_object_unref (clock);
-        } else {
-          GST_ERROR_OBJECT (udpsrc,
-              "Failed to get element clock, not setting DTS");
-        }
-      }
-#endif
-    }
+    skip_packet =
+        gst_udpsrc_parse_control_messages (udpsrc, msgs, n_msgs, &dts, NULL);
 
     for (i = 0; i < n_msgs; i++) {
       g_object_unref (msgs[i]);
@@ -1148,6 +1612,9 @@ retry:
           "Dropping packet for a different multicast address");
       goto retry;
     }
+
+    if (GST_CLOCK_TIME_IS_VALID (dts))
+      GST_BUFFER_DTS (outbuf) = dts;
   }
 
   gst_buffer_unmap (outbuf, &info);
@@ -1375,6 +1842,12 @@ gst_udpsrc_set_property (GObject * object, guint prop_id, const GValue * value,
     case PROP_SOCKET_TIMESTAMP:
       udpsrc->socket_timestamp_mode = g_value_get_enum (value);
       break;
+    case PROP_MAX_BATCH_SIZE:
+      udpsrc->max_batch_size = g_value_get_uint (value);
+      break;
+    case PROP_GRO:
+      udpsrc->gro = g_value_get_boolean (value);
+      break;
     default:
       break;
   }
@@ -1441,6 +1914,12 @@ gst_udpsrc_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_SOCKET_TIMESTAMP:
       g_value_set_enum (value, udpsrc->socket_timestamp_mode);
       break;
+    case PROP_MAX_BATCH_SIZE:
+      g_value_set_uint (value, udpsrc->max_batch_size);
+      break;
+    case PROP_GRO:
+      g_value_set_boolean (value, udpsrc->gro);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1754,6 +2233,22 @@ gst_udpsrc_open (GstUDPSrc * src)
   }
 #endif
 
+  src->use_gro = FALSE;
+  if (src->gro) {
+#ifdef UDP_GRO
+    if (!g_socket_set_option (src->used_socket, IPPROTO_UDP, UDP_GRO, TRUE,
+            &err)) {
+      GST_WARNING_OBJECT (src, "Failed to enable UDP_GRO: %s", err->message);
+      g_clear_error (&err);
+    } else {
+      GST_LOG_OBJECT (src, "UDP GRO enabled");
+      src->use_gro = TRUE;
+    }
+#else
+    GST_WARNING_OBJECT (src, "gro was requested but UDP_GRO is not defined");
+#endif
+  }
+
   /* NOTE: sockaddr_in.sin_port works for ipv4 and ipv6 because sin_port
    * follows ss_family on both */
   {
@@ -1894,6 +2389,9 @@ gst_udpsrc_close (GstUDPSrc * src)
         GST_ERROR_OBJECT (src, "Failed to close socket: %s", err->message);
         g_clear_error (&err);
       }
+    } else if (src->max_batch_size > 1 || src->use_gro) {
+      /* give back the external socket like we got it */
+      g_socket_set_blocking (src->used_socket, TRUE);
     }
 
     g_object_unref (src->used_socket);
@@ -1902,6 +2400,12 @@ gst_udpsrc_close (GstUDPSrc * src)
     src->addr = NULL;
   }
 
+  if (src->slab) {
+    g_atomic_rc_box_release (src->slab);
+    src->slab = NULL;
+    src->slab_offset = 0;
+  }
+
   gst_udpsrc_free_cancellable (src);
 
   return TRUE;
@@ -96,6 +96,13 @@ struct _GstUDPSrc {
   /* Extra memory for buffers with a size superior to max_packet_size */
   GstMemory *extra_mem;
 
+  /* batched receive */
+  guint      max_batch_size;
+  gboolean   gro;
+  gboolean   use_gro;	/* gro is enabled on the socket */
+  guint8    *slab;	/* GAtomicRcBox shared with the pushed buffers */
+  gsize      slab_offset;
+
   gchar     *uri;
 };
 
@@ -2423,13 +2423,16 @@ static GstCaps *gst_video_box_transform_caps (GstBaseTransform * trans,
     GstPadDirection direction, GstCaps * from, GstCaps * filter);
 static void gst_video_box_before_transform (GstBaseTransform * trans,
     GstBuffer * in);
+static GstFlowReturn gst_video_box_transform (GstBaseTransform * trans,
+    GstBuffer * in, GstBuffer * out);
 static gboolean gst_video_box_src_event (GstBaseTransform * trans,
     GstEvent * event);
 
 static gboolean gst_video_box_set_info (GstVideoFilter * vfilter, GstCaps * in,
     GstVideoInfo * in_info, GstCaps * out, GstVideoInfo * out_info);
-static GstFlowReturn gst_video_box_transform_frame (GstVideoFilter * vfilter,
-    GstVideoFrame * in_frame, GstVideoFrame * out_frame);
+static GstFlowReturn gst_video_box_transform_frame_lines (GstVideoFilter *
+    vfilter, GstVideoFrame * in_frame, GstVideoFrame * out_frame, guint y,
+    guint height);
 
 #define GST_TYPE_VIDEO_BOX_FILL (gst_video_box_fill_get_type())
 static GType
@@ -2458,7 +2461,7 @@ gst_video_box_finalize (GObject * object)
 {
   GstVideoBox *video_box = GST_VIDEO_BOX (object);
 
-  g_mutex_clear (&video_box->mutex);
+  g_rw_lock_clear (&video_box->lock);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -2519,13 +2522,14 @@ gst_video_box_class_init (GstVideoBoxClass * klass)
 
   trans_class->before_transform =
       GST_DEBUG_FUNCPTR (gst_video_box_before_transform);
+  trans_class->transform = GST_DEBUG_FUNCPTR (gst_video_box_transform);
   trans_class->transform_caps =
       GST_DEBUG_FUNCPTR (gst_video_box_transform_caps);
   trans_class->src_event = GST_DEBUG_FUNCPTR (gst_video_box_src_event);
 
   vfilter_class->set_info = GST_DEBUG_FUNCPTR (gst_video_box_set_info);
-  vfilter_class->transform_frame =
-      GST_DEBUG_FUNCPTR (gst_video_box_transform_frame);
+  vfilter_class->transform_frame_lines =
+      GST_DEBUG_FUNCPTR (gst_video_box_transform_frame_lines);
 
   gst_element_class_set_static_metadata (element_class, "Video box filter",
       "Filter/Effect/Video",
@@ -2556,7 +2560,7 @@ gst_video_box_init (GstVideoBox * video_box)
   video_box->border_alpha = DEFAULT_BORDER_ALPHA;
   video_box->autocrop = FALSE;
 
-  g_mutex_init (&video_box->mutex);
+  g_rw_lock_init (&video_box->lock);
 }
 
 static void
@@ -2565,7 +2569,7 @@ gst_video_box_set_property (GObject * object, guint prop_id,
 {
   GstVideoBox *video_box = GST_VIDEO_BOX (object);
 
-  g_mutex_lock (&video_box->mutex);
+  g_rw_lock_writer_lock (&video_box->lock);
   switch (prop_id) {
     case PROP_LEFT:
       video_box->box_left = g_value_get_int (value);
@@ -2628,7 +2632,7 @@ gst_video_box_set_property (GObject * object, guint prop_id,
   GST_DEBUG_OBJECT (video_box, "Calling reconfigure");
   gst_base_transform_reconfigure_src (GST_BASE_TRANSFORM_CAST (video_box));
 
-  g_mutex_unlock (&video_box->mutex);
+  g_rw_lock_writer_unlock (&video_box->lock);
 }
 
 static void
@@ -3152,7 +3156,7 @@ gst_video_box_set_info (GstVideoFilter * vfilter, GstCaps * in,
   GstVideoBox *video_box = GST_VIDEO_BOX (vfilter);
   gboolean ret;
 
-  g_mutex_lock (&video_box->mutex);
+  g_rw_lock_writer_lock (&video_box->lock);
 
   video_box->in_format = GST_VIDEO_INFO_FORMAT (in_info);
   video_box->in_width = GST_VIDEO_INFO_WIDTH (in_info);
@@ -3180,7 +3184,7 @@ gst_video_box_set_info (GstVideoFilter * vfilter, GstCaps * in,
 
   if (ret)
     ret = gst_video_box_select_processing_functions (video_box);
-  g_mutex_unlock (&video_box->mutex);
+  g_rw_lock_writer_unlock (&video_box->lock);
 
   return ret;
 }
@@ -3214,10 +3218,33 @@ gst_video_box_src_event (GstBaseTransform * trans, GstEvent * event)
   return GST_BASE_TRANSFORM_CLASS (parent_class)->src_event (trans, event);
 }
 
+/* Make @lines a view of @height lines of @frame starting at line @y */
+static void
+gst_video_box_frame_lines (const GstVideoFrame * frame, GstVideoFrame * lines,
+    guint y, guint height)
+{
+  const GstVideoFormatInfo *finfo = frame->info.finfo;
+  guint i;
+
+  *lines = *frame;
+  lines->info.height = height;
+
+  for (i = 0; i < GST_VIDEO_FRAME_N_PLANES (frame); i++) {
+    gint comp[GST_VIDEO_MAX_COMPONENTS];
+
+    gst_video_format_info_component (finfo, i, comp);
+    lines->data[i] = (guint8 *) frame->data[i] +
+        GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT (finfo, comp[0], y) *
+        GST_VIDEO_FRAME_PLANE_STRIDE (frame, i);
+  }
+}
+
+/* Creates the output lines @y to @y + @height of @out */
 static void
 gst_video_box_process (GstVideoBox * video_box, GstVideoFrame * in,
-    GstVideoFrame * out)
+    GstVideoFrame * out, guint y, guint height)
 {
+  GstVideoFrame lines;
   guint b_alpha = CLAMP (video_box->border_alpha * 256, 0, 255);
   guint i_alpha = CLAMP (video_box->alpha * 256, 0, 255);
   GstVideoBoxFill fill_type = video_box->fill_type;
@@ -3256,18 +3283,18 @@ gst_video_box_process (GstVideoBox * video_box, GstVideoFrame * in,
   GST_DEBUG_OBJECT (video_box, "Alpha value is: %u (frame) %u (border)",
       i_alpha, b_alpha);
 
+  gst_video_box_frame_lines (out, &lines, y, height);
+
   if (crop_h < 0 || crop_w < 0) {
-    video_box->fill (fill_type, b_alpha, out, video_box->out_sdtv);
-  } else if (bb == 0 && bt == 0 && br == 0 && bl == 0) {
-    video_box->copy (i_alpha, out, video_box->out_sdtv, 0, 0, in,
-        video_box->in_sdtv, 0, 0, crop_w, crop_h);
+    video_box->fill (fill_type, b_alpha, &lines, video_box->out_sdtv);
   } else {
     gint src_x = 0, src_y = 0;
     gint dest_x = 0, dest_y = 0;
+    gint first, last;
 
     /* Fill everything if a border should be added somewhere */
     if (bt < 0 || bb < 0 || br < 0 || bl < 0)
-      video_box->fill (fill_type, b_alpha, out, video_box->out_sdtv);
+      video_box->fill (fill_type, b_alpha, &lines, video_box->out_sdtv);
 
     /* Top border */
     if (bt < 0) {
@@ -3283,9 +3310,13 @@ gst_video_box_process (GstVideoBox * video_box, GstVideoFrame * in,
       src_x += bl;
     }
 
-    /* Frame */
-    video_box->copy (i_alpha, out, video_box->out_sdtv, dest_x, dest_y,
-        in, video_box->in_sdtv, src_x, src_y, crop_w, crop_h);
+    /* Frame, limited to the lines we are creating */
+    first = MAX (dest_y, (gint) y);
+    last = MIN (dest_y + crop_h, (gint) (y + height));
+    if (last > first)
+      video_box->copy (i_alpha, &lines, video_box->out_sdtv, dest_x,
+          first - y, in, video_box->in_sdtv, src_x, src_y + first - dest_y,
+          crop_w, last - first);
   }
 
   GST_LOG_OBJECT (video_box, "image created");
@@ -3309,14 +3340,28 @@ gst_video_box_before_transform (GstBaseTransform * trans, GstBuffer * in)
 }
 
 static GstFlowReturn
-gst_video_box_transform_frame (GstVideoFilter * vfilter,
-    GstVideoFrame * in_frame, GstVideoFrame * out_frame)
+gst_video_box_transform (GstBaseTransform * trans, GstBuffer * in,
+    GstBuffer * out)
+{
+  GstVideoBox *video_box = GST_VIDEO_BOX (trans);
+  GstFlowReturn ret;
+
+  /* all bands of lines of the frame are created with the same settings */
+  g_rw_lock_reader_lock (&video_box->lock);
+  ret = GST_BASE_TRANSFORM_CLASS (parent_class)->transform (trans, in, out);
+  g_rw_lock_reader_unlock (&video_box->lock);
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_video_box_transform_frame_lines (GstVideoFilter * vfilter,
+    GstVideoFrame * in_frame, GstVideoFrame * out_frame, guint y, guint height)
 {
   GstVideoBox *video_box = GST_VIDEO_BOX (vfilter);
 
-  g_mutex_lock (&video_box->mutex);
-  gst_video_box_process (video_box, in_frame, out_frame);
-  g_mutex_unlock (&video_box->mutex);
+  /* read-locked by gst_video_box_transform() */
+  gst_video_box_process (video_box, in_frame, out_frame, y, height);
   return GST_FLOW_OK;
 }
 
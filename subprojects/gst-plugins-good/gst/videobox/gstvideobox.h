@@ -56,8 +56,8 @@ struct _GstVideoBox
 
   /* <private> */
 
-  /* Guarding everything below */
-  GMutex mutex;
+  /* Guarding everything below, read-locked while processing a frame */
+  GRWLock lock;
   /* caps */
   GstVideoFormat in_format;
   gint in_width, in_height;
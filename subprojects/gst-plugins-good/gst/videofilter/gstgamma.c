@@ -94,8 +94,8 @@ static void gst_gamma_get_property (GObject * object, guint prop_id,
 
 static gboolean gst_gamma_set_info (GstVideoFilter * vfilter, GstCaps * incaps,
     GstVideoInfo * in_info, GstCaps * outcaps, GstVideoInfo * out_info);
-static GstFlowReturn gst_gamma_transform_frame_ip (GstVideoFilter * vfilter,
-    GstVideoFrame * frame);
+static GstFlowReturn gst_gamma_transform_frame_ip_lines (GstVideoFilter *
+    vfilter, GstVideoFrame * frame, guint y, guint height);
 static void gst_gamma_before_transform (GstBaseTransform * transform,
     GstBuffer * buf);
 
@@ -136,8 +136,8 @@ gst_gamma_class_init (GstGammaClass * g_class)
   trans_class->transform_ip_on_passthrough = FALSE;
 
   vfilter_class->set_info = GST_DEBUG_FUNCPTR (gst_gamma_set_info);
-  vfilter_class->transform_frame_ip =
-      GST_DEBUG_FUNCPTR (gst_gamma_transform_frame_ip);
+  vfilter_class->transform_frame_ip_lines =
+      GST_DEBUG_FUNCPTR (gst_gamma_transform_frame_ip_lines);
 }
 
 static void
@@ -194,40 +194,40 @@ gst_gamma_calculate_tables (GstGamma * gamma)
   gint n;
   gdouble val;
   gdouble exp;
-  gboolean passthrough = FALSE;
+  gboolean passthrough;
 
   GST_OBJECT_LOCK (gamma);
-  if (gamma->gamma == 1.0) {
-    passthrough = TRUE;
-  } else {
-    exp = 1.0 / gamma->gamma;
-    for (n = 0; n < 256; n++) {
-      val = n / 255.0;
-      val = pow (val, exp);
-      val = 255.0 * val;
-      gamma->gamma_table[n] = (guint8) floor (val + 0.5);
-    }
+  /* also in passthrough, for a frame started before it was turned off */
+  passthrough = gamma->gamma == 1.0;
+  exp = 1.0 / gamma->gamma;
+  for (n = 0; n < 256; n++) {
+    val = n / 255.0;
+    val = pow (val, exp);
+    val = 255.0 * val;
+    gamma->gamma_table[n] = (guint8) floor (val + 0.5);
   }
   GST_OBJECT_UNLOCK (gamma);
 
   gst_base_transform_set_passthrough (GST_BASE_TRANSFORM (gamma), passthrough);
 }
 
+/* The process functions handle the frame lines from first_line up to but not
+ * including last_line */
 static void
-gst_gamma_planar_yuv_ip (GstGamma * gamma, GstVideoFrame * frame)
+gst_gamma_planar_yuv_ip (GstGamma * gamma, GstVideoFrame * frame,
+    gint first_line, gint last_line)
 {
-  gint i, j, height;
+  gint i, j;
   gint width, stride, row_wrap;
-  const guint8 *table = gamma->gamma_table;
+  const guint8 *table = gamma->frame_table;
   guint8 *data;
 
-  data = GST_VIDEO_FRAME_COMP_DATA (frame, 0);
   stride = GST_VIDEO_FRAME_COMP_STRIDE (frame, 0);
+  data = (guint8 *) GST_VIDEO_FRAME_COMP_DATA (frame, 0) + first_line * stride;
   width = GST_VIDEO_FRAME_COMP_WIDTH (frame, 0);
-  height = GST_VIDEO_FRAME_COMP_HEIGHT (frame, 0);
   row_wrap = stride - width;
 
-  for (i = 0; i < height; i++) {
+  for (i = first_line; i < last_line; i++) {
     for (j = 0; j < width; j++) {
       *data = table[*data];
       data++;
@@ -237,22 +237,22 @@ gst_gamma_planar_yuv_ip (GstGamma * gamma, GstVideoFrame * frame)
 }
 
 static void
-gst_gamma_packed_yuv_ip (GstGamma * gamma, GstVideoFrame * frame)
+gst_gamma_packed_yuv_ip (GstGamma * gamma, GstVideoFrame * frame,
+    gint first_line, gint last_line)
 {
-  gint i, j, height;
+  gint i, j;
   gint width, stride, row_wrap;
   gint pixel_stride;
-  const guint8 *table = gamma->gamma_table;
+  const guint8 *table = gamma->frame_table;
   guint8 *data;
 
-  data = GST_VIDEO_FRAME_COMP_DATA (frame, 0);
   stride = GST_VIDEO_FRAME_COMP_STRIDE (frame, 0);
+  data = (guint8 *) GST_VIDEO_FRAME_COMP_DATA (frame, 0) + first_line * stride;
   width = GST_VIDEO_FRAME_COMP_WIDTH (frame, 0);
-  height = GST_VIDEO_FRAME_COMP_HEIGHT (frame, 0);
   pixel_stride = GST_VIDEO_FRAME_COMP_PSTRIDE (frame, 0);
   row_wrap = stride - pixel_stride * width;
 
-  for (i = 0; i < height; i++) {
+  for (i = first_line; i < last_line; i++) {
     for (j = 0; j < width; j++) {
       *data = table[*data];
       data += pixel_stride;
@@ -276,21 +276,21 @@ static const gint cog_rgb_to_ycbcr_matrix_8bit_sdtv[] = {
 #define APPLY_MATRIX(m,o,v1,v2,v3) ((m[o*4] * v1 + m[o*4+1] * v2 + m[o*4+2] * v3 + m[o*4+3]) >> 8)
 
 static void
-gst_gamma_packed_rgb_ip (GstGamma * gamma, GstVideoFrame * frame)
+gst_gamma_packed_rgb_ip (GstGamma * gamma, GstVideoFrame * frame,
+    gint first_line, gint last_line)
 {
-  gint i, j, height;
+  gint i, j;
   gint width, stride, row_wrap;
   gint pixel_stride;
-  const guint8 *table = gamma->gamma_table;
+  const guint8 *table = gamma->frame_table;
   gint offsets[3];
   gint r, g, b;
   gint y, u, v;
   guint8 *data;
 
-  data = GST_VIDEO_FRAME_PLANE_DATA (frame, 0);
   stride = GST_VIDEO_FRAME_PLANE_STRIDE (frame, 0);
+  data = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (frame, 0) + first_line * stride;
   width = GST_VIDEO_FRAME_COMP_WIDTH (frame, 0);
-  height = GST_VIDEO_FRAME_COMP_HEIGHT (frame, 0);
 
   offsets[0] = GST_VIDEO_FRAME_COMP_OFFSET (frame, 0);
   offsets[1] = GST_VIDEO_FRAME_COMP_OFFSET (frame, 1);
@@ -299,7 +299,7 @@ gst_gamma_packed_rgb_ip (GstGamma * gamma, GstVideoFrame * frame)
   pixel_stride = GST_VIDEO_FRAME_COMP_PSTRIDE (frame, 0);
   row_wrap = stride - pixel_stride * width;
 
-  for (i = 0; i < height; i++) {
+  for (i = first_line; i < last_line; i++) {
     for (j = 0; j < width; j++) {
       r = data[offsets[0]];
       g = data[offsets[1]];
@@ -390,19 +390,22 @@ gst_gamma_before_transform (GstBaseTransform * base, GstBuffer * outbuf)
 
   if (GST_CLOCK_TIME_IS_VALID (stream_time))
     gst_object_sync_values (GST_OBJECT (gamma), stream_time);
+
+  GST_OBJECT_LOCK (gamma);
+  memcpy (gamma->frame_table, gamma->gamma_table, sizeof (gamma->frame_table));
+  GST_OBJECT_UNLOCK (gamma);
 }
 
 static GstFlowReturn
-gst_gamma_transform_frame_ip (GstVideoFilter * vfilter, GstVideoFrame * frame)
+gst_gamma_transform_frame_ip_lines (GstVideoFilter * vfilter,
+    GstVideoFrame * frame, guint y, guint height)
 {
   GstGamma *gamma = GST_GAMMA (vfilter);
 
   if (!gamma->process)
     goto not_negotiated;
 
-  GST_OBJECT_LOCK (gamma);
-  gamma->process (gamma, frame);
-  GST_OBJECT_UNLOCK (gamma);
+  gamma->process (gamma, frame, y, y + height);
 
   return GST_FLOW_OK;
 
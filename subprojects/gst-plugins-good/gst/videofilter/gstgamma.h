@@ -57,10 +57,14 @@ struct _GstGamma
   /* properties */
   gdouble gamma;
 
-  /* tables */
+  /* tables, protected by the object lock */
   guint8 gamma_table[256];
+  /* copy of gamma_table taken in before_transform, so that all lines of a
+   * frame are processed with the same one */
+  guint8 frame_table[256];
 
-  void (*process) (GstGamma *gamma, GstVideoFrame *frame);
+  void (*process) (GstGamma *gamma, GstVideoFrame *frame, gint first_line,
+      gint last_line);
 };
 
 struct _GstGammaClass
@@ -108,7 +108,8 @@ GST_ELEMENT_REGISTER_DEFINE (videobalance, "videobalance",
  * look-up tables (LUT).
  */
 static void
-gst_video_balance_update_tables (GstVideoBalance * vb)
+gst_video_balance_update_tables (GstVideoBalance * vb,
+    GstVideoBalanceTables * tables)
 {
   gint i, j;
   gdouble y, u, v, hue_cos, hue_sin;
@@ -120,7 +121,7 @@ gst_video_balance_update_tables (GstVideoBalance * vb)
       y = 0;
     else if (y > 255)
       y = 255;
-    vb->tabley[i] = rint (y);
+    tables->y[i] = rint (y);
   }
 
   hue_cos = cos (G_PI * vb->hue);
@@ -140,8 +141,8 @@ gst_video_balance_update_tables (GstVideoBalance * vb)
         v = 0;
       else if (v > 255)
         v = 255;
-      vb->tableu[i + 128][j + 128] = rint (u);
-      vb->tablev[i + 128][j + 128] = rint (v);
+      tables->u[i + 128][j + 128] = rint (u);
+      tables->v[i + 128][j + 128] = rint (v);
     }
   }
 }
@@ -159,37 +160,53 @@ gst_video_balance_update_properties (GstVideoBalance * videobalance)
 {
   gboolean passthrough;
   GstBaseTransform *base = GST_BASE_TRANSFORM (videobalance);
+  GstVideoBalanceTables *old_tables = NULL;
 
   GST_OBJECT_LOCK (videobalance);
   passthrough = gst_video_balance_is_passthrough (videobalance);
-  if (!passthrough)
-    gst_video_balance_update_tables (videobalance);
+  if (!passthrough) {
+    GstVideoBalanceTables *tables;
+
+    /* frames being processed keep using the old tables */
+    tables = g_atomic_rc_box_new (GstVideoBalanceTables);
+    gst_video_balance_update_tables (videobalance, tables);
+    old_tables = videobalance->tables;
+    videobalance->tables = tables;
+  }
   GST_OBJECT_UNLOCK (videobalance);
 
+  if (old_tables)
+    g_atomic_rc_box_release (old_tables);
+
   gst_base_transform_set_passthrough (base, passthrough);
 }
 
+/* The process functions handle the frame lines from first_line up to but not
+ * including last_line, and the chroma lines covered by them */
+#define CHROMA_LINE(frame,line) \
+  GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT ((frame)->info.finfo, 1, line)
+
 static void
 gst_video_balance_planar_yuv (GstVideoBalance * videobalance,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, gint first_line, gint last_line)
 {
   gint x, y;
   guint8 *ydata;
   guint8 *udata, *vdata;
   gint ystride, ustride, vstride;
-  gint width, height;
-  gint width2, height2;
-  guint8 *tabley = videobalance->tabley;
-  guint8 **tableu = videobalance->tableu;
-  guint8 **tablev = videobalance->tablev;
+  gint width;
+  gint width2;
+  GstVideoBalanceTables *tables = videobalance->frame_tables;
+  guint8 *tabley = tables->y;
+  guint8 (*tableu)[256] = tables->u;
+  guint8 (*tablev)[256] = tables->v;
 
   width = GST_VIDEO_FRAME_WIDTH (frame);
-  height = GST_VIDEO_FRAME_HEIGHT (frame);
 
   ydata = GST_VIDEO_FRAME_PLANE_DATA (frame, 0);
   ystride = GST_VIDEO_FRAME_PLANE_STRIDE (frame, 0);
 
-  for (y = 0; y < height; y++) {
+  for (y = first_line; y < last_line; y++) {
     guint8 *yptr;
 
     yptr = ydata + y * ystride;
@@ -200,14 +217,14 @@ gst_video_balance_planar_yuv (GstVideoBalance * videobalance,
   }
 
   width2 = GST_VIDEO_FRAME_COMP_WIDTH (frame, 1);
-  height2 = GST_VIDEO_FRAME_COMP_HEIGHT (frame, 1);
 
   udata = GST_VIDEO_FRAME_PLANE_DATA (frame, 1);
   vdata = GST_VIDEO_FRAME_PLANE_DATA (frame, 2);
   ustride = GST_VIDEO_FRAME_PLANE_STRIDE (frame, 1);
   vstride = GST_VIDEO_FRAME_PLANE_STRIDE (frame, 2);
 
-  for (y = 0; y < height2; y++) {
+  for (y = CHROMA_LINE (frame, first_line);
+      y < CHROMA_LINE (frame, last_line); y++) {
     guint8 *uptr, *vptr;
     guint8 u1, v1;
 
@@ -226,26 +243,26 @@ gst_video_balance_planar_yuv (GstVideoBalance * videobalance,
 
 static void
 gst_video_balance_semiplanar_yuv (GstVideoBalance * videobalance,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, gint first_line, gint last_line)
 {
   gint x, y;
   guint8 *ydata;
   guint8 *uvdata;
   gint ystride, uvstride;
-  gint width, height;
-  gint width2, height2;
-  guint8 *tabley = videobalance->tabley;
-  guint8 **tableu = videobalance->tableu;
-  guint8 **tablev = videobalance->tablev;
+  gint width;
+  gint width2;
+  GstVideoBalanceTables *tables = videobalance->frame_tables;
+  guint8 *tabley = tables->y;
+  guint8 (*tableu)[256] = tables->u;
+  guint8 (*tablev)[256] = tables->v;
   gint upos, vpos;
 
   width = GST_VIDEO_FRAME_WIDTH (frame);
-  height = GST_VIDEO_FRAME_HEIGHT (frame);
 
   ydata = GST_VIDEO_FRAME_PLANE_DATA (frame, 0);
   ystride = GST_VIDEO_FRAME_PLANE_STRIDE (frame, 0);
 
-  for (y = 0; y < height; y++) {
+  for (y = first_line; y < last_line; y++) {
     guint8 *yptr;
 
     yptr = ydata + y * ystride;
@@ -256,7 +273,6 @@ gst_video_balance_semiplanar_yuv (GstVideoBalance * videobalance,
   }
 
   width2 = GST_VIDEO_FRAME_COMP_WIDTH (frame, 1);
-  height2 = GST_VIDEO_FRAME_COMP_HEIGHT (frame, 1);
 
   uvdata = GST_VIDEO_FRAME_PLANE_DATA (frame, 1);
   uvstride = GST_VIDEO_FRAME_PLANE_STRIDE (frame, 1);
@@ -264,7 +280,8 @@ gst_video_balance_semiplanar_yuv (GstVideoBalance * videobalance,
   upos = GST_VIDEO_INFO_FORMAT (&frame->info) == GST_VIDEO_FORMAT_NV12 ? 0 : 1;
   vpos = GST_VIDEO_INFO_FORMAT (&frame->info) == GST_VIDEO_FORMAT_NV12 ? 1 : 0;
 
-  for (y = 0; y < height2; y++) {
+  for (y = CHROMA_LINE (frame, first_line);
+      y < CHROMA_LINE (frame, last_line); y++) {
     guint8 *uvptr;
     guint8 u1, v1;
 
@@ -283,25 +300,25 @@ gst_video_balance_semiplanar_yuv (GstVideoBalance * videobalance,
 
 static void
 gst_video_balance_packed_yuv (GstVideoBalance * videobalance,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, gint first_line, gint last_line)
 {
   gint x, y, stride;
   guint8 *ydata, *udata, *vdata;
   gint yoff, uoff, voff;
-  gint width, height;
-  gint width2, height2;
-  guint8 *tabley = videobalance->tabley;
-  guint8 **tableu = videobalance->tableu;
-  guint8 **tablev = videobalance->tablev;
+  gint width;
+  gint width2;
+  GstVideoBalanceTables *tables = videobalance->frame_tables;
+  guint8 *tabley = tables->y;
+  guint8 (*tableu)[256] = tables->u;
+  guint8 (*tablev)[256] = tables->v;
 
   width = GST_VIDEO_FRAME_WIDTH (frame);
-  height = GST_VIDEO_FRAME_HEIGHT (frame);
 
   stride = GST_VIDEO_FRAME_PLANE_STRIDE (frame, 0);
   ydata = GST_VIDEO_FRAME_COMP_DATA (frame, 0);
   yoff = GST_VIDEO_FRAME_COMP_PSTRIDE (frame, 0);
 
-  for (y = 0; y < height; y++) {
+  for (y = first_line; y < last_line; y++) {
     guint8 *yptr;
 
     yptr = ydata + y * stride;
@@ -312,14 +329,14 @@ gst_video_balance_packed_yuv (GstVideoBalance * videobalance,
   }
 
   width2 = GST_VIDEO_FRAME_COMP_WIDTH (frame, 1);
-  height2 = GST_VIDEO_FRAME_COMP_HEIGHT (frame, 1);
 
   udata = GST_VIDEO_FRAME_COMP_DATA (frame, 1);
   vdata = GST_VIDEO_FRAME_COMP_DATA (frame, 2);
   uoff = GST_VIDEO_FRAME_COMP_PSTRIDE (frame, 1);
   voff = GST_VIDEO_FRAME_COMP_PSTRIDE (frame, 2);
 
-  for (y = 0; y < height2; y++) {
+  for (y = CHROMA_LINE (frame, first_line);
+      y < CHROMA_LINE (frame, last_line); y++) {
     guint8 *uptr, *vptr;
     guint8 u1, v1;
 
@@ -355,9 +372,9 @@ static const gint cog_rgb_to_ycbcr_matrix_8bit_sdtv[] = {
 
 static void
 gst_video_balance_packed_rgb (GstVideoBalance * videobalance,
-    GstVideoFrame * frame)
+    GstVideoFrame * frame, gint first_line, gint last_line)
 {
-  gint i, j, height;
+  gint i, j;
   gint width, stride, row_wrap;
   gint pixel_stride;
   guint8 *data;
@@ -365,24 +382,24 @@ gst_video_balance_packed_rgb (GstVideoBalance * videobalance,
   gint r, g, b;
   gint y, u, v;
   gint u_tmp, v_tmp;
-  guint8 *tabley = videobalance->tabley;
-  guint8 **tableu = videobalance->tableu;
-  guint8 **tablev = videobalance->tablev;
+  GstVideoBalanceTables *tables = videobalance->frame_tables;
+  guint8 *tabley = tables->y;
+  guint8 (*tableu)[256] = tables->u;
+  guint8 (*tablev)[256] = tables->v;
 
   width = GST_VIDEO_FRAME_WIDTH (frame);
-  height = GST_VIDEO_FRAME_HEIGHT (frame);
 
   offsets[0] = GST_VIDEO_FRAME_COMP_OFFSET (frame, 0);
   offsets[1] = GST_VIDEO_FRAME_COMP_OFFSET (frame, 1);
   offsets[2] = GST_VIDEO_FRAME_COMP_OFFSET (frame, 2);
 
-  data = GST_VIDEO_FRAME_PLANE_DATA (frame, 0);
   stride = GST_VIDEO_FRAME_PLANE_STRIDE (frame, 0);
+  data = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (frame, 0) + first_line * stride;
 
   pixel_stride = GST_VIDEO_FRAME_COMP_PSTRIDE (frame, 0);
   row_wrap = stride - pixel_stride * width;
 
-  for (i = 0; i < height; i++) {
+  for (i = first_line; i < last_line; i++) {
     for (j = 0; j < width; j++) {
       r = data[offsets[0]];
       g = data[offsets[1]];
@@ -486,6 +503,13 @@ gst_video_balance_before_transform (GstBaseTransform * base, GstBuffer * buf)
 
   if (GST_CLOCK_TIME_IS_VALID (stream_time))
     gst_object_sync_values (GST_OBJECT (balance), stream_time);
+
+  if (balance->frame_tables)
+    g_atomic_rc_box_release (balance->frame_tables);
+  GST_OBJECT_LOCK (balance);
+  balance->frame_tables =
+      balance->tables ? g_atomic_rc_box_acquire (balance->tables) : NULL;
+  GST_OBJECT_UNLOCK (balance);
 }
 
 static GstCaps *
@@ -519,17 +543,20 @@ gst_video_balance_transform_caps (GstBaseTransform * trans,
 }
 
 static GstFlowReturn
-gst_video_balance_transform_frame_ip (GstVideoFilter * vfilter,
-    GstVideoFrame * frame)
+gst_video_balance_transform_frame_ip_lines (GstVideoFilter * vfilter,
+    GstVideoFrame * frame, guint y, guint height)
 {
   GstVideoBalance *videobalance = GST_VIDEO_BALANCE (vfilter);
 
   if (!videobalance->process)
     goto not_negotiated;
 
-  GST_OBJECT_LOCK (videobalance);
-  videobalance->process (videobalance, frame);
-  GST_OBJECT_UNLOCK (videobalance);
+  /* the properties only stopped being the passthrough ones after the frame
+   * was started */
+  if (!videobalance->frame_tables)
+    return GST_FLOW_OK;
+
+  videobalance->process (videobalance, frame, y, y + height);
 
   return GST_FLOW_OK;
 
@@ -547,7 +574,10 @@ gst_video_balance_finalize (GObject * object)
   GList *channels = NULL;
   GstVideoBalance *balance = GST_VIDEO_BALANCE (object);
 
-  g_free (balance->tableu[0]);
+  if (balance->tables)
+    g_atomic_rc_box_release (balance->tables);
+  if (balance->frame_tables)
+    g_atomic_rc_box_release (balance->frame_tables);
 
   channels = balance->channels;
   while (channels) {
@@ -612,8 +642,8 @@ gst_video_balance_class_init (GstVideoBalanceClass * klass)
       GST_DEBUG_FUNCPTR (gst_video_balance_transform_caps);
 
   vfilter_class->set_info = GST_DEBUG_FUNCPTR (gst_video_balance_set_info);
-  vfilter_class->transform_frame_ip =
-      GST_DEBUG_FUNCPTR (gst_video_balance_transform_frame_ip);
+  vfilter_class->transform_frame_ip_lines =
+      GST_DEBUG_FUNCPTR (gst_video_balance_transform_frame_ip_lines);
 }
 
 static void
@@ -630,15 +660,6 @@ gst_video_balance_init (GstVideoBalance * videobalance)
   videobalance->hue = DEFAULT_PROP_HUE;
   videobalance->saturation = DEFAULT_PROP_SATURATION;
 
-  videobalance->tableu[0] = g_new (guint8, 256 * 256 * 2);
-  for (i = 0; i < 256; i++) {
-    videobalance->tableu[i] =
-        videobalance->tableu[0] + i * 256 * sizeof (guint8);
-    videobalance->tablev[i] =
-        videobalance->tableu[0] + 256 * 256 * sizeof (guint8) +
-        i * 256 * sizeof (guint8);
-  }
-
   gst_video_balance_update_properties (videobalance);
 
   /* Generate the channels list */
@@ -41,6 +41,13 @@ G_BEGIN_DECLS
 typedef struct _GstVideoBalance GstVideoBalance;
 typedef struct _GstVideoBalanceClass GstVideoBalanceClass;
 
+typedef struct
+{
+  guint8 y[256];
+  guint8 u[256][256];
+  guint8 v[256][256];
+} GstVideoBalanceTables;
+
 /**
  * GstVideoBalance:
  *
@@ -60,12 +67,15 @@ struct _GstVideoBalance {
   gdouble hue;
   gdouble saturation;
 
-  /* tables */
-  guint8 tabley[256];
-  guint8 *tableu[256];
-  guint8 *tablev[256];
+  /* tables, replaced with new ones when the properties change. Protected
+   * by the object lock */
+  GstVideoBalanceTables *tables;
+  /* the tables the current frame is processed with, taken in
+   * before_transform so that all its lines use the same ones */
+  GstVideoBalanceTables *frame_tables;
 
-  void (*process) (GstVideoBalance *balance, GstVideoFrame *frame);
+  void (*process) (GstVideoBalance *balance, GstVideoFrame *frame,
+      gint first_line, gint last_line);
 };
 
 struct _GstVideoBalanceClass {
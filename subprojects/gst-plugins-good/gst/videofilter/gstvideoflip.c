@@ -220,9 +220,48 @@ gst_video_flip_transform_caps (GstBaseTransform * trans,
   return ret;
 }
 
+/* The process functions fill the destination lines from first_line up to but
+ * not including last_line, and the chroma lines covered by them */
+#define DEST_LINE(frame,comp,line) \
+  GST_VIDEO_FORMAT_INFO_SCALE_HEIGHT ((frame)->info.finfo, comp, line)
+
+static void
+gst_video_flip_copy_plane_lines (GstVideoFrame * dest,
+    const GstVideoFrame * src, gint plane, gint first_line, gint last_line)
+{
+  gint comp[GST_VIDEO_MAX_COMPONENTS];
+  gint src_stride, dest_stride, row_size, y;
+  const guint8 *s;
+  guint8 *d;
+
+  gst_video_format_info_component (dest->info.finfo, plane, comp);
+
+  src_stride = GST_VIDEO_FRAME_PLANE_STRIDE (src, plane);
+  dest_stride = GST_VIDEO_FRAME_PLANE_STRIDE (dest, plane);
+  row_size = GST_VIDEO_FRAME_COMP_WIDTH (dest, comp[0]) *
+      GST_VIDEO_FRAME_COMP_PSTRIDE (dest, comp[0]);
+
+  s = GST_VIDEO_FRAME_PLANE_DATA (src, plane);
+  d = GST_VIDEO_FRAME_PLANE_DATA (dest, plane);
+
+  for (y = DEST_LINE (dest, comp[0], first_line);
+      y < DEST_LINE (dest, comp[0], last_line); y++)
+    memcpy (d + y * dest_stride, s + y * src_stride, row_size);
+}
+
+static void
+gst_video_flip_copy_lines (GstVideoFrame * dest, const GstVideoFrame * src,
+    gint first_line, gint last_line)
+{
+  gint i;
+
+  for (i = 0; i < GST_VIDEO_FRAME_N_PLANES (dest); i++)
+    gst_video_flip_copy_plane_lines (dest, src, i, first_line, last_line);
+}
+
 static void
 gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
-    const GstVideoFrame * src)
+    const GstVideoFrame * src, gint first_line, gint last_line)
 {
   gint x, y;
   guint8 const *s;
@@ -231,7 +270,8 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
   gint src_y_height, src_u_height, src_v_height;
   gint src_y_width, src_u_width, src_v_width;
   gint dest_y_stride, dest_u_stride, dest_v_stride;
-  gint dest_y_height, dest_u_height, dest_v_height;
+  gint dest_y_first, dest_u_first, dest_v_first;
+  gint dest_y_last, dest_u_last, dest_v_last;
   gint dest_y_width, dest_u_width, dest_v_width;
 
   src_y_stride = GST_VIDEO_FRAME_PLANE_STRIDE (src, 0);
@@ -254,16 +294,19 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
   src_u_height = GST_VIDEO_FRAME_COMP_HEIGHT (src, 1);
   src_v_height = GST_VIDEO_FRAME_COMP_HEIGHT (src, 2);
 
-  dest_y_height = GST_VIDEO_FRAME_COMP_HEIGHT (dest, 0);
-  dest_u_height = GST_VIDEO_FRAME_COMP_HEIGHT (dest, 1);
-  dest_v_height = GST_VIDEO_FRAME_COMP_HEIGHT (dest, 2);
+  dest_y_first = DEST_LINE (dest, 0, first_line);
+  dest_u_first = DEST_LINE (dest, 1, first_line);
+  dest_v_first = DEST_LINE (dest, 2, first_line);
+  dest_y_last = DEST_LINE (dest, 0, last_line);
+  dest_u_last = DEST_LINE (dest, 1, last_line);
+  dest_v_last = DEST_LINE (dest, 2, last_line);
 
   switch (videoflip->active_method) {
     case GST_VIDEO_ORIENTATION_90R:
       /* Flip Y */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
+      for (y = dest_y_first; y < dest_y_last; y++) {
         for (x = 0; x < dest_y_width; x++) {
           d[y * dest_y_stride + x] =
               s[(src_y_height - 1 - x) * src_y_stride + y];
@@ -272,7 +315,7 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip U */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_u_height; y++) {
+      for (y = dest_u_first; y < dest_u_last; y++) {
         for (x = 0; x < dest_u_width; x++) {
           d[y * dest_u_stride + x] =
               s[(src_u_height - 1 - x) * src_u_stride + y];
@@ -281,7 +324,7 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip V */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 2);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 2);
-      for (y = 0; y < dest_v_height; y++) {
+      for (y = dest_v_first; y < dest_v_last; y++) {
         for (x = 0; x < dest_v_width; x++) {
           d[y * dest_v_stride + x] =
               s[(src_v_height - 1 - x) * src_v_stride + y];
@@ -292,7 +335,7 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip Y */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
+      for (y = dest_y_first; y < dest_y_last; y++) {
         for (x = 0; x < dest_y_width; x++) {
           d[y * dest_y_stride + x] =
               s[x * src_y_stride + (src_y_width - 1 - y)];
@@ -301,7 +344,7 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip U */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_u_height; y++) {
+      for (y = dest_u_first; y < dest_u_last; y++) {
         for (x = 0; x < dest_u_width; x++) {
           d[y * dest_u_stride + x] =
               s[x * src_u_stride + (src_u_width - 1 - y)];
@@ -310,7 +353,7 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip V */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 2);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 2);
-      for (y = 0; y < dest_v_height; y++) {
+      for (y = dest_v_first; y < dest_v_last; y++) {
         for (x = 0; x < dest_v_width; x++) {
           d[y * dest_v_stride + x] =
               s[x * src_v_stride + (src_v_width - 1 - y)];
@@ -321,7 +364,7 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip Y */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
+      for (y = dest_y_first; y < dest_y_last; y++) {
         for (x = 0; x < dest_y_width; x++) {
           d[y * dest_y_stride + x] =
               s[(src_y_height - 1 - y) * src_y_stride + (src_y_width - 1 - x)];
@@ -330,7 +373,7 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip U */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_u_height; y++) {
+      for (y = dest_u_first; y < dest_u_last; y++) {
         for (x = 0; x < dest_u_width; x++) {
           d[y * dest_u_stride + x] =
               s[(src_u_height - 1 - y) * src_u_stride + (src_u_width - 1 - x)];
@@ -339,7 +382,7 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip V */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 2);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 2);
-      for (y = 0; y < dest_v_height; y++) {
+      for (y = dest_v_first; y < dest_v_last; y++) {
         for (x = 0; x < dest_v_width; x++) {
           d[y * dest_v_stride + x] =
               s[(src_v_height - 1 - y) * src_v_stride + (src_v_width - 1 - x)];
@@ -350,7 +393,7 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip Y */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
+      for (y = dest_y_first; y < dest_y_last; y++) {
         for (x = 0; x < dest_y_width; x++) {
           d[y * dest_y_stride + x] =
               s[y * src_y_stride + (src_y_width - 1 - x)];
@@ -359,7 +402,7 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip U */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_u_height; y++) {
+      for (y = dest_u_first; y < dest_u_last; y++) {
         for (x = 0; x < dest_u_width; x++) {
           d[y * dest_u_stride + x] =
               s[y * src_u_stride + (src_u_width - 1 - x)];
@@ -368,7 +411,7 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip V */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 2);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 2);
-      for (y = 0; y < dest_v_height; y++) {
+      for (y = dest_v_first; y < dest_v_last; y++) {
         for (x = 0; x < dest_v_width; x++) {
           d[y * dest_v_stride + x] =
               s[y * src_v_stride + (src_v_width - 1 - x)];
@@ -379,7 +422,7 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip Y */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
+      for (y = dest_y_first; y < dest_y_last; y++) {
         for (x = 0; x < dest_y_width; x++) {
           d[y * dest_y_stride + x] =
               s[(src_y_height - 1 - y) * src_y_stride + x];
@@ -388,7 +431,7 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip U */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_u_height; y++) {
+      for (y = dest_u_first; y < dest_u_last; y++) {
         for (x = 0; x < dest_u_width; x++) {
           d[y * dest_u_stride + x] =
               s[(src_u_height - 1 - y) * src_u_stride + x];
@@ -397,7 +440,7 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip V */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 2);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 2);
-      for (y = 0; y < dest_v_height; y++) {
+      for (y = dest_v_first; y < dest_v_last; y++) {
         for (x = 0; x < dest_v_width; x++) {
           d[y * dest_v_stride + x] =
               s[(src_v_height - 1 - y) * src_v_stride + x];
@@ -408,7 +451,7 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip Y */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
+      for (y = dest_y_first; y < dest_y_last; y++) {
         for (x = 0; x < dest_y_width; x++) {
           d[y * dest_y_stride + x] = s[x * src_y_stride + y];
         }
@@ -416,7 +459,7 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip U */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_u_height; y++) {
+      for (y = dest_u_first; y < dest_u_last; y++) {
         for (x = 0; x < dest_u_width; x++) {
           d[y * dest_u_stride + x] = s[x * src_u_stride + y];
         }
@@ -424,7 +467,7 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip V */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 2);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 2);
-      for (y = 0; y < dest_v_height; y++) {
+      for (y = dest_v_first; y < dest_v_last; y++) {
         for (x = 0; x < dest_v_width; x++) {
           d[y * dest_v_stride + x] = s[x * src_v_stride + y];
         }
@@ -434,7 +477,7 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip Y */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
+      for (y = dest_y_first; y < dest_y_last; y++) {
         for (x = 0; x < dest_y_width; x++) {
           d[y * dest_y_stride + x] =
               s[(src_y_height - 1 - x) * src_y_stride + (src_y_width - 1 - y)];
@@ -443,7 +486,7 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip U */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_u_height; y++) {
+      for (y = dest_u_first; y < dest_u_last; y++) {
         for (x = 0; x < dest_u_width; x++) {
           d[y * dest_u_stride + x] =
               s[(src_u_height - 1 - x) * src_u_stride + (src_u_width - 1 - y)];
@@ -452,7 +495,7 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip V */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 2);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 2);
-      for (y = 0; y < dest_v_height; y++) {
+      for (y = dest_v_first; y < dest_v_last; y++) {
         for (x = 0; x < dest_v_width; x++) {
           d[y * dest_v_stride + x] =
               s[(src_v_height - 1 - x) * src_v_stride + (src_v_width - 1 - y)];
@@ -460,7 +503,7 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       }
       break;
     case GST_VIDEO_ORIENTATION_IDENTITY:
-      gst_video_frame_copy (dest, src);
+      gst_video_flip_copy_lines (dest, src, first_line, last_line);
       break;
     default:
       g_assert_not_reached ();
@@ -470,7 +513,7 @@ gst_video_flip_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
 
 static void
 gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
-    const GstVideoFrame * src)
+    const GstVideoFrame * src, gint first_line, gint last_line)
 {
   gint x, y;
   guint16 const *s;
@@ -479,7 +522,8 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
   gint src_y_height, src_u_height, src_v_height;
   gint src_y_width, src_u_width, src_v_width;
   gint dest_y_stride, dest_u_stride, dest_v_stride;
-  gint dest_y_height, dest_u_height, dest_v_height;
+  gint dest_y_first, dest_u_first, dest_v_first;
+  gint dest_y_last, dest_u_last, dest_v_last;
   gint dest_y_width, dest_u_width, dest_v_width;
 
   /* Divide strides by 2 because we're operating on guint16's */
@@ -503,16 +547,19 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
   src_u_height = GST_VIDEO_FRAME_COMP_HEIGHT (src, 1);
   src_v_height = GST_VIDEO_FRAME_COMP_HEIGHT (src, 2);
 
-  dest_y_height = GST_VIDEO_FRAME_COMP_HEIGHT (dest, 0);
-  dest_u_height = GST_VIDEO_FRAME_COMP_HEIGHT (dest, 1);
-  dest_v_height = GST_VIDEO_FRAME_COMP_HEIGHT (dest, 2);
+  dest_y_first = DEST_LINE (dest, 0, first_line);
+  dest_u_first = DEST_LINE (dest, 1, first_line);
+  dest_v_first = DEST_LINE (dest, 2, first_line);
+  dest_y_last = DEST_LINE (dest, 0, last_line);
+  dest_u_last = DEST_LINE (dest, 1, last_line);
+  dest_v_last = DEST_LINE (dest, 2, last_line);
 
   switch (videoflip->active_method) {
     case GST_VIDEO_ORIENTATION_90R:
       /* Flip Y */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
+      for (y = dest_y_first; y < dest_y_last; y++) {
         for (x = 0; x < dest_y_width; x++) {
           d[y * dest_y_stride + x] =
               s[(src_y_height - 1 - x) * src_y_stride + y];
@@ -521,7 +568,7 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip U */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_u_height; y++) {
+      for (y = dest_u_first; y < dest_u_last; y++) {
         for (x = 0; x < dest_u_width; x++) {
           d[y * dest_u_stride + x] =
               s[(src_u_height - 1 - x) * src_u_stride + y];
@@ -530,7 +577,7 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip V */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 2);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 2);
-      for (y = 0; y < dest_v_height; y++) {
+      for (y = dest_v_first; y < dest_v_last; y++) {
         for (x = 0; x < dest_v_width; x++) {
           d[y * dest_v_stride + x] =
               s[(src_v_height - 1 - x) * src_v_stride + y];
@@ -541,7 +588,7 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip Y */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
+      for (y = dest_y_first; y < dest_y_last; y++) {
         for (x = 0; x < dest_y_width; x++) {
           d[y * dest_y_stride + x] =
               s[x * src_y_stride + (src_y_width - 1 - y)];
@@ -550,7 +597,7 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip U */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_u_height; y++) {
+      for (y = dest_u_first; y < dest_u_last; y++) {
         for (x = 0; x < dest_u_width; x++) {
           d[y * dest_u_stride + x] =
               s[x * src_u_stride + (src_u_width - 1 - y)];
@@ -559,7 +606,7 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip V */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 2);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 2);
-      for (y = 0; y < dest_v_height; y++) {
+      for (y = dest_v_first; y < dest_v_last; y++) {
         for (x = 0; x < dest_v_width; x++) {
           d[y * dest_v_stride + x] =
               s[x * src_v_stride + (src_v_width - 1 - y)];
@@ -570,7 +617,7 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip Y */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
+      for (y = dest_y_first; y < dest_y_last; y++) {
         for (x = 0; x < dest_y_width; x++) {
           d[y * dest_y_stride + x] =
               s[(src_y_height - 1 - y) * src_y_stride + (src_y_width - 1 - x)];
@@ -579,7 +626,7 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip U */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_u_height; y++) {
+      for (y = dest_u_first; y < dest_u_last; y++) {
         for (x = 0; x < dest_u_width; x++) {
           d[y * dest_u_stride + x] =
               s[(src_u_height - 1 - y) * src_u_stride + (src_u_width - 1 - x)];
@@ -588,7 +635,7 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip V */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 2);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 2);
-      for (y = 0; y < dest_v_height; y++) {
+      for (y = dest_v_first; y < dest_v_last; y++) {
         for (x = 0; x < dest_v_width; x++) {
           d[y * dest_v_stride + x] =
               s[(src_v_height - 1 - y) * src_v_stride + (src_v_width - 1 - x)];
@@ -599,7 +646,7 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip Y */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
+      for (y = dest_y_first; y < dest_y_last; y++) {
         for (x = 0; x < dest_y_width; x++) {
           d[y * dest_y_stride + x] =
               s[y * src_y_stride + (src_y_width - 1 - x)];
@@ -608,7 +655,7 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip U */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_u_height; y++) {
+      for (y = dest_u_first; y < dest_u_last; y++) {
         for (x = 0; x < dest_u_width; x++) {
           d[y * dest_u_stride + x] =
               s[y * src_u_stride + (src_u_width - 1 - x)];
@@ -617,7 +664,7 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip V */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 2);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 2);
-      for (y = 0; y < dest_v_height; y++) {
+      for (y = dest_v_first; y < dest_v_last; y++) {
         for (x = 0; x < dest_v_width; x++) {
           d[y * dest_v_stride + x] =
               s[y * src_v_stride + (src_v_width - 1 - x)];
@@ -628,7 +675,7 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip Y */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
+      for (y = dest_y_first; y < dest_y_last; y++) {
         for (x = 0; x < dest_y_width; x++) {
           d[y * dest_y_stride + x] =
               s[(src_y_height - 1 - y) * src_y_stride + x];
@@ -637,7 +684,7 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip U */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_u_height; y++) {
+      for (y = dest_u_first; y < dest_u_last; y++) {
         for (x = 0; x < dest_u_width; x++) {
           d[y * dest_u_stride + x] =
               s[(src_u_height - 1 - y) * src_u_stride + x];
@@ -646,7 +693,7 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip V */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 2);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 2);
-      for (y = 0; y < dest_v_height; y++) {
+      for (y = dest_v_first; y < dest_v_last; y++) {
         for (x = 0; x < dest_v_width; x++) {
           d[y * dest_v_stride + x] =
               s[(src_v_height - 1 - y) * src_v_stride + x];
@@ -657,7 +704,7 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip Y */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
+      for (y = dest_y_first; y < dest_y_last; y++) {
         for (x = 0; x < dest_y_width; x++) {
           d[y * dest_y_stride + x] = s[x * src_y_stride + y];
         }
@@ -665,7 +712,7 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip U */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_u_height; y++) {
+      for (y = dest_u_first; y < dest_u_last; y++) {
         for (x = 0; x < dest_u_width; x++) {
           d[y * dest_u_stride + x] = s[x * src_u_stride + y];
         }
@@ -673,7 +720,7 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip V */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 2);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 2);
-      for (y = 0; y < dest_v_height; y++) {
+      for (y = dest_v_first; y < dest_v_last; y++) {
         for (x = 0; x < dest_v_width; x++) {
           d[y * dest_v_stride + x] = s[x * src_v_stride + y];
         }
@@ -683,7 +730,7 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip Y */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
+      for (y = dest_y_first; y < dest_y_last; y++) {
         for (x = 0; x < dest_y_width; x++) {
           d[y * dest_y_stride + x] =
               s[(src_y_height - 1 - x) * src_y_stride + (src_y_width - 1 - y)];
@@ -692,7 +739,7 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip U */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_u_height; y++) {
+      for (y = dest_u_first; y < dest_u_last; y++) {
         for (x = 0; x < dest_u_width; x++) {
           d[y * dest_u_stride + x] =
               s[(src_u_height - 1 - x) * src_u_stride + (src_u_width - 1 - y)];
@@ -701,7 +748,7 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip V */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 2);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 2);
-      for (y = 0; y < dest_v_height; y++) {
+      for (y = dest_v_first; y < dest_v_last; y++) {
         for (x = 0; x < dest_v_width; x++) {
           d[y * dest_v_stride + x] =
               s[(src_v_height - 1 - x) * src_v_stride + (src_v_width - 1 - y)];
@@ -709,7 +756,7 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
       }
       break;
     case GST_VIDEO_ORIENTATION_IDENTITY:
-      gst_video_frame_copy (dest, src);
+      gst_video_flip_copy_lines (dest, src, first_line, last_line);
       break;
     default:
       g_assert_not_reached ();
@@ -720,10 +767,10 @@ gst_video_flip_planar_yuv_16bit (GstVideoFlip * videoflip, GstVideoFrame * dest,
 static inline void
 rotate_yuv422_plane (GstVideoFrame * dest, const GstVideoFrame * src,
     gint plane_index, GstVideoOrientationMethod method,
-    gboolean is_chroma, gboolean is_le)
+    gboolean is_chroma, gboolean is_le, gint first_line, gint last_line)
 {
   gint src_stride, src_height, src_width;
-  gint dest_stride, dest_height, dest_width;
+  gint dest_stride, dest_first, dest_last, dest_width;
   gint x, y;
   guint scale;
   guint16 const *s, *addr;
@@ -739,7 +786,8 @@ rotate_yuv422_plane (GstVideoFrame * dest, const GstVideoFrame * src,
   src_width = GST_VIDEO_FRAME_COMP_WIDTH (src, plane_index);
 
   dest_stride = GST_VIDEO_FRAME_PLANE_STRIDE (dest, plane_index) / 2;
-  dest_height = GST_VIDEO_FRAME_COMP_HEIGHT (dest, plane_index);
+  dest_first = DEST_LINE (dest, plane_index, first_line);
+  dest_last = DEST_LINE (dest, plane_index, last_line);
   dest_width = GST_VIDEO_FRAME_COMP_WIDTH (dest, plane_index);
 
   scale = is_chroma ? 2 : 1;
@@ -747,7 +795,7 @@ rotate_yuv422_plane (GstVideoFrame * dest, const GstVideoFrame * src,
   switch (method) {
     case GST_VIDEO_ORIENTATION_90R:
       if (is_le) {
-        for (y = 0; y < dest_height; y++) {
+        for (y = dest_first; y < dest_last; y++) {
           for (x = 0; x < dest_width; x++) {
             addr = s + (src_height - 1 - x * scale) * src_stride + y / scale;
             val = GST_READ_UINT16_LE (addr);
@@ -762,7 +810,7 @@ rotate_yuv422_plane (GstVideoFrame * dest, const GstVideoFrame * src,
           }
         }
       } else {
-        for (y = 0; y < dest_height; y++) {
+        for (y = dest_first; y < dest_last; y++) {
           for (x = 0; x < dest_width; x++) {
             addr = s + (src_height - 1 - x * scale) * src_stride + y / scale;
             val = GST_READ_UINT16_BE (addr);
@@ -780,7 +828,7 @@ rotate_yuv422_plane (GstVideoFrame * dest, const GstVideoFrame * src,
       break;
     case GST_VIDEO_ORIENTATION_90L:
       if (is_le) {
-        for (y = 0; y < dest_height; y++) {
+        for (y = dest_first; y < dest_last; y++) {
           for (x = 0; x < dest_width; x++) {
             addr = s + x * scale * src_stride + (src_width - 1 - y / scale);
             val = GST_READ_UINT16_LE (addr);
@@ -795,7 +843,7 @@ rotate_yuv422_plane (GstVideoFrame * dest, const GstVideoFrame * src,
           }
         }
       } else {
-        for (y = 0; y < dest_height; y++) {
+        for (y = dest_first; y < dest_last; y++) {
           for (x = 0; x < dest_width; x++) {
             addr = s + x * scale * src_stride + (src_width - 1 - y / scale);
             val = GST_READ_UINT16_BE (addr);
@@ -812,7 +860,7 @@ rotate_yuv422_plane (GstVideoFrame * dest, const GstVideoFrame * src,
       }
       break;
     case GST_VIDEO_ORIENTATION_180:
-      for (y = 0; y < dest_height; y++) {
+      for (y = dest_first; y < dest_last; y++) {
         for (x = 0; x < dest_width; x++) {
           d[y * dest_stride + x] =
               s[(src_height - 1 - y) * src_stride + (src_width - 1 - x)];
@@ -820,14 +868,14 @@ rotate_yuv422_plane (GstVideoFrame * dest, const GstVideoFrame * src,
       }
       break;
     case GST_VIDEO_ORIENTATION_HORIZ:
-      for (y = 0; y < dest_height; y++) {
+      for (y = dest_first; y < dest_last; y++) {
         for (x = 0; x < dest_width; x++) {
           d[y * dest_stride + x] = s[y * src_stride + (src_width - 1 - x)];
         }
       }
       break;
     case GST_VIDEO_ORIENTATION_VERT:
-      for (y = 0; y < dest_height; y++) {
+      for (y = dest_first; y < dest_last; y++) {
         for (x = 0; x < dest_width; x++) {
           d[y * dest_stride + x] = s[(src_height - 1 - y) * src_stride + x];
         }
@@ -835,7 +883,7 @@ rotate_yuv422_plane (GstVideoFrame * dest, const GstVideoFrame * src,
       break;
     case GST_VIDEO_ORIENTATION_UL_LR:
       if (is_le) {
-        for (y = 0; y < dest_height; y++) {
+        for (y = dest_first; y < dest_last; y++) {
           for (x = 0; x < dest_width; x++) {
             addr = s + x * scale * src_stride + y / scale;
             val = GST_READ_UINT16_LE (addr);
@@ -850,7 +898,7 @@ rotate_yuv422_plane (GstVideoFrame * dest, const GstVideoFrame * src,
           }
         }
       } else {
-        for (y = 0; y < dest_height; y++) {
+        for (y = dest_first; y < dest_last; y++) {
           for (x = 0; x < dest_width; x++) {
             addr = s + x * scale * src_stride + y / scale;
             val = GST_READ_UINT16_BE (addr);
@@ -868,7 +916,7 @@ rotate_yuv422_plane (GstVideoFrame * dest, const GstVideoFrame * src,
       break;
     case GST_VIDEO_ORIENTATION_UR_LL:
       if (is_le) {
-        for (y = 0; y < dest_height; y++) {
+        for (y = dest_first; y < dest_last; y++) {
           for (x = 0; x < dest_width; x++) {
             addr = s
                 + (src_height - 1 - x * scale) * src_stride
@@ -887,7 +935,7 @@ rotate_yuv422_plane (GstVideoFrame * dest, const GstVideoFrame * src,
           }
         }
       } else {
-        for (y = 0; y < dest_height; y++) {
+        for (y = dest_first; y < dest_last; y++) {
           for (x = 0; x < dest_width; x++) {
             addr = s
                 + (src_height - 1 - x * scale) * src_stride
@@ -908,7 +956,8 @@ rotate_yuv422_plane (GstVideoFrame * dest, const GstVideoFrame * src,
       }
       break;
     case GST_VIDEO_ORIENTATION_IDENTITY:
-      gst_video_frame_copy (dest, src);
+      gst_video_flip_copy_plane_lines (dest, src, plane_index, first_line,
+          last_line);
       break;
     default:
       g_assert_not_reached ();
@@ -918,7 +967,8 @@ rotate_yuv422_plane (GstVideoFrame * dest, const GstVideoFrame * src,
 
 static void
 gst_video_flip_planar_yuv_422_16bit (GstVideoFlip * videoflip,
-    GstVideoFrame * dest, const GstVideoFrame * src)
+    GstVideoFrame * dest, const GstVideoFrame * src, gint first_line,
+    gint last_line)
 {
   gboolean format_is_le;
 
@@ -929,19 +979,25 @@ gst_video_flip_planar_yuv_422_16bit (GstVideoFlip * videoflip,
   /* Attempt to get the compiler to inline specialized variants of this function 
    * to avoid too much branching due to endianness checks */
   if (format_is_le) {
-    rotate_yuv422_plane (dest, src, 0, videoflip->active_method, FALSE, TRUE);
-    rotate_yuv422_plane (dest, src, 1, videoflip->active_method, TRUE, TRUE);
-    rotate_yuv422_plane (dest, src, 2, videoflip->active_method, TRUE, TRUE);
+    rotate_yuv422_plane (dest, src, 0, videoflip->active_method, FALSE, TRUE,
+        first_line, last_line);
+    rotate_yuv422_plane (dest, src, 1, videoflip->active_method, TRUE, TRUE,
+        first_line, last_line);
+    rotate_yuv422_plane (dest, src, 2, videoflip->active_method, TRUE, TRUE,
+        first_line, last_line);
   } else {
-    rotate_yuv422_plane (dest, src, 0, videoflip->active_method, FALSE, FALSE);
-    rotate_yuv422_plane (dest, src, 1, videoflip->active_method, TRUE, FALSE);
-    rotate_yuv422_plane (dest, src, 2, videoflip->active_method, TRUE, FALSE);
+    rotate_yuv422_plane (dest, src, 0, videoflip->active_method, FALSE, FALSE,
+        first_line, last_line);
+    rotate_yuv422_plane (dest, src, 1, videoflip->active_method, TRUE, FALSE,
+        first_line, last_line);
+    rotate_yuv422_plane (dest, src, 2, videoflip->active_method, TRUE, FALSE,
+        first_line, last_line);
   }
 }
 
 static void
 gst_video_flip_semi_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
-    const GstVideoFrame * src)
+    const GstVideoFrame * src, gint first_line, gint last_line)
 {
   gint x, y;
   guint8 const *s;
@@ -951,7 +1007,8 @@ gst_video_flip_semi_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
   gint src_y_height, src_uv_height;
   gint src_y_width, src_uv_width;
   gint dest_y_stride, dest_uv_stride;
-  gint dest_y_height, dest_uv_height;
+  gint dest_y_first, dest_uv_first;
+  gint dest_y_last, dest_uv_last;
   gint dest_y_width, dest_uv_width;
 
 
@@ -970,15 +1027,17 @@ gst_video_flip_semi_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
   src_y_height = GST_VIDEO_FRAME_COMP_HEIGHT (src, 0);
   src_uv_height = GST_VIDEO_FRAME_COMP_HEIGHT (src, 1);
 
-  dest_y_height = GST_VIDEO_FRAME_COMP_HEIGHT (dest, 0);
-  dest_uv_height = GST_VIDEO_FRAME_COMP_HEIGHT (dest, 1);
+  dest_y_first = DEST_LINE (dest, 0, first_line);
+  dest_uv_first = DEST_LINE (dest, 1, first_line);
+  dest_y_last = DEST_LINE (dest, 0, last_line);
+  dest_uv_last = DEST_LINE (dest, 1, last_line);
 
   switch (videoflip->active_method) {
     case GST_VIDEO_ORIENTATION_90R:
       /* Flip Y */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
+      for (y = dest_y_first; y < dest_y_last; y++) {
         for (x = 0; x < dest_y_width; x++) {
           d[y * dest_y_stride + x] =
               s[(src_y_height - 1 - x) * src_y_stride + y];
@@ -987,7 +1046,7 @@ gst_video_flip_semi_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip UV */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_uv_height; y++) {
+      for (y = dest_uv_first; y < dest_uv_last; y++) {
         for (x = 0; x < dest_uv_width; x++) {
           d_off = y * dest_uv_stride + x * 2;
           s_off = (src_uv_height - 1 - x) * src_uv_stride + y * 2;
@@ -1000,7 +1059,7 @@ gst_video_flip_semi_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip Y */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
+      for (y = dest_y_first; y < dest_y_last; y++) {
         for (x = 0; x < dest_y_width; x++) {
           d[y * dest_y_stride + x] =
               s[x * src_y_stride + (src_y_width - 1 - y)];
@@ -1009,7 +1068,7 @@ gst_video_flip_semi_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip UV */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_uv_height; y++) {
+      for (y = dest_uv_first; y < dest_uv_last; y++) {
         for (x = 0; x < dest_uv_width; x++) {
           d_off = y * dest_uv_stride + x * 2;
           s_off = x * src_uv_stride + (src_uv_width - 1 - y) * 2;
@@ -1022,7 +1081,7 @@ gst_video_flip_semi_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip Y */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
+      for (y = dest_y_first; y < dest_y_last; y++) {
         for (x = 0; x < dest_y_width; x++) {
           d[y * dest_y_stride + x] =
               s[(src_y_height - 1 - y) * src_y_stride + (src_y_width - 1 - x)];
@@ -1031,7 +1090,7 @@ gst_video_flip_semi_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip UV */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_uv_height; y++) {
+      for (y = dest_uv_first; y < dest_uv_last; y++) {
         for (x = 0; x < dest_uv_width; x++) {
           d_off = y * dest_uv_stride + x * 2;
           s_off = (src_uv_height - 1 - y) * src_uv_stride + (src_uv_width - 1 -
@@ -1045,7 +1104,7 @@ gst_video_flip_semi_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip Y */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
+      for (y = dest_y_first; y < dest_y_last; y++) {
         for (x = 0; x < dest_y_width; x++) {
           d[y * dest_y_stride + x] =
               s[y * src_y_stride + (src_y_width - 1 - x)];
@@ -1054,7 +1113,7 @@ gst_video_flip_semi_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip UV */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_uv_height; y++) {
+      for (y = dest_uv_first; y < dest_uv_last; y++) {
         for (x = 0; x < dest_uv_width; x++) {
           d_off = y * dest_uv_stride + x * 2;
           s_off = y * src_uv_stride + (src_uv_width - 1 - x) * 2;
@@ -1067,7 +1126,7 @@ gst_video_flip_semi_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip Y */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
+      for (y = dest_y_first; y < dest_y_last; y++) {
         for (x = 0; x < dest_y_width; x++) {
           d[y * dest_y_stride + x] =
               s[(src_y_height - 1 - y) * src_y_stride + x];
@@ -1076,7 +1135,7 @@ gst_video_flip_semi_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip UV */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_uv_height; y++) {
+      for (y = dest_uv_first; y < dest_uv_last; y++) {
         for (x = 0; x < dest_uv_width; x++) {
           d_off = y * dest_uv_stride + x * 2;
           s_off = (src_uv_height - 1 - y) * src_uv_stride + x * 2;
@@ -1089,7 +1148,7 @@ gst_video_flip_semi_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip Y */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
+      for (y = dest_y_first; y < dest_y_last; y++) {
         for (x = 0; x < dest_y_width; x++) {
           d[y * dest_y_stride + x] = s[x * src_y_stride + y];
         }
@@ -1097,7 +1156,7 @@ gst_video_flip_semi_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip UV */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_uv_height; y++) {
+      for (y = dest_uv_first; y < dest_uv_last; y++) {
         for (x = 0; x < dest_uv_width; x++) {
           d_off = y * dest_uv_stride + x * 2;
           s_off = x * src_uv_stride + y * 2;
@@ -1110,7 +1169,7 @@ gst_video_flip_semi_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip Y */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 0);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 0);
-      for (y = 0; y < dest_y_height; y++) {
+      for (y = dest_y_first; y < dest_y_last; y++) {
         for (x = 0; x < dest_y_width; x++) {
           d[y * dest_y_stride + x] =
               s[(src_y_height - 1 - x) * src_y_stride + (src_y_width - 1 - y)];
@@ -1119,7 +1178,7 @@ gst_video_flip_semi_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       /* Flip UV */
       s = GST_VIDEO_FRAME_PLANE_DATA (src, 1);
       d = GST_VIDEO_FRAME_PLANE_DATA (dest, 1);
-      for (y = 0; y < dest_uv_height; y++) {
+      for (y = dest_uv_first; y < dest_uv_last; y++) {
         for (x = 0; x < dest_uv_width; x++) {
           d_off = y * dest_uv_stride + x * 2;
           s_off = (src_uv_height - 1 - x) * src_uv_stride + (src_uv_width - 1 -
@@ -1130,7 +1189,7 @@ gst_video_flip_semi_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
       }
       break;
     case GST_VIDEO_ORIENTATION_IDENTITY:
-      gst_video_frame_copy (dest, src);
+      gst_video_flip_copy_lines (dest, src, first_line, last_line);
       break;
     default:
       g_assert_not_reached ();
@@ -1140,7 +1199,7 @@ gst_video_flip_semi_planar_yuv (GstVideoFlip * videoflip, GstVideoFrame * dest,
 
 static void
 gst_video_flip_packed_simple (GstVideoFlip * videoflip, GstVideoFrame * dest,
-    const GstVideoFrame * src)
+    const GstVideoFrame * src, gint first_line, gint last_line)
 {
   gint x, y, z;
   guint8 const *s;
@@ -1148,7 +1207,6 @@ gst_video_flip_packed_simple (GstVideoFlip * videoflip, GstVideoFrame * dest,
   gint sw = GST_VIDEO_FRAME_WIDTH (src);
   gint sh = GST_VIDEO_FRAME_HEIGHT (src);
   gint dw = GST_VIDEO_FRAME_WIDTH (dest);
-  gint dh = GST_VIDEO_FRAME_HEIGHT (dest);
   gint src_stride, dest_stride;
   gint bpp;
 
@@ -1162,7 +1220,7 @@ gst_video_flip_packed_simple (GstVideoFlip * videoflip, GstVideoFrame * dest,
 
   switch (videoflip->active_method) {
     case GST_VIDEO_ORIENTATION_90R:
-      for (y = 0; y < dh; y++) {
+      for (y = first_line; y < last_line; y++) {
         for (x = 0; x < dw; x++) {
           for (z = 0; z < bpp; z++) {
             d[y * dest_stride + x * bpp + z] =
@@ -1172,7 +1230,7 @@ gst_video_flip_packed_simple (GstVideoFlip * videoflip, GstVideoFrame * dest,
       }
       break;
     case GST_VIDEO_ORIENTATION_90L:
-      for (y = 0; y < dh; y++) {
+      for (y = first_line; y < last_line; y++) {
         for (x = 0; x < dw; x++) {
           for (z = 0; z < bpp; z++) {
             d[y * dest_stride + x * bpp + z] =
@@ -1182,7 +1240,7 @@ gst_video_flip_packed_simple (GstVideoFlip * videoflip, GstVideoFrame * dest,
       }
       break;
     case GST_VIDEO_ORIENTATION_180:
-      for (y = 0; y < dh; y++) {
+      for (y = first_line; y < last_line; y++) {
         for (x = 0; x < dw; x++) {
           for (z = 0; z < bpp; z++) {
             d[y * dest_stride + x * bpp + z] =
@@ -1192,7 +1250,7 @@ gst_video_flip_packed_simple (GstVideoFlip * videoflip, GstVideoFrame * dest,
       }
       break;
     case GST_VIDEO_ORIENTATION_HORIZ:
-      for (y = 0; y < dh; y++) {
+      for (y = first_line; y < last_line; y++) {
         for (x = 0; x < dw; x++) {
           for (z = 0; z < bpp; z++) {
             d[y * dest_stride + x * bpp + z] =
@@ -1202,7 +1260,7 @@ gst_video_flip_packed_simple (GstVideoFlip * videoflip, GstVideoFrame * dest,
       }
       break;
     case GST_VIDEO_ORIENTATION_VERT:
-      for (y = 0; y < dh; y++) {
+      for (y = first_line; y < last_line; y++) {
         for (x = 0; x < dw; x++) {
           for (z = 0; z < bpp; z++) {
             d[y * dest_stride + x * bpp + z] =
@@ -1212,7 +1270,7 @@ gst_video_flip_packed_simple (GstVideoFlip * videoflip, GstVideoFrame * dest,
       }
       break;
     case GST_VIDEO_ORIENTATION_UL_LR:
-      for (y = 0; y < dh; y++) {
+      for (y = first_line; y < last_line; y++) {
         for (x = 0; x < dw; x++) {
           for (z = 0; z < bpp; z++) {
             d[y * dest_stride + x * bpp + z] = s[x * src_stride + y * bpp + z];
@@ -1221,7 +1279,7 @@ gst_video_flip_packed_simple (GstVideoFlip * videoflip, GstVideoFrame * dest,
       }
       break;
     case GST_VIDEO_ORIENTATION_UR_LL:
-      for (y = 0; y < dh; y++) {
+      for (y = first_line; y < last_line; y++) {
         for (x = 0; x < dw; x++) {
           for (z = 0; z < bpp; z++) {
             d[y * dest_stride + x * bpp + z] =
@@ -1231,7 +1289,7 @@ gst_video_flip_packed_simple (GstVideoFlip * videoflip, GstVideoFrame * dest,
       }
       break;
     case GST_VIDEO_ORIENTATION_IDENTITY:
-      gst_video_frame_copy (dest, src);
+      gst_video_flip_copy_lines (dest, src, first_line, last_line);
       break;
     default:
       g_assert_not_reached ();
@@ -1241,7 +1299,7 @@ gst_video_flip_packed_simple (GstVideoFlip * videoflip, GstVideoFrame * dest,
 
 static void
 gst_video_flip_y422 (GstVideoFlip * videoflip, GstVideoFrame * dest,
-    const GstVideoFrame * src)
+    const GstVideoFrame * src, gint first_line, gint last_line)
 {
   gint x, y;
   guint8 const *s;
@@ -1249,7 +1307,6 @@ gst_video_flip_y422 (GstVideoFlip * videoflip, GstVideoFrame * dest,
   gint sw = GST_VIDEO_FRAME_WIDTH (src);
   gint sh = GST_VIDEO_FRAME_HEIGHT (src);
   gint dw = GST_VIDEO_FRAME_WIDTH (dest);
-  gint dh = GST_VIDEO_FRAME_HEIGHT (dest);
   gint src_stride, dest_stride;
   gint bpp;
   gint y_offset;
@@ -1271,7 +1328,7 @@ gst_video_flip_y422 (GstVideoFlip * videoflip, GstVideoFrame * dest,
 
   switch (videoflip->active_method) {
     case GST_VIDEO_ORIENTATION_90R:
-      for (y = 0; y < dh; y++) {
+      for (y = first_line; y < last_line; y++) {
         for (x = 0; x < dw; x += 2) {
           guint8 u;
           guint8 v;
@@ -1298,7 +1355,7 @@ gst_video_flip_y422 (GstVideoFlip * videoflip, GstVideoFrame * dest,
       }
       break;
     case GST_VIDEO_ORIENTATION_90L:
-      for (y = 0; y < dh; y++) {
+      for (y = first_line; y < last_line; y++) {
         for (x = 0; x < dw; x += 2) {
           guint8 u;
           guint8 v;
@@ -1323,7 +1380,7 @@ gst_video_flip_y422 (GstVideoFlip * videoflip, GstVideoFrame * dest,
       }
       break;
     case GST_VIDEO_ORIENTATION_180:
-      for (y = 0; y < dh; y++) {
+      for (y = first_line; y < last_line; y++) {
         for (x = 0; x < dw; x += 2) {
           guint8 u;
           guint8 v;
@@ -1347,7 +1404,7 @@ gst_video_flip_y422 (GstVideoFlip * videoflip, GstVideoFrame * dest,
       }
       break;
     case GST_VIDEO_ORIENTATION_HORIZ:
-      for (y = 0; y < dh; y++) {
+      for (y = first_line; y < last_line; y++) {
         for (x = 0; x < dw; x += 2) {
           guint8 u;
           guint8 v;
@@ -1370,7 +1427,7 @@ gst_video_flip_y422 (GstVideoFlip * videoflip, GstVideoFrame * dest,
       }
       break;
     case GST_VIDEO_ORIENTATION_VERT:
-      for (y = 0; y < dh; y++) {
+      for (y = first_line; y < last_line; y++) {
         for (x = 0; x < dw; x += 2) {
           guint8 u;
           guint8 v;
@@ -1393,7 +1450,7 @@ gst_video_flip_y422 (GstVideoFlip * videoflip, GstVideoFrame * dest,
       }
       break;
     case GST_VIDEO_ORIENTATION_UL_LR:
-      for (y = 0; y < dh; y++) {
+      for (y = first_line; y < last_line; y++) {
         for (x = 0; x < dw; x += 2) {
           guint8 u;
           guint8 v;
@@ -1418,7 +1475,7 @@ gst_video_flip_y422 (GstVideoFlip * videoflip, GstVideoFrame * dest,
       }
       break;
     case GST_VIDEO_ORIENTATION_UR_LL:
-      for (y = 0; y < dh; y++) {
+      for (y = first_line; y < last_line; y++) {
         for (x = 0; x < dw; x += 2) {
           guint8 u;
           guint8 v;
@@ -1446,7 +1503,7 @@ gst_video_flip_y422 (GstVideoFlip * videoflip, GstVideoFrame * dest,
       }
       break;
     case GST_VIDEO_ORIENTATION_IDENTITY:
-      gst_video_frame_copy (dest, src);
+      gst_video_flip_copy_lines (dest, src, first_line, last_line);
       break;
     default:
       g_assert_not_reached ();
@@ -1644,7 +1701,11 @@ static void
 gst_video_flip_before_transform (GstBaseTransform * trans, GstBuffer * in)
 {
   GstVideoFlip *videoflip = GST_VIDEO_FLIP (trans);
+  GstVideoFilter *vfilter = GST_VIDEO_FILTER (trans);
   GstClockTime timestamp, stream_time;
+  GEnumClass *enum_class;
+  GstVideoOrientationMethod active, proposed;
+  GEnumValue *active_method_enum;
 
   timestamp = GST_BUFFER_TIMESTAMP (in);
   stream_time =
@@ -1655,20 +1716,14 @@ gst_video_flip_before_transform (GstBaseTransform * trans, GstBuffer * in)
 
   if (GST_CLOCK_TIME_IS_VALID (stream_time))
     gst_object_sync_values (GST_OBJECT (videoflip), stream_time);
-}
-
-static GstFlowReturn
-gst_video_flip_transform_frame (GstVideoFilter * vfilter,
-    GstVideoFrame * in_frame, GstVideoFrame * out_frame)
-{
-  GEnumClass *enum_class;
-  GstVideoOrientationMethod active, proposed;
-  GEnumValue *active_method_enum;
-  GstVideoFlip *videoflip = GST_VIDEO_FLIP (vfilter);
 
+  /* Switch to the new method here, once per frame, as the frame itself can
+   * be processed in bands of lines from several threads */
   GST_OBJECT_LOCK (videoflip);
-  if (G_UNLIKELY (videoflip->process == NULL))
-    goto not_negotiated;
+  if (G_UNLIKELY (videoflip->process == NULL)) {
+    GST_OBJECT_UNLOCK (videoflip);
+    return;
+  }
 
   if (videoflip->configuring_method != videoflip->active_method) {
     videoflip->active_method = videoflip->configuring_method;
@@ -1680,28 +1735,41 @@ gst_video_flip_transform_frame (GstVideoFilter * vfilter,
   GST_LOG_OBJECT (videoflip,
       "videoflip: flipping (%s), input %ux%u output %ux%u",
       active_method_enum ? active_method_enum->value_nick : "(nil)",
-      GST_VIDEO_FRAME_WIDTH (in_frame), GST_VIDEO_FRAME_HEIGHT (in_frame),
-      GST_VIDEO_FRAME_WIDTH (out_frame), GST_VIDEO_FRAME_HEIGHT (out_frame));
+      GST_VIDEO_INFO_WIDTH (&vfilter->in_info),
+      GST_VIDEO_INFO_HEIGHT (&vfilter->in_info),
+      GST_VIDEO_INFO_WIDTH (&vfilter->out_info),
+      GST_VIDEO_INFO_HEIGHT (&vfilter->out_info));
   g_type_class_unref (enum_class);
 
-  videoflip->process (videoflip, out_frame, in_frame);
-
   proposed = videoflip->proposed_method;
   active = videoflip->active_method;
   videoflip->change_configuring_method = TRUE;
   GST_OBJECT_UNLOCK (videoflip);
 
   if (proposed != active) {
-    gst_base_transform_set_passthrough (GST_BASE_TRANSFORM (videoflip),
+    gst_base_transform_set_passthrough (trans,
         proposed == GST_VIDEO_ORIENTATION_IDENTITY);
-    gst_base_transform_reconfigure_src (GST_BASE_TRANSFORM (videoflip));
+    gst_base_transform_reconfigure_src (trans);
   }
+}
+
+/* active_method and process are only changed from the streaming thread, in
+ * set_info() and before_transform(), so they can be used without the lock */
+static GstFlowReturn
+gst_video_flip_transform_frame_lines (GstVideoFilter * vfilter,
+    GstVideoFrame * in_frame, GstVideoFrame * out_frame, guint y, guint height)
+{
+  GstVideoFlip *videoflip = GST_VIDEO_FLIP (vfilter);
+
+  if (G_UNLIKELY (videoflip->process == NULL))
+    goto not_negotiated;
+
+  videoflip->process (videoflip, out_frame, in_frame, y, y + height);
 
   return GST_FLOW_OK;
 
 not_negotiated:
   {
-    GST_OBJECT_UNLOCK (videoflip);
     GST_ERROR_OBJECT (videoflip, "Not negotiated yet");
     return GST_FLOW_NOT_NEGOTIATED;
   }
@@ -1901,8 +1969,8 @@ gst_video_flip_class_init (GstVideoFlipClass * klass)
   trans_class->sink_event = GST_DEBUG_FUNCPTR (gst_video_flip_sink_event);
 
   vfilter_class->set_info = GST_DEBUG_FUNCPTR (gst_video_flip_set_info);
-  vfilter_class->transform_frame =
-      GST_DEBUG_FUNCPTR (gst_video_flip_transform_frame);
+  vfilter_class->transform_frame_lines =
+      GST_DEBUG_FUNCPTR (gst_video_flip_transform_frame_lines);
 
   gst_type_mark_as_plugin_api (GST_TYPE_VIDEO_FLIP_METHOD, 0);
 }
@@ -83,7 +83,8 @@ struct _GstVideoFlip {
   gboolean change_configuring_method;
   GstVideoOrientationMethod configuring_method;
   GstVideoOrientationMethod active_method;
-  void (*process) (GstVideoFlip *videoflip, GstVideoFrame *dest, const GstVideoFrame *src);
+  void (*process) (GstVideoFlip *videoflip, GstVideoFrame *dest,
+      const GstVideoFrame *src, gint first_line, gint last_line);
 };
 
 struct _GstVideoFlipClass {
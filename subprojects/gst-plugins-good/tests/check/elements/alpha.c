@@ -19,8 +19,11 @@
  */
 
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
 #include <gst/video/video.h>
 
+#include "videothreads.h"
+
 
 GstPad *srcpad, *sinkpad;
 
@@ -255,6 +258,29 @@ GST_START_TEST (test_alpha)
 
 GST_END_TEST;
 
+GST_START_TEST (test_max_threads)
+{
+  static const gchar *formats[] = { "I420", "AYUV", "ARGB", "xRGB" };
+  static const gchar *filters[] = {
+    "alpha method=set alpha=0.5",
+    "alpha method=green",
+    "alpha method=custom target-r=200 target-g=30 target-b=80 angle=30",
+  };
+  gint i, f;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    /* tall enough to be split into several bands */
+    gchar *caps = g_strdup_printf ("video/x-raw, format=%s, width=480, "
+        "height=1001, framerate=25/1", formats[i]);
+
+    for (f = 0; f < G_N_ELEMENTS (filters); f++)
+      video_threads_check_match (filters[f], caps);
+
+    g_free (caps);
+  }
+}
+
+GST_END_TEST;
 
 static Suite *
 alpha_suite (void)
@@ -265,6 +291,9 @@ alpha_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_alpha);
   tcase_add_test (tc_chain, test_chromakeying);
+  tcase_add_test (tc_chain, test_max_threads);
+
+  video_threads_force_n_cpus ();
 
   return s;
 }
@@ -23,8 +23,11 @@
 
 #include <stdio.h>
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
 #include <gst/video/video.h>
 
+#include "videothreads.h"
+
 static gboolean
 gst_caps_is_interlaced (GstCaps * caps)
 {
@@ -1016,7 +1019,95 @@ GST_START_TEST (test_fields_auto_expected_caps)
 
 GST_END_TEST;
 
+#define N_THREAD_TEST_FRAMES 4
+
+/* deinterlaces a few frames with @max_threads and returns all the output
+ * frames, including the ones flushed out of the history by EOS */
+static GList *
+deinterlace_with_threads (const gchar * method, guint max_threads,
+    const gchar * caps, gboolean tff)
+{
+  GstHarness *h;
+  GstBuffer *buf;
+  GList *out = NULL;
+  gchar *launch;
+  gint i;
+
+  launch = g_strdup_printf ("deinterlace mode=interlaced method=%s "
+      "max-threads=%u", method, max_threads);
+  h = gst_harness_new_parse (launch);
+  g_free (launch);
+  gst_harness_set_src_caps_str (h, caps);
+
+  for (i = 0; i < N_THREAD_TEST_FRAMES; i++) {
+    buf = video_threads_create_pattern_buffer (caps, i);
+    GST_BUFFER_PTS (buf) = i * GST_SECOND / 25;
+    GST_BUFFER_DURATION (buf) = GST_SECOND / 25;
+    if (tff)
+      GST_BUFFER_FLAG_SET (buf, GST_VIDEO_BUFFER_FLAG_TFF);
+    fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+  }
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
 
+  while ((buf = gst_harness_try_pull (h)))
+    out = g_list_append (out, buf);
+  gst_harness_teardown (h);
+
+  return out;
+}
+
+/* gst_video_parallel_runner_run() itself is tested in the video library
+ * tests */
+GST_START_TEST (test_max_threads)
+{
+  static const gchar *formats[] = { "I420", "YUY2" };
+  /* 1080 lines are split into bands of 270 lines, 1084 into bands of 271
+   * luma and 181 chroma lines, so that the bands start at lines of either
+   * field */
+  static const gint heights[] = { 1080, 1084 };
+  static const gchar *methods[] = {
+    "linear", "linearblend", "scalerbob", "vfir", "greedyl", "yadif",
+    "weave", "weavetff", "weavebff"
+  };
+  gint i, j, m, tff;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    for (j = 0; j < G_N_ELEMENTS (heights); j++) {
+      gchar *caps = g_strdup_printf ("video/x-raw, format=%s, width=480, "
+          "height=%d, framerate=25/1, interlace-mode=interleaved",
+          formats[i], heights[j]);
+
+      fail_unless (gst_video_parallel_get_n_threads (VIDEO_THREADS_N_CPUS,
+              heights[j]) > 1);
+
+      for (m = 0; m < G_N_ELEMENTS (methods); m++) {
+        for (tff = 0; tff < 2; tff++) {
+          GList *single, *threaded, *s, *t;
+
+          GST_DEBUG ("Testing %s with %s caps: %s", methods[m],
+              tff ? "TFF" : "BFF", caps);
+
+          single = deinterlace_with_threads (methods[m], 1, caps, tff);
+          threaded = deinterlace_with_threads (methods[m],
+              VIDEO_THREADS_N_CPUS, caps, tff);
+
+          fail_unless (single != NULL);
+          fail_unless_equals_int (g_list_length (threaded),
+              g_list_length (single));
+          for (s = single, t = threaded; s; s = s->next, t = t->next)
+            video_threads_check_buffers_equal (t->data, s->data);
+
+          g_list_free_full (single, (GDestroyNotify) gst_buffer_unref);
+          g_list_free_full (threaded, (GDestroyNotify) gst_buffer_unref);
+        }
+      }
+
+      g_free (caps);
+    }
+  }
+}
+
+GST_END_TEST;
 
 static Suite *
 deinterlace_suite (void)
@@ -1045,6 +1136,9 @@ deinterlace_suite (void)
   tcase_add_test (tc_chain, test_mode_auto_expected_caps);
   tcase_add_test (tc_chain, test_mode_auto_strict_expected_caps);
   tcase_add_test (tc_chain, test_fields_auto_expected_caps);
+  tcase_add_test (tc_chain, test_max_threads);
+
+  video_threads_force_n_cpus ();
 
   return s;
 }
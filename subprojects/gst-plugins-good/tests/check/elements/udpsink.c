@@ -22,6 +22,11 @@
 #include <gio/gio.h>
 #include <stdlib.h>
 
+#ifndef G_OS_WIN32
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#endif
+
 static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_SRC,
     GST_PAD_ALWAYS,
@@ -244,6 +249,116 @@ GST_START_TEST (test_udpsink_dscp)
 
 GST_END_TEST;
 
+#ifdef UDP_SEGMENT
+/* same check as multiudpsink does when starting */
+static gboolean
+socket_supports_gso (GSocket * socket)
+{
+  gint value;
+
+  return g_socket_get_option (socket, IPPROTO_UDP, UDP_SEGMENT, &value, NULL);
+}
+#endif
+
+GST_START_TEST (test_multiudpsink_gso)
+{
+  GstSegment segment;
+  GstElement *sink;
+  GstPad *srcpad;
+  GstBufferList *list;
+  GstStructure *stats = NULL;
+  GInetAddress *ia;
+  GSocketAddress *sa;
+  GSocket *socket;
+  GError *err = NULL;
+  guint64 packets_sent, send_calls;
+  gboolean gso_supported = FALSE;
+  gchar data[1500];
+  guint16 port;
+  guint i;
+
+  socket = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_DATAGRAM,
+      G_SOCKET_PROTOCOL_UDP, &err);
+  fail_unless (socket != NULL && err == NULL);
+
+  ia = g_inet_address_new_loopback (G_SOCKET_FAMILY_IPV4);
+  sa = g_inet_socket_address_new (ia, 0);
+  fail_unless (g_socket_bind (socket, sa, TRUE, NULL));
+  g_object_unref (sa);
+  g_object_unref (ia);
+
+  sa = g_socket_get_local_address (socket, NULL);
+  port = g_inet_socket_address_get_port (G_INET_SOCKET_ADDRESS (sa));
+  g_object_unref (sa);
+
+#ifdef UDP_SEGMENT
+  gso_supported = socket_supports_gso (socket);
+#endif
+  if (!gso_supported) {
+    GST_INFO ("UDP_SEGMENT not supported, skipping test");
+    g_object_unref (socket);
+    return;
+  }
+
+  sink = gst_check_setup_element ("multiudpsink");
+  g_object_set (sink, "gso", TRUE, NULL);
+  g_signal_emit_by_name (sink, "add", "127.0.0.1", port, NULL);
+
+  srcpad = gst_check_setup_src_pad_by_name (sink, &srctemplate, "sink");
+
+  gst_element_set_state (sink, GST_STATE_PLAYING);
+  gst_pad_set_active (srcpad, TRUE);
+
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("gso"));
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (srcpad, gst_event_new_segment (&segment));
+
+  /* 8 equally sized packets followed by a shorter one, each made up of an
+   * RTP header and a payload memory */
+  list = gst_buffer_list_new ();
+  for (i = 0; i < 9; i++) {
+    GstBuffer *buf;
+
+    buf = gst_buffer_new_allocate (NULL, RTP_HEADER_SIZE, NULL);
+    gst_buffer_memset (buf, 0, i, RTP_HEADER_SIZE);
+    buf = gst_buffer_append (buf, gst_buffer_new_allocate (NULL,
+            i < 8 ? RTP_PAYLOAD_SIZE : RTP_PAYLOAD_SIZE / 2, NULL));
+    gst_buffer_memset (buf, RTP_HEADER_SIZE, i, gst_buffer_get_size (buf) -
+        RTP_HEADER_SIZE);
+    gst_buffer_list_add (list, buf);
+  }
+
+  fail_unless_equals_int (gst_pad_push_list (srcpad, list), GST_FLOW_OK);
+
+  /* whether coalesced or not, the receiver sees the original packets */
+  for (i = 0; i < 9; i++) {
+    gssize len = g_socket_receive (socket, data, sizeof (data), NULL, &err);
+
+    fail_unless (err == NULL);
+    fail_unless_equals_int (len, RTP_HEADER_SIZE +
+        (i < 8 ? RTP_PAYLOAD_SIZE : RTP_PAYLOAD_SIZE / 2));
+    fail_unless_equals_int (data[0], i);
+    fail_unless_equals_int (data[len - 1], i);
+  }
+
+  g_signal_emit_by_name (sink, "get-stats", "127.0.0.1", port, &stats);
+  fail_unless (stats != NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "packets-sent",
+          &packets_sent));
+  fail_unless (gst_structure_get_uint64 (stats, "send-calls", &send_calls));
+  fail_unless_equals_uint64 (packets_sent, 9);
+  /* the packets must have been coalesced into fewer sends */
+  fail_unless (send_calls >= 1 && send_calls < 9);
+  gst_structure_free (stats);
+
+  gst_check_teardown_pad_by_name (sink, "sink");
+  gst_check_teardown_element (sink);
+
+  g_object_unref (socket);
+}
+
+GST_END_TEST;
+
 static Suite *
 udpsink_suite (void)
 {
@@ -256,6 +371,7 @@ udpsink_suite (void)
   tcase_add_test (tc_chain, test_udpsink_bufferlist);
   tcase_add_test (tc_chain, test_udpsink_client_add_remove);
   tcase_add_test (tc_chain, test_udpsink_dscp);
+  tcase_add_test (tc_chain, test_multiudpsink_gso);
 
   return s;
 }
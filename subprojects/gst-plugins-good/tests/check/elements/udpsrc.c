@@ -19,6 +19,7 @@
 #include <gst/check/gstcheck.h>
 #include <gio/gio.h>
 #include <stdlib.h>
+#include <string.h>
 
 static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
@@ -27,7 +28,7 @@ static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
 
 static gboolean
 udpsrc_setup (GstElement ** udpsrc, GSocket ** socket,
-    GstPad ** sinkpad, GSocketAddress ** sa)
+    GstPad ** sinkpad, GSocketAddress ** sa, guint max_batch_size)
 {
   GInetAddress *ia;
   int port = 0;
@@ -35,7 +36,7 @@ udpsrc_setup (GstElement ** udpsrc, GSocket ** socket,
 
   *udpsrc = gst_check_setup_element ("udpsrc");
   fail_unless (*udpsrc != NULL);
-  g_object_set (*udpsrc, "port", 0, NULL);
+  g_object_set (*udpsrc, "port", 0, "max-batch-size", max_batch_size, NULL);
 
   *sinkpad = gst_check_setup_sink_pad_by_name (*udpsrc, &sinktemplate, "src");
   fail_unless (*sinkpad != NULL);
@@ -70,7 +71,7 @@ GST_START_TEST (test_udpsrc_empty_packet)
   GSocket *socket = NULL;
   GstPad *sinkpad = NULL;
 
-  if (!udpsrc_setup (&udpsrc, &socket, &sinkpad, &sa))
+  if (!udpsrc_setup (&udpsrc, &socket, &sinkpad, &sa, 1))
     goto no_socket;
 
   if (g_socket_send_to (socket, sa, "HeLL0", 0, NULL, NULL) == 0) {
@@ -152,7 +153,7 @@ GST_START_TEST (test_udpsrc)
   for (i = 0; i < G_N_ELEMENTS (data); ++i)
     data[i] = i & 0xff;
 
-  if (!udpsrc_setup (&udpsrc, &socket, &sinkpad, &sa))
+  if (!udpsrc_setup (&udpsrc, &socket, &sinkpad, &sa, 1))
     goto no_socket;
 
   if ((sent = g_socket_send_to (socket, sa, data, 48000, NULL, &err)) == -1)
@@ -247,6 +248,78 @@ send_failure:
 
 GST_END_TEST;
 
+GST_START_TEST (test_udpsrc_batch)
+{
+  GSocketAddress *sa = NULL;
+  GstElement *udpsrc = NULL;
+  GSocket *socket = NULL;
+  GstPad *sinkpad = NULL;
+  GstBuffer *buf;
+  GstMapInfo map;
+  GstClock *clock;
+  guint8 data[1400];
+  int i, len = 0;
+  gssize sent;
+  GError *err = NULL;
+
+  if (!udpsrc_setup (&udpsrc, &socket, &sinkpad, &sa, 16))
+    goto no_socket;
+
+  /* the packets are timestamped with the running time of the clock */
+  clock = gst_system_clock_obtain ();
+  gst_element_set_base_time (udpsrc, gst_clock_get_time (clock));
+  gst_element_set_clock (udpsrc, clock);
+  gst_object_unref (clock);
+
+  /* packet i is 100 * (i + 1) bytes, all filled with i */
+  for (i = 0; i < 10; i++) {
+    memset (data, i, sizeof (data));
+    if ((sent = g_socket_send_to (socket, sa, (gchar *) data, 100 * (i + 1),
+                NULL, &err)) == -1)
+      goto send_failure;
+    fail_unless_equals_int (sent, 100 * (i + 1));
+  }
+
+  g_mutex_lock (&check_mutex);
+  len = g_list_length (buffers);
+  while (len < 10) {
+    g_cond_wait (&check_cond, &check_mutex);
+    len = g_list_length (buffers);
+    GST_INFO ("%u buffers", len);
+  }
+  fail_unless_equals_int (len, 10);
+
+  for (i = 0; i < 10; i++) {
+    buf = GST_BUFFER (g_list_nth_data (buffers, i));
+    fail_unless_equals_int (gst_buffer_get_size (buf), 100 * (i + 1));
+    fail_unless (GST_BUFFER_DTS_IS_VALID (buf));
+
+    gst_buffer_map (buf, &map, GST_MAP_READ);
+    fail_unless_equals_int (map.data[0], i);
+    fail_unless_equals_int (map.data[map.size - 1], i);
+    gst_buffer_unmap (buf, &map);
+  }
+  g_mutex_unlock (&check_mutex);
+
+no_socket:
+send_failure:
+  if (err) {
+    GST_WARNING ("Socket send error, skipping test: %s", err->message);
+    g_clear_error (&err);
+  }
+
+  gst_element_set_state (udpsrc, GST_STATE_NULL);
+
+  gst_check_drop_buffers ();
+  gst_check_teardown_pad_by_name (udpsrc, "src");
+  gst_check_teardown_element (udpsrc);
+
+  g_object_unref (socket);
+  g_object_unref (sa);
+}
+
+GST_END_TEST;
+
 static Suite *
 udpsrc_suite (void)
 {
@@ -256,6 +329,7 @@ udpsrc_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_udpsrc_empty_packet);
   tcase_add_test (tc_chain, test_udpsrc);
+  tcase_add_test (tc_chain, test_udpsrc_batch);
   return s;
 }
 
@@ -24,6 +24,10 @@
 #endif
 
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
+#include <gst/video/video.h>
+
+#include "videothreads.h"
 
 typedef struct _GstVideoBoxTestContext
 {
@@ -206,6 +210,33 @@ GST_START_TEST (test_caps_transform)
 
 GST_END_TEST;
 
+GST_START_TEST (test_max_threads)
+{
+  static const gchar *formats[] = { "I420", "AYUV", "xRGB", "YUY2" };
+  static const gchar *filters[] = {
+    "videobox top=-20 bottom=30 left=10 right=-12 fill=red",
+    "videobox top=100 bottom=-50 left=-8 right=0 fill=white",
+    "videobox alpha=0.7 border-alpha=0.5 top=-31 bottom=-7",
+    /* odd top borders and crops make the bands after the first one start
+     * at odd input lines, in the middle of a subsampled chroma line */
+    "videobox top=37 bottom=-9 left=3 right=5 fill=green",
+    "videobox top=-21 bottom=13 fill=blue",
+  };
+  gint i, f;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    /* tall enough to be split into several bands */
+    gchar *caps = g_strdup_printf ("video/x-raw, format=%s, width=480, "
+        "height=1001, framerate=25/1", formats[i]);
+
+    for (f = 0; f < G_N_ELEMENTS (filters); f++)
+      video_threads_check_match (filters[f], caps);
+
+    g_free (caps);
+  }
+}
+
+GST_END_TEST;
 
 static Suite *
 videobox_suite (void)
@@ -215,6 +246,9 @@ videobox_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_caps_transform);
+  tcase_add_test (tc_chain, test_max_threads);
+
+  video_threads_force_n_cpus ();
 
   return s;
 }
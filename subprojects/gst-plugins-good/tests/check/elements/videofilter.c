@@ -24,6 +24,9 @@
 
 #include <gst/video/video.h>
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
+
+#include "videothreads.h"
 
 gboolean have_eos = FALSE;
 
@@ -248,6 +251,210 @@ GST_START_TEST (test_gamma)
 GST_END_TEST;
 
 
+static GstPadProbeReturn
+count_fused_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  gint *n_fused = user_data;
+  GstCustomMeta *meta;
+
+  meta = gst_buffer_get_custom_meta (GST_PAD_PROBE_INFO_BUFFER (info),
+      "GstVideoFilterFusedMeta");
+  *n_fused = meta ?
+      gst_structure_n_fields (gst_custom_meta_get_structure (meta)) : 0;
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* If @n_fused is not %NULL, it is set to the number of following filters
+ * that the element named "first" marked as already done */
+static GstBuffer *
+run_harness (GstHarness * h, const gchar * caps, GstBuffer * inbuf,
+    gint * n_fused)
+{
+  GstBuffer *outbuf;
+
+  if (n_fused) {
+    GstElement *first;
+    GstPad *pad;
+
+    first = gst_bin_get_by_name (GST_BIN (h->element), "first");
+    fail_unless (first != NULL);
+    pad = gst_element_get_static_pad (first, "src");
+    *n_fused = -1;
+    gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, count_fused_probe,
+        n_fused, NULL);
+    gst_object_unref (pad);
+    gst_object_unref (first);
+  }
+  gst_harness_set_src_caps_str (h, caps);
+  outbuf = gst_harness_push_and_pull (h, gst_buffer_copy_deep (inbuf));
+  fail_unless (outbuf != NULL);
+  gst_harness_teardown (h);
+
+  return outbuf;
+}
+
+static GstBuffer *
+run_chain (const gchar * launch, const gchar * caps, GstBuffer * inbuf,
+    gint * n_fused)
+{
+  return run_harness (gst_harness_new_parse (launch), caps, inbuf, n_fused);
+}
+
+GST_START_TEST (test_fused)
+{
+  static const gchar *formats[] = { "I420", "NV12", "YUY2", "AYUV", "xRGB" };
+  static const struct
+  {
+    const int width, height;
+  } resolutions[] = { {
+  385, 289}, {
+  320, 1001}};
+  gint i, r;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    for (r = 0; r < G_N_ELEMENTS (resolutions); r++) {
+      GstBuffer *inbuf, *fused, *separate;
+      gint n_fused, n_separate;
+      gchar *caps;
+
+      caps = g_strdup_printf ("video/x-raw, format=%s, width=%d, height=%d, "
+          "framerate=25/1", formats[i], resolutions[r].width,
+          resolutions[r].height);
+      GST_DEBUG ("Testing with caps: %s", caps);
+
+      inbuf = video_threads_create_pattern_buffer (caps, 0);
+
+      /* identity keeps the filters from being fused */
+      fused = run_chain ("gamma name=first gamma=0.6 fuse=true ! videobalance "
+          "saturation=0.5 hue=0.3 contrast=1.2 fuse=true ! gamma gamma=1.4 "
+          "fuse=true", caps, inbuf, &n_fused);
+      separate = run_chain ("gamma name=first gamma=0.6 fuse=true ! identity ! "
+          "videobalance saturation=0.5 hue=0.3 contrast=1.2 fuse=true ! "
+          "identity ! gamma gamma=1.4 fuse=true", caps, inbuf, &n_separate);
+
+      /* the first filter ran the two others */
+      fail_unless_equals_int (n_fused, 2);
+      fail_unless_equals_int (n_separate, 0);
+
+      video_threads_check_buffers_equal (fused, separate);
+      fail_if (gst_buffer_get_custom_meta (fused, "GstVideoFilterFusedMeta"));
+
+      gst_buffer_unref (fused);
+      gst_buffer_unref (separate);
+      gst_buffer_unref (inbuf);
+      g_free (caps);
+    }
+  }
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_fused_disabled)
+{
+  const gchar *caps = "video/x-raw, format=I420, width=320, height=240, "
+      "framerate=25/1";
+  GstBuffer *inbuf, *outbuf;
+  gint n_fused;
+
+  inbuf = video_threads_create_pattern_buffer (caps, 0);
+
+  /* not by default */
+  outbuf = run_chain ("gamma name=first gamma=0.6 ! videobalance "
+      "saturation=0.5", caps, inbuf, &n_fused);
+  fail_unless_equals_int (n_fused, 0);
+  gst_buffer_unref (outbuf);
+
+  /* only with the filters that enabled it */
+  outbuf = run_chain ("gamma name=first gamma=0.6 fuse=true ! videobalance "
+      "saturation=0.5 fuse=true ! gamma gamma=1.4 ! videobalance hue=0.3 "
+      "fuse=true", caps, inbuf, &n_fused);
+  fail_unless_equals_int (n_fused, 1);
+  gst_buffer_unref (outbuf);
+
+  /* not with passthrough filters, which don't pass the mark on either */
+  outbuf = run_chain ("gamma name=first gamma=0.6 fuse=true ! videobalance "
+      "fuse=true ! gamma gamma=1.4 fuse=true", caps, inbuf, &n_fused);
+  fail_unless_equals_int (n_fused, 0);
+  fail_if (gst_buffer_get_custom_meta (outbuf, "GstVideoFilterFusedMeta"));
+  gst_buffer_unref (outbuf);
+
+  gst_buffer_unref (inbuf);
+}
+
+GST_END_TEST;
+
+/* the filters are fused into and out of bins */
+GST_START_TEST (test_fused_bins)
+{
+  const gchar *caps = "video/x-raw, format=I420, width=320, height=240, "
+      "framerate=25/1";
+  GstElement *bin, *first, *second;
+  GstBuffer *inbuf, *fused, *separate;
+  GstPad *pad;
+  gint n_fused;
+
+  inbuf = video_threads_create_pattern_buffer (caps, 0);
+
+  bin = gst_object_ref_sink (gst_bin_new (NULL));
+  first = gst_parse_bin_from_description ("gamma name=first gamma=0.6 "
+      "fuse=true", TRUE, NULL);
+  second = gst_parse_bin_from_description ("videobalance saturation=0.5 "
+      "fuse=true ! gamma gamma=1.4 fuse=true", TRUE, NULL);
+  fail_unless (first != NULL && second != NULL);
+  gst_bin_add_many (GST_BIN (bin), first, second, NULL);
+  fail_unless (gst_element_link (first, second));
+  pad = gst_element_get_static_pad (first, "sink");
+  gst_element_add_pad (bin, gst_ghost_pad_new ("sink", pad));
+  gst_object_unref (pad);
+  pad = gst_element_get_static_pad (second, "src");
+  gst_element_add_pad (bin, gst_ghost_pad_new ("src", pad));
+  gst_object_unref (pad);
+
+  fused = run_harness (gst_harness_new_with_element (bin, "sink", "src"),
+      caps, inbuf, &n_fused);
+  gst_object_unref (bin);
+  separate = run_chain ("gamma gamma=0.6 ! identity ! videobalance "
+      "saturation=0.5 ! identity ! gamma gamma=1.4", caps, inbuf, NULL);
+
+  fail_unless_equals_int (n_fused, 2);
+  video_threads_check_buffers_equal (fused, separate);
+  fail_if (gst_buffer_get_custom_meta (fused, "GstVideoFilterFusedMeta"));
+
+  gst_buffer_unref (fused);
+  gst_buffer_unref (separate);
+  gst_buffer_unref (inbuf);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_max_threads)
+{
+  static const gchar *formats[] = { "I420", "NV12", "YUY2", "AYUV", "xRGB" };
+  static const gchar *filters[] = {
+    "videobalance saturation=0.5 hue=0.3 contrast=1.2",
+    "gamma gamma=0.6",
+    "videoflip method=horizontal-flip",
+    "videoflip method=vertical-flip",
+    "videoflip method=clockwise",
+    "videoflip method=upper-left-diagonal",
+  };
+  gint i, f;
+
+  for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+    /* tall enough to be split into several bands */
+    gchar *caps = g_strdup_printf ("video/x-raw, format=%s, width=480, "
+        "height=1001, framerate=25/1", formats[i]);
+
+    for (f = 0; f < G_N_ELEMENTS (filters); f++)
+      video_threads_check_match (filters[f], caps);
+
+    g_free (caps);
+  }
+}
+
+GST_END_TEST;
+
 static Suite *
 videofilter_suite (void)
 {
@@ -258,6 +465,12 @@ videofilter_suite (void)
   tcase_add_test (tc_chain, test_videobalance);
   tcase_add_test (tc_chain, test_videoflip);
   tcase_add_test (tc_chain, test_gamma);
+  tcase_add_test (tc_chain, test_fused);
+  tcase_add_test (tc_chain, test_fused_disabled);
+  tcase_add_test (tc_chain, test_fused_bins);
+  tcase_add_test (tc_chain, test_max_threads);
+
+  video_threads_force_n_cpus ();
 
   return s;
 }
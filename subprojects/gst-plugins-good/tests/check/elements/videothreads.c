@@ -0,0 +1,112 @@
+/* GStreamer
+ *
+ * helpers for testing video elements that split frames between threads
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gst/check/gstharness.h>
+#include <gst/video/video.h>
+
+#include "videothreads.h"
+
+void
+video_threads_force_n_cpus (void)
+{
+  gchar *n_cpus = g_strdup_printf ("%u", VIDEO_THREADS_N_CPUS);
+
+  /* read by gst_video_parallel_get_n_threads() */
+  g_setenv ("GST_VIDEO_PARALLEL_N_CPUS", n_cpus, TRUE);
+  g_free (n_cpus);
+}
+
+GstBuffer *
+video_threads_create_pattern_buffer (const gchar * caps, guint n)
+{
+  GstBuffer *buf;
+  GstMapInfo map;
+  GstVideoInfo info;
+  GstCaps *vcaps;
+  gsize j;
+
+  vcaps = gst_caps_from_string (caps);
+  fail_unless (gst_video_info_from_caps (&info, vcaps));
+  gst_caps_unref (vcaps);
+  buf = gst_buffer_new_and_alloc (GST_VIDEO_INFO_SIZE (&info));
+  gst_buffer_map (buf, &map, GST_MAP_WRITE);
+  for (j = 0; j < map.size; j++)
+    map.data[j] = (j * 7 + j / 13 + n * 29) & 0xff;
+  gst_buffer_unmap (buf, &map);
+  GST_BUFFER_PTS (buf) = 0;
+
+  return buf;
+}
+
+void
+video_threads_check_buffers_equal (GstBuffer * a, GstBuffer * b)
+{
+  GstMapInfo map;
+
+  fail_unless_equals_int (gst_buffer_get_size (a), gst_buffer_get_size (b));
+  gst_buffer_map (b, &map, GST_MAP_READ);
+  fail_unless (gst_buffer_memcmp (a, 0, map.data, map.size) == 0);
+  gst_buffer_unmap (b, &map);
+}
+
+static GstBuffer *
+run_with_threads (const gchar * launch, guint max_threads, const gchar * caps,
+    GstBuffer * inbuf)
+{
+  GstHarness *h;
+  GstBuffer *outbuf;
+  gchar *desc;
+
+  desc = g_strdup_printf ("%s max-threads=%u", launch, max_threads);
+  h = gst_harness_new_parse (desc);
+  g_free (desc);
+  gst_harness_set_src_caps_str (h, caps);
+  outbuf = gst_harness_push_and_pull (h, gst_buffer_copy_deep (inbuf));
+  fail_unless (outbuf != NULL);
+  gst_harness_teardown (h);
+
+  return outbuf;
+}
+
+void
+video_threads_check_match (const gchar * launch, const gchar * caps)
+{
+  GstBuffer *inbuf, *single, *threaded;
+  GstVideoInfo info;
+  GstCaps *vcaps;
+
+  GST_DEBUG ("Testing %s with caps: %s", launch, caps);
+
+  vcaps = gst_caps_from_string (caps);
+  fail_unless (gst_video_info_from_caps (&info, vcaps));
+  gst_caps_unref (vcaps);
+  fail_unless (gst_video_parallel_get_n_threads (VIDEO_THREADS_N_CPUS,
+          GST_VIDEO_INFO_HEIGHT (&info)) > 1);
+
+  inbuf = video_threads_create_pattern_buffer (caps, 0);
+  single = run_with_threads (launch, 1, caps, inbuf);
+  threaded = run_with_threads (launch, VIDEO_THREADS_N_CPUS, caps, inbuf);
+
+  video_threads_check_buffers_equal (threaded, single);
+
+  gst_buffer_unref (single);
+  gst_buffer_unref (threaded);
+  gst_buffer_unref (inbuf);
+}
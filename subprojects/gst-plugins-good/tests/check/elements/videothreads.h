@@ -0,0 +1,43 @@
+/* GStreamer
+ *
+ * helpers for testing video elements that split frames between threads
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+
+/* The number of CPUs the video library is made to assume, and so the
+ * number of bands frames are split into with max-threads set to it */
+#define VIDEO_THREADS_N_CPUS 4
+
+/* Makes frames be split into bands the same way whatever the number of CPUs
+ * of the machine running the tests. Must be called before any frame is
+ * processed, e.g. from the suite function. */
+void        video_threads_force_n_cpus          (void);
+
+/* Returns a frame of @caps filled with a pattern that varies with @n */
+GstBuffer * video_threads_create_pattern_buffer (const gchar * caps,
+                                                 guint n);
+
+void        video_threads_check_buffers_equal   (GstBuffer * a,
+                                                 GstBuffer * b);
+
+/* Checks that the pipeline @launch creates the same output from a pattern
+ * frame of @caps with max-threads set to 1 and to VIDEO_THREADS_N_CPUS, and
+ * that the frame is actually split in the latter case */
+void        video_threads_check_match           (const gchar * launch,
+                                                 const gchar * caps);
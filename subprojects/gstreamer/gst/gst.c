@@ -659,6 +659,7 @@ init_post (GOptionContext * context, GOptionGroup * group, gpointer data,
     return TRUE;
   }
 
+  _priv_gst_slab_initialize ();
   _priv_gst_mini_object_initialize ();
   _priv_gst_quarks_initialize ();
   _priv_gst_allocator_initialize ();
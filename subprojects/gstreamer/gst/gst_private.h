@@ -113,6 +113,7 @@ G_GNUC_INTERNAL  gboolean _priv_plugin_deps_env_vars_changed (GstPlugin * plugin
 G_GNUC_INTERNAL  gboolean _priv_plugin_deps_files_changed (GstPlugin * plugin);
 
 /* init functions called from gst_init(). */
+G_GNUC_INTERNAL  void  _priv_gst_slab_initialize (void);
 G_GNUC_INTERNAL  void  _priv_gst_quarks_initialize (void);
 G_GNUC_INTERNAL  void  _priv_gst_mini_object_initialize (void);
 G_GNUC_INTERNAL  void  _priv_gst_memory_initialize (void);
@@ -156,6 +157,29 @@ G_GNUC_INTERNAL  void _priv_gst_registry_cleanup (void);
 GST_API
 gboolean _gst_plugin_loader_client_run (void);
 
+/* Per-thread caches for buffers and small system memory, see gstslab.c */
+G_GNUC_INTERNAL
+gpointer _priv_gst_slab_alloc (gsize size);
+
+G_GNUC_INTERNAL
+void     _priv_gst_slab_free  (gsize size, gpointer mem);
+
+typedef struct {
+  /* allocations served from a thread cache */
+  guint64 cached_allocs;
+  /* allocations that had to go to g_slice */
+  guint64 system_allocs;
+  /* magazines a thread took from the depot */
+  guint64 refills;
+  /* magazines a thread gave to the depot, because it freed more blocks
+   * than it allocated */
+  guint64 flushes;
+} GstSlabStats;
+
+/* used by the stats tracer */
+GST_API
+gboolean _gst_slab_get_stats (GstSlabStats * stats);
+
 G_GNUC_INTERNAL  GstPlugin * _priv_gst_plugin_load_file_for_registry (const gchar *filename,
                                                                       GstRegistry * registry,
                                                                       GError** error);
@@ -169,6 +193,12 @@ G_GNUC_INTERNAL gboolean _priv_gst_value_parse_simple_string (gchar * str, gchar
 G_GNUC_INTERNAL gboolean _priv_gst_value_parse_value (gchar * str, gchar ** after, GValue * value, GType default_type, GParamSpec *pspec);
 G_GNUC_INTERNAL gchar * _priv_gst_value_serialize_any_list (const GValue * value, const gchar * begin, const gchar * end, gboolean print_type, GstSerializeFlags flags);
 
+/* Used in GstTask to let tasks on a work-stealing pool give up their worker */
+G_GNUC_INTERNAL  gboolean _priv_gst_work_stealing_task_pool_should_yield (GstTaskPool *pool);
+
+/* Used in GstElement to check the interest mask of the toplevel bus */
+G_GNUC_INTERNAL  gboolean _priv_gst_bus_wants_message_type (GstBus *bus, GstMessageType type);
+
 /* Used in GstBin for manual state handling */
 G_GNUC_INTERNAL  void _priv_gst_element_state_changed (GstElement *element,
                       GstState oldstate, GstState newstate, GstState pending);
@@ -189,6 +219,15 @@ gboolean priv__gst_structure_append_template_to_gstring (GQuark field_id,
 G_GNUC_INTERNAL
 void priv_gst_caps_features_append_to_gstring (const GstCapsFeatures * features, GString *s);
 
+/* used in gststructure.c, gstcapsfeatures.c and gstcaps.c to keep the serial
+ * of caps up to date when their structures or features are modified */
+G_GNUC_INTERNAL
+void _priv_gst_caps_serial_changed (gsize * serial);
+G_GNUC_INTERNAL
+void _priv_gst_structure_set_parent_serial (GstStructure * structure, gsize * serial);
+G_GNUC_INTERNAL
+void _priv_gst_caps_features_set_parent_serial (GstCapsFeatures * features, gsize * serial);
+
 G_GNUC_INTERNAL
 gboolean priv_gst_structure_parse_name (gchar * str, gchar **start, gchar ** end, gchar ** next, gboolean check_valid);
 G_GNUC_INTERNAL
@@ -419,6 +458,12 @@ struct _GstTypeFindFactory {
   gpointer                      user_data;
   GDestroyNotify                user_data_notify;
 
+  /* caps string in the registry cache, parsed on first use */
+  const gchar *                 caps_str;
+  GBytes *                      cache;
+  /* caps_str could not be parsed, don't try again */
+  gint                          caps_invalid;
+
   gpointer _gst_reserved[GST_PADDING];
 };
 
@@ -466,6 +511,12 @@ struct _GstElementFactory {
 
   GList *               interfaces;             /* interface type names this element implements */
 
+  /* metadata string in the registry cache, parsed on first use */
+  const gchar *         metadata_str;
+  GBytes *              cache;
+  /* metadata_str could not be parsed, don't try again */
+  gint                  metadata_invalid;
+
   /*< private >*/
   gpointer _gst_reserved[GST_PADDING];
 };
@@ -485,6 +536,12 @@ struct _GstDeviceProviderFactory {
   GstDeviceProvider         *provider;
   gpointer                   metadata;
 
+  /* metadata string in the registry cache, parsed on first use */
+  const gchar               *metadata_str;
+  GBytes                    *cache;
+  /* metadata_str could not be parsed, don't try again */
+  gint                       metadata_invalid;
+
   gpointer _gst_reserved[GST_PADDING];
 };
 
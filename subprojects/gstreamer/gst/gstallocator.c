@@ -411,7 +411,7 @@ _sysmem_new (GstMemoryFlags flags,
 
   slice_size = sizeof (GstMemorySystem);
 
-  mem = g_slice_alloc (slice_size);
+  mem = _priv_gst_slab_alloc (slice_size);
   _sysmem_init (mem, flags, parent, slice_size,
       data, maxsize, align, offset, size, user_data, notify);
 
@@ -434,7 +434,7 @@ _sysmem_new_block (GstMemoryFlags flags,
   /* alloc header and data in one block */
   slice_size = sizeof (GstMemorySystem) + maxsize;
 
-  mem = g_slice_alloc (slice_size);
+  mem = _priv_gst_slab_alloc (slice_size);
   if (mem == NULL)
     return NULL;
 
@@ -553,7 +553,7 @@ default_free (GstAllocator * allocator, GstMemory * mem)
   memset (mem, 0xff, sizeof (GstMemorySystem));
 #endif
 
-  g_slice_free1 (slice_size, mem);
+  _priv_gst_slab_free (slice_size, mem);
 }
 
 static void
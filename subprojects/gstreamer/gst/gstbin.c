@@ -141,6 +141,7 @@
 
 #include "gstutils.h"
 #include "gstchildproxy.h"
+#include "gsttaskpool.h"
 
 GST_DEBUG_CATEGORY_STATIC (bin_debug);
 #define GST_CAT_DEFAULT bin_debug
@@ -172,6 +173,11 @@ struct _GstBinPrivate
   gboolean posted_eos;
   gboolean posted_playing;
   GstElementFlags suppressed_flags;
+
+  /* threads used to change the state of independent children, created on
+   * the first state change when state_change_threads > 0 */
+  guint state_change_threads;
+  GstTaskPool *state_change_pool;
 };
 
 typedef struct
@@ -246,12 +252,14 @@ enum
 
 #define DEFAULT_ASYNC_HANDLING	FALSE
 #define DEFAULT_MESSAGE_FORWARD	FALSE
+#define DEFAULT_STATE_CHANGE_THREADS	0
 
 enum
 {
   PROP_0,
   PROP_ASYNC_HANDLING,
   PROP_MESSAGE_FORWARD,
+  PROP_STATE_CHANGE_THREADS,
   PROP_LAST
 };
 
@@ -445,6 +453,27 @@ gst_bin_class_init (GstBinClass * klass)
           "Forwards all children messages",
           DEFAULT_MESSAGE_FORWARD, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstBin:state-change-threads:
+   *
+   * The maximum number of threads used to change the state of the children
+   * at the same time. 0 changes the state of one child after the other.
+   *
+   * Children are still handled from the sinks to the sources. Only the
+   * children that don't provide data to any child that did not change state
+   * yet are handled at the same time, and the next children are only handled
+   * once all of them are done. This helps pipelines with many independent
+   * branches whose elements take a long time to open devices or files.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_STATE_CHANGE_THREADS,
+      g_param_spec_uint ("state-change-threads", "State Change Threads",
+          "Maximum number of threads changing the state of independent "
+          "children at the same time (0 = one child after the other)",
+          0, G_MAXINT, DEFAULT_STATE_CHANGE_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gobject_class->dispose = gst_bin_dispose;
 
   gst_element_class_set_static_metadata (gstelement_class, "Generic bin",
@@ -504,6 +533,7 @@ gst_bin_init (GstBin * bin)
   bin->priv->asynchandling = DEFAULT_ASYNC_HANDLING;
   bin->priv->structure_cookie = 0;
   bin->priv->message_forward = DEFAULT_MESSAGE_FORWARD;
+  bin->priv->state_change_threads = DEFAULT_STATE_CHANGE_THREADS;
 }
 
 static void
@@ -531,6 +561,12 @@ gst_bin_dispose (GObject * object)
         GST_STR_NULL (GST_OBJECT_NAME (object)));
   }
 
+  if (bin->priv->state_change_pool) {
+    gst_task_pool_cleanup (bin->priv->state_change_pool);
+    gst_object_unref (bin->priv->state_change_pool);
+    bin->priv->state_change_pool = NULL;
+  }
+
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
 
@@ -567,6 +603,15 @@ gst_bin_set_property (GObject * object, guint prop_id,
       gstbin->priv->message_forward = g_value_get_boolean (value);
       GST_OBJECT_UNLOCK (gstbin);
       break;
+    case PROP_STATE_CHANGE_THREADS:
+      GST_OBJECT_LOCK (gstbin);
+      gstbin->priv->state_change_threads = g_value_get_uint (value);
+      if (gstbin->priv->state_change_pool && gstbin->priv->state_change_threads)
+        gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL
+            (gstbin->priv->state_change_pool),
+            gstbin->priv->state_change_threads);
+      GST_OBJECT_UNLOCK (gstbin);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -592,6 +637,11 @@ gst_bin_get_property (GObject * object, guint prop_id,
       g_value_set_boolean (value, gstbin->priv->message_forward);
       GST_OBJECT_UNLOCK (gstbin);
       break;
+    case PROP_STATE_CHANGE_THREADS:
+      GST_OBJECT_LOCK (gstbin);
+      g_value_set_uint (value, gstbin->priv->state_change_threads);
+      GST_OBJECT_UNLOCK (gstbin);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2312,6 +2362,36 @@ find_element (GstElement * element, GstBinSortIterator * bit)
   }
 }
 
+/* with an empty queue, find the next best element and mark it as handled */
+static GstElement *
+gst_bin_sort_iterator_find_best (GstBinSortIterator * bit)
+{
+  GstElement *best;
+  GstBin *bin = bit->bin;
+
+  bit->best = NULL;
+  bit->best_deg = G_MAXINT;
+  g_list_foreach (bin->children, (GFunc) find_element, bit);
+  if ((best = bit->best)) {
+    /* when we detected an unlink, don't warn because our degrees might be
+     * screwed up. We will resync later */
+    if (bit->best_deg != 0 && !bit->dirty) {
+      /* we don't fail on this one yet */
+      GST_WARNING_OBJECT (bin, "loop dected in graph");
+      g_warning ("loop detected in the graph of bin '%s'!!",
+          GST_ELEMENT_NAME (bin));
+    }
+    /* best unhandled element, schedule as next element */
+    GST_DEBUG_OBJECT (bin, "queue empty, next best: %s",
+        GST_ELEMENT_NAME (best));
+    HASH_SET_DEGREE (bit, best, -1);
+  } else {
+    GST_DEBUG_OBJECT (bin, "queue empty, elements exhausted");
+  }
+
+  return best;
+}
+
 /* get next element in iterator. */
 static GstIteratorResult
 gst_bin_sort_iterator_next (GstBinSortIterator * bit, GValue * result)
@@ -2321,25 +2401,9 @@ gst_bin_sort_iterator_next (GstBinSortIterator * bit, GValue * result)
 
   /* empty queue, we have to find a next best element */
   if (g_queue_is_empty (&bit->queue)) {
-    bit->best = NULL;
-    bit->best_deg = G_MAXINT;
-    g_list_foreach (bin->children, (GFunc) find_element, bit);
-    if ((best = bit->best)) {
-      /* when we detected an unlink, don't warn because our degrees might be
-       * screwed up. We will resync later */
-      if (bit->best_deg != 0 && !bit->dirty) {
-        /* we don't fail on this one yet */
-        GST_WARNING_OBJECT (bin, "loop dected in graph");
-        g_warning ("loop detected in the graph of bin '%s'!!",
-            GST_ELEMENT_NAME (bin));
-      }
-      /* best unhandled element, schedule as next element */
-      GST_DEBUG_OBJECT (bin, "queue empty, next best: %s",
-          GST_ELEMENT_NAME (best));
-      HASH_SET_DEGREE (bit, best, -1);
+    if ((best = gst_bin_sort_iterator_find_best (bit))) {
       g_value_set_object (result, best);
     } else {
-      GST_DEBUG_OBJECT (bin, "queue empty, elements exhausted");
       /* no more unhandled elements, we are done */
       return GST_ITERATOR_DONE;
     }
@@ -2357,6 +2421,82 @@ gst_bin_sort_iterator_next (GstBinSortIterator * bit, GValue * result)
   return GST_ITERATOR_OK;
 }
 
+static gboolean
+provides_data_to_pending (GstBinSortIterator * bit, GstElement * element)
+{
+  gboolean pending = FALSE;
+  GList *pads;
+
+  GST_OBJECT_LOCK (element);
+  for (pads = element->srcpads; pads && !pending; pads = g_list_next (pads)) {
+    GstPad *peer;
+    GstElement *peer_element;
+
+    if (!(peer = gst_pad_get_peer (GST_PAD_CAST (pads->data))))
+      continue;
+
+    if ((peer_element = gst_pad_get_parent_element (peer))) {
+      if (GST_OBJECT_PARENT (peer_element) == GST_OBJECT_CAST (bit->bin))
+        pending = HASH_GET_DEGREE (bit, peer_element) > 0 ||
+            g_queue_find (&bit->queue, peer_element) != NULL;
+      gst_object_unref (peer_element);
+    }
+    gst_object_unref (peer);
+  }
+  GST_OBJECT_UNLOCK (element);
+
+  return pending;
+}
+
+/* Moves all the elements that can change state now to @level. These don't
+ * provide data to any element that was not handled yet, so their state can
+ * be changed at the same time. Unlike gst_bin_sort_iterator_next(), the
+ * degrees of their peers are only updated with
+ * gst_bin_sort_iterator_level_done() once all of them are done.
+ *
+ * Should be called with the bin LOCK held. */
+static void
+gst_bin_sort_iterator_next_level (GstBinSortIterator * bit, GPtrArray * level)
+{
+  GstElement *element;
+  GList *walk;
+
+  /* elements with the SINK flag are queued right away, even when they
+   * provide data to another queued element. Leave those in the queue, they
+   * are removed from it when the element they provide data to is done. The
+   * queue took a ref, which moves to the level. */
+  for (walk = bit->queue.head; walk;) {
+    GList *next = walk->next;
+
+    element = walk->data;
+    if (!provides_data_to_pending (bit, element)) {
+      g_queue_delete_link (&bit->queue, walk);
+      g_ptr_array_add (level, element);
+    }
+    walk = next;
+  }
+
+  /* loop between queued elements, take them in order like the sequential
+   * iterator */
+  if (level->len == 0 && !g_queue_is_empty (&bit->queue))
+    g_ptr_array_add (level, g_queue_pop_head (&bit->queue));
+
+  if (level->len == 0 && (element = gst_bin_sort_iterator_find_best (bit)))
+    g_ptr_array_add (level, gst_object_ref (element));
+}
+
+/* the elements of @level changed state, queue the elements linked to them.
+ * Should be called with the bin LOCK held. */
+static void
+gst_bin_sort_iterator_level_done (GstBinSortIterator * bit, GPtrArray * level)
+{
+  guint i;
+
+  for (i = 0; i < level->len; i++)
+    update_degree (g_ptr_array_index (level, i), bit);
+  g_ptr_array_set_size (level, 0);
+}
+
 /* clear queues, recalculate the degrees and restart. */
 static void
 gst_bin_sort_iterator_resync (GstBinSortIterator * bit)
@@ -2817,6 +2957,207 @@ reset_state (const GValue * data, gpointer user_data)
         gst_element_state_get_name (state));
 }
 
+/* handles the result of the state change of @child, returns %FALSE when the
+ * state change of the bin failed */
+static gboolean
+gst_bin_child_state_changed (GstBin * bin, GstElement * child,
+    GstStateChangeReturn ret, GstState next, gboolean * have_async,
+    gboolean * have_no_preroll)
+{
+  switch (ret) {
+    case GST_STATE_CHANGE_SUCCESS:
+      GST_CAT_INFO_OBJECT (GST_CAT_STATES, bin,
+          "child '%s' changed state to %d(%s) successfully",
+          GST_ELEMENT_NAME (child), next, gst_element_state_get_name (next));
+      break;
+    case GST_STATE_CHANGE_ASYNC:
+    {
+      GST_CAT_INFO_OBJECT (GST_CAT_STATES, bin,
+          "child '%s' is changing state asynchronously to %s",
+          GST_ELEMENT_NAME (child), gst_element_state_get_name (next));
+      *have_async = TRUE;
+      break;
+    }
+    case GST_STATE_CHANGE_FAILURE:{
+      GstObject *parent;
+
+      GST_CAT_INFO_OBJECT (GST_CAT_STATES, bin,
+          "child '%s' failed to go to state %d(%s)",
+          GST_ELEMENT_NAME (child), next, gst_element_state_get_name (next));
+
+      /* Only fail if the child is still inside
+       * this bin. It might've been removed already
+       * because of the error by the bin subclass
+       * to ignore the error.  */
+      parent = gst_object_get_parent (GST_OBJECT_CAST (child));
+      if (parent == GST_OBJECT_CAST (bin)) {
+        /* element is still in bin, really error now */
+        gst_object_unref (parent);
+        return FALSE;
+      }
+      /* child removed from bin, let the resync code redo the state
+       * change */
+      GST_CAT_INFO_OBJECT (GST_CAT_STATES, bin,
+          "child '%s' was removed from the bin", GST_ELEMENT_NAME (child));
+
+      if (parent)
+        gst_object_unref (parent);
+
+      break;
+    }
+    case GST_STATE_CHANGE_NO_PREROLL:
+      GST_CAT_INFO_OBJECT (GST_CAT_STATES, bin,
+          "child '%s' changed state to %d(%s) successfully without preroll",
+          GST_ELEMENT_NAME (child), next, gst_element_state_get_name (next));
+      *have_no_preroll = TRUE;
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+  return TRUE;
+}
+
+typedef struct
+{
+  GstBin *bin;
+  GstElement *child;
+  GstClockTime base_time;
+  GstClockTime start_time;
+  GstState current;
+  GstState next;
+  GstStateChangeReturn ret;
+  gpointer handle;
+} BinChildStateChange;
+
+static void
+gst_bin_child_state_change_func (BinChildStateChange * change)
+{
+  change->ret = gst_bin_element_set_state (change->bin, change->child,
+      change->base_time, change->start_time, change->current, change->next);
+}
+
+/* Changes the state of the children level by level, the children of a level
+ * at the same time on @pool. The children of the next level are only taken
+ * from @bit once all the children of the previous level changed state, which
+ * keeps the sink to source order of the sequential state change.
+ *
+ * Returns GST_ITERATOR_RESYNC when the children changed, GST_ITERATOR_ERROR
+ * when the bin failed to change state and GST_ITERATOR_DONE otherwise. */
+static GstIteratorResult
+gst_bin_change_state_parallel (GstBin * bin, GstBinSortIterator * bit,
+    GstTaskPool * pool, GstClockTime base_time, GstClockTime start_time,
+    GstState current, GstState next, gboolean * have_async,
+    gboolean * have_no_preroll)
+{
+  GstIteratorResult result = GST_ITERATOR_DONE;
+  GPtrArray *level;
+  BinChildStateChange *changes = NULL;
+  guint n_changes = 0, i;
+
+  level = g_ptr_array_new_with_free_func (gst_object_unref);
+
+  while (TRUE) {
+    GST_OBJECT_LOCK (bin);
+    if (G_UNLIKELY (bit->it.cookie != *bit->it.master_cookie)) {
+      GST_OBJECT_UNLOCK (bin);
+      result = GST_ITERATOR_RESYNC;
+      break;
+    }
+    gst_bin_sort_iterator_level_done (bit, level);
+    gst_bin_sort_iterator_next_level (bit, level);
+    GST_OBJECT_UNLOCK (bin);
+
+    if (level->len == 0)
+      break;
+
+    if (level->len > n_changes) {
+      n_changes = level->len;
+      changes = g_renew (BinChildStateChange, changes, n_changes);
+    }
+
+    GST_CAT_DEBUG_OBJECT (GST_CAT_STATES, bin,
+        "changing state of %u children at the same time", level->len);
+
+    for (i = 0; i < level->len; i++) {
+      BinChildStateChange *change = &changes[i];
+      GError *error = NULL;
+
+      change->bin = bin;
+      change->child = g_ptr_array_index (level, i);
+      change->base_time = base_time;
+      change->start_time = start_time;
+      change->current = current;
+      change->next = next;
+      change->handle = NULL;
+
+      /* the last one runs in this thread while the others are busy */
+      if (i + 1 < level->len)
+        change->handle = gst_task_pool_push (pool,
+            (GstTaskPoolFunction) gst_bin_child_state_change_func, change,
+            &error);
+
+      /* on error the shared pool only returns a handle when one of its
+       * threads already took the change, otherwise it is never run there */
+      if (error) {
+        GST_CAT_WARNING_OBJECT (GST_CAT_STATES, bin,
+            "failed to push state change: %s", error->message);
+        g_clear_error (&error);
+      }
+      if (change->handle == NULL)
+        gst_bin_child_state_change_func (change);
+    }
+
+    /* wait for all of them, even when one failed, before handling the
+     * results in the order of the level */
+    for (i = 0; i < level->len; i++) {
+      if (changes[i].handle)
+        gst_task_pool_join (pool, changes[i].handle);
+    }
+
+    for (i = 0; i < level->len; i++) {
+      if (!gst_bin_child_state_changed (bin, changes[i].child, changes[i].ret,
+              next, have_async, have_no_preroll))
+        result = GST_ITERATOR_ERROR;
+    }
+    if (result == GST_ITERATOR_ERROR)
+      break;
+  }
+
+  g_ptr_array_unref (level);
+  g_free (changes);
+
+  return result;
+}
+
+static GstTaskPool *
+gst_bin_get_state_change_pool (GstBin * bin)
+{
+  GstTaskPool *pool = NULL;
+
+  GST_OBJECT_LOCK (bin);
+  if (bin->priv->state_change_threads > 0) {
+    if (bin->priv->state_change_pool == NULL) {
+      GError *error = NULL;
+
+      pool = gst_shared_task_pool_new ();
+      gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (pool),
+          bin->priv->state_change_threads);
+      gst_task_pool_prepare (pool, &error);
+      if (error) {
+        GST_WARNING_OBJECT (bin, "failed to prepare state change pool: %s",
+            error->message);
+        g_clear_error (&error);
+      }
+      bin->priv->state_change_pool = pool;
+    }
+    pool = gst_object_ref (bin->priv->state_change_pool);
+  }
+  GST_OBJECT_UNLOCK (bin);
+
+  return pool;
+}
+
 static GstStateChangeReturn
 gst_bin_change_state_func (GstElement * element, GstStateChange transition)
 {
@@ -2827,6 +3168,7 @@ gst_bin_change_state_func (GstElement * element, GstStateChange transition)
   gboolean have_no_preroll;
   GstClockTime base_time, start_time;
   GstIterator *it;
+  GstTaskPool *pool;
   gboolean done;
   GValue data = { 0, };
 
@@ -2904,6 +3246,7 @@ gst_bin_change_state_func (GstElement * element, GstStateChange transition)
 
   /* iterate in state change order */
   it = gst_bin_iterate_sorted (bin);
+  pool = gst_bin_get_state_change_pool (bin);
 
   /* mark if we've seen an ASYNC element in the bin when we did a state change.
    * Note how we don't reset this value when a resync happens, the reason being
@@ -2919,6 +3262,21 @@ restart:
   have_no_preroll = FALSE;
 
   done = FALSE;
+  if (pool) {
+    switch (gst_bin_change_state_parallel (bin, (GstBinSortIterator *) it,
+            pool, base_time, start_time, current, next, &have_async,
+            &have_no_preroll)) {
+      case GST_ITERATOR_RESYNC:
+        GST_CAT_DEBUG_OBJECT (GST_CAT_STATES, element, "iterator doing resync");
+        gst_iterator_resync (it);
+        goto restart;
+      case GST_ITERATOR_ERROR:
+        goto undo;
+      default:
+        done = TRUE;
+        break;
+    }
+  }
   while (!done) {
     switch (gst_iterator_next (it, &data)) {
       case GST_ITERATOR_OK:
@@ -2931,61 +3289,9 @@ restart:
         ret = gst_bin_element_set_state (bin, child, base_time, start_time,
             current, next);
 
-        switch (ret) {
-          case GST_STATE_CHANGE_SUCCESS:
-            GST_CAT_INFO_OBJECT (GST_CAT_STATES, element,
-                "child '%s' changed state to %d(%s) successfully",
-                GST_ELEMENT_NAME (child), next,
-                gst_element_state_get_name (next));
-            break;
-          case GST_STATE_CHANGE_ASYNC:
-          {
-            GST_CAT_INFO_OBJECT (GST_CAT_STATES, element,
-                "child '%s' is changing state asynchronously to %s",
-                GST_ELEMENT_NAME (child), gst_element_state_get_name (next));
-            have_async = TRUE;
-            break;
-          }
-          case GST_STATE_CHANGE_FAILURE:{
-            GstObject *parent;
-
-            GST_CAT_INFO_OBJECT (GST_CAT_STATES, element,
-                "child '%s' failed to go to state %d(%s)",
-                GST_ELEMENT_NAME (child),
-                next, gst_element_state_get_name (next));
-
-            /* Only fail if the child is still inside
-             * this bin. It might've been removed already
-             * because of the error by the bin subclass
-             * to ignore the error.  */
-            parent = gst_object_get_parent (GST_OBJECT_CAST (child));
-            if (parent == GST_OBJECT_CAST (element)) {
-              /* element is still in bin, really error now */
-              gst_object_unref (parent);
-              goto undo;
-            }
-            /* child removed from bin, let the resync code redo the state
-             * change */
-            GST_CAT_INFO_OBJECT (GST_CAT_STATES, element,
-                "child '%s' was removed from the bin",
-                GST_ELEMENT_NAME (child));
-
-            if (parent)
-              gst_object_unref (parent);
-
-            break;
-          }
-          case GST_STATE_CHANGE_NO_PREROLL:
-            GST_CAT_INFO_OBJECT (GST_CAT_STATES, element,
-                "child '%s' changed state to %d(%s) successfully without preroll",
-                GST_ELEMENT_NAME (child), next,
-                gst_element_state_get_name (next));
-            have_no_preroll = TRUE;
-            break;
-          default:
-            g_assert_not_reached ();
-            break;
-        }
+        if (!gst_bin_child_state_changed (bin, child, ret, next, &have_async,
+                &have_no_preroll))
+          goto undo;
         g_value_reset (&data);
         break;
       }
@@ -3020,6 +3326,8 @@ restart:
 done:
   g_value_unset (&data);
   gst_iterator_free (it);
+  if (pool)
+    gst_object_unref (pool);
 
   GST_OBJECT_LOCK (bin);
   bin->polling = FALSE;
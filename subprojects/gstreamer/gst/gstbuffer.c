@@ -153,6 +153,33 @@ GType _gst_buffer_type = 0;
 #define GST_BUFFER_META(b)         (((GstBufferImpl *)(b))->item)
 #define GST_BUFFER_TAIL_META(b)    (((GstBufferImpl *)(b))->tail_item)
 
+/* Metas are allocated from the meta store of the buffer while it has room.
+ * This is enough for the usual video frame metas (video, crop, timecode and
+ * reference timestamp). */
+#define GST_BUFFER_INLINE_META_SIZE 384
+
+/* The first meta of each API is also found through a small index hashed by
+ * API type. Each slot points to the first item in the list whose API hashes
+ * to the slot, so a lookup only walks the list on collisions. */
+#define GST_BUFFER_META_SLOTS      8
+#define META_SLOT_INDEX(api) \
+    ((((gsize) (api) >> 4) ^ ((gsize) (api) >> 8)) % GST_BUFFER_META_SLOTS)
+#define GST_BUFFER_META_STORE(b)   (((GstBufferImpl *)(b))->meta_store)
+/* only valid when the buffer has a meta store */
+#define GST_BUFFER_META_SLOT(b,api) (GST_BUFFER_META_STORE (b)->slots[META_SLOT_INDEX (api)])
+
+/* Index and storage for the first metas. It is allocated when the first meta
+ * is added, so buffers without metas don't pay for it, and kept until the
+ * buffer is freed so that pooled buffers reuse it. The used part of the
+ * storage is reset when all metas in it are gone. */
+typedef struct
+{
+  GstMetaItem *slots[GST_BUFFER_META_SLOTS];
+  guint used;
+  guint live;
+  guint64 data[GST_BUFFER_INLINE_META_SIZE / sizeof (guint64)];
+} GstBufferMetaStore;
+
 typedef struct
 {
   GstBuffer buffer;
@@ -166,10 +193,9 @@ typedef struct
   /* memory of the buffer when allocated from 1 chunk */
   GstMemory *bufmem;
 
-  /* FIXME, make metadata allocation more efficient by using part of the
-   * GstBufferImpl */
   GstMetaItem *item;
   GstMetaItem *tail_item;
+  GstBufferMetaStore *meta_store;
 } GstBufferImpl;
 
 static gint64 meta_seq;         /* 0 *//* ATOMIC */
@@ -778,6 +804,97 @@ _gst_buffer_dispose (GstBuffer * buffer)
   return FALSE;
 }
 
+/* returns the first item in the index slot of @api */
+static inline GstMetaItem *
+meta_slot_get (GstBuffer * buffer, GType api)
+{
+  GstBufferMetaStore *store = GST_BUFFER_META_STORE (buffer);
+
+  return store ? store->slots[META_SLOT_INDEX (api)] : NULL;
+}
+
+static GstMetaItem *
+meta_item_alloc (GstBuffer * buffer, const GstMetaInfo * info)
+{
+  GstBufferMetaStore *store = GST_BUFFER_META_STORE (buffer);
+  gsize size = ITEM_SIZE (info);
+  gsize asize = GST_ROUND_UP_8 (size);
+  GstMetaItem *item;
+
+  if (G_UNLIKELY (store == NULL))
+    store = GST_BUFFER_META_STORE (buffer) = g_slice_new0 (GstBufferMetaStore);
+
+  if (store->used + asize <= GST_BUFFER_INLINE_META_SIZE) {
+    item = (GstMetaItem *) ((guint8 *) store->data + store->used);
+    store->used += asize;
+    store->live++;
+
+    /* We warn in gst_meta_register() about metas without
+     * init function but let's play safe here and prevent
+     * uninitialized memory
+     */
+    if (!info->init_func)
+      memset (item, 0, size);
+  } else if (!info->init_func) {
+    item = g_slice_alloc0 (size);
+  } else {
+    item = g_slice_alloc (size);
+  }
+
+  return item;
+}
+
+static void
+meta_item_free (GstBuffer * buffer, GstMetaItem * item)
+{
+  GstBufferMetaStore *store = GST_BUFFER_META_STORE (buffer);
+  guint8 *start = (guint8 *) store->data;
+  guint8 *p = (guint8 *) item;
+
+  if (p >= start && p < start + GST_BUFFER_INLINE_META_SIZE) {
+    gsize asize = GST_ROUND_UP_8 (ITEM_SIZE (item->meta.info));
+
+    /* the space is only reused when this was the last one */
+    if (--store->live == 0)
+      store->used = 0;
+    else if (p + asize == start + store->used)
+      store->used -= asize;
+  } else {
+    g_slice_free1 (ITEM_SIZE (item->meta.info), item);
+  }
+}
+
+/* unlinks @item, which comes after @prev in the list (or is the head when
+ * @prev == @item) */
+static void
+meta_item_unlink (GstBuffer * buffer, GstMetaItem * item, GstMetaItem * prev)
+{
+  GType api = item->meta.info->api;
+
+  if (GST_BUFFER_TAIL_META (buffer) == item) {
+    if (prev != item)
+      GST_BUFFER_TAIL_META (buffer) = prev;
+    else
+      GST_BUFFER_TAIL_META (buffer) = NULL;
+  }
+
+  if (GST_BUFFER_META (buffer) == item)
+    GST_BUFFER_META (buffer) = item->next;
+  else
+    prev->next = item->next;
+
+  /* point the index to the next item with the same slot */
+  if (GST_BUFFER_META_SLOT (buffer, api) == item) {
+    GstMetaItem *next;
+
+    for (next = item->next; next; next = next->next) {
+      if (META_SLOT_INDEX (next->meta.info->api) == META_SLOT_INDEX (api))
+        break;
+    }
+    GST_BUFFER_META_SLOT (buffer, api) = next;
+  }
+}
+
 static void
 _gst_buffer_free (GstBuffer * buffer)
 {
@@ -799,9 +916,11 @@ _gst_buffer_free (GstBuffer * buffer)
       info->free_func (meta, buffer);
 
     next = walk->next;
-    /* and free the slice */
-    g_slice_free1 (ITEM_SIZE (info), walk);
+    /* and free the item */
+    meta_item_free (buffer, walk);
   }
+  if (GST_BUFFER_META_STORE (buffer))
+    g_slice_free (GstBufferMetaStore, GST_BUFFER_META_STORE (buffer));
 
   /* get the size, when unreffing the memory, we could also unref the buffer
    * itself */
@@ -821,7 +940,7 @@ _gst_buffer_free (GstBuffer * buffer)
 #ifdef USE_POISONING
     memset (buffer, 0xff, msize);
 #endif
-    g_slice_free1 (msize, buffer);
+    _priv_gst_slab_free (msize, buffer);
   } else {
     gst_memory_unref (GST_BUFFER_BUFMEM (buffer));
   }
@@ -846,6 +965,7 @@ gst_buffer_init (GstBufferImpl * buffer, gsize size)
 
   GST_BUFFER_MEM_LEN (buffer) = 0;
   GST_BUFFER_META (buffer) = NULL;
+  buffer->meta_store = NULL;
 }
 
 /**
@@ -860,7 +980,7 @@ gst_buffer_new (void)
 {
   GstBufferImpl *newbuf;
 
-  newbuf = g_slice_new (GstBufferImpl);
+  newbuf = _priv_gst_slab_alloc (sizeof (GstBufferImpl));
   GST_CAT_LOG (GST_CAT_BUFFER, "new %p", newbuf);
 
   gst_buffer_init (newbuf, sizeof (GstBufferImpl));
@@ -2250,8 +2370,9 @@ gst_buffer_get_meta (GstBuffer * buffer, GType api)
   g_return_val_if_fail (buffer != NULL, NULL);
   g_return_val_if_fail (api != 0, NULL);
 
-  /* find GstMeta of the requested API */
-  for (item = GST_BUFFER_META (buffer); item; item = item->next) {
+  /* find GstMeta of the requested API, starting from the first one in its
+   * slot */
+  for (item = meta_slot_get (buffer, api); item; item = item->next) {
     GstMeta *meta = &item->meta;
     if (meta->info->api == api) {
       result = meta;
@@ -2299,22 +2420,12 @@ gst_buffer_add_meta (GstBuffer * buffer, const GstMetaInfo * info,
 {
   GstMetaItem *item;
   GstMeta *result = NULL;
-  gsize size;
 
   g_return_val_if_fail (buffer != NULL, NULL);
   g_return_val_if_fail (info != NULL, NULL);
   g_return_val_if_fail (gst_buffer_is_writable (buffer), NULL);
 
-  /* create a new slice */
-  size = ITEM_SIZE (info);
-  /* We warn in gst_meta_register() about metas without
-   * init function but let's play safe here and prevent
-   * uninitialized memory
-   */
-  if (!info->init_func)
-    item = g_slice_alloc0 (size);
-  else
-    item = g_slice_alloc (size);
+  item = meta_item_alloc (buffer, info);
   result = &item->meta;
   result->info = info;
   result->flags = GST_META_FLAG_NONE;
@@ -2337,12 +2448,14 @@ gst_buffer_add_meta (GstBuffer * buffer, const GstMetaInfo * info,
     GST_BUFFER_TAIL_META (buffer)->next = item;
     GST_BUFFER_TAIL_META (buffer) = item;
   }
+  if (!GST_BUFFER_META_SLOT (buffer, info->api))
+    GST_BUFFER_META_SLOT (buffer, info->api) = item;
 
   return result;
 
 init_failed:
   {
-    g_slice_free1 (size, item);
+    meta_item_free (buffer, item);
     return NULL;
   }
 }
@@ -2376,24 +2489,14 @@ gst_buffer_remove_meta (GstBuffer * buffer, GstMeta * meta)
       const GstMetaInfo *info = meta->info;
 
       /* remove from list */
-      if (GST_BUFFER_TAIL_META (buffer) == walk) {
-        if (prev != walk)
-          GST_BUFFER_TAIL_META (buffer) = prev;
-        else
-          GST_BUFFER_TAIL_META (buffer) = NULL;
-      }
-
-      if (GST_BUFFER_META (buffer) == walk)
-        GST_BUFFER_META (buffer) = walk->next;
-      else
-        prev->next = walk->next;
+      meta_item_unlink (buffer, walk, prev);
 
       /* call free_func if any */
       if (info->free_func)
         info->free_func (m, buffer);
 
-      /* and free the slice */
-      g_slice_free1 (ITEM_SIZE (info), walk);
+      /* and free the item */
+      meta_item_free (buffer, walk);
       break;
     }
     prev = walk;
@@ -2464,8 +2567,8 @@ gst_buffer_iterate_meta_filtered (GstBuffer * buffer, gpointer * state,
 
   meta = (GstMetaItem **) state;
   if (*meta == NULL)
-    /* state NULL, move to first item */
-    *meta = GST_BUFFER_META (buffer);
+    /* state NULL, move to first item in the slot of the API */
+    *meta = meta_slot_get (buffer, meta_api_type);
   else
     /* state !NULL, move to next item in list */
     *meta = (*meta)->next;
@@ -2523,25 +2626,17 @@ gst_buffer_foreach_meta (GstBuffer * buffer, GstBufferForeachMetaFunc func,
       g_return_val_if_fail (!GST_META_FLAG_IS_SET (m, GST_META_FLAG_LOCKED),
           FALSE);
 
-      if (GST_BUFFER_TAIL_META (buffer) == walk) {
-        if (prev != walk)
-          GST_BUFFER_TAIL_META (buffer) = prev;
-        else
-          GST_BUFFER_TAIL_META (buffer) = NULL;
-      }
-
       /* remove from list */
-      if (GST_BUFFER_META (buffer) == walk)
-        prev = GST_BUFFER_META (buffer) = next;
-      else
-        prev->next = next;
+      meta_item_unlink (buffer, walk, prev);
+      if (GST_BUFFER_META (buffer) == next)
+        prev = next;
 
       /* call free_func if any */
       if (info->free_func)
         info->free_func (m, buffer);
 
-      /* and free the slice */
-      g_slice_free1 (ITEM_SIZE (info), walk);
+      /* and free the item */
+      meta_item_free (buffer, walk);
     } else {
       prev = walk;
     }
@@ -55,6 +55,9 @@
  *
  * Buffers allocated from a bufferpool will automatically be returned to the
  * pool with gst_buffer_pool_release_buffer() when their refcount drops to 0.
+ * The default implementation keeps a few released buffers in a cache of the
+ * releasing thread, so that a thread that acquires and releases buffers in a
+ * loop doesn't contend with other threads using the same pool.
  *
  * The bufferpool can be deactivated again with gst_buffer_pool_set_active().
  * All further gst_buffer_pool_acquire_buffer() calls will return an error. When
@@ -90,11 +93,33 @@ GST_DEBUG_CATEGORY_STATIC (gst_buffer_pool_debug);
 #define GST_BUFFER_POOL_LOCK(pool)   (g_rec_mutex_lock(&pool->priv->rec_lock))
 #define GST_BUFFER_POOL_UNLOCK(pool) (g_rec_mutex_unlock(&pool->priv->rec_lock))
 
+/* Released buffers are first kept in a small cache per thread. Threads are
+ * spread over a fixed number of caches, so more threads than that share a
+ * cache. Buffers in the caches don't need the control token, which saves
+ * the wakeup socket round trip and the contention on the shared queue */
+#define BUFFER_POOL_N_CACHES 8
+#define BUFFER_POOL_CACHE_SIZE 4
+
+typedef struct
+{
+  GMutex lock;
+  guint n_buffers;
+  GstBuffer *buffers[BUFFER_POOL_CACHE_SIZE];
+} GstBufferPoolCache;
+
+static GPrivate thread_cache_index;
+static gint next_cache_index;
+
 struct _GstBufferPoolPrivate
 {
   GstAtomicQueue *queue;
   GstPoll *poll;
 
+  GstBufferPoolCache caches[BUFFER_POOL_N_CACHES];
+  /* number of threads about to wait for a buffer, releasing threads put
+   * buffers in the shared queue then to wake them up */
+  gint waiters;
+
   GRecMutex rec_lock;
 
   gboolean started;
@@ -154,6 +179,7 @@ static void
 gst_buffer_pool_init (GstBufferPool * pool)
 {
   GstBufferPoolPrivate *priv;
+  guint i;
 
   priv = pool->priv = gst_buffer_pool_get_instance_private (pool);
 
@@ -161,6 +187,8 @@ gst_buffer_pool_init (GstBufferPool * pool)
 
   priv->poll = gst_poll_new_timer ();
   priv->queue = gst_atomic_queue_new (16);
+  for (i = 0; i < BUFFER_POOL_N_CACHES; i++)
+    g_mutex_init (&priv->caches[i].lock);
   pool->flushing = 1;
   priv->active = FALSE;
   priv->configured = FALSE;
@@ -201,12 +229,15 @@ gst_buffer_pool_finalize (GObject * object)
 {
   GstBufferPool *pool;
   GstBufferPoolPrivate *priv;
+  guint i;
 
   pool = GST_BUFFER_POOL_CAST (object);
   priv = pool->priv;
 
   GST_DEBUG_OBJECT (pool, "%p finalize", pool);
 
+  for (i = 0; i < BUFFER_POOL_N_CACHES; i++)
+    g_mutex_clear (&priv->caches[i].lock);
   gst_atomic_queue_unref (priv->queue);
   gst_poll_free (priv->poll);
   gst_structure_free (priv->config);
@@ -236,6 +267,77 @@ gst_buffer_pool_new (void)
   return result;
 }
 
+static inline guint
+get_thread_cache_index (void)
+{
+  gint index = GPOINTER_TO_INT (g_private_get (&thread_cache_index));
+
+  /* stored + 1 so that 0 means unset */
+  if (G_UNLIKELY (index == 0)) {
+    index = (g_atomic_int_add (&next_cache_index, 1) % BUFFER_POOL_N_CACHES) + 1;
+    g_private_set (&thread_cache_index, GINT_TO_POINTER (index));
+  }
+
+  return index - 1;
+}
+
+/* Puts @buffer in the cache of the current thread. Fails when the cache is
+ * full or when someone is about to wait for a buffer, which must then go to
+ * the shared queue to wake them up. */
+static gboolean
+cache_push (GstBufferPool * pool, GstBuffer * buffer)
+{
+  GstBufferPoolCache *cache = &pool->priv->caches[get_thread_cache_index ()];
+  gboolean res = FALSE;
+
+  g_mutex_lock (&cache->lock);
+  /* checked with the lock held, see default_acquire_buffer() */
+  if (cache->n_buffers < BUFFER_POOL_CACHE_SIZE
+      && g_atomic_int_get (&pool->priv->waiters) == 0) {
+    cache->buffers[cache->n_buffers++] = buffer;
+    res = TRUE;
+  }
+  g_mutex_unlock (&cache->lock);
+
+  return res;
+}
+
+static GstBuffer *
+cache_pop (GstBufferPoolCache * cache, gboolean wait)
+{
+  GstBuffer *buffer = NULL;
+
+  if (wait)
+    g_mutex_lock (&cache->lock);
+  else if (!g_mutex_trylock (&cache->lock))
+    return NULL;
+
+  if (cache->n_buffers > 0)
+    buffer = cache->buffers[--cache->n_buffers];
+  g_mutex_unlock (&cache->lock);
+
+  return buffer;
+}
+
+/* Takes a buffer from the caches of the other threads. When @wait is %FALSE
+ * caches that are in use right now are skipped. */
+static GstBuffer *
+cache_steal (GstBufferPool * pool, gboolean wait)
+{
+  guint i, index = get_thread_cache_index ();
+  GstBuffer *buffer;
+
+  for (i = 1; i < BUFFER_POOL_N_CACHES; i++) {
+    GstBufferPoolCache *cache =
+        &pool->priv->caches[(index + i) % BUFFER_POOL_N_CACHES];
+
+    if ((buffer = cache_pop (cache, wait)))
+      return buffer;
+  }
+
+  return NULL;
+}
+
 static GstFlowReturn
 default_alloc_buffer (GstBufferPool * pool, GstBuffer ** buffer,
     GstBufferPoolAcquireParams * params)
@@ -405,6 +507,13 @@ default_stop (GstBufferPool * pool)
 {
   GstBufferPoolPrivate *priv = pool->priv;
   GstBuffer *buffer;
+  guint i;
+
+  /* clear the caches */
+  for (i = 0; i < BUFFER_POOL_N_CACHES; i++) {
+    while ((buffer = cache_pop (&priv->caches[i], TRUE)))
+      do_free_buffer (pool, buffer);
+  }
 
   /* clear the pool */
   while ((buffer = gst_atomic_queue_pop (priv->queue))) {
@@ -1111,12 +1220,21 @@ default_acquire_buffer (GstBufferPool * pool, GstBuffer ** buffer,
 {
   GstFlowReturn result;
   GstBufferPoolPrivate *priv = pool->priv;
+  GstBufferPoolCache *cache = &priv->caches[get_thread_cache_index ()];
 
   while (TRUE) {
     if (G_UNLIKELY (GST_BUFFER_POOL_IS_FLUSHING (pool)))
       goto flushing;
 
-    /* try to get a buffer from the queue */
+    /* try to get a buffer from the cache of this thread first */
+    *buffer = cache_pop (cache, TRUE);
+    if (G_LIKELY (*buffer)) {
+      result = GST_FLOW_OK;
+      GST_LOG_OBJECT (pool, "acquired cached buffer %p", *buffer);
+      break;
+    }
+
+    /* then from the queue */
     *buffer = gst_atomic_queue_pop (priv->queue);
     if (G_LIKELY (*buffer)) {
       while (!gst_poll_read_control (priv->poll)) {
@@ -1135,6 +1253,14 @@ default_acquire_buffer (GstBufferPool * pool, GstBuffer ** buffer,
       break;
     }
 
+    /* then from the caches of other threads */
+    *buffer = cache_steal (pool, FALSE);
+    if (*buffer) {
+      result = GST_FLOW_OK;
+      GST_LOG_OBJECT (pool, "acquired buffer %p from other thread", *buffer);
+      break;
+    }
+
     /* no buffer, try to allocate some more */
     GST_LOG_OBJECT (pool, "no buffer, trying to allocate");
     result = do_alloc_buffer (pool, buffer, params);
@@ -1152,6 +1278,21 @@ default_acquire_buffer (GstBufferPool * pool, GstBuffer ** buffer,
       break;
     }
 
+    /* From now on releasing threads put buffers in the queue and wake us
+     * up. Check the caches a last time for buffers that were put there
+     * before they noticed, cache_push() checks the waiters with the cache
+     * lock held so we can't miss any. */
+    g_atomic_int_inc (&priv->waiters);
+    *buffer = cache_steal (pool, TRUE);
+    if (!*buffer)
+      *buffer = cache_pop (cache, TRUE);
+    if (*buffer) {
+      g_atomic_int_add (&priv->waiters, -1);
+      result = GST_FLOW_OK;
+      GST_LOG_OBJECT (pool, "acquired buffer %p from other thread", *buffer);
+      break;
+    }
+
     /* now we release the control socket, we wait for a buffer release or
      * flushing */
     if (!gst_poll_read_control (pool->priv->poll)) {
@@ -1165,6 +1306,7 @@ default_acquire_buffer (GstBufferPool * pool, GstBuffer ** buffer,
         gst_poll_wait (priv->poll, GST_CLOCK_TIME_NONE);
       } else {
         /* This is a critical error, GstPoll already gave a warning */
+        g_atomic_int_add (&priv->waiters, -1);
         result = GST_FLOW_ERROR;
         break;
       }
@@ -1181,6 +1323,7 @@ default_acquire_buffer (GstBufferPool * pool, GstBuffer ** buffer,
       }
       gst_poll_write_control (pool->priv->poll);
     }
+    g_atomic_int_add (&priv->waiters, -1);
   }
 
   return result;
@@ -1193,6 +1336,10 @@ flushing:
   }
 }
 
+/* Releasing doesn't take the object lock or the pool lock, the flushing
+ * state and the outstanding count are atomics. The pool lock is only taken
+ * here by the release of the last outstanding buffer of a deactivated pool,
+ * which then frees the buffers. */
 static inline void
 dec_outstanding (GstBufferPool * pool)
 {
@@ -1324,7 +1471,10 @@ default_release_buffer (GstBufferPool * pool, GstBuffer * buffer)
   if (G_UNLIKELY (!gst_buffer_is_all_memory_writable (buffer)))
     goto not_writable;
 
-  /* keep it around in our queue */
+  /* keep it around in the cache of this thread or in our queue */
+  if (G_LIKELY (cache_push (pool, buffer)))
+    return;
+
   gst_atomic_queue_push (pool->priv->queue, buffer);
   gst_poll_write_control (pool->priv->poll);
 
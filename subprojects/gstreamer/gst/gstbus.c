@@ -97,11 +97,15 @@ enum
 };
 
 #define DEFAULT_ENABLE_ASYNC (TRUE)
+#define DEFAULT_INTEREST_MASK (GST_MESSAGE_ANY)
+#define DEFAULT_DISPATCH_BATCH_SIZE (1)
 
 enum
 {
   PROP_0,
-  PROP_ENABLE_ASYNC
+  PROP_ENABLE_ASYNC,
+  PROP_INTEREST_MASK,
+  PROP_DISPATCH_BATCH_SIZE
 };
 
 static void gst_bus_dispose (GObject * object);
@@ -152,6 +156,10 @@ struct _GstBusPrivate
   gboolean enable_async;
   GstPoll *poll;
   GPollFD pollfd;
+
+  /* GstMessageType, read without the lock when posting */
+  guint interest_mask;
+  guint dispatch_batch_size;
 };
 
 #define gst_bus_parent_class parent_class
@@ -167,6 +175,31 @@ gst_bus_set_property (GObject * object,
     case PROP_ENABLE_ASYNC:
       bus->priv->enable_async = g_value_get_boolean (value);
       break;
+    case PROP_INTEREST_MASK:
+      gst_bus_set_interest_mask (bus, g_value_get_flags (value));
+      break;
+    case PROP_DISPATCH_BATCH_SIZE:
+      gst_bus_set_dispatch_batch_size (bus, g_value_get_uint (value));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_bus_get_property (GObject * object,
+    guint prop_id, GValue * value, GParamSpec * pspec)
+{
+  GstBus *bus = GST_BUS_CAST (object);
+
+  switch (prop_id) {
+    case PROP_INTEREST_MASK:
+      g_value_set_flags (value, gst_bus_get_interest_mask (bus));
+      break;
+    case PROP_DISPATCH_BATCH_SIZE:
+      g_value_set_uint (value, gst_bus_get_dispatch_batch_size (bus));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -194,6 +227,7 @@ gst_bus_class_init (GstBusClass * klass)
   gobject_class->dispose = gst_bus_dispose;
   gobject_class->finalize = gst_bus_finalize;
   gobject_class->set_property = gst_bus_set_property;
+  gobject_class->get_property = gst_bus_get_property;
   gobject_class->constructed = gst_bus_constructed;
 
   /**
@@ -212,6 +246,34 @@ gst_bus_class_init (GstBusClass * klass)
           DEFAULT_ENABLE_ASYNC,
           G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstBus:interest-mask:
+   *
+   * The message types the application is interested in, see
+   * gst_bus_set_interest_mask().
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_INTEREST_MASK,
+      g_param_spec_flags ("interest-mask", "Interest Mask",
+          "Message types that are delivered, others are dropped when posted",
+          GST_TYPE_MESSAGE_TYPE, DEFAULT_INTEREST_MASK,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstBus:dispatch-batch-size:
+   *
+   * The maximum number of messages delivered in one dispatch of a bus
+   * watch, see gst_bus_set_dispatch_batch_size().
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_DISPATCH_BATCH_SIZE,
+      g_param_spec_uint ("dispatch-batch-size", "Dispatch Batch Size",
+          "Maximum number of messages delivered per dispatch of a bus watch",
+          1, G_MAXUINT, DEFAULT_DISPATCH_BATCH_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstBus::sync-message:
    * @self: the object which received the signal
@@ -250,6 +312,8 @@ gst_bus_init (GstBus * bus)
 {
   bus->priv = gst_bus_get_instance_private (bus);
   bus->priv->enable_async = DEFAULT_ENABLE_ASYNC;
+  bus->priv->interest_mask = DEFAULT_INTEREST_MASK;
+  bus->priv->dispatch_batch_size = DEFAULT_DISPATCH_BATCH_SIZE;
   g_mutex_init (&bus->priv->queue_lock);
   bus->priv->queue = gst_atomic_queue_new (32);
 
@@ -342,6 +406,11 @@ gst_bus_post (GstBus * bus, GstMessage * message)
   g_assert (!GST_MINI_OBJECT_FLAG_IS_SET (message,
           GST_MESSAGE_FLAG_ASYNC_DELIVERY));
 
+  /* nobody is interested in this message */
+  if (G_UNLIKELY (!_priv_gst_bus_wants_message_type (bus,
+              GST_MESSAGE_TYPE (message))))
+    goto not_interested;
+
   GST_OBJECT_LOCK (bus);
   /* check if the bus is flushing */
   if (GST_OBJECT_FLAG_IS_SET (bus, GST_BUS_FLUSHING))
@@ -437,6 +506,114 @@ is_flushing:
 
     return FALSE;
   }
+not_interested:
+  {
+    GST_DEBUG_OBJECT (bus, "[msg %p] dropped, not in interest mask", message);
+    gst_message_unref (message);
+
+    return TRUE;
+  }
+}
+
+/* extended types only match when the mask contains GST_MESSAGE_EXTENDED,
+ * like in gst_bus_timed_pop_filtered() */
+gboolean
+_priv_gst_bus_wants_message_type (GstBus * bus, GstMessageType type)
+{
+  guint mask = g_atomic_int_get (&bus->priv->interest_mask);
+
+  if (type & GST_MESSAGE_EXTENDED)
+    return (mask & GST_MESSAGE_EXTENDED) != 0;
+
+  return (type & mask) != 0;
+}
+
+/**
+ * gst_bus_set_interest_mask:
+ * @bus: a #GstBus
+ * @types: the message types to deliver, %GST_MESSAGE_ANY for all types
+ *
+ * Declares the message types the application handles. Messages of other
+ * types posted on @bus are dropped right away, before the sync handler is
+ * called, so they don't wake up the main loop. Elements can check with
+ * gst_element_is_message_wanted() whether it is worth creating a message at
+ * all.
+ *
+ * This should only be set on the bus of a toplevel pipeline. The bins inside
+ * the pipeline still get all the messages of their children.
+ *
+ * Since: 1.24
+ */
+void
+gst_bus_set_interest_mask (GstBus * bus, GstMessageType types)
+{
+  g_return_if_fail (GST_IS_BUS (bus));
+
+  GST_DEBUG_OBJECT (bus, "interest mask 0x%08x", (guint) types);
+  g_atomic_int_set (&bus->priv->interest_mask, (guint) types);
+}
+
+/**
+ * gst_bus_get_interest_mask:
+ * @bus: a #GstBus
+ *
+ * Returns: the message types delivered by @bus.
+ *
+ * Since: 1.24
+ */
+GstMessageType
+gst_bus_get_interest_mask (GstBus * bus)
+{
+  g_return_val_if_fail (GST_IS_BUS (bus), GST_MESSAGE_ANY);
+
+  return (GstMessageType) g_atomic_int_get (&bus->priv->interest_mask);
+}
+
+/**
+ * gst_bus_set_dispatch_batch_size:
+ * @bus: a #GstBus
+ * @max_messages: the maximum number of messages per dispatch
+ *
+ * Sets how many pending messages a bus watch delivers each time it is
+ * dispatched. By default every message is delivered in a separate iteration
+ * of the main loop. When a pipeline posts many messages, delivering several
+ * of them at once saves main loop wakeups at the cost of the latency of the
+ * other sources of the main context.
+ *
+ * Since: 1.24
+ */
+void
+gst_bus_set_dispatch_batch_size (GstBus * bus, guint max_messages)
+{
+  g_return_if_fail (GST_IS_BUS (bus));
+  g_return_if_fail (max_messages > 0);
+
+  GST_OBJECT_LOCK (bus);
+  bus->priv->dispatch_batch_size = max_messages;
+  GST_OBJECT_UNLOCK (bus);
+}
+
+/**
+ * gst_bus_get_dispatch_batch_size:
+ * @bus: a #GstBus
+ *
+ * Returns: the maximum number of messages delivered per dispatch of a bus
+ * watch.
+ *
+ * Since: 1.24
+ */
+guint
+gst_bus_get_dispatch_batch_size (GstBus * bus)
+{
+  guint result;
+
+  g_return_val_if_fail (GST_IS_BUS (bus), DEFAULT_DISPATCH_BATCH_SIZE);
+
+  GST_OBJECT_LOCK (bus);
+  result = bus->priv->dispatch_batch_size;
+  GST_OBJECT_UNLOCK (bus);
+
+  return result;
 }
 
 /**
@@ -796,8 +973,9 @@ gst_bus_source_dispatch (GSource * source, GSourceFunc callback,
   GstBusFunc handler = (GstBusFunc) callback;
   GstBusSource *bsource = (GstBusSource *) source;
   GstMessage *message;
-  gboolean keep;
+  gboolean keep = TRUE;
   GstBus *bus;
+  guint batch_size;
 
   g_return_val_if_fail (bsource != NULL, FALSE);
 
@@ -805,23 +983,31 @@ gst_bus_source_dispatch (GSource * source, GSourceFunc callback,
 
   g_return_val_if_fail (GST_IS_BUS (bus), FALSE);
 
-  message = gst_bus_pop (bus);
+  GST_OBJECT_LOCK (bus);
+  batch_size = bus->priv->dispatch_batch_size;
+  GST_OBJECT_UNLOCK (bus);
 
-  /* The message queue might be empty if some other thread or callback set
-   * the bus to flushing between check/prepare and dispatch */
-  if (G_UNLIKELY (message == NULL))
-    return TRUE;
+  do {
+    message = gst_bus_pop (bus);
+
+    /* The message queue might be empty if some other thread or callback set
+     * the bus to flushing between check/prepare and dispatch */
+    if (G_UNLIKELY (message == NULL))
+      break;
 
-  if (!handler)
-    goto no_handler;
+    if (!handler)
+      goto no_handler;
 
-  GST_DEBUG_OBJECT (bus, "source %p calling dispatch with %" GST_PTR_FORMAT,
-      source, message);
+    GST_DEBUG_OBJECT (bus, "source %p calling dispatch with %" GST_PTR_FORMAT,
+        source, message);
+
+    keep = handler (bus, message, user_data);
+    gst_message_unref (message);
 
-  keep = handler (bus, message, user_data);
-  gst_message_unref (message);
+    GST_DEBUG_OBJECT (bus, "source %p handler returns %d", source, keep);
 
-  GST_DEBUG_OBJECT (bus, "source %p handler returns %d", source, keep);
+    /* stop when the handler removed the watch */
+  } while (keep && --batch_size > 0 && !g_source_is_destroyed (source));
 
   return keep;
 
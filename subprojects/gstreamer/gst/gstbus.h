@@ -185,6 +185,12 @@ GstMessage *            gst_bus_timed_pop_filtered      (GstBus * bus, GstClockT
 GST_API
 void                    gst_bus_set_flushing            (GstBus * bus, gboolean flushing);
 
+GST_API
+void                    gst_bus_set_interest_mask       (GstBus * bus, GstMessageType types);
+
+GST_API
+GstMessageType          gst_bus_get_interest_mask       (GstBus * bus);
+
 /* synchronous dispatching */
 
 GST_API
@@ -214,6 +220,12 @@ guint                   gst_bus_add_watch               (GstBus * bus,
 GST_API
 gboolean                gst_bus_remove_watch            (GstBus * bus);
 
+GST_API
+void                    gst_bus_set_dispatch_batch_size (GstBus * bus, guint max_messages);
+
+GST_API
+guint                   gst_bus_get_dispatch_batch_size (GstBus * bus);
+
 /* polling the bus */
 
 GST_API
@@ -84,10 +84,34 @@ typedef struct _GstCapsImpl
   GstCaps caps;
 
   GArray *array;
+
+  /* identifies the caps and their content in the intersection cache, changes
+   * whenever the caps, their structures or their features are modified */
+  gsize serial;
 } GstCapsImpl;
 
 #define GST_CAPS_ARRAY(c) (((GstCapsImpl *)(c))->array)
 
+#define GST_CAPS_SERIAL(c) (((GstCapsImpl *)(c))->serial)
+
+/* gives the caps a new serial, must be called for every modification */
+#define GST_CAPS_CHANGED(c) G_STMT_START{                               \
+  if (G_UNLIKELY (caps_cache_enabled))                                  \
+    GST_CAPS_SERIAL (c) =                                               \
+        (gsize) g_atomic_pointer_add (&caps_serial, 1) + 1;             \
+}G_STMT_END
+
+/* lets the structure and features change the serial of the caps when they
+ * are modified */
+#define GST_CAPS_TRACK_STRUCTURE(c, s) G_STMT_START{                     \
+  if (G_UNLIKELY (caps_cache_enabled))                                  \
+    _priv_gst_structure_set_parent_serial (s, &GST_CAPS_SERIAL (c));    \
+}G_STMT_END
+#define GST_CAPS_TRACK_FEATURES(c, f) G_STMT_START{                      \
+  if (G_UNLIKELY (caps_cache_enabled))                                  \
+    _priv_gst_caps_features_set_parent_serial (f, &GST_CAPS_SERIAL (c)); \
+}G_STMT_END
+
 #define GST_CAPS_LEN(c)   (GST_CAPS_ARRAY(c)->len)
 
 #define IS_WRITABLE(caps) \
@@ -117,14 +141,59 @@ typedef struct _GstCapsImpl
 /* quick way to append a structure without checking the args */
 #define gst_caps_append_structure_unchecked(caps, s, f) G_STMT_START{\
   GstCapsArrayElement __e={s, f};                                      \
+  GST_CAPS_CHANGED (caps);                                             \
   if (gst_structure_set_parent_refcount (__e.structure, &GST_MINI_OBJECT_REFCOUNT(caps)) && \
-      (!__e.features || gst_caps_features_set_parent_refcount (__e.features, &GST_MINI_OBJECT_REFCOUNT(caps))))         \
-    g_array_append_val (GST_CAPS_ARRAY (caps), __e);                             \
+      (!__e.features || gst_caps_features_set_parent_refcount (__e.features, &GST_MINI_OBJECT_REFCOUNT(caps)))) {       \
+    GST_CAPS_TRACK_STRUCTURE (caps, __e.structure);                      \
+    if (__e.features)                                                    \
+      GST_CAPS_TRACK_FEATURES (caps, __e.features);                      \
+    g_array_append_val (GST_CAPS_ARRAY (caps), __e);                     \
+  }                                                                      \
 }G_STMT_END
 
 /* lock to protect multiple invocations of static caps to caps conversion */
 G_LOCK_DEFINE_STATIC (static_caps_lock);
 
+/* When GST_CAPS_CACHE is set, the results of intersections between caps that
+ * are not writable are remembered, keyed on the serials of both caps. As the
+ * serial changes with every modification, including the ones made through
+ * structures and features handed out by the caps, and freed caps never give
+ * their serial to new caps, entries never have to be invalidated explicitly,
+ * they are just not found anymore and get replaced eventually. */
+#define CAPS_CACHE_SIZE 256
+
+typedef enum
+{
+  CAPS_CACHE_INTERSECT_ZIG_ZAG,
+  CAPS_CACHE_INTERSECT_FIRST,
+  CAPS_CACHE_CAN_INTERSECT,
+  CAPS_CACHE_IS_SUBSET,
+} GstCapsCacheOp;
+
+typedef struct
+{
+  gsize serial1;
+  gsize serial2;
+  GstCapsCacheOp op;
+
+  /* result of the intersections or of the checks */
+  GstCaps *caps;
+  gboolean result;
+} GstCapsCacheEntry;
+
+static gboolean caps_cache_enabled = FALSE;
+static gsize caps_serial = 0;
+static GMutex caps_cache_lock;
+static GstCapsCacheEntry caps_cache[CAPS_CACHE_SIZE];
+
+/* called by structures and features when they are modified, @serial points
+ * to the serial of their parent caps */
+void
+_priv_gst_caps_serial_changed (gsize * serial)
+{
+  *serial = (gsize) g_atomic_pointer_add (&caps_serial, 1) + 1;
+}
+
 static void gst_caps_transform_to_string (const GValue * src_value,
     GValue * dest_value);
 static gboolean gst_caps_from_string_inplace (GstCaps * caps,
@@ -139,6 +208,11 @@ GST_DEFINE_MINI_OBJECT_TYPE (GstCaps, gst_caps);
 void
 _priv_gst_caps_initialize (void)
 {
+  const gchar *env;
+
+  env = g_getenv ("GST_CAPS_CACHE");
+  caps_cache_enabled = env != NULL && *env != '\0' && strcmp (env, "0") != 0;
+
   _gst_caps_type = gst_caps_get_type ();
 
   _gst_caps_any = gst_caps_new_any ();
@@ -151,6 +225,13 @@ _priv_gst_caps_initialize (void)
 void
 _priv_gst_caps_cleanup (void)
 {
+  guint i;
+
+  for (i = 0; i < CAPS_CACHE_SIZE; i++) {
+    gst_caps_replace (&caps_cache[i].caps, NULL);
+    caps_cache[i].serial1 = caps_cache[i].serial2 = 0;
+  }
+
   gst_caps_unref (_gst_caps_any);
   _gst_caps_any = NULL;
   gst_caps_unref (_gst_caps_none);
@@ -239,6 +320,8 @@ gst_caps_init (GstCaps * caps)
    */
   GST_CAPS_ARRAY (caps) =
       g_array_new (FALSE, TRUE, sizeof (GstCapsArrayElement));
+  GST_CAPS_SERIAL (caps) = 0;
+  GST_CAPS_CHANGED (caps);
 }
 
 /**
@@ -494,6 +577,7 @@ gst_caps_remove_and_get_structure_and_features (GstCaps * caps, guint idx,
 
   /* don't use index_fast, gst_caps_simplify relies on the order */
   g_array_remove_index (GST_CAPS_ARRAY (caps), idx);
+  GST_CAPS_CHANGED (caps);
 
   gst_structure_set_parent_refcount (s_, NULL);
   if (f_) {
@@ -530,6 +614,7 @@ gst_caps_make_any (GstCaps * caps)
     gst_structure_free (s);
   }
   GST_CAPS_FLAGS (caps) |= GST_CAPS_FLAG_ANY;
+  GST_CAPS_CHANGED (caps);
 }
 
 /**
@@ -927,6 +1012,7 @@ gst_caps_get_features (const GstCaps * caps, guint index)
      * at the very same time */
     features = gst_caps_features_copy (GST_CAPS_FEATURES_MEMORY_SYSTEM_MEMORY);
     gst_caps_features_set_parent_refcount (features, &GST_CAPS_REFCOUNT (caps));
+    GST_CAPS_TRACK_FEATURES (caps, features);
 
     storage = gst_caps_get_features_storage_unchecked (caps, index);
     if (!g_atomic_pointer_compare_and_exchange (storage,
@@ -966,9 +1052,12 @@ gst_caps_set_features (GstCaps * caps, guint index, GstCapsFeatures * features)
   /* Not much problem here as caps are writable */
   old = g_atomic_pointer_get (storage);
   g_atomic_pointer_set (storage, features);
+  GST_CAPS_CHANGED (caps);
 
-  if (features)
+  if (features) {
     gst_caps_features_set_parent_refcount (features, &GST_CAPS_REFCOUNT (caps));
+    GST_CAPS_TRACK_FEATURES (caps, features);
+  }
 
   if (old) {
     gst_caps_features_set_parent_refcount (old, NULL);
@@ -1112,6 +1201,8 @@ gst_caps_set_value (GstCaps * caps, const char *field, const GValue * value)
   g_return_if_fail (field != NULL);
   g_return_if_fail (G_IS_VALUE (value));
 
+  GST_CAPS_CHANGED (caps);
+
   len = GST_CAPS_LEN (caps);
   for (i = 0; i < len; i++) {
     GstStructure *structure = gst_caps_get_structure_unchecked (caps, i);
@@ -1179,6 +1270,90 @@ gst_caps_set_simple (GstCaps * caps, const char *field, ...)
   va_end (var_args);
 }
 
+/* cache */
+
+/* only caps that nobody can modify anymore can be cached */
+#define CAPS_CACHEABLE(caps1, caps2)                                    \
+  (G_UNLIKELY (caps_cache_enabled) && !IS_WRITABLE (caps1) &&           \
+      !IS_WRITABLE (caps2) && GST_CAPS_SERIAL (caps1) != 0 &&           \
+      GST_CAPS_SERIAL (caps2) != 0)
+
+static inline GstCapsCacheEntry *
+caps_cache_get_entry (gsize serial1, gsize serial2, GstCapsCacheOp op)
+{
+  guint hash;
+
+  hash = (guint) (serial1 * 2654435761u) ^ (guint) (serial2 * 40503u) ^ op;
+
+  return &caps_cache[hash % CAPS_CACHE_SIZE];
+}
+
+/* Looks up the result of @op on @caps1 and @caps2, either the resulting caps
+ * in @res or the result of the check in @result. The caps in @res are a
+ * copy of the cached ones, so callers can modify them like freshly computed
+ * ones. */
+static gboolean
+caps_cache_lookup (const GstCaps * caps1, const GstCaps * caps2,
+    GstCapsCacheOp op, GstCaps ** res, gboolean * result)
+{
+  GstCapsCacheEntry *entry;
+  GstCaps *cached = NULL;
+  gsize serial1, serial2;
+  gboolean hit = FALSE;
+
+  serial1 = GST_CAPS_SERIAL (caps1);
+  serial2 = GST_CAPS_SERIAL (caps2);
+  entry = caps_cache_get_entry (serial1, serial2, op);
+
+  g_mutex_lock (&caps_cache_lock);
+  if (entry->serial1 == serial1 && entry->serial2 == serial2
+      && entry->op == op) {
+    if (res)
+      cached = gst_caps_ref (entry->caps);
+    if (result)
+      *result = entry->result;
+    hit = TRUE;
+  }
+  g_mutex_unlock (&caps_cache_lock);
+
+  /* copy outside of the lock, the cached caps are never modified */
+  if (cached) {
+    *res = gst_caps_copy (cached);
+    gst_caps_unref (cached);
+  }
+
+  GST_TRACER_CAPS_CACHE_LOOKUP (caps1, caps2, hit);
+
+  return hit;
+}
+
+static void
+caps_cache_store (const GstCaps * caps1, const GstCaps * caps2,
+    GstCapsCacheOp op, GstCaps * res, gboolean result)
+{
+  GstCapsCacheEntry *entry;
+  GstCaps *copy, *old;
+
+  /* keep our own copy, @res is returned to the caller who may modify it */
+  copy = res ? gst_caps_copy (res) : NULL;
+
+  entry = caps_cache_get_entry (GST_CAPS_SERIAL (caps1),
+      GST_CAPS_SERIAL (caps2), op);
+
+  g_mutex_lock (&caps_cache_lock);
+  old = entry->caps;
+  entry->serial1 = GST_CAPS_SERIAL (caps1);
+  entry->serial2 = GST_CAPS_SERIAL (caps2);
+  entry->op = op;
+  entry->caps = copy;
+  entry->result = result;
+  g_mutex_unlock (&caps_cache_lock);
+
+  /* the replaced entry might hold the last reference */
+  if (old)
+    gst_caps_unref (old);
+}
+
 /* tests */
 
 /**
@@ -1323,7 +1498,7 @@ gst_caps_is_subset (const GstCaps * subset, const GstCaps * superset)
 {
   GstStructure *s1, *s2;
   GstCapsFeatures *f1, *f2;
-  gboolean ret = TRUE;
+  gboolean cacheable, ret = TRUE;
   gint i, j;
 
   g_return_val_if_fail (subset != NULL, FALSE);
@@ -1334,6 +1509,11 @@ gst_caps_is_subset (const GstCaps * subset, const GstCaps * superset)
   if (CAPS_IS_ANY (subset) || CAPS_IS_EMPTY (superset))
     return FALSE;
 
+  cacheable = CAPS_CACHEABLE (subset, superset);
+  if (cacheable && caps_cache_lookup (subset, superset, CAPS_CACHE_IS_SUBSET,
+          NULL, &ret))
+    return ret;
+
   for (i = GST_CAPS_LEN (subset) - 1; i >= 0; i--) {
     s1 = gst_caps_get_structure_unchecked (subset, i);
     f1 = gst_caps_get_features_unchecked (subset, i);
@@ -1362,6 +1542,9 @@ gst_caps_is_subset (const GstCaps * subset, const GstCaps * superset)
     }
   }
 
+  if (cacheable)
+    caps_cache_store (subset, superset, CAPS_CACHE_IS_SUBSET, NULL, ret);
+
   return ret;
 }
 
@@ -1544,6 +1727,7 @@ gst_caps_can_intersect (const GstCaps * caps1, const GstCaps * caps2)
   GstStructure *struct2;
   GstCapsFeatures *features1;
   GstCapsFeatures *features2;
+  gboolean cacheable, result = FALSE;
 
   g_return_val_if_fail (GST_IS_CAPS (caps1), FALSE);
   g_return_val_if_fail (GST_IS_CAPS (caps2), FALSE);
@@ -1560,6 +1744,11 @@ gst_caps_can_intersect (const GstCaps * caps1, const GstCaps * caps2)
   if (G_UNLIKELY (CAPS_IS_ANY (caps1) || CAPS_IS_ANY (caps2)))
     return TRUE;
 
+  cacheable = CAPS_CACHEABLE (caps1, caps2);
+  if (cacheable && caps_cache_lookup (caps1, caps2, CAPS_CACHE_CAN_INTERSECT,
+          NULL, &result))
+    return result;
+
   /* run zigzag on top line then right line, this preserves the caps order
    * much better than a simple loop.
    *
@@ -1598,7 +1787,8 @@ gst_caps_can_intersect (const GstCaps * caps1, const GstCaps * caps2)
         features2 = GST_CAPS_FEATURES_MEMORY_SYSTEM_MEMORY;
       if (gst_caps_features_is_equal (features1, features2) &&
           gst_structure_can_intersect (struct1, struct2)) {
-        return TRUE;
+        result = TRUE;
+        goto done;
       }
       /* move down left */
       k++;
@@ -1608,7 +1798,11 @@ gst_caps_can_intersect (const GstCaps * caps1, const GstCaps * caps2)
     }
   }
 
-  return FALSE;
+done:
+  if (cacheable)
+    caps_cache_store (caps1, caps2, CAPS_CACHE_CAN_INTERSECT, NULL, result);
+
+  return result;
 }
 
 static GstCaps *
@@ -1755,6 +1949,10 @@ GstCaps *
 gst_caps_intersect_full (GstCaps * caps1, GstCaps * caps2,
     GstCapsIntersectMode mode)
 {
+  GstCapsCacheOp op;
+  gboolean cacheable;
+  GstCaps *res;
+
   g_return_val_if_fail (GST_IS_CAPS (caps1), NULL);
   g_return_val_if_fail (GST_IS_CAPS (caps2), NULL);
 
@@ -1774,15 +1972,28 @@ gst_caps_intersect_full (GstCaps * caps1, GstCaps * caps2,
   if (G_UNLIKELY (CAPS_IS_ANY (caps2)))
     return gst_caps_ref (caps1);
 
+  op = mode == GST_CAPS_INTERSECT_FIRST ? CAPS_CACHE_INTERSECT_FIRST :
+      CAPS_CACHE_INTERSECT_ZIG_ZAG;
+  cacheable = CAPS_CACHEABLE (caps1, caps2);
+  if (cacheable && caps_cache_lookup (caps1, caps2, op, &res, NULL))
+    return res;
+
   switch (mode) {
     case GST_CAPS_INTERSECT_FIRST:
-      return gst_caps_intersect_first (caps1, caps2);
+      res = gst_caps_intersect_first (caps1, caps2);
+      break;
     default:
       g_warning ("Unknown caps intersect mode: %d", mode);
       /* fallthrough */
     case GST_CAPS_INTERSECT_ZIG_ZAG:
-      return gst_caps_intersect_zig_zag (caps1, caps2);
+      res = gst_caps_intersect_zig_zag (caps1, caps2);
+      break;
   }
+
+  if (cacheable)
+    caps_cache_store (caps1, caps2, op, res, FALSE);
+
+  return res;
 }
 
 /**
@@ -2021,6 +2232,7 @@ gst_caps_normalize (GstCaps * caps)
   g_return_val_if_fail (GST_IS_CAPS (caps), NULL);
 
   caps = gst_caps_make_writable (caps);
+  GST_CAPS_CHANGED (caps);
   nf.caps = caps;
 
   for (i = 0; i < gst_caps_get_size (nf.caps); i++) {
@@ -2153,6 +2365,7 @@ gst_caps_switch_structures (GstCaps * caps, GstStructure * old,
   gst_structure_set_parent_refcount (old, NULL);
   gst_structure_free (old);
   gst_structure_set_parent_refcount (new, &GST_CAPS_REFCOUNT (caps));
+  GST_CAPS_TRACK_STRUCTURE (caps, new);
   g_array_index (GST_CAPS_ARRAY (caps), GstCapsArrayElement, i).structure = new;
 }
 
@@ -2192,6 +2405,7 @@ gst_caps_simplify (GstCaps * caps)
     return caps;
 
   caps = gst_caps_make_writable (caps);
+  GST_CAPS_CHANGED (caps);
 
   g_array_sort (GST_CAPS_ARRAY (caps), gst_caps_compare_structures);
 
@@ -2617,6 +2831,8 @@ gst_caps_map_in_place (GstCaps * caps, GstCapsMapFunc func, gpointer user_data)
   g_return_val_if_fail (gst_caps_is_writable (caps), FALSE);
   g_return_val_if_fail (func != NULL, FALSE);
 
+  GST_CAPS_CHANGED (caps);
+
   n = GST_CAPS_LEN (caps);
 
   for (i = 0; i < n; i++) {
@@ -2666,6 +2882,8 @@ gst_caps_filter_and_map_in_place (GstCaps * caps, GstCapsFilterMapFunc func,
   g_return_if_fail (gst_caps_is_writable (caps));
   g_return_if_fail (func != NULL);
 
+  GST_CAPS_CHANGED (caps);
+
   n = GST_CAPS_LEN (caps);
 
   for (i = 0; i < n;) {
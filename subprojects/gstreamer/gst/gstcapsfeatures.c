@@ -62,6 +62,8 @@ struct _GstCapsFeatures
 {
   GType type;
   gint *parent_refcount;
+  /* serial of the parent caps that changes with the features */
+  gsize *parent_serial;
   GArray *array;
   gboolean is_any;
 };
@@ -75,6 +77,12 @@ static GQuark _gst_caps_feature_memory_system_memory = 0;
 G_DEFINE_BOXED_TYPE (GstCapsFeatures, gst_caps_features,
     gst_caps_features_copy, gst_caps_features_free);
 
+/* must be called for every modification, see gststructure.c */
+#define GST_CAPS_FEATURES_CHANGED(f) G_STMT_START{                      \
+  if (G_UNLIKELY ((f)->parent_serial))                                  \
+    _priv_gst_caps_serial_changed ((f)->parent_serial);                 \
+}G_STMT_END
+
 #define IS_MUTABLE(features) \
     (!features->parent_refcount || \
      g_atomic_int_get (features->parent_refcount) == 1)
@@ -183,6 +191,7 @@ gst_caps_features_new_empty (void)
   features = g_slice_new (GstCapsFeatures);
   features->type = _gst_caps_features_type;
   features->parent_refcount = NULL;
+  features->parent_serial = NULL;
   features->array = g_array_new (FALSE, FALSE, sizeof (GQuark));
   features->is_any = FALSE;
 
@@ -379,10 +388,21 @@ gst_caps_features_set_parent_refcount (GstCapsFeatures * features,
   }
 
   features->parent_refcount = refcount;
+  if (refcount == NULL)
+    features->parent_serial = NULL;
 
   return TRUE;
 }
 
+/* Makes modifications of @features change the caps serial at @serial, until
+ * the parent refcount is reset */
+void
+_priv_gst_caps_features_set_parent_serial (GstCapsFeatures * features,
+    gsize * serial)
+{
+  features->parent_serial = serial;
+}
+
 /**
  * gst_caps_features_copy:
  * @features: a #GstCapsFeatures to duplicate
@@ -818,6 +838,7 @@ gst_caps_features_add_id (GstCapsFeatures * features, GQuark feature)
       && gst_caps_features_contains_id (features, feature))
     return;
 
+  GST_CAPS_FEATURES_CHANGED (features);
   g_array_append_val (features->array, feature);
 }
 
@@ -863,6 +884,7 @@ gst_caps_features_remove_id (GstCapsFeatures * features, GQuark feature)
     GQuark quark = gst_caps_features_get_nth_id (features, i);
 
     if (quark == feature) {
+      GST_CAPS_FEATURES_CHANGED (features);
       g_array_remove_index_fast (features->array, i);
       return;
     }
@@ -138,6 +138,11 @@ gst_device_provider_factory_cleanup (GstDeviceProviderFactory * factory)
     gst_structure_free ((GstStructure *) factory->metadata);
     factory->metadata = NULL;
   }
+  factory->metadata_str = NULL;
+  if (factory->cache) {
+    g_bytes_unref (factory->cache);
+    factory->cache = NULL;
+  }
   if (factory->type) {
     factory->type = G_TYPE_INVALID;
   }
@@ -403,6 +408,38 @@ gst_device_provider_factory_get_device_provider_type (GstDeviceProviderFactory *
   return factory->type;
 }
 
+/* the metadata of factories loaded from the registry cache is deserialized
+ * when it is first needed */
+static GstStructure *
+gst_device_provider_factory_ensure_metadata (GstDeviceProviderFactory *
+    factory)
+{
+  GstStructure *metadata;
+
+  metadata = g_atomic_pointer_get (&factory->metadata);
+  if (G_LIKELY (metadata != NULL || factory->metadata_str == NULL))
+    return metadata;
+
+  if (g_atomic_int_get (&factory->metadata_invalid))
+    return NULL;
+
+  metadata = gst_structure_from_string (factory->metadata_str, NULL);
+  if (G_UNLIKELY (metadata == NULL)) {
+    GST_ERROR_OBJECT (factory, "Error when trying to deserialize structure "
+        "for metadata '%s'", factory->metadata_str);
+    g_atomic_int_set (&factory->metadata_invalid, TRUE);
+    return NULL;
+  }
+
+  if (!g_atomic_pointer_compare_and_exchange (&factory->metadata, NULL,
+          metadata)) {
+    gst_structure_free (metadata);
+    metadata = g_atomic_pointer_get (&factory->metadata);
+  }
+
+  return metadata;
+}
+
 /**
  * gst_device_provider_factory_get_metadata:
  * @factory: a #GstDeviceProviderFactory
@@ -419,7 +456,8 @@ const gchar *
 gst_device_provider_factory_get_metadata (GstDeviceProviderFactory * factory,
     const gchar * key)
 {
-  return gst_structure_get_string ((GstStructure *) factory->metadata, key);
+  return gst_structure_get_string (gst_device_provider_factory_ensure_metadata
+      (factory), key);
 }
 
 /**
@@ -444,7 +482,7 @@ gst_device_provider_factory_get_metadata_keys (GstDeviceProviderFactory *
 
   g_return_val_if_fail (GST_IS_DEVICE_PROVIDER_FACTORY (factory), NULL);
 
-  metadata = (GstStructure *) factory->metadata;
+  metadata = gst_device_provider_factory_ensure_metadata (factory);
   if (metadata == NULL)
     return NULL;
 
@@ -2175,6 +2175,52 @@ gst_element_post_message (GstElement * element, GstMessage * message)
   return res;
 }
 
+/**
+ * gst_element_is_message_wanted:
+ * @element: a #GstElement
+ * @type: the #GstMessageType of a message @element could post
+ *
+ * Checks whether a message of @type posted by @element would reach the
+ * application, based on the interest mask of the bus of the toplevel
+ * element, see gst_bus_set_interest_mask(). Elements can use this to skip
+ * creating informational messages, like QoS, buffering or element messages,
+ * that nobody handles.
+ *
+ * Messages that are handled by #GstBin itself should always be posted.
+ *
+ * Returns: %FALSE if a message of @type would be dropped.
+ *
+ * MT safe.
+ *
+ * Since: 1.24
+ */
+gboolean
+gst_element_is_message_wanted (GstElement * element, GstMessageType type)
+{
+  GstObject *toplevel, *parent;
+  GstBus *bus = NULL;
+  gboolean res = TRUE;
+
+  g_return_val_if_fail (GST_IS_ELEMENT (element), FALSE);
+
+  toplevel = gst_object_ref (element);
+  while ((parent = gst_object_get_parent (toplevel))) {
+    gst_object_unref (toplevel);
+    toplevel = parent;
+  }
+
+  if (GST_IS_ELEMENT (toplevel))
+    bus = gst_element_get_bus (GST_ELEMENT_CAST (toplevel));
+
+  if (bus) {
+    res = _priv_gst_bus_wants_message_type (bus, type);
+    gst_object_unref (bus);
+  }
+  gst_object_unref (toplevel);
+
+  return res;
+}
+
 /**
  * _gst_element_error_printf:
  * @format: (allow-none): the printf-like format to use, or %NULL
@@ -1106,6 +1106,9 @@ gboolean                gst_element_query               (GstElement *element, Gs
 GST_API
 gboolean                gst_element_post_message        (GstElement * element, GstMessage * message);
 
+GST_API
+gboolean                gst_element_is_message_wanted   (GstElement * element, GstMessageType type);
+
 /* error handling */
 /* gcc versions < 3.3 warn about NULL being passed as format to printf */
 #if (!defined(__GNUC__) || (__GNUC__ < 3) || (__GNUC__ == 3 && __GNUC_MINOR__ < 3))
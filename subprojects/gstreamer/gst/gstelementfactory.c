@@ -155,6 +155,7 @@ gst_element_factory_cleanup (GstElementFactory * factory)
     gst_structure_free ((GstStructure *) factory->metadata);
     factory->metadata = NULL;
   }
+  factory->metadata_str = NULL;
   if (factory->type) {
     factory->type = G_TYPE_INVALID;
   }
@@ -168,6 +169,12 @@ gst_element_factory_cleanup (GstElementFactory * factory)
   g_list_free (factory->staticpadtemplates);
   factory->staticpadtemplates = NULL;
   factory->numpadtemplates = 0;
+
+  /* nothing points into the registry cache anymore */
+  if (factory->cache) {
+    g_bytes_unref (factory->cache);
+    factory->cache = NULL;
+  }
   factory->uri_type = GST_URI_UNKNOWN;
   if (factory->uri_protocols) {
     g_strfreev (factory->uri_protocols);
@@ -857,6 +864,38 @@ gst_element_factory_get_element_type (GstElementFactory * factory)
   return factory->type;
 }
 
+/* Factories loaded from the registry cache only deserialize their metadata
+ * when it is first needed. Concurrent callers might both parse it, only the
+ * first result is kept. */
+static GstStructure *
+gst_element_factory_ensure_metadata (GstElementFactory * factory)
+{
+  GstStructure *metadata;
+
+  metadata = g_atomic_pointer_get (&factory->metadata);
+  if (G_LIKELY (metadata != NULL || factory->metadata_str == NULL))
+    return metadata;
+
+  if (g_atomic_int_get (&factory->metadata_invalid))
+    return NULL;
+
+  metadata = gst_structure_from_string (factory->metadata_str, NULL);
+  if (G_UNLIKELY (metadata == NULL)) {
+    GST_ERROR_OBJECT (factory, "Error when trying to deserialize structure "
+        "for metadata '%s'", factory->metadata_str);
+    g_atomic_int_set (&factory->metadata_invalid, TRUE);
+    return NULL;
+  }
+
+  if (!g_atomic_pointer_compare_and_exchange (&factory->metadata, NULL,
+          metadata)) {
+    gst_structure_free (metadata);
+    metadata = g_atomic_pointer_get (&factory->metadata);
+  }
+
+  return metadata;
+}
+
 /**
  * gst_element_factory_get_metadata:
  * @factory: a #GstElementFactory
@@ -873,7 +912,8 @@ gst_element_factory_get_metadata (GstElementFactory * factory,
 {
   g_return_val_if_fail (GST_IS_ELEMENT_FACTORY (factory), NULL);
 
-  return gst_structure_get_string ((GstStructure *) factory->metadata, key);
+  return gst_structure_get_string (gst_element_factory_ensure_metadata
+      (factory), key);
 }
 
 /**
@@ -895,7 +935,7 @@ gst_element_factory_get_metadata_keys (GstElementFactory * factory)
 
   g_return_val_if_fail (GST_IS_ELEMENT_FACTORY (factory), NULL);
 
-  metadata = (GstStructure *) factory->metadata;
+  metadata = gst_element_factory_ensure_metadata (factory);
   if (metadata == NULL)
     return NULL;
 
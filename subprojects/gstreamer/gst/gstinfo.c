@@ -3766,6 +3766,483 @@ gst_debug_remove_ring_buffer_logger (void)
   gst_debug_remove_log_function (gst_ring_buffer_logger_log);
 }
 
+/* The flight recorder keeps the messages of each thread in a ring that only
+ * this thread writes to, so logging takes no lock. Messages are not formatted
+ * when they are logged: the format string is stored together with a copy of
+ * the arguments and the message is only formatted when the logs are fetched.
+ *
+ * Readers copy a ring while its thread keeps on writing and then only use the
+ * part of the copy that was not overwritten in the meantime, including the
+ * space reserved for a record that is being written. Every record ends
+ * with its size so the complete records can be found going backwards from the
+ * end. */
+#define FLIGHT_RECORDER_MIN_SIZE 4096
+#define FLIGHT_RECORDER_MAX_ARGS_SIZE 1024
+
+typedef struct
+{
+  /* size of the whole record, including the size at the end */
+  guint32 size;
+  guint16 level;
+  /* if the data is the formatted message instead of the arguments */
+  guint16 formatted;
+  gint line;
+  GstClockTime ts;
+  GstDebugCategory *category;
+  const gchar *file;
+  const gchar *function;
+  const gchar *format;
+  guint32 id_len;
+  guint32 data_len;
+  /* followed by the object id, the data and the size */
+} GstFlightRecord;
+
+typedef struct
+{
+  GThread *thread;
+  /* the thread is gone, a new thread can take over the ring */
+  gboolean retired;
+  /* the flight recorder this ring belongs to */
+  guint generation;
+
+  gsize size;
+  /* number of bytes written and reserved so far, only modified by the
+   * owning thread */
+  gsize written;
+  gsize reserved;
+  guint8 *data;
+} GstFlightRing;
+
+typedef struct
+{
+  GThread *thread;
+  guint8 *data;
+  gsize len;
+} GstFlightSnapshot;
+
+/* The reservation must be visible before the record data is written, and a
+ * reader must have copied the data before it checks the reservation again,
+ * otherwise weakly ordered CPUs can make it accept a record that is being
+ * overwritten. The atomic set and get only order the accesses on their other
+ * side. */
+#if defined (__GNUC__) || defined (__clang__)
+#define FLIGHT_RING_WRITE_BARRIER() __atomic_thread_fence (__ATOMIC_RELEASE)
+#define FLIGHT_RING_READ_BARRIER() __atomic_thread_fence (__ATOMIC_ACQUIRE)
+#else
+/* atomic read-modify-write operations are full barriers */
+static gint flight_ring_barrier;
+#define FLIGHT_RING_WRITE_BARRIER() g_atomic_int_add (&flight_ring_barrier, 0)
+#define FLIGHT_RING_READ_BARRIER() g_atomic_int_add (&flight_ring_barrier, 0)
+#endif
+
+static GMutex flight_recorder_lock;
+/* size of the rings, 0 when the flight recorder is not active */
+static gsize flight_recorder_size = 0;
+/* changed whenever the flight recorder is added or removed, rings of another
+ * generation are not in the list anymore and only owned by their thread */
+static guint flight_recorder_generation = 0;
+static GList *flight_recorder_rings = NULL;
+
+static void flight_ring_retire (gpointer data);
+static GPrivate flight_ring = G_PRIVATE_INIT (flight_ring_retire);
+
+static void
+flight_ring_free (GstFlightRing * ring)
+{
+  g_free (ring->data);
+  g_free (ring);
+}
+
+/* called when the owning thread exits */
+static void
+flight_ring_retire (gpointer data)
+{
+  GstFlightRing *ring = data;
+
+  g_mutex_lock (&flight_recorder_lock);
+  if (flight_recorder_size != 0
+      && ring->generation == flight_recorder_generation) {
+    /* keep the logs of the thread until another thread needs a ring */
+    ring->retired = TRUE;
+    ring = NULL;
+  }
+  g_mutex_unlock (&flight_recorder_lock);
+
+  if (ring)
+    flight_ring_free (ring);
+}
+
+static GstFlightRing *
+flight_ring_get (void)
+{
+  GstFlightRing *ring, *old;
+  GList *l;
+
+  ring = g_private_get (&flight_ring);
+  if (G_LIKELY (ring != NULL && ring->generation ==
+          (guint) g_atomic_int_get (&flight_recorder_generation)))
+    return ring;
+
+  /* the ring of this thread, if any, belongs to a flight recorder that was
+   * removed since and is not in the list anymore */
+  old = ring;
+
+  g_mutex_lock (&flight_recorder_lock);
+  if (flight_recorder_size == 0) {
+    g_mutex_unlock (&flight_recorder_lock);
+    if (old) {
+      g_private_set (&flight_ring, NULL);
+      flight_ring_free (old);
+    }
+    return NULL;
+  }
+
+  ring = NULL;
+  for (l = flight_recorder_rings; l; l = l->next) {
+    GstFlightRing *retired = l->data;
+
+    if (retired->retired) {
+      ring = retired;
+      break;
+    }
+  }
+
+  if (ring) {
+    ring->retired = FALSE;
+    ring->written = ring->reserved = 0;
+  } else {
+    ring = g_new0 (GstFlightRing, 1);
+    ring->generation = flight_recorder_generation;
+    ring->size = flight_recorder_size;
+    ring->data = g_malloc (ring->size);
+    flight_recorder_rings = g_list_prepend (flight_recorder_rings, ring);
+  }
+  ring->thread = g_thread_self ();
+  g_mutex_unlock (&flight_recorder_lock);
+
+  g_private_set (&flight_ring, ring);
+  if (old)
+    flight_ring_free (old);
+
+  return ring;
+}
+
+static inline void
+flight_ring_write (GstFlightRing * ring, gsize pos, gconstpointer data,
+    gsize len)
+{
+  gsize offset = pos & (ring->size - 1);
+  gsize first = MIN (len, ring->size - offset);
+
+  memcpy (ring->data + offset, data, first);
+  memcpy (ring->data, (const guint8 *) data + first, len - first);
+}
+
+static void
+gst_flight_recorder_log (GstDebugCategory * category, GstDebugLevel level,
+    const gchar * file, const gchar * function, gint line, GObject * object,
+    GstDebugMessage * message, gpointer user_data)
+{
+  GstFlightRing *ring;
+  GstFlightRecord record;
+  gchar args[FLIGHT_RECORDER_MAX_ARGS_SIZE];
+  const gchar *object_id, *data = args;
+  gint len = -1;
+  gsize pos;
+
+  ring = flight_ring_get ();
+  if (G_UNLIKELY (ring == NULL))
+    return;
+
+  record.formatted = FALSE;
+  record.format = NULL;
+
+  if (message->message == NULL) {
+    va_list arguments;
+
+    G_VA_COPY (arguments, message->arguments);
+    len = __gst_vcapture_args (args, sizeof (args), message->format,
+        arguments);
+    va_end (arguments);
+    record.format = message->format;
+  }
+
+  if (len < 0 || (gsize) len > sizeof (args)) {
+    /* literal messages, messages that were formatted already for another
+     * log function, and arguments that don't fit */
+    data = gst_debug_message_get (message);
+    if (data == NULL)
+      return;
+    len = strlen (data) + 1;
+    record.formatted = TRUE;
+    record.format = NULL;
+  }
+
+  object_id = gst_debug_message_get_id (message);
+
+  record.id_len = object_id ? strlen (object_id) + 1 : 0;
+  record.data_len = len;
+  record.size = GST_ROUND_UP_8 (sizeof (record) + record.id_len +
+      record.data_len + sizeof (guint32));
+  /* would overwrite too much of the history */
+  if (record.size > ring->size / 2)
+    return;
+
+  record.level = level;
+  record.line = line;
+  record.ts = GST_CLOCK_DIFF (_priv_gst_start_time, gst_util_get_timestamp ());
+  record.category = category;
+  record.file = file;
+  record.function = function;
+
+  pos = ring->written;
+  g_atomic_pointer_set (&ring->reserved, pos + record.size);
+  FLIGHT_RING_WRITE_BARRIER ();
+
+  flight_ring_write (ring, pos, &record, sizeof (record));
+  pos += sizeof (record);
+  if (object_id) {
+    flight_ring_write (ring, pos, object_id, record.id_len);
+    pos += record.id_len;
+  }
+  flight_ring_write (ring, pos, data, record.data_len);
+  flight_ring_write (ring, ring->written + record.size - sizeof (guint32),
+      &record.size, sizeof (guint32));
+
+  /* publish the record */
+  g_atomic_pointer_set (&ring->written, ring->written + record.size);
+}
+
+/* copies the part of the ring that has complete records */
+static void
+flight_ring_snapshot (GstFlightRing * ring, GstFlightSnapshot * snapshot)
+{
+  gsize start, end, valid, offset, first;
+
+  end = g_atomic_pointer_get (&ring->written);
+  start = end - MIN (end, ring->size);
+
+  snapshot->thread = ring->thread;
+  snapshot->len = end - start;
+  snapshot->data = g_malloc (snapshot->len);
+
+  offset = start & (ring->size - 1);
+  first = MIN (snapshot->len, ring->size - offset);
+  memcpy (snapshot->data, ring->data + offset, first);
+  memcpy (snapshot->data + first, ring->data, snapshot->len - first);
+
+  /* the thread might have overwritten the oldest records while copying */
+  FLIGHT_RING_READ_BARRIER ();
+  valid = g_atomic_pointer_get (&ring->reserved);
+  valid -= MIN (valid, ring->size);
+  if (valid > start) {
+    offset = MIN (valid - start, snapshot->len);
+    memmove (snapshot->data, snapshot->data + offset, snapshot->len - offset);
+    snapshot->len -= offset;
+  }
+}
+
+static gchar *
+flight_snapshot_format (GstFlightSnapshot * snapshot, GstClockTime min_ts)
+{
+  GArray *offsets;
+  GString *str;
+  gsize pos = snapshot->len;
+  guint i;
+
+  /* find the complete records, going backwards from the newest */
+  offsets = g_array_new (FALSE, FALSE, sizeof (gsize));
+  while (pos >= sizeof (GstFlightRecord) + sizeof (guint32)) {
+    guint32 size;
+
+    memcpy (&size, snapshot->data + pos - sizeof (guint32), sizeof (guint32));
+    if (size > pos || size < sizeof (GstFlightRecord) + sizeof (guint32))
+      break;
+    pos -= size;
+    g_array_append_val (offsets, pos);
+  }
+
+  str = g_string_new (NULL);
+  for (i = offsets->len; i > 0; i--) {
+    GstFlightRecord record;
+    const gchar *object_id, *data, *file;
+    gchar *message = NULL;
+    gchar c;
+
+    pos = g_array_index (offsets, gsize, i - 1);
+    memcpy (&record, snapshot->data + pos, sizeof (record));
+    if (record.ts < min_ts)
+      continue;
+
+    object_id = record.id_len ?
+        (const gchar *) snapshot->data + pos + sizeof (record) : NULL;
+    data = (const gchar *) snapshot->data + pos + sizeof (record) +
+        record.id_len;
+
+    if (record.formatted) {
+      message = g_strdup (data);
+    } else if (__gst_asprintf_captured (&message, record.format, data,
+            record.data_len) < 0) {
+      message = g_strdup (record.format);
+    }
+
+    /* same as in gst_debug_log_get_line() */
+    file = record.file;
+    c = file[0];
+    if (c == '.' || c == '/' || c == '\\' || (c != '\0' && file[1] == ':'))
+      file = gst_path_basename (file);
+
+    if (object_id) {
+      g_string_append_printf (str, "%" GST_TIME_FORMAT NOCOLOR_PRINT_FMT_ID,
+          GST_TIME_ARGS (record.ts), _gst_getpid (), snapshot->thread,
+          gst_debug_level_get_name (record.level),
+          gst_debug_category_get_name (record.category), file, record.line,
+          record.function, object_id, message);
+    } else {
+      g_string_append_printf (str, "%" GST_TIME_FORMAT NOCOLOR_PRINT_FMT,
+          GST_TIME_ARGS (record.ts), _gst_getpid (), snapshot->thread,
+          gst_debug_level_get_name (record.level),
+          gst_debug_category_get_name (record.category), file, record.line,
+          record.function, "", message);
+    }
+    g_free (message);
+  }
+  g_array_free (offsets, TRUE);
+
+  return g_string_free (str, FALSE);
+}
+
+/**
+ * gst_debug_flight_recorder_get_logs:
+ * @max_age: only return messages that are at most this old, in nanoseconds,
+ *     or %GST_CLOCK_TIME_NONE for all messages
+ *
+ * Formats the messages that are currently in the flight recorder. See
+ * gst_debug_add_flight_recorder() for details.
+ *
+ * Returns: (transfer full) (array zero-terminated=1): %NULL-terminated array of
+ * strings with the debug output per thread
+ *
+ * Since: 1.24
+ */
+gchar **
+gst_debug_flight_recorder_get_logs (guint64 max_age)
+{
+  GstFlightSnapshot *snapshots;
+  GstClockTime now, min_ts = 0;
+  gchar **logs;
+  guint i, n;
+  GList *l;
+
+  now = GST_CLOCK_DIFF (_priv_gst_start_time, gst_util_get_timestamp ());
+  if (GST_CLOCK_TIME_IS_VALID (max_age) && max_age < now)
+    min_ts = now - max_age;
+
+  g_mutex_lock (&flight_recorder_lock);
+  if (flight_recorder_size == 0) {
+    g_mutex_unlock (&flight_recorder_lock);
+    g_return_val_if_reached (NULL);
+  }
+
+  n = g_list_length (flight_recorder_rings);
+  snapshots = g_new (GstFlightSnapshot, n);
+  for (l = flight_recorder_rings, i = 0; l; l = l->next, i++)
+    flight_ring_snapshot (l->data, &snapshots[i]);
+  g_mutex_unlock (&flight_recorder_lock);
+
+  /* formatting only needs the copies */
+  logs = g_new0 (gchar *, n + 1);
+  for (i = 0; i < n; i++) {
+    logs[i] = flight_snapshot_format (&snapshots[i], min_ts);
+    g_free (snapshots[i].data);
+  }
+  g_free (snapshots);
+
+  return logs;
+}
+
+static void
+gst_flight_recorder_free (gpointer data)
+{
+  GList *l;
+
+  g_mutex_lock (&flight_recorder_lock);
+  flight_recorder_size = 0;
+  g_atomic_int_inc (&flight_recorder_generation);
+
+  /* the rings of running threads are freed by the threads themselves */
+  for (l = flight_recorder_rings; l; l = l->next) {
+    GstFlightRing *ring = l->data;
+
+    if (ring->retired)
+      flight_ring_free (ring);
+  }
+  g_list_free (flight_recorder_rings);
+  flight_recorder_rings = NULL;
+  g_mutex_unlock (&flight_recorder_lock);
+}
+
+/**
+ * gst_debug_add_flight_recorder:
+ * @max_size_per_thread: Maximum size of log per thread in bytes
+ *
+ * Adds a debug logger that keeps the most recent messages of each thread in
+ * memory, up to @max_size_per_thread bytes per thread.
+ *
+ * Unlike the ring buffer logger, messages are not formatted when they are
+ * logged. The format and a copy of the arguments are stored instead, without
+ * taking any lock, and the messages are only formatted when they are fetched
+ * with gst_debug_flight_recorder_get_logs(). This makes it cheap enough to
+ * keep a high debug level enabled all the time, for example after removing
+ * the default log function, and to look at the last seconds of logs when
+ * something went wrong.
+ *
+ * Objects printed with %GST_PTR_FORMAT are still converted to strings when
+ * they are logged, as they might be gone later. The format strings have to
+ * stay valid as long as the flight recorder exists, which is the case for the
+ * string literals used with the GST_DEBUG() family of macros.
+ *
+ * The logger can be removed again with gst_debug_remove_flight_recorder().
+ * Only one flight recorder at a time is possible.
+ *
+ * Since: 1.24
+ */
+void
+gst_debug_add_flight_recorder (guint max_size_per_thread)
+{
+  gsize size = FLIGHT_RECORDER_MIN_SIZE;
+
+  /* a power of two, so that offsets stay valid when wrapping around */
+  while (size < max_size_per_thread)
+    size <<= 1;
+
+  g_mutex_lock (&flight_recorder_lock);
+  if (flight_recorder_size != 0) {
+    g_mutex_unlock (&flight_recorder_lock);
+    g_warn_if_reached ();
+    return;
+  }
+  flight_recorder_size = size;
+  g_atomic_int_inc (&flight_recorder_generation);
+  g_mutex_unlock (&flight_recorder_lock);
+
+  gst_debug_add_log_function (gst_flight_recorder_log, NULL,
+      gst_flight_recorder_free);
+}
+
+/**
+ * gst_debug_remove_flight_recorder:
+ *
+ * Removes the flight recorder added with gst_debug_add_flight_recorder().
+ *
+ * Since: 1.24
+ */
+void
+gst_debug_remove_flight_recorder (void)
+{
+  gst_debug_remove_log_function (gst_flight_recorder_log);
+}
+
 #else /* GST_DISABLE_GST_DEBUG */
 #ifndef GST_REMOVE_DISABLED
 
@@ -3786,5 +4263,21 @@ gst_debug_remove_ring_buffer_logger (void)
 {
 }
 
+gchar **
+gst_debug_flight_recorder_get_logs (guint64 max_age)
+{
+  return NULL;
+}
+
+void
+gst_debug_add_flight_recorder (guint max_size_per_thread)
+{
+}
+
+void
+gst_debug_remove_flight_recorder (void)
+{
+}
+
 #endif /* GST_REMOVE_DISABLED */
 #endif /* GST_DISABLE_GST_DEBUG */
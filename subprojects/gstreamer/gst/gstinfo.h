@@ -2163,6 +2163,13 @@ void                  gst_debug_remove_ring_buffer_logger   (void);
 GST_API
 gchar **              gst_debug_ring_buffer_logger_get_logs (void);
 
+GST_API
+void                  gst_debug_add_flight_recorder         (guint max_size_per_thread);
+GST_API
+void                  gst_debug_remove_flight_recorder      (void);
+GST_API
+gchar **              gst_debug_flight_recorder_get_logs    (guint64 max_age);
+
 G_END_DECLS
 
 #endif /* __GSTINFO_H__ */
@@ -141,6 +141,12 @@ struct _GstPadPrivate
   gint using;
   guint probe_list_cookie;
 
+  /* peer that gst_pad_push() hands data to without taking the object lock
+   * while there are no probes and no pending events. It holds a ref that
+   * moves to stale_peer on unlink until the last thread stops using it */
+  GstPad *fast_peer;
+  GstPad *stale_peer;
+
   /* counter of how many idle probes are running directly from the add_probe
    * call. Used to block any data flowing in the pad while the idle callback
    * Doesn't finish its work */
@@ -703,6 +709,40 @@ get_pad_caps (GstPad * pad)
   return caps;
 }
 
+/* called with the object lock after a thread stopped using @pad. Releases
+ * the peer the fast push path used before the pad was unlinked once no
+ * thread can be pushing to it anymore. It is not linked to us anymore so
+ * it won't take our lock if this was the last ref. */
+static inline void
+gst_pad_drop_stale_peer (GstPad * pad)
+{
+  GstPad *peer = pad->priv->stale_peer;
+
+  if (G_UNLIKELY (peer != NULL)
+      && g_atomic_int_get (&pad->priv->using) == 0) {
+    g_atomic_pointer_set (&pad->priv->stale_peer, NULL);
+    gst_object_unref (peer);
+  }
+}
+
+/* called with the object lock when the peer of @pad goes away or @pad is
+ * deactivated, makes gst_pad_push() take the slow path again */
+static void
+gst_pad_reset_fast_peer (GstPad * pad)
+{
+  GstPad *peer = pad->priv->fast_peer;
+
+  if (peer == NULL)
+    return;
+
+  /* threads that are pushing right now still use the old peer, the ordering
+   * of these against the using count of gst_pad_push_data() makes sure the
+   * last of them will see it */
+  g_atomic_pointer_set (&pad->priv->fast_peer, NULL);
+  g_atomic_pointer_set (&pad->priv->stale_peer, peer);
+  gst_pad_drop_stale_peer (pad);
+}
+
 static void
 gst_pad_dispose (GObject * object)
 {
@@ -747,6 +787,11 @@ gst_pad_finalize (GObject * object)
     gst_object_unref (task);
   }
 
+  if (pad->priv->fast_peer)
+    gst_object_unref (pad->priv->fast_peer);
+  if (pad->priv->stale_peer)
+    gst_object_unref (pad->priv->stale_peer);
+
   if (pad->activatenotify)
     pad->activatenotify (pad->activatedata);
   if (pad->activatemodenotify)
@@ -989,6 +1034,7 @@ pre_activate (GstPad * pad, GstPadMode new_mode)
       GST_PAD_SET_FLUSHING (pad);
       pad->ABI.abi.last_flowret = GST_FLOW_FLUSHING;
       GST_PAD_MODE (pad) = new_mode;
+      gst_pad_reset_fast_peer (pad);
       /* unlock blocked pads so element can resume and stop */
       GST_PAD_BLOCK_BROADCAST (pad);
       GST_OBJECT_UNLOCK (pad);
@@ -1398,7 +1444,7 @@ cleanup_hook (GstPad * pad, GHook * hook)
     }
   }
   g_hook_destroy_link (&pad->probes, hook);
-  pad->num_probes--;
+  g_atomic_int_add (&pad->num_probes, -1);
 }
 
 /**
@@ -1461,7 +1507,9 @@ gst_pad_add_probe (GstPad * pad, GstPadProbeType mask,
 
   /* add the probe */
   g_hook_append (&pad->probes, hook);
-  pad->num_probes++;
+  /* must be visible to the fast path of gst_pad_push_data() before we look
+   * at the using count below */
+  g_atomic_int_inc (&pad->num_probes);
   /* incremenent cookie so that the new hook gets called */
   pad->priv->probe_list_cookie++;
 
@@ -1484,7 +1532,7 @@ gst_pad_add_probe (GstPad * pad, GstPadProbeType mask,
 
   /* call the callback if we need to be called for idle callbacks */
   if ((mask & GST_PAD_PROBE_TYPE_IDLE) && (callback != NULL)) {
-    if (pad->priv->using > 0) {
+    if (g_atomic_int_get (&pad->priv->using) > 0) {
       /* the pad is in use, we can't signal the idle callback yet. Since we set the
        * flag above, the last thread to leave the push will do the callback. New
        * threads going into the push will block. */
@@ -2185,6 +2233,7 @@ no_sink_parent:
   /* first clear peers */
   GST_PAD_PEER (srcpad) = NULL;
   GST_PAD_PEER (sinkpad) = NULL;
+  gst_pad_reset_fast_peer (srcpad);
 
   GST_OBJECT_UNLOCK (sinkpad);
   GST_OBJECT_UNLOCK (srcpad);
@@ -2629,6 +2678,7 @@ link_failed:
 
     GST_PAD_PEER (srcpad) = NULL;
     GST_PAD_PEER (sinkpad) = NULL;
+    gst_pad_reset_fast_peer (srcpad);
 
     GST_OBJECT_UNLOCK (sinkpad);
     GST_OBJECT_UNLOCK (srcpad);
@@ -4677,6 +4727,55 @@ gst_pad_chain_list (GstPad * pad, GstBufferList * list)
       GST_PAD_PROBE_TYPE_BUFFER_LIST | GST_PAD_PROBE_TYPE_PUSH, list);
 }
 
+#ifndef GST_ENABLE_EXTRA_CHECKS
+/* pad flags that make gst_pad_push_data() take the object lock */
+#define FAST_PUSH_SLOW_FLAGS \
+    (GST_PAD_FLAG_FLUSHING | GST_PAD_FLAG_EOS | GST_PAD_FLAG_PENDING_EVENTS)
+
+#define FAST_PUSH_POSSIBLE(pad) \
+    (g_atomic_pointer_get (&(pad)->priv->fast_peer) != NULL && \
+     g_atomic_int_get (&(pad)->num_probes) == 0 && \
+     (GST_OBJECT_FLAGS (pad) & FAST_PUSH_SLOW_FLAGS) == 0)
+
+/* the fast path doesn't hold the object lock that protects last_flowret */
+#define FAST_PUSH_SET_LAST_FLOWRET(pad, ret) \
+    g_atomic_int_set ((gint *) &(pad)->ABI.abi.last_flowret, (gint) (ret))
+
+/* the last thread left the fast path of gst_pad_push_data() while probes
+ * were added or the pad was unlinked */
+static GstFlowReturn
+gst_pad_fast_push_done (GstPad * pad, GstFlowReturn ret)
+{
+  GST_OBJECT_LOCK (pad);
+  gst_pad_drop_stale_peer (pad);
+  if (g_atomic_int_get (&pad->priv->using) == 0) {
+    /* pad is not active anymore, trigger idle callbacks */
+    PROBE_NO_DATA (pad, GST_PAD_PROBE_TYPE_PUSH | GST_PAD_PROBE_TYPE_IDLE,
+        probe_stopped, ret);
+  }
+  GST_OBJECT_UNLOCK (pad);
+
+  return ret;
+
+probe_stopped:
+  {
+    GST_OBJECT_UNLOCK (pad);
+
+    switch (ret) {
+      case GST_FLOW_CUSTOM_SUCCESS:
+      case GST_FLOW_CUSTOM_SUCCESS_1:
+        ret = GST_FLOW_OK;
+        break;
+      default:
+        GST_DEBUG_OBJECT (pad, "an error occurred %s", gst_flow_get_name (ret));
+        break;
+    }
+    FAST_PUSH_SET_LAST_FLOWRET (pad, ret);
+    return ret;
+  }
+}
+#endif
+
 static GstFlowReturn
 gst_pad_push_data (GstPad * pad, GstPadProbeType type, void *data)
 {
@@ -4684,6 +4783,34 @@ gst_pad_push_data (GstPad * pad, GstPadProbeType type, void *data)
   GstFlowReturn ret;
   gboolean handled = FALSE;
 
+#ifndef GST_ENABLE_EXTRA_CHECKS
+  /* When the pad is linked, has no probes and no pending events, the data
+   * goes straight to the peer that was cached by an earlier push. The using
+   * count is raised before checking again so that unlinking and adding idle
+   * probes, which do it the other way around, always see us. */
+  if (G_LIKELY (FAST_PUSH_POSSIBLE (pad))) {
+    gboolean fast;
+
+    g_atomic_int_inc (&pad->priv->using);
+    peer = g_atomic_pointer_get (&pad->priv->fast_peer);
+    fast = G_LIKELY (FAST_PUSH_POSSIBLE (pad));
+    if (fast)
+      ret = gst_pad_chain_data_unchecked (peer, type, data);
+    else
+      ret = GST_FLOW_OK;
+
+    if (g_atomic_int_dec_and_test (&pad->priv->using)
+        && G_UNLIKELY (g_atomic_int_get (&pad->num_probes) != 0
+            || g_atomic_pointer_get (&pad->priv->stale_peer) != NULL))
+      ret = gst_pad_fast_push_done (pad, ret);
+
+    if (fast) {
+      FAST_PUSH_SET_LAST_FLOWRET (pad, ret);
+      return ret;
+    }
+  }
+#endif
+
   GST_OBJECT_LOCK (pad);
   if (G_UNLIKELY (GST_PAD_IS_FLUSHING (pad)))
     goto flushing;
@@ -4731,9 +4858,16 @@ gst_pad_push_data (GstPad * pad, GstPadProbeType type, void *data)
   if (G_UNLIKELY ((peer = GST_PAD_PEER (pad)) == NULL))
     goto not_linked;
 
+#ifndef GST_ENABLE_EXTRA_CHECKS
+  /* nothing to check for the next pushes until this changes */
+  if (pad->num_probes == 0 && pad->priv->fast_peer == NULL
+      && pad->priv->stale_peer == NULL)
+    g_atomic_pointer_set (&pad->priv->fast_peer, gst_object_ref (peer));
+#endif
+
   /* take ref to peer pad before releasing the lock */
   gst_object_ref (peer);
-  pad->priv->using++;
+  g_atomic_int_inc (&pad->priv->using);
   GST_OBJECT_UNLOCK (pad);
 
   ret = gst_pad_chain_data_unchecked (peer, type, data);
@@ -4743,8 +4877,8 @@ gst_pad_push_data (GstPad * pad, GstPadProbeType type, void *data)
 
   GST_OBJECT_LOCK (pad);
   pad->ABI.abi.last_flowret = ret;
-  pad->priv->using--;
-  if (pad->priv->using == 0) {
+  if (g_atomic_int_dec_and_test (&pad->priv->using)) {
+    gst_pad_drop_stale_peer (pad);
     /* pad is not active anymore, trigger idle callbacks */
     PROBE_NO_DATA (pad, GST_PAD_PROBE_TYPE_PUSH | GST_PAD_PROBE_TYPE_IDLE,
         probe_stopped, ret);
@@ -5187,7 +5321,7 @@ gst_pad_pull_range (GstPad * pad, guint64 offset, guint size,
     goto not_linked;
 
   gst_object_ref (peer);
-  pad->priv->using++;
+  g_atomic_int_inc (&pad->priv->using);
   GST_OBJECT_UNLOCK (pad);
 
   ret = gst_pad_get_range_unchecked (peer, offset, size, &res_buf);
@@ -5195,9 +5329,8 @@ gst_pad_pull_range (GstPad * pad, guint64 offset, guint size,
   gst_object_unref (peer);
 
   GST_OBJECT_LOCK (pad);
-  pad->priv->using--;
   pad->ABI.abi.last_flowret = ret;
-  if (pad->priv->using == 0) {
+  if (g_atomic_int_dec_and_test (&pad->priv->using)) {
     /* pad is not active anymore, trigger idle callbacks */
     PROBE_NO_DATA (pad, GST_PAD_PROBE_TYPE_PULL | GST_PAD_PROBE_TYPE_IDLE,
         probe_stopped_unref, ret);
@@ -5563,7 +5696,7 @@ gst_pad_push_event_unchecked (GstPad * pad, GstEvent * event,
     goto not_linked;
 
   gst_object_ref (peerpad);
-  pad->priv->using++;
+  g_atomic_int_inc (&pad->priv->using);
   GST_OBJECT_UNLOCK (pad);
 
   GST_LOG_OBJECT (pad, "sending event %p (%s) to peerpad %" GST_PTR_FORMAT,
@@ -5580,8 +5713,8 @@ gst_pad_push_event_unchecked (GstPad * pad, GstEvent * event,
   gst_object_unref (peerpad);
 
   GST_OBJECT_LOCK (pad);
-  pad->priv->using--;
-  if (pad->priv->using == 0) {
+  if (g_atomic_int_dec_and_test (&pad->priv->using)) {
+    gst_pad_drop_stale_peer (pad);
     /* pad is not active anymore, trigger idle callbacks */
     PROBE_NO_DATA (pad, GST_PAD_PROBE_TYPE_PUSH | GST_PAD_PROBE_TYPE_IDLE,
         idle_probe_stopped, ret);
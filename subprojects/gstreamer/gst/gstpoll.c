@@ -51,6 +51,12 @@
  * descriptor, and gst_poll_fd_can_write() to see if it is possible to
  * write to it.
  *
+ * On Linux, sets that contain many file descriptors are waited on with
+ * epoll instead of ppoll(), so that the cost of a wakeup does not grow with
+ * the number of file descriptors in the set. The `GST_POLL_MODE`
+ * environment variable can be set to `epoll` to always use epoll or to
+ * `poll` to never use it.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -83,6 +89,10 @@
 #endif
 #include <sys/time.h>
 #include <sys/socket.h>
+#if defined(HAVE_SYS_EPOLL_H) && defined(HAVE_EPOLL_CREATE1)
+#define USE_EPOLL 1
+#include <sys/epoll.h>
+#endif
 #endif
 
 #ifdef G_OS_WIN32
@@ -124,9 +134,18 @@ typedef enum
   GST_POLL_MODE_PSELECT,
   GST_POLL_MODE_POLL,
   GST_POLL_MODE_PPOLL,
-  GST_POLL_MODE_WINDOWS
+  GST_POLL_MODE_WINDOWS,
+  GST_POLL_MODE_EPOLL
 } GstPollMode;
 
+#ifdef USE_EPOLL
+/* sets with at least this many fds switch from ppoll() to epoll in auto
+ * mode, below that the extra epoll_ctl() calls are not worth it */
+#define GST_POLL_EPOLL_THRESHOLD 64
+/* initial number of events we collect per epoll_wait() call */
+#define GST_POLL_EPOLL_MIN_EVENTS 64
+#endif
+
 struct _GstPoll
 {
   GstPollMode mode;
@@ -142,6 +161,17 @@ struct _GstPoll
 #ifndef G_OS_WIN32
   GstPollFD control_read_fd;
   GstPollFD control_write_fd;
+#ifdef USE_EPOLL
+  /* epoll instance, -1 when the set never used epoll */
+  gint epoll_fd;
+  /* set when epoll must not be used (anymore) for this set */
+  gboolean epoll_disabled;
+  /* indices in active_fds with revents set by the last epoll_wait(), only
+   * used from the waiting thread with the lock */
+  GArray *epoll_ready;
+  /* array of struct epoll_event, only used by the waiting thread */
+  GArray *epoll_events;
+#endif
 #else
   GArray *active_fds_ignored;
   GArray *events;
@@ -392,6 +422,228 @@ find_index (GArray * array, GstPollFD * fd)
   return fd->idx;
 }
 
+#ifdef USE_EPOLL
+static guint32
+pollfd_events_to_epoll (gshort events)
+{
+  guint32 res = 0;
+
+  if (events & POLLIN)
+    res |= EPOLLIN;
+  if (events & POLLOUT)
+    res |= EPOLLOUT;
+  if (events & POLLPRI)
+    res |= EPOLLPRI;
+
+  /* EPOLLERR and EPOLLHUP are always reported */
+  return res;
+}
+
+static gshort
+epoll_events_to_pollfd (guint32 events)
+{
+  gshort res = 0;
+
+  if (events & EPOLLIN)
+    res |= POLLIN;
+  if (events & EPOLLOUT)
+    res |= POLLOUT;
+  if (events & EPOLLPRI)
+    res |= POLLPRI;
+  if (events & EPOLLERR)
+    res |= POLLERR;
+  if (events & EPOLLHUP)
+    res |= POLLHUP;
+
+  return res;
+}
+
+/* we store the index of the fd in the fds array next to the fd so that the
+ * events can be mapped to active_fds without a lookup */
+static gboolean
+epoll_ctl_pollfd (GstPoll * set, gint op, guint idx)
+{
+  struct pollfd *pfd = &g_array_index (set->fds, struct pollfd, idx);
+  struct epoll_event ev;
+
+  ev.events = pollfd_events_to_epoll (pfd->events);
+  ev.data.u64 = ((guint64) idx << 32) | (guint32) pfd->fd;
+
+  if (epoll_ctl (set->epoll_fd, op, pfd->fd, &ev) < 0) {
+    GST_DEBUG ("%p: epoll_ctl %d for fd %d failed: %s", set, op, pfd->fd,
+        g_strerror (errno));
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/* stop using epoll, the waiting thread will pick up the new mode after its
+ * current wait. We keep the epoll fd open because it might still be waited
+ * on. */
+static void
+epoll_disable_unlocked (GstPoll * set)
+{
+  GST_INFO ("%p: not using epoll anymore", set);
+
+  if (set->mode == GST_POLL_MODE_EPOLL)
+    set->mode = GST_POLL_MODE_AUTO;
+  set->epoll_disabled = TRUE;
+  MARK_REBUILD (set);
+}
+
+static void
+epoll_enable_unlocked (GstPoll * set)
+{
+  guint i;
+
+  if (set->epoll_fd < 0) {
+    set->epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+    if (set->epoll_fd < 0)
+      goto no_epoll;
+  }
+
+  for (i = 0; i < set->fds->len; i++) {
+    if (!epoll_ctl_pollfd (set, EPOLL_CTL_ADD, i))
+      goto add_failed;
+  }
+
+  GST_DEBUG ("%p: using epoll for %u fds", set, set->fds->len);
+  set->mode = GST_POLL_MODE_EPOLL;
+  MARK_REBUILD (set);
+  return;
+
+  /* ERRORS */
+no_epoll:
+  {
+    GST_WARNING ("%p: can't create epoll fd: %s", set, g_strerror (errno));
+    set->epoll_disabled = TRUE;
+    return;
+  }
+add_failed:
+  {
+    /* happens for fds that don't support polling with epoll, such as
+     * regular files. Nobody is waiting on the epoll fd yet. */
+    GST_INFO ("%p: can't use epoll for fd %d", set,
+        g_array_index (set->fds, struct pollfd, i).fd);
+    close (set->epoll_fd);
+    set->epoll_fd = -1;
+    set->epoll_disabled = TRUE;
+    return;
+  }
+}
+
+/* called after an fd was added to the fds array */
+static void
+epoll_add_unlocked (GstPoll * set, guint idx)
+{
+  if (set->mode == GST_POLL_MODE_EPOLL) {
+    if (!epoll_ctl_pollfd (set, EPOLL_CTL_ADD, idx))
+      epoll_disable_unlocked (set);
+  } else if (set->mode == GST_POLL_MODE_AUTO && !set->epoll_disabled
+      && set->fds->len >= GST_POLL_EPOLL_THRESHOLD) {
+    epoll_enable_unlocked (set);
+  }
+}
+
+/* called after the fd at idx was removed from the fds array */
+static void
+epoll_remove_unlocked (GstPoll * set, gint fd, guint idx)
+{
+  if (set->mode != GST_POLL_MODE_EPOLL)
+    return;
+
+  /* this fails if the fd was already closed, which also removed it from the
+   * epoll set */
+  epoll_ctl (set->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+
+  /* the last fd was moved to idx, update the index stored with it. If this
+   * fails, the stale index is handled by the lookup after the wait. */
+  if (idx < set->fds->len)
+    epoll_ctl_pollfd (set, EPOLL_CTL_MOD, idx);
+}
+
+/* called after the events of the fd at idx were changed */
+static void
+epoll_update_unlocked (GstPoll * set, guint idx)
+{
+  if (set->mode != GST_POLL_MODE_EPOLL)
+    return;
+
+  if (!epoll_ctl_pollfd (set, EPOLL_CTL_MOD, idx))
+    epoll_disable_unlocked (set);
+}
+
+static gint
+epoll_wait_set (GstPoll * set, GstClockTime timeout)
+{
+  struct epoll_event *events;
+  gint maxevents, t, n, i, res;
+
+  if (timeout != GST_CLOCK_TIME_NONE) {
+    /* round up, returning early makes callers wait again */
+    guint64 msecs = GST_TIME_AS_MSECONDS (timeout);
+
+    if (timeout % GST_MSECOND)
+      msecs++;
+    t = (gint) MIN (msecs, G_MAXINT);
+  } else {
+    t = -1;
+  }
+
+  events = (struct epoll_event *) set->epoll_events->data;
+  maxevents = set->epoll_events->len;
+
+  n = epoll_wait (set->epoll_fd, events, maxevents, t);
+  if (n < 0)
+    return n;
+
+  g_mutex_lock (&set->lock);
+
+  if (TEST_REBUILD (set)) {
+    g_array_set_size (set->active_fds, set->fds->len);
+    memcpy (set->active_fds->data, set->fds->data,
+        set->fds->len * sizeof (struct pollfd));
+  } else {
+    /* only clear the results of the previous wait */
+    for (i = 0; i < set->epoll_ready->len; i++) {
+      guint idx = g_array_index (set->epoll_ready, guint, i);
+
+      g_array_index (set->active_fds, struct pollfd, idx).revents = 0;
+    }
+  }
+  g_array_set_size (set->epoll_ready, 0);
+
+  res = 0;
+  for (i = 0; i < n; i++) {
+    GstPollFD pollfd = GST_POLL_FD_INIT;
+    struct pollfd *pfd;
+    guint idx;
+
+    pollfd.fd = (gint) (events[i].data.u64 & G_MAXUINT32);
+    pollfd.idx = (gint) (events[i].data.u64 >> 32);
+
+    /* does a lookup when the fds array changed while we were waiting. If the
+     * fd was removed in the meantime, we ignore its events. */
+    if (find_index (set->active_fds, &pollfd) < 0)
+      continue;
+
+    idx = pollfd.idx;
+    pfd = &g_array_index (set->active_fds, struct pollfd, idx);
+    pfd->revents = epoll_events_to_pollfd (events[i].events);
+    g_array_append_val (set->epoll_ready, idx);
+    res++;
+  }
+
+  /* there might be more ready fds, collect more next time */
+  if (n == maxevents && maxevents < set->fds->len)
+    g_array_set_size (set->epoll_events, maxevents * 2);
+
+  g_mutex_unlock (&set->lock);
+
+  return res;
+}
+#endif
+
 #if !defined(HAVE_PPOLL) && defined(HAVE_POLL)
 /* check if all file descriptors will fit in an fd_set */
 static gboolean
@@ -659,26 +911,14 @@ gst_poll_collect_winsock_events (GstPoll * set)
 }
 #endif
 
-/**
- * gst_poll_new: (skip)
- * @controllable: whether it should be possible to control a wait.
- *
- * Create a new file descriptor set. If @controllable, it
- * is possible to restart or flush a call to gst_poll_wait() with
- * gst_poll_restart() and gst_poll_set_flushing() respectively.
- *
- * Free-function: gst_poll_free
- *
- * Returns: (transfer full) (nullable): a new #GstPoll, or %NULL in
- *     case of an error.  Free with gst_poll_free().
- */
-GstPoll *
-gst_poll_new (gboolean controllable)
+static GstPoll *
+gst_poll_new_full (gboolean controllable, gboolean timer)
 {
   GstPoll *nset;
 
   nset = g_slice_new0 (GstPoll);
-  GST_DEBUG ("%p: new controllable : %d", nset, controllable);
+  GST_DEBUG ("%p: new controllable : %d, timer : %d", nset, controllable,
+      timer);
   g_mutex_init (&nset->lock);
 #ifndef G_OS_WIN32
   nset->mode = GST_POLL_MODE_AUTO;
@@ -686,6 +926,25 @@ gst_poll_new (gboolean controllable)
   nset->active_fds = g_array_new (FALSE, FALSE, sizeof (struct pollfd));
   nset->control_read_fd.fd = -1;
   nset->control_write_fd.fd = -1;
+#ifdef USE_EPOLL
+  nset->epoll_fd = -1;
+  nset->epoll_ready = g_array_new (FALSE, FALSE, sizeof (guint));
+  nset->epoll_events = g_array_sized_new (FALSE, FALSE,
+      sizeof (struct epoll_event), GST_POLL_EPOLL_MIN_EVENTS);
+  g_array_set_size (nset->epoll_events, GST_POLL_EPOLL_MIN_EVENTS);
+
+  /* timers need the precision of ppoll() and only ever have the control fd */
+  if (timer) {
+    nset->epoll_disabled = TRUE;
+  } else {
+    const gchar *mode = g_getenv ("GST_POLL_MODE");
+
+    if (mode && g_str_equal (mode, "epoll"))
+      epoll_enable_unlocked (nset);
+    else if (mode && g_str_equal (mode, "poll"))
+      nset->epoll_disabled = TRUE;
+  }
+#endif
   {
     gint control_sock[2];
 
@@ -714,6 +973,7 @@ gst_poll_new (gboolean controllable)
 
   nset->controllable = controllable;
   nset->control_pending = 0;
+  nset->timer = timer;
 
   return nset;
 
@@ -728,6 +988,25 @@ no_socket_pair:
 #endif
 }
 
+/**
+ * gst_poll_new: (skip)
+ * @controllable: whether it should be possible to control a wait.
+ *
+ * Create a new file descriptor set. If @controllable, it
+ * is possible to restart or flush a call to gst_poll_wait() with
+ * gst_poll_restart() and gst_poll_set_flushing() respectively.
+ *
+ * Free-function: gst_poll_free
+ *
+ * Returns: (transfer full) (nullable): a new #GstPoll, or %NULL in
+ *     case of an error.  Free with gst_poll_free().
+ */
+GstPoll *
+gst_poll_new (gboolean controllable)
+{
+  return gst_poll_new_full (controllable, FALSE);
+}
+
 /**
  * gst_poll_new_timer: (skip)
  *
@@ -745,17 +1024,8 @@ no_socket_pair:
 GstPoll *
 gst_poll_new_timer (void)
 {
-  GstPoll *poll;
-
-  /* make a new controllable poll set */
-  if (!(poll = gst_poll_new (TRUE)))
-    goto done;
-
-  /* we are a timer */
-  poll->timer = TRUE;
-
-done:
-  return poll;
+  /* make a new controllable poll set, we are a timer */
+  return gst_poll_new_full (TRUE, TRUE);
 }
 
 /**
@@ -776,6 +1046,12 @@ gst_poll_free (GstPoll * set)
     close (set->control_write_fd.fd);
   if (set->control_read_fd.fd >= 0)
     close (set->control_read_fd.fd);
+#ifdef USE_EPOLL
+  if (set->epoll_fd >= 0)
+    close (set->epoll_fd);
+  g_array_free (set->epoll_events, TRUE);
+  g_array_free (set->epoll_ready, TRUE);
+#endif
 #else
   CloseHandle (set->wakeup_event);
 
@@ -859,6 +1135,9 @@ gst_poll_add_fd_unlocked (GstPoll * set, GstPollFD * fd)
     g_array_append_val (set->fds, nfd);
 
     fd->idx = set->fds->len - 1;
+#ifdef USE_EPOLL
+    epoll_add_unlocked (set, fd->idx);
+#endif
 #else
     WinsockFd wfd;
     HANDLE event;
@@ -943,6 +1222,9 @@ gst_poll_remove_fd (GstPoll * set, GstPollFD * fd)
     /* remove the fd at index, we use _remove_index_fast, which copies the last
      * element of the array to the freed index */
     g_array_remove_index_fast (set->fds, idx);
+#ifdef USE_EPOLL
+    epoll_remove_unlocked (set, fd->fd, idx);
+#endif
 
     /* mark fd as removed by setting the index to -1 */
     fd->idx = -1;
@@ -992,6 +1274,9 @@ gst_poll_fd_ctl_write (GstPoll * set, GstPollFD * fd, gboolean active)
       pfd->events &= ~POLLOUT;
 
     GST_LOG ("%p: pfd->events now %d (POLLOUT:%d)", set, pfd->events, POLLOUT);
+#ifdef USE_EPOLL
+    epoll_update_unlocked (set, idx);
+#endif
 #else
     gst_poll_update_winsock_event_mask (set, idx, FD_WRITE | FD_CONNECT,
         active);
@@ -1024,6 +1309,9 @@ gst_poll_fd_ctl_read_unlocked (GstPoll * set, GstPollFD * fd, gboolean active)
       pfd->events |= POLLIN;
     else
       pfd->events &= ~POLLIN;
+#ifdef USE_EPOLL
+    epoll_update_unlocked (set, idx);
+#endif
 #else
     gst_poll_update_winsock_event_mask (set, idx, FD_READ | FD_ACCEPT, active);
 #endif
@@ -1106,6 +1394,9 @@ gst_poll_fd_ctl_pri (GstPoll * set, GstPollFD * fd, gboolean active)
       pfd->events &= ~POLLPRI;
 
     GST_LOG ("%p: pfd->events now %d (POLLPRI:%d)", set, pfd->events, POLLOUT);
+#ifdef USE_EPOLL
+    epoll_update_unlocked (set, idx);
+#endif
     MARK_REBUILD (set);
   } else {
     GST_WARNING ("%p: couldn't find fd !", set);
@@ -1434,7 +1725,8 @@ gst_poll_wait (GstPoll * set, GstClockTime timeout)
 
     mode = choose_mode (set, timeout);
 
-    if (TEST_REBUILD (set)) {
+    /* with epoll, active_fds is updated after the wait */
+    if (mode != GST_POLL_MODE_EPOLL && TEST_REBUILD (set)) {
       g_mutex_lock (&set->lock);
 #ifndef G_OS_WIN32
       g_array_set_size (set->active_fds, set->fds->len);
@@ -1490,6 +1782,16 @@ gst_poll_wait (GstPoll * set, GstClockTime timeout)
 #else
         g_assert_not_reached ();
         errno = ENOSYS;
+#endif
+        break;
+      }
+      case GST_POLL_MODE_EPOLL:
+      {
+#ifdef USE_EPOLL
+        res = epoll_wait_set (set, timeout);
+#else
+        g_assert_not_reached ();
+        errno = ENOSYS;
 #endif
         break;
       }
@@ -574,6 +574,7 @@ priv_gst_registry_binary_read_cache (GstRegistry * registry,
     const char *location)
 {
   GMappedFile *mapped = NULL;
+  GBytes *bytes;
   gchar *contents = NULL;
   gchar *in = NULL;
   gsize size;
@@ -615,12 +616,23 @@ priv_gst_registry_binary_read_cache (GstRegistry * registry,
       g_error_free (err);
       return FALSE;
     }
+    bytes = g_bytes_new_take (contents, size);
   } else {
-    /* This can't fail if g_mapped_file_new() succeeded */
-    contents = g_mapped_file_get_contents (mapped);
-    size = g_mapped_file_get_length (mapped);
+#ifdef G_OS_WIN32
+    /* the features keep the contents around, and a mapped file can't be
+     * replaced when the registry is written again on win32 */
+    bytes = g_bytes_new (g_mapped_file_get_contents (mapped),
+        g_mapped_file_get_length (mapped));
+#else
+    bytes = g_mapped_file_get_bytes (mapped);
+#endif
+    g_mapped_file_unref (mapped);
   }
 
+  /* the features loaded below keep a reference to the contents when they
+   * point into it */
+  contents = (gchar *) g_bytes_get_data (bytes, &size);
+
   /* in is a cursor pointer, we initialize it with the begin of registry and is updated on each read */
   in = contents;
   GST_DEBUG ("File data at address %p", in);
@@ -666,7 +678,8 @@ priv_gst_registry_binary_read_cache (GstRegistry * registry,
       GST_DEBUG ("reading binary registry %" G_GSIZE_FORMAT "(%x)/%"
           G_GSIZE_FORMAT, (gsize) in - (gsize) contents,
           (guint) ((gsize) in - (gsize) contents), size);
-      if (!_priv_gst_registry_chunks_load_plugin (registry, &in, end, NULL)) {
+      if (!_priv_gst_registry_chunks_load_plugin (registry, &in, end, bytes,
+              NULL)) {
         GST_ERROR ("Problem while reading binary registry %s", location);
         goto Error;
       }
@@ -683,16 +696,11 @@ done:
   GST_INFO ("loaded %s in %lf seconds", location, seconds);
 
   res = TRUE;
-  /* TODO: once we re-use the pointers to registry contents, return here */
 
 Error:
 #ifndef GST_DISABLE_GST_DEBUG
   g_timer_destroy (timer);
 #endif
-  if (mapped) {
-    g_mapped_file_unref (mapped);
-  } else {
-    g_free (contents);
-  }
+  g_bytes_unref (bytes);
   return res;
 }
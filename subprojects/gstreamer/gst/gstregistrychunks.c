@@ -300,9 +300,15 @@ gst_registry_chunks_save_feature (GList ** list, GstPluginFeature * feature)
       }
     }
 
-    /* pack element metadata strings */
-    gst_registry_chunks_save_string (list,
-        gst_structure_to_string (factory->metadata));
+    /* pack element metadata strings, as loaded from the cache if they were
+     * never needed */
+    if (g_atomic_pointer_get (&factory->metadata) == NULL
+        && factory->metadata_str != NULL) {
+      gst_registry_chunks_save_const_string (list, factory->metadata_str);
+    } else {
+      gst_registry_chunks_save_string (list,
+          gst_structure_to_string (factory->metadata));
+    }
   } else if (GST_IS_TYPE_FIND_FACTORY (feature)) {
     GstRegistryChunkTypeFindFactory *tff;
     GstTypeFindFactory *factory = GST_TYPE_FIND_FACTORY (feature);
@@ -326,7 +332,10 @@ gst_registry_chunks_save_feature (GList ** list, GstPluginFeature * feature)
     }
     GST_DEBUG_OBJECT (feature, "saved %d extensions", tff->nextensions);
     /* save caps */
-    if (factory->caps) {
+    if (g_atomic_pointer_get (&factory->caps) == NULL
+        && factory->caps_str != NULL) {
+      gst_registry_chunks_save_const_string (list, factory->caps_str);
+    } else if (factory->caps) {
       GstCaps *fcaps = gst_caps_ref (factory->caps);
       /* we simplify the caps before saving. This is a lot faster
        * when loading them later on */
@@ -353,8 +362,13 @@ gst_registry_chunks_save_feature (GList ** list, GstPluginFeature * feature)
 
 
     /* pack element metadata strings */
-    gst_registry_chunks_save_string (list,
-        gst_structure_to_string (factory->metadata));
+    if (g_atomic_pointer_get (&factory->metadata) == NULL
+        && factory->metadata_str != NULL) {
+      gst_registry_chunks_save_const_string (list, factory->metadata_str);
+    } else {
+      gst_registry_chunks_save_string (list,
+          gst_structure_to_string (factory->metadata));
+    }
   } else if (GST_IS_TRACER_FACTORY (feature)) {
     /* Initialize with zeroes because of struct padding and
      * valgrind complaining about copying uninitialized memory
@@ -532,7 +546,9 @@ gst_registry_chunks_load_pad_template (GstElementFactory * factory, gchar ** in,
   template->direction = (GstPadDirection) pt->direction;
   template->static_caps.caps = NULL;
 
-  /* unpack pad template strings */
+  /* unpack pad template strings. They are interned even when the registry
+   * contents are kept around, static pad templates and their strings are
+   * expected to stay valid after the factory is gone */
   unpack_const_string (*in, template->name_template, end, fail);
   unpack_const_string (*in, template->static_caps.string, end, fail);
 
@@ -550,13 +566,17 @@ fail:
 /*
  * gst_registry_chunks_load_feature:
  *
- * Make a new GstPluginFeature from current binary plugin feature structure
+ * Make a new GstPluginFeature from current binary plugin feature structure.
+ *
+ * With a @cache, the registry contents stay around and the feature keeps a
+ * reference to them. Metadata and typefind caps are then only deserialized
+ * when they are first needed.
  *
  * Returns: new GstPluginFeature
  */
 static gboolean
 gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
-    gchar * end, GstPlugin * plugin)
+    gchar * end, GBytes * cache, GstPlugin * plugin)
 {
   GstRegistryChunkPluginFeature *pf = NULL;
   GstPluginFeature *feature = NULL;
@@ -614,7 +634,10 @@ gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
 
     /* unpack element factory strings */
     unpack_string_nocopy (*in, meta_data_str, end, fail);
-    if (meta_data_str && *meta_data_str) {
+    if (meta_data_str && *meta_data_str && cache) {
+      factory->metadata_str = meta_data_str;
+      factory->cache = g_bytes_ref (cache);
+    } else if (meta_data_str && *meta_data_str) {
       factory->metadata = gst_structure_from_string (meta_data_str, NULL);
       if (!factory->metadata) {
         GST_ERROR
@@ -671,10 +694,14 @@ gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
 
     /* load typefinder caps */
     unpack_string_nocopy (*in, const_str, end, fail);
-    if (const_str != NULL && *const_str != '\0')
+    if (const_str != NULL && *const_str != '\0' && cache) {
+      factory->caps_str = const_str;
+      factory->cache = g_bytes_ref (cache);
+    } else if (const_str != NULL && *const_str != '\0') {
       factory->caps = gst_caps_from_string (const_str);
-    else
+    } else {
       factory->caps = NULL;
+    }
 
     /* load extensions */
     if (tff->nextensions) {
@@ -703,7 +730,10 @@ gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
 
     /* unpack element factory strings */
     unpack_string_nocopy (*in, meta_data_str, end, fail);
-    if (meta_data_str && *meta_data_str) {
+    if (meta_data_str && *meta_data_str && cache) {
+      factory->metadata_str = meta_data_str;
+      factory->cache = g_bytes_ref (cache);
+    } else if (meta_data_str && *meta_data_str) {
       factory->metadata = gst_structure_from_string (meta_data_str, NULL);
       if (!factory->metadata) {
         GST_ERROR
@@ -820,10 +850,13 @@ fail:
  * Make a new GstPlugin from current GstRegistryChunkPluginElement structure
  * and add it to the GstRegistry. Return an offset to the next
  * GstRegistryChunkPluginElement structure.
+ *
+ * @cache are the registry contents @in points into, or %NULL when they are
+ * only valid during the call.
  */
 gboolean
 _priv_gst_registry_chunks_load_plugin (GstRegistry * registry, gchar ** in,
-    gchar * end, GstPlugin ** out_plugin)
+    gchar * end, GBytes * cache, GstPlugin ** out_plugin)
 {
 #ifndef GST_DISABLE_GST_DEBUG
   gchar *start = *in;
@@ -890,7 +923,7 @@ _priv_gst_registry_chunks_load_plugin (GstRegistry * registry, gchar ** in,
   /* Load plugin features */
   for (i = 0; i < n; i++) {
     if (G_UNLIKELY (!gst_registry_chunks_load_feature (registry, in, end,
-                plugin))) {
+                cache, plugin))) {
       GST_ERROR ("Error while loading binary feature for plugin '%s'",
           GST_STR_NULL (plugin->desc.name));
       gst_registry_remove_plugin (registry, plugin);
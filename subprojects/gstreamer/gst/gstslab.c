@@ -0,0 +1,280 @@
+/* GStreamer
+ *
+ * gstslab.c: Per-thread caches for small allocations
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* When GST_SLAB_ALLOC is set, the small blocks used for buffers and system
+ * memory are recycled in caches per thread instead of going through g_slice
+ * for every allocation.
+ *
+ * Blocks are grouped in size classes. Each thread keeps up to two magazines
+ * worth of free blocks per class. A thread that frees more blocks than it
+ * allocates, which happens when buffers are allocated in one thread and freed
+ * in another, moves a magazine of blocks to a global depot where the
+ * allocating thread picks them up again when its own cache runs empty.
+ * Magazines are linked lists made of the free blocks themselves so moving
+ * them around needs no memory. */
+
+#include "gst_private.h"
+
+#include <string.h>
+
+#define SLAB_MAGAZINE_SIZE 32
+#define SLAB_MAX_MAGAZINES 64
+#define SLAB_MAX_SIZE 4096
+#define SLAB_GRANULE 64
+
+static const gsize slab_sizes[] = {
+  64, 128, 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096
+};
+
+#define SLAB_N_CLASSES G_N_ELEMENTS (slab_sizes)
+
+typedef struct _GstSlabBlock GstSlabBlock;
+
+struct _GstSlabBlock
+{
+  /* next block in the magazine */
+  GstSlabBlock *next;
+  /* next magazine in the depot, only valid in the first block */
+  GstSlabBlock *next_magazine;
+};
+
+typedef struct
+{
+  GMutex lock;
+  GstSlabBlock *magazines;
+  guint n_magazines;
+} GstSlabDepot;
+
+typedef struct
+{
+  guint n_blocks[SLAB_N_CLASSES];
+  gpointer blocks[SLAB_N_CLASSES][2 * SLAB_MAGAZINE_SIZE];
+
+  /* only written by the owning thread */
+  GstSlabStats stats;
+} GstSlabCache;
+
+static gboolean slab_enabled = FALSE;
+static guint8 slab_class_index[SLAB_MAX_SIZE / SLAB_GRANULE + 1];
+static GstSlabDepot slab_depots[SLAB_N_CLASSES];
+
+/* all thread caches and the stats of the threads that are gone */
+static GMutex slab_caches_lock;
+static GList *slab_caches = NULL;
+static GstSlabStats slab_retired_stats;
+
+static void slab_cache_free (gpointer data);
+static GPrivate slab_cache = G_PRIVATE_INIT (slab_cache_free);
+
+void
+_priv_gst_slab_initialize (void)
+{
+  const gchar *env;
+  guint i, c = 0;
+
+  env = g_getenv ("GST_SLAB_ALLOC");
+  slab_enabled = env != NULL && *env != '\0' && strcmp (env, "0") != 0;
+
+  for (i = 0; i < G_N_ELEMENTS (slab_class_index); i++) {
+    while (slab_sizes[c] < i * SLAB_GRANULE)
+      c++;
+    slab_class_index[i] = c;
+  }
+
+  GST_CAT_DEBUG (GST_CAT_MEMORY, "per-thread slab %s",
+      slab_enabled ? "enabled" : "disabled");
+}
+
+static inline guint
+slab_get_class (gsize size)
+{
+  return slab_class_index[(size + SLAB_GRANULE - 1) / SLAB_GRANULE];
+}
+
+static inline GstSlabCache *
+slab_get_cache (void)
+{
+  GstSlabCache *cache = g_private_get (&slab_cache);
+
+  if (G_UNLIKELY (cache == NULL)) {
+    cache = g_new0 (GstSlabCache, 1);
+    g_private_set (&slab_cache, cache);
+
+    g_mutex_lock (&slab_caches_lock);
+    slab_caches = g_list_prepend (slab_caches, cache);
+    g_mutex_unlock (&slab_caches_lock);
+  }
+
+  return cache;
+}
+
+/* takes a magazine from the depot */
+static gboolean
+slab_refill (GstSlabCache * cache, guint c)
+{
+  GstSlabDepot *depot = &slab_depots[c];
+  GstSlabBlock *block;
+  guint n = 0;
+
+  g_mutex_lock (&depot->lock);
+  block = depot->magazines;
+  if (block) {
+    depot->magazines = block->next_magazine;
+    depot->n_magazines--;
+  }
+  g_mutex_unlock (&depot->lock);
+
+  for (; block; block = block->next)
+    cache->blocks[c][n++] = block;
+  cache->n_blocks[c] = n;
+
+  return n > 0;
+}
+
+/* moves the last @n blocks of the cache to the depot as one magazine */
+static void
+slab_flush (GstSlabCache * cache, guint c, guint n)
+{
+  GstSlabDepot *depot = &slab_depots[c];
+  GstSlabBlock *first = NULL, *next;
+  guint i;
+
+  for (i = 0; i < n; i++) {
+    GstSlabBlock *block = cache->blocks[c][--cache->n_blocks[c]];
+
+    block->next = first;
+    first = block;
+  }
+
+  g_mutex_lock (&depot->lock);
+  if (depot->n_magazines < SLAB_MAX_MAGAZINES) {
+    first->next_magazine = depot->magazines;
+    depot->magazines = first;
+    depot->n_magazines++;
+    first = NULL;
+  }
+  g_mutex_unlock (&depot->lock);
+
+  /* depot is full, give the blocks back */
+  for (; first; first = next) {
+    next = first->next;
+    g_slice_free1 (slab_sizes[c], first);
+  }
+}
+
+static void
+slab_cache_free (gpointer data)
+{
+  GstSlabCache *cache = data;
+  guint c;
+
+  for (c = 0; c < SLAB_N_CLASSES; c++) {
+    while (cache->n_blocks[c] > 0)
+      slab_flush (cache, c, MIN (cache->n_blocks[c], SLAB_MAGAZINE_SIZE));
+  }
+
+  g_mutex_lock (&slab_caches_lock);
+  slab_caches = g_list_remove (slab_caches, cache);
+  slab_retired_stats.cached_allocs += cache->stats.cached_allocs;
+  slab_retired_stats.system_allocs += cache->stats.system_allocs;
+  slab_retired_stats.refills += cache->stats.refills;
+  slab_retired_stats.flushes += cache->stats.flushes;
+  g_mutex_unlock (&slab_caches_lock);
+
+  g_free (cache);
+}
+
+/* Allocates @size bytes. The memory must be freed with _priv_gst_slab_free()
+ * with the same size. */
+gpointer
+_priv_gst_slab_alloc (gsize size)
+{
+  GstSlabCache *cache;
+  guint c;
+
+  if (!slab_enabled || size > SLAB_MAX_SIZE)
+    return g_slice_alloc (size);
+
+  c = slab_get_class (size);
+  cache = slab_get_cache ();
+
+  if (G_UNLIKELY (cache->n_blocks[c] == 0)) {
+    if (!slab_refill (cache, c)) {
+      cache->stats.system_allocs++;
+      return g_slice_alloc (slab_sizes[c]);
+    }
+    cache->stats.refills++;
+  }
+
+  cache->stats.cached_allocs++;
+  return cache->blocks[c][--cache->n_blocks[c]];
+}
+
+void
+_priv_gst_slab_free (gsize size, gpointer mem)
+{
+  GstSlabCache *cache;
+  guint c;
+
+  if (!slab_enabled || size > SLAB_MAX_SIZE) {
+    g_slice_free1 (size, mem);
+    return;
+  }
+
+  c = slab_get_class (size);
+  cache = slab_get_cache ();
+
+  if (G_UNLIKELY (cache->n_blocks[c] == 2 * SLAB_MAGAZINE_SIZE)) {
+    slab_flush (cache, c, SLAB_MAGAZINE_SIZE);
+    cache->stats.flushes++;
+  }
+
+  cache->blocks[c][cache->n_blocks[c]++] = mem;
+}
+
+/* _gst_slab_get_stats:
+ * @stats: (out): the allocation counts
+ *
+ * Sums up the allocation counts of all threads. The counts of running
+ * threads are read without synchronization and can be slightly behind.
+ *
+ * Returns: %TRUE if the per-thread slab is enabled.
+ */
+gboolean
+_gst_slab_get_stats (GstSlabStats * stats)
+{
+  GList *walk;
+
+  g_return_val_if_fail (stats != NULL, FALSE);
+
+  g_mutex_lock (&slab_caches_lock);
+  *stats = slab_retired_stats;
+  for (walk = slab_caches; walk; walk = walk->next) {
+    GstSlabCache *cache = walk->data;
+
+    stats->cached_allocs += cache->stats.cached_allocs;
+    stats->system_allocs += cache->stats.system_allocs;
+    stats->refills += cache->stats.refills;
+    stats->flushes += cache->stats.flushes;
+  }
+  g_mutex_unlock (&slab_caches_lock);
+
+  return slab_enabled;
+}
@@ -163,10 +163,18 @@ typedef struct
 
   /* owned by parent structure, NULL if no parent */
   gint *parent_refcount;
+  /* serial of the parent caps that changes with the structure, NULL if the
+   * parent doesn't care */
+  gsize *parent_serial;
 
   guint fields_len;             /* Number of valid items in fields */
   guint fields_alloc;           /* Allocated items in fields */
 
+  /* One bit per field name quark (modulo 64), so lookups of fields that are
+   * not in the structure don't need to scan the fields. Bits of removed
+   * fields are cleared by recomputing the mask. */
+  guint64 fields_mask;
+
   /* Fields are allocated if GST_STRUCTURE_IS_USING_DYNAMIC_ARRAY(),
    *  else it's a pointer to the arr field. */
   GstStructureField *fields;
@@ -175,7 +183,21 @@ typedef struct
 } GstStructureImpl;
 
 #define GST_STRUCTURE_REFCOUNT(s) (((GstStructureImpl*)(s))->parent_refcount)
+#define GST_STRUCTURE_SERIAL(s) (((GstStructureImpl*)(s))->parent_serial)
+
+/* must be called for every modification, so the parent caps can tell that
+ * the structure changed even when it was modified through a pointer that
+ * was handed out earlier */
+#define GST_STRUCTURE_CHANGED(s) G_STMT_START{                          \
+  if (G_UNLIKELY (GST_STRUCTURE_SERIAL (s)))                            \
+    _priv_gst_caps_serial_changed (GST_STRUCTURE_SERIAL (s));           \
+}G_STMT_END
 #define GST_STRUCTURE_LEN(s) (((GstStructureImpl*)(s))->fields_len)
+#define GST_STRUCTURE_MASK(s) (((GstStructureImpl*)(s))->fields_mask)
+
+#define FIELD_MASK_BIT(quark) (G_GUINT64_CONSTANT (1) << ((quark) & 63))
+#define GST_STRUCTURE_MAY_HAVE_FIELD(s, quark) \
+  ((GST_STRUCTURE_MASK (s) & FIELD_MASK_BIT (quark)) != 0)
 
 #define GST_STRUCTURE_IS_USING_DYNAMIC_ARRAY(s) \
   (((GstStructureImpl*)(s))->fields != &((GstStructureImpl*)(s))->arr[0])
@@ -218,6 +240,7 @@ _structure_append_val (GstStructure * s, GstStructureField * val)
 
   /* Finally set value */
   impl->fields[impl->fields_len++] = *val;
+  impl->fields_mask |= FIELD_MASK_BIT (val->name);
 }
 
 /* Replacement for g_array_remove_index */
@@ -230,12 +253,18 @@ _structure_remove_index (GstStructure * s, guint idx)
   if (idx >= impl->fields_len)
     return;
 
+  GST_STRUCTURE_CHANGED (s);
+
   /* Shift everything if it's not the last item */
   if (idx != impl->fields_len)
     memmove (&impl->fields[idx],
         &impl->fields[idx + 1],
         (impl->fields_len - idx - 1) * sizeof (GstStructureField));
   impl->fields_len--;
+
+  impl->fields_mask = 0;
+  for (idx = 0; idx < impl->fields_len; idx++)
+    impl->fields_mask |= FIELD_MASK_BIT (impl->fields[idx].name);
 }
 
 static void gst_structure_set_field (GstStructure * structure,
@@ -286,6 +315,7 @@ gst_structure_new_id_empty_with_size (GQuark quark, guint prealloc)
   GST_STRUCTURE_REFCOUNT (structure) = NULL;
 
   structure->fields_len = 0;
+  structure->fields_mask = 0;
   structure->fields_alloc = n_alloc;
   structure->fields = &structure->arr[0];
 
@@ -473,10 +503,22 @@ gst_structure_set_parent_refcount (GstStructure * structure, gint * refcount)
   }
 
   GST_STRUCTURE_REFCOUNT (structure) = refcount;
+  if (refcount == NULL)
+    GST_STRUCTURE_SERIAL (structure) = NULL;
 
   return TRUE;
 }
 
+/* Makes modifications of @structure change the caps serial at @serial. Only
+ * valid while @structure has a parent refcount, it is reset together with
+ * it. */
+void
+_priv_gst_structure_set_parent_serial (GstStructure * structure,
+    gsize * serial)
+{
+  GST_STRUCTURE_SERIAL (structure) = serial;
+}
+
 /**
  * gst_structure_copy:
  * @structure: a #GstStructure to duplicate
@@ -687,6 +729,7 @@ gst_structure_set_name (GstStructure * structure, const gchar * name)
   g_return_if_fail (IS_MUTABLE (structure));
   g_return_if_fail (gst_structure_validate_name (name));
 
+  GST_STRUCTURE_CHANGED (structure);
   structure->name = g_quark_from_string (name);
 }
 
@@ -1012,6 +1055,8 @@ gst_structure_set_field (GstStructure * structure, GstStructureField * field)
   GType field_value_type;
   guint i, len;
 
+  GST_STRUCTURE_CHANGED (structure);
+
   len = GST_STRUCTURE_LEN (structure);
 
   field_value_type = G_VALUE_TYPE (&field->value);
@@ -1063,13 +1108,15 @@ gst_structure_set_field (GstStructure * structure, GstStructureField * field)
     }
   }
 
-  for (i = 0; i < len; i++) {
-    f = GST_STRUCTURE_FIELD (structure, i);
+  if (GST_STRUCTURE_MAY_HAVE_FIELD (structure, field->name)) {
+    for (i = 0; i < len; i++) {
+      f = GST_STRUCTURE_FIELD (structure, i);
 
-    if (G_UNLIKELY (f->name == field->name)) {
-      g_value_unset (&f->value);
-      memcpy (f, field, sizeof (GstStructureField));
-      return;
+      if (G_UNLIKELY (f->name == field->name)) {
+        g_value_unset (&f->value);
+        memcpy (f, field, sizeof (GstStructureField));
+        return;
+      }
     }
   }
 
@@ -1084,6 +1131,9 @@ gst_structure_id_get_field (const GstStructure * structure, GQuark field_id)
   GstStructureField *field;
   guint i, len;
 
+  if (!GST_STRUCTURE_MAY_HAVE_FIELD (structure, field_id))
+    return NULL;
+
   len = GST_STRUCTURE_LEN (structure);
 
   for (i = 0; i < len; i++) {
@@ -1395,6 +1445,8 @@ gst_structure_map_in_place (GstStructure * structure,
   g_return_val_if_fail (func != NULL, FALSE);
   len = GST_STRUCTURE_LEN (structure);
 
+  GST_STRUCTURE_CHANGED (structure);
+
   for (i = 0; i < len; i++) {
     field = GST_STRUCTURE_FIELD (structure, i);
 
@@ -1433,6 +1485,8 @@ gst_structure_filter_and_map_in_place (GstStructure * structure,
   g_return_if_fail (func != NULL);
   len = GST_STRUCTURE_LEN (structure);
 
+  GST_STRUCTURE_CHANGED (structure);
+
   for (i = 0; i < len;) {
     field = GST_STRUCTURE_FIELD (structure, i);
 
@@ -3079,15 +3133,58 @@ gst_structure_id_get (const GstStructure * structure, GQuark first_field_id,
   return ret;
 }
 
+/* Fast path for fixed values of the same basic type, which make up most of
+ * the fields in caps. Returns %FALSE if the values need to go through the
+ * generic GstValue functions, else sets @equal. Intersecting such values is
+ * the same as checking them for equality. */
+static inline gboolean
+gst_structure_fixed_values_equal (const GValue * value1,
+    const GValue * value2, gboolean * equal)
+{
+  GType type = G_VALUE_TYPE (value1);
+
+  if (type != G_VALUE_TYPE (value2))
+    return FALSE;
+
+  switch (type) {
+    case G_TYPE_INT:
+    case G_TYPE_BOOLEAN:
+      *equal = value1->data[0].v_int == value2->data[0].v_int;
+      return TRUE;
+    case G_TYPE_UINT:
+      *equal = value1->data[0].v_uint == value2->data[0].v_uint;
+      return TRUE;
+    case G_TYPE_STRING:{
+      const gchar *str1 = value1->data[0].v_pointer;
+      const gchar *str2 = value2->data[0].v_pointer;
+
+      if (str1 == NULL || str2 == NULL)
+        return FALSE;
+      *equal = str1 == str2 || strcmp (str1, str2) == 0;
+      return TRUE;
+    }
+    default:
+      if (type == GST_TYPE_FRACTION) {
+        *equal = (gint64) value1->data[0].v_int * value2->data[1].v_int ==
+            (gint64) value2->data[0].v_int * value1->data[1].v_int;
+        return TRUE;
+      }
+      return FALSE;
+  }
+}
+
 static gboolean
 gst_structure_is_equal_foreach (GQuark field_id, const GValue * val2,
     gpointer data)
 {
   const GstStructure *struct1 = (const GstStructure *) data;
   const GValue *val1 = gst_structure_id_get_value (struct1, field_id);
+  gboolean equal;
 
   if (G_UNLIKELY (val1 == NULL))
     return FALSE;
+  if (gst_structure_fixed_values_equal (val1, val2, &equal))
+    return equal;
   if (gst_value_compare (val1, val2) == GST_VALUE_EQUAL) {
     return TRUE;
   }
@@ -3153,29 +3250,41 @@ gst_structure_intersect (const GstStructure * struct1,
   /* Resulting structure will be at most the size of the smallest structure */
   dest = gst_structure_new_id_empty_with_size (struct1->name, MIN (len1, len2));
 
+  /* The field names of the result are unique and its values come from
+   * structures that were already validated, so they are appended directly
+   * instead of going through gst_structure_set_field(). */
+
   /* copy fields from struct1 which we have not in struct2 to target
    * intersect if we have the field in both */
   for (it1 = 0; it1 < len1; it1++) {
     GstStructureField *field1 = GST_STRUCTURE_FIELD (struct1, it1);
+    GstStructureField new_field = { field1->name, G_VALUE_INIT };
     gboolean seenother = FALSE;
-    for (it2 = 0; it2 < len2; it2++) {
+
+    for (it2 = 0; GST_STRUCTURE_MAY_HAVE_FIELD (struct2, field1->name)
+        && it2 < len2; it2++) {
       GstStructureField *field2 = GST_STRUCTURE_FIELD (struct2, it2);
       if (field1->name == field2->name) {
-        GValue dest_value = { 0 };
+        gboolean equal;
+
         seenother = TRUE;
-        /* Get the intersection if any */
-        if (gst_value_intersect (&dest_value, &field1->value, &field2->value)) {
-          gst_structure_id_take_value (dest, field1->name, &dest_value);
-          break;
-        } else {
+        if (gst_structure_fixed_values_equal (&field1->value, &field2->value,
+                &equal)) {
+          if (!equal)
+            goto error;
+          gst_value_init_and_copy (&new_field.value, &field1->value);
+        } else if (!gst_value_intersect (&new_field.value, &field1->value,
+                &field2->value)) {
           /* No intersection, return nothing */
           goto error;
         }
+        break;
       }
     }
     /* Field1 was only present in struct1, copy it over */
     if (!seenother)
-      gst_structure_id_set_value (dest, field1->name, &field1->value);
+      gst_value_init_and_copy (&new_field.value, &field1->value);
+    _structure_append_val (dest, &new_field);
   }
 
   /* Now iterate over the 2nd struct and copy over everything which
@@ -3183,17 +3292,13 @@ gst_structure_intersect (const GstStructure * struct1,
    * values being present in both just above) */
   for (it2 = 0; it2 < len2; it2++) {
     GstStructureField *field2 = GST_STRUCTURE_FIELD (struct2, it2);
-    gboolean seenother = FALSE;
-    for (it1 = 0; it1 < len1; it1++) {
-      GstStructureField *field1 = GST_STRUCTURE_FIELD (struct1, it1);
-      if (field1->name == field2->name) {
-        seenother = TRUE;
-        break;
-      }
-    }
-    if (!seenother)
-      gst_structure_id_set_value (dest, field2->name, &field2->value);
+    GstStructureField new_field = { field2->name, G_VALUE_INIT };
 
+    if (gst_structure_id_get_field (struct1, field2->name))
+      continue;
+
+    gst_value_init_and_copy (&new_field.value, &field2->value);
+    _structure_append_val (dest, &new_field);
   }
 
   return dest;
@@ -3204,26 +3309,26 @@ error:
 }
 
 static gboolean
-gst_caps_structure_can_intersect_field (GQuark id, const GValue * val1,
-    gpointer data)
+gst_caps_structure_can_intersect_field (const GValue * val1,
+    const GValue * val2)
 {
-  GstStructure *other = (GstStructure *) data;
-  const GValue *val2 = gst_structure_id_get_value (other, id);
+  gboolean equal;
 
-  if (G_LIKELY (val2)) {
-    if (!gst_value_can_intersect (val1, val2)) {
-      return FALSE;
-    } else {
-      gint eq = gst_value_compare (val1, val2);
+  if (gst_structure_fixed_values_equal (val1, val2, &equal))
+    return equal;
 
-      if (eq == GST_VALUE_UNORDERED) {
-        /* we need to try interseting */
-        if (!gst_value_intersect (NULL, val1, val2)) {
-          return FALSE;
-        }
-      } else if (eq != GST_VALUE_EQUAL) {
+  if (!gst_value_can_intersect (val1, val2)) {
+    return FALSE;
+  } else {
+    gint eq = gst_value_compare (val1, val2);
+
+    if (eq == GST_VALUE_UNORDERED) {
+      /* we need to try interseting */
+      if (!gst_value_intersect (NULL, val1, val2)) {
         return FALSE;
       }
+    } else if (eq != GST_VALUE_EQUAL) {
+      return FALSE;
     }
   }
   return TRUE;
@@ -3243,6 +3348,8 @@ gboolean
 gst_structure_can_intersect (const GstStructure * struct1,
     const GstStructure * struct2)
 {
+  guint i, len;
+
   g_return_val_if_fail (GST_IS_STRUCTURE (struct1), FALSE);
   g_return_val_if_fail (GST_IS_STRUCTURE (struct2), FALSE);
 
@@ -3250,8 +3357,18 @@ gst_structure_can_intersect (const GstStructure * struct1,
     return FALSE;
 
   /* tries to intersect if we have the field in both */
-  return gst_structure_foreach ((GstStructure *) struct1,
-      gst_caps_structure_can_intersect_field, (gpointer) struct2);
+  len = GST_STRUCTURE_LEN (struct1);
+  for (i = 0; i < len; i++) {
+    GstStructureField *field1 = GST_STRUCTURE_FIELD (struct1, i);
+    GstStructureField *field2 =
+        gst_structure_id_get_field (struct2, field1->name);
+
+    if (field2 && !gst_caps_structure_can_intersect_field (&field1->value,
+            &field2->value))
+      return FALSE;
+  }
+
+  return TRUE;
 }
 
 
@@ -3285,13 +3402,27 @@ gst_structure_is_subset (const GstStructure * subset,
   for (it2 = 0; it2 < len2; it2++) {
     GstStructureField *superfield = GST_STRUCTURE_FIELD (superset, it2);
     gboolean seenother = FALSE;
+
+    if (!GST_STRUCTURE_MAY_HAVE_FIELD (subset, superfield->name))
+      return FALSE;
+
     for (it1 = 0; it1 < len1; it1++) {
       GstStructureField *subfield = GST_STRUCTURE_FIELD (subset, it1);
       if (subfield->name == superfield->name) {
-        int comparison =
-            gst_value_compare (&subfield->value, &superfield->value);
+        gboolean equal;
+        int comparison;
+
         seenother = TRUE;
 
+        if (gst_structure_fixed_values_equal (&subfield->value,
+                &superfield->value, &equal)) {
+          if (!equal)
+            return FALSE;
+          break;
+        }
+
+        comparison = gst_value_compare (&subfield->value, &superfield->value);
+
         /* If present and equal, stop iterating */
         if (comparison == GST_VALUE_EQUAL)
           break;
@@ -103,6 +103,9 @@ struct _GstClockEntryFutex
   GDestroyNotify destroy_entry;
 
   gboolean initialized;
+  /* position in the heap of pending async entries plus one, 0 if not
+   * queued. Protected by the clock lock */
+  guint heap_pos;
 
   GMutex lock;
   guint cond_val;
@@ -269,6 +272,9 @@ struct _GstClockEntryPThread
   GDestroyNotify destroy_entry;
 
   gboolean initialized;
+  /* position in the heap of pending async entries plus one, 0 if not
+   * queued. Protected by the clock lock */
+  guint heap_pos;
 
   pthread_cond_t cond;
   pthread_mutex_t lock;
@@ -401,6 +407,9 @@ struct _GstClockEntryGLib
   GDestroyNotify destroy_entry;
 
   gboolean initialized;
+  /* position in the heap of pending async entries plus one, 0 if not
+   * queued. Protected by the clock lock */
+  guint heap_pos;
 
   GMutex lock;
   GCond cond;
@@ -437,13 +446,29 @@ ensure_entry_initialized (GstClockEntryImpl * entry_impl)
   }
 }
 
+/* an entry in the heap of pending async entries, the time is copied to
+ * keep the comparisons in the array */
+typedef struct
+{
+  GstClockTime time;
+  guint64 seqnum;
+  GstClockEntry *entry;
+} GstClockHeapItem;
+
 struct _GstSystemClockPrivate
 {
   GThread *thread;              /* thread for async notify */
   gboolean stopping;
 
-  GList *entries;
+  /* pending async entries as a binary min-heap, ordered by time and then
+   * by the order they were added in */
+  GstClockHeapItem *entries;
+  guint n_entries;
+  guint entries_size;
+  guint64 entries_seqnum;
   GCond entries_changed;
+  /* the entry taken out of the heap by the async thread */
+  GstClockEntry *async_entry;
 
   GstClockType clock_type;
 
@@ -549,6 +574,7 @@ gst_system_clock_init (GstSystemClock * clock)
   priv->clock_type = DEFAULT_CLOCK_TYPE;
 
   priv->entries = NULL;
+  priv->n_entries = priv->entries_size = 0;
   g_cond_init (&priv->entries_changed);
 
 #ifdef G_OS_WIN32
@@ -573,37 +599,32 @@ gst_system_clock_dispose (GObject * object)
   GstClock *clock = (GstClock *) object;
   GstSystemClock *sysclock = GST_SYSTEM_CLOCK_CAST (clock);
   GstSystemClockPrivate *priv = sysclock->priv;
-  GList *entries;
+  guint i;
 
   /* else we have to stop the thread */
   GST_SYSTEM_CLOCK_LOCK (clock);
   priv->stopping = TRUE;
-  /* unschedule all entries */
-  for (entries = priv->entries; entries; entries = g_list_next (entries)) {
-    GstClockEntryImpl *entry = (GstClockEntryImpl *) entries->data;
-
-    /* We don't need to take the entry lock here because the async thread
-     * would only ever look at the head entry, which is locked below and only
-     * accesses new entries with the clock lock, which we hold here.
-     */
+  /* unschedule all entries. We don't need to take the entry locks here
+   * because the async thread only accesses queued entries with the clock
+   * lock, which we hold here. */
+  for (i = 0; i < priv->n_entries; i++)
+    GST_CLOCK_ENTRY_STATUS (priv->entries[i].entry) = GST_CLOCK_UNSCHEDULED;
+
+  /* Wake up the entry the async thread is handling. Once it is unscheduled
+   * the thread tries to get the system clock lock (which we hold here),
+   * notices that we are stopping and shuts down. */
+  if (priv->async_entry) {
+    GstClockEntryImpl *entry = (GstClockEntryImpl *) priv->async_entry;
+
+    /* it was initialized before adding to the heap */
+    g_assert (entry->initialized);
+
+    GST_SYSTEM_CLOCK_ENTRY_LOCK (entry);
+    GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "unscheduling entry %p",
+        entry);
     GST_CLOCK_ENTRY_STATUS ((GstClockEntry *) entry) = GST_CLOCK_UNSCHEDULED;
-
-    /* Wake up only the head entry: the async thread would only be waiting for
-     * this one, not all of them. Once the head entry is unscheduled it tries
-     * to get the system clock lock (which we hold here) and then look for the
-     * next entry. Once it gets the lock it will notice that all further
-     * entries are unscheduled, would remove them one by one from the list and
-     * then shut down. */
-    if (!entries->prev) {
-      /* it was initialized before adding to the list */
-      g_assert (entry->initialized);
-
-      GST_SYSTEM_CLOCK_ENTRY_LOCK (entry);
-      GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "unscheduling entry %p",
-          entry);
-      GST_SYSTEM_CLOCK_ENTRY_BROADCAST (entry);
-      GST_SYSTEM_CLOCK_ENTRY_UNLOCK ((GstClockEntryImpl *) entry);
-    }
+    GST_SYSTEM_CLOCK_ENTRY_BROADCAST (entry);
+    GST_SYSTEM_CLOCK_ENTRY_UNLOCK (entry);
   }
   GST_SYSTEM_CLOCK_BROADCAST (clock);
   GST_SYSTEM_CLOCK_UNLOCK (clock);
@@ -613,9 +634,13 @@ gst_system_clock_dispose (GObject * object)
   priv->thread = NULL;
   GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock, "joined thread");
 
-  g_list_foreach (priv->entries, (GFunc) gst_clock_id_unref, NULL);
-  g_list_free (priv->entries);
+  for (i = 0; i < priv->n_entries; i++) {
+    ((GstClockEntryImpl *) priv->entries[i].entry)->heap_pos = 0;
+    gst_clock_id_unref ((GstClockID) priv->entries[i].entry);
+  }
+  g_free (priv->entries);
   priv->entries = NULL;
+  priv->n_entries = priv->entries_size = 0;
 
   g_cond_clear (&priv->entries_changed);
 
@@ -740,6 +765,127 @@ gst_system_clock_obtain (void)
   return clock;
 }
 
+static inline gboolean
+heap_item_less (const GstClockHeapItem * a, const GstClockHeapItem * b)
+{
+  return a->time < b->time || (a->time == b->time && a->seqnum < b->seqnum);
+}
+
+static inline void
+heap_set (GstSystemClockPrivate * priv, guint i, const GstClockHeapItem * item)
+{
+  priv->entries[i] = *item;
+  ((GstClockEntryImpl *) item->entry)->heap_pos = i + 1;
+}
+
+static void
+heap_sift_up (GstSystemClockPrivate * priv, guint i)
+{
+  GstClockHeapItem item = priv->entries[i];
+
+  while (i > 0) {
+    guint parent = (i - 1) / 2;
+
+    if (!heap_item_less (&item, &priv->entries[parent]))
+      break;
+    heap_set (priv, i, &priv->entries[parent]);
+    i = parent;
+  }
+  heap_set (priv, i, &item);
+}
+
+static void
+heap_sift_down (GstSystemClockPrivate * priv, guint i)
+{
+  GstClockHeapItem item = priv->entries[i];
+
+  while (TRUE) {
+    guint child = 2 * i + 1;
+
+    if (child >= priv->n_entries)
+      break;
+    if (child + 1 < priv->n_entries
+        && heap_item_less (&priv->entries[child + 1], &priv->entries[child]))
+      child++;
+    if (!heap_item_less (&priv->entries[child], &item))
+      break;
+    heap_set (priv, i, &priv->entries[child]);
+    i = child;
+  }
+  heap_set (priv, i, &item);
+}
+
+/* Must be called with the clock lock */
+static inline GstClockEntry *
+gst_system_clock_head_entry (GstSystemClockPrivate * priv)
+{
+  return priv->n_entries ? priv->entries[0].entry : NULL;
+}
+
+/* Adds @entry to the heap, or moves it to its new place when it is queued
+ * already. The heap owns a ref to the entries in it.
+ *
+ * Must be called with the clock lock */
+static void
+gst_system_clock_add_entry (GstSystemClockPrivate * priv,
+    GstClockEntry * entry)
+{
+  guint i = ((GstClockEntryImpl *) entry)->heap_pos;
+
+  if (i == 0) {
+    if (priv->n_entries == priv->entries_size) {
+      priv->entries_size = MAX (16, 2 * priv->entries_size);
+      priv->entries = g_renew (GstClockHeapItem, priv->entries,
+          priv->entries_size);
+    }
+    i = ++priv->n_entries;
+    priv->entries[i - 1].entry = entry;
+  }
+
+  priv->entries[i - 1].time = GST_CLOCK_ENTRY_TIME (entry);
+  priv->entries[i - 1].seqnum = priv->entries_seqnum++;
+  heap_sift_up (priv, i - 1);
+  heap_sift_down (priv, ((GstClockEntryImpl *) entry)->heap_pos - 1);
+}
+
+/* Removes @entry from the heap, the ref of the heap is passed to the caller.
+ *
+ * Must be called with the clock lock */
+static void
+gst_system_clock_remove_entry (GstSystemClockPrivate * priv,
+    GstClockEntry * entry)
+{
+  guint i = ((GstClockEntryImpl *) entry)->heap_pos - 1;
+
+  ((GstClockEntryImpl *) entry)->heap_pos = 0;
+
+  priv->n_entries--;
+  if (i == priv->n_entries)
+    return;
+
+  heap_set (priv, i, &priv->entries[priv->n_entries]);
+  heap_sift_up (priv, i);
+  heap_sift_down (priv, i);
+}
+
+/* Puts the entry the async thread handled back into the heap, which takes
+ * over the ref of the thread. Unless it was unscheduled or scheduled again
+ * in the meantime.
+ *
+ * Must be called with the clock lock */
+static void
+gst_system_clock_requeue_entry (GstSystemClockPrivate * priv,
+    GstClockEntry * entry)
+{
+  priv->async_entry = NULL;
+
+  if (G_LIKELY (GST_CLOCK_ENTRY_STATUS (entry) != GST_CLOCK_UNSCHEDULED &&
+          ((GstClockEntryImpl *) entry)->heap_pos == 0))
+    gst_system_clock_add_entry (priv, entry);
+  else
+    gst_clock_id_unref ((GstClockID) entry);
+}
+
 /* this thread reads the sorted clock entries from the queue.
  *
  * It waits on each of them and fires the callback when the timeout occurs.
@@ -771,7 +917,7 @@ gst_system_clock_async_thread (GstClock * clock)
     GstClockReturn res;
 
     /* check if something to be done */
-    while (priv->entries == NULL) {
+    while (priv->n_entries == 0) {
       GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock,
           "no clock entries, waiting..");
       /* wait for work to do */
@@ -782,10 +928,12 @@ gst_system_clock_async_thread (GstClock * clock)
         goto exit;
     }
 
-    /* pick the next entry */
-    entry = priv->entries->data;
+    /* take the next entry out of the heap, we own its ref now */
+    entry = gst_system_clock_head_entry (priv);
+    gst_system_clock_remove_entry (priv, entry);
+    priv->async_entry = entry;
 
-    /* it was initialized before adding to the list */
+    /* it was initialized before adding to the heap */
     g_assert (((GstClockEntryImpl *) entry)->initialized);
 
     /* unlocked before the next loop iteration at latest */
@@ -854,9 +1002,8 @@ gst_system_clock_async_thread (GstClock * clock)
           GST_SYSTEM_CLOCK_LOCK (clock);
           /* adjust time now */
           entry->time = requested + entry->interval;
-          /* and resort the list now */
-          priv->entries =
-              g_list_sort (priv->entries, gst_clock_id_compare_func);
+          /* and queue it again */
+          gst_system_clock_requeue_entry (priv, entry);
           /* and restart */
           continue;
         } else {
@@ -878,6 +1025,8 @@ gst_system_clock_async_thread (GstClock * clock)
         if (entry_needs_unlock)
           GST_SYSTEM_CLOCK_ENTRY_UNLOCK ((GstClockEntryImpl *) entry);
         GST_SYSTEM_CLOCK_LOCK (clock);
+        /* put it back, the new entry is handled first */
+        gst_system_clock_requeue_entry (priv, entry);
         continue;
       default:
         GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock,
@@ -891,8 +1040,8 @@ gst_system_clock_async_thread (GstClock * clock)
       GST_SYSTEM_CLOCK_ENTRY_UNLOCK ((GstClockEntryImpl *) entry);
     GST_SYSTEM_CLOCK_LOCK (clock);
 
-    /* we remove the current entry and unref it */
-    priv->entries = g_list_remove (priv->entries, entry);
+    /* we are done with the current entry, unref it */
+    priv->async_entry = NULL;
     gst_clock_id_unref ((GstClockID) entry);
   }
 exit:
@@ -1256,10 +1405,11 @@ no_thread:
   return FALSE;
 }
 
-/* Add an entry to the list of pending async waits. The entry is inserted
- * in sorted order. If we inserted the entry at the head of the list, we
- * need to signal the thread as it might either be waiting on it or waiting
- * for a new entry.
+/* Add an entry to the heap of pending async waits. The entry is inserted
+ * in sorted order. If we inserted the entry at the head of the heap and it
+ * is due before the entry the async thread is handling, we need to signal
+ * the thread as it might either be waiting on that entry or waiting for a
+ * new entry.
  *
  * MT safe.
  */
@@ -1286,34 +1436,31 @@ gst_system_clock_id_wait_async (GstClock * clock, GstClockEntry * entry)
     goto was_unscheduled;
   GST_SYSTEM_CLOCK_ENTRY_UNLOCK ((GstClockEntryImpl *) entry);
 
-  if (priv->entries)
-    head = priv->entries->data;
-  else
-    head = NULL;
-
-  /* need to take a ref */
-  gst_clock_id_ref ((GstClockID) entry);
+  /* need to take a ref, unless it is still queued from before */
+  if (((GstClockEntryImpl *) entry)->heap_pos == 0)
+    gst_clock_id_ref ((GstClockID) entry);
 
   /* insert the entry in sorted order */
-  priv->entries = g_list_insert_sorted (priv->entries, entry,
-      gst_clock_id_compare_func);
+  gst_system_clock_add_entry (priv, entry);
 
   /* only need to send the signal if the entry was added to the
    * front, else the thread is just waiting for another entry and
    * will get to this entry automatically. */
-  if (priv->entries->data == entry) {
+  if (gst_system_clock_head_entry (priv) == entry) {
+    head = priv->async_entry;
+
     GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock,
-        "async entry added to head %p", head);
+        "async entry added to head, handling %p", head);
     if (head == NULL) {
-      /* the list was empty before, signal the cond so that the async thread can
-       * start taking a look at the queue */
+      /* the async thread is not handling an entry, signal the cond so that
+       * it can start taking a look at the queue */
       GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, clock,
           "first entry, sending signal");
       GST_SYSTEM_CLOCK_BROADCAST (clock);
-    } else {
+    } else if (GST_CLOCK_ENTRY_TIME (entry) < GST_CLOCK_ENTRY_TIME (head)) {
       GstClockReturn status;
 
-      /* it was initialized before adding to the list */
+      /* it was initialized before adding to the heap */
       g_assert (((GstClockEntryImpl *) head)->initialized);
 
       GST_SYSTEM_CLOCK_ENTRY_LOCK ((GstClockEntryImpl *) head);
@@ -1360,7 +1507,9 @@ was_unscheduled:
 static void
 gst_system_clock_id_unschedule (GstClock * clock, GstClockEntry * entry)
 {
+  GstSystemClockPrivate *priv = GST_SYSTEM_CLOCK_CAST (clock)->priv;
   GstClockReturn status;
+  gboolean dequeued = FALSE;
 
   GST_SYSTEM_CLOCK_LOCK (clock);
 
@@ -1380,5 +1529,16 @@ gst_system_clock_id_unschedule (GstClock * clock, GstClockEntry * entry)
     GST_SYSTEM_CLOCK_ENTRY_BROADCAST ((GstClockEntryImpl *) entry);
   }
   GST_SYSTEM_CLOCK_ENTRY_UNLOCK ((GstClockEntryImpl *) entry);
+
+  /* a pending async entry doesn't need to stay queued until it is due */
+  if (((GstClockEntryImpl *) entry)->heap_pos != 0) {
+    gst_system_clock_remove_entry (priv, entry);
+    dequeued = TRUE;
+  }
   GST_SYSTEM_CLOCK_UNLOCK (clock);
+
+  /* drop the ref of the heap, outside of the lock as this might free the
+   * entry and its user data */
+  if (dequeued)
+    gst_clock_id_unref ((GstClockID) entry);
 }
@@ -106,6 +106,12 @@ struct _GstTaskPrivate
   /* remember the pool and id that is currently running. */
   gpointer id;
   GstTaskPool *pool_id;
+
+  /* for tasks on a work-stealing pool: the task gave up its worker and was
+   * pushed to the pool again (resumed), or is paused without a worker
+   * (parked) */
+  gboolean resumed;
+  gboolean parked;
 };
 
 #ifdef _MSC_VER
@@ -325,12 +331,40 @@ gst_task_configure_name (GstTask * task)
 #endif
 }
 
+/* Push a task that gave up its worker back to its work-stealing pool.
+ * Should be called with the object lock. */
+static gboolean
+gst_task_reschedule_unlocked (GstTask * task)
+{
+  GstTaskPrivate *priv = task->priv;
+  GError *error = NULL;
+  gpointer id;
+
+  priv->resumed = TRUE;
+  id = gst_task_pool_push (priv->pool_id, (GstTaskPoolFunction) gst_task_func,
+      task, &error);
+
+  if (error != NULL) {
+    GST_WARNING_OBJECT (task, "failed to reschedule task: %s", error->message);
+    g_error_free (error);
+    priv->resumed = FALSE;
+    return FALSE;
+  }
+
+  /* only the handle of the initial push is joined */
+  if (id)
+    gst_task_pool_dispose_handle (priv->pool_id, id);
+
+  return TRUE;
+}
+
 static void
 gst_task_func (GstTask * task)
 {
   GRecMutex *lock;
   GThread *tself;
   GstTaskPrivate *priv;
+  gboolean cooperative, resumed;
 
   priv = task->priv;
 
@@ -342,16 +376,20 @@ gst_task_func (GstTask * task)
    * mark our state running so that nobody can mess with
    * the mutex. */
   GST_OBJECT_LOCK (task);
+  resumed = priv->resumed;
+  priv->resumed = FALSE;
   if (GET_TASK_STATE (task) == GST_TASK_STOPPED)
     goto exit;
   lock = GST_TASK_GET_LOCK (task);
   if (G_UNLIKELY (lock == NULL))
     goto no_lock;
   task->thread = tself;
+  cooperative = GST_IS_WORK_STEALING_TASK_POOL (priv->pool_id);
   GST_OBJECT_UNLOCK (task);
 
-  /* fire the enter_func callback when we need to */
-  if (priv->enter_func)
+  /* fire the enter_func callback when we need to, only once when the task
+   * moves between the workers of a work-stealing pool */
+  if (priv->enter_func && !resumed)
     priv->enter_func (task, tself, priv->enter_user_data);
 
   /* locking order is TASK_LOCK, LOCK */
@@ -364,6 +402,17 @@ gst_task_func (GstTask * task)
     while (G_UNLIKELY (GST_TASK_STATE (task) == GST_TASK_PAUSED)) {
       g_rec_mutex_unlock (lock);
 
+      if (cooperative) {
+        /* don't block a worker while paused, we get pushed to the pool
+         * again when the state changes */
+        GST_INFO_OBJECT (task, "Task parked while paused");
+        priv->parked = TRUE;
+        task->thread = NULL;
+        GST_TASK_SIGNAL (task);
+        GST_OBJECT_UNLOCK (task);
+        return;
+      }
+
       GST_TASK_SIGNAL (task);
       GST_INFO_OBJECT (task, "Task going to paused");
       GST_TASK_WAIT (task);
@@ -382,6 +431,30 @@ gst_task_func (GstTask * task)
     }
 
     task->func (task->user_data);
+
+    /* give up the worker when other tasks are waiting for one */
+    if (cooperative
+        && _priv_gst_work_stealing_task_pool_should_yield (priv->pool_id)) {
+      gboolean yielded = FALSE;
+
+      g_rec_mutex_unlock (lock);
+
+      GST_OBJECT_LOCK (task);
+      if (GET_TASK_STATE (task) == GST_TASK_STARTED) {
+        task->thread = NULL;
+        yielded = gst_task_reschedule_unlocked (task);
+        if (!yielded)
+          task->thread = tself;
+      }
+      GST_OBJECT_UNLOCK (task);
+
+      if (yielded) {
+        GST_LOG_OBJECT (task, "yielded worker");
+        return;
+      }
+
+      g_rec_mutex_lock (lock);
+    }
   }
 
   g_rec_mutex_unlock (lock);
@@ -745,6 +818,14 @@ gst_task_set_state_unlocked (GstTask * task, GstTaskState state)
         break;
       case GST_TASK_PAUSED:
         /* when we are paused, signal to go to the new state */
+        if (task->priv->parked) {
+          /* or continue on a worker of the work-stealing pool */
+          task->priv->parked = FALSE;
+          if (!gst_task_reschedule_unlocked (task)) {
+            task->priv->parked = TRUE;
+            res = FALSE;
+          }
+        }
         GST_TASK_SIGNAL (task);
         break;
       case GST_TASK_STARTED:
@@ -916,6 +997,12 @@ gst_task_join (GstTask * task)
   SET_TASK_STATE (task, GST_TASK_STOPPED);
   /* signal the state change for when it was blocked in PAUSED. */
   GST_TASK_SIGNAL (task);
+  /* a task parked on a work-stealing pool has to run once more to exit */
+  if (priv->parked) {
+    priv->parked = FALSE;
+    if (!gst_task_reschedule_unlocked (task))
+      goto reschedule_failed;
+  }
   /* we set the running flag when pushing the task on the thread pool.
    * This means that the task function might not be called when we try
    * to join it here. */
@@ -951,4 +1038,27 @@ joining_self:
         "schedule the state change from the main thread.\n", task);
     return FALSE;
   }
+reschedule_failed:
+  {
+    /* the pool is gone, finish the task here */
+    GST_WARNING_OBJECT (task, "could not reschedule parked task");
+    task->running = FALSE;
+    pool = priv->pool_id;
+    id = priv->id;
+    priv->pool_id = NULL;
+    priv->id = NULL;
+    GST_OBJECT_UNLOCK (task);
+
+    if (priv->leave_func)
+      priv->leave_func (task, tself, priv->leave_user_data);
+
+    if (pool) {
+      if (id)
+        gst_task_pool_join (pool, id);
+      gst_object_unref (pool);
+    }
+    /* the ref of the task function */
+    gst_object_unref (task);
+    return TRUE;
+  }
 }
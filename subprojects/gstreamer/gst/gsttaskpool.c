@@ -29,14 +29,32 @@
  * implementation uses a regular GThreadPool to start tasks.
  *
  * Subclasses can be made to create custom threads.
+ *
+ * #GstWorkStealingTaskPool runs its tasks on a fixed number of worker threads,
+ * by default one per CPU core. Each worker has its own run queue and idle
+ * workers steal tasks from the queues of busy ones. A #GstTask that runs on
+ * such a pool gives up its worker between two iterations of its function when
+ * other tasks are waiting, so that many streaming threads can share a few
+ * OS threads. It can be configured on the tasks of a pipeline from the
+ * %GST_STREAM_STATUS_TYPE_CREATE stream status message with
+ * gst_task_set_pool().
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1           /* for pthread_setaffinity_np() */
+#endif
+
 #include "gst_private.h"
 
 #include "gstinfo.h"
 #include "gsttaskpool.h"
 #include "gsterror.h"
 
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 GST_DEBUG_CATEGORY_STATIC (taskpool_debug);
 #define GST_CAT_DEFAULT (taskpool_debug)
 
@@ -324,9 +342,17 @@ gst_task_pool_dispose_handle (GstTaskPool * pool, gpointer id)
     klass->dispose_handle (pool, id);
 }
 
+typedef enum
+{
+  SHARED_TASK_PENDING,
+  SHARED_TASK_RUNNING,
+  SHARED_TASK_CANCELLED,
+} SharedTaskState;
+
 typedef struct
 {
   gboolean done;
+  gint state;
   guint64 id;
   GstTaskPoolFunction func;
   gpointer user_data;
@@ -366,7 +392,9 @@ G_DEFINE_TYPE_WITH_PRIVATE (GstSharedTaskPool, gst_shared_task_pool,
 static void
 shared_func (SharedTaskData * tdata, GstTaskPool * pool)
 {
-  tdata->func (tdata->user_data);
+  if (g_atomic_int_compare_and_exchange (&tdata->state, SHARED_TASK_PENDING,
+          SHARED_TASK_RUNNING))
+    tdata->func (tdata->user_data);
 
   g_mutex_lock (&tdata->done_lock);
   tdata->done = TRUE;
@@ -392,13 +420,24 @@ shared_push (GstTaskPool * pool, GstTaskPoolFunction func,
   ret = g_slice_new (SharedTaskData);
 
   ret->done = FALSE;
+  ret->state = SHARED_TASK_PENDING;
   ret->func = func;
   ret->user_data = user_data;
   g_atomic_int_set (&ret->refcount, 1);
   g_cond_init (&ret->done_cond);
   g_mutex_init (&ret->done_lock);
 
-  g_thread_pool_push (pool->pool, shared_task_data_ref (ret), error);
+  if (!g_thread_pool_push (pool->pool, shared_task_data_ref (ret), error)) {
+    /* No thread could be started but the task is queued anyway and would run
+     * whenever a thread becomes available. Unless one of the existing threads
+     * already took it, make it do nothing then and return no handle so that
+     * the caller can run it itself. */
+    if (g_atomic_int_compare_and_exchange (&ret->state, SHARED_TASK_PENDING,
+            SHARED_TASK_CANCELLED)) {
+      shared_task_data_unref (ret);
+      ret = NULL;
+    }
+  }
 
   GST_OBJECT_UNLOCK (pool);
 
@@ -532,6 +571,10 @@ gst_shared_task_pool_get_max_threads (GstSharedTaskPool * pool)
  * as pad tasks, as having one task waiting on another to return before returning
  * would cause obvious deadlocks if they happen to share the same thread.
  *
+ * When gst_task_pool_push() fails to start a thread for a task it sets the
+ * error and, unless one of the existing threads already runs the task,
+ * returns %NULL and never runs it, so the caller can run it itself.
+ *
  * Returns: (transfer full): a new #GstSharedTaskPool. gst_object_unref() after usage.
  * Since: 1.20
  */
@@ -547,3 +590,574 @@ gst_shared_task_pool_new (void)
 
   return pool;
 }
+
+struct _GstWorkStealingTaskPoolPrivate
+{
+  guint n_threads;
+  gboolean pin_threads;
+
+  /* protects all the fields below, the queues have their own lock */
+  GMutex lock;
+  /* idle workers wait on this one */
+  GCond cond;
+  /* the monitor and cleanup wait on this one */
+  GCond monitor_cond;
+
+  gboolean running;
+  struct _StealingWorker **workers;
+  guint n_workers;
+  guint next_worker;
+  guint n_spares;
+  GThread *monitor;
+
+  /* accessed atomically */
+  gint n_idle;
+  gint n_queued;
+  gint n_started;
+};
+
+/* Interval of the monitor checking for starved queues */
+#define STEALING_MONITOR_INTERVAL (10 * G_TIME_SPAN_MILLISECOND)
+/* Time after which an idle spare worker exits */
+#define STEALING_SPARE_IDLE_TIMEOUT (G_TIME_SPAN_SECOND)
+
+typedef struct _StealingWorker
+{
+  GstWorkStealingTaskPool *pool;
+  GThread *thread;
+  guint index;
+  /* spare workers are added when all workers are blocked, they have no
+   * queue of their own and exit again when idle */
+  gboolean spare;
+
+  GMutex lock;
+  GQueue queue;
+} StealingWorker;
+
+static GPrivate current_worker;
+
+G_DEFINE_TYPE_WITH_PRIVATE (GstWorkStealingTaskPool,
+    gst_work_stealing_task_pool, GST_TYPE_TASK_POOL);
+
+static void
+stealing_worker_pin (StealingWorker * worker)
+{
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+  cpu_set_t allowed, set;
+  guint n_allowed, nth, cpu;
+
+  /* pick the n-th CPU we are allowed to run on, which also works when
+   * restricted to a subset of the CPUs */
+  CPU_ZERO (&allowed);
+  if (pthread_getaffinity_np (pthread_self (), sizeof (allowed), &allowed) != 0)
+    goto failed;
+
+  n_allowed = CPU_COUNT (&allowed);
+  if (n_allowed == 0)
+    goto failed;
+
+  nth = worker->index % n_allowed;
+  for (cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (CPU_ISSET (cpu, &allowed) && nth-- == 0)
+      break;
+  }
+
+  CPU_ZERO (&set);
+  CPU_SET (cpu, &set);
+  if (pthread_setaffinity_np (pthread_self (), sizeof (set), &set) != 0)
+    goto failed;
+
+  GST_DEBUG_OBJECT (worker->pool, "pinned worker %u to CPU %u", worker->index,
+      cpu);
+  return;
+
+failed:
+  GST_WARNING_OBJECT (worker->pool, "failed to pin worker %u", worker->index);
+#else
+  GST_DEBUG_OBJECT (worker->pool, "CPU affinity is not supported");
+#endif
+}
+
+/* Takes a task from the queue of @worker, or steals one from another
+ * worker when that is empty */
+static SharedTaskData *
+stealing_worker_pop (StealingWorker * worker)
+{
+  GstWorkStealingTaskPoolPrivate *priv = worker->pool->priv;
+  SharedTaskData *tdata;
+  guint i, start;
+
+  if (!worker->spare) {
+    g_mutex_lock (&worker->lock);
+    tdata = g_queue_pop_head (&worker->queue);
+    g_mutex_unlock (&worker->lock);
+
+    if (tdata)
+      return tdata;
+
+    start = worker->index + 1;
+  } else {
+    start = 0;
+  }
+
+  for (i = 0; i < priv->n_workers; i++) {
+    StealingWorker *victim = priv->workers[(start + i) % priv->n_workers];
+
+    if (victim == worker)
+      continue;
+
+    g_mutex_lock (&victim->lock);
+    tdata = g_queue_pop_tail (&victim->queue);
+    g_mutex_unlock (&victim->lock);
+
+    if (tdata) {
+      GST_LOG_OBJECT (worker->pool, "worker %u stole task %p from worker %u",
+          worker->index, tdata, victim->index);
+      return tdata;
+    }
+  }
+
+  return NULL;
+}
+
+static gpointer
+stealing_worker_func (StealingWorker * worker)
+{
+  GstWorkStealingTaskPool *pool = worker->pool;
+  GstWorkStealingTaskPoolPrivate *priv = pool->priv;
+
+  g_private_set (&current_worker, worker);
+
+  /* wait until whoever created us is done setting up the workers */
+  g_mutex_lock (&priv->lock);
+  g_mutex_unlock (&priv->lock);
+
+  if (priv->pin_threads && !worker->spare)
+    stealing_worker_pin (worker);
+
+  while (TRUE) {
+    SharedTaskData *tdata;
+    gboolean timed_out = FALSE;
+
+    if ((tdata = stealing_worker_pop (worker))) {
+      g_atomic_int_add (&priv->n_queued, -1);
+      g_atomic_int_inc (&priv->n_started);
+      shared_func (tdata, GST_TASK_POOL_CAST (pool));
+      continue;
+    }
+
+    g_mutex_lock (&priv->lock);
+    /* a task was pushed but not queued yet, try again */
+    if (g_atomic_int_get (&priv->n_queued) > 0) {
+      g_mutex_unlock (&priv->lock);
+      continue;
+    }
+    if (!priv->running) {
+      g_mutex_unlock (&priv->lock);
+      break;
+    }
+
+    g_atomic_int_inc (&priv->n_idle);
+    if (worker->spare) {
+      timed_out = !g_cond_wait_until (&priv->cond, &priv->lock,
+          g_get_monotonic_time () + STEALING_SPARE_IDLE_TIMEOUT);
+    } else {
+      g_cond_wait (&priv->cond, &priv->lock);
+    }
+    g_atomic_int_add (&priv->n_idle, -1);
+
+    if (timed_out && g_atomic_int_get (&priv->n_queued) == 0) {
+      g_mutex_unlock (&priv->lock);
+      break;
+    }
+    g_mutex_unlock (&priv->lock);
+  }
+
+  g_private_set (&current_worker, NULL);
+
+  if (worker->spare) {
+    GST_DEBUG_OBJECT (pool, "spare worker exiting");
+
+    g_mutex_lock (&priv->lock);
+    priv->n_spares--;
+    g_cond_broadcast (&priv->monitor_cond);
+    g_mutex_unlock (&priv->lock);
+
+    g_mutex_clear (&worker->lock);
+    g_free (worker);
+  }
+
+  return NULL;
+}
+
+static StealingWorker *
+stealing_worker_new (GstWorkStealingTaskPool * pool, guint index,
+    gboolean spare, GError ** error)
+{
+  StealingWorker *worker;
+  gchar *name;
+
+  worker = g_new0 (StealingWorker, 1);
+  worker->pool = pool;
+  worker->index = index;
+  worker->spare = spare;
+  g_mutex_init (&worker->lock);
+  g_queue_init (&worker->queue);
+
+  name = g_strdup_printf ("gstws-%u", index);
+  worker->thread = g_thread_try_new (name,
+      (GThreadFunc) stealing_worker_func, worker, error);
+  g_free (name);
+
+  if (worker->thread == NULL) {
+    g_mutex_clear (&worker->lock);
+    g_free (worker);
+    return NULL;
+  }
+
+  return worker;
+}
+
+/* call with the lock */
+static void
+stealing_pool_add_spare (GstWorkStealingTaskPool * pool)
+{
+  GstWorkStealingTaskPoolPrivate *priv = pool->priv;
+  StealingWorker *worker;
+  GError *err = NULL;
+
+  worker = stealing_worker_new (pool, priv->n_workers + priv->n_spares, TRUE,
+      &err);
+  if (worker == NULL) {
+    GST_WARNING_OBJECT (pool, "failed to add spare worker: %s", err->message);
+    g_clear_error (&err);
+    return;
+  }
+
+  GST_DEBUG_OBJECT (pool, "all workers blocked, added spare worker %u",
+      worker->index);
+
+  /* spare workers clean up after themselves */
+  g_thread_unref (worker->thread);
+  priv->n_spares++;
+}
+
+static gpointer
+stealing_monitor_func (GstWorkStealingTaskPool * pool)
+{
+  GstWorkStealingTaskPoolPrivate *priv = pool->priv;
+  gint last_started = 0;
+
+  g_mutex_lock (&priv->lock);
+  while (priv->running) {
+    gint started;
+
+    g_cond_wait_until (&priv->monitor_cond, &priv->lock,
+        g_get_monotonic_time () + STEALING_MONITOR_INTERVAL);
+    if (!priv->running)
+      break;
+
+    /* Tasks are waiting but no worker picked up anything since the last
+     * check, so all of them are blocked inside a task function. Add a spare
+     * worker, the blocked tasks might be waiting for one of the queued ones */
+    started = g_atomic_int_get (&priv->n_started);
+    if (g_atomic_int_get (&priv->n_idle) == 0
+        && g_atomic_int_get (&priv->n_queued) > 0 && started == last_started)
+      stealing_pool_add_spare (pool);
+    last_started = started;
+  }
+  g_mutex_unlock (&priv->lock);
+
+  return NULL;
+}
+
+static void
+stealing_prepare (GstTaskPool * pool, GError ** error)
+{
+  GstWorkStealingTaskPool *stealing_pool = GST_WORK_STEALING_TASK_POOL (pool);
+  GstWorkStealingTaskPoolPrivate *priv = stealing_pool->priv;
+  guint i;
+
+  g_mutex_lock (&priv->lock);
+  if (priv->workers)
+    goto done;
+
+  priv->running = TRUE;
+  priv->n_workers = 0;
+  priv->workers = g_new0 (StealingWorker *, priv->n_threads);
+  for (i = 0; i < priv->n_threads; i++) {
+    StealingWorker *worker;
+
+    worker = stealing_worker_new (stealing_pool, i, FALSE, error);
+    if (worker == NULL)
+      goto no_thread;
+
+    priv->workers[priv->n_workers++] = worker;
+  }
+
+  priv->monitor = g_thread_try_new ("gstws-monitor",
+      (GThreadFunc) stealing_monitor_func, stealing_pool, error);
+  if (priv->monitor == NULL)
+    goto no_thread;
+
+  GST_DEBUG_OBJECT (pool, "started %u workers", priv->n_workers);
+
+done:
+  g_mutex_unlock (&priv->lock);
+  return;
+
+  /* ERRORS */
+no_thread:
+  {
+    /* the workers we have stop again and are freed on cleanup */
+    GST_WARNING_OBJECT (pool, "failed to start worker threads");
+    priv->running = FALSE;
+    g_cond_broadcast (&priv->cond);
+    goto done;
+  }
+}
+
+static void
+stealing_cleanup (GstTaskPool * pool)
+{
+  GstWorkStealingTaskPoolPrivate *priv = GST_WORK_STEALING_TASK_POOL (pool)->priv;
+  StealingWorker **workers;
+  GThread *monitor;
+  guint i, n_workers;
+
+  g_mutex_lock (&priv->lock);
+  workers = priv->workers;
+  n_workers = priv->n_workers;
+  monitor = priv->monitor;
+  priv->running = FALSE;
+  priv->monitor = NULL;
+  g_cond_broadcast (&priv->cond);
+  g_cond_broadcast (&priv->monitor_cond);
+  g_mutex_unlock (&priv->lock);
+
+  if (workers == NULL)
+    return;
+
+  /* the workers still run all tasks that were scheduled before exiting */
+  if (monitor)
+    g_thread_join (monitor);
+  for (i = 0; i < n_workers; i++)
+    g_thread_join (workers[i]->thread);
+
+  g_mutex_lock (&priv->lock);
+  while (priv->n_spares > 0)
+    g_cond_wait (&priv->monitor_cond, &priv->lock);
+  priv->workers = NULL;
+  priv->n_workers = 0;
+  g_mutex_unlock (&priv->lock);
+
+  for (i = 0; i < n_workers; i++) {
+    g_mutex_clear (&workers[i]->lock);
+    g_free (workers[i]);
+  }
+  g_free (workers);
+}
+
+static gpointer
+stealing_push (GstTaskPool * pool, GstTaskPoolFunction func,
+    gpointer user_data, GError ** error)
+{
+  GstWorkStealingTaskPool *stealing_pool = GST_WORK_STEALING_TASK_POOL (pool);
+  GstWorkStealingTaskPoolPrivate *priv = stealing_pool->priv;
+  StealingWorker *worker;
+  SharedTaskData *ret;
+
+  g_mutex_lock (&priv->lock);
+  if (!priv->running || priv->n_workers == 0)
+    goto not_running;
+
+  /* Tasks pushed from one of our workers, like a yielding #GstTask, stay on
+   * that worker's queue and thus on the same CPU unless they get stolen */
+  worker = g_private_get (&current_worker);
+  if (worker == NULL || worker->pool != stealing_pool || worker->spare)
+    worker = priv->workers[priv->next_worker++ % priv->n_workers];
+
+  ret = g_slice_new (SharedTaskData);
+  ret->done = FALSE;
+  ret->func = func;
+  ret->user_data = user_data;
+  g_atomic_int_set (&ret->refcount, 1);
+  g_cond_init (&ret->done_cond);
+  g_mutex_init (&ret->done_lock);
+
+  g_atomic_int_inc (&priv->n_queued);
+  g_mutex_lock (&worker->lock);
+  g_queue_push_tail (&worker->queue, shared_task_data_ref (ret));
+  g_mutex_unlock (&worker->lock);
+
+  if (g_atomic_int_get (&priv->n_idle) > 0)
+    g_cond_signal (&priv->cond);
+  g_mutex_unlock (&priv->lock);
+
+  return ret;
+
+  /* ERRORS */
+not_running:
+  {
+    g_mutex_unlock (&priv->lock);
+    g_set_error_literal (error, GST_CORE_ERROR, GST_CORE_ERROR_FAILED,
+        "No thread pool");
+    return NULL;
+  }
+}
+
+static void
+gst_work_stealing_task_pool_finalize (GObject * object)
+{
+  GstWorkStealingTaskPoolPrivate *priv =
+      GST_WORK_STEALING_TASK_POOL (object)->priv;
+
+  g_mutex_clear (&priv->lock);
+  g_cond_clear (&priv->cond);
+  g_cond_clear (&priv->monitor_cond);
+
+  G_OBJECT_CLASS (gst_work_stealing_task_pool_parent_class)->finalize (object);
+}
+
+static void
+gst_work_stealing_task_pool_class_init (GstWorkStealingTaskPoolClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstTaskPoolClass *taskpoolclass = GST_TASK_POOL_CLASS (klass);
+
+  gobject_class->finalize = gst_work_stealing_task_pool_finalize;
+
+  taskpoolclass->prepare = stealing_prepare;
+  taskpoolclass->cleanup = stealing_cleanup;
+  taskpoolclass->push = stealing_push;
+  taskpoolclass->join = shared_join;
+  taskpoolclass->dispose_handle = shared_dispose_handle;
+}
+
+static void
+gst_work_stealing_task_pool_init (GstWorkStealingTaskPool * pool)
+{
+  GstWorkStealingTaskPoolPrivate *priv;
+
+  priv = pool->priv = gst_work_stealing_task_pool_get_instance_private (pool);
+  priv->n_threads = 1;
+  priv->pin_threads = FALSE;
+  g_mutex_init (&priv->lock);
+  g_cond_init (&priv->cond);
+  g_cond_init (&priv->monitor_cond);
+}
+
+/* Returns %TRUE when called from a worker of @pool while other tasks are
+ * waiting and no worker is idle to pick them up */
+gboolean
+_priv_gst_work_stealing_task_pool_should_yield (GstTaskPool * pool)
+{
+  GstWorkStealingTaskPoolPrivate *priv;
+  StealingWorker *worker;
+
+  worker = g_private_get (&current_worker);
+  if (worker == NULL || GST_TASK_POOL_CAST (worker->pool) != pool)
+    return FALSE;
+
+  priv = worker->pool->priv;
+
+  return g_atomic_int_get (&priv->n_queued) > 0
+      && g_atomic_int_get (&priv->n_idle) == 0;
+}
+
+/**
+ * gst_work_stealing_task_pool_set_pin_threads:
+ * @pool: a #GstWorkStealingTaskPool
+ * @pin_threads: whether to pin the workers to CPUs
+ *
+ * Configure if the workers of @pool are pinned to a CPU each, worker N
+ * running on the N-th CPU the process may use. Together with the per-worker
+ * run queues this keeps tasks on the same CPU unless they get stolen by an
+ * idle worker. Only has an effect on platforms that support thread affinity
+ * and must be called before gst_task_pool_prepare().
+ *
+ * Since: 1.24
+ */
+void
+gst_work_stealing_task_pool_set_pin_threads (GstWorkStealingTaskPool * pool,
+    gboolean pin_threads)
+{
+  g_return_if_fail (GST_IS_WORK_STEALING_TASK_POOL (pool));
+
+  g_mutex_lock (&pool->priv->lock);
+  pool->priv->pin_threads = pin_threads;
+  g_mutex_unlock (&pool->priv->lock);
+}
+
+/**
+ * gst_work_stealing_task_pool_get_pin_threads:
+ * @pool: a #GstWorkStealingTaskPool
+ *
+ * Returns: whether the workers of @pool are pinned to CPUs
+ *
+ * Since: 1.24
+ */
+gboolean
+gst_work_stealing_task_pool_get_pin_threads (GstWorkStealingTaskPool * pool)
+{
+  gboolean ret;
+
+  g_return_val_if_fail (GST_IS_WORK_STEALING_TASK_POOL (pool), FALSE);
+
+  g_mutex_lock (&pool->priv->lock);
+  ret = pool->priv->pin_threads;
+  g_mutex_unlock (&pool->priv->lock);
+
+  return ret;
+}
+
+/**
+ * gst_work_stealing_task_pool_get_n_threads:
+ * @pool: a #GstWorkStealingTaskPool
+ *
+ * Returns: the number of workers of @pool, not counting the spare workers
+ * that are temporarily added when all workers are blocked
+ *
+ * Since: 1.24
+ */
+guint
+gst_work_stealing_task_pool_get_n_threads (GstWorkStealingTaskPool * pool)
+{
+  g_return_val_if_fail (GST_IS_WORK_STEALING_TASK_POOL (pool), 0);
+
+  return pool->priv->n_threads;
+}
+
+/**
+ * gst_work_stealing_task_pool_new:
+ * @n_threads: the number of worker threads, or 0 for one per CPU
+ *
+ * Create a new work-stealing task pool. The pool runs its tasks on
+ * @n_threads workers, each with its own run queue. Idle workers steal
+ * tasks from the queues of busy ones.
+ *
+ * A #GstTask running on this pool gives up its worker after an iteration
+ * of its function when other tasks are waiting to run, and does not keep a
+ * worker busy while paused. A task function that blocks, for example
+ * waiting for data, still blocks its worker. When all workers are blocked
+ * while tasks are waiting, spare workers are added until they become idle
+ * again, so inter-dependent tasks can't deadlock the pool.
+ *
+ * Returns: (transfer full): a new #GstWorkStealingTaskPool.
+ * gst_object_unref() after usage.
+ *
+ * Since: 1.24
+ */
+GstTaskPool *
+gst_work_stealing_task_pool_new (guint n_threads)
+{
+  GstWorkStealingTaskPool *pool;
+
+  pool = g_object_new (GST_TYPE_WORK_STEALING_TASK_POOL, NULL);
+  pool->priv->n_threads = n_threads > 0 ? n_threads : g_get_num_processors ();
+
+  /* clear floating flag */
+  gst_object_ref_sink (pool);
+
+  return GST_TASK_POOL_CAST (pool);
+}
@@ -120,6 +120,11 @@ gst_type_find_factory_dispose (GObject * object)
     gst_caps_unref (factory->caps);
     factory->caps = NULL;
   }
+  factory->caps_str = NULL;
+  if (factory->cache) {
+    g_bytes_unref (factory->cache);
+    factory->cache = NULL;
+  }
   if (factory->extensions) {
     g_strfreev (factory->extensions);
     factory->extensions = NULL;
@@ -164,9 +169,33 @@ gst_type_find_factory_get_list (void)
 GstCaps *
 gst_type_find_factory_get_caps (GstTypeFindFactory * factory)
 {
+  GstCaps *caps;
+
   g_return_val_if_fail (GST_IS_TYPE_FIND_FACTORY (factory), NULL);
 
-  return factory->caps;
+  caps = g_atomic_pointer_get (&factory->caps);
+  if (G_LIKELY (caps != NULL || factory->caps_str == NULL))
+    return caps;
+
+  if (g_atomic_int_get (&factory->caps_invalid))
+    return NULL;
+
+  /* factories loaded from the registry cache parse their caps when they are
+   * first needed */
+  caps = gst_caps_from_string (factory->caps_str);
+  if (G_UNLIKELY (caps == NULL)) {
+    GST_WARNING_OBJECT (factory, "invalid caps '%s'", factory->caps_str);
+    g_atomic_int_set (&factory->caps_invalid, TRUE);
+    return NULL;
+  }
+
+  if (!g_atomic_pointer_compare_and_exchange (&factory->caps, NULL,
+          caps)) {
+    gst_caps_unref (caps);
+    caps = g_atomic_pointer_get (&factory->caps);
+  }
+
+  return caps;
 }
 
 /**
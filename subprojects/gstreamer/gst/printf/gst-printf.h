@@ -25,6 +25,8 @@
 /* Private namespace for gnulib functions */
 #define asnprintf        __gst_asnprintf
 #define vasnprintf       __gst_vasnprintf
+#define vcaptureargs     __gst_vcaptureargs
+#define asnprintf_captured __gst_asnprintf_captured
 #define printf_parse     __gst_printf_parse
 #define printf_fetchargs __gst_printf_fetchargs
 
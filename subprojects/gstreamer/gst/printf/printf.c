@@ -157,3 +157,22 @@ __gst_vasprintf (char **result, char const *format, va_list args)
 
   return length;
 }
+
+int
+__gst_vcapture_args (char *buf, size_t size, char const *format, va_list args)
+{
+  return vcaptureargs (buf, size, format, args);
+}
+
+int
+__gst_asprintf_captured (char **result, char const *format, char const *buf,
+    size_t size)
+{
+  size_t length;
+
+  *result = asnprintf_captured (NULL, &length, format, buf, size);
+  if (*result == NULL)
+    return -1;
+
+  return length;
+}
@@ -60,5 +60,15 @@ int __gst_vasprintf (char       **result,
                      char const *format,
                      va_list      args);
 
+int __gst_vcapture_args (char       *buf,
+                         size_t      size,
+                         char const *format,
+                         va_list     args);
+
+int __gst_asprintf_captured (char       **result,
+                             char const  *format,
+                             char const  *buf,
+                             size_t       size);
+
 
 #endif /* __GNULIB_PRINTF_H__ */
@@ -246,7 +246,8 @@ printf_postprocess_args (char_directives * directives, arguments * arguments)
 
     a = &arguments->arg[dp->arg_index];
 
-    if (a->type == TYPE_POINTER_EXT) {
+    /* captured arguments come with their string already */
+    if (a->type == TYPE_POINTER_EXT && a->ext_string == NULL) {
       char fmt[4];
 
       fmt[0] = 'p';
@@ -260,16 +261,6 @@ printf_postprocess_args (char_directives * directives, arguments * arguments)
   }
 }
 
-char *
-vasnprintf (char *resultbuf, size_t * lengthp, const char *format, va_list args)
-{
-  char_directives d;
-  arguments a;
-
-  if (printf_parse (format, &d, &a) < 0) {
-    errno = EINVAL;
-    return NULL;
-  }
 #define CLEANUP()                         \
   free (d.dir);                           \
   if (a.arg) {                            \
@@ -280,12 +271,12 @@ vasnprintf (char *resultbuf, size_t * lengthp, const char *format, va_list args)
     free (a.arg);                         \
   }
 
-  if (printf_fetchargs (args, &a) < 0) {
-    CLEANUP ();
-    errno = EINVAL;
-    return NULL;
-  }
-
+/* formats the parsed @format with the arguments in @a, takes ownership of
+ * the memory of @d and @a */
+static char *
+vasnprintf_parsed (char *resultbuf, size_t * lengthp, const char *format,
+    char_directives d, arguments a)
+{
   /* collect TYPE_POINTER_EXT argument strings */
   printf_postprocess_args (&d, &a);
 
@@ -1039,3 +1030,239 @@ vasnprintf (char *resultbuf, size_t * lengthp, const char *format, va_list args)
     return result;
   }
 }
+
+char *
+vasnprintf (char *resultbuf, size_t * lengthp, const char *format, va_list args)
+{
+  char_directives d;
+  arguments a;
+
+  if (printf_parse (format, &d, &a) < 0) {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  if (printf_fetchargs (args, &a) < 0) {
+    CLEANUP ();
+    errno = EINVAL;
+    return NULL;
+  }
+
+  return vasnprintf_parsed (resultbuf, lengthp, format, d, a);
+}
+
+/* Captured arguments are stored one after the other in the order of the
+ * arguments. Plain values are stored as the argument union, strings as their
+ * length followed by the bytes and a NUL. The types are not stored, they
+ * are known again when parsing the format for formatting. */
+#define CAPTURED_NULL_STRING ((unsigned int) -1)
+
+static size_t
+capture_string (char *buf, size_t size, size_t pos, const char *str,
+    int max_len)
+{
+  unsigned int len;
+
+  if (str == NULL) {
+    len = CAPTURED_NULL_STRING;
+  } else if (max_len >= 0) {
+    const char *end = memchr (str, '\0', max_len);
+
+    len = end ? end - str : max_len;
+  } else {
+    len = strlen (str);
+  }
+
+  if (pos + sizeof (len) <= size)
+    memcpy (buf + pos, &len, sizeof (len));
+  pos += sizeof (len);
+
+  if (len != CAPTURED_NULL_STRING) {
+    if (pos + len + 1 <= size) {
+      memcpy (buf + pos, str, len);
+      buf[pos + len] = '\0';
+    }
+    pos += len + 1;
+  }
+
+  return pos;
+}
+
+int
+vcaptureargs (char *buf, size_t size, const char *format, va_list args)
+{
+  char_directives d;
+  arguments a;
+  int *max_lens;
+  size_t pos = 0;
+  unsigned int i;
+
+  if (printf_parse (format, &d, &a) < 0)
+    return -1;
+
+  if (printf_fetchargs (args, &a) < 0) {
+    CLEANUP ();
+    return -1;
+  }
+
+  /* strings with a precision don't need to be NUL terminated */
+  max_lens = alloca (a.count * sizeof (int) + 1);
+  for (i = 0; i < a.count; i++)
+    max_lens[i] = -1;
+  for (i = 0; i < d.count; i++) {
+    char_directive *dp = &d.dir[i];
+
+    if (dp->conversion != 's' || dp->precision_start == dp->precision_end)
+      continue;
+
+    if (dp->precision_arg_index >= 0) {
+      max_lens[dp->arg_index] =
+          MAX (a.arg[dp->precision_arg_index].a.a_int, 0);
+    } else {
+      const char *digitp = dp->precision_start + 1;
+      int precision = 0;
+
+      while (digitp != dp->precision_end)
+        precision = precision * 10 + (*digitp++ - '0');
+      max_lens[dp->arg_index] = precision;
+    }
+  }
+
+  for (i = 0; i < a.count; i++) {
+    argument *ap = &a.arg[i];
+
+    switch (ap->type) {
+      case TYPE_STRING:
+        pos = capture_string (buf, size, pos, ap->a.a_string, max_lens[i]);
+        break;
+      case TYPE_POINTER_EXT:{
+        char fmt[4] = { 'p', POINTER_EXT_SIGNIFIER_CHAR, 0, '\0' };
+        char *str;
+        unsigned int j;
+
+        /* whatever the pointer points to might be gone later */
+        for (j = 0; j < d.count; j++) {
+          if (d.dir[j].arg_index == (int) i)
+            fmt[2] = d.dir[j].ptr_ext_char;
+        }
+        str = __gst_printf_pointer_extension_serialize (fmt, ap->a.a_pointer);
+        if (pos + sizeof (ap->a) <= size)
+          memcpy (buf + pos, &ap->a, sizeof (ap->a));
+        pos += sizeof (ap->a);
+        pos = capture_string (buf, size, pos, str, -1);
+        free (str);
+        break;
+      }
+      case TYPE_COUNT_SCHAR_POINTER:
+      case TYPE_COUNT_SHORT_POINTER:
+      case TYPE_COUNT_INT_POINTER:
+      case TYPE_COUNT_LONGINT_POINTER:
+#ifdef HAVE_LONG_LONG
+      case TYPE_COUNT_LONGLONGINT_POINTER:
+#endif
+        /* %n writes to memory of the caller, can't be done later */
+        freea (max_lens);
+        CLEANUP ();
+        return -1;
+      default:
+        if (pos + sizeof (ap->a) <= size)
+          memcpy (buf + pos, &ap->a, sizeof (ap->a));
+        pos += sizeof (ap->a);
+        break;
+    }
+  }
+
+  freea (max_lens);
+  CLEANUP ();
+
+  return (int) pos;
+}
+
+static int
+restore_string (const char *buf, size_t size, size_t pos, const char **str)
+{
+  unsigned int len;
+
+  if (pos + sizeof (len) > size)
+    return -1;
+  memcpy (&len, buf + pos, sizeof (len));
+  pos += sizeof (len);
+
+  if (len == CAPTURED_NULL_STRING) {
+    *str = NULL;
+    return pos;
+  }
+
+  if (pos + len + 1 > size)
+    return -1;
+  *str = buf + pos;
+
+  return pos + len + 1;
+}
+
+char *
+asnprintf_captured (char *resultbuf, size_t * lengthp, const char *format,
+    const char *buf, size_t size)
+{
+  char_directives d;
+  arguments a;
+  unsigned int i;
+  int pos = 0;
+
+  if (printf_parse (format, &d, &a) < 0) {
+    errno = EINVAL;
+    return NULL;
+  }
+
+  for (i = 0; i < a.count && pos >= 0; i++) {
+    argument *ap = &a.arg[i];
+    const char *str = NULL;
+    char ptr_str[2 + 2 * sizeof (void *) + 1];
+    size_t str_len;
+
+    switch (ap->type) {
+      case TYPE_STRING:
+        pos = restore_string (buf, size, pos, &ap->a.a_string);
+        break;
+      case TYPE_POINTER_EXT:
+        if (pos + sizeof (ap->a) > size) {
+          pos = -1;
+          break;
+        }
+        memcpy (&ap->a, buf + pos, sizeof (ap->a));
+        pos = restore_string (buf, size, pos + sizeof (ap->a), &str);
+        if (pos < 0)
+          break;
+        /* never look at the pointer again. The string is freed with free()
+         * by CLEANUP, so allocate it with malloc() */
+        if (str == NULL) {
+          snprintf (ptr_str, sizeof (ptr_str), "%p", ap->a.a_pointer);
+          str = ptr_str;
+        }
+        str_len = strlen (str) + 1;
+        ap->ext_string = (char *) malloc (str_len);
+        if (ap->ext_string == NULL) {
+          pos = -1;
+          break;
+        }
+        memcpy (ap->ext_string, str, str_len);
+        break;
+      default:
+        if (pos + sizeof (ap->a) > size) {
+          pos = -1;
+          break;
+        }
+        memcpy (&ap->a, buf + pos, sizeof (ap->a));
+        pos += sizeof (ap->a);
+        break;
+    }
+  }
+
+  if (pos < 0) {
+    CLEANUP ();
+    errno = EINVAL;
+    return NULL;
+  }
+
+  return vasnprintf_parsed (resultbuf, lengthp, format, d, a);
+}
@@ -54,6 +54,17 @@ extern char * asnprintf (char *resultbuf, size_t *lengthp, const char *format, .
 extern char * vasnprintf (char *resultbuf, size_t *lengthp, const char *format, va_list args)
        __attribute__ ((__format__ (__printf__, 3, 0)));
 
+/* Store the arguments for FORMAT from ARGS as binary data in BUF, so that the
+   string can be formatted later with asnprintf_captured() without having to
+   keep the arguments around. Strings are copied and pointer extensions are
+   serialized right away. Return the number of bytes needed, which can be more
+   than SIZE in which case BUF is incomplete, or -1 on errors.  */
+extern int vcaptureargs (char *buf, size_t size, const char *format, va_list args);
+
+/* Like asnprintf() but takes the arguments captured with vcaptureargs().  */
+extern char * asnprintf_captured (char *resultbuf, size_t *lengthp, const char *format,
+                                  const char *buf, size_t size);
+
 #ifdef	__cplusplus
 }
 #endif
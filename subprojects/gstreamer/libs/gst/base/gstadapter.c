@@ -126,6 +126,7 @@
 
 #include <gst/gst_private.h>
 #include "gstadapter.h"
+#include "gstbytescan-private.h"
 #include <string.h>
 #include <gst/base/gstqueuearray.h>
 
@@ -1653,7 +1654,8 @@ gssize
 gst_adapter_masked_scan_uint32_peek (GstAdapter * adapter, guint32 mask,
     guint32 pattern, gsize offset, gsize size, guint32 * value)
 {
-  gsize skip, bsize, i;
+  gsize skip, bsize, head, i;
+  gssize ret;
   guint32 state;
   GstMapInfo info;
   guint8 *bdata;
@@ -1703,7 +1705,10 @@ gst_adapter_masked_scan_uint32_peek (GstAdapter * adapter, guint32 mask,
   /* now find data */
   do {
     bsize = MIN (bsize, size);
-    for (i = 0; i < bsize; i++) {
+
+    /* matches that start in the previous buffers end in the first 3 bytes */
+    head = MIN (bsize, 3);
+    for (i = 0; i < head; i++) {
       state = ((state << 8) | bdata[i]);
       if (G_UNLIKELY ((state & mask) == pattern)) {
         /* we have a match but we need to have skipped at
@@ -1716,6 +1721,20 @@ gst_adapter_masked_scan_uint32_peek (GstAdapter * adapter, guint32 mask,
         }
       }
     }
+
+    /* matches inside this buffer */
+    ret = _priv_gst_byte_scan_masked_uint32 (bdata, bsize, mask, pattern);
+    if (ret >= 0) {
+      if (G_LIKELY (value))
+        *value = GST_READ_UINT32_BE (bdata + ret);
+      gst_buffer_unmap (buf, &info);
+      return offset + skip + ret;
+    }
+
+    /* keep the last bytes in the state for the next buffer */
+    for (i = bsize > head + 3 ? bsize - 3 : head; i < bsize; i++)
+      state = ((state << 8) | bdata[i]);
+
     size -= bsize;
     if (size == 0)
       break;
@@ -277,6 +277,12 @@ struct _GstAggregatorPadPrivate
 
   gboolean eos;
 
+  /* Readiness accounting in the aggregator this pad is counted in, see
+   * gst_aggregator_pad_update_readiness_unlocked() */
+  GstAggregator *counted_in;
+  gboolean counted_waiting;
+  gboolean counted_event;
+
   GMutex lock;
   GCond event_cond;
   /* This lock prevents a flush start processing happening while
@@ -288,6 +294,9 @@ struct _GstAggregatorPadPrivate
   gboolean emit_signals;
 };
 
+static void gst_aggregator_pad_update_readiness_unlocked (GstAggregatorPad *
+    aggpad);
+
 /* Must be called with PAD_LOCK held */
 static void
 gst_aggregator_pad_reset_unlocked (GstAggregatorPad * aggpad)
@@ -305,6 +314,7 @@ gst_aggregator_pad_reset_unlocked (GstAggregatorPad * aggpad)
   aggpad->priv->time_level = 0;
   aggpad->priv->first_buffer = TRUE;
   aggpad->priv->waited_once = FALSE;
+  gst_aggregator_pad_update_readiness_unlocked (aggpad);
 }
 
 static gboolean
@@ -411,6 +421,18 @@ struct _GstAggregatorPrivate
   gboolean emit_signals;
   gboolean ignore_inactive_pads;
   gboolean force_live;          /* Construct only, doesn't need any locking */
+  guint max_pad_threads;
+
+  /* used by gst_aggregator_foreach_sink_pad_parallel(), protected by the
+   * object lock */
+  GstTaskPool *pad_pool;
+
+  /* Number of sink pads taking part in the readiness accounting, protected
+   * by the object lock. The two counters are updated atomically with the
+   * PAD_LOCK of the pad that changes held. */
+  guint n_pads_counted;
+  gint n_pads_waiting;          /* no data and not EOS */
+  gint n_pads_with_event;       /* serialized event or query to handle */
 };
 
 /* With SRC_LOCK */
@@ -439,6 +461,7 @@ typedef struct
 #define DEFAULT_START_TIME           (-1)
 #define DEFAULT_EMIT_SIGNALS         FALSE
 #define DEFAULT_FORCE_LIVE           FALSE
+#define DEFAULT_MAX_PAD_THREADS      1
 
 enum
 {
@@ -448,6 +471,7 @@ enum
   PROP_START_TIME_SELECTION,
   PROP_START_TIME,
   PROP_EMIT_SIGNALS,
+  PROP_MAX_PAD_THREADS,
   PROP_LAST
 };
 
@@ -469,6 +493,65 @@ gst_aggregator_pad_queue_is_empty (GstAggregatorPad * pad)
       pad->priv->clipped_buffer == NULL);
 }
 
+/* Must be called with PAD_LOCK held after anything that can change whether
+ * the pad has no data at all or has a serialized event or query at the top of
+ * its queue, so that gst_aggregator_check_pads_ready() can tell most of the
+ * time that it has to wait without looking at every pad */
+static void
+gst_aggregator_pad_update_readiness_unlocked (GstAggregatorPad * aggpad)
+{
+  GstAggregator *self = aggpad->priv->counted_in;
+  gpointer top;
+  gboolean waiting, event;
+
+  if (self == NULL)
+    return;
+
+  top = g_queue_peek_tail (&aggpad->priv->data);
+  waiting = !aggpad->priv->clipped_buffer && top == NULL && !aggpad->priv->eos;
+  event = !aggpad->priv->clipped_buffer && (GST_IS_EVENT (top)
+      || GST_IS_QUERY (top));
+
+  if (waiting != aggpad->priv->counted_waiting) {
+    g_atomic_int_add (&self->priv->n_pads_waiting, waiting ? 1 : -1);
+    aggpad->priv->counted_waiting = waiting;
+  }
+  if (event != aggpad->priv->counted_event) {
+    g_atomic_int_add (&self->priv->n_pads_with_event, event ? 1 : -1);
+    aggpad->priv->counted_event = event;
+  }
+}
+
+/* Must be called with the object lock and PAD_LOCK held */
+static void
+gst_aggregator_pad_count_readiness_unlocked (GstAggregator * self,
+    GstAggregatorPad * aggpad)
+{
+  aggpad->priv->counted_in = self;
+  aggpad->priv->counted_waiting = FALSE;
+  aggpad->priv->counted_event = FALSE;
+  self->priv->n_pads_counted++;
+  gst_aggregator_pad_update_readiness_unlocked (aggpad);
+}
+
+/* Must be called with the object lock and PAD_LOCK held */
+static void
+gst_aggregator_pad_uncount_readiness_unlocked (GstAggregator * self,
+    GstAggregatorPad * aggpad)
+{
+  if (aggpad->priv->counted_in != self)
+    return;
+
+  if (aggpad->priv->counted_waiting)
+    g_atomic_int_add (&self->priv->n_pads_waiting, -1);
+  if (aggpad->priv->counted_event)
+    g_atomic_int_add (&self->priv->n_pads_with_event, -1);
+  aggpad->priv->counted_in = NULL;
+  aggpad->priv->counted_waiting = FALSE;
+  aggpad->priv->counted_event = FALSE;
+  self->priv->n_pads_counted--;
+}
+
 /* Will return FALSE if there's no buffer available on every non-EOS pad, or
  * if at least one of the pads has an event or query at the top of its queue.
  *
@@ -493,11 +576,26 @@ gst_aggregator_check_pads_ready (GstAggregator * self,
   if (sinkpads == NULL)
     goto no_sinkpads;
 
+  /* In non-live mode all pads need data, so if all of them are counted and
+   * one is still waiting for some while none has an event or query to
+   * handle first, there is no need to look at each of them */
+  if (!is_live_unlocked (self)
+      && self->priv->n_pads_counted == GST_ELEMENT_CAST (self)->numsinkpads
+      && g_atomic_int_get (&self->priv->n_pads_with_event) == 0
+      && g_atomic_int_get (&self->priv->n_pads_waiting) > 0) {
+    GST_LOG_OBJECT (self, "%d pads have no buffer and are not EOS yet",
+        g_atomic_int_get (&self->priv->n_pads_waiting));
+    goto pad_not_ready;
+  }
+
   for (l = sinkpads; l != NULL; l = l->next) {
     pad = l->data;
 
     PAD_LOCK (pad);
 
+    if (G_UNLIKELY (pad->priv->counted_in == NULL))
+      gst_aggregator_pad_count_readiness_unlocked (self, pad);
+
     /* If there's an event or query at the top of the queue and we don't yet
      * have taken the top buffer out and stored it as clip_buffer, remember
      * that and exit the loop. We first have to handle all events/queries
@@ -1009,6 +1107,7 @@ gst_aggregator_do_events_and_queries (GstElement * self, GstPad * epad,
         }
       }
 
+      gst_aggregator_pad_update_readiness_unlocked (pad);
       PAD_BROADCAST_EVENT (pad);
       PAD_UNLOCK (pad);
     }
@@ -1049,6 +1148,7 @@ gst_aggregator_pad_skip_buffers (GstElement * self, GstPad * epad,
     item = prev;
   }
 
+  gst_aggregator_pad_update_readiness_unlocked (aggpad);
   PAD_UNLOCK (aggpad);
 
   return TRUE;
@@ -1101,6 +1201,7 @@ gst_aggregator_pad_set_flushing (GstAggregatorPad * aggpad,
   }
   aggpad->priv->num_buffers = 0;
   gst_buffer_replace (&aggpad->priv->clipped_buffer, NULL);
+  gst_aggregator_pad_update_readiness_unlocked (aggpad);
 
   PAD_BROADCAST_EVENT (aggpad);
   PAD_UNLOCK (aggpad);
@@ -1736,6 +1837,7 @@ gst_aggregator_default_sink_event (GstAggregator * self,
       SRC_LOCK (self);
       PAD_LOCK (aggpad);
       aggpad->priv->eos = TRUE;
+      gst_aggregator_pad_update_readiness_unlocked (aggpad);
       PAD_UNLOCK (aggpad);
       SRC_BROADCAST (self);
       SRC_UNLOCK (self);
@@ -1763,6 +1865,7 @@ gst_aggregator_default_sink_event (GstAggregator * self,
     {
       PAD_LOCK (aggpad);
       aggpad->priv->eos = FALSE;
+      gst_aggregator_pad_update_readiness_unlocked (aggpad);
       PAD_UNLOCK (aggpad);
       goto eat;
     }
@@ -1810,6 +1913,7 @@ gst_aggregator_default_sink_event (GstAggregator * self,
       PAD_LOCK (aggpad);
       if (g_queue_peek_tail (&aggpad->priv->data) == event)
         gst_event_unref (g_queue_pop_tail (&aggpad->priv->data));
+      gst_aggregator_pad_update_readiness_unlocked (aggpad);
       PAD_UNLOCK (aggpad);
 
       if (gst_aggregator_pad_chain_internal (self, aggpad, gapbuf, FALSE) !=
@@ -1867,6 +1971,7 @@ gst_aggregator_default_sink_event_pre_queue (GstAggregator * self,
 
     GST_DEBUG_OBJECT (aggpad, "Store event in queue: %" GST_PTR_FORMAT, event);
     g_queue_push_head (&aggpad->priv->data, event);
+    gst_aggregator_pad_update_readiness_unlocked (aggpad);
     SRC_BROADCAST (self);
     PAD_UNLOCK (aggpad);
     SRC_UNLOCK (self);
@@ -2040,6 +2145,25 @@ gst_aggregator_release_pad (GstElement * element, GstPad * pad)
   SRC_UNLOCK (self);
 }
 
+static void
+gst_aggregator_pad_removed (GstElement * element, GstPad * pad)
+{
+  GstAggregator *self = GST_AGGREGATOR (element);
+
+  if (GST_PAD_IS_SINK (pad) && GST_IS_AGGREGATOR_PAD (pad)) {
+    GstAggregatorPad *aggpad = GST_AGGREGATOR_PAD_CAST (pad);
+
+    GST_OBJECT_LOCK (self);
+    PAD_LOCK (aggpad);
+    gst_aggregator_pad_uncount_readiness_unlocked (self, aggpad);
+    PAD_UNLOCK (aggpad);
+    GST_OBJECT_UNLOCK (self);
+  }
+
+  if (aggregator_parent_class->pad_removed)
+    aggregator_parent_class->pad_removed (element, pad);
+}
+
 static GstAggregatorPad *
 gst_aggregator_default_create_new_pad (GstAggregator * self,
     GstPadTemplate * templ, const gchar * req_name, const GstCaps * caps)
@@ -2632,6 +2756,7 @@ gst_aggregator_default_sink_query_pre_queue (GstAggregator * self,
     }
 
     g_queue_push_head (&aggpad->priv->data, query);
+    gst_aggregator_pad_update_readiness_unlocked (aggpad);
     SRC_BROADCAST (self);
     SRC_UNLOCK (self);
 
@@ -2646,6 +2771,7 @@ gst_aggregator_default_sink_query_pre_queue (GstAggregator * self,
       gst_structure_remove_field (s, "gst-aggregator-retval");
     else
       g_queue_remove (&aggpad->priv->data, query);
+    gst_aggregator_pad_update_readiness_unlocked (aggpad);
 
     if (aggpad->priv->flow_return != GST_FLOW_OK)
       goto flushing;
@@ -2685,6 +2811,11 @@ gst_aggregator_finalize (GObject * object)
   g_mutex_clear (&self->priv->src_lock);
   g_cond_clear (&self->priv->src_cond);
 
+  if (self->priv->pad_pool) {
+    gst_task_pool_cleanup (self->priv->pad_pool);
+    gst_object_unref (self->priv->pad_pool);
+  }
+
   G_OBJECT_CLASS (aggregator_parent_class)->finalize (object);
 }
 
@@ -2787,6 +2918,11 @@ gst_aggregator_set_property (GObject * object, guint prop_id,
     case PROP_EMIT_SIGNALS:
       agg->priv->emit_signals = g_value_get_boolean (value);
       break;
+    case PROP_MAX_PAD_THREADS:
+      GST_OBJECT_LOCK (agg);
+      agg->priv->max_pad_threads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (agg);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2817,6 +2953,11 @@ gst_aggregator_get_property (GObject * object, guint prop_id,
     case PROP_EMIT_SIGNALS:
       g_value_set_boolean (value, agg->priv->emit_signals);
       break;
+    case PROP_MAX_PAD_THREADS:
+      GST_OBJECT_LOCK (agg);
+      g_value_set_uint (value, agg->priv->max_pad_threads);
+      GST_OBJECT_UNLOCK (agg);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2863,6 +3004,8 @@ gst_aggregator_class_init (GstAggregatorClass * klass)
   gstelement_class->send_event = GST_DEBUG_FUNCPTR (gst_aggregator_send_event);
   gstelement_class->release_pad =
       GST_DEBUG_FUNCPTR (gst_aggregator_release_pad);
+  gstelement_class->pad_removed =
+      GST_DEBUG_FUNCPTR (gst_aggregator_pad_removed);
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_aggregator_change_state);
 
@@ -2924,6 +3067,21 @@ gst_aggregator_class_init (GstAggregatorClass * klass)
           "Send signals", DEFAULT_EMIT_SIGNALS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAggregator:max-pad-threads:
+   *
+   * Maximum number of threads used to prepare the sink pads at the same time,
+   * 0 meaning one per CPU. This is only used by subclasses that prepare their
+   * input with gst_aggregator_foreach_sink_pad_parallel().
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_PAD_THREADS,
+      g_param_spec_uint ("max-pad-threads", "Maximum pad threads",
+          "Maximum number of threads used to prepare sink pads "
+          "(0 = one per CPU)", 0, G_MAXINT, DEFAULT_MAX_PAD_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstAggregator::samples-selected:
    * @aggregator: The #GstAggregator that emitted the signal
@@ -3007,6 +3165,7 @@ gst_aggregator_init (GstAggregator * self, GstAggregatorClass * klass)
   self->priv->start_time_selection = DEFAULT_START_TIME_SELECTION;
   self->priv->start_time = DEFAULT_START_TIME;
   self->priv->force_live = DEFAULT_FORCE_LIVE;
+  self->priv->max_pad_threads = DEFAULT_MAX_PAD_THREADS;
 
   g_mutex_init (&self->priv->src_lock);
   g_cond_init (&self->priv->src_cond);
@@ -3155,6 +3314,7 @@ gst_aggregator_pad_chain_internal (GstAggregator * self,
       }
       apply_buffer (aggpad, buffer, head);
       aggpad->priv->num_buffers++;
+      gst_aggregator_pad_update_readiness_unlocked (aggpad);
       buffer = NULL;
       SRC_BROADCAST (self);
       break;
@@ -3510,6 +3670,8 @@ gst_aggregator_pad_clip_buffer_unlocked (GstAggregatorPad * pad)
     pad->priv->clipped_buffer = buffer;
   }
 
+  gst_aggregator_pad_update_readiness_unlocked (pad);
+
   if (self)
     gst_object_unref (self);
 }
@@ -3564,6 +3726,7 @@ done:
       gst_aggregator_pad_buffer_consumed (pad, buffer, FALSE);
       pad->priv->peeked_buffer = NULL;
     }
+    gst_aggregator_pad_update_readiness_unlocked (pad);
     GST_DEBUG_OBJECT (pad, "Consumed: %" GST_PTR_FORMAT, buffer);
   }
 
@@ -4017,3 +4180,127 @@ gst_aggregator_set_force_live (GstAggregator * self, gboolean force_live)
 {
   self->priv->force_live = force_live;
 }
+
+typedef struct
+{
+  GstElement *element;
+  GstPad *pad;
+  GstElementForeachPadFunc func;
+  gpointer user_data;
+  gboolean result;
+} PadJob;
+
+static void
+gst_aggregator_pad_job_func (PadJob * job)
+{
+  job->result = job->func (job->element, job->pad, job->user_data);
+}
+
+/**
+ * gst_aggregator_foreach_sink_pad_parallel:
+ * @self: a #GstAggregator
+ * @func: (scope call): function to call for each sink pad
+ * @user_data: (closure): user data passed to @func
+ *
+ * Like gst_element_foreach_sink_pad() but calls @func for up to
+ * #GstAggregator:max-pad-threads sink pads at the same time from different
+ * threads, and returns once it was called for all of them. Subclasses can use
+ * this from their aggregate implementation for per-pad work that does not
+ * depend on the other pads, like converting the input to the output format.
+ *
+ * Unlike gst_element_foreach_sink_pad(), @func is called for all the sink
+ * pads even if one of the calls returned %FALSE.
+ *
+ * Returns: %FALSE if @self had no sink pads or if one of the calls to @func
+ *   returned %FALSE.
+ *
+ * Since: 1.24
+ */
+gboolean
+gst_aggregator_foreach_sink_pad_parallel (GstAggregator * self,
+    GstElementForeachPadFunc func, gpointer user_data)
+{
+  GstElement *element = GST_ELEMENT_CAST (self);
+  GstTaskPool *pool;
+  PadJob *jobs;
+  gpointer *handles;
+  guint n_threads, n_pads = 0, i;
+  gboolean ret = TRUE;
+  GList *l;
+
+  g_return_val_if_fail (GST_IS_AGGREGATOR (self), FALSE);
+  g_return_val_if_fail (func != NULL, FALSE);
+
+  GST_OBJECT_LOCK (self);
+  n_threads = self->priv->max_pad_threads;
+  if (n_threads == 0)
+    n_threads = g_get_num_processors ();
+  n_threads = MIN (n_threads, element->numsinkpads);
+
+  if (n_threads <= 1) {
+    GST_OBJECT_UNLOCK (self);
+    return gst_element_foreach_sink_pad (element, func, user_data);
+  }
+
+  /* the calling thread takes care of one of the pads too */
+  if (self->priv->pad_pool == NULL) {
+    GError *err = NULL;
+
+    self->priv->pad_pool = gst_shared_task_pool_new ();
+    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL
+        (self->priv->pad_pool), n_threads - 1);
+    gst_task_pool_prepare (self->priv->pad_pool, &err);
+    if (err) {
+      GST_WARNING_OBJECT (self, "failed to prepare pad pool: %s",
+          err->message);
+      g_clear_error (&err);
+    }
+  } else if (gst_shared_task_pool_get_max_threads (GST_SHARED_TASK_POOL
+          (self->priv->pad_pool)) != n_threads - 1) {
+    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL
+        (self->priv->pad_pool), n_threads - 1);
+  }
+  pool = gst_object_ref (self->priv->pad_pool);
+
+  jobs = g_new (PadJob, element->numsinkpads);
+  for (l = element->sinkpads; l; l = l->next) {
+    jobs[n_pads].element = element;
+    jobs[n_pads].pad = gst_object_ref (l->data);
+    jobs[n_pads].func = func;
+    jobs[n_pads].user_data = user_data;
+    jobs[n_pads].result = FALSE;
+    n_pads++;
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  handles = g_new0 (gpointer, n_pads);
+  for (i = 0; i < n_pads - 1; i++) {
+    GError *err = NULL;
+
+    /* on error the shared pool only returns a handle when one of its
+     * threads already took the job, otherwise it is never run there */
+    handles[i] = gst_task_pool_push (pool,
+        (GstTaskPoolFunction) gst_aggregator_pad_job_func, &jobs[i], &err);
+    if (err) {
+      GST_WARNING_OBJECT (self, "failed to push on pad pool: %s",
+          err->message);
+      g_clear_error (&err);
+    }
+    if (handles[i] == NULL)
+      gst_aggregator_pad_job_func (&jobs[i]);
+  }
+  gst_aggregator_pad_job_func (&jobs[n_pads - 1]);
+
+  for (i = 0; i < n_pads; i++) {
+    if (handles[i])
+      gst_task_pool_join (pool, handles[i]);
+    ret &= jobs[i].result;
+    gst_object_unref (jobs[i].pad);
+  }
+
+  g_free (handles);
+  g_free (jobs);
+  gst_object_unref (pool);
+
+  return ret;
+}
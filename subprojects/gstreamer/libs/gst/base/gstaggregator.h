@@ -441,6 +441,11 @@ GST_BASE_API
 void            gst_aggregator_set_force_live       (GstAggregator *self,
                                                      gboolean force_live);
 
+GST_BASE_API
+gboolean        gst_aggregator_foreach_sink_pad_parallel (GstAggregator * self,
+                                                          GstElementForeachPadFunc func,
+                                                          gpointer user_data);
+
 /**
  * GstAggregatorStartTimeSelection:
  * @GST_AGGREGATOR_START_TIME_SELECTION_ZERO: Start at running time 0.
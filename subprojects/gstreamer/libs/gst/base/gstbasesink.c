@@ -4030,7 +4030,10 @@ dropped:
     priv->dropped++;
     GST_DEBUG_OBJECT (basesink, "buffer late, dropping");
 
-    if (g_atomic_int_get (&priv->qos_enabled)) {
+    /* don't bother creating the message when it is dropped anyway */
+    if (g_atomic_int_get (&priv->qos_enabled) &&
+        gst_element_is_message_wanted (GST_ELEMENT_CAST (basesink),
+            GST_MESSAGE_QOS)) {
       GstMessage *qos_msg;
       GstClockTime timestamp, duration;
 
@@ -2109,13 +2109,16 @@ default_submit_input_buffer (GstBaseTransform * trans, gboolean is_discont,
           timestamp);
       jitter = GST_CLOCK_DIFF (running_time, earliest_time);
 
-      qos_msg =
-          gst_message_new_qos (GST_OBJECT_CAST (trans), FALSE, running_time,
-          stream_time, timestamp, duration);
-      gst_message_set_qos_values (qos_msg, jitter, proportion, 1000000);
-      gst_message_set_qos_stats (qos_msg, GST_FORMAT_BUFFERS,
-          priv->processed, priv->dropped);
-      gst_element_post_message (GST_ELEMENT_CAST (trans), qos_msg);
+      if (gst_element_is_message_wanted (GST_ELEMENT_CAST (trans),
+              GST_MESSAGE_QOS)) {
+        qos_msg =
+            gst_message_new_qos (GST_OBJECT_CAST (trans), FALSE, running_time,
+            stream_time, timestamp, duration);
+        gst_message_set_qos_values (qos_msg, jitter, proportion, 1000000);
+        gst_message_set_qos_stats (qos_msg, GST_FORMAT_BUFFERS,
+            priv->processed, priv->dropped);
+        gst_element_post_message (GST_ELEMENT_CAST (trans), qos_msg);
+      }
 
       /* mark discont for next buffer */
       priv->discont = TRUE;
@@ -0,0 +1,279 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Scanning for masked 32-bit patterns, used by GstByteReader and GstAdapter
+ * and thereby by most parsers to find start codes and sync words.
+ *
+ * The vector versions compare 16 or 32 candidate positions at once: every
+ * byte of the pattern is compared, after masking, against the data shifted
+ * by the position of that byte and the results are combined. The AVX2
+ * version is picked at runtime, SSE2 and NEON are always available on the
+ * architectures they are used on. The remaining bytes at the end are
+ * scanned with the scalar version. */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstbytescan-private.h"
+
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__)) && defined (__SSE2__)
+#define HAVE_SCAN_SSE2
+#include <emmintrin.h>
+#if defined (__clang__) || __GNUC__ >= 5
+#define HAVE_SCAN_AVX2
+#include <immintrin.h>
+#endif
+#elif defined (__GNUC__) && defined (__aarch64__) && defined (__ARM_NEON)
+#define HAVE_SCAN_NEON
+#include <arm_neon.h>
+#endif
+
+typedef enum
+{
+  SCAN_IMPL_SCALAR = 1,
+  SCAN_IMPL_SSE2,
+  SCAN_IMPL_AVX2,
+  SCAN_IMPL_NEON,
+} ScanImpl;
+
+/* byte @n of the 4 bytes, from left to right */
+#define PATTERN_BYTE(p,n) (((p) >> (24 - 8 * (n))) & 0xff)
+
+/* Special optimized scan for mask 0xffffff00 and pattern 0x00000100 */
+static gssize
+scan_for_start_code (const guint8 * data, gsize size)
+{
+  const guint8 *pdata = data;
+  const guint8 *pend = data + size - 4;
+
+  while (pdata <= pend) {
+    if (pdata[2] > 1) {
+      pdata += 3;
+    } else if (pdata[1]) {
+      pdata += 2;
+    } else if (pdata[0] || pdata[2] != 1) {
+      pdata++;
+    } else {
+      return (pdata - data);
+    }
+  }
+
+  /* nothing found */
+  return -1;
+}
+
+static gssize
+scan_masked_scalar (const guint8 * data, gsize size, guint32 mask,
+    guint32 pattern)
+{
+  guint32 state;
+  gsize i;
+
+  if (size < 4)
+    return -1;
+
+  /* Handle special case found in MPEG and H264 */
+  if (pattern == 0x00000100 && mask == 0xffffff00)
+    return scan_for_start_code (data, size);
+
+  /* set the state to something that does not match */
+  state = ~pattern;
+
+  for (i = 0; i < size; i++) {
+    /* throw away one byte and move in the next byte */
+    state = ((state << 8) | data[i]);
+    /* we need to have skipped at least 4 bytes to fill the state */
+    if (G_UNLIKELY ((state & mask) == pattern) && G_LIKELY (i >= 3))
+      return i - 3;
+  }
+
+  /* nothing found */
+  return -1;
+}
+
+#ifdef HAVE_SCAN_SSE2
+static gssize
+scan_masked_sse2 (const guint8 * data, gsize size, guint32 mask,
+    guint32 pattern)
+{
+  __m128i m[4], p[4];
+  gssize ret;
+  gsize i;
+  guint n;
+
+  for (n = 0; n < 4; n++) {
+    m[n] = _mm_set1_epi8 ((gchar) PATTERN_BYTE (mask, n));
+    p[n] = _mm_set1_epi8 ((gchar) PATTERN_BYTE (pattern, n));
+  }
+
+  /* the last of the 16 positions needs 3 more bytes */
+  for (i = 0; i + 16 + 3 <= size; i += 16) {
+    __m128i eq = _mm_set1_epi8 (-1);
+    guint bits;
+
+    for (n = 0; n < 4; n++) {
+      __m128i v;
+
+      if (PATTERN_BYTE (mask, n) == 0)
+        continue;
+      v = _mm_loadu_si128 ((const __m128i *) (data + i + n));
+      v = _mm_cmpeq_epi8 (_mm_and_si128 (v, m[n]), p[n]);
+      eq = _mm_and_si128 (eq, v);
+    }
+
+    bits = _mm_movemask_epi8 (eq);
+    if (bits)
+      return i + __builtin_ctz (bits);
+  }
+
+  ret = scan_masked_scalar (data + i, size - i, mask, pattern);
+  return ret < 0 ? -1 : (gssize) (ret + i);
+}
+#endif
+
+#ifdef HAVE_SCAN_AVX2
+__attribute__ ((target ("avx2")))
+static gssize
+scan_masked_avx2 (const guint8 * data, gsize size, guint32 mask,
+    guint32 pattern)
+{
+  __m256i m[4], p[4];
+  gssize ret;
+  gsize i;
+  guint n;
+
+  for (n = 0; n < 4; n++) {
+    m[n] = _mm256_set1_epi8 ((gchar) PATTERN_BYTE (mask, n));
+    p[n] = _mm256_set1_epi8 ((gchar) PATTERN_BYTE (pattern, n));
+  }
+
+  for (i = 0; i + 32 + 3 <= size; i += 32) {
+    __m256i eq = _mm256_set1_epi8 (-1);
+    guint bits;
+
+    for (n = 0; n < 4; n++) {
+      __m256i v;
+
+      if (PATTERN_BYTE (mask, n) == 0)
+        continue;
+      v = _mm256_loadu_si256 ((const __m256i *) (data + i + n));
+      v = _mm256_cmpeq_epi8 (_mm256_and_si256 (v, m[n]), p[n]);
+      eq = _mm256_and_si256 (eq, v);
+    }
+
+    bits = _mm256_movemask_epi8 (eq);
+    if (bits)
+      return i + __builtin_ctz (bits);
+  }
+
+  ret = scan_masked_sse2 (data + i, size - i, mask, pattern);
+  return ret < 0 ? -1 : (gssize) (ret + i);
+}
+#endif
+
+#ifdef HAVE_SCAN_NEON
+static gssize
+scan_masked_neon (const guint8 * data, gsize size, guint32 mask,
+    guint32 pattern)
+{
+  uint8x16_t m[4], p[4];
+  gssize ret;
+  gsize i;
+  guint n;
+
+  for (n = 0; n < 4; n++) {
+    m[n] = vdupq_n_u8 (PATTERN_BYTE (mask, n));
+    p[n] = vdupq_n_u8 (PATTERN_BYTE (pattern, n));
+  }
+
+  for (i = 0; i + 16 + 3 <= size; i += 16) {
+    uint8x16_t eq = vdupq_n_u8 (0xff);
+    guint64 bits;
+
+    for (n = 0; n < 4; n++) {
+      uint8x16_t v;
+
+      if (PATTERN_BYTE (mask, n) == 0)
+        continue;
+      v = vld1q_u8 (data + i + n);
+      eq = vandq_u8 (eq, vceqq_u8 (vandq_u8 (v, m[n]), p[n]));
+    }
+
+    /* 4 bits per position */
+    bits = vget_lane_u64 (vreinterpret_u64_u8 (vshrn_n_u16
+            (vreinterpretq_u16_u8 (eq), 4)), 0);
+    if (bits)
+      return i + __builtin_ctzll (bits) / 4;
+  }
+
+  ret = scan_masked_scalar (data + i, size - i, mask, pattern);
+  return ret < 0 ? -1 : (gssize) (ret + i);
+}
+#endif
+
+static ScanImpl
+scan_impl_detect (void)
+{
+#ifdef HAVE_SCAN_AVX2
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx2"))
+    return SCAN_IMPL_AVX2;
+#endif
+#ifdef HAVE_SCAN_SSE2
+  return SCAN_IMPL_SSE2;
+#elif defined (HAVE_SCAN_NEON)
+  return SCAN_IMPL_NEON;
+#else
+  return SCAN_IMPL_SCALAR;
+#endif
+}
+
+/* Returns the position of the first 4 bytes in @data that match @pattern
+ * after applying @mask, with the bytes interpreted from left to right, or -1
+ * if there is no match. */
+gssize
+_priv_gst_byte_scan_masked_uint32 (const guint8 * data, gsize size,
+    guint32 mask, guint32 pattern)
+{
+  static gsize impl = 0;
+
+  /* can never match */
+  if (G_UNLIKELY (pattern & ~mask))
+    return -1;
+
+  if (g_once_init_enter (&impl))
+    g_once_init_leave (&impl, scan_impl_detect ());
+
+  switch (impl) {
+#ifdef HAVE_SCAN_AVX2
+    case SCAN_IMPL_AVX2:
+      return scan_masked_avx2 (data, size, mask, pattern);
+#endif
+#ifdef HAVE_SCAN_SSE2
+    case SCAN_IMPL_SSE2:
+      return scan_masked_sse2 (data, size, mask, pattern);
+#endif
+#ifdef HAVE_SCAN_NEON
+    case SCAN_IMPL_NEON:
+      return scan_masked_neon (data, size, mask, pattern);
+#endif
+    default:
+      return scan_masked_scalar (data, size, mask, pattern);
+  }
+}
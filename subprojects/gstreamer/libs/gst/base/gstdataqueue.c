@@ -78,6 +78,14 @@ struct _GstDataQueuePrivate
                                  * of external flushing */
   GstDataQueueFullCallback fullcallback;
   GstDataQueueEmptyCallback emptycallback;
+
+  /* max. time to spin before waiting on the conds, in microseconds, and the
+   * current budget of the pushing and popping side */
+  guint spin_time;
+  guint push_spin_budget, pop_spin_budget;
+  /* bumped atomically whenever something changed that a waiting thread
+   * could be interested in */
+  gint changes;
 };
 
 #define GST_DATA_QUEUE_MUTEX_LOCK(q) G_STMT_START {                     \
@@ -116,6 +124,8 @@ struct _GstDataQueuePrivate
 
 static void gst_data_queue_finalize (GObject * object);
 
+static gboolean can_spin = FALSE;
+
 static void gst_data_queue_set_property (GObject * object,
     guint prop_id, const GValue * value, GParamSpec * pspec);
 static void gst_data_queue_get_property (GObject * object,
@@ -188,6 +198,8 @@ gst_data_queue_class_init (GstDataQueueClass * klass)
           G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 
   gobject_class->finalize = gst_data_queue_finalize;
+
+  can_spin = g_get_num_processors () > 1;
 }
 
 static void
@@ -283,6 +295,59 @@ gst_data_queue_finalize (GObject * object)
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
+/* must be called with the lock held whenever items were added or removed,
+ * the flushing state or the limits changed */
+static inline void
+gst_data_queue_locked_changed (GstDataQueue * queue)
+{
+  g_atomic_int_inc (&queue->priv->changes);
+}
+
+/* Called with the lock held. Drops the lock and busy-waits for another thread
+ * to change the queue, for as long as the current @budget allows, and takes
+ * the lock again. The budget is doubled, up to the spin time, each time
+ * spinning succeeds and halved each time it doesn't, so that spinning
+ * quickly stops costing CPU when the other thread is slow.
+ *
+ * Returns: %TRUE if the queue changed meanwhile, also when it changed after
+ * we stopped spinning but before we got the lock again. Nobody was waiting
+ * on the conds then, so the caller must not wait for a signal. */
+static gboolean
+gst_data_queue_locked_spin (GstDataQueue * queue, guint * budget)
+{
+  GstDataQueuePrivate *priv = queue->priv;
+  gint changes;
+  gint64 end_time;
+  gboolean res = FALSE;
+
+  if (priv->spin_time == 0 || !can_spin)
+    return FALSE;
+
+  if (*budget == 0 || *budget > priv->spin_time)
+    *budget = priv->spin_time;
+
+  changes = g_atomic_int_get (&priv->changes);
+  end_time = g_get_monotonic_time () + *budget;
+
+  GST_DATA_QUEUE_MUTEX_UNLOCK (queue);
+  for (;;) {
+    guint i;
+
+    for (i = 0; i < 64 && !res; i++)
+      res = g_atomic_int_get (&priv->changes) != changes;
+    if (res || g_get_monotonic_time () >= end_time)
+      break;
+  }
+  GST_DATA_QUEUE_MUTEX_LOCK (queue);
+
+  if (res)
+    *budget = MIN (*budget * 2, priv->spin_time);
+  else
+    *budget = MAX (*budget / 2, 1);
+
+  return res || g_atomic_int_get (&priv->changes) != changes;
+}
+
 static inline void
 gst_data_queue_locked_flush (GstDataQueue * queue)
 {
@@ -291,6 +356,7 @@ gst_data_queue_locked_flush (GstDataQueue * queue)
   STATUS (queue, "before flushing");
   gst_data_queue_cleanup (queue);
   STATUS (queue, "after flushing");
+  gst_data_queue_locked_changed (queue);
   /* we deleted something... */
   if (priv->waiting_del)
     g_cond_signal (&priv->item_del);
@@ -403,6 +469,7 @@ gst_data_queue_set_flushing (GstDataQueue * queue, gboolean flushing)
 
   GST_DATA_QUEUE_MUTEX_LOCK (queue);
   priv->flushing = flushing;
+  gst_data_queue_locked_changed (queue);
   if (flushing) {
     /* release push/pop functions */
     if (priv->waiting_add)
@@ -425,6 +492,8 @@ gst_data_queue_push_force_unlocked (GstDataQueue * queue,
     priv->cur_level.visible++;
   priv->cur_level.bytes += item->size;
   priv->cur_level.time += item->duration;
+
+  gst_data_queue_locked_changed (queue);
 }
 
 /**
@@ -517,9 +586,11 @@ gst_data_queue_push (GstDataQueue * queue, GstDataQueueItem * item)
 
     /* signal might have removed some items */
     while (gst_data_queue_locked_is_full (queue)) {
-      priv->waiting_del = TRUE;
-      g_cond_wait (&priv->item_del, &priv->qlock);
-      priv->waiting_del = FALSE;
+      if (!gst_data_queue_locked_spin (queue, &priv->push_spin_budget)) {
+        priv->waiting_del = TRUE;
+        g_cond_wait (&priv->item_del, &priv->qlock);
+        priv->waiting_del = FALSE;
+      }
       if (priv->flushing)
         goto flushing;
     }
@@ -550,9 +621,11 @@ _gst_data_queue_wait_non_empty (GstDataQueue * queue)
   GstDataQueuePrivate *priv = queue->priv;
 
   while (gst_data_queue_locked_is_empty (queue)) {
-    priv->waiting_add = TRUE;
-    g_cond_wait (&priv->item_add, &priv->qlock);
-    priv->waiting_add = FALSE;
+    if (!gst_data_queue_locked_spin (queue, &priv->pop_spin_budget)) {
+      priv->waiting_add = TRUE;
+      g_cond_wait (&priv->item_add, &priv->qlock);
+      priv->waiting_add = FALSE;
+    }
     if (priv->flushing)
       return FALSE;
   }
@@ -605,6 +678,7 @@ gst_data_queue_pop (GstDataQueue * queue, GstDataQueueItem ** item)
     priv->cur_level.visible--;
   priv->cur_level.bytes -= (*item)->size;
   priv->cur_level.time -= (*item)->duration;
+  gst_data_queue_locked_changed (queue);
 
   STATUS (queue, "after popping");
   if (priv->waiting_del)
@@ -719,6 +793,7 @@ gst_data_queue_drop_head (GstDataQueue * queue, GType type)
     priv->cur_level.visible--;
   priv->cur_level.bytes -= leak->size;
   priv->cur_level.time -= leak->duration;
+  gst_data_queue_locked_changed (queue);
 
   leak->destroy (leak);
 
@@ -749,6 +824,7 @@ gst_data_queue_limits_changed (GstDataQueue * queue)
   g_return_if_fail (GST_IS_DATA_QUEUE (queue));
 
   GST_DATA_QUEUE_MUTEX_LOCK (queue);
+  gst_data_queue_locked_changed (queue);
   if (priv->waiting_del) {
     GST_DEBUG ("signal del");
     g_cond_signal (&priv->item_del);
@@ -773,6 +849,56 @@ gst_data_queue_get_level (GstDataQueue * queue, GstDataQueueSize * level)
   memcpy (level, (&priv->cur_level), sizeof (GstDataQueueSize));
 }
 
+/**
+ * gst_data_queue_set_spin_time: (skip)
+ * @queue: The #GstDataQueue
+ * @spin_time: max. time to spin in microseconds, or 0 to disable spinning
+ *
+ * Lets gst_data_queue_push() and gst_data_queue_pop() busy-wait for up to
+ * @spin_time microseconds for another thread to pop or push an item before
+ * blocking. When one thread is pushing and another one popping items at a
+ * high rate, this avoids most of the cost and latency of putting threads to
+ * sleep and waking them up, at the expense of some CPU time. The time spent
+ * spinning is reduced automatically while the other thread is too slow for
+ * spinning to pay off.
+ *
+ * Spinning is disabled by default, and never done on systems with only one
+ * processor.
+ *
+ * Since: 1.24
+ */
+void
+gst_data_queue_set_spin_time (GstDataQueue * queue, guint spin_time)
+{
+  g_return_if_fail (GST_IS_DATA_QUEUE (queue));
+
+  GST_DATA_QUEUE_MUTEX_LOCK (queue);
+  queue->priv->spin_time = spin_time;
+  GST_DATA_QUEUE_MUTEX_UNLOCK (queue);
+}
+
+/**
+ * gst_data_queue_get_spin_time: (skip)
+ * @queue: The #GstDataQueue
+ *
+ * Returns: the max. time in microseconds that @queue spins before blocking.
+ *
+ * Since: 1.24
+ */
+guint
+gst_data_queue_get_spin_time (GstDataQueue * queue)
+{
+  guint spin_time;
+
+  g_return_val_if_fail (GST_IS_DATA_QUEUE (queue), 0);
+
+  GST_DATA_QUEUE_MUTEX_LOCK (queue);
+  spin_time = queue->priv->spin_time;
+  GST_DATA_QUEUE_MUTEX_UNLOCK (queue);
+
+  return spin_time;
+}
+
 static void
 gst_data_queue_set_property (GObject * object,
     guint prop_id, const GValue * value, GParamSpec * pspec)
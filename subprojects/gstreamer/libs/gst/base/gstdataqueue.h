@@ -177,6 +177,12 @@ void           gst_data_queue_get_level      (GstDataQueue * queue, GstDataQueue
 GST_BASE_API
 void           gst_data_queue_limits_changed (GstDataQueue * queue);
 
+GST_BASE_API
+void           gst_data_queue_set_spin_time  (GstDataQueue * queue, guint spin_time);
+
+GST_BASE_API
+guint          gst_data_queue_get_spin_time  (GstDataQueue * queue);
+
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstDataQueue, gst_object_unref)
 
 G_END_DECLS
@@ -32,6 +32,12 @@
  * gst-launch-1.0 v4l2src num-buffers=1 ! jpegenc ! filesink location=capture1.jpeg
  * ]| Capture one frame from a v4l2 camera and save as jpeg image.
  *
+ * With #GstFileSink:async, the data is written by a separate thread so that
+ * the streaming thread only blocks when more than
+ * #GstFileSink:max-pending-bytes are waiting to be written, for example
+ * while the disk is busy. The #GstFileSink:stats property reports how much
+ * data is pending and how long the writes take.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -102,6 +108,28 @@ gst_file_sink_buffer_mode_get_type (void)
   return buffer_mode_type;
 }
 
+#define GST_TYPE_FILE_SINK_FSYNC_POLICY (gst_file_sink_fsync_policy_get_type ())
+static GType
+gst_file_sink_fsync_policy_get_type (void)
+{
+  static GType fsync_policy_type = 0;
+  static const GEnumValue fsync_policy[] = {
+    {GST_FILE_SINK_FSYNC_POLICY_DEFAULT,
+        "Only after buffers flagged with SYNC_AFTER", "default"},
+    {GST_FILE_SINK_FSYNC_POLICY_EOS, "Also on EOS", "eos"},
+    {GST_FILE_SINK_FSYNC_POLICY_INTERVAL, "Also every fsync-interval",
+        "interval"},
+    {GST_FILE_SINK_FSYNC_POLICY_ALWAYS, "After every write", "always"},
+    {0, NULL, NULL},
+  };
+
+  if (!fsync_policy_type) {
+    fsync_policy_type =
+        g_enum_register_static ("GstFileSinkFsyncPolicy", fsync_policy);
+  }
+  return fsync_policy_type;
+}
+
 GST_DEBUG_CATEGORY_STATIC (gst_file_sink_debug);
 #define GST_CAT_DEFAULT gst_file_sink_debug
 
@@ -111,6 +139,10 @@ GST_DEBUG_CATEGORY_STATIC (gst_file_sink_debug);
 #define DEFAULT_APPEND		FALSE
 #define DEFAULT_O_SYNC		FALSE
 #define DEFAULT_MAX_TRANSIENT_ERROR_TIMEOUT	0
+#define DEFAULT_FSYNC_POLICY	GST_FILE_SINK_FSYNC_POLICY_DEFAULT
+#define DEFAULT_FSYNC_INTERVAL	1000
+#define DEFAULT_ASYNC		FALSE
+#define DEFAULT_MAX_PENDING_BYTES	(16 * 1024 * 1024)
 
 enum
 {
@@ -121,6 +153,11 @@ enum
   PROP_APPEND,
   PROP_O_SYNC,
   PROP_MAX_TRANSIENT_ERROR_TIMEOUT,
+  PROP_FSYNC_POLICY,
+  PROP_FSYNC_INTERVAL,
+  PROP_ASYNC,
+  PROP_MAX_PENDING_BYTES,
+  PROP_STATS,
   PROP_LAST
 };
 
@@ -162,6 +199,7 @@ gst_fopen (const gchar * filename, const gchar * mode, gboolean o_sync)
 }
 
 static void gst_file_sink_dispose (GObject * object);
+static void gst_file_sink_finalize (GObject * object);
 
 static void gst_file_sink_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
@@ -192,6 +230,9 @@ static void gst_file_sink_uri_handler_init (gpointer g_iface,
     gpointer iface_data);
 
 static GstFlowReturn gst_file_sink_flush_buffer (GstFileSink * filesink);
+static GstFlowReturn gst_file_sink_async_drain (GstFileSink * filesink);
+static void gst_file_sink_async_stop (GstFileSink * filesink);
+static GstFlowReturn gst_file_sink_fsync (GstFileSink * filesink);
 
 #define _do_init \
   G_IMPLEMENT_INTERFACE (GST_TYPE_URI_HANDLER, gst_file_sink_uri_handler_init); \
@@ -210,6 +251,7 @@ gst_file_sink_class_init (GstFileSinkClass * klass)
   GstBaseSinkClass *gstbasesink_class = GST_BASE_SINK_CLASS (klass);
 
   gobject_class->dispose = gst_file_sink_dispose;
+  gobject_class->finalize = gst_file_sink_finalize;
 
   gobject_class->set_property = gst_file_sink_set_property;
   gobject_class->get_property = gst_file_sink_get_property;
@@ -253,6 +295,88 @@ gst_file_sink_class_init (GstFileSinkClass * klass)
           G_MAXINT, DEFAULT_MAX_TRANSIENT_ERROR_TIMEOUT,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstFileSink:fsync-policy:
+   *
+   * When to flush the written data to the storage device with fsync(), in
+   * addition to after buffers flagged with %GST_BUFFER_FLAG_SYNC_AFTER.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_FSYNC_POLICY,
+      g_param_spec_enum ("fsync-policy", "Fsync policy",
+          "When to flush the data to the storage device",
+          GST_TYPE_FILE_SINK_FSYNC_POLICY, DEFAULT_FSYNC_POLICY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstFileSink:fsync-interval:
+   *
+   * Minimum time in milliseconds between two flushes to the storage device
+   * with the interval fsync-policy.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_FSYNC_INTERVAL,
+      g_param_spec_uint ("fsync-interval", "Fsync interval",
+          "Time between flushes to the storage device with the interval "
+          "fsync-policy (in ms)", 0, G_MAXUINT, DEFAULT_FSYNC_INTERVAL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstFileSink:async:
+   *
+   * Write the data from a separate thread. The streaming thread only waits
+   * when more than #GstFileSink:max-pending-bytes are not written yet, or
+   * when it needs everything to be written, for example on EOS or before
+   * seeking.
+   *
+   * Buffers flagged with %GST_BUFFER_FLAG_SYNC_AFTER still only return once
+   * they and everything before them are written and flushed to the storage
+   * device. The flushes of #GstFileSink:fsync-policy happen from the writer
+   * thread without waiting for them.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_ASYNC,
+      g_param_spec_boolean ("async", "Async",
+          "Write the data from a separate thread", DEFAULT_ASYNC,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstFileSink:max-pending-bytes:
+   *
+   * Maximum amount of data waiting to be written in async mode.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_PENDING_BYTES,
+      g_param_spec_uint64 ("max-pending-bytes", "Max pending bytes",
+          "Max. amount of data waiting to be written in async mode", 1,
+          G_MAXUINT64, DEFAULT_MAX_PENDING_BYTES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstFileSink:stats:
+   *
+   * Statistics of the async mode, with the following fields:
+   *
+   * * "pending-bytes" G_TYPE_UINT64: data currently waiting to be written
+   * * "peak-pending-bytes" G_TYPE_UINT64: max. data waiting to be written
+   * * "writes" G_TYPE_UINT64: number of buffers and buffer lists written
+   * * "write-latency-avg" G_TYPE_UINT64: average time to write one buffer or
+   *   buffer list, in ns
+   * * "write-latency-max" G_TYPE_UINT64: longest time to write one buffer or
+   *   buffer list, in ns
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_STATS,
+      g_param_spec_boxed ("stats", "Statistics",
+          "Statistics of the async mode", GST_TYPE_STRUCTURE,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (gstelement_class,
       "File Sink",
       "Sink/File", "Write stream to a file",
@@ -276,6 +400,7 @@ gst_file_sink_class_init (GstFileSinkClass * klass)
   }
 
   gst_type_mark_as_plugin_api (GST_TYPE_FILE_SINK_BUFFER_MODE, 0);
+  gst_type_mark_as_plugin_api (GST_TYPE_FILE_SINK_FSYNC_POLICY, 0);
 }
 
 static void
@@ -287,6 +412,13 @@ gst_file_sink_init (GstFileSink * filesink)
   filesink->buffer_mode = DEFAULT_BUFFER_MODE;
   filesink->buffer_size = DEFAULT_BUFFER_SIZE;
   filesink->append = FALSE;
+  filesink->fsync_policy = DEFAULT_FSYNC_POLICY;
+  filesink->fsync_interval = DEFAULT_FSYNC_INTERVAL;
+  filesink->async = DEFAULT_ASYNC;
+  filesink->max_pending_bytes = DEFAULT_MAX_PENDING_BYTES;
+
+  g_mutex_init (&filesink->async_lock);
+  g_cond_init (&filesink->async_cond);
 
   gst_base_sink_set_sync (GST_BASE_SINK (filesink), FALSE);
 }
@@ -304,6 +436,17 @@ gst_file_sink_dispose (GObject * object)
   sink->filename = NULL;
 }
 
+static void
+gst_file_sink_finalize (GObject * object)
+{
+  GstFileSink *sink = GST_FILE_SINK (object);
+
+  g_mutex_clear (&sink->async_lock);
+  g_cond_clear (&sink->async_cond);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
 static gboolean
 gst_file_sink_set_location (GstFileSink * sink, const gchar * location,
     GError ** error)
@@ -364,6 +507,21 @@ gst_file_sink_set_property (GObject * object, guint prop_id,
     case PROP_MAX_TRANSIENT_ERROR_TIMEOUT:
       sink->max_transient_error_timeout = g_value_get_int (value);
       break;
+    case PROP_FSYNC_POLICY:
+      sink->fsync_policy = g_value_get_enum (value);
+      break;
+    case PROP_FSYNC_INTERVAL:
+      sink->fsync_interval = g_value_get_uint (value);
+      break;
+    case PROP_ASYNC:
+      sink->async = g_value_get_boolean (value);
+      break;
+    case PROP_MAX_PENDING_BYTES:
+      g_mutex_lock (&sink->async_lock);
+      sink->max_pending_bytes = g_value_get_uint64 (value);
+      g_cond_broadcast (&sink->async_cond);
+      g_mutex_unlock (&sink->async_lock);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -395,6 +553,34 @@ gst_file_sink_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_MAX_TRANSIENT_ERROR_TIMEOUT:
       g_value_set_int (value, sink->max_transient_error_timeout);
       break;
+    case PROP_FSYNC_POLICY:
+      g_value_set_enum (value, sink->fsync_policy);
+      break;
+    case PROP_FSYNC_INTERVAL:
+      g_value_set_uint (value, sink->fsync_interval);
+      break;
+    case PROP_ASYNC:
+      g_value_set_boolean (value, sink->async);
+      break;
+    case PROP_MAX_PENDING_BYTES:
+      g_mutex_lock (&sink->async_lock);
+      g_value_set_uint64 (value, sink->max_pending_bytes);
+      g_mutex_unlock (&sink->async_lock);
+      break;
+    case PROP_STATS:
+      g_mutex_lock (&sink->async_lock);
+      g_value_take_boxed (value,
+          gst_structure_new ("application/x-filesink-stats",
+              "pending-bytes", G_TYPE_UINT64, sink->async_pending_bytes,
+              "peak-pending-bytes", G_TYPE_UINT64,
+              sink->stats_peak_pending_bytes,
+              "writes", G_TYPE_UINT64, sink->stats_writes,
+              "write-latency-avg", G_TYPE_UINT64, sink->stats_writes ?
+              sink->stats_latency_total / sink->stats_writes : 0,
+              "write-latency-max", G_TYPE_UINT64, sink->stats_latency_max,
+              NULL));
+      g_mutex_unlock (&sink->async_lock);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -416,6 +602,7 @@ gst_file_sink_open_file (GstFileSink * sink)
     goto open_failed;
 
   sink->current_pos = 0;
+  sink->last_fsync = g_get_monotonic_time ();
   /* try to seek in the file to figure out if it is seekable */
   sink->seekable = gst_file_sink_do_seek (sink, 0);
 
@@ -465,10 +652,15 @@ open_failed:
 static void
 gst_file_sink_close_file (GstFileSink * sink)
 {
+  /* let the writer thread write what is pending */
+  gst_file_sink_async_stop (sink);
+
   if (sink->file) {
     if (gst_file_sink_flush_buffer (sink) != GST_FLOW_OK)
       GST_ELEMENT_ERROR (sink, RESOURCE, CLOSE,
           (_("Error closing file \"%s\"."), sink->filename), NULL);
+    else if (sink->fsync_policy != GST_FILE_SINK_FSYNC_POLICY_DEFAULT)
+      gst_file_sink_fsync (sink);
 
     if (fclose (sink->file) != 0)
       GST_ELEMENT_ERROR (sink, RESOURCE, CLOSE,
@@ -507,10 +699,23 @@ gst_file_sink_query (GstBaseSink * bsink, GstQuery * query)
       switch (format) {
         case GST_FORMAT_DEFAULT:
         case GST_FORMAT_BYTES:
-          gst_query_set_position (query, GST_FORMAT_BYTES,
-              self->current_pos + self->current_buffer_size);
+        {
+          guint64 pos;
+
+          /* the position changes while the writer thread is writing, but the
+           * data it writes is still pending until it's done */
+          g_mutex_lock (&self->async_lock);
+          if (self->async_writing)
+            pos = self->async_write_pos;
+          else
+            pos = self->current_pos + self->current_buffer_size;
+          pos += self->async_pending_bytes;
+          g_mutex_unlock (&self->async_lock);
+
+          gst_query_set_position (query, GST_FORMAT_BYTES, pos);
           res = TRUE;
           break;
+        }
         default:
           res = FALSE;
           break;
@@ -603,6 +808,14 @@ gst_file_sink_event (GstBaseSink * sink, GstEvent * event)
 
   type = GST_EVENT_TYPE (event);
 
+  /* these need everything that is pending to be written */
+  if (type == GST_EVENT_SEGMENT || type == GST_EVENT_FLUSH_STOP
+      || type == GST_EVENT_EOS) {
+    if (gst_file_sink_async_drain (filesink) != GST_FLOW_OK
+        && type != GST_EVENT_FLUSH_STOP)
+      goto write_failed;
+  }
+
   switch (type) {
     case GST_EVENT_SEGMENT:
     {
@@ -646,6 +859,9 @@ gst_file_sink_event (GstBaseSink * sink, GstEvent * event)
     case GST_EVENT_EOS:
       if (gst_file_sink_flush_buffer (filesink) != GST_FLOW_OK)
         goto flush_buffer_failed;
+      if (filesink->fsync_policy != GST_FILE_SINK_FSYNC_POLICY_DEFAULT
+          && gst_file_sink_fsync (filesink) != GST_FLOW_OK)
+        goto write_failed;
       break;
     default:
       break;
@@ -677,6 +893,13 @@ truncate_failed:
     gst_event_unref (event);
     return FALSE;
   }
+write_failed:
+  {
+    /* the error was already posted */
+    GST_DEBUG_OBJECT (filesink, "writing failed");
+    gst_event_unref (event);
+    return FALSE;
+  }
 }
 
 static gboolean
@@ -703,6 +926,18 @@ gst_file_sink_get_current_offset (GstFileSink * filesink, guint64 * p_pos)
   return (ret != (off_t) - 1);
 }
 
+/* Called when a write was interrupted because the sink is flushing. The
+ * streaming thread waits until it can continue, the writer thread of the
+ * async mode can't wait for preroll and gives up on the data. */
+static GstFlowReturn
+gst_file_sink_wait_flushing (GstFileSink * sink)
+{
+  if (g_thread_self () == sink->async_thread)
+    return GST_FLOW_FLUSHING;
+
+  return gst_base_sink_wait_preroll (GST_BASE_SINK (sink));
+}
+
 static GstFlowReturn
 gst_file_sink_render_list_internal (GstFileSink * sink,
     GstBufferList * buffer_list)
@@ -733,7 +968,7 @@ gst_file_sink_render_list_internal (GstFileSink * sink,
     if (flow != GST_FLOW_FLUSHING)
       break;
 
-    flow = gst_base_sink_wait_preroll (GST_BASE_SINK (sink));
+    flow = gst_file_sink_wait_flushing (sink);
 
     if (flow != GST_FLOW_OK)
       return flow;
@@ -774,7 +1009,7 @@ gst_file_sink_flush_buffer (GstFileSink * filesink)
       if (flow_ret != GST_FLOW_FLUSHING)
         break;
 
-      flow_ret = gst_base_sink_wait_preroll (GST_BASE_SINK (filesink));
+      flow_ret = gst_file_sink_wait_flushing (filesink);
       if (flow_ret != GST_FLOW_OK)
         break;
     }
@@ -797,6 +1032,59 @@ gst_file_sink_flush_buffer (GstFileSink * filesink)
   return flow_ret;
 }
 
+static GstFlowReturn
+gst_file_sink_fsync (GstFileSink * filesink)
+{
+  gint fsync_ret;
+
+  GST_DEBUG_OBJECT (filesink, "flushing to the storage device");
+
+  do {
+    fsync_ret = fsync (fileno (filesink->file));
+  } while (fsync_ret < 0 && errno == EINTR);
+  if (fsync_ret) {
+    GST_ELEMENT_ERROR (filesink, RESOURCE, WRITE,
+        (_("Error while writing to file \"%s\"."), filesink->filename),
+        ("%s", g_strerror (errno)));
+    return GST_FLOW_ERROR;
+  }
+
+  filesink->last_fsync = g_get_monotonic_time ();
+
+  return GST_FLOW_OK;
+}
+
+/* fsyncs after a write if the buffer asked for it or the fsync-policy
+ * says so */
+static GstFlowReturn
+gst_file_sink_sync_after_write (GstFileSink * filesink, gboolean sync_after)
+{
+  GstFlowReturn flow;
+
+  switch (filesink->fsync_policy) {
+    case GST_FILE_SINK_FSYNC_POLICY_ALWAYS:
+      break;
+    case GST_FILE_SINK_FSYNC_POLICY_INTERVAL:
+      if (sync_after || g_get_monotonic_time () - filesink->last_fsync >=
+          (gint64) filesink->fsync_interval * 1000)
+        break;
+      return GST_FLOW_OK;
+    default:
+      if (sync_after)
+        break;
+      return GST_FLOW_OK;
+  }
+
+  /* buffers with SYNC_AFTER are never kept in the internal buffer */
+  if (!sync_after) {
+    flow = gst_file_sink_flush_buffer (filesink);
+    if (flow != GST_FLOW_OK)
+      return flow;
+  }
+
+  return gst_file_sink_fsync (filesink);
+}
+
 static gboolean
 has_sync_after_buffer (GstBuffer ** buffer, guint idx, gpointer user_data)
 {
@@ -840,7 +1128,7 @@ render_buffer (GstFileSink * filesink, GstBuffer * buffer)
     if (flow != GST_FLOW_FLUSHING)
       break;
 
-    flow = gst_base_sink_wait_preroll (GST_BASE_SINK (filesink));
+    flow = gst_file_sink_wait_flushing (filesink);
 
     if (flow != GST_FLOW_OK)
       break;
@@ -850,15 +1138,11 @@ render_buffer (GstFileSink * filesink, GstBuffer * buffer)
 }
 
 static GstFlowReturn
-gst_file_sink_render_list (GstBaseSink * bsink, GstBufferList * buffer_list)
+gst_file_sink_write_list (GstFileSink * sink, GstBufferList * buffer_list)
 {
   GstFlowReturn flow;
-  GstFileSink *sink;
   guint i, num_buffers;
   gboolean sync_after = FALSE;
-  gint fsync_ret;
-
-  sink = GST_FILE_SINK_CAST (bsink);
 
   num_buffers = gst_buffer_list_length (buffer_list);
   if (num_buffers == 0)
@@ -919,17 +1203,8 @@ gst_file_sink_render_list (GstBaseSink * bsink, GstBufferList * buffer_list)
     }
   }
 
-  if (flow == GST_FLOW_OK && sync_after) {
-    do {
-      fsync_ret = fsync (fileno (sink->file));
-    } while (fsync_ret < 0 && errno == EINTR);
-    if (fsync_ret) {
-      GST_ELEMENT_ERROR (sink, RESOURCE, WRITE,
-          (_("Error while writing to file \"%s\"."), sink->filename),
-          ("%s", g_strerror (errno)));
-      flow = GST_FLOW_ERROR;
-    }
-  }
+  if (flow == GST_FLOW_OK)
+    flow = gst_file_sink_sync_after_write (sink, sync_after);
 
   return flow;
 
@@ -941,15 +1216,11 @@ no_data:
 }
 
 static GstFlowReturn
-gst_file_sink_render (GstBaseSink * sink, GstBuffer * buffer)
+gst_file_sink_write_buffer (GstFileSink * filesink, GstBuffer * buffer)
 {
-  GstFileSink *filesink;
   GstFlowReturn flow;
   guint8 n_mem;
   gboolean sync_after;
-  gint fsync_ret;
-
-  filesink = GST_FILE_SINK_CAST (sink);
 
   sync_after = GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_SYNC_AFTER);
 
@@ -978,7 +1249,7 @@ gst_file_sink_render (GstBaseSink * sink, GstBuffer * buffer)
       }
 
       if (size > filesink->allocated_buffer_size) {
-        GST_DEBUG_OBJECT (sink,
+        GST_DEBUG_OBJECT (filesink,
             "writing buffer ( %" G_GSIZE_FORMAT
             " bytes) at position %" G_GUINT64_FORMAT,
             size, filesink->current_pos);
@@ -1003,21 +1274,236 @@ gst_file_sink_render (GstBaseSink * sink, GstBuffer * buffer)
     flow = GST_FLOW_OK;
   }
 
-  if (flow == GST_FLOW_OK && sync_after) {
-    do {
-      fsync_ret = fsync (fileno (filesink->file));
-    } while (fsync_ret < 0 && errno == EINTR);
-    if (fsync_ret) {
-      GST_ELEMENT_ERROR (filesink, RESOURCE, WRITE,
-          (_("Error while writing to file \"%s\"."), filesink->filename),
-          ("%s", g_strerror (errno)));
-      flow = GST_FLOW_ERROR;
+  if (flow == GST_FLOW_OK && (n_mem > 0 || sync_after))
+    flow = gst_file_sink_sync_after_write (filesink, sync_after);
+
+  return flow;
+}
+
+static gsize
+get_object_size (GstMiniObject * obj)
+{
+  guint size = 0;
+
+  if (GST_IS_BUFFER (obj))
+    return gst_buffer_get_size (GST_BUFFER_CAST (obj));
+
+  gst_buffer_list_foreach (GST_BUFFER_LIST_CAST (obj), accumulate_size, &size);
+  return size;
+}
+
+/* the writer thread of the async mode, writes the buffers and buffer lists
+ * queued by the streaming thread */
+static gpointer
+gst_file_sink_async_writer (gpointer data)
+{
+  GstFileSink *filesink = data;
+  GstMiniObject *obj;
+  GstFlowReturn flow;
+  GstClockTime start, latency;
+  gsize size;
+
+  g_mutex_lock (&filesink->async_lock);
+  for (;;) {
+    while (gst_queue_array_is_empty (filesink->async_queue)
+        && !filesink->async_quit)
+      g_cond_wait (&filesink->async_cond, &filesink->async_lock);
+
+    obj = gst_queue_array_pop_head (filesink->async_queue);
+    if (obj == NULL)
+      break;
+
+    size = get_object_size (obj);
+
+    /* nothing is written after an error */
+    if (filesink->async_flow != GST_FLOW_OK) {
+      filesink->async_pending_bytes -= size;
+      g_cond_broadcast (&filesink->async_cond);
+      gst_mini_object_unref (obj);
+      continue;
+    }
+
+    filesink->async_writing = TRUE;
+    filesink->async_write_pos =
+        filesink->current_pos + filesink->current_buffer_size;
+    g_mutex_unlock (&filesink->async_lock);
+
+    start = gst_util_get_timestamp ();
+    if (GST_IS_BUFFER (obj))
+      flow = gst_file_sink_write_buffer (filesink, GST_BUFFER_CAST (obj));
+    else
+      flow = gst_file_sink_write_list (filesink, GST_BUFFER_LIST_CAST (obj));
+    latency = gst_util_get_timestamp () - start;
+    gst_mini_object_unref (obj);
+
+    g_mutex_lock (&filesink->async_lock);
+    filesink->async_writing = FALSE;
+    filesink->async_pending_bytes -= size;
+    filesink->stats_writes++;
+    filesink->stats_latency_total += latency;
+    filesink->stats_latency_max = MAX (filesink->stats_latency_max, latency);
+    if (flow != GST_FLOW_OK && flow != GST_FLOW_FLUSHING) {
+      GST_DEBUG_OBJECT (filesink, "write failed: %s", gst_flow_get_name (flow));
+      filesink->async_flow = flow;
+    }
+    g_cond_broadcast (&filesink->async_cond);
+  }
+  g_mutex_unlock (&filesink->async_lock);
+
+  return NULL;
+}
+
+static void
+gst_file_sink_async_start (GstFileSink * filesink)
+{
+  filesink->async_queue = gst_queue_array_new (16);
+  filesink->async_pending_bytes = 0;
+  filesink->async_writing = FALSE;
+  filesink->async_flushing = FALSE;
+  filesink->async_quit = FALSE;
+  filesink->async_flow = GST_FLOW_OK;
+  filesink->stats_writes = 0;
+  filesink->stats_peak_pending_bytes = 0;
+  filesink->stats_latency_total = 0;
+  filesink->stats_latency_max = 0;
+
+  filesink->async_thread =
+      g_thread_new ("filesink-writer", gst_file_sink_async_writer, filesink);
+}
+
+/* writes everything that is pending and stops the writer thread */
+static void
+gst_file_sink_async_stop (GstFileSink * filesink)
+{
+  if (filesink->async_thread == NULL)
+    return;
+
+  g_mutex_lock (&filesink->async_lock);
+  filesink->async_quit = TRUE;
+  g_cond_broadcast (&filesink->async_cond);
+  g_mutex_unlock (&filesink->async_lock);
+
+  g_thread_join (filesink->async_thread);
+  filesink->async_thread = NULL;
+
+  gst_queue_array_free (filesink->async_queue);
+  filesink->async_queue = NULL;
+}
+
+/* waits until everything that is pending is written, returns the result of
+ * the writes */
+static GstFlowReturn
+gst_file_sink_async_drain (GstFileSink * filesink)
+{
+  GstFlowReturn flow;
+
+  if (filesink->async_thread == NULL)
+    return GST_FLOW_OK;
+
+  g_mutex_lock (&filesink->async_lock);
+  while (!gst_queue_array_is_empty (filesink->async_queue)
+      || filesink->async_writing)
+    g_cond_wait (&filesink->async_cond, &filesink->async_lock);
+  flow = filesink->async_flow;
+  g_mutex_unlock (&filesink->async_lock);
+
+  return flow;
+}
+
+static gboolean
+is_sync_after_object (GstMiniObject * obj)
+{
+  gboolean sync_after = FALSE;
+
+  if (GST_IS_BUFFER (obj))
+    return GST_BUFFER_FLAG_IS_SET (GST_BUFFER_CAST (obj),
+        GST_BUFFER_FLAG_SYNC_AFTER);
+
+  gst_buffer_list_foreach (GST_BUFFER_LIST_CAST (obj), has_sync_after_buffer,
+      &sync_after);
+  return sync_after;
+}
+
+/* hands @obj over to the writer thread, waiting for it to catch up when too
+ * much data is pending, or until @obj is written and flushed to the storage
+ * device when it asks for that */
+static GstFlowReturn
+gst_file_sink_async_queue (GstFileSink * filesink, GstMiniObject * obj)
+{
+  GstFlowReturn flow = GST_FLOW_OK;
+  gsize size = get_object_size (obj);
+  gboolean sync_after = is_sync_after_object (obj);
+
+  g_mutex_lock (&filesink->async_lock);
+  for (;;) {
+    if (filesink->async_flow != GST_FLOW_OK) {
+      flow = filesink->async_flow;
+      goto done;
+    }
+
+    if (filesink->async_flushing) {
+      g_mutex_unlock (&filesink->async_lock);
+      flow = gst_base_sink_wait_preroll (GST_BASE_SINK (filesink));
+      if (flow != GST_FLOW_OK)
+        return flow;
+      g_mutex_lock (&filesink->async_lock);
+      continue;
     }
+
+    /* always accept something when nothing is pending so that data larger
+     * than the limit can pass */
+    if (filesink->async_pending_bytes == 0 ||
+        filesink->async_pending_bytes + size <= filesink->max_pending_bytes)
+      break;
+
+    GST_LOG_OBJECT (filesink, "%" G_GUINT64_FORMAT " bytes pending, waiting",
+        filesink->async_pending_bytes);
+    g_cond_wait (&filesink->async_cond, &filesink->async_lock);
+  }
+
+  gst_queue_array_push_tail (filesink->async_queue,
+      gst_mini_object_ref (obj));
+  filesink->async_pending_bytes += size;
+  filesink->stats_peak_pending_bytes =
+      MAX (filesink->stats_peak_pending_bytes, filesink->async_pending_bytes);
+  g_cond_broadcast (&filesink->async_cond);
+
+  if (sync_after) {
+    while (!gst_queue_array_is_empty (filesink->async_queue)
+        || filesink->async_writing)
+      g_cond_wait (&filesink->async_cond, &filesink->async_lock);
+    flow = filesink->async_flow;
   }
 
+done:
+  g_mutex_unlock (&filesink->async_lock);
+
   return flow;
 }
 
+static GstFlowReturn
+gst_file_sink_render_list (GstBaseSink * bsink, GstBufferList * buffer_list)
+{
+  GstFileSink *sink = GST_FILE_SINK_CAST (bsink);
+
+  if (sink->async_thread)
+    return gst_file_sink_async_queue (sink,
+        GST_MINI_OBJECT_CAST (buffer_list));
+
+  return gst_file_sink_write_list (sink, buffer_list);
+}
+
+static GstFlowReturn
+gst_file_sink_render (GstBaseSink * sink, GstBuffer * buffer)
+{
+  GstFileSink *filesink = GST_FILE_SINK_CAST (sink);
+
+  if (filesink->async_thread)
+    return gst_file_sink_async_queue (filesink, GST_MINI_OBJECT_CAST (buffer));
+
+  return gst_file_sink_write_buffer (filesink, buffer);
+}
+
 static gboolean
 gst_file_sink_start (GstBaseSink * basesink)
 {
@@ -1026,7 +1512,13 @@ gst_file_sink_start (GstBaseSink * basesink)
   filesink = GST_FILE_SINK_CAST (basesink);
 
   g_atomic_int_set (&filesink->flushing, FALSE);
-  return gst_file_sink_open_file (filesink);
+  if (!gst_file_sink_open_file (filesink))
+    return FALSE;
+
+  if (filesink->async)
+    gst_file_sink_async_start (filesink);
+
+  return TRUE;
 }
 
 static gboolean
@@ -1048,6 +1540,11 @@ gst_file_sink_unlock (GstBaseSink * basesink)
   filesink = GST_FILE_SINK_CAST (basesink);
   g_atomic_int_set (&filesink->flushing, TRUE);
 
+  g_mutex_lock (&filesink->async_lock);
+  filesink->async_flushing = TRUE;
+  g_cond_broadcast (&filesink->async_cond);
+  g_mutex_unlock (&filesink->async_lock);
+
   return TRUE;
 }
 
@@ -1059,6 +1556,10 @@ gst_file_sink_unlock_stop (GstBaseSink * basesink)
   filesink = GST_FILE_SINK_CAST (basesink);
   g_atomic_int_set (&filesink->flushing, FALSE);
 
+  g_mutex_lock (&filesink->async_lock);
+  filesink->async_flushing = FALSE;
+  g_mutex_unlock (&filesink->async_lock);
+
   return TRUE;
 }
 
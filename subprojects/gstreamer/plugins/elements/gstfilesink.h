@@ -28,6 +28,7 @@
 
 #include <gst/gst.h>
 #include <gst/base/gstbasesink.h>
+#include <gst/base/gstqueuearray.h>
 
 G_BEGIN_DECLS
 
@@ -62,6 +63,25 @@ typedef enum {
   GST_FILE_SINK_BUFFER_MODE_UNBUFFERED = _IONBF
 } GstFileSinkBufferMode;
 
+/**
+ * GstFileSinkFsyncPolicy:
+ * @GST_FILE_SINK_FSYNC_POLICY_DEFAULT: Only after buffers flagged with
+ *   %GST_BUFFER_FLAG_SYNC_AFTER
+ * @GST_FILE_SINK_FSYNC_POLICY_EOS: Also on EOS
+ * @GST_FILE_SINK_FSYNC_POLICY_INTERVAL: Also every fsync-interval
+ * @GST_FILE_SINK_FSYNC_POLICY_ALWAYS: After every write
+ *
+ * When to flush the written data to the storage device.
+ *
+ * Since: 1.24
+ */
+typedef enum {
+  GST_FILE_SINK_FSYNC_POLICY_DEFAULT,
+  GST_FILE_SINK_FSYNC_POLICY_EOS,
+  GST_FILE_SINK_FSYNC_POLICY_INTERVAL,
+  GST_FILE_SINK_FSYNC_POLICY_ALWAYS
+} GstFileSinkFsyncPolicy;
+
 /**
  * GstFileSink:
  *
@@ -96,6 +116,32 @@ struct _GstFileSink {
   gint max_transient_error_timeout;
 
   gboolean flushing;
+
+  gint fsync_policy;
+  guint fsync_interval;         /* in ms */
+  gint64 last_fsync;            /* monotonic time of the last fsync */
+
+  /* write-behind. async only changes in the NULL and READY states and
+   * async_thread and async_queue are only set when starting and stopping,
+   * the rest and the contents of async_queue are protected by async_lock */
+  gboolean async;
+  guint64 max_pending_bytes;
+  GThread *async_thread;
+  GMutex async_lock;
+  GCond async_cond;
+  GstQueueArray *async_queue;   /* buffers and buffer lists to write */
+  guint64 async_pending_bytes;
+  gboolean async_writing;       /* the writer thread is writing */
+  guint64 async_write_pos;      /* position when the write started */
+  gboolean async_flushing;
+  gboolean async_quit;
+  GstFlowReturn async_flow;     /* result of the last write */
+
+  /* write-behind statistics, protected by async_lock */
+  guint64 stats_writes;
+  guint64 stats_peak_pending_bytes;
+  GstClockTime stats_latency_total;
+  GstClockTime stats_latency_max;
 };
 
 struct _GstFileSinkClass {
@@ -31,6 +31,11 @@
  * gst-launch-1.0 filesrc location=song.ogg ! decodebin ! audioconvert ! audioresample ! autoaudiosink
  * ]| Play song.ogg audio file which must be in the current working directory.
  *
+ * With #GstFileSrc:use-mmap, regular files are mapped into memory and the
+ * buffers point directly to the mapped pages instead of containing a copy of
+ * the data. This saves copying every byte of large files that are read
+ * sequentially.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -65,6 +70,11 @@
 #  include <unistd.h>
 #endif
 
+#if defined (HAVE_MMAP) && defined (HAVE_SYS_MMAN_H)
+#  include <sys/mman.h>
+#  define USE_MMAP 1
+#endif
+
 #define struct_stat struct stat
 
 #ifdef __BIONIC__               /* Android */
@@ -110,11 +120,25 @@ enum
 };
 
 #define DEFAULT_BLOCKSIZE       4*1024
+#define DEFAULT_USE_MMAP        FALSE
+
+/* blocksize used instead of the default one when use-mmap is set but the file
+ * can't be mapped */
+#define LARGE_BLOCKSIZE         256*1024
 
 enum
 {
   PROP_0,
-  PROP_LOCATION
+  PROP_LOCATION,
+  PROP_USE_MMAP
+};
+
+/* a mapping of the whole file, shared by all buffers created from it */
+struct _GstFileSrcMapping
+{
+  gint refcount;
+  gpointer data;
+  gsize size;
 };
 
 static void gst_file_src_finalize (GObject * object);
@@ -131,6 +155,8 @@ static gboolean gst_file_src_is_seekable (GstBaseSrc * src);
 static gboolean gst_file_src_get_size (GstBaseSrc * src, guint64 * size);
 static GstFlowReturn gst_file_src_fill (GstBaseSrc * src, guint64 offset,
     guint length, GstBuffer * buf);
+static GstFlowReturn gst_file_src_create (GstBaseSrc * src, guint64 offset,
+    guint length, GstBuffer ** buf);
 
 static void gst_file_src_uri_handler_init (gpointer g_iface,
     gpointer iface_data);
@@ -163,6 +189,26 @@ gst_file_src_class_init (GstFileSrcClass * klass)
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
           GST_PARAM_MUTABLE_READY));
 
+  /**
+   * GstFileSrc:use-mmap:
+   *
+   * Map regular files into memory and output buffers that point to the
+   * mapped file pages instead of reading a copy of the data. The buffers
+   * are read-only, elements that want to modify the data in place get a
+   * copy. Files that can't be mapped, like pipes, are read in larger blocks
+   * instead.
+   *
+   * The file must not be truncated while it is mapped, accessing the
+   * missing data would crash the application.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_USE_MMAP,
+      g_param_spec_boolean ("use-mmap", "Use mmap",
+          "Map the file into memory instead of reading it", DEFAULT_USE_MMAP,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   gobject_class->finalize = gst_file_src_finalize;
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -177,6 +223,7 @@ gst_file_src_class_init (GstFileSrcClass * klass)
   gstbasesrc_class->is_seekable = GST_DEBUG_FUNCPTR (gst_file_src_is_seekable);
   gstbasesrc_class->get_size = GST_DEBUG_FUNCPTR (gst_file_src_get_size);
   gstbasesrc_class->fill = GST_DEBUG_FUNCPTR (gst_file_src_fill);
+  gstbasesrc_class->create = GST_DEBUG_FUNCPTR (gst_file_src_create);
 
   if (sizeof (off_t) < 8) {
     GST_LOG ("No large file support, sizeof (off_t) = %" G_GSIZE_FORMAT "!",
@@ -192,6 +239,7 @@ gst_file_src_init (GstFileSrc * src)
   src->uri = NULL;
 
   src->is_regular = FALSE;
+  src->use_mmap = DEFAULT_USE_MMAP;
 
   gst_base_src_set_blocksize (GST_BASE_SRC (src), DEFAULT_BLOCKSIZE);
 }
@@ -270,6 +318,9 @@ gst_file_src_set_property (GObject * object, guint prop_id,
     case PROP_LOCATION:
       gst_file_src_set_location (src, g_value_get_string (value), NULL);
       break;
+    case PROP_USE_MMAP:
+      src->use_mmap = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -290,6 +341,9 @@ gst_file_src_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_LOCATION:
       g_value_set_string (value, src->filename);
       break;
+    case PROP_USE_MMAP:
+      g_value_set_boolean (value, src->use_mmap);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -318,7 +372,10 @@ gst_file_src_fill (GstBaseSrc * basesrc, guint64 offset, guint length,
 
   src = GST_FILE_SRC_CAST (basesrc);
 
-  if (G_UNLIKELY (offset != -1 && src->read_position != offset)) {
+  /* reads from the mapping don't move the fd, so it is only known to be at
+   * the read position when the file is not mapped */
+  if (G_UNLIKELY (offset != -1 && (src->read_position != offset
+              || src->mapping != NULL))) {
     off_t res;
 
     res = lseek (src->fd, offset, SEEK_SET);
@@ -395,6 +452,99 @@ buffer_write_fail:
   }
 }
 
+static GstFileSrcMapping *
+gst_file_src_mapping_ref (GstFileSrcMapping * mapping)
+{
+  g_atomic_int_inc (&mapping->refcount);
+  return mapping;
+}
+
+static void
+gst_file_src_mapping_unref (GstFileSrcMapping * mapping)
+{
+  if (g_atomic_int_dec_and_test (&mapping->refcount)) {
+#ifdef USE_MMAP
+    munmap (mapping->data, mapping->size);
+#endif
+    g_free (mapping);
+  }
+}
+
+/* maps the whole file, returns NULL if it can't be mapped */
+static GstFileSrcMapping *
+gst_file_src_map_file (GstFileSrc * src, guint64 size)
+{
+#ifdef USE_MMAP
+  GstFileSrcMapping *mapping;
+  gpointer data;
+
+  if (size == 0 || size > G_MAXSIZE)
+    return NULL;
+
+  data = mmap (NULL, size, PROT_READ, MAP_SHARED, src->fd, 0);
+  if (data == MAP_FAILED) {
+    GST_WARNING_OBJECT (src, "could not map file: %s", g_strerror (errno));
+    return NULL;
+  }
+#ifdef HAVE_MADVISE
+  madvise (data, size, MADV_SEQUENTIAL);
+#endif
+
+  mapping = g_new (GstFileSrcMapping, 1);
+  mapping->refcount = 1;
+  mapping->data = data;
+  mapping->size = size;
+
+  GST_DEBUG_OBJECT (src, "mapped %" G_GUINT64_FORMAT " bytes", size);
+
+  return mapping;
+#else
+  return NULL;
+#endif
+}
+
+static GstFlowReturn
+gst_file_src_create (GstBaseSrc * basesrc, guint64 offset, guint length,
+    GstBuffer ** buffer)
+{
+  GstFileSrc *src = GST_FILE_SRC_CAST (basesrc);
+  GstFileSrcMapping *mapping = src->mapping;
+  GstMemory *mem;
+  GstBuffer *buf;
+  gsize size;
+
+  if (offset == -1)
+    offset = src->read_position;
+
+  /* read into the buffer when downstream provides one, and when reading
+   * past the mapping, the file might have grown since it was mapped */
+  if (mapping == NULL || *buffer != NULL || length == 0
+      || offset >= mapping->size)
+    return GST_BASE_SRC_CLASS (parent_class)->create (basesrc, offset, length,
+        buffer);
+
+  size = MIN (length, mapping->size - offset);
+
+  GST_LOG_OBJECT (src, "Wrapping %" G_GSIZE_FORMAT " bytes at offset 0x%"
+      G_GINT64_MODIFIER "x", size, offset);
+
+  mem = gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY, mapping->data,
+      mapping->size, offset, size, gst_file_src_mapping_ref (mapping),
+      (GDestroyNotify) gst_file_src_mapping_unref);
+
+  buf = gst_buffer_new ();
+  gst_buffer_append_memory (buf, mem);
+
+  GST_BUFFER_OFFSET (buf) = offset;
+  GST_BUFFER_OFFSET_END (buf) = offset + size;
+
+  src->read_position = offset + size;
+
+  *buffer = buf;
+
+  return GST_FLOW_OK;
+}
+
 static gboolean
 gst_file_src_is_seekable (GstBaseSrc * basesrc)
 {
@@ -537,6 +687,27 @@ gst_file_src_start (GstBaseSrc * basesrc)
 
   gst_base_src_set_dynamic_size (basesrc, src->seekable);
 
+#ifdef HAVE_POSIX_FADVISE
+  /* use-mmap is meant for large files read sequentially, let the kernel
+   * read ahead more aggressively for the reads that don't use the mapping */
+  if (src->use_mmap && src->is_regular)
+    posix_fadvise (src->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+  if (src->use_mmap) {
+    guint64 size;
+
+    if (src->is_regular && gst_file_src_get_size (basesrc, &size))
+      src->mapping = gst_file_src_map_file (src, size);
+
+    if (src->mapping == NULL
+        && gst_base_src_get_blocksize (basesrc) == DEFAULT_BLOCKSIZE) {
+      GST_DEBUG_OBJECT (src, "can't map file, reading larger blocks");
+      gst_base_src_set_blocksize (basesrc, LARGE_BLOCKSIZE);
+      src->raised_blocksize = TRUE;
+    }
+  }
+
   return TRUE;
 
   /* ERROR */
@@ -600,6 +771,18 @@ gst_file_src_stop (GstBaseSrc * basesrc)
 {
   GstFileSrc *src = GST_FILE_SRC (basesrc);
 
+  /* buffers that are still around keep the mapping alive */
+  if (src->mapping) {
+    gst_file_src_mapping_unref (src->mapping);
+    src->mapping = NULL;
+  }
+
+  if (src->raised_blocksize) {
+    if (gst_base_src_get_blocksize (basesrc) == LARGE_BLOCKSIZE)
+      gst_base_src_set_blocksize (basesrc, DEFAULT_BLOCKSIZE);
+    src->raised_blocksize = FALSE;
+  }
+
   /* close the file */
   g_close (src->fd, NULL);
 
@@ -45,6 +45,7 @@ G_BEGIN_DECLS
 
 typedef struct _GstFileSrc GstFileSrc;
 typedef struct _GstFileSrcClass GstFileSrcClass;
+typedef struct _GstFileSrcMapping GstFileSrcMapping;
 
 /**
  * GstFileSrc:
@@ -58,11 +59,18 @@ struct _GstFileSrc {
   gchar *filename;			/* filename */
   gchar *uri;				/* caching the URI */
   gint fd;				/* open file descriptor */
-  guint64 read_position;		/* position of fd */
+  guint64 read_position;		/* position of the next read, also
+					   the position of fd unless the
+					   file is mapped */
 
   gboolean seekable;                    /* whether the file is seekable */
   gboolean is_regular;                  /* whether it's a (symlink to a)
                                            regular file */
+
+  gboolean use_mmap;                    /* whether to map the file */
+  GstFileSrcMapping *mapping;           /* the whole file, if mapped */
+  gboolean raised_blocksize;            /* if we raised the blocksize because
+                                           the file could not be mapped */
 };
 
 struct _GstFileSrcClass {
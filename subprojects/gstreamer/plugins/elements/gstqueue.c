@@ -122,13 +122,16 @@ enum
   PROP_MIN_THRESHOLD_TIME,
   PROP_LEAKY,
   PROP_SILENT,
-  PROP_FLUSH_ON_EOS
+  PROP_FLUSH_ON_EOS,
+  PROP_SPIN_TIME
 };
 
 /* default property values */
 #define DEFAULT_MAX_SIZE_BUFFERS  200   /* 200 buffers */
 #define DEFAULT_MAX_SIZE_BYTES    (10 * 1024 * 1024)    /* 10 MB       */
 #define DEFAULT_MAX_SIZE_TIME     GST_SECOND    /* 1 second    */
+#define DEFAULT_SPIN_TIME         0
+#define MAX_SPIN_TIME             1000  /* 1 ms */
 
 #define GST_QUEUE_MUTEX_LOCK(q) G_STMT_START {                          \
   g_mutex_lock (&q->qlock);                                              \
@@ -144,11 +147,61 @@ enum
   g_mutex_unlock (&q->qlock);                                            \
 } G_STMT_END
 
+/* spinning only makes sense when the other thread can run meanwhile */
+static gboolean can_spin = FALSE;
+
+/* Called with the queue lock held. Releases the lock and busy-waits until
+ * the other thread bumps @seq, for at most @budget microseconds, so that a
+ * thread that has to wait for only a short while does not go to sleep and
+ * need to be woken up again. The budget is doubled, up to the spin-time,
+ * when spinning worked and halved when it did not.
+ *
+ * Returns TRUE if @seq changed, also when it changed after we stopped
+ * spinning but before we got the lock again. The other thread did not
+ * signal in that case as nobody was waiting yet, so the caller must not wait
+ * on the cond then. The lock is held again on return. */
+static gboolean
+gst_queue_spin_wait (GstQueue * queue, gint * seq, guint * budget)
+{
+  gint64 deadline;
+  gint start_seq;
+  gboolean changed = FALSE;
+  guint i = 0;
+
+  if (queue->spin_time == 0 || !can_spin)
+    return FALSE;
+
+  if (*budget == 0 || *budget > queue->spin_time)
+    *budget = queue->spin_time;
+
+  start_seq = g_atomic_int_get (seq);
+  deadline = g_get_monotonic_time () + *budget;
+  GST_QUEUE_MUTEX_UNLOCK (queue);
+  do {
+    if (g_atomic_int_get (seq) != start_seq) {
+      changed = TRUE;
+      break;
+    }
+    /* don't read the clock on every iteration */
+  } while ((++i & 0x3f) != 0 || g_get_monotonic_time () < deadline);
+  GST_QUEUE_MUTEX_LOCK (queue);
+
+  if (changed)
+    *budget = MIN (*budget * 2, queue->spin_time);
+  else
+    *budget = MAX (*budget / 2, 1);
+
+  return changed || g_atomic_int_get (seq) != start_seq;
+}
+
 #define GST_QUEUE_WAIT_DEL_CHECK(q, label) G_STMT_START {               \
   STATUS (q, q->sinkpad, "wait for DEL");                               \
-  q->waiting_del = TRUE;                                                \
-  g_cond_wait (&q->item_del, &q->qlock);                                  \
-  q->waiting_del = FALSE;                                               \
+  if (!gst_queue_spin_wait (q, &q->del_seq, &q->del_spin_budget) &&     \
+      q->srcresult == GST_FLOW_OK) {                                    \
+    q->waiting_del = TRUE;                                              \
+    g_cond_wait (&q->item_del, &q->qlock);                              \
+    q->waiting_del = FALSE;                                             \
+  }                                                                     \
   if (q->srcresult != GST_FLOW_OK) {                                    \
     STATUS (q, q->srcpad, "received DEL wakeup");                       \
     goto label;                                                         \
@@ -158,9 +211,12 @@ enum
 
 #define GST_QUEUE_WAIT_ADD_CHECK(q, label) G_STMT_START {               \
   STATUS (q, q->srcpad, "wait for ADD");                                \
-  q->waiting_add = TRUE;                                                \
-  g_cond_wait (&q->item_add, &q->qlock);                                  \
-  q->waiting_add = FALSE;                                               \
+  if (!gst_queue_spin_wait (q, &q->add_seq, &q->add_spin_budget) &&     \
+      q->srcresult == GST_FLOW_OK) {                                    \
+    q->waiting_add = TRUE;                                              \
+    g_cond_wait (&q->item_add, &q->qlock);                              \
+    q->waiting_add = FALSE;                                             \
+  }                                                                     \
   if (q->srcresult != GST_FLOW_OK) {                                    \
     STATUS (q, q->srcpad, "received ADD wakeup");                       \
     goto label;                                                         \
@@ -169,6 +225,7 @@ enum
 } G_STMT_END
 
 #define GST_QUEUE_SIGNAL_DEL(q) G_STMT_START {                          \
+  g_atomic_int_inc (&q->del_seq);                                       \
   if (q->waiting_del) {                                                 \
     STATUS (q, q->srcpad, "signal DEL");                                \
     g_cond_signal (&q->item_del);                                        \
@@ -176,6 +233,7 @@ enum
 } G_STMT_END
 
 #define GST_QUEUE_SIGNAL_ADD(q) G_STMT_START {                          \
+  g_atomic_int_inc (&q->add_seq);                                       \
   if (q->waiting_add) {                                                 \
     STATUS (q, q->sinkpad, "signal ADD");                               \
     g_cond_signal (&q->item_add);                                        \
@@ -405,6 +463,29 @@ gst_queue_class_init (GstQueueClass * klass)
           G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
           G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstQueue:spin-time:
+   *
+   * Maximum time in microseconds that the upstream and downstream threads
+   * busy-wait for each other before going to sleep when the queue is full or
+   * empty. With one thread producing and another consuming buffers at a high
+   * rate, this avoids most of the cost and latency of waking up the other
+   * thread, at the expense of some CPU time. The actual spinning time is
+   * adapted to how often the wait is short enough. 0 disables spinning.
+   *
+   * Spinning is never done on systems with a single processor.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_SPIN_TIME,
+      g_param_spec_uint ("spin-time", "Spin time (us)",
+          "Max. time to busy-wait for data or space before sleeping "
+          "(in us, 0=disable)", 0, MAX_SPIN_TIME, DEFAULT_SPIN_TIME,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
+  can_spin = g_get_num_processors () > 1;
+
   gobject_class->finalize = gst_queue_finalize;
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -459,6 +540,7 @@ gst_queue_init (GstQueue * queue)
   queue->head_needs_discont = queue->tail_needs_discont = FALSE;
 
   queue->leaky = GST_QUEUE_NO_LEAK;
+  queue->spin_time = DEFAULT_SPIN_TIME;
   queue->srcresult = GST_FLOW_FLUSHING;
 
   g_mutex_init (&queue->qlock);
@@ -1844,6 +1926,9 @@ gst_queue_set_property (GObject * object,
     case PROP_FLUSH_ON_EOS:
       queue->flush_on_eos = g_value_get_boolean (value);
       break;
+    case PROP_SPIN_TIME:
+      queue->spin_time = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1897,6 +1982,9 @@ gst_queue_get_property (GObject * object,
     case PROP_FLUSH_ON_EOS:
       g_value_set_boolean (value, queue->flush_on_eos);
       break;
+    case PROP_SPIN_TIME:
+      g_value_set_uint (value, queue->spin_time);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -138,6 +138,13 @@ struct _GstQueue {
   GstQuery *last_handled_query;
 
   gboolean flush_on_eos; /* flush on EOS */
+
+  /* max. time in microseconds to spin before waiting on the conds, and the
+   * current budget of each side, adapted to how often spinning pays off */
+  guint spin_time;
+  guint add_spin_budget, del_spin_budget;
+  /* incremented (atomically) for every add and delete */
+  gint add_seq, del_seq;
 };
 
 struct _GstQueueClass {
@@ -50,6 +50,11 @@
  * The temp-location property will be used to notify the application of the
  * allocated filename.
  *
+ * When a temp file is combined with #GstQueue2:ring-buffer-max-size and
+ * #GstQueue2:use-mmap is set, the file is mapped into memory and buffers
+ * handed downstream point directly into the mapped ring instead of being
+ * read back into a copy.
+ *
  * If the #GstQueue2:use-buffering property is set to TRUE, and any writable
  * property is modified, #GstQueue2 will attempt to post a buffering message
  * if the changes to the properties also cause the buffering percentage to be
@@ -85,6 +90,12 @@
 #include <fcntl.h>
 #endif
 
+#if defined (HAVE_MMAP) && defined (HAVE_SYS_MMAN_H)
+#include <sys/mman.h>
+#include <fcntl.h>              /* posix_fallocate */
+#define USE_MMAP 1
+#endif
+
 static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -109,6 +120,8 @@ enum
 #define QUEUE_IS_USING_TEMP_FILE(queue) ((queue)->temp_template != NULL)
 #define QUEUE_IS_USING_RING_BUFFER(queue) ((queue)->ring_buffer_max_size != 0)  /* for consistency with the above macro */
 #define QUEUE_IS_USING_QUEUE(queue) (!QUEUE_IS_USING_TEMP_FILE(queue) && !QUEUE_IS_USING_RING_BUFFER (queue))
+/* a mapped temp file is accessed like the memory ring buffer */
+#define QUEUE_IS_USING_FILE_IO(queue) (QUEUE_IS_USING_TEMP_FILE(queue) && (queue)->mapping == NULL)
 
 #define QUEUE_MAX_BYTES(queue) MIN((queue)->max_level.bytes, (queue)->ring_buffer_max_size)
 
@@ -126,6 +139,7 @@ enum
 #define DEFAULT_TEMP_REMOVE        TRUE
 #define DEFAULT_RING_BUFFER_MAX_SIZE 0
 #define DEFAULT_USE_BITRATE_QUERY  TRUE
+#define DEFAULT_USE_MMAP           FALSE
 
 enum
 {
@@ -150,6 +164,7 @@ enum
   PROP_AVG_IN_RATE,
   PROP_USE_BITRATE_QUERY,
   PROP_BITRATE,
+  PROP_USE_MMAP,
   PROP_LAST
 };
 static GParamSpec *obj_props[PROP_LAST] = { NULL, };
@@ -473,6 +488,31 @@ gst_queue2_class_init (GstQueue2Class * klass)
       "Conversion value between data size and time",
       0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * GstQueue2:use-mmap:
+   *
+   * When both #GstQueue2:temp-template and #GstQueue2:ring-buffer-max-size
+   * are set, map the temp file into memory. Data is then written to and read
+   * from the mapping instead of going through file I/O, and reads that don't
+   * wrap around the end of the ring are handed downstream as read-only
+   * buffers that point into the mapping.
+   *
+   * The space for the whole ring is allocated in the temp file up front.
+   * When that fails, or on platforms without posix_fallocate(), file I/O is
+   * used as without this property.
+   *
+   * At most half of the ring is handed out like this at any time, reads are
+   * copied once downstream holds on to that much. The ring data referenced
+   * by such buffers is not overwritten until they are released, the upstream
+   * side continues writing as soon as they are.
+   *
+   * Since: 1.24
+   */
+  obj_props[PROP_USE_MMAP] = g_param_spec_boolean ("use-mmap", "Use mmap",
+      "Map the temp file ring into memory and output buffers pointing into it",
+      DEFAULT_USE_MMAP, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+      GST_PARAM_MUTABLE_READY);
+
   g_object_class_install_properties (gobject_class, PROP_LAST, obj_props);
 
   /* set several parent class virtual functions */
@@ -552,6 +592,8 @@ gst_queue2_init (GstQueue2 * queue)
   g_cond_init (&queue->item_add);
   queue->waiting_del = FALSE;
   g_cond_init (&queue->item_del);
+  g_mutex_init (&queue->view_lock);
+  g_cond_init (&queue->view_del);
   queue->queue = gst_queue_array_new_for_struct (sizeof (GstQueue2Item), 32);
 
   g_cond_init (&queue->query_handled);
@@ -568,6 +610,7 @@ gst_queue2_init (GstQueue2 * queue)
 
   queue->ring_buffer = NULL;
   queue->ring_buffer_max_size = DEFAULT_RING_BUFFER_MAX_SIZE;
+  queue->use_mmap = DEFAULT_USE_MMAP;
 
   queue->use_bitrate_query = DEFAULT_USE_BITRATE_QUERY;
 
@@ -595,6 +638,8 @@ gst_queue2_finalize (GObject * object)
   g_mutex_clear (&queue->buffering_post_lock);
   g_cond_clear (&queue->item_add);
   g_cond_clear (&queue->item_del);
+  g_mutex_clear (&queue->view_lock);
+  g_cond_clear (&queue->view_del);
   g_cond_clear (&queue->query_handled);
   g_timer_destroy (queue->in_timer);
   g_timer_destroy (queue->out_timer);
@@ -603,6 +648,10 @@ gst_queue2_finalize (GObject * object)
   g_free (queue->temp_template);
   g_free (queue->temp_location);
 
+  /* views only stay in the list after they were released, the others keep
+   * a reference to the queue */
+  g_list_free_full (queue->ring_views, g_free);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -1480,6 +1529,205 @@ gst_queue2_have_data (GstQueue2 * queue, guint64 offset, guint length)
 #define FSEEK_FILE(file,offset)  (fseek (file, offset, SEEK_SET) != 0)
 #endif
 
+struct _GstQueue2Mapping
+{
+  gint refcount;
+  guint8 *data;
+  gsize size;
+};
+
+/* a part of the mapped ring that is referenced by a buffer downstream */
+typedef struct
+{
+  GstQueue2 *queue;
+  GstQueue2Mapping *mapping;
+  guint64 rb_offset;
+  guint size;
+  gint released;
+} GstQueue2RingView;
+
+static GstQueue2Mapping *
+gst_queue2_mapping_ref (GstQueue2Mapping * mapping)
+{
+  g_atomic_int_inc (&mapping->refcount);
+  return mapping;
+}
+
+static void
+gst_queue2_mapping_unref (GstQueue2Mapping * mapping)
+{
+  if (g_atomic_int_dec_and_test (&mapping->refcount)) {
+#ifdef USE_MMAP
+    munmap (mapping->data, mapping->size);
+#endif
+    g_free (mapping);
+  }
+}
+
+/* must be called with MUTEX_LOCK, maps the temp file and uses it as ring
+ * buffer. File I/O is used when it can't be mapped. */
+static void
+gst_queue2_map_temp_file (GstQueue2 * queue)
+{
+#if defined (USE_MMAP) && defined (HAVE_POSIX_FALLOCATE)
+  GstQueue2Mapping *mapping;
+  gpointer data;
+  gint fd, res;
+
+  if (queue->ring_buffer_max_size > G_MAXSIZE)
+    return;
+
+  fd = fileno (queue->temp_file);
+
+  /* the whole ring must be backed by allocated blocks of the file. Writing
+   * to holes of a sparse file through the mapping raises SIGBUS when the
+   * disk is full instead of returning an error, so keep using file I/O if
+   * the space can't be reserved */
+  res = posix_fallocate (fd, 0, (off_t) queue->ring_buffer_max_size);
+  if (res != 0) {
+    GST_WARNING_OBJECT (queue, "could not allocate temp file space, not "
+        "mapping it: %s", g_strerror (res));
+    return;
+  }
+
+  data = mmap (NULL, queue->ring_buffer_max_size, PROT_READ | PROT_WRITE,
+      MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED) {
+    GST_WARNING_OBJECT (queue, "could not map temp file: %s",
+        g_strerror (errno));
+    return;
+  }
+
+  mapping = g_new (GstQueue2Mapping, 1);
+  mapping->refcount = 1;
+  mapping->data = data;
+  mapping->size = queue->ring_buffer_max_size;
+
+  queue->mapping = mapping;
+  queue->ring_buffer = data;
+
+  GST_DEBUG_OBJECT (queue, "mapped %" G_GSIZE_FORMAT " bytes of temp file",
+      mapping->size);
+#else
+  GST_WARNING_OBJECT (queue, "can't map the temp file on this platform");
+#endif
+}
+
+/* called from any thread when the buffer holding the view is freed. The
+ * queue lock might be held by the caller so only the view lock is taken, the
+ * writer keeps it while checking the views so the wakeup can't get lost. */
+static void
+gst_queue2_ring_view_release (GstQueue2RingView * view)
+{
+  GstQueue2 *queue = view->queue;
+
+  gst_queue2_mapping_unref (view->mapping);
+
+  g_mutex_lock (&queue->view_lock);
+  view->released = 1;
+  queue->view_bytes -= view->size;
+  g_cond_signal (&queue->view_del);
+  g_mutex_unlock (&queue->view_lock);
+
+  gst_object_unref (queue);
+}
+
+/* must be called with MUTEX_LOCK, wakes up the writer when it waits for ring
+ * views to be released so it notices the new sinkresult */
+static void
+gst_queue2_unblock_ring_writer (GstQueue2 * queue)
+{
+  g_mutex_lock (&queue->view_lock);
+  g_cond_signal (&queue->view_del);
+  g_mutex_unlock (&queue->view_lock);
+}
+
+/* must be called with MUTEX_LOCK and the view lock */
+static void
+gst_queue2_prune_ring_views (GstQueue2 * queue)
+{
+  GList *walk, *next;
+
+  for (walk = queue->ring_views; walk; walk = next) {
+    GstQueue2RingView *view = walk->data;
+
+    next = walk->next;
+    if (view->released) {
+      queue->ring_views = g_list_delete_link (queue->ring_views, walk);
+      g_free (view);
+    }
+  }
+}
+
+/* must be called with MUTEX_LOCK and the view lock, returns how many of the
+ * @length bytes at ring position @rb_pos can be written without overwriting
+ * data that is still referenced downstream */
+static guint
+gst_queue2_ring_writable (GstQueue2 * queue, guint64 rb_pos, guint length)
+{
+  guint64 rb_size = queue->ring_buffer_max_size;
+  GList *walk;
+
+  gst_queue2_prune_ring_views (queue);
+
+  for (walk = queue->ring_views; walk && length > 0; walk = walk->next) {
+    GstQueue2RingView *view = walk->data;
+
+    /* views of an earlier mapping don't share the ring */
+    if (view->mapping != queue->mapping)
+      continue;
+
+    if ((rb_pos + rb_size - view->rb_offset) % rb_size < view->size)
+      length = 0;
+    else
+      length = MIN (length, (view->rb_offset + rb_size - rb_pos) % rb_size);
+  }
+
+  return length;
+}
+
+/* must be called with MUTEX_LOCK, wraps @length bytes at position
+ * @rb_offset of the mapped ring in a read-only buffer. Returns %NULL when
+ * half of the ring is already referenced downstream, the data has to be
+ * copied then. */
+static GstBuffer *
+gst_queue2_new_ring_view (GstQueue2 * queue, guint64 rb_offset, guint length)
+{
+  GstQueue2RingView *view;
+  GstBuffer *buf;
+
+  g_mutex_lock (&queue->view_lock);
+  gst_queue2_prune_ring_views (queue);
+
+  if (queue->view_bytes + length > queue->ring_buffer_max_size / 2) {
+    GST_LOG_OBJECT (queue, "%" G_GUINT64_FORMAT " bytes referenced "
+        "downstream, copying", queue->view_bytes);
+    g_mutex_unlock (&queue->view_lock);
+    return NULL;
+  }
+  queue->view_bytes += length;
+
+  GST_LOG_OBJECT (queue, "Wrapping %u bytes at ring offset %" G_GUINT64_FORMAT,
+      length, rb_offset);
+
+  view = g_new (GstQueue2RingView, 1);
+  view->queue = gst_object_ref (queue);
+  view->mapping = gst_queue2_mapping_ref (queue->mapping);
+  view->rb_offset = rb_offset;
+  view->size = length;
+  view->released = 0;
+  queue->ring_views = g_list_prepend (queue->ring_views, view);
+  g_mutex_unlock (&queue->view_lock);
+
+  buf = gst_buffer_new ();
+  gst_buffer_append_memory (buf,
+      gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY, view->mapping->data,
+          view->mapping->size, rb_offset, length, view,
+          (GDestroyNotify) gst_queue2_ring_view_release));
+
+  return buf;
+}
+
 static GstFlowReturn
 gst_queue2_read_data_at_offset (GstQueue2 * queue, guint64 offset, guint length,
     guint8 * dst, gint64 * read_return)
@@ -1489,13 +1737,13 @@ gst_queue2_read_data_at_offset (GstQueue2 * queue, guint64 offset, guint length,
 
   ring_buffer = queue->ring_buffer;
 
-  if (QUEUE_IS_USING_TEMP_FILE (queue) && FSEEK_FILE (queue->temp_file, offset))
+  if (QUEUE_IS_USING_FILE_IO (queue) && FSEEK_FILE (queue->temp_file, offset))
     goto seek_failed;
 
   /* this should not block */
   GST_LOG_OBJECT (queue, "Reading %d bytes from offset %" G_GUINT64_FORMAT,
       length, offset);
-  if (QUEUE_IS_USING_TEMP_FILE (queue)) {
+  if (QUEUE_IS_USING_FILE_IO (queue)) {
     res = fread (dst, 1, length, queue->temp_file);
   } else {
     memcpy (dst, ring_buffer + offset, length);
@@ -1505,7 +1753,7 @@ gst_queue2_read_data_at_offset (GstQueue2 * queue, guint64 offset, guint length,
   GST_LOG_OBJECT (queue, "read %" G_GSIZE_FORMAT " bytes", res);
 
   if (G_UNLIKELY (res < length)) {
-    if (!QUEUE_IS_USING_TEMP_FILE (queue))
+    if (!QUEUE_IS_USING_FILE_IO (queue))
       goto could_not_read;
     /* check for errors or EOF */
     if (ferror (queue->temp_file))
@@ -1539,25 +1787,34 @@ static GstFlowReturn
 gst_queue2_create_read (GstQueue2 * queue, guint64 offset, guint length,
     GstBuffer ** buffer)
 {
-  GstBuffer *buf;
+  GstBuffer *buf = NULL;
   GstMapInfo info;
-  guint8 *data;
+  guint8 *data = NULL;
   guint64 file_offset;
   guint block_length, remaining, read_length;
   guint64 rb_size;
   guint64 max_size;
   guint64 rpos;
+  gboolean try_view, mapped = FALSE;
   GstFlowReturn ret = GST_FLOW_OK;
 
-  /* allocate the output buffer of the requested size */
-  if (*buffer == NULL)
-    buf = gst_buffer_new_allocate (NULL, length, NULL);
-  else
-    buf = *buffer;
+  /* with a mapped ring, the first read is handed out without copying when it
+   * covers the whole request and not too much of the ring is referenced
+   * downstream yet, the buffer is only allocated otherwise */
+  try_view = queue->mapping != NULL && *buffer == NULL && length > 0;
 
-  if (!gst_buffer_map (buf, &info, GST_MAP_WRITE))
-    goto buffer_write_fail;
-  data = info.data;
+  if (!try_view) {
+    /* allocate the output buffer of the requested size */
+    if (*buffer == NULL)
+      buf = gst_buffer_new_allocate (NULL, length, NULL);
+    else
+      buf = *buffer;
+
+    if (!gst_buffer_map (buf, &info, GST_MAP_WRITE))
+      goto buffer_write_fail;
+    data = info.data;
+    mapped = TRUE;
+  }
 
   GST_DEBUG_OBJECT (queue, "Reading %u bytes from %" G_GUINT64_FORMAT, length,
       offset);
@@ -1646,6 +1903,25 @@ gst_queue2_create_read (GstQueue2 * queue, guint64 offset, guint length,
       block_length = read_length;
     }
 
+    if (try_view) {
+      try_view = FALSE;
+
+      if (read_length == length && block_length == length &&
+          (buf = gst_queue2_new_ring_view (queue, file_offset, length))) {
+        queue->current->reading_pos += length;
+        update_cur_pos (queue, queue->current, queue->current->reading_pos);
+        GST_QUEUE2_SIGNAL_DEL (queue);
+        break;
+      }
+
+      /* wraps around the end of the ring or too much is referenced, copy */
+      buf = gst_buffer_new_allocate (NULL, length, NULL);
+      if (!gst_buffer_map (buf, &info, GST_MAP_WRITE))
+        goto buffer_write_fail;
+      data = info.data;
+      mapped = TRUE;
+    }
+
     /* while we still have data to read, we loop */
     while (read_length > 0) {
       gint64 read_return;
@@ -1672,8 +1948,10 @@ gst_queue2_create_read (GstQueue2 * queue, guint64 offset, guint length,
     GST_DEBUG_OBJECT (queue, "%u bytes left to read", remaining);
   }
 
-  gst_buffer_unmap (buf, &info);
-  gst_buffer_resize (buf, 0, length);
+  if (mapped) {
+    gst_buffer_unmap (buf, &info);
+    gst_buffer_resize (buf, 0, length);
+  }
 
   GST_BUFFER_OFFSET (buf) = offset;
   GST_BUFFER_OFFSET_END (buf) = offset + length;
@@ -1686,16 +1964,18 @@ gst_queue2_create_read (GstQueue2 * queue, guint64 offset, guint length,
 hit_eos:
   {
     GST_DEBUG_OBJECT (queue, "EOS hit and we don't have any requested data");
-    gst_buffer_unmap (buf, &info);
-    if (*buffer == NULL)
+    if (mapped)
+      gst_buffer_unmap (buf, &info);
+    if (*buffer == NULL && buf != NULL)
       gst_buffer_unref (buf);
     return GST_FLOW_EOS;
   }
 out_flushing:
   {
     GST_DEBUG_OBJECT (queue, "we are flushing");
-    gst_buffer_unmap (buf, &info);
-    if (*buffer == NULL)
+    if (mapped)
+      gst_buffer_unmap (buf, &info);
+    if (*buffer == NULL && buf != NULL)
       gst_buffer_unref (buf);
     return GST_FLOW_FLUSHING;
   }
@@ -1795,6 +2075,9 @@ gst_queue2_open_temp_location_file (GstQueue2 * queue)
   g_free (queue->temp_location);
   queue->temp_location = name;
 
+  if (queue->use_mmap && QUEUE_IS_USING_RING_BUFFER (queue))
+    gst_queue2_map_temp_file (queue);
+
   GST_QUEUE2_MUTEX_UNLOCK (queue);
 
   /* we can't emit the notify with the lock */
@@ -1846,6 +2129,13 @@ gst_queue2_close_temp_location_file (GstQueue2 * queue)
 
   GST_DEBUG_OBJECT (queue, "closing temp file");
 
+  /* buffers downstream keep their part of the mapping alive */
+  if (queue->mapping) {
+    gst_queue2_mapping_unref (queue->mapping);
+    queue->mapping = NULL;
+    queue->ring_buffer = NULL;
+  }
+
   fflush (queue->temp_file);
   fclose (queue->temp_file);
 
@@ -1866,6 +2156,11 @@ gst_queue2_flush_temp_file (GstQueue2 * queue)
   if (queue->temp_file == NULL)
     return;
 
+  /* truncating the file would invalidate the mapping, the ranges are reset
+   * anyway so the old data is simply overwritten */
+  if (queue->mapping)
+    return;
+
   GST_DEBUG_OBJECT (queue, "flushing temp file");
 
   queue->temp_file = g_freopen (queue->temp_location, "wb+", queue->temp_file);
@@ -2001,6 +2296,32 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
        * buffer now */
       to_write = MIN (size, space);
 
+      /* don't overwrite ring data that is still used downstream */
+      if (queue->ring_views) {
+        guint writable;
+
+        g_mutex_lock (&queue->view_lock);
+        while (!(writable =
+                gst_queue2_ring_writable (queue, writing_pos, to_write))) {
+          if (queue->sinkresult != GST_FLOW_OK) {
+            g_mutex_unlock (&queue->view_lock);
+            goto out_flushing;
+          }
+
+          GST_CAT_DEBUG_OBJECT (queue_dataflow, queue,
+              "ring data is still referenced, waiting for it to be released");
+          /* the reader continues meanwhile, the view lock is held until the
+           * wait so a release in between still wakes us up */
+          GST_QUEUE2_MUTEX_UNLOCK (queue);
+          g_cond_wait (&queue->view_del, &queue->view_lock);
+          g_mutex_unlock (&queue->view_lock);
+          GST_QUEUE2_MUTEX_LOCK (queue);
+          g_mutex_lock (&queue->view_lock);
+        }
+        g_mutex_unlock (&queue->view_lock);
+        to_write = writable;
+      }
+
       /* the writing position in the ring buffer after writing (part
        * or all of) the buffer */
       new_writing_pos = (writing_pos + to_write) % rb_size;
@@ -2105,7 +2426,7 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
       new_writing_pos = writing_pos + to_write;
     }
 
-    if (QUEUE_IS_USING_TEMP_FILE (queue)
+    if (QUEUE_IS_USING_FILE_IO (queue)
         && FSEEK_FILE (queue->temp_file, writing_pos))
       goto seek_failed;
 
@@ -2115,7 +2436,7 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
           "] (rb wpos %" G_GUINT64_FORMAT ")", to_write, queue->current->offset,
           queue->current->writing_pos, queue->current->rb_writing_pos);
       /* either not using ring buffer or no wrapping, just write */
-      if (QUEUE_IS_USING_TEMP_FILE (queue)) {
+      if (QUEUE_IS_USING_FILE_IO (queue)) {
         if (fwrite (data, to_write, 1, queue->temp_file) != 1)
           goto handle_error;
       } else {
@@ -2160,7 +2481,7 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
       if (block_one > 0) {
         GST_INFO_OBJECT (queue, "writing %u bytes", block_one);
         /* write data to end of ring buffer */
-        if (QUEUE_IS_USING_TEMP_FILE (queue)) {
+        if (QUEUE_IS_USING_FILE_IO (queue)) {
           if (fwrite (data, block_one, 1, queue->temp_file) != 1)
             goto handle_error;
         } else {
@@ -2168,12 +2489,12 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
         }
       }
 
-      if (QUEUE_IS_USING_TEMP_FILE (queue) && FSEEK_FILE (queue->temp_file, 0))
+      if (QUEUE_IS_USING_FILE_IO (queue) && FSEEK_FILE (queue->temp_file, 0))
         goto seek_failed;
 
       if (block_two > 0) {
         GST_INFO_OBJECT (queue, "writing %u bytes", block_two);
-        if (QUEUE_IS_USING_TEMP_FILE (queue)) {
+        if (QUEUE_IS_USING_FILE_IO (queue)) {
           if (fwrite (data + block_one, block_two, 1, queue->temp_file) != 1)
             goto handle_error;
         } else {
@@ -2593,6 +2914,7 @@ gst_queue2_handle_sink_event (GstPad * pad, GstObject * parent,
         /* unblock the loop and chain functions */
         GST_QUEUE2_SIGNAL_ADD (queue);
         GST_QUEUE2_SIGNAL_DEL (queue);
+        gst_queue2_unblock_ring_writer (queue);
         GST_QUEUE2_MUTEX_UNLOCK (queue);
 
         /* make sure it pauses, this should happen since we sent
@@ -2609,6 +2931,7 @@ gst_queue2_handle_sink_event (GstPad * pad, GstObject * parent,
         /* flush the sink pad */
         queue->sinkresult = GST_FLOW_FLUSHING;
         GST_QUEUE2_SIGNAL_DEL (queue);
+        gst_queue2_unblock_ring_writer (queue);
         queue->last_query = FALSE;
         g_cond_signal (&queue->query_handled);
         GST_QUEUE2_MUTEX_UNLOCK (queue);
@@ -3658,6 +3981,7 @@ gst_queue2_sink_activate_mode (GstPad * pad, GstObject * parent,
         queue->srcresult = GST_FLOW_FLUSHING;
         queue->sinkresult = GST_FLOW_FLUSHING;
         GST_QUEUE2_SIGNAL_DEL (queue);
+        gst_queue2_unblock_ring_writer (queue);
         GST_QUEUE2_MUTEX_UNLOCK (queue);
 
         /* wait until it is unblocked and clean up */
@@ -3990,6 +4314,9 @@ gst_queue2_set_property (GObject * object,
     case PROP_USE_BITRATE_QUERY:
       queue->use_bitrate_query = g_value_get_boolean (value);
       break;
+    case PROP_USE_MMAP:
+      queue->use_mmap = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -4077,6 +4404,9 @@ gst_queue2_get_property (GObject * object,
     case PROP_USE_BITRATE_QUERY:
       g_value_set_boolean (value, queue->use_bitrate_query);
       break;
+    case PROP_USE_MMAP:
+      g_value_set_boolean (value, queue->use_mmap);
+      break;
     case PROP_BITRATE:{
       guint64 bitrate = 0;
       if (bitrate == 0 && queue->use_tags_bitrate) {
@@ -47,6 +47,7 @@ typedef struct _GstQueue2 GstQueue2;
 typedef struct _GstQueue2Size GstQueue2Size;
 typedef struct _GstQueue2Class GstQueue2Class;
 typedef struct _GstQueue2Range GstQueue2Range;
+typedef struct _GstQueue2Mapping GstQueue2Mapping;
 
 /* used to keep track of sizes (current and max) */
 struct _GstQueue2Size
@@ -164,6 +165,15 @@ struct _GstQueue2
   guint64 ring_buffer_max_size;
   guint8 * ring_buffer;
 
+  /* temp file ring mapped into memory and the parts of it that are still
+   * referenced by buffers downstream */
+  gboolean use_mmap;
+  GstQueue2Mapping *mapping;
+  GList *ring_views;
+  GMutex view_lock;             /* protects the view state below */
+  GCond view_del;               /* signals views released downstream */
+  guint64 view_bytes;           /* bytes currently handed out as views */
+
   gint downstream_may_block;
 
   GstBufferingMode mode;
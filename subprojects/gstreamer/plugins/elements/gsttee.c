@@ -35,6 +35,14 @@
  * provide separate threads for each branch. Otherwise a blocked dataflow in one
  * branch would stall the other branches.
  *
+ * Alternatively, with #GstTee:parallel the same buffer is pushed to all the
+ * branches at the same time from a pool of threads, so that the time spent in
+ * the branches does not add up. Branches whose src pad has the `leaky`
+ * property set don't hold back the others: a buffer is dropped for such a
+ * branch when it is still busy with the previous one. The `pushed`,
+ * `dropped`, `push-latency-avg` and `push-latency-max` properties of the src
+ * pads give statistics about each branch in this mode.
+ *
  * ## Example launch line
  * |[
  * gst-launch-1.0 filesrc location=song.ogg ! decodebin ! tee name=t ! queue ! audioconvert ! audioresample ! autoaudiosink t. ! queue ! audioconvert ! goom ! videoconvert ! autovideosink
@@ -88,6 +96,7 @@ gst_tee_pull_mode_get_type (void)
 #define DEFAULT_PROP_LAST_MESSAGE	NULL
 #define DEFAULT_PULL_MODE		GST_TEE_PULL_MODE_NEVER
 #define DEFAULT_PROP_ALLOW_NOT_LINKED	FALSE
+#define DEFAULT_PROP_PARALLEL		FALSE
 
 enum
 {
@@ -99,6 +108,7 @@ enum
   PROP_PULL_MODE,
   PROP_ALLOC_PAD,
   PROP_ALLOW_NOT_LINKED,
+  PROP_PARALLEL,
 };
 
 static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src_%u",
@@ -141,6 +151,19 @@ struct _GstTeePad
   gboolean pushed;
   GstFlowReturn result;
   gboolean removed;
+
+  /* parallel mode, protected by the tee lock */
+  GstTee *tee;
+  gboolean leaky;
+  gboolean busy;
+  gpointer push_data;
+  gboolean push_is_list;
+
+  /* statistics of the parallel mode, protected by the tee lock */
+  guint64 num_pushed;
+  guint64 num_dropped;
+  GstClockTime latency_total;
+  GstClockTime latency_max;
 };
 
 struct _GstTeePadClass
@@ -148,11 +171,99 @@ struct _GstTeePadClass
   GstPadClass parent;
 };
 
+enum
+{
+  PROP_PAD_0,
+  PROP_PAD_LEAKY,
+  PROP_PAD_PUSHED,
+  PROP_PAD_DROPPED,
+  PROP_PAD_PUSH_LATENCY_AVG,
+  PROP_PAD_PUSH_LATENCY_MAX,
+};
+
 G_DEFINE_TYPE (GstTeePad, gst_tee_pad, GST_TYPE_PAD);
 
+static void
+gst_tee_pad_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstTeePad *pad = GST_TEE_PAD_CAST (object);
+
+  switch (prop_id) {
+    case PROP_PAD_LEAKY:
+      GST_OBJECT_LOCK (pad->tee);
+      pad->leaky = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (pad->tee);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_tee_pad_get_property (GObject * object, guint prop_id, GValue * value,
+    GParamSpec * pspec)
+{
+  GstTeePad *pad = GST_TEE_PAD_CAST (object);
+
+  GST_OBJECT_LOCK (pad->tee);
+  switch (prop_id) {
+    case PROP_PAD_LEAKY:
+      g_value_set_boolean (value, pad->leaky);
+      break;
+    case PROP_PAD_PUSHED:
+      g_value_set_uint64 (value, pad->num_pushed);
+      break;
+    case PROP_PAD_DROPPED:
+      g_value_set_uint64 (value, pad->num_dropped);
+      break;
+    case PROP_PAD_PUSH_LATENCY_AVG:
+      g_value_set_uint64 (value, pad->num_pushed ?
+          pad->latency_total / pad->num_pushed : 0);
+      break;
+    case PROP_PAD_PUSH_LATENCY_MAX:
+      g_value_set_uint64 (value, pad->latency_max);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  GST_OBJECT_UNLOCK (pad->tee);
+}
+
 static void
 gst_tee_pad_class_init (GstTeePadClass * klass)
 {
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->set_property = gst_tee_pad_set_property;
+  gobject_class->get_property = gst_tee_pad_get_property;
+
+  g_object_class_install_property (gobject_class, PROP_PAD_LEAKY,
+      g_param_spec_boolean ("leaky", "Leaky",
+          "Drop buffers for this branch while it is busy (parallel mode only)",
+          FALSE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_PAD_PUSHED,
+      g_param_spec_uint64 ("pushed", "Pushed",
+          "Number of buffers or lists pushed on this branch (parallel mode "
+          "only)", 0, G_MAXUINT64, 0,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_PAD_DROPPED,
+      g_param_spec_uint64 ("dropped", "Dropped",
+          "Number of buffers or lists dropped because this leaky branch was "
+          "busy", 0, G_MAXUINT64, 0,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_PAD_PUSH_LATENCY_AVG,
+      g_param_spec_uint64 ("push-latency-avg", "Average push latency",
+          "Average time in nanoseconds a push on this branch took (parallel "
+          "mode only)", 0, G_MAXUINT64, 0,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_PAD_PUSH_LATENCY_MAX,
+      g_param_spec_uint64 ("push-latency-max", "Maximum push latency",
+          "Maximum time in nanoseconds a push on this branch took (parallel "
+          "mode only)", 0, G_MAXUINT64, 0,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -200,8 +311,20 @@ static GstFlowReturn gst_tee_src_get_range (GstPad * pad, GstObject * parent,
 static void
 gst_tee_dispose (GObject * object)
 {
+  GstTee *tee = GST_TEE (object);
   GList *item;
 
+  /* pushes on leaky branches can still be running */
+  GST_OBJECT_LOCK (tee);
+  while (tee->pushes_in_flight > 0)
+    g_cond_wait (&tee->push_cond, GST_OBJECT_GET_LOCK (tee));
+  GST_OBJECT_UNLOCK (tee);
+
+  if (tee->push_pool) {
+    gst_task_pool_cleanup (tee->push_pool);
+    gst_clear_object (&tee->push_pool);
+  }
+
 restart:
   for (item = GST_ELEMENT_PADS (object); item; item = g_list_next (item)) {
     GstPad *pad = GST_PAD (item->data);
@@ -224,6 +347,7 @@ gst_tee_finalize (GObject * object)
   g_hash_table_unref (tee->pad_indexes);
 
   g_free (tee->last_message);
+  g_cond_clear (&tee->push_cond);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -288,6 +412,24 @@ gst_tee_class_init (GstTeeClass * klass)
           "all unlinked", DEFAULT_PROP_ALLOW_NOT_LINKED,
           G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstTee:parallel
+   *
+   * Push each buffer to all the src pads at the same time from a pool of
+   * threads instead of one after the other from the streaming thread. The
+   * buffers are shared between the branches like in the default mode.
+   *
+   * Src pads with the `leaky` property set don't hold back the streaming
+   * thread, a buffer is dropped for them when they are still busy with the
+   * previous one.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_PARALLEL,
+      g_param_spec_boolean ("parallel", "Parallel",
+          "Push to all the src pads at the same time", DEFAULT_PROP_PARALLEL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (gstelement_class,
       "Tee pipe fitting",
       "Generic",
@@ -324,6 +466,8 @@ gst_tee_init (GstTee * tee)
   tee->pad_indexes = g_hash_table_new (NULL, NULL);
 
   tee->last_message = NULL;
+  tee->parallel = DEFAULT_PROP_PARALLEL;
+  g_cond_init (&tee->push_cond);
 }
 
 static void
@@ -390,6 +534,7 @@ gst_tee_request_new_pad (GstElement * element, GstPadTemplate * templ,
           "name", name, "direction", templ->direction, "template", templ,
           NULL));
   GST_TEE_PAD_CAST (srcpad)->index = index;
+  GST_TEE_PAD_CAST (srcpad)->tee = tee;
   g_free (name);
 
   mode = tee->sink_mode;
@@ -508,6 +653,9 @@ gst_tee_set_property (GObject * object, guint prop_id, const GValue * value,
     case PROP_ALLOW_NOT_LINKED:
       tee->allow_not_linked = g_value_get_boolean (value);
       break;
+    case PROP_PARALLEL:
+      tee->parallel = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -544,6 +692,9 @@ gst_tee_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_ALLOW_NOT_LINKED:
       g_value_set_boolean (value, tee->allow_not_linked);
       break;
+    case PROP_PARALLEL:
+      g_value_set_boolean (value, tee->parallel);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -551,11 +702,26 @@ gst_tee_get_property (GObject * object, guint prop_id, GValue * value,
   GST_OBJECT_UNLOCK (tee);
 }
 
+/* waits until no push of the parallel mode is running anymore */
+static void
+gst_tee_wait_pushes (GstTee * tee)
+{
+  GST_OBJECT_LOCK (tee);
+  while (tee->pushes_in_flight > 0)
+    g_cond_wait (&tee->push_cond, GST_OBJECT_GET_LOCK (tee));
+  GST_OBJECT_UNLOCK (tee);
+}
+
 static gboolean
 gst_tee_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
 {
   gboolean res;
 
+  /* keep serialized events behind the buffers still being pushed on leaky
+   * branches */
+  if (GST_EVENT_IS_SERIALIZED (event))
+    gst_tee_wait_pushes (GST_TEE_CAST (parent));
+
   switch (GST_EVENT_TYPE (event)) {
     default:
       res = gst_pad_event_default (pad, parent, event);
@@ -865,6 +1031,170 @@ clear_pads (GstPad * pad, GstTee * tee)
   GST_TEE_PAD_CAST (pad)->result = GST_FLOW_NOT_LINKED;
 }
 
+static void
+gst_tee_pad_push_func (GstTeePad * tpad)
+{
+  GstTee *tee = tpad->tee;
+  GstPad *pad = GST_PAD_CAST (tpad);
+  GstClockTime start, latency;
+  GstFlowReturn ret;
+
+  GST_LOG_OBJECT (pad, "Starting to push %s %p",
+      tpad->push_is_list ? "list" : "buffer", tpad->push_data);
+
+  /* push_data is only touched by us while the pad is busy */
+  start = gst_util_get_timestamp ();
+  if (tpad->push_is_list)
+    ret = gst_pad_push_list (pad, tpad->push_data);
+  else
+    ret = gst_pad_push (pad, tpad->push_data);
+  latency = gst_util_get_timestamp () - start;
+
+  GST_LOG_OBJECT (pad, "Pushing yielded result %s", gst_flow_get_name (ret));
+
+  GST_OBJECT_LOCK (tee);
+  tpad->push_data = NULL;
+  tpad->result = ret;
+  tpad->num_pushed++;
+  tpad->latency_total += latency;
+  if (latency > tpad->latency_max)
+    tpad->latency_max = latency;
+  tpad->busy = FALSE;
+  tee->pushes_in_flight--;
+  g_cond_broadcast (&tee->push_cond);
+  GST_OBJECT_UNLOCK (tee);
+
+  gst_object_unref (pad);
+}
+
+/* Called with the tee lock held, which is released. Pushes @data on all the
+ * src pads at the same time and waits for all of them but the leaky ones. */
+static GstFlowReturn
+gst_tee_handle_data_parallel (GstTee * tee, gpointer data, gboolean is_list)
+{
+  GstElement *element = GST_ELEMENT_CAST (tee);
+  GstTeePad **tpads, *last = NULL;
+  gboolean *started;
+  GstFlowReturn ret = GST_FLOW_OK, cret;
+  guint n_pads = 0, i;
+  GList *pads;
+
+  if (G_UNLIKELY (tee->push_pool == NULL)) {
+    GError *err = NULL;
+
+    tee->push_pool = gst_shared_task_pool_new ();
+    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL
+        (tee->push_pool), element->numsrcpads);
+    gst_task_pool_prepare (tee->push_pool, &err);
+    if (err) {
+      GST_WARNING_OBJECT (tee, "failed to prepare push pool: %s",
+          err->message);
+      g_clear_error (&err);
+    }
+  } else if (gst_shared_task_pool_get_max_threads (GST_SHARED_TASK_POOL
+          (tee->push_pool)) < element->numsrcpads) {
+    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL
+        (tee->push_pool), element->numsrcpads);
+  }
+
+  /* the previous push on a branch that can't drop is normally done already,
+   * unless the pad stopped being leaky during it */
+restart:
+  for (pads = element->srcpads; pads; pads = g_list_next (pads)) {
+    GstTeePad *tpad = GST_TEE_PAD_CAST (pads->data);
+
+    if (tpad->busy && !tpad->leaky) {
+      g_cond_wait (&tee->push_cond, GST_OBJECT_GET_LOCK (tee));
+      goto restart;
+    }
+  }
+
+  tpads = g_newa (GstTeePad *, element->numsrcpads);
+  started = g_newa (gboolean, element->numsrcpads);
+
+  for (pads = element->srcpads; pads; pads = g_list_next (pads)) {
+    GstTeePad *tpad = GST_TEE_PAD_CAST (pads->data);
+
+    if (GST_PAD_CAST (tpad) == tee->pull_pad || tpad->removed)
+      continue;
+
+    if (tpad->busy) {
+      GST_LOG_OBJECT (tpad, "branch busy, dropping %s %p",
+          is_list ? "list" : "buffer", data);
+      tpad->num_dropped++;
+      started[n_pads] = FALSE;
+    } else {
+      tpad->busy = TRUE;
+      tpad->push_data = gst_mini_object_ref (GST_MINI_OBJECT_CAST (data));
+      tpad->push_is_list = is_list;
+      tee->pushes_in_flight++;
+      started[n_pads] = TRUE;
+      if (!tpad->leaky)
+        last = tpad;
+    }
+    tpads[n_pads++] = gst_object_ref (tpad);
+  }
+  GST_OBJECT_UNLOCK (tee);
+
+  /* the streaming thread pushes on the last branch that can't drop itself */
+  for (i = 0; i < n_pads; i++) {
+    GError *err = NULL;
+    gpointer handle;
+
+    if (!started[i] || tpads[i] == last)
+      continue;
+
+    handle = gst_task_pool_push (tee->push_pool,
+        (GstTaskPoolFunction) gst_tee_pad_push_func,
+        gst_object_ref (tpads[i]), &err);
+    if (err) {
+      GST_WARNING_OBJECT (tee, "failed to push on pool: %s", err->message);
+      g_clear_error (&err);
+    }
+    if (handle)
+      gst_task_pool_dispose_handle (tee->push_pool, handle);
+    else
+      gst_tee_pad_push_func (tpads[i]);
+  }
+  if (last)
+    gst_tee_pad_push_func (gst_object_ref (last));
+
+  cret = tee->allow_not_linked ? GST_FLOW_OK : GST_FLOW_NOT_LINKED;
+
+  GST_OBJECT_LOCK (tee);
+  for (i = 0; i < n_pads; i++) {
+    GstTeePad *tpad = tpads[i];
+    GstFlowReturn pad_ret;
+
+    if (!tpad->leaky) {
+      while (tpad->busy)
+        g_cond_wait (&tee->push_cond, GST_OBJECT_GET_LOCK (tee));
+    }
+
+    /* leaky branches that are still busy report their previous result */
+    pad_ret = tpad->removed ? GST_FLOW_NOT_LINKED : tpad->result;
+
+    if (G_UNLIKELY (pad_ret != GST_FLOW_OK && pad_ret != GST_FLOW_NOT_LINKED)) {
+      if (ret == GST_FLOW_OK)
+        ret = pad_ret;
+    } else if (pad_ret != GST_FLOW_NOT_LINKED) {
+      cret = pad_ret;
+    }
+  }
+  GST_OBJECT_UNLOCK (tee);
+
+  for (i = 0; i < n_pads; i++)
+    gst_object_unref (tpads[i]);
+  gst_mini_object_unref (GST_MINI_OBJECT_CAST (data));
+
+  if (ret != GST_FLOW_OK) {
+    GST_DEBUG_OBJECT (tee, "received error %s", gst_flow_get_name (ret));
+    return ret;
+  }
+
+  return cret;
+}
+
 static GstFlowReturn
 gst_tee_handle_data (GstTee * tee, gpointer data, gboolean is_list)
 {
@@ -882,6 +1212,16 @@ gst_tee_handle_data (GstTee * tee, gpointer data, gboolean is_list)
   if (G_UNLIKELY (!pads))
     goto no_pads;
 
+  if (tee->parallel)
+    return gst_tee_handle_data_parallel (tee, data, is_list);
+
+  /* pushes of the parallel mode can still be running on leaky branches */
+  while (G_UNLIKELY (tee->pushes_in_flight > 0))
+    g_cond_wait (&tee->push_cond, GST_OBJECT_GET_LOCK (tee));
+  pads = GST_ELEMENT_CAST (tee)->srcpads;
+  if (G_UNLIKELY (!pads))
+    goto no_pads;
+
   /* special case for just one pad that avoids reffing the buffer */
   if (!pads->next) {
     GstPad *pad = GST_PAD_CAST (pads->data);
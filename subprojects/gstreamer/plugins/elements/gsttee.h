@@ -81,6 +81,12 @@ struct _GstTee {
   GstPad         *pull_pad;
 
   gboolean        allow_not_linked;
+
+  /* pushing to the branches at the same time */
+  gboolean        parallel;
+  GstTaskPool    *push_pool;
+  GCond           push_cond;
+  guint           pushes_in_flight;
 };
 
 struct _GstTeeClass {
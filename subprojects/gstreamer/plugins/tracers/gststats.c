@@ -23,6 +23,12 @@
  * @short_description: log event stats
  *
  * A tracing module that builds usage statistic for elements and pads.
+ *
+ * When the per-thread slab is enabled with `GST_SLAB_ALLOC`, its allocation
+ * counts are logged when the tracer goes away.
+ *
+ * When the caps cache is enabled with `GST_CAPS_CACHE`, the number of hits and
+ * misses of the cache are logged when the tracer goes away.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -30,8 +36,15 @@
 #endif
 
 #include "gststats.h"
+#include "gst/gst_private.h"
 
 #include <stdio.h>
+#ifdef G_OS_WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
 
 GST_DEBUG_CATEGORY_STATIC (gst_stats_debug);
 #define GST_CAT_DEFAULT gst_stats_debug
@@ -54,6 +67,8 @@ static GstTracerRecord *tr_element_query;
 static GstTracerRecord *tr_event;
 static GstTracerRecord *tr_message;
 static GstTracerRecord *tr_query;
+static GstTracerRecord *tr_slab;
+static GstTracerRecord *tr_caps_cache;
 
 typedef struct
 {
@@ -518,8 +533,55 @@ do_query_post (GstStatsTracer * self, guint64 ts, GstPad * this_pad,
       qry, ts, TRUE, res);
 }
 
+static void
+log_slab_stats (void)
+{
+  GstSlabStats stats;
+
+  if (!_gst_slab_get_stats (&stats))
+    return;
+
+  gst_tracer_record_log (tr_slab, (guint64) getpid (),
+      gst_util_get_timestamp (), stats.cached_allocs, stats.system_allocs,
+      stats.refills, stats.flushes);
+}
+
+static void
+do_caps_cache_lookup (GstStatsTracer * self, GstClockTime ts,
+    const GstCaps * caps1, const GstCaps * caps2, gboolean hit)
+{
+  if (hit)
+    g_atomic_int_inc (&self->caps_cache_hits);
+  else
+    g_atomic_int_inc (&self->caps_cache_misses);
+}
+
+static void
+log_caps_cache_stats (GstStatsTracer * self)
+{
+  guint hits = g_atomic_int_get (&self->caps_cache_hits);
+  guint misses = g_atomic_int_get (&self->caps_cache_misses);
+
+  if (hits + misses == 0)
+    return;
+
+  gst_tracer_record_log (tr_caps_cache, (guint64) getpid (),
+      gst_util_get_timestamp (), hits, misses);
+}
+
 /* tracer class */
 
+static void
+gst_stats_tracer_dispose (GObject * object)
+{
+  GstStatsTracer *self = GST_STATS_TRACER (object);
+
+  log_slab_stats ();
+  log_caps_cache_stats (self);
+
+  G_OBJECT_CLASS (parent_class)->dispose (object);
+}
+
 static void
 gst_stats_tracer_constructed (GObject * object)
 {
@@ -552,6 +614,7 @@ gst_stats_tracer_class_init (GstStatsTracerClass * klass)
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
 
   gobject_class->constructed = gst_stats_tracer_constructed;
+  gobject_class->dispose = gst_stats_tracer_dispose;
 
   /* announce trace formats */
   /* *INDENT-OFF* */
@@ -773,6 +836,51 @@ gst_stats_tracer_class_init (GstStatsTracerClass * klass)
           "description", G_TYPE_STRING, "ipad direction",
           NULL),
       NULL);
+  tr_slab = gst_tracer_record_new ("slab.class",
+      "process-id", GST_TYPE_STRUCTURE, gst_structure_new ("scope",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "related-to", GST_TYPE_TRACER_VALUE_SCOPE, GST_TRACER_VALUE_SCOPE_PROCESS,
+          NULL),
+      "ts", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "event ts",
+          NULL),
+      "cached-allocs", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "allocations served from a thread cache",
+          NULL),
+      "system-allocs", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "allocations from the system allocator",
+          NULL),
+      "refills", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "magazines taken from the shared depot",
+          NULL),
+      "flushes", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING,
+          "magazines given to the shared depot by threads freeing memory of other threads",
+          NULL),
+      NULL);
+  tr_caps_cache = gst_tracer_record_new ("caps-cache.class",
+      "process-id", GST_TYPE_STRUCTURE, gst_structure_new ("scope",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "related-to", GST_TYPE_TRACER_VALUE_SCOPE, GST_TRACER_VALUE_SCOPE_PROCESS,
+          NULL),
+      "ts", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT64,
+          "description", G_TYPE_STRING, "event ts",
+          NULL),
+      "hits", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT,
+          "description", G_TYPE_STRING, "caps operations answered from the cache",
+          NULL),
+      "misses", GST_TYPE_STRUCTURE, gst_structure_new ("value",
+          "type", G_TYPE_GTYPE, G_TYPE_UINT,
+          "description", G_TYPE_STRING, "caps operations that had to be computed",
+          NULL),
+      NULL);
   /* *INDENT-ON* */
 
   GST_OBJECT_FLAG_SET (tr_buffer, GST_OBJECT_FLAG_MAY_BE_LEAKED);
@@ -782,6 +890,8 @@ gst_stats_tracer_class_init (GstStatsTracerClass * klass)
   GST_OBJECT_FLAG_SET (tr_query, GST_OBJECT_FLAG_MAY_BE_LEAKED);
   GST_OBJECT_FLAG_SET (tr_new_element, GST_OBJECT_FLAG_MAY_BE_LEAKED);
   GST_OBJECT_FLAG_SET (tr_new_pad, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+  GST_OBJECT_FLAG_SET (tr_slab, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+  GST_OBJECT_FLAG_SET (tr_caps_cache, GST_OBJECT_FLAG_MAY_BE_LEAKED);
 }
 
 static void
@@ -813,4 +923,6 @@ gst_stats_tracer_init (GstStatsTracer * self)
       G_CALLBACK (do_query_pre));
   gst_tracing_register_hook (tracer, "pad-query-post",
       G_CALLBACK (do_query_post));
+  gst_tracing_register_hook (tracer, "caps-cache-lookup",
+      G_CALLBACK (do_caps_cache_lookup));
 }
@@ -52,6 +52,7 @@ struct _GstStatsTracer {
 
   /*< private >*/
   guint num_elements, num_pads;
+  gint caps_cache_hits, caps_cache_misses;
 };
 
 struct _GstStatsTracerClass {
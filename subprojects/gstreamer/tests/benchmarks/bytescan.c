@@ -0,0 +1,183 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Measures the throughput of scanning a large elementary stream for start
+ * codes and other 32-bit patterns, like parsers do, with GstByteReader on
+ * contiguous memory and with GstAdapter on the buffers of an upstream
+ * element. A plain byte loop is measured for comparison. */
+
+#include <gst/gst.h>
+#include <gst/base/base.h>
+
+#define STREAM_SIZE (64 * 1024 * 1024)
+#define NAL_SIZE 4096
+#define BUFFER_SIZE 4096
+#define NUM_ITERATIONS 4
+
+static guint8 *stream;
+
+static void
+make_stream (void)
+{
+  GRand *rand = g_rand_new_with_seed (42);
+  gsize i;
+
+  stream = g_malloc (STREAM_SIZE);
+  for (i = 0; i < STREAM_SIZE; i++)
+    stream[i] = g_rand_int (rand);
+
+  /* no emulated start codes in the payload, like in real streams */
+  for (i = 2; i < STREAM_SIZE; i++) {
+    if (stream[i - 2] == 0 && stream[i - 1] == 0 && stream[i] <= 3)
+      stream[i] = 4;
+  }
+
+  /* start codes with a random NAL size around NAL_SIZE */
+  for (i = 0; i + 4 < STREAM_SIZE;
+      i += NAL_SIZE / 2 + g_rand_int_range (rand, 0, NAL_SIZE)) {
+    stream[i] = 0;
+    stream[i + 1] = 0;
+    stream[i + 2] = 1;
+    stream[i + 3] = g_rand_int_range (rand, 0, 0x20);
+  }
+
+  g_rand_free (rand);
+}
+
+static void
+print_result (const gchar * name, guint matches, GstClockTime elapsed)
+{
+  g_print ("%-24s %7u matches, %6.2f GB/s\n", name, matches,
+      (gdouble) STREAM_SIZE * NUM_ITERATIONS / elapsed);
+}
+
+static void
+run_loop (guint32 mask, guint32 pattern)
+{
+  GstClockTime start;
+  guint32 state;
+  guint matches = 0;
+  gsize i;
+  gint n;
+
+  start = gst_util_get_timestamp ();
+  for (n = 0; n < NUM_ITERATIONS; n++) {
+    matches = 0;
+    state = ~pattern;
+    for (i = 0; i < STREAM_SIZE; i++) {
+      state = ((state << 8) | stream[i]);
+      if (G_UNLIKELY ((state & mask) == pattern) && i >= 3)
+        matches++;
+    }
+  }
+  print_result ("byte loop", matches, gst_util_get_timestamp () - start);
+}
+
+static void
+run_byte_reader (guint32 mask, guint32 pattern)
+{
+  GstClockTime start;
+  guint matches = 0;
+  gint n;
+
+  start = gst_util_get_timestamp ();
+  for (n = 0; n < NUM_ITERATIONS; n++) {
+    GstByteReader reader = GST_BYTE_READER_INIT (stream, STREAM_SIZE);
+    gint off;
+
+    matches = 0;
+    while (gst_byte_reader_get_remaining (&reader) >= 4) {
+      off = gst_byte_reader_masked_scan_uint32 (&reader, mask, pattern, 0,
+          gst_byte_reader_get_remaining (&reader));
+      if (off < 0)
+        break;
+      matches++;
+      gst_byte_reader_skip_unchecked (&reader, off + 1);
+    }
+  }
+  print_result ("GstByteReader", matches, gst_util_get_timestamp () - start);
+}
+
+static void
+run_adapter (guint32 mask, guint32 pattern)
+{
+  GstAdapter *adapter;
+  GstClockTime start;
+  guint matches = 0;
+  gsize i;
+  gint n;
+
+  adapter = gst_adapter_new ();
+
+  start = gst_util_get_timestamp ();
+  for (n = 0; n < NUM_ITERATIONS; n++) {
+    gsize pos = 0;
+
+    matches = 0;
+    for (i = 0; i < STREAM_SIZE; i += BUFFER_SIZE) {
+      gst_adapter_push (adapter, gst_buffer_new_wrapped_full (0,
+              stream + i, BUFFER_SIZE, 0, BUFFER_SIZE, NULL, NULL));
+
+      /* scan what was added, the last 3 bytes might start a match */
+      while (gst_adapter_available (adapter) - pos >= 4) {
+        gssize off = gst_adapter_masked_scan_uint32 (adapter, mask, pattern,
+            pos, gst_adapter_available (adapter) - pos);
+
+        if (off < 0) {
+          pos = gst_adapter_available (adapter) - 3;
+          break;
+        }
+        matches++;
+        pos = off + 1;
+      }
+
+      /* drop what was scanned */
+      gst_adapter_flush (adapter, pos);
+      pos = 0;
+    }
+    gst_adapter_clear (adapter);
+  }
+  print_result ("GstAdapter", matches, gst_util_get_timestamp () - start);
+
+  g_object_unref (adapter);
+}
+
+static void
+run_test (const gchar * name, guint32 mask, guint32 pattern)
+{
+  g_print ("%s (mask 0x%08x, pattern 0x%08x):\n", name, mask, pattern);
+  run_loop (mask, pattern);
+  run_byte_reader (mask, pattern);
+  run_adapter (mask, pattern);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  gst_init (&argc, &argv);
+
+  make_stream ();
+
+  run_test ("start codes", 0xffffff00, 0x00000100);
+  run_test ("H.264 IDR slices", 0xffffff1f, 0x00000105);
+  run_test ("MPEG-2 sequence headers", 0xffffffff, 0x000001b3);
+
+  g_free (stream);
+
+  return 0;
+}
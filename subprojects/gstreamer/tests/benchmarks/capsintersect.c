@@ -0,0 +1,113 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Measures the caps operations done during negotiation with large caps, like
+ * the ones of decoders and parsers that list many formats and profiles:
+ * intersecting, checking for intersection and for subsets against fixed
+ * caps and against caps with ranges. */
+
+#include <gst/gst.h>
+
+#define NUM_ITERATIONS 200
+#define NUM_STRUCTURES 200
+
+static const gchar *formats[] = {
+  "I420", "YV12", "NV12", "NV21", "YUY2", "UYVY", "AYUV", "RGBx",
+  "BGRx", "xRGB", "xBGR", "RGBA", "BGRA", "ARGB", "ABGR", "RGB",
+  "BGR", "Y41B", "Y42B", "Y444", "GRAY8", "GRAY16_LE", "P010_10LE",
+  "I420_10LE", "I422_10LE"
+};
+
+static GstCaps *
+make_large_caps (void)
+{
+  GstCaps *caps = gst_caps_new_empty ();
+  gint i;
+
+  for (i = 0; i < NUM_STRUCTURES; i++) {
+    gst_caps_append_structure (caps, gst_structure_new ("video/x-raw",
+            "format", G_TYPE_STRING, formats[i % G_N_ELEMENTS (formats)],
+            "width", G_TYPE_INT, 320 + 16 * (i / G_N_ELEMENTS (formats)),
+            "height", G_TYPE_INT, 240,
+            "framerate", GST_TYPE_FRACTION, 30, 1,
+            "pixel-aspect-ratio", GST_TYPE_FRACTION, 1, 1,
+            "interlace-mode", G_TYPE_STRING, "progressive",
+            "colorimetry", G_TYPE_STRING, "bt601",
+            "chroma-site", G_TYPE_STRING, "mpeg2", NULL));
+  }
+
+  return caps;
+}
+
+static void
+run_test (const gchar * name, GstCaps * caps1, GstCaps * caps2)
+{
+  GstClockTime start, end;
+  GstCaps *res;
+  gint i;
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_ITERATIONS; i++) {
+    res = gst_caps_intersect (caps1, caps2);
+    gst_caps_unref (res);
+  }
+  end = gst_util_get_timestamp ();
+  g_print ("%-12s intersect:     %" GST_TIME_FORMAT "\n", name,
+      GST_TIME_ARGS ((end - start) / NUM_ITERATIONS));
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_ITERATIONS; i++)
+    gst_caps_can_intersect (caps1, caps2);
+  end = gst_util_get_timestamp ();
+  g_print ("%-12s can_intersect: %" GST_TIME_FORMAT "\n", name,
+      GST_TIME_ARGS ((end - start) / NUM_ITERATIONS));
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_ITERATIONS; i++)
+    gst_caps_is_subset (caps2, caps1);
+  end = gst_util_get_timestamp ();
+  g_print ("%-12s is_subset:     %" GST_TIME_FORMAT "\n", name,
+      GST_TIME_ARGS ((end - start) / NUM_ITERATIONS));
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  GstCaps *large, *fixed, *ranges;
+
+  gst_init (&argc, &argv);
+
+  large = make_large_caps ();
+
+  /* matches the last structure only */
+  fixed = gst_caps_copy_nth (large, NUM_STRUCTURES - 1);
+
+  ranges = gst_caps_from_string ("video/x-raw, format = (string) "
+      "{ NV12, I420 }, width = (int) [ 1, MAX ], height = (int) [ 1, MAX ], "
+      "framerate = (fraction) [ 0/1, MAX ]");
+
+  run_test ("fixed", large, fixed);
+  run_test ("ranges", large, ranges);
+  run_test ("large", large, large);
+
+  gst_caps_unref (ranges);
+  gst_caps_unref (fixed);
+  gst_caps_unref (large);
+
+  return 0;
+}
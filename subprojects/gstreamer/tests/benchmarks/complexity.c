@@ -111,6 +111,8 @@ main (gint argc, gchar * argv[])
   gst_message_unref (msg);
   g_print ("%" GST_TIME_FORMAT " - putting %d buffers through\n",
       GST_TIME_ARGS (end - start), BUFFER_COUNT);
+  g_print ("%.1f ns per buffer and pad push\n",
+      (gdouble) (end - start) / BUFFER_COUNT / n_elements);
 
   start = gst_util_get_timestamp ();
   if (gst_element_set_state (pipeline,
@@ -0,0 +1,145 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Measures the time it takes a pipeline with many independent branches to
+ * go to PLAYING, with the state of the children changed one after the other
+ * and with an increasing number of state change threads. Each branch has an
+ * element that takes some time to start, like one opening a device. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gst/gst.h>
+#include <gst/base/gstbasetransform.h>
+
+static const guint num_threads[] = { 0, 1, 2, 4, 8, 16 };
+
+static guint start_delay_us = 10000;
+
+typedef GstBaseTransform SlowStart;
+typedef GstBaseTransformClass SlowStartClass;
+
+static GType slow_start_get_type (void);
+G_DEFINE_TYPE (SlowStart, slow_start, GST_TYPE_BASE_TRANSFORM);
+
+static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK, GST_PAD_ALWAYS, GST_STATIC_CAPS_ANY);
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC, GST_PAD_ALWAYS, GST_STATIC_CAPS_ANY);
+
+static gboolean
+slow_start_start (GstBaseTransform * trans)
+{
+  g_usleep (start_delay_us);
+  return TRUE;
+}
+
+static void
+slow_start_class_init (SlowStartClass * klass)
+{
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+
+  gst_element_class_add_static_pad_template (element_class, &sink_template);
+  gst_element_class_add_static_pad_template (element_class, &src_template);
+  gst_element_class_set_static_metadata (element_class, "Slow start",
+      "Filter", "Takes some time to start", "GStreamer");
+
+  klass->start = slow_start_start;
+}
+
+static void
+slow_start_init (SlowStart * trans)
+{
+  gst_base_transform_set_passthrough (trans, TRUE);
+}
+
+static GstElement *
+make_pipeline (guint n_branches, guint threads)
+{
+  GstElement *pipeline, *src, *filter, *sink;
+  guint i;
+
+  pipeline = gst_pipeline_new (NULL);
+  g_object_set (pipeline, "state-change-threads", threads, NULL);
+
+  for (i = 0; i < n_branches; i++) {
+    src = gst_element_factory_make ("fakesrc", NULL);
+    g_object_set (src, "num-buffers", 1, NULL);
+    filter = g_object_new (slow_start_get_type (), NULL);
+    sink = gst_element_factory_make ("fakesink", NULL);
+    g_object_set (sink, "sync", FALSE, NULL);
+
+    gst_bin_add_many (GST_BIN (pipeline), src, filter, sink, NULL);
+    if (!gst_element_link_many (src, filter, sink, NULL))
+      g_error ("could not link branch %u", i);
+  }
+
+  return pipeline;
+}
+
+static void
+run_test (guint n_branches, guint threads)
+{
+  GstElement *pipeline;
+  GstClockTime start, end;
+
+  pipeline = make_pipeline (n_branches, threads);
+
+  start = gst_util_get_timestamp ();
+  if (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE)
+    g_error ("could not go to PLAYING");
+  if (gst_element_get_state (pipeline, NULL, NULL,
+          GST_CLOCK_TIME_NONE) != GST_STATE_CHANGE_SUCCESS)
+    g_error ("could not reach PLAYING");
+  end = gst_util_get_timestamp ();
+
+  g_print ("%2u threads: time to PLAYING %" GST_TIME_FORMAT "\n", threads,
+      GST_TIME_ARGS (end - start));
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  guint n_branches, i;
+
+  gst_init (&argc, &argv);
+
+  if (argc < 2) {
+    g_print ("usage: %s <branches> [start delay in us]\n", argv[0]);
+    exit (-1);
+  }
+
+  n_branches = atoi (argv[1]);
+  if (argc > 2)
+    start_delay_us = atoi (argv[2]);
+
+  if (n_branches == 0) {
+    g_print ("number of branches must be greater than 0\n");
+    exit (-3);
+  }
+
+  g_print ("%u branches, %u us to start each\n", n_branches, start_delay_us);
+
+  for (i = 0; i < G_N_ELEMENTS (num_threads); i++)
+    run_test (n_branches, num_threads[i]);
+
+  return 0;
+}
@@ -0,0 +1,124 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Measures scheduling many outstanding async waits on the system clock,
+ * like a server with thousands of jitterbuffers and live sinks does. The
+ * entries are added in random order with deadlines spread over one second,
+ * then the benchmark waits for all callbacks and reports how late they
+ * fired. */
+
+#include <stdlib.h>
+#include <gst/gst.h>
+
+#define DEFAULT_NUM_ENTRIES 10000
+#define SPREAD GST_SECOND
+
+static GMutex lock;
+static GCond cond;
+static guint fired;
+static GstClockTime total_late, max_late;
+
+static gboolean
+callback (GstClock * clock, GstClockTime time, GstClockID id,
+    gpointer user_data)
+{
+  GstClockTime now = gst_clock_get_time (clock);
+  GstClockTime late = now > time ? now - time : 0;
+
+  g_mutex_lock (&lock);
+  total_late += late;
+  max_late = MAX (max_late, late);
+  fired++;
+  g_cond_signal (&cond);
+  g_mutex_unlock (&lock);
+
+  return TRUE;
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  GstClock *clock;
+  GstClockID *ids;
+  GstClockTime base, start, end;
+  GRand *rand;
+  guint i, num_entries = DEFAULT_NUM_ENTRIES;
+
+  gst_init (&argc, &argv);
+
+  if (argc > 1)
+    num_entries = atoi (argv[1]);
+  if (num_entries == 0) {
+    g_print ("usage: %s [<number of entries>]\n", argv[0]);
+    exit (-1);
+  }
+
+  clock = gst_system_clock_obtain ();
+  rand = g_rand_new_with_seed (42);
+  ids = g_new (GstClockID, num_entries);
+
+  /* leave some time to add all entries before the first one is due */
+  base = gst_clock_get_time (clock) + 200 * GST_MSECOND;
+  for (i = 0; i < num_entries; i++)
+    ids[i] = gst_clock_new_single_shot_id (clock,
+        base + g_rand_int_range (rand, 0, SPREAD / GST_USECOND) * GST_USECOND);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < num_entries; i++)
+    gst_clock_id_wait_async (ids[i], callback, NULL, NULL);
+  end = gst_util_get_timestamp ();
+
+  g_print ("%u entries: scheduling took %" GST_TIME_FORMAT " - %"
+      GST_TIME_FORMAT " per entry\n", num_entries, GST_TIME_ARGS (end - start),
+      GST_TIME_ARGS ((end - start) / num_entries));
+
+  g_mutex_lock (&lock);
+  while (fired < num_entries)
+    g_cond_wait (&cond, &lock);
+  g_mutex_unlock (&lock);
+
+  g_print ("all fired: average %" GST_TIME_FORMAT " late, maximum %"
+      GST_TIME_FORMAT " late\n", GST_TIME_ARGS (total_late / num_entries),
+      GST_TIME_ARGS (max_late));
+
+  /* like timeouts that are cancelled before they are due */
+  base = gst_clock_get_time (clock) + SPREAD;
+  for (i = 0; i < num_entries; i++) {
+    gst_clock_id_unref (ids[i]);
+    ids[i] = gst_clock_new_single_shot_id (clock,
+        base + g_rand_int_range (rand, 0, SPREAD / GST_USECOND) * GST_USECOND);
+  }
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < num_entries; i++)
+    gst_clock_id_wait_async (ids[i], callback, NULL, NULL);
+  for (i = 0; i < num_entries; i++)
+    gst_clock_id_unschedule (ids[i]);
+  end = gst_util_get_timestamp ();
+
+  g_print ("%u entries: scheduling and unscheduling took %" GST_TIME_FORMAT
+      "\n", num_entries, GST_TIME_ARGS (end - start));
+
+  for (i = 0; i < num_entries; i++)
+    gst_clock_id_unref (ids[i]);
+  g_free (ids);
+  g_rand_free (rand);
+  gst_object_unref (clock);
+
+  return 0;
+}
@@ -0,0 +1,126 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Measures the cost of waking up a GstPoll with one active fd among many
+ * idle ones, with the ppoll() and the epoll backend. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <gst/gst.h>
+
+#define NUM_WAKEUPS 10000
+
+static const guint num_fds[] = { 10, 1000, 10000 };
+
+static gboolean
+raise_fd_limit (guint needed)
+{
+  struct rlimit rl;
+
+  if (getrlimit (RLIMIT_NOFILE, &rl) < 0)
+    return FALSE;
+
+  if (rl.rlim_cur >= needed)
+    return TRUE;
+
+  if (rl.rlim_max < needed)
+    return FALSE;
+
+  rl.rlim_cur = needed;
+  return setrlimit (RLIMIT_NOFILE, &rl) == 0;
+}
+
+static void
+run_test (const gchar * mode, guint n_fds)
+{
+  GstPoll *set;
+  GstPollFD active = GST_POLL_FD_INIT;
+  GstPollFD *idle;
+  gint sock[2], idle_pipe[2];
+  GstClockTime start, end;
+  guint i;
+  gchar c = 'W';
+
+  if (!raise_fd_limit (n_fds + 64)) {
+    g_print ("%-6s %6u fds: skipped, fd limit too low\n", mode, n_fds);
+    return;
+  }
+
+  g_setenv ("GST_POLL_MODE", mode, TRUE);
+  set = gst_poll_new (TRUE);
+
+  if (socketpair (PF_UNIX, SOCK_STREAM, 0, sock) < 0 || pipe (idle_pipe) < 0)
+    g_error ("could not create fds");
+
+  /* all idle fds share a pipe that is never written to */
+  idle = g_new (GstPollFD, n_fds - 1);
+  for (i = 0; i < n_fds - 1; i++) {
+    gst_poll_fd_init (&idle[i]);
+    idle[i].fd = dup (idle_pipe[0]);
+    gst_poll_add_fd (set, &idle[i]);
+    gst_poll_fd_ctl_read (set, &idle[i], TRUE);
+  }
+
+  active.fd = sock[0];
+  gst_poll_add_fd (set, &active);
+  gst_poll_fd_ctl_read (set, &active, TRUE);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < NUM_WAKEUPS; i++) {
+    if (write (sock[1], &c, 1) != 1)
+      g_error ("write failed");
+    if (gst_poll_wait (set, GST_CLOCK_TIME_NONE) != 1)
+      g_error ("unexpected wakeup");
+    if (!gst_poll_fd_can_read (set, &active))
+      g_error ("active fd not readable");
+    if (read (sock[0], &c, 1) != 1)
+      g_error ("read failed");
+  }
+  end = gst_util_get_timestamp ();
+
+  g_print ("%-6s %6u fds: %" GST_TIME_FORMAT " per wakeup\n", mode, n_fds,
+      GST_TIME_ARGS ((end - start) / NUM_WAKEUPS));
+
+  gst_poll_free (set);
+
+  for (i = 0; i < n_fds - 1; i++)
+    close (idle[i].fd);
+  g_free (idle);
+  close (idle_pipe[0]);
+  close (idle_pipe[1]);
+  close (sock[0]);
+  close (sock[1]);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  guint i;
+
+  gst_init (&argc, &argv);
+
+  for (i = 0; i < G_N_ELEMENTS (num_fds); i++) {
+    run_test ("poll", num_fds[i]);
+    run_test ("epoll", num_fds[i]);
+  }
+
+  return 0;
+}
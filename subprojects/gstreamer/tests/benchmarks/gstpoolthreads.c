@@ -0,0 +1,116 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Measures the acquire/release throughput of a single buffer pool shared by
+ * an increasing number of threads. Each thread acquires a few buffers and
+ * releases them again in a loop, like an element in a pipeline would. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gst/gst.h>
+
+#define BUFFER_SIZE (1400)
+#define BUFFERS_PER_ITERATION 4
+
+static const guint num_threads[] = { 1, 2, 4, 8, 16 };
+
+static GstBufferPool *pool;
+static guint64 iterations;
+
+static gpointer
+run_thread (gpointer data)
+{
+  GstBuffer *bufs[BUFFERS_PER_ITERATION];
+  guint64 i;
+  guint j;
+
+  for (i = 0; i < iterations; i++) {
+    for (j = 0; j < BUFFERS_PER_ITERATION; j++) {
+      if (gst_buffer_pool_acquire_buffer (pool, &bufs[j], NULL) != GST_FLOW_OK)
+        g_error ("could not acquire buffer");
+    }
+    for (j = 0; j < BUFFERS_PER_ITERATION; j++)
+      gst_buffer_unref (bufs[j]);
+  }
+
+  return NULL;
+}
+
+static void
+run_test (guint n_threads)
+{
+  GThread **threads;
+  GstClockTime start, end;
+  guint64 total;
+  guint i;
+
+  threads = g_new (GThread *, n_threads);
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < n_threads; i++)
+    threads[i] = g_thread_new (NULL, run_thread, NULL);
+  for (i = 0; i < n_threads; i++)
+    g_thread_join (threads[i]);
+  end = gst_util_get_timestamp ();
+
+  total = iterations * BUFFERS_PER_ITERATION * n_threads;
+  g_print ("%2u threads: total %" GST_TIME_FORMAT " - %.0f buffers/s"
+      " - average %" GST_TIME_FORMAT " per buffer\n", n_threads,
+      GST_TIME_ARGS (end - start),
+      (gdouble) total * GST_SECOND / (end - start),
+      GST_TIME_ARGS ((end - start) / total));
+
+  g_free (threads);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  GstStructure *conf;
+  guint i;
+
+  gst_init (&argc, &argv);
+
+  if (argc != 2) {
+    g_print ("usage: %s <iterations per thread>\n", argv[0]);
+    exit (-1);
+  }
+
+  iterations = atoi (argv[1]);
+
+  if (iterations <= 0) {
+    g_print ("number of iterations must be greater than 0\n");
+    exit (-3);
+  }
+
+  pool = gst_buffer_pool_new ();
+
+  conf = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (conf, NULL, BUFFER_SIZE, 0, 0);
+  gst_buffer_pool_set_config (pool, conf);
+
+  gst_buffer_pool_set_active (pool, TRUE);
+
+  for (i = 0; i < G_N_ELEMENTS (num_threads); i++)
+    run_test (num_threads[i]);
+
+  gst_buffer_pool_set_active (pool, FALSE);
+  gst_object_unref (pool);
+
+  return 0;
+}
@@ -20,12 +20,52 @@
  */
 
 
+/* Measures the startup time, which is mostly loading the registry cache,
+ * and the first uses of the loaded features: looking up a factory, reading
+ * the metadata of all element factories and the caps of all typefinders. */
+
 #include <gst/gst.h>
 
 gint
 main (gint argc, gchar * argv[])
 {
+  GstClockTime start, end;
+  GstElementFactory *factory;
+  GList *features, *walk;
+  guint n;
+
+  start = gst_util_get_timestamp ();
   gst_init (&argc, &argv);
+  end = gst_util_get_timestamp ();
+  g_print ("gst_init:          %" GST_TIME_FORMAT "\n",
+      GST_TIME_ARGS (end - start));
+
+  start = gst_util_get_timestamp ();
+  factory = gst_element_factory_find ("fakesink");
+  end = gst_util_get_timestamp ();
+  g_print ("first lookup:      %" GST_TIME_FORMAT "\n",
+      GST_TIME_ARGS (end - start));
+  if (factory)
+    gst_object_unref (factory);
+
+  start = gst_util_get_timestamp ();
+  features = gst_element_factory_list_get_elements
+      (GST_ELEMENT_FACTORY_TYPE_ANY, GST_RANK_NONE);
+  for (walk = features, n = 0; walk; walk = walk->next, n++)
+    gst_element_factory_get_metadata (walk->data, GST_ELEMENT_METADATA_KLASS);
+  end = gst_util_get_timestamp ();
+  g_print ("%4u element metadata: %" GST_TIME_FORMAT "\n", n,
+      GST_TIME_ARGS (end - start));
+  gst_plugin_feature_list_free (features);
+
+  start = gst_util_get_timestamp ();
+  features = gst_type_find_factory_get_list ();
+  for (walk = features, n = 0; walk; walk = walk->next, n++)
+    gst_type_find_factory_get_caps (walk->data);
+  end = gst_util_get_timestamp ();
+  g_print ("%4u typefind caps:     %" GST_TIME_FORMAT "\n", n,
+      GST_TIME_ARGS (end - start));
+  gst_plugin_feature_list_free (features);
 
   return 0;
 }
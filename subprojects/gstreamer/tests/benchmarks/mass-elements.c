@@ -25,6 +25,11 @@
 #define SRC_ELEMENT "fakesrc"
 #define SINK_ELEMENT "fakesink"
 
+static GstPadProbeReturn
+pass_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  return GST_PAD_PROBE_OK;
+}
 
 gint
 main (gint argc, gchar * argv[])
@@ -34,6 +39,7 @@ main (gint argc, gchar * argv[])
   guint i, buffers = BUFFER_COUNT, identities = IDENTITY_COUNT;
   GstClockTime start, end;
   const gchar *src_name = SRC_ELEMENT, *sink_name = SINK_ELEMENT;
+  gboolean probes = FALSE;
 
   gst_init (&argc, &argv);
 
@@ -45,10 +51,14 @@ main (gint argc, gchar * argv[])
     src_name = argv[3];
   if (argc > 4)
     sink_name = argv[4];
+  /* a probe on every pad makes the pushes take the pad locks and check the
+   * probes, to compare against the direct path without probes */
+  if (argc > 5)
+    probes = g_str_equal (argv[5], "probes");
 
   g_print
-      ("*** benchmarking this pipeline: %s num-buffers=%u ! %u * identity ! %s\n",
-      src_name, buffers, identities, sink_name);
+      ("*** benchmarking this pipeline: %s num-buffers=%u ! %u * identity ! %s%s\n",
+      src_name, buffers, identities, sink_name, probes ? " (with probes)" : "");
   start = gst_util_get_timestamp ();
   pipeline = gst_element_factory_make ("pipeline", NULL);
   g_assert (pipeline);
@@ -70,6 +80,13 @@ main (gint argc, gchar * argv[])
     g_assert (current);
     /* shut this element up (no g_strdup_printf please) */
     g_object_set (current, "silent", TRUE, NULL);
+    if (probes) {
+      GstPad *pad = gst_element_get_static_pad (current, "src");
+
+      gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, pass_probe, NULL,
+          NULL);
+      gst_object_unref (pad);
+    }
     gst_bin_add (GST_BIN (pipeline), current);
     if (!gst_element_link (last, current))
       g_assert_not_reached ();
@@ -99,6 +116,8 @@ main (gint argc, gchar * argv[])
   gst_message_unref (msg);
   g_print ("%" GST_TIME_FORMAT " - putting %u buffers through\n",
       GST_TIME_ARGS (end - start), buffers);
+  g_print ("%.1f ns per buffer and element\n",
+      (gdouble) (end - start) / buffers / (identities + 1));
 
   start = gst_util_get_timestamp ();
   if (gst_element_set_state (pipeline,
@@ -0,0 +1,245 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Measures the time it takes an item to go from one thread to another
+ * through a GstDataQueue and through a queue element, with and without
+ * spinning before blocking. The producer waits a little between items so
+ * that the consumer is usually waiting for the next one. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <gst/gst.h>
+#include <gst/base/gstdataqueue.h>
+
+static const guint spin_times[] = { 0, 10, 50, 200 };
+
+static guint num_items = 100000;
+static guint delay_us = 5;
+
+static void
+busy_wait (guint us)
+{
+  gint64 end = g_get_monotonic_time () + us;
+
+  while (g_get_monotonic_time () < end);
+}
+
+static gint
+compare_latency (gconstpointer a, gconstpointer b)
+{
+  GstClockTime la = *(const GstClockTime *) a;
+  GstClockTime lb = *(const GstClockTime *) b;
+
+  return la < lb ? -1 : la > lb ? 1 : 0;
+}
+
+static void
+print_percentiles (const gchar * name, guint spin_time,
+    GstClockTime * latencies, guint n)
+{
+  static const gdouble percentiles[] = { 50.0, 90.0, 99.0, 99.9 };
+  guint i;
+
+  g_assert (n > 0);
+  qsort (latencies, n, sizeof (GstClockTime), compare_latency);
+
+  g_print ("%-9s spin %3u us:", name, spin_time);
+  for (i = 0; i < G_N_ELEMENTS (percentiles); i++) {
+    guint idx = MIN (n - 1, (guint) (n * percentiles[i] / 100.0));
+
+    g_print (" p%g %6" G_GUINT64_FORMAT " ns", percentiles[i], latencies[idx]);
+  }
+  g_print ("\n");
+}
+
+/* GstDataQueue */
+
+static gboolean
+never_full (GstDataQueue * queue, guint visible, guint bytes, guint64 time,
+    gpointer checkdata)
+{
+  return FALSE;
+}
+
+static void
+item_destroy (GstDataQueueItem * item)
+{
+  gst_mini_object_unref (item->object);
+  g_free (item);
+}
+
+static gpointer
+data_queue_producer (gpointer data)
+{
+  GstDataQueue *queue = data;
+  guint i;
+
+  for (i = 0; i < num_items; i++) {
+    GstDataQueueItem *item = g_new0 (GstDataQueueItem, 1);
+    GstBuffer *buf = gst_buffer_new ();
+
+    busy_wait (delay_us);
+
+    GST_BUFFER_OFFSET (buf) = gst_util_get_timestamp ();
+    item->object = GST_MINI_OBJECT_CAST (buf);
+    item->visible = TRUE;
+    item->destroy = (GDestroyNotify) item_destroy;
+    if (!gst_data_queue_push (queue, item))
+      g_error ("could not push item %u", i);
+  }
+
+  return NULL;
+}
+
+static void
+run_data_queue (guint spin_time, GstClockTime * latencies)
+{
+  GstDataQueue *queue;
+  GstDataQueueItem *item;
+  GThread *thread;
+  guint i;
+
+  queue = gst_data_queue_new (never_full, NULL, NULL, NULL);
+  gst_data_queue_set_spin_time (queue, spin_time);
+
+  thread = g_thread_new ("producer", data_queue_producer, queue);
+  for (i = 0; i < num_items; i++) {
+    if (!gst_data_queue_pop (queue, &item))
+      g_error ("could not pop item %u", i);
+    latencies[i] = gst_util_get_timestamp () -
+        GST_BUFFER_OFFSET (GST_BUFFER_CAST (item->object));
+    item->destroy (item);
+  }
+  g_thread_join (thread);
+  g_object_unref (queue);
+
+  print_percentiles ("dataqueue", spin_time, latencies, num_items);
+}
+
+/* queue element */
+
+typedef struct
+{
+  GstClockTime *latencies;
+  guint n;
+} QueueLatency;
+
+static GstPadProbeReturn
+stamp_buffer (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  GstBuffer *buf = GST_PAD_PROBE_INFO_BUFFER (info);
+
+  busy_wait (delay_us);
+
+  buf = gst_buffer_make_writable (buf);
+  GST_BUFFER_OFFSET (buf) = gst_util_get_timestamp ();
+  GST_PAD_PROBE_INFO_DATA (info) = buf;
+
+  return GST_PAD_PROBE_OK;
+}
+
+static GstPadProbeReturn
+measure_buffer (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  QueueLatency *ql = user_data;
+  GstBuffer *buf = GST_PAD_PROBE_INFO_BUFFER (info);
+
+  if (ql->n < num_items)
+    ql->latencies[ql->n++] = gst_util_get_timestamp () -
+        GST_BUFFER_OFFSET (buf);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static void
+run_queue (guint spin_time, GstClockTime * latencies)
+{
+  GstElement *pipeline, *src, *queue, *sink;
+  QueueLatency ql = { latencies, 0 };
+  GstMessage *msg;
+  GstPad *pad;
+
+  pipeline = gst_pipeline_new (NULL);
+  src = gst_element_factory_make ("fakesrc", NULL);
+  g_object_set (src, "num-buffers", num_items, NULL);
+  queue = gst_element_factory_make ("queue", NULL);
+  g_object_set (queue, "spin-time", spin_time, "max-size-buffers", 0,
+      "max-size-bytes", 0, "max-size-time", G_GUINT64_CONSTANT (0), NULL);
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (sink, "sync", FALSE, NULL);
+
+  gst_bin_add_many (GST_BIN (pipeline), src, queue, sink, NULL);
+  if (!gst_element_link_many (src, queue, sink, NULL))
+    g_error ("could not link elements");
+
+  pad = gst_element_get_static_pad (queue, "sink");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, stamp_buffer, NULL,
+      NULL);
+  gst_object_unref (pad);
+  pad = gst_element_get_static_pad (queue, "src");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, measure_buffer, &ql,
+      NULL);
+  gst_object_unref (pad);
+
+  if (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE)
+    g_error ("could not go to PLAYING");
+
+  msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipeline),
+      GST_CLOCK_TIME_NONE, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR)
+    g_error ("error while running the pipeline");
+  gst_message_unref (msg);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  print_percentiles ("queue", spin_time, latencies, ql.n);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  GstClockTime *latencies;
+  guint i;
+
+  gst_init (&argc, &argv);
+
+  if (argc > 1)
+    num_items = atoi (argv[1]);
+  if (argc > 2)
+    delay_us = atoi (argv[2]);
+
+  if (num_items == 0) {
+    g_print ("usage: %s [items] [delay between items in us]\n", argv[0]);
+    exit (-1);
+  }
+
+  g_print ("%u items, %u us between items\n", num_items, delay_us);
+
+  latencies = g_new (GstClockTime, num_items);
+
+  for (i = 0; i < G_N_ELEMENTS (spin_times); i++)
+    run_data_queue (spin_times[i], latencies);
+  for (i = 0; i < G_N_ELEMENTS (spin_times); i++)
+    run_queue (spin_times[i], latencies);
+
+  g_free (latencies);
+
+  return 0;
+}
@@ -219,7 +219,8 @@ create_temporary_file (void)
 
 /* TODO: we don't check that the data is actually written to the right
  * position after a seek */
-GST_START_TEST (test_seeking)
+static void
+test_seeking_with_async (gboolean async)
 {
   GstElement *filesink;
   gchar *tmp_fn;
@@ -233,7 +234,7 @@ GST_START_TEST (test_seeking)
   sync_buffers = TRUE;
 
   GST_LOG ("using temp file '%s'", tmp_fn);
-  g_object_set (filesink, "location", tmp_fn, NULL);
+  g_object_set (filesink, "location", tmp_fn, "async", async, NULL);
 
   fail_unless_equals_int (gst_element_set_state (filesink, GST_STATE_PLAYING),
       GST_STATE_CHANGE_ASYNC);
@@ -328,9 +329,24 @@ GST_START_TEST (test_seeking)
   g_free (tmp_fn);
 }
 
+GST_START_TEST (test_seeking)
+{
+  test_seeking_with_async (FALSE);
+}
+
 GST_END_TEST;
 
-GST_START_TEST (test_flush)
+/* the buffers are flagged with SYNC_AFTER, so they are on disk once pushed
+ * even when written by the writer thread */
+GST_START_TEST (test_seeking_async)
+{
+  test_seeking_with_async (TRUE);
+}
+
+GST_END_TEST;
+
+static void
+test_flush_with_async (gboolean async)
 {
   GstElement *filesink;
   gchar *tmp_fn;
@@ -344,7 +360,7 @@ GST_START_TEST (test_flush)
   sync_buffers = FALSE;
 
   GST_LOG ("using temp file '%s'", tmp_fn);
-  g_object_set (filesink, "location", tmp_fn, NULL);
+  g_object_set (filesink, "location", tmp_fn, "async", async, NULL);
 
   fail_unless_equals_int (gst_element_set_state (filesink, GST_STATE_PLAYING),
       GST_STATE_CHANGE_ASYNC);
@@ -380,6 +396,113 @@ GST_START_TEST (test_flush)
   g_free (tmp_fn);
 }
 
+GST_START_TEST (test_flush)
+{
+  test_flush_with_async (FALSE);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_flush_async)
+{
+  test_flush_with_async (TRUE);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_async)
+{
+  GstElement *filesink;
+  GstStructure *stats;
+  gchar *tmp_fn;
+  GstSegment segment;
+  guint64 writes, peak;
+
+  tmp_fn = create_temporary_file ();
+  if (tmp_fn == NULL)
+    return;
+  filesink = setup_filesink ();
+
+  sync_buffers = FALSE;
+
+  g_object_set (filesink, "location", tmp_fn, "async", TRUE,
+      "max-pending-bytes", G_GUINT64_CONSTANT (1000), NULL);
+  gst_util_set_object_arg (G_OBJECT (filesink), "fsync-policy", "eos");
+
+  fail_unless_equals_int (gst_element_set_state (filesink, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+
+  fail_unless (gst_pad_push_event (mysrcpad,
+          gst_event_new_stream_start ("test")));
+
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  /* more than max-pending-bytes still passes */
+  PUSH_BYTES (8800);
+  PUSH_BYTES (1);
+  PUSH_BYTES (99);
+  CHECK_QUERY_POSITION (filesink, GST_FORMAT_BYTES, 8900);
+
+  /* everything is written on EOS */
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+  CHECK_QUERY_POSITION (filesink, GST_FORMAT_BYTES, 8900);
+
+  g_object_get (filesink, "stats", &stats, NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "writes", &writes));
+  fail_unless_equals_int (writes, 3);
+  fail_unless (gst_structure_get_uint64 (stats, "peak-pending-bytes", &peak));
+  fail_unless (peak >= 8800);
+  gst_structure_free (stats);
+
+  cleanup_filesink (filesink);
+
+  CHECK_WRITTEN_BYTES (8801, 99, 8900);
+
+  g_remove (tmp_fn);
+  g_free (tmp_fn);
+}
+
+GST_END_TEST;
+
+/* errors of the writer thread fail the following buffers and events */
+GST_START_TEST (test_async_write_error)
+{
+  GstElement *filesink;
+  GstSegment segment;
+  GstFlowReturn flow;
+
+  if (!g_file_test ("/dev/full", G_FILE_TEST_EXISTS))
+    return;
+
+  filesink = setup_filesink ();
+
+  g_object_set (filesink, "location", "/dev/full", "async", TRUE, NULL);
+  gst_util_set_object_arg (G_OBJECT (filesink), "buffer-mode", "unbuffered");
+
+  fail_unless_equals_int (gst_element_set_state (filesink, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+
+  fail_unless (gst_pad_push_event (mysrcpad,
+          gst_event_new_stream_start ("test")));
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  /* only queued, unless the writer thread already failed */
+  flow = gst_pad_push (mysrcpad, gst_buffer_new_and_alloc (100));
+  fail_unless (flow == GST_FLOW_OK || flow == GST_FLOW_ERROR);
+
+  fail_if (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+  fail_unless_equals_int (gst_pad_push (mysrcpad,
+          gst_buffer_new_and_alloc (100)), GST_FLOW_ERROR);
+
+  fail_unless_equals_int (gst_element_set_state (filesink, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+
+  cleanup_filesink (filesink);
+}
+
 GST_END_TEST;
 
 GST_START_TEST (test_coverage)
@@ -576,7 +699,11 @@ filesink_suite (void)
   tcase_add_test (tc_chain, test_coverage);
   tcase_add_test (tc_chain, test_uri_interface);
   tcase_add_test (tc_chain, test_seeking);
+  tcase_add_test (tc_chain, test_seeking_async);
   tcase_add_test (tc_chain, test_flush);
+  tcase_add_test (tc_chain, test_flush_async);
+  tcase_add_test (tc_chain, test_async);
+  tcase_add_test (tc_chain, test_async_write_error);
   tcase_add_test (tc_chain, test_buffered_write_17_1);
   tcase_add_test (tc_chain, test_buffered_write_9_2);
   tcase_add_test (tc_chain, test_buffered_write_6_3);
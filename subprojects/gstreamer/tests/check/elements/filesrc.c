@@ -303,6 +303,92 @@ GST_START_TEST (test_pull)
 
 GST_END_TEST;
 
+GST_START_TEST (test_pull_mmap)
+{
+  GstElement *src;
+  GstPad *pad;
+  GstBuffer *buffer;
+  GstMapInfo info;
+  gchar *contents;
+  gsize length;
+
+  fail_unless (g_file_get_contents (TESTFILE, &contents, &length, NULL));
+  fail_unless (length > 200);
+
+  src = setup_filesrc ();
+
+  g_object_set (G_OBJECT (src), "location", TESTFILE, "use-mmap", TRUE, NULL);
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_READY) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to ready");
+
+  pad = gst_element_get_static_pad (src, "src");
+  fail_unless (gst_pad_activate_mode (pad, GST_PAD_MODE_PULL, TRUE));
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  buffer = NULL;
+  fail_unless_equals_int (gst_pad_get_range (pad, 100, 100, &buffer),
+      GST_FLOW_OK);
+  fail_unless_equals_int (gst_buffer_get_size (buffer), 100);
+  fail_unless_equals_int (GST_BUFFER_OFFSET (buffer), 100);
+  fail_unless (gst_buffer_map (buffer, &info, GST_MAP_READ));
+  fail_unless (memcmp (info.data, contents + 100, 100) == 0);
+  gst_buffer_unmap (buffer, &info);
+
+  /* writing gives a copy, the file is not touched */
+  fail_unless (gst_buffer_map (buffer, &info, GST_MAP_WRITE));
+  memset (info.data, 0, info.size);
+  gst_buffer_unmap (buffer, &info);
+  gst_buffer_unref (buffer);
+
+  /* the end of the file is cut off */
+  buffer = NULL;
+  fail_unless_equals_int (gst_pad_get_range (pad, length - 10, 20, &buffer),
+      GST_FLOW_OK);
+  fail_unless_equals_int (gst_buffer_get_size (buffer), 10);
+  gst_buffer_unref (buffer);
+
+  buffer = NULL;
+  fail_unless_equals_int (gst_pad_get_range (pad, 100, 100, &buffer),
+      GST_FLOW_OK);
+  fail_unless (gst_buffer_map (buffer, &info, GST_MAP_READ));
+  fail_unless (memcmp (info.data, contents + 100, 100) == 0);
+  gst_buffer_unmap (buffer, &info);
+  gst_buffer_unref (buffer);
+
+  /* a buffer provided by downstream is read into, right after the data
+   * that came from the mapping */
+  buffer = gst_buffer_new_and_alloc (50);
+  fail_unless_equals_int (gst_pad_get_range (pad, 200, 50, &buffer),
+      GST_FLOW_OK);
+  fail_unless_equals_int (GST_BUFFER_OFFSET (buffer), 200);
+  fail_unless (gst_buffer_map (buffer, &info, GST_MAP_READ));
+  fail_unless_equals_int (info.size, 50);
+  fail_unless (memcmp (info.data, contents + 200, 50) == 0);
+  gst_buffer_unmap (buffer, &info);
+  gst_buffer_unref (buffer);
+
+  buffer = NULL;
+  fail_unless_equals_int (gst_pad_get_range (pad, 100, 100, &buffer),
+      GST_FLOW_OK);
+
+  /* the mapping stays valid after the element is stopped */
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+  fail_unless (gst_buffer_map (buffer, &info, GST_MAP_READ));
+  fail_unless (memcmp (info.data, contents + 100, 100) == 0);
+  gst_buffer_unmap (buffer, &info);
+  gst_buffer_unref (buffer);
+
+  gst_object_unref (pad);
+  cleanup_filesrc (src);
+  g_free (contents);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_coverage)
 {
   GstElement *src;
@@ -554,6 +640,7 @@ filesrc_suite (void)
   tcase_add_test (tc_chain, test_seeking);
   tcase_add_test (tc_chain, test_reverse);
   tcase_add_test (tc_chain, test_pull);
+  tcase_add_test (tc_chain, test_pull_mmap);
   tcase_add_test (tc_chain, test_coverage);
   tcase_add_test (tc_chain, test_uri_interface);
   tcase_add_test (tc_chain, test_uri_query);
@@ -1181,6 +1181,86 @@ GST_START_TEST (test_initial_events_nodelay)
 
 GST_END_TEST;
 
+GST_START_TEST (test_spin_time)
+{
+  GstSegment segment;
+  gint i;
+
+  mysinkpad = gst_check_setup_sink_pad (queue, &sinktemplate);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  /* a small queue so that both sides have to wait for each other */
+  g_object_set (G_OBJECT (queue), "spin-time", 50, "max-size-buffers", 2,
+      NULL);
+
+  fail_unless (gst_element_set_state (queue,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  gst_pad_push_event (mysrcpad, gst_event_new_stream_start ("test"));
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment));
+
+  for (i = 0; i < 100; i++)
+    fail_unless_equals_int (gst_pad_push (mysrcpad,
+            gst_buffer_new_and_alloc (4)), GST_FLOW_OK);
+
+  g_mutex_lock (&check_mutex);
+  while (g_list_length (buffers) < 100)
+    g_cond_wait (&check_cond, &check_mutex);
+  g_mutex_unlock (&check_mutex);
+
+  /* the streaming thread must not miss the flush while spinning */
+  fail_unless (gst_element_set_state (queue,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+}
+
+GST_END_TEST;
+
+/* Both threads wait for each other on every buffer with a queue of one
+ * buffer. A wakeup that is lost while a thread goes from spinning to
+ * waiting on the cond makes this hang before the EOS arrives. */
+GST_START_TEST (test_spin_time_one_buffer)
+{
+  GstSegment segment;
+  gint i;
+
+  mysinkpad = gst_check_setup_sink_pad (queue, &sinktemplate);
+  gst_pad_set_event_function (mysinkpad, event_func);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  /* short enough that spinning often gives up just before the other thread
+   * changes the queue */
+  g_object_set (G_OBJECT (queue), "spin-time", 1, "max-size-buffers", 1,
+      "max-size-bytes", 0, "max-size-time", G_GUINT64_CONSTANT (0), NULL);
+
+  fail_unless (gst_element_set_state (queue,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  gst_pad_push_event (mysrcpad, gst_event_new_stream_start ("test"));
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment));
+
+  for (i = 0; i < 10000; i++)
+    fail_unless_equals_int (gst_pad_push (mysrcpad,
+            gst_buffer_new_and_alloc (4)), GST_FLOW_OK);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  g_mutex_lock (&events_lock);
+  while (events == NULL
+      || GST_EVENT_TYPE (g_list_last (events)->data) != GST_EVENT_EOS)
+    g_cond_wait (&events_cond, &events_lock);
+  g_mutex_unlock (&events_lock);
+
+  fail_unless_equals_int (g_list_length (buffers), 10000);
+
+  fail_unless (gst_element_set_state (queue,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+}
+
+GST_END_TEST;
+
 static Suite *
 queue_suite (void)
 {
@@ -1204,6 +1284,8 @@ queue_suite (void)
   tcase_add_test (tc_chain, test_sticky_not_linked);
   tcase_add_test (tc_chain, test_time_level_buffer_list);
   tcase_add_test (tc_chain, test_initial_events_nodelay);
+  tcase_add_test (tc_chain, test_spin_time);
+  tcase_add_test (tc_chain, test_spin_time_one_buffer);
 
   return s;
 }
@@ -449,6 +449,135 @@ GST_START_TEST (test_filled_read)
 GST_END_TEST;
 
 
+#if defined (HAVE_MMAP) && defined (HAVE_POSIX_FALLOCATE)
+static GstBuffer *
+create_filled_buffer (gsize size, guint8 val)
+{
+  GstBuffer *buffer;
+
+  buffer = gst_buffer_new_and_alloc (size);
+  gst_buffer_memset (buffer, 0, val, size);
+
+  return buffer;
+}
+
+static void
+check_filled_buffer (GstBuffer * buffer, gsize size, guint8 val)
+{
+  GstMapInfo map;
+  gsize i;
+
+  fail_unless_equals_int (gst_buffer_get_size (buffer), size);
+  fail_unless (gst_buffer_map (buffer, &map, GST_MAP_READ));
+  for (i = 0; i < size; i++)
+    fail_unless_equals_int (map.data[i], val);
+  gst_buffer_unmap (buffer, &map);
+}
+
+typedef struct
+{
+  GstPad *sinkpad;
+  gint pushed;
+} PushData;
+
+static gpointer
+push_filled_buffer (PushData * data)
+{
+  GstFlowReturn ret;
+
+  ret = gst_pad_chain (data->sinkpad, create_filled_buffer (2 * 1024, 3));
+  g_atomic_int_set (&data->pushed, TRUE);
+
+  return GINT_TO_POINTER (ret);
+}
+
+GST_START_TEST (test_mmap_ring_views)
+{
+  GstElement *queue2;
+  GstBuffer *view1 = NULL, *view2 = NULL, *buffer = NULL;
+  GstPad *sinkpad, *srcpad;
+  GThread *thread;
+  GstSegment segment;
+  PushData push_data;
+  gchar *template;
+
+  queue2 = gst_element_factory_make ("queue2", NULL);
+  sinkpad = gst_element_get_static_pad (queue2, "sink");
+  srcpad = gst_element_get_static_pad (queue2, "src");
+
+  template = g_build_filename (g_get_tmp_dir (), "queue2-test-XXXXXX", NULL);
+  g_object_set (queue2, "ring-buffer-max-size", (guint64) 8 * 1024,
+      "temp-template", template, "use-mmap", TRUE, "use-buffering", FALSE,
+      "max-size-buffers", (guint) 0, "max-size-time", (guint64) 0,
+      "max-size-bytes", (guint) 8 * 1024, NULL);
+  g_free (template);
+
+  gst_pad_activate_mode (srcpad, GST_PAD_MODE_PULL, TRUE);
+  gst_element_set_state (queue2, GST_STATE_PLAYING);
+
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  gst_pad_send_event (sinkpad, gst_event_new_stream_start ("test"));
+  gst_pad_send_event (sinkpad, gst_event_new_segment (&segment));
+
+  fail_unless (gst_pad_chain (sinkpad,
+          create_filled_buffer (4 * 1024, 1)) == GST_FLOW_OK);
+
+  /* reads are handed out as read-only views into the ring */
+  fail_unless (gst_pad_get_range (srcpad, 0, 2 * 1024,
+          &view1) == GST_FLOW_OK);
+  fail_unless_equals_int (gst_buffer_n_memory (view1), 1);
+  fail_unless (GST_MEMORY_IS_READONLY (gst_buffer_peek_memory (view1, 0)));
+  check_filled_buffer (view1, 2 * 1024, 1);
+
+  fail_unless (gst_pad_get_range (srcpad, 2 * 1024, 2 * 1024,
+          &view2) == GST_FLOW_OK);
+  fail_unless (GST_MEMORY_IS_READONLY (gst_buffer_peek_memory (view2, 0)));
+  check_filled_buffer (view2, 2 * 1024, 1);
+
+  /* fill the rest of the ring, the next write wraps around onto the data
+   * of the first view */
+  fail_unless (gst_pad_chain (sinkpad,
+          create_filled_buffer (4 * 1024, 2)) == GST_FLOW_OK);
+
+  /* half of the ring is referenced now, further reads are copied */
+  fail_unless (gst_pad_get_range (srcpad, 4 * 1024, 2 * 1024,
+          &buffer) == GST_FLOW_OK);
+  fail_if (GST_MEMORY_IS_READONLY (gst_buffer_peek_memory (buffer, 0)));
+  check_filled_buffer (buffer, 2 * 1024, 2);
+  gst_buffer_unref (buffer);
+  gst_buffer_unref (view2);
+
+  push_data.sinkpad = sinkpad;
+  push_data.pushed = FALSE;
+  thread = g_thread_try_new ("gst-check", (GThreadFunc) push_filled_buffer,
+      &push_data, NULL);
+  fail_unless (thread != NULL);
+
+  /* the writer must wait until the view is released and is woken up by the
+   * release */
+  g_usleep (G_USEC_PER_SEC / 10);
+  fail_if (g_atomic_int_get (&push_data.pushed));
+  check_filled_buffer (view1, 2 * 1024, 1);
+  gst_buffer_unref (view1);
+
+  fail_unless_equals_int (GPOINTER_TO_INT (g_thread_join (thread)),
+      GST_FLOW_OK);
+
+  fail_unless (gst_pad_get_range (srcpad, 8 * 1024, 2 * 1024,
+          &buffer) == GST_FLOW_OK);
+  check_filled_buffer (buffer, 2 * 1024, 3);
+  gst_buffer_unref (buffer);
+
+  gst_element_set_state (queue2, GST_STATE_NULL);
+
+  gst_object_unref (sinkpad);
+  gst_object_unref (srcpad);
+  gst_object_unref (queue2);
+}
+
+GST_END_TEST;
+#endif
+
 static GstPadProbeReturn
 block_callback (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
 {
@@ -729,6 +858,9 @@ queue2_suite (void)
   tcase_add_test (tc_chain, test_simple_shutdown_while_running_ringbuffer);
   tcase_add_test (tc_chain, test_watermark_and_fill_level);
   tcase_add_test (tc_chain, test_filled_read);
+#if defined (HAVE_MMAP) && defined (HAVE_POSIX_FALLOCATE)
+  tcase_add_test (tc_chain, test_mmap_ring_views);
+#endif
   tcase_add_test (tc_chain, test_percent_overflow);
   tcase_add_test (tc_chain, test_small_ring_buffer);
   tcase_add_test (tc_chain, test_bitrate_query);
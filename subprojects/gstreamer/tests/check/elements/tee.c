@@ -595,6 +595,123 @@ GST_START_TEST (test_flow_aggregation)
 
 GST_END_TEST;
 
+static GMutex slow_lock;
+static GCond slow_cond;
+static gboolean slow_blocked;
+static guint slow_count, fast_count;
+
+static GstFlowReturn
+_slow_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  g_mutex_lock (&slow_lock);
+  slow_count++;
+  g_cond_broadcast (&slow_cond);
+  while (slow_blocked)
+    g_cond_wait (&slow_cond, &slow_lock);
+  g_mutex_unlock (&slow_lock);
+
+  gst_buffer_unref (buffer);
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+_counting_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  g_atomic_int_inc (&fast_count);
+  gst_buffer_unref (buffer);
+  return GST_FLOW_OK;
+}
+
+GST_START_TEST (test_parallel_leaky)
+{
+  GstPad *mysrc, *mysink1, *mysink2;
+  GstPad *teesink, *teesrc1, *teesrc2;
+  GstElement *tee;
+  GstSegment segment;
+  guint64 pushed, dropped;
+  gint i;
+
+  slow_blocked = TRUE;
+  slow_count = fast_count = 0;
+
+  tee = gst_element_factory_make ("tee", NULL);
+  fail_unless (tee != NULL);
+  g_object_set (tee, "parallel", TRUE, NULL);
+  teesink = gst_element_get_static_pad (tee, "sink");
+  teesrc1 = gst_element_request_pad_simple (tee, "src_%u");
+  teesrc2 = gst_element_request_pad_simple (tee, "src_%u");
+  g_object_set (teesrc2, "leaky", TRUE, NULL);
+
+  mysink1 = gst_pad_new ("mysink1", GST_PAD_SINK);
+  gst_pad_set_chain_function (mysink1, _counting_chain);
+  gst_pad_set_active (mysink1, TRUE);
+
+  mysink2 = gst_pad_new ("mysink2", GST_PAD_SINK);
+  gst_pad_set_chain_function (mysink2, _slow_chain);
+  gst_pad_set_active (mysink2, TRUE);
+
+  mysrc = gst_pad_new ("mysrc", GST_PAD_SRC);
+  gst_pad_set_active (mysrc, TRUE);
+
+  fail_unless (gst_pad_link (mysrc, teesink) == GST_PAD_LINK_OK);
+  fail_unless (gst_pad_link (teesrc1, mysink1) == GST_PAD_LINK_OK);
+  fail_unless (gst_pad_link (teesrc2, mysink2) == GST_PAD_LINK_OK);
+
+  fail_unless (gst_element_set_state (tee,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS);
+
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  gst_pad_push_event (mysrc, gst_event_new_stream_start ("test"));
+  gst_pad_push_event (mysrc, gst_event_new_segment (&segment));
+
+  /* the leaky branch blocks on the first buffer, the others are dropped for
+   * it without holding back the other branch */
+  fail_unless_equals_int (gst_pad_push (mysrc, gst_buffer_new ()),
+      GST_FLOW_OK);
+  g_mutex_lock (&slow_lock);
+  while (slow_count == 0)
+    g_cond_wait (&slow_cond, &slow_lock);
+  g_mutex_unlock (&slow_lock);
+
+  for (i = 0; i < 4; i++)
+    fail_unless_equals_int (gst_pad_push (mysrc, gst_buffer_new ()),
+        GST_FLOW_OK);
+  fail_unless_equals_int (g_atomic_int_get (&fast_count), 5);
+
+  g_object_get (teesrc2, "dropped", &dropped, NULL);
+  fail_unless_equals_uint64 (dropped, 4);
+
+  /* let the slow branch go, the EOS waits for it */
+  g_mutex_lock (&slow_lock);
+  slow_blocked = FALSE;
+  g_cond_broadcast (&slow_cond);
+  g_mutex_unlock (&slow_lock);
+  gst_pad_push_event (mysrc, gst_event_new_eos ());
+  fail_unless_equals_int (slow_count, 1);
+
+  g_object_get (teesrc1, "pushed", &pushed, "dropped", &dropped, NULL);
+  fail_unless_equals_uint64 (pushed, 5);
+  fail_unless_equals_uint64 (dropped, 0);
+  g_object_get (teesrc2, "pushed", &pushed, NULL);
+  fail_unless_equals_uint64 (pushed, 1);
+
+  fail_unless (gst_element_set_state (tee,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS);
+
+  gst_object_unref (teesink);
+  gst_element_release_request_pad (tee, teesrc1);
+  gst_element_release_request_pad (tee, teesrc2);
+  gst_object_unref (teesrc1);
+  gst_object_unref (teesrc2);
+  gst_object_unref (tee);
+
+  gst_object_unref (mysink1);
+  gst_object_unref (mysink2);
+  gst_object_unref (mysrc);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_request_pads)
 {
   GstElement *tee;
@@ -956,6 +1073,7 @@ tee_suite (void)
   tcase_add_test (tc_chain, test_release_while_second_buffer_alloc);
   tcase_add_test (tc_chain, test_internal_links);
   tcase_add_test (tc_chain, test_flow_aggregation);
+  tcase_add_test (tc_chain, test_parallel_leaky);
   tcase_add_test (tc_chain, test_request_pads);
   tcase_add_test (tc_chain, test_allow_not_linked);
   tcase_add_test (tc_chain, test_allocation_query_aggregation);
@@ -1251,6 +1251,68 @@ GST_START_TEST (test_children_state_change_order_two_sink)
 
 GST_END_TEST;
 
+/* with state change threads, the sinks of all branches change state before
+ * the elements providing data to them */
+GST_START_TEST (test_children_state_change_order_threads)
+{
+  GstElement *pipeline, *elements[3][3];
+  GstMessage *msg;
+  GstBus *bus;
+  GList *order = NULL;
+  gint i, j, pos[3][3];
+  const gchar *factories[] = { "fakesink", "identity", "fakesrc" };
+
+  pipeline = gst_pipeline_new (NULL);
+  g_object_set (pipeline, "state-change-threads", 4, NULL);
+  bus = gst_element_get_bus (pipeline);
+
+  for (i = 0; i < 3; i++) {
+    for (j = 0; j < 3; j++) {
+      elements[i][j] = gst_element_factory_make (factories[j], NULL);
+      fail_if (elements[i][j] == NULL, "Could not create %s", factories[j]);
+      gst_bin_add (GST_BIN (pipeline), elements[i][j]);
+    }
+    fail_unless (gst_element_link_many (elements[i][2], elements[i][1],
+            elements[i][0], NULL));
+  }
+
+  fail_unless_equals_int (gst_element_set_state (pipeline, GST_STATE_READY),
+      GST_STATE_CHANGE_SUCCESS);
+
+  while ((msg = gst_bus_pop_filtered (bus, GST_MESSAGE_STATE_CHANGED))) {
+    if (GST_MESSAGE_SRC (msg) != GST_OBJECT (pipeline))
+      order = g_list_append (order, GST_MESSAGE_SRC (msg));
+    gst_message_unref (msg);
+  }
+  fail_unless_equals_int (g_list_length (order), 9);
+
+  for (i = 0; i < 3; i++)
+    for (j = 0; j < 3; j++)
+      pos[i][j] = g_list_index (order, elements[i][j]);
+
+  /* every element of a level before every element of the next one */
+  for (i = 0; i < 3; i++) {
+    for (j = 0; j < 3; j++) {
+      fail_unless (pos[i][0] < pos[j][1]);
+      fail_unless (pos[i][1] < pos[j][2]);
+    }
+  }
+  g_list_free (order);
+
+  fail_unless_equals_int (gst_element_set_state (pipeline, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+  fail_unless_equals_int (gst_element_get_state (pipeline, NULL, NULL,
+          GST_CLOCK_TIME_NONE), GST_STATE_CHANGE_SUCCESS);
+
+  fail_unless_equals_int (gst_element_set_state (pipeline, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+
+  gst_object_unref (bus);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_iterate_sorted)
 {
   GstElement *src, *tee, *identity, *sink1, *sink2, *pipeline, *bin;
@@ -2005,6 +2067,7 @@ gst_bin_suite (void)
   tcase_add_test (tc_chain, test_children_state_change_order_flagged_sink);
   tcase_add_test (tc_chain, test_children_state_change_order_semi_sink);
   tcase_add_test (tc_chain, test_children_state_change_order_two_sink);
+  tcase_add_test (tc_chain, test_children_state_change_order_threads);
   tcase_add_test (tc_chain, test_message_state_changed);
   tcase_add_test (tc_chain, test_message_state_changed_child);
   tcase_add_test (tc_chain, test_message_state_changed_children);
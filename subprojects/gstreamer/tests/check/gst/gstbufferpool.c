@@ -336,6 +336,50 @@ GST_START_TEST (test_no_deadlock_for_buffer_discard)
 
 GST_END_TEST;
 
+static gpointer
+unref_buf_delayed (gpointer p)
+{
+  g_usleep (G_USEC_PER_SEC / 100);
+  gst_buffer_unref (GST_BUFFER (p));
+  return NULL;
+}
+
+GST_START_TEST (test_buffer_released_in_other_thread)
+{
+  GstBufferPool *pool = create_pool (10, 0, 1);
+  GstBuffer *buf = NULL, *prev;
+  GThread *thread;
+  gint dcount = 0;
+
+  gst_buffer_pool_set_active (pool, TRUE);
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buf,
+          NULL) == GST_FLOW_OK);
+  buffer_track_destroy (buf, &dcount);
+  prev = buf;
+
+  /* released in another thread, must be picked up from there */
+  thread = g_thread_new (NULL, unref_buf_delayed, buf);
+  g_thread_join (thread);
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buf,
+          NULL) == GST_FLOW_OK);
+  fail_unless (buf == prev, "got a fresh buffer instead of previous");
+
+  /* released in another thread while we wait for it */
+  thread = g_thread_new (NULL, unref_buf_delayed, buf);
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buf,
+          NULL) == GST_FLOW_OK);
+  fail_unless (buf == prev, "got a fresh buffer instead of previous");
+  g_thread_join (thread);
+
+  gst_buffer_unref (buf);
+  gst_buffer_pool_set_active (pool, FALSE);
+  gst_object_unref (pool);
+
+  fail_unless_equals_int (dcount, 1);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_buffer_pool_suite (void)
 {
@@ -355,6 +399,7 @@ gst_buffer_pool_suite (void)
   tcase_add_test (tc_chain, test_pool_config_validate);
   tcase_add_test (tc_chain, test_flushing_pool_returns_flushing);
   tcase_add_test (tc_chain, test_no_deadlock_for_buffer_discard);
+  tcase_add_test (tc_chain, test_buffer_released_in_other_thread);
 
   return s;
 }
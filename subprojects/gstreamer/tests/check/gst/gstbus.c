@@ -926,6 +926,101 @@ GST_START_TEST (test_single_gsource)
 
 GST_END_TEST;
 
+static gboolean
+count_dispatch_func (GstBus * bus, GstMessage * msg, gpointer user_data)
+{
+  guint *count = user_data;
+
+  (*count)++;
+
+  return TRUE;
+}
+
+GST_START_TEST (test_dispatch_batch)
+{
+  guint i, num_messages = 0;
+  GSource *source;
+
+  test_bus = gst_bus_new ();
+  fail_unless_equals_int (gst_bus_get_dispatch_batch_size (test_bus), 1);
+  gst_bus_set_dispatch_batch_size (test_bus, 4);
+
+  source = gst_bus_create_watch (test_bus);
+  g_source_set_callback (source, (GSourceFunc) count_dispatch_func,
+      &num_messages, NULL);
+  g_source_attach (source, NULL);
+
+  for (i = 0; i < 10; i++)
+    gst_bus_post (test_bus, gst_message_new_application (NULL,
+            gst_structure_new_empty ("test")));
+
+  /* up to 4 messages per iteration */
+  g_main_context_iteration (NULL, FALSE);
+  fail_unless_equals_int (num_messages, 4);
+  g_main_context_iteration (NULL, FALSE);
+  fail_unless_equals_int (num_messages, 8);
+  g_main_context_iteration (NULL, FALSE);
+  fail_unless_equals_int (num_messages, 10);
+  fail_if (gst_bus_have_pending (test_bus));
+
+  g_source_destroy (source);
+  g_source_unref (source);
+  gst_object_unref (test_bus);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_interest_mask)
+{
+  GstElement *pipeline, *bin, *sink;
+  GstMessage *msg;
+
+  test_bus = gst_bus_new ();
+  fail_unless_equals_int (gst_bus_get_interest_mask (test_bus),
+      GST_MESSAGE_ANY);
+  gst_bus_set_interest_mask (test_bus, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+
+  fail_unless (gst_bus_post (test_bus,
+          gst_message_new_application (NULL,
+              gst_structure_new_empty ("test"))));
+  fail_unless (gst_bus_post (test_bus, gst_message_new_eos (NULL)));
+  /* extended types don't match the basic type bits */
+  fail_unless (gst_bus_post (test_bus,
+          gst_message_new_custom (GST_MESSAGE_REDIRECT, NULL, NULL)));
+
+  /* only the EOS made it */
+  msg = gst_bus_pop (test_bus);
+  fail_unless (msg != NULL);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  fail_if (gst_bus_have_pending (test_bus));
+  gst_object_unref (test_bus);
+
+  /* elements look at the bus of the toplevel */
+  pipeline = gst_pipeline_new (NULL);
+  bin = gst_bin_new (NULL);
+  sink = gst_element_factory_make ("fakesink", NULL);
+  gst_bin_add (GST_BIN (bin), sink);
+  gst_bin_add (GST_BIN (pipeline), bin);
+
+  fail_unless (gst_element_is_message_wanted (sink, GST_MESSAGE_QOS));
+
+  test_bus = gst_element_get_bus (pipeline);
+  gst_bus_set_interest_mask (test_bus, GST_MESSAGE_ERROR | GST_MESSAGE_EOS);
+  fail_if (gst_element_is_message_wanted (sink, GST_MESSAGE_QOS));
+  fail_unless (gst_element_is_message_wanted (sink, GST_MESSAGE_EOS));
+  fail_if (gst_element_is_message_wanted (sink, GST_MESSAGE_DEVICE_ADDED));
+
+  gst_bus_set_interest_mask (test_bus, GST_MESSAGE_ANY);
+  fail_unless (gst_element_is_message_wanted (sink, GST_MESSAGE_QOS));
+  fail_unless (gst_element_is_message_wanted (sink, GST_MESSAGE_DEVICE_ADDED));
+
+  gst_object_unref (test_bus);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_bus_suite (void)
 {
@@ -949,6 +1044,8 @@ gst_bus_suite (void)
   tcase_add_test (tc_chain, test_custom_main_context);
   tcase_add_test (tc_chain, test_async_message);
   tcase_add_test (tc_chain, test_single_gsource);
+  tcase_add_test (tc_chain, test_dispatch_batch);
+  tcase_add_test (tc_chain, test_interest_mask);
   return s;
 }
 
@@ -0,0 +1,239 @@
+/* GStreamer
+ *
+ * unit test for the cache of caps intersections
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+
+GST_START_TEST (test_cache_hit)
+{
+  GstCaps *c1, *c2, *ci1, *ci2;
+
+  c1 = gst_caps_from_string ("video/x-raw, format = (string) { I420, NV12 }, "
+      "width = (int) [ 1, MAX ]");
+  c2 = gst_caps_from_string ("video/x-raw, format = (string) NV12, "
+      "width = (int) 320");
+
+  /* writable caps are never cached */
+  ci1 = gst_caps_intersect (c1, c2);
+  ci2 = gst_caps_intersect (c1, c2);
+  fail_unless (ci1 != ci2);
+  fail_unless (gst_caps_is_equal (ci1, ci2));
+  gst_caps_unref (ci1);
+  gst_caps_unref (ci2);
+
+  /* shared caps can't change anymore, the second result comes from the
+   * cache as a copy that the caller owns */
+  gst_caps_ref (c1);
+  gst_caps_ref (c2);
+  ci1 = gst_caps_intersect (c1, c2);
+  fail_unless (gst_caps_is_writable (ci1));
+  ci2 = gst_caps_intersect (c1, c2);
+  fail_unless (ci1 != ci2);
+  fail_unless (gst_caps_is_writable (ci2));
+  fail_unless (gst_caps_is_equal (ci1, c2));
+  fail_unless (gst_caps_is_equal (ci2, c2));
+
+  /* modifying the results must not change what the cache returns */
+  gst_caps_set_simple (ci1, "width", G_TYPE_INT, 640, NULL);
+  gst_caps_set_simple (ci2, "width", G_TYPE_INT, 800, NULL);
+  gst_caps_unref (ci1);
+  gst_caps_unref (ci2);
+  ci1 = gst_caps_intersect (c1, c2);
+  fail_unless (gst_caps_is_equal (ci1, c2));
+  gst_caps_unref (ci1);
+
+  /* the mode is part of the key */
+  ci1 = gst_caps_intersect_full (c1, c2, GST_CAPS_INTERSECT_FIRST);
+  fail_unless (gst_caps_is_equal (ci1, c2));
+  gst_caps_unref (ci1);
+
+  fail_unless (gst_caps_can_intersect (c1, c2));
+  fail_unless (gst_caps_can_intersect (c1, c2));
+  fail_unless (gst_caps_is_subset (c2, c1));
+  fail_unless (gst_caps_is_subset (c2, c1));
+  fail_if (gst_caps_is_subset (c1, c2));
+  fail_if (gst_caps_is_subset (c1, c2));
+
+  gst_caps_unref (c1);
+  gst_caps_unref (c1);
+  gst_caps_unref (c2);
+  gst_caps_unref (c2);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_cache_modified)
+{
+  GstCaps *c1, *c2, *ci;
+  GstStructure *s;
+
+  c1 = gst_caps_from_string ("audio/x-raw, rate = (int) [ 8000, 48000 ]");
+  c2 = gst_caps_from_string ("audio/x-raw, rate = (int) 44100");
+
+  gst_caps_ref (c1);
+  gst_caps_ref (c2);
+  fail_unless (gst_caps_can_intersect (c1, c2));
+  fail_unless (gst_caps_is_subset (c2, c1));
+  ci = gst_caps_intersect (c1, c2);
+  fail_unless (gst_caps_is_equal (ci, c2));
+  gst_caps_unref (ci);
+  gst_caps_unref (c2);
+
+  /* change the caps in place now that they are writable again */
+  gst_caps_set_simple (c2, "rate", G_TYPE_INT, 96000, NULL);
+
+  gst_caps_ref (c2);
+  fail_if (gst_caps_can_intersect (c1, c2));
+  fail_if (gst_caps_is_subset (c2, c1));
+  ci = gst_caps_intersect (c1, c2);
+  fail_unless (gst_caps_is_empty (ci));
+  gst_caps_unref (ci);
+  gst_caps_unref (c2);
+
+  /* and through the structure */
+  s = gst_caps_get_structure (c2, 0);
+  gst_structure_set (s, "rate", G_TYPE_INT, 22050, NULL);
+
+  gst_caps_ref (c2);
+  fail_unless (gst_caps_can_intersect (c1, c2));
+  fail_unless (gst_caps_is_subset (c2, c1));
+  ci = gst_caps_intersect (c1, c2);
+  fail_unless (gst_caps_is_equal (ci, c2));
+  gst_caps_unref (ci);
+  gst_caps_unref (c2);
+
+  gst_caps_unref (c1);
+  gst_caps_unref (c1);
+  gst_caps_unref (c2);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_cache_saved_structure)
+{
+  GstCaps *c1, *c2, *ci;
+  GstCapsFeatures *f;
+  GstStructure *s;
+
+  c1 = gst_caps_from_string ("audio/x-raw, rate = (int) [ 8000, 48000 ]");
+  c2 = gst_caps_from_string ("audio/x-raw, rate = (int) 44100");
+  gst_caps_ref (c1);
+
+  /* take the structure while the caps are writable and keep it around */
+  s = gst_caps_get_structure (c2, 0);
+
+  gst_caps_ref (c2);
+  ci = gst_caps_intersect (c1, c2);
+  fail_unless (gst_caps_is_equal (ci, c2));
+  gst_caps_unref (ci);
+  fail_unless (gst_caps_can_intersect (c1, c2));
+  gst_caps_unref (c2);
+
+  /* modify the writable caps through the saved structure */
+  gst_structure_set (s, "rate", G_TYPE_INT, 96000, NULL);
+
+  gst_caps_ref (c2);
+  ci = gst_caps_intersect (c1, c2);
+  fail_unless (gst_caps_is_empty (ci));
+  gst_caps_unref (ci);
+  fail_if (gst_caps_can_intersect (c1, c2));
+  gst_caps_unref (c2);
+
+  gst_structure_remove_field (s, "rate");
+
+  gst_caps_ref (c2);
+  fail_unless (gst_caps_can_intersect (c1, c2));
+  gst_caps_unref (c2);
+
+  /* same for the features */
+  f = gst_caps_get_features (c2, 0);
+
+  gst_caps_ref (c2);
+  fail_unless (gst_caps_can_intersect (c1, c2));
+  gst_caps_unref (c2);
+
+  gst_caps_features_remove (f, GST_CAPS_FEATURE_MEMORY_SYSTEM_MEMORY);
+  gst_caps_features_add (f, "memory:Test");
+
+  gst_caps_ref (c2);
+  fail_if (gst_caps_can_intersect (c1, c2));
+  gst_caps_unref (c2);
+
+  gst_caps_unref (c1);
+  gst_caps_unref (c1);
+  gst_caps_unref (c2);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_cache_freed)
+{
+  GstCaps *c1, *c2, *ci;
+  gint i;
+
+  c1 = gst_caps_from_string ("video/x-raw, width = (int) [ 1, 640 ]");
+  gst_caps_ref (c1);
+
+  /* new caps might get the address of freed ones, they must not get their
+   * results */
+  for (i = 0; i < 100; i++) {
+    c2 = gst_caps_new_simple ("video/x-raw", "width", G_TYPE_INT,
+        (i % 2) ? 320 : 1280, NULL);
+    gst_caps_ref (c2);
+    ci = gst_caps_intersect (c1, c2);
+    fail_unless (gst_caps_is_empty (ci) == !(i % 2));
+    gst_caps_unref (ci);
+    fail_unless (gst_caps_can_intersect (c1, c2) == (i % 2));
+    gst_caps_unref (c2);
+    gst_caps_unref (c2);
+  }
+
+  gst_caps_unref (c1);
+  gst_caps_unref (c1);
+}
+
+GST_END_TEST;
+
+static Suite *
+gst_caps_cache_suite (void)
+{
+  Suite *s = suite_create ("GstCapsCache");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_cache_hit);
+  tcase_add_test (tc_chain, test_cache_modified);
+  tcase_add_test (tc_chain, test_cache_saved_structure);
+  tcase_add_test (tc_chain, test_cache_freed);
+
+  return s;
+}
+
+int
+main (int argc, char **argv)
+{
+  Suite *s;
+
+  /* must be set before the caps are initialized */
+  g_setenv ("GST_CAPS_CACHE", "1", TRUE);
+
+  gst_check_init (&argc, &argv);
+  s = gst_caps_cache_suite ();
+  return gst_check_run_suite (s, "gstcapscache", __FILE__);
+}
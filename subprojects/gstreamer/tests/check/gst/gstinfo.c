@@ -26,6 +26,7 @@
 #include <gst/check/gstcheck.h>
 
 #include <string.h>
+#include <stdio.h>
 
 #ifndef GST_DISABLE_GST_DEBUG
 
@@ -558,6 +559,151 @@ GST_START_TEST (info_set_and_reset_string)
 
 GST_END_TEST;
 
+static gpointer
+flight_recorder_thread (gpointer data)
+{
+  GST_INFO ("message from thread %s", (const gchar *) data);
+  return NULL;
+}
+
+GST_START_TEST (info_flight_recorder)
+{
+  gchar **logs, *all, str[] = "first";
+  GstStructure *s;
+  GThread *thread;
+  gint i;
+
+  gst_debug_remove_log_function (gst_debug_log_default);
+  gst_debug_add_flight_recorder (0);
+  gst_debug_set_threshold_from_string ("LOG", TRUE);
+
+  s = gst_structure_new ("foo/bar", "number", G_TYPE_INT, 1, NULL);
+  GST_LOG ("%s %d %" GST_TIME_FORMAT " %" GST_PTR_FORMAT, str, 42,
+      GST_TIME_ARGS (GST_SECOND), s);
+  /* the message must not change with its arguments */
+  strcpy (str, "later");
+  gst_structure_set (s, "number", G_TYPE_INT, 2, NULL);
+  gst_structure_free (s);
+
+  gst_debug_log_literal (GST_CAT_DEFAULT, GST_LEVEL_LOG, __FILE__,
+      GST_FUNCTION, __LINE__, NULL, "literal %s message");
+
+  /* the logs of a thread are kept after it exited */
+  thread = g_thread_new ("flight", flight_recorder_thread, (gpointer) "two");
+  g_thread_join (thread);
+
+  logs = gst_debug_flight_recorder_get_logs (GST_CLOCK_TIME_NONE);
+  fail_unless (g_strv_length (logs) >= 2);
+  all = g_strjoinv ("", logs);
+  fail_unless (strstr (all,
+          "first 42 0:00:01.000000000 foo/bar, number=(int)1;\n") != NULL);
+  fail_unless (strstr (all, "literal %s message\n") != NULL);
+  fail_unless (strstr (all, "message from thread two\n") != NULL);
+  g_free (all);
+  g_strfreev (logs);
+
+  /* only the newest messages fit */
+  for (i = 0; i < 1000; i++)
+    GST_LOG ("message %d", i);
+
+  logs = gst_debug_flight_recorder_get_logs (GST_CLOCK_TIME_NONE);
+  all = g_strjoinv ("", logs);
+  fail_unless (strstr (all, "message 999\n") != NULL);
+  fail_if (strstr (all, "message 0\n") != NULL);
+  fail_if (strstr (all, "first 42") != NULL);
+  g_free (all);
+  g_strfreev (logs);
+
+  logs = gst_debug_flight_recorder_get_logs (0);
+  all = g_strjoinv ("", logs);
+  fail_if (strstr (all, "message 999\n") != NULL);
+  g_free (all);
+  g_strfreev (logs);
+
+  gst_debug_remove_flight_recorder ();
+
+  /* the ring of this thread belonged to the removed flight recorder, a new
+   * one with the same size must not write into it */
+  gst_debug_add_flight_recorder (0);
+  GST_LOG ("message after re-adding");
+  logs = gst_debug_flight_recorder_get_logs (GST_CLOCK_TIME_NONE);
+  all = g_strjoinv ("", logs);
+  fail_unless (strstr (all, "message after re-adding\n") != NULL);
+  fail_if (strstr (all, "message 999\n") != NULL);
+  g_free (all);
+  g_strfreev (logs);
+  gst_debug_remove_flight_recorder ();
+
+  gst_debug_set_default_threshold (GST_LEVEL_NONE);
+  gst_debug_add_log_function (gst_debug_log_default, NULL, NULL);
+}
+
+GST_END_TEST;
+
+static gint flight_recorder_stress_running;
+
+static gpointer
+flight_recorder_stress_thread (gpointer data)
+{
+  guint i = 0;
+
+  /* every record has two numbers that add up to G_MAXUINT, a torn record
+   * shows up as a pair that doesn't */
+  while (g_atomic_int_get (&flight_recorder_stress_running)) {
+    GST_LOG ("stress %u %u", i, G_MAXUINT - i);
+    i++;
+  }
+
+  return NULL;
+}
+
+GST_START_TEST (info_flight_recorder_stress)
+{
+  GThread *threads[4];
+  gchar **logs, **lines;
+  guint i, j, k, n_checked = 0;
+
+  gst_debug_remove_log_function (gst_debug_log_default);
+  /* small rings so that they are overwritten all the time */
+  gst_debug_add_flight_recorder (4096);
+  gst_debug_set_threshold_from_string ("LOG", TRUE);
+
+  g_atomic_int_set (&flight_recorder_stress_running, 1);
+  for (i = 0; i < G_N_ELEMENTS (threads); i++)
+    threads[i] = g_thread_new ("stress", flight_recorder_stress_thread, NULL);
+
+  for (i = 0; i < 200; i++) {
+    logs = gst_debug_flight_recorder_get_logs (GST_CLOCK_TIME_NONE);
+    for (j = 0; logs[j]; j++) {
+      lines = g_strsplit (logs[j], "\n", -1);
+      for (k = 0; lines[k]; k++) {
+        const gchar *msg = strstr (lines[k], "stress ");
+        guint a, b;
+
+        if (msg == NULL)
+          continue;
+        fail_unless_equals_int (sscanf (msg, "stress %u %u", &a, &b), 2);
+        fail_unless_equals_int64 ((guint64) a + b, G_MAXUINT);
+        n_checked++;
+      }
+      g_strfreev (lines);
+    }
+    g_strfreev (logs);
+  }
+
+  g_atomic_int_set (&flight_recorder_stress_running, 0);
+  for (i = 0; i < G_N_ELEMENTS (threads); i++)
+    g_thread_join (threads[i]);
+
+  fail_unless (n_checked > 0);
+
+  gst_debug_remove_flight_recorder ();
+  gst_debug_set_default_threshold (GST_LEVEL_NONE);
+  gst_debug_add_log_function (gst_debug_log_default, NULL, NULL);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_info_suite (void)
 {
@@ -581,6 +727,8 @@ gst_info_suite (void)
   tcase_add_test (tc_chain, info_set_and_unset_multiple);
   tcase_add_test (tc_chain, info_post_gst_init_category_registration);
   tcase_add_test (tc_chain, info_set_and_reset_string);
+  tcase_add_test (tc_chain, info_flight_recorder);
+  tcase_add_test (tc_chain, info_flight_recorder_stress);
 #endif
 
   return s;
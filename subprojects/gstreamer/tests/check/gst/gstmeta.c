@@ -535,6 +535,70 @@ GST_START_TEST (test_meta_foreach_remove_several)
 
 GST_END_TEST;
 
+static gboolean
+foreach_meta_remove_test_api (GstBuffer * buffer, GstMeta ** meta,
+    gpointer user_data)
+{
+  if ((*meta)->info->api == GST_META_TEST_API_TYPE)
+    *meta = NULL;
+
+  return TRUE;
+}
+
+GST_START_TEST (test_meta_many)
+{
+  GstBuffer *buffer;
+  GstMetaTest *tests[20];
+  GstMetaFoo *foos[20];
+  gint i, round;
+
+  buffer = gst_buffer_new_and_alloc (4);
+  fail_if (buffer == NULL);
+
+  /* more metas than fit in the buffer, added and removed a few times to
+   * reuse the storage in the buffer */
+  for (round = 0; round < 3; round++) {
+    for (i = 0; i < G_N_ELEMENTS (tests); i++) {
+      tests[i] = GST_META_TEST_ADD (buffer);
+      fail_if (tests[i] == NULL);
+      tests[i]->pts = i;
+      foos[i] = GST_META_FOO_ADD (buffer);
+      fail_if (foos[i] == NULL);
+    }
+
+    fail_unless_equals_int (count_buffer_meta (buffer), 40);
+    fail_unless_equals_int (gst_buffer_get_n_meta (buffer,
+            GST_META_TEST_API_TYPE), 20);
+    fail_unless (GST_META_TEST_GET (buffer) == tests[0]);
+    fail_unless (GST_META_FOO_GET (buffer) == foos[0]);
+
+    /* the lookup must move on to the next meta of the same API */
+    fail_unless (gst_buffer_remove_meta (buffer, (GstMeta *) tests[0]));
+    fail_unless (GST_META_TEST_GET (buffer) == tests[1]);
+    fail_unless (gst_buffer_remove_meta (buffer, (GstMeta *) foos[0]));
+    fail_unless (GST_META_FOO_GET (buffer) == foos[1]);
+    fail_unless (gst_buffer_remove_meta (buffer, (GstMeta *) tests[19]));
+
+    for (i = 1; i < 19; i++)
+      fail_unless_equals_uint64 (tests[i]->pts, i);
+
+    gst_buffer_foreach_meta (buffer, foreach_meta_remove_test_api, NULL);
+    fail_unless (GST_META_TEST_GET (buffer) == NULL);
+    fail_unless (GST_META_FOO_GET (buffer) == foos[1]);
+    fail_unless_equals_int (count_buffer_meta (buffer), 19);
+
+    for (i = 1; i < G_N_ELEMENTS (foos); i++)
+      fail_unless (gst_buffer_remove_meta (buffer, (GstMeta *) foos[i]));
+    fail_unless (GST_META_FOO_GET (buffer) == NULL);
+    fail_unless_equals_int (count_buffer_meta (buffer), 0);
+  }
+
+  /* clean up */
+  gst_buffer_unref (buffer);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_meta_iterate)
 {
   GstBuffer *buffer;
@@ -823,6 +887,7 @@ gst_buffermeta_suite (void)
   tcase_add_test (tc_chain, test_meta_foreach_remove_tail_of_three);
   tcase_add_test (tc_chain, test_meta_foreach_remove_head_and_tail_of_three);
   tcase_add_test (tc_chain, test_meta_foreach_remove_several);
+  tcase_add_test (tc_chain, test_meta_many);
   tcase_add_test (tc_chain, test_meta_iterate);
   tcase_add_test (tc_chain, test_meta_seqnum);
   tcase_add_test (tc_chain, test_meta_custom);
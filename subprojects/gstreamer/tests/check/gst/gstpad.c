@@ -2952,6 +2952,250 @@ GST_START_TEST (test_flush_stop_inactive)
 
 GST_END_TEST;
 
+/* The fast push path hands buffers to the peer without taking the object
+ * lock once a push cached the peer. These tests change the pad while such a
+ * push is blocked in the chain function of the peer. */
+static GMutex fast_push_lock;
+static GCond fast_push_cond;
+static gboolean fast_push_block;
+static gboolean fast_push_blocked;
+static gint fast_push_chained;
+static gint fast_push_idle_called;
+
+static GstFlowReturn
+fast_push_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  g_mutex_lock (&fast_push_lock);
+  if (fast_push_block) {
+    fast_push_blocked = TRUE;
+    g_cond_broadcast (&fast_push_cond);
+    while (fast_push_block)
+      g_cond_wait (&fast_push_cond, &fast_push_lock);
+    fast_push_blocked = FALSE;
+  }
+  fast_push_chained++;
+  g_mutex_unlock (&fast_push_lock);
+
+  gst_buffer_unref (buffer);
+  return GST_FLOW_OK;
+}
+
+static void
+fast_push_setup (GstPad ** srcpad, GstPad ** sinkpad)
+{
+  *srcpad = gst_pad_new ("src", GST_PAD_SRC);
+  *sinkpad = gst_pad_new ("sink", GST_PAD_SINK);
+  gst_pad_set_chain_function (*sinkpad, fast_push_chain);
+  fail_unless (gst_pad_link (*srcpad, *sinkpad) == GST_PAD_LINK_OK);
+  gst_pad_set_active (*sinkpad, TRUE);
+  gst_pad_set_active (*srcpad, TRUE);
+
+  fail_unless (gst_pad_push_event (*srcpad,
+          gst_event_new_stream_start ("test")));
+  fail_unless (gst_pad_push_event (*srcpad,
+          gst_event_new_segment (&dummy_segment)));
+
+  fast_push_block = FALSE;
+  fast_push_blocked = FALSE;
+  fast_push_chained = 0;
+  fast_push_idle_called = 0;
+
+  /* the first push takes the locked path and caches the peer */
+  fail_unless_equals_int (gst_pad_push (*srcpad, gst_buffer_new ()),
+      GST_FLOW_OK);
+  fail_unless_equals_int (fast_push_chained, 1);
+}
+
+/* pushes a buffer from a new thread and waits until it is in the chain
+ * function of the peer */
+static GThread *
+fast_push_start_blocked (GstPad * srcpad)
+{
+  GThread *thread;
+
+  g_mutex_lock (&fast_push_lock);
+  fast_push_block = TRUE;
+  g_mutex_unlock (&fast_push_lock);
+
+  thread = g_thread_new ("gst-check", (GThreadFunc) push_buffer_async,
+      gst_object_ref (srcpad));
+
+  g_mutex_lock (&fast_push_lock);
+  while (!fast_push_blocked)
+    g_cond_wait (&fast_push_cond, &fast_push_lock);
+  g_mutex_unlock (&fast_push_lock);
+
+  return thread;
+}
+
+static GstFlowReturn
+fast_push_finish (GThread * thread)
+{
+  g_mutex_lock (&fast_push_lock);
+  fast_push_block = FALSE;
+  g_cond_broadcast (&fast_push_cond);
+  g_mutex_unlock (&fast_push_lock);
+
+  return GPOINTER_TO_INT (g_thread_join (thread));
+}
+
+GST_START_TEST (test_fast_push_unlink)
+{
+  GstPad *srcpad, *sinkpad;
+  GThread *thread;
+
+  fast_push_setup (&srcpad, &sinkpad);
+
+  thread = fast_push_start_blocked (srcpad);
+  fail_unless (gst_pad_unlink (srcpad, sinkpad));
+  fail_unless (gst_pad_get_peer (srcpad) == NULL);
+
+  /* the buffer was already given to the old peer */
+  fail_unless_equals_int (fast_push_finish (thread), GST_FLOW_OK);
+  fail_unless_equals_int (fast_push_chained, 2);
+
+  /* the old peer is released once the push is done */
+  ASSERT_OBJECT_REFCOUNT (sinkpad, "sinkpad", 1);
+
+  fail_unless_equals_int (gst_pad_push (srcpad, gst_buffer_new ()),
+      GST_FLOW_NOT_LINKED);
+  fail_unless_equals_int (gst_pad_get_last_flow_return (srcpad),
+      GST_FLOW_NOT_LINKED);
+  fail_unless_equals_int (fast_push_chained, 2);
+
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+}
+
+GST_END_TEST;
+
+static GstPadProbeReturn
+fast_push_idle_probe (GstPad * pad, GstPadProbeInfo * info, gpointer data)
+{
+  fail_unless (info->type & GST_PAD_PROBE_TYPE_IDLE);
+  g_atomic_int_inc (&fast_push_idle_called);
+  return GST_PAD_PROBE_REMOVE;
+}
+
+static GstPadProbeReturn
+fast_push_block_probe (GstPad * pad, GstPadProbeInfo * info, gpointer data)
+{
+  return GST_PAD_PROBE_OK;
+}
+
+GST_START_TEST (test_fast_push_probes)
+{
+  GstPad *srcpad, *sinkpad;
+  GThread *thread;
+  gulong block_id;
+
+  fast_push_setup (&srcpad, &sinkpad);
+
+  /* an idle probe added during a push is called when the push is done */
+  thread = fast_push_start_blocked (srcpad);
+  gst_pad_add_probe (srcpad, GST_PAD_PROBE_TYPE_IDLE, fast_push_idle_probe,
+      NULL, NULL);
+  fail_unless_equals_int (g_atomic_int_get (&fast_push_idle_called), 0);
+  fail_unless_equals_int (fast_push_finish (thread), GST_FLOW_OK);
+  fail_unless_equals_int (g_atomic_int_get (&fast_push_idle_called), 1);
+  fail_unless_equals_int (fast_push_chained, 2);
+
+  /* a blocking probe added during a push blocks the next push */
+  thread = fast_push_start_blocked (srcpad);
+  block_id = gst_pad_add_probe (srcpad, GST_PAD_PROBE_TYPE_BLOCK_DOWNSTREAM,
+      fast_push_block_probe, NULL, NULL);
+  fail_unless_equals_int (fast_push_finish (thread), GST_FLOW_OK);
+  fail_unless_equals_int (fast_push_chained, 3);
+
+  thread = g_thread_new ("gst-check", (GThreadFunc) push_buffer_async,
+      gst_object_ref (srcpad));
+  while (!gst_pad_is_blocking (srcpad))
+    g_usleep (1000);
+  fail_unless_equals_int (fast_push_chained, 3);
+
+  gst_pad_remove_probe (srcpad, block_id);
+  fail_unless_equals_int (GPOINTER_TO_INT (g_thread_join (thread)),
+      GST_FLOW_OK);
+  fail_unless_equals_int (fast_push_chained, 4);
+
+  /* and without probes the fast path is used again */
+  fail_unless_equals_int (gst_pad_push (srcpad, gst_buffer_new ()),
+      GST_FLOW_OK);
+  fail_unless_equals_int (fast_push_chained, 5);
+
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_fast_push_deactivate)
+{
+  GstPad *srcpad, *sinkpad;
+  GThread *thread;
+
+  fast_push_setup (&srcpad, &sinkpad);
+
+  thread = fast_push_start_blocked (srcpad);
+  fail_unless (gst_pad_set_active (srcpad, FALSE));
+  fail_unless_equals_int (fast_push_finish (thread), GST_FLOW_OK);
+  fail_unless_equals_int (fast_push_chained, 2);
+
+  /* still linked, but the peer is not used anymore without the lock */
+  ASSERT_OBJECT_REFCOUNT (sinkpad, "sinkpad", 1);
+
+  fail_unless_equals_int (gst_pad_push (srcpad, gst_buffer_new ()),
+      GST_FLOW_FLUSHING);
+  fail_unless_equals_int (gst_pad_get_last_flow_return (srcpad),
+      GST_FLOW_FLUSHING);
+  fail_unless_equals_int (fast_push_chained, 2);
+
+  fail_unless (gst_pad_set_active (srcpad, TRUE));
+  fail_unless (gst_pad_push_event (srcpad,
+          gst_event_new_stream_start ("test")));
+  fail_unless (gst_pad_push_event (srcpad,
+          gst_event_new_segment (&dummy_segment)));
+  fail_unless_equals_int (gst_pad_push (srcpad, gst_buffer_new ()),
+      GST_FLOW_OK);
+  fail_unless_equals_int (fast_push_chained, 3);
+
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_fast_push_flush)
+{
+  GstPad *srcpad, *sinkpad;
+  GThread *thread;
+
+  fast_push_setup (&srcpad, &sinkpad);
+
+  thread = fast_push_start_blocked (srcpad);
+  fail_unless (gst_pad_push_event (srcpad, gst_event_new_flush_start ()));
+  fail_unless_equals_int (fast_push_finish (thread), GST_FLOW_OK);
+  fail_unless_equals_int (fast_push_chained, 2);
+
+  fail_unless_equals_int (gst_pad_push (srcpad, gst_buffer_new ()),
+      GST_FLOW_FLUSHING);
+  fail_unless_equals_int (gst_pad_get_last_flow_return (srcpad),
+      GST_FLOW_FLUSHING);
+  fail_unless_equals_int (fast_push_chained, 2);
+
+  fail_unless (gst_pad_push_event (srcpad,
+          gst_event_new_flush_stop (FALSE)));
+  fail_unless_equals_int (gst_pad_push (srcpad, gst_buffer_new ()),
+      GST_FLOW_OK);
+  fail_unless_equals_int (gst_pad_get_last_flow_return (srcpad), GST_FLOW_OK);
+  fail_unless_equals_int (fast_push_chained, 3);
+
+  gst_object_unref (srcpad);
+  gst_object_unref (sinkpad);
+}
+
+GST_END_TEST;
+
 /* For proxy caps flag tests */
 
 typedef struct _GstProxyTestElement GstProxyTestElement;
@@ -3447,6 +3691,10 @@ gst_pad_suite (void)
   tcase_add_test (tc_chain, test_last_flow_return_push);
   tcase_add_test (tc_chain, test_last_flow_return_pull);
   tcase_add_test (tc_chain, test_flush_stop_inactive);
+  tcase_add_test (tc_chain, test_fast_push_unlink);
+  tcase_add_test (tc_chain, test_fast_push_probes);
+  tcase_add_test (tc_chain, test_fast_push_deactivate);
+  tcase_add_test (tc_chain, test_fast_push_flush);
   tcase_add_test (tc_chain, test_proxy_accept_caps_no_proxy);
   tcase_add_test (tc_chain, test_proxy_accept_caps_with_proxy);
   tcase_add_test (tc_chain, test_proxy_accept_caps_with_incompatible_proxy);
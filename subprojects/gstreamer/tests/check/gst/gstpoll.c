@@ -325,6 +325,240 @@ GST_START_TEST (test_poll_controllable)
 
 GST_END_TEST;
 
+#ifndef G_OS_WIN32
+/* GST_POLL_MODE is read when the set is created */
+static GstPoll *
+poll_new_with_mode (const gchar * mode, gboolean controllable)
+{
+  GstPoll *set;
+
+  if (mode)
+    g_setenv ("GST_POLL_MODE", mode, TRUE);
+  else
+    g_unsetenv ("GST_POLL_MODE");
+  set = gst_poll_new (controllable);
+  g_unsetenv ("GST_POLL_MODE");
+  fail_if (set == NULL, "Failed to create a GstPoll");
+
+  return set;
+}
+
+static void
+check_poll_read_write (const gchar * mode)
+{
+  GstPoll *set;
+  GstPollFD rfd = GST_POLL_FD_INIT;
+  GstPollFD wfd = GST_POLL_FD_INIT;
+  gint socks[2];
+  guchar c = 'A';
+
+  set = poll_new_with_mode (mode, FALSE);
+
+  fail_if (socketpair (PF_UNIX, SOCK_STREAM, 0, socks) < 0,
+      "Could not create a socket pair");
+  rfd.fd = socks[0];
+  wfd.fd = socks[1];
+
+  fail_unless (gst_poll_add_fd (set, &rfd), "Could not add read descriptor");
+  fail_unless (gst_poll_fd_ctl_read (set, &rfd, TRUE),
+      "Could not mark the descriptor as readable");
+  fail_unless (gst_poll_wait (set, 0) == 0, "Nothing should be available");
+
+  fail_unless (write (wfd.fd, &c, 1) == 1, "write() failed");
+  fail_unless (gst_poll_wait (set, GST_CLOCK_TIME_NONE) == 1,
+      "One descriptor should be available");
+  fail_unless (gst_poll_fd_can_read (set, &rfd),
+      "Read descriptor should be readable");
+  fail_if (gst_poll_fd_can_write (set, &rfd),
+      "Read descriptor should not be writeable");
+
+  fail_unless (gst_poll_add_fd (set, &wfd), "Could not add write descriptor");
+  fail_unless (gst_poll_fd_ctl_write (set, &wfd, TRUE),
+      "Could not mark the descriptor as writeable");
+  fail_unless (gst_poll_wait (set, GST_CLOCK_TIME_NONE) == 2,
+      "Two descriptors should be available");
+  fail_unless (gst_poll_fd_can_read (set, &rfd),
+      "Read descriptor should be readable");
+  fail_unless (gst_poll_fd_can_write (set, &wfd),
+      "Write descriptor should be writeable");
+
+  /* not interested in reading anymore */
+  fail_unless (gst_poll_fd_ctl_read (set, &rfd, FALSE),
+      "Could not unmark the descriptor as readable");
+  fail_unless (gst_poll_wait (set, GST_CLOCK_TIME_NONE) == 1,
+      "One descriptor should be available");
+  fail_if (gst_poll_fd_can_read (set, &rfd),
+      "Read descriptor should not be readable");
+
+  fail_unless (gst_poll_remove_fd (set, &wfd),
+      "Could not remove write descriptor");
+  fail_unless (gst_poll_fd_ctl_read (set, &rfd, TRUE),
+      "Could not mark the descriptor as readable");
+  fail_unless (read (rfd.fd, &c, 1) == 1, "read() failed");
+  fail_unless (gst_poll_wait (set, 0) == 0, "Nothing should be available");
+
+  /* removing and adding again must register the fd again */
+  fail_unless (gst_poll_remove_fd (set, &rfd),
+      "Could not remove read descriptor");
+  fail_unless (gst_poll_add_fd (set, &rfd), "Could not add read descriptor");
+  fail_unless (gst_poll_fd_ctl_read (set, &rfd, TRUE),
+      "Could not mark the descriptor as readable");
+  fail_unless (write (wfd.fd, &c, 1) == 1, "write() failed");
+  fail_unless (gst_poll_wait (set, GST_CLOCK_TIME_NONE) == 1,
+      "One descriptor should be available");
+  fail_unless (gst_poll_fd_can_read (set, &rfd),
+      "Read descriptor should be readable");
+
+  gst_poll_free (set);
+  close (socks[0]);
+  close (socks[1]);
+}
+
+GST_START_TEST (test_poll_modes_read_write)
+{
+  check_poll_read_write ("poll");
+  check_poll_read_write ("epoll");
+  check_poll_read_write (NULL);
+}
+
+GST_END_TEST;
+
+/* more than the number of fds that makes the set switch to epoll */
+#define N_SOCKET_PAIRS 80
+
+static void
+check_poll_many_fds (const gchar * mode)
+{
+  GstPoll *set;
+  GstPollFD fds[N_SOCKET_PAIRS];
+  gint peers[N_SOCKET_PAIRS];
+  guchar c = 'A';
+  gint i, n_written = 0;
+
+  set = poll_new_with_mode (mode, FALSE);
+
+  for (i = 0; i < N_SOCKET_PAIRS; i++) {
+    gint socks[2];
+
+    fail_if (socketpair (PF_UNIX, SOCK_STREAM, 0, socks) < 0,
+        "Could not create a socket pair");
+    gst_poll_fd_init (&fds[i]);
+    fds[i].fd = socks[0];
+    peers[i] = socks[1];
+
+    fail_unless (gst_poll_add_fd (set, &fds[i]), "Could not add descriptor");
+    fail_unless (gst_poll_fd_ctl_read (set, &fds[i], TRUE),
+        "Could not mark the descriptor as readable");
+  }
+
+  fail_unless (gst_poll_wait (set, 0) == 0, "Nothing should be available");
+
+  for (i = 0; i < N_SOCKET_PAIRS; i += 3) {
+    fail_unless (write (peers[i], &c, 1) == 1, "write() failed");
+    n_written++;
+  }
+
+  fail_unless_equals_int (gst_poll_wait (set, GST_CLOCK_TIME_NONE),
+      n_written);
+  for (i = 0; i < N_SOCKET_PAIRS; i++) {
+    fail_unless_equals_int (gst_poll_fd_can_read (set, &fds[i]), i % 3 == 0);
+    fail_if (gst_poll_fd_has_closed (set, &fds[i]));
+  }
+
+  /* drop the readable ones, the others are still quiet */
+  for (i = 0; i < N_SOCKET_PAIRS; i += 3)
+    fail_unless (gst_poll_remove_fd (set, &fds[i]),
+        "Could not remove descriptor");
+  fail_unless (gst_poll_wait (set, 0) == 0, "Nothing should be available");
+
+  /* closing the peer is reported as readable and closed */
+  close (peers[1]);
+  peers[1] = -1;
+  fail_unless_equals_int (gst_poll_wait (set, GST_CLOCK_TIME_NONE), 1);
+  fail_unless (gst_poll_fd_can_read (set, &fds[1]));
+
+  gst_poll_free (set);
+  for (i = 0; i < N_SOCKET_PAIRS; i++) {
+    close (fds[i].fd);
+    if (peers[i] != -1)
+      close (peers[i]);
+  }
+}
+
+GST_START_TEST (test_poll_modes_many_fds)
+{
+  check_poll_many_fds ("poll");
+  check_poll_many_fds ("epoll");
+  check_poll_many_fds (NULL);
+}
+
+GST_END_TEST;
+
+static gpointer
+delayed_write (gpointer data)
+{
+  gint fd = GPOINTER_TO_INT (data);
+  guchar c = 'A';
+
+  THREAD_START ();
+
+  g_usleep (500000);
+  fail_unless (write (fd, &c, 1) == 1, "write() failed");
+
+  return NULL;
+}
+
+static void
+check_poll_control (const gchar * mode)
+{
+  GstPoll *set;
+  GstPollFD rfd = GST_POLL_FD_INIT;
+  gint socks[2];
+
+  set = poll_new_with_mode (mode, TRUE);
+
+  fail_if (socketpair (PF_UNIX, SOCK_STREAM, 0, socks) < 0,
+      "Could not create a socket pair");
+  rfd.fd = socks[0];
+  fail_unless (gst_poll_add_fd (set, &rfd), "Could not add read descriptor");
+  fail_unless (gst_poll_fd_ctl_read (set, &rfd, TRUE),
+      "Could not mark the descriptor as readable");
+
+  /* an fd that becomes ready while waiting wakes up the set */
+  MAIN_START_THREADS (1, delayed_write, GINT_TO_POINTER (socks[1]));
+  fail_unless (gst_poll_wait (set, 5 * GST_SECOND) == 1,
+      "One descriptor should be available");
+  fail_unless (gst_poll_fd_can_read (set, &rfd),
+      "Read descriptor should be readable");
+  MAIN_STOP_THREADS ();
+
+  /* the control fd is never reported as one of our fds */
+  fail_unless (gst_poll_fd_ctl_read (set, &rfd, FALSE),
+      "Could not unmark the descriptor as readable");
+  MAIN_START_THREADS (1, delayed_flush, set);
+  fail_unless (gst_poll_wait (set, 5 * GST_SECOND) == -1 && errno == EBUSY,
+      "Waiting was not flushed");
+  MAIN_STOP_THREADS ();
+
+  gst_poll_set_flushing (set, FALSE);
+  fail_unless (gst_poll_write_control (set), "Could not write control");
+  fail_unless (gst_poll_read_control (set), "Could not read control");
+  fail_unless (gst_poll_wait (set, 0) == 0, "Nothing should be available");
+
+  gst_poll_free (set);
+  close (socks[0]);
+  close (socks[1]);
+}
+
+GST_START_TEST (test_poll_modes_control)
+{
+  check_poll_control ("poll");
+  check_poll_control ("epoll");
+}
+
+GST_END_TEST;
+#endif
+
 static Suite *
 gst_poll_suite (void)
 {
@@ -343,6 +577,9 @@ gst_poll_suite (void)
   tcase_add_test (tc_chain, test_poll_wait_restart);
   tcase_add_test (tc_chain, test_poll_wait_flush);
   tcase_add_test (tc_chain, test_poll_controllable);
+  tcase_add_test (tc_chain, test_poll_modes_read_write);
+  tcase_add_test (tc_chain, test_poll_modes_many_fds);
+  tcase_add_test (tc_chain, test_poll_modes_control);
 #else
   tcase_skip_broken_test (tc_chain, test_poll_basic);
 #ifdef HAVE_PIPE
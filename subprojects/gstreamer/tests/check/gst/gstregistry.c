@@ -23,6 +23,7 @@
 #endif
 
 #include <gst/check/gstcheck.h>
+#include <glib/gstdio.h>
 #include <string.h>
 
 static gint
@@ -203,6 +204,196 @@ GST_START_TEST (test_registry_update)
 
 GST_END_TEST;
 
+/* helper processes of test_registry_cache, each of them initializes
+ * GStreamer with the registry written by the previous one */
+#define CACHE_TEST_STEP_ENV "GST_REGISTRY_CACHE_TEST_STEP"
+
+static const gchar *test_binary;
+
+static gboolean
+check_cached_fakesrc (void)
+{
+  GstElementFactory *factory;
+  const GList *l;
+  gboolean ok = TRUE, found = FALSE;
+
+  factory = gst_element_factory_find ("fakesrc");
+  if (factory == NULL) {
+    g_printerr ("no fakesrc factory\n");
+    return FALSE;
+  }
+
+  /* deserialized now when loaded from the registry cache */
+  if (g_strcmp0 (gst_element_factory_get_metadata (factory,
+              GST_ELEMENT_METADATA_LONGNAME), "Fake Source") != 0 ||
+      gst_element_factory_get_metadata (factory,
+          GST_ELEMENT_METADATA_KLASS) == NULL) {
+    g_printerr ("wrong fakesrc metadata\n");
+    ok = FALSE;
+  }
+
+  for (l = gst_element_factory_get_static_pad_templates (factory); l;
+      l = l->next) {
+    GstStaticPadTemplate *templ = l->data;
+    GstCaps *caps;
+
+    if (templ->direction != GST_PAD_SRC)
+      continue;
+    found = TRUE;
+
+    caps = gst_static_pad_template_get_caps (templ);
+    if (g_strcmp0 (templ->name_template, "src") != 0 ||
+        !gst_caps_is_any (caps)) {
+      g_printerr ("wrong fakesrc pad template\n");
+      ok = FALSE;
+    }
+    gst_caps_unref (caps);
+  }
+  if (!found) {
+    g_printerr ("no fakesrc pad template\n");
+    ok = FALSE;
+  }
+
+  gst_object_unref (factory);
+
+  return ok;
+}
+
+static void
+write_bogus_plugin (const gchar * dir, const gchar * name)
+{
+  gchar *basename, *filename;
+
+  /* can't be loaded, the registry remembers it as blacklisted and has to be
+   * written again */
+  basename = g_strdup_printf ("libgst%s.%s", name, G_MODULE_SUFFIX);
+  filename = g_build_filename (dir, basename, NULL);
+  g_file_set_contents (filename, "not a plugin", -1, NULL);
+  g_free (filename);
+  g_free (basename);
+}
+
+static int
+run_cache_test_step (int argc, char **argv, const gchar * step)
+{
+  gboolean ok = TRUE;
+
+  gst_init (&argc, &argv);
+
+  if (strcmp (step, "reload") == 0) {
+    /* loaded lazily, query and then write everything again */
+    ok = check_cached_fakesrc ();
+    write_bogus_plugin (g_getenv ("GST_REGISTRY_CACHE_TEST_DIR"), "bogus2");
+    if (!gst_update_registry ()) {
+      g_printerr ("could not update the registry\n");
+      ok = FALSE;
+    }
+  } else if (strcmp (step, "write") != 0) {
+    ok = check_cached_fakesrc ();
+  }
+
+  gst_deinit ();
+
+  return ok ? 0 : 1;
+}
+
+static void
+run_cache_test_process (const gchar * step, gchar ** env)
+{
+  gchar *argv[] = { (gchar *) test_binary, NULL };
+  GError *err = NULL;
+  gchar **envp;
+  gint status;
+
+  envp = g_environ_setenv (g_strdupv (env), CACHE_TEST_STEP_ENV, step, TRUE);
+
+  fail_unless (g_spawn_sync (NULL, argv, envp, G_SPAWN_SEARCH_PATH, NULL,
+          NULL, NULL, NULL, &status, &err), "could not run step %s: %s", step,
+      err ? err->message : "");
+  g_strfreev (envp);
+#if GLIB_CHECK_VERSION(2,70,0)
+  fail_unless (g_spawn_check_wait_status (status, &err),
+      "step %s failed: %s", step, err ? err->message : "");
+#else
+  fail_unless (g_spawn_check_exit_status (status, &err),
+      "step %s failed: %s", step, err ? err->message : "");
+#endif
+}
+
+GST_START_TEST (test_registry_cache)
+{
+  GstPlugin *plugin;
+  gchar *tmpdir, *plugindir, *coredir, *registry_file, *plugin_path;
+  gchar **envp;
+
+  plugin = gst_registry_find_plugin (gst_registry_get (), "coreelements");
+  fail_unless (plugin != NULL);
+  fail_unless (gst_plugin_get_filename (plugin) != NULL);
+
+  tmpdir = g_dir_make_tmp ("gst-registry-cache-XXXXXX", NULL);
+  fail_unless (tmpdir != NULL);
+  plugindir = g_build_filename (tmpdir, "plugins", NULL);
+  fail_unless (g_mkdir (plugindir, 0755) == 0);
+  registry_file = g_build_filename (tmpdir, "registry.bin", NULL);
+
+  /* the core elements plugin and a directory we can add files to */
+  coredir = g_path_get_dirname (gst_plugin_get_filename (plugin));
+  plugin_path = g_strjoin (G_SEARCHPATH_SEPARATOR_S, coredir, plugindir, NULL);
+  gst_object_unref (plugin);
+
+  envp = g_get_environ ();
+  envp = g_environ_setenv (envp, "GST_REGISTRY", registry_file, TRUE);
+  envp = g_environ_setenv (envp, "GST_REGISTRY_1_0", registry_file, TRUE);
+  envp = g_environ_setenv (envp, "GST_PLUGIN_PATH_1_0", plugin_path, TRUE);
+  envp = g_environ_setenv (envp, "GST_PLUGIN_SYSTEM_PATH_1_0", "", TRUE);
+  envp = g_environ_setenv (envp, "GST_REGISTRY_CACHE_TEST_DIR", plugindir,
+      TRUE);
+  envp = g_environ_unsetenv (envp, "GST_PLUGIN_PATH");
+  envp = g_environ_unsetenv (envp, "GST_REGISTRY_UPDATE");
+
+  /* scans the plugins and writes the registry */
+  run_cache_test_process ("write", envp);
+  fail_unless (g_file_test (registry_file, G_FILE_TEST_EXISTS));
+
+  /* loads the features lazily and writes them again without ever needing
+   * their metadata, because of the new file */
+  write_bogus_plugin (plugindir, "bogus1");
+  run_cache_test_process ("check", envp);
+
+  /* loads what was written without deserializing, deserializes it and
+   * writes it again */
+  run_cache_test_process ("reload", envp);
+
+  /* loads what was written after deserializing */
+  run_cache_test_process ("check", envp);
+
+  {
+    const gchar *name;
+    GDir *dir;
+
+    dir = g_dir_open (plugindir, 0, NULL);
+    fail_unless (dir != NULL);
+    while ((name = g_dir_read_name (dir))) {
+      gchar *filename = g_build_filename (plugindir, name, NULL);
+      g_unlink (filename);
+      g_free (filename);
+    }
+    g_dir_close (dir);
+  }
+  g_rmdir (plugindir);
+  g_unlink (registry_file);
+  g_rmdir (tmpdir);
+
+  g_strfreev (envp);
+  g_free (plugin_path);
+  g_free (coredir);
+  g_free (registry_file);
+  g_free (plugindir);
+  g_free (tmpdir);
+}
+
+GST_END_TEST;
+
 static Suite *
 registry_suite (void)
 {
@@ -212,8 +403,25 @@ registry_suite (void)
   suite_add_tcase (s, tc_chain);
 
   tcase_add_test (tc_chain, test_registry_update);
+  tcase_add_test (tc_chain, test_registry_cache);
 
   return s;
 }
 
-GST_CHECK_MAIN (registry);
+int
+main (int argc, char **argv)
+{
+  const gchar *step;
+  Suite *s;
+
+  step = g_getenv (CACHE_TEST_STEP_ENV);
+  if (step != NULL)
+    return run_cache_test_step (argc, argv, step);
+
+  test_binary = argv[0];
+
+  gst_check_init (&argc, &argv);
+  s = registry_suite ();
+
+  return gst_check_run_suite (s, "registry", __FILE__);
+}
@@ -0,0 +1,122 @@
+/* GStreamer
+ *
+ * unit test for the per-thread slab of buffers and system memory
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#include "../../gst/gst_private.h"
+
+#include <gst/check/gstcheck.h>
+
+#define N_BUFFERS 500
+
+GST_START_TEST (test_slab_reuse)
+{
+  GstSlabStats before, after;
+  GstBuffer *buf;
+  GstMapInfo map;
+  gint i;
+
+  fail_unless (_gst_slab_get_stats (&before));
+
+  for (i = 0; i < 100; i++) {
+    buf = gst_buffer_new_allocate (NULL, 100, NULL);
+    fail_unless (gst_buffer_map (buf, &map, GST_MAP_WRITE));
+    memset (map.data, i, map.size);
+    gst_buffer_unmap (buf, &map);
+    gst_buffer_unref (buf);
+  }
+
+  fail_unless (_gst_slab_get_stats (&after));
+  /* one buffer and one memory per iteration, only the first ones can come
+   * from the system */
+  fail_unless (after.cached_allocs - before.cached_allocs >= 2 * 99);
+  fail_unless (after.system_allocs - before.system_allocs <= 2);
+}
+
+GST_END_TEST;
+
+static gpointer
+alloc_buffers (gpointer data)
+{
+  GstBuffer **bufs = data;
+  gint i;
+
+  for (i = 0; i < N_BUFFERS; i++)
+    bufs[i] = gst_buffer_new_allocate (NULL, 1400, NULL);
+
+  return NULL;
+}
+
+GST_START_TEST (test_slab_cross_thread)
+{
+  GstBuffer *bufs[N_BUFFERS];
+  GstSlabStats before, after;
+  GThread *thread;
+  gint i;
+
+  fail_unless (_gst_slab_get_stats (&before));
+
+  /* allocated in one thread, freed in this one */
+  thread = g_thread_new ("alloc", alloc_buffers, bufs);
+  g_thread_join (thread);
+  for (i = 0; i < N_BUFFERS; i++)
+    gst_buffer_unref (bufs[i]);
+
+  fail_unless (_gst_slab_get_stats (&after));
+  fail_unless (after.flushes > before.flushes);
+
+  /* a new thread picks up what we freed */
+  before = after;
+  thread = g_thread_new ("alloc", alloc_buffers, bufs);
+  g_thread_join (thread);
+
+  fail_unless (_gst_slab_get_stats (&after));
+  fail_unless (after.refills > before.refills);
+
+  for (i = 0; i < N_BUFFERS; i++) {
+    fail_unless_equals_int (gst_buffer_get_size (bufs[i]), 1400);
+    gst_buffer_unref (bufs[i]);
+  }
+}
+
+GST_END_TEST;
+
+static Suite *
+gst_slab_suite (void)
+{
+  Suite *s = suite_create ("GstSlab");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_slab_reuse);
+  tcase_add_test (tc_chain, test_slab_cross_thread);
+
+  return s;
+}
+
+int
+main (int argc, char **argv)
+{
+  Suite *s;
+
+  /* must be set before the slab is initialized */
+  g_setenv ("GST_SLAB_ALLOC", "1", TRUE);
+
+  gst_check_init (&argc, &argv);
+  s = gst_slab_suite ();
+  return gst_check_run_suite (s, "gstslab", __FILE__);
+}
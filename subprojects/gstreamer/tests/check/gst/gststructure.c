@@ -1034,6 +1034,99 @@ GST_START_TEST (test_flags)
 
 GST_END_TEST;
 
+GST_START_TEST (test_many_fields)
+{
+  GstStructure *s1;
+  gchar name[16];
+  gint i, val;
+
+  /* more fields than bits in the field mask */
+  s1 = gst_structure_new_empty ("test/many");
+  for (i = 0; i < 100; i++) {
+    g_snprintf (name, sizeof (name), "field%d", i);
+    gst_structure_set (s1, name, G_TYPE_INT, i, NULL);
+  }
+  fail_unless_equals_int (gst_structure_n_fields (s1), 100);
+
+  for (i = 0; i < 100; i += 2) {
+    g_snprintf (name, sizeof (name), "field%d", i);
+    gst_structure_remove_field (s1, name);
+  }
+  fail_unless_equals_int (gst_structure_n_fields (s1), 50);
+
+  for (i = 0; i < 100; i++) {
+    g_snprintf (name, sizeof (name), "field%d", i);
+    fail_unless_equals_int (gst_structure_has_field (s1, name), i % 2 == 1);
+    if (i % 2 == 1) {
+      fail_unless (gst_structure_get_int (s1, name, &val));
+      fail_unless_equals_int (val, i);
+    }
+  }
+  fail_if (gst_structure_has_field (s1, "field100"));
+
+  /* field order is kept */
+  fail_unless_equals_string (gst_structure_nth_field_name (s1, 0), "field1");
+  fail_unless_equals_string (gst_structure_nth_field_name (s1, 49), "field99");
+
+  gst_structure_free (s1);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_intersect_fixed_fields)
+{
+  GstStructure *s1, *s2, *res;
+  const GValue *v;
+
+  s1 = gst_structure_new ("video/x-raw", "format", G_TYPE_STRING, "I420",
+      "width", G_TYPE_INT, 320, "framerate", GST_TYPE_FRACTION, 30, 1,
+      "interlaced", G_TYPE_BOOLEAN, FALSE, NULL);
+  s2 = gst_structure_new ("video/x-raw", "height", G_TYPE_INT, 240,
+      "framerate", GST_TYPE_FRACTION, 30, 1, "format", G_TYPE_STRING, "I420",
+      NULL);
+
+  fail_unless (gst_structure_can_intersect (s1, s2));
+  res = gst_structure_intersect (s1, s2);
+  fail_unless (res != NULL);
+  fail_unless_equals_int (gst_structure_n_fields (res), 5);
+  fail_unless_equals_string (gst_structure_get_string (res, "format"), "I420");
+  v = gst_structure_get_value (res, "framerate");
+  fail_unless_equals_int (gst_value_get_fraction_numerator (v), 30);
+  fail_unless_equals_int (gst_value_get_fraction_denominator (v), 1);
+  fail_unless (gst_structure_has_field_typed (res, "height", G_TYPE_INT));
+  fail_unless (gst_structure_is_subset (res, s1));
+  fail_unless (gst_structure_is_subset (res, s2));
+  fail_if (gst_structure_is_subset (s1, res));
+  gst_structure_free (res);
+
+  /* fixed values of the same type that differ */
+  gst_structure_set (s2, "framerate", GST_TYPE_FRACTION, 25, 1, NULL);
+  fail_if (gst_structure_can_intersect (s1, s2));
+  fail_unless (gst_structure_intersect (s1, s2) == NULL);
+  gst_structure_set (s2, "framerate", GST_TYPE_FRACTION, 30, 1,
+      "format", G_TYPE_STRING, "NV12", NULL);
+  fail_if (gst_structure_can_intersect (s1, s2));
+  fail_unless (gst_structure_intersect (s1, s2) == NULL);
+  gst_structure_set (s2, "format", G_TYPE_STRING, "I420",
+      "interlaced", G_TYPE_BOOLEAN, TRUE, NULL);
+  fail_if (gst_structure_can_intersect (s1, s2));
+  fail_if (gst_structure_is_subset (s1, s2));
+
+  /* and against a range, which takes the generic path */
+  gst_structure_remove_field (s2, "interlaced");
+  gst_structure_set (s2, "width", GST_TYPE_INT_RANGE, 1, 640, NULL);
+  fail_unless (gst_structure_can_intersect (s1, s2));
+  res = gst_structure_intersect (s1, s2);
+  fail_unless (res != NULL);
+  fail_unless (gst_structure_has_field_typed (res, "width", G_TYPE_INT));
+  gst_structure_free (res);
+
+  gst_structure_free (s1);
+  gst_structure_free (s2);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_structure_suite (void)
 {
@@ -1067,6 +1160,8 @@ gst_structure_suite (void)
   tcase_add_test (tc_chain, test_filter_and_map_in_place);
   tcase_add_test (tc_chain, test_flagset);
   tcase_add_test (tc_chain, test_flags);
+  tcase_add_test (tc_chain, test_many_fields);
+  tcase_add_test (tc_chain, test_intersect_fixed_fields);
   return s;
 }
 
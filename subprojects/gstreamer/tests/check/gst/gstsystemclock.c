@@ -197,6 +197,77 @@ GST_START_TEST (test_async_full)
 
 GST_END_TEST;
 
+#define N_ASYNC_ENTRIES 200
+
+typedef struct
+{
+  GMutex lock;
+  GCond cond;
+  GstClockTime last;
+  guint fired;
+  gboolean out_of_order;
+} AsyncOrderData;
+
+static gboolean
+async_order_callback (GstClock * clock, GstClockTime time, GstClockID id,
+    gpointer user_data)
+{
+  AsyncOrderData *d = user_data;
+
+  g_mutex_lock (&d->lock);
+  if (time < d->last)
+    d->out_of_order = TRUE;
+  d->last = time;
+  d->fired++;
+  g_cond_signal (&d->cond);
+  g_mutex_unlock (&d->lock);
+
+  return TRUE;
+}
+
+GST_START_TEST (test_async_order)
+{
+  GstClockID ids[N_ASYNC_ENTRIES];
+  GstClockTime base;
+  AsyncOrderData d = { 0, };
+  GstClock *clock;
+  guint i;
+
+  clock = gst_system_clock_obtain ();
+  g_mutex_init (&d.lock);
+  g_cond_init (&d.cond);
+
+  /* scheduled in random order, every other one is unscheduled before it is
+   * due */
+  base = gst_clock_get_time (clock) + 50 * GST_MSECOND;
+  for (i = 0; i < N_ASYNC_ENTRIES; i++) {
+    ids[i] = gst_clock_new_single_shot_id (clock,
+        base + g_random_int_range (0, 50) * GST_MSECOND);
+    fail_unless (gst_clock_id_wait_async (ids[i], async_order_callback, &d,
+            NULL) == GST_CLOCK_OK);
+  }
+  for (i = 0; i < N_ASYNC_ENTRIES; i += 2)
+    gst_clock_id_unschedule (ids[i]);
+
+  g_mutex_lock (&d.lock);
+  while (d.fired < N_ASYNC_ENTRIES / 2)
+    g_cond_wait (&d.cond, &d.lock);
+  g_mutex_unlock (&d.lock);
+
+  /* nothing else fires */
+  g_usleep (150 * 1000);
+  fail_unless_equals_int (d.fired, N_ASYNC_ENTRIES / 2);
+  fail_if (d.out_of_order);
+
+  for (i = 0; i < N_ASYNC_ENTRIES; i++)
+    gst_clock_id_unref (ids[i]);
+  g_mutex_clear (&d.lock);
+  g_cond_clear (&d.cond);
+  gst_object_unref (clock);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_resolution)
 {
   GstClock *clock;
@@ -396,6 +467,7 @@ gst_systemclock_suite (void)
   tcase_add_test (tc_chain, test_signedness);
   tcase_add_test (tc_chain, test_diff);
   tcase_add_test (tc_chain, test_async_full);
+  tcase_add_test (tc_chain, test_async_order);
   tcase_add_test (tc_chain, test_set_default);
   tcase_add_test (tc_chain, test_resolution);
   tcase_add_test (tc_chain, test_stress_cleanup_unschedule);
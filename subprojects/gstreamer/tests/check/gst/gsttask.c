@@ -464,6 +464,78 @@ GST_START_TEST (test_shared_task_pool_two_threads)
 
 GST_END_TEST;
 
+#define N_STEALING_TASKS 8
+
+static void
+stealing_task_func (gint * count)
+{
+  g_atomic_int_inc (count);
+}
+
+/* In this test, we run more tasks than the work-stealing pool has threads and
+ * verify that all of them make progress and can be paused, resumed and
+ * joined */
+GST_START_TEST (test_work_stealing_task_pool)
+{
+  GstTaskPool *pool;
+  GstTask *tasks[N_STEALING_TASKS];
+  GRecMutex locks[N_STEALING_TASKS];
+  gint counts[N_STEALING_TASKS] = { 0, };
+  GError *err = NULL;
+  gboolean progress;
+  gint i;
+
+  pool = gst_work_stealing_task_pool_new (2);
+  fail_unless_equals_int (gst_work_stealing_task_pool_get_n_threads
+      (GST_WORK_STEALING_TASK_POOL (pool)), 2);
+  gst_task_pool_prepare (pool, &err);
+  fail_unless (err == NULL);
+
+  for (i = 0; i < N_STEALING_TASKS; i++) {
+    g_rec_mutex_init (&locks[i]);
+    tasks[i] = gst_task_new ((GstTaskFunction) stealing_task_func, &counts[i],
+        NULL);
+    gst_task_set_lock (tasks[i], &locks[i]);
+    gst_task_set_pool (tasks[i], pool);
+    fail_unless (gst_task_start (tasks[i]));
+  }
+
+  /* all tasks must get to run, even though they never block */
+  do {
+    g_usleep (1000);
+    progress = TRUE;
+    for (i = 0; i < N_STEALING_TASKS; i++)
+      progress &= g_atomic_int_get (&counts[i]) > 100;
+  } while (!progress);
+
+  /* paused tasks don't occupy a worker, the others keep running */
+  for (i = 0; i < N_STEALING_TASKS / 2; i++)
+    fail_unless (gst_task_pause (tasks[i]));
+  for (i = N_STEALING_TASKS / 2; i < N_STEALING_TASKS; i++)
+    g_atomic_int_set (&counts[i], 0);
+  do {
+    g_usleep (1000);
+    progress = TRUE;
+    for (i = N_STEALING_TASKS / 2; i < N_STEALING_TASKS; i++)
+      progress &= g_atomic_int_get (&counts[i]) > 100;
+  } while (!progress);
+
+  for (i = 0; i < N_STEALING_TASKS / 2; i++)
+    fail_unless (gst_task_resume (tasks[i]));
+
+  for (i = 0; i < N_STEALING_TASKS; i++) {
+    fail_unless (gst_task_stop (tasks[i]));
+    fail_unless (gst_task_join (tasks[i]));
+    gst_object_unref (tasks[i]);
+    g_rec_mutex_clear (&locks[i]);
+  }
+
+  gst_task_pool_cleanup (pool);
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_task_suite (void)
 {
@@ -480,6 +552,7 @@ gst_task_suite (void)
   tcase_add_test (tc_chain, test_resume);
   tcase_add_test (tc_chain, test_shared_task_pool_shared_thread);
   tcase_add_test (tc_chain, test_shared_task_pool_two_threads);
+  tcase_add_test (tc_chain, test_work_stealing_task_pool);
 
   return s;
 }
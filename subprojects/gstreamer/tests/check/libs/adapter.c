@@ -1168,6 +1168,73 @@ GST_START_TEST (test_scan)
 
 GST_END_TEST;
 
+static gssize
+scan_bytes (const guint8 * data, gsize size, guint32 mask, guint32 pattern)
+{
+  gsize i;
+
+  for (i = 0; i + 4 <= size; i++) {
+    if ((GST_READ_UINT32_BE (data + i) & mask) == pattern)
+      return i;
+  }
+  return -1;
+}
+
+/* matches inside buffers and across buffer boundaries */
+GST_START_TEST (test_scan_buffers)
+{
+  GstAdapter *adapter;
+  guint8 data[600];
+  gsize i, j, pos, offset, size;
+  GRand *rand;
+
+  rand = g_rand_new_with_seed (1);
+  adapter = gst_adapter_new ();
+
+  for (i = 0; i < 500; i++) {
+    gssize expected, found;
+    guint32 val;
+
+    for (j = 0; j < sizeof (data); j++)
+      data[j] = g_rand_int_range (rand, 0, 4) ? g_rand_int_range (rand, 0,
+          2) : g_rand_int (rand);
+
+    /* split into buffers of random size */
+    for (pos = 0; pos < sizeof (data); pos += size) {
+      size = MIN (g_rand_int_range (rand, 1, 100), sizeof (data) - pos);
+      gst_adapter_push (adapter, gst_buffer_new_memdup (data + pos, size));
+    }
+
+    for (j = 0; j < 10; j++) {
+      offset = g_rand_int_range (rand, 0, 200);
+      size = g_rand_int_range (rand, 1, sizeof (data) - offset);
+
+      expected = scan_bytes (data + offset, size, 0xffffff00, 0x00000100);
+      if (expected >= 0)
+        expected += offset;
+      found = gst_adapter_masked_scan_uint32_peek (adapter, 0xffffff00,
+          0x00000100, offset, size, &val);
+      fail_unless_equals_int (found, expected);
+      if (expected >= 0)
+        fail_unless_equals_int (val, GST_READ_UINT32_BE (data + expected));
+
+      expected = scan_bytes (data + offset, size, 0xff00ff00, 0x01000100);
+      if (expected >= 0)
+        expected += offset;
+      found = gst_adapter_masked_scan_uint32 (adapter, 0xff00ff00,
+          0x01000100, offset, size);
+      fail_unless_equals_int (found, expected);
+    }
+
+    gst_adapter_clear (adapter);
+  }
+
+  g_object_unref (adapter);
+  g_rand_free (rand);
+}
+
+GST_END_TEST;
+
 /* Fill a buffer with a sequence of 32 bit ints and read them back out
  * using take_buffer, checking that they're still in the right order */
 GST_START_TEST (test_take_list)
@@ -1465,6 +1532,7 @@ gst_adapter_suite (void)
   tcase_add_test (tc_chain, test_take_buf_order);
   tcase_add_test (tc_chain, test_timestamp);
   tcase_add_test (tc_chain, test_scan);
+  tcase_add_test (tc_chain, test_scan_buffers);
   tcase_add_test (tc_chain, test_take_list);
   tcase_add_test (tc_chain, test_get_list);
   tcase_add_test (tc_chain, test_take_buffer_list);
@@ -1381,6 +1381,168 @@ GST_START_TEST (test_force_live)
 
 GST_END_TEST;
 
+typedef struct
+{
+  GMutex lock;
+  GCond cond;
+  GHashTable *pads;
+  GPtrArray *threads;
+  GstPad *fail_pad;
+  gint running, max_running;
+  gint wait_for;                /* calls that have to run at the same time */
+} ParallelData;
+
+static gboolean
+parallel_pad_func (GstElement * element, GstPad * pad, gpointer user_data)
+{
+  ParallelData *data = user_data;
+  GThread *self = g_thread_self ();
+  gint64 end_time;
+
+  g_mutex_lock (&data->lock);
+  fail_if (g_hash_table_contains (data->pads, pad));
+  g_hash_table_add (data->pads, pad);
+  if (!g_ptr_array_find (data->threads, self, NULL))
+    g_ptr_array_add (data->threads, self);
+
+  data->running++;
+  data->max_running = MAX (data->max_running, data->running);
+  g_cond_broadcast (&data->cond);
+
+  /* gives up after a while so that serial calls fail the test instead of
+   * blocking it */
+  end_time = g_get_monotonic_time () + 5 * G_TIME_SPAN_SECOND;
+  while (data->max_running < data->wait_for) {
+    if (!g_cond_wait_until (&data->cond, &data->lock, end_time))
+      break;
+  }
+  data->running--;
+  g_mutex_unlock (&data->lock);
+
+  return pad != data->fail_pad;
+}
+
+GST_START_TEST (test_foreach_sink_pad_parallel)
+{
+  GstElement *agg;
+  GstPad *pads[8];
+  ParallelData data;
+  guint i;
+
+  agg = gst_check_setup_element ("testaggregator");
+  g_mutex_init (&data.lock);
+  g_cond_init (&data.cond);
+  data.pads = g_hash_table_new (NULL, NULL);
+  data.threads = g_ptr_array_new ();
+  data.fail_pad = NULL;
+  data.running = data.max_running = 0;
+  data.wait_for = 0;
+
+  /* no sink pads */
+  fail_if (gst_aggregator_foreach_sink_pad_parallel (GST_AGGREGATOR (agg),
+          parallel_pad_func, &data));
+
+  for (i = 0; i < G_N_ELEMENTS (pads); i++)
+    pads[i] = gst_element_request_pad_simple (agg, "sink_%u");
+
+  /* serial by default */
+  fail_unless (gst_aggregator_foreach_sink_pad_parallel (GST_AGGREGATOR (agg),
+          parallel_pad_func, &data));
+  fail_unless_equals_int (g_hash_table_size (data.pads), G_N_ELEMENTS (pads));
+  fail_unless_equals_int (data.threads->len, 1);
+  fail_unless_equals_int (data.max_running, 1);
+
+  g_hash_table_remove_all (data.pads);
+  g_ptr_array_set_size (data.threads, 0);
+  data.max_running = 0;
+
+  /* the pads are handled at the same time, and every pad is still handled
+   * once when one of them fails */
+  g_object_set (agg, "max-pad-threads", 4, NULL);
+  data.fail_pad = pads[3];
+  data.wait_for = 2;
+  fail_if (gst_aggregator_foreach_sink_pad_parallel (GST_AGGREGATOR (agg),
+          parallel_pad_func, &data));
+  fail_unless_equals_int (g_hash_table_size (data.pads), G_N_ELEMENTS (pads));
+  fail_unless (data.max_running >= 2);
+  fail_unless (data.max_running <= 4);
+  fail_unless (data.threads->len >= 2);
+  fail_unless (data.threads->len <= 4);
+
+  for (i = 0; i < G_N_ELEMENTS (pads); i++) {
+    gst_element_release_request_pad (agg, pads[i]);
+    gst_object_unref (pads[i]);
+  }
+
+  g_ptr_array_unref (data.threads);
+  g_hash_table_unref (data.pads);
+  g_cond_clear (&data.cond);
+  g_mutex_clear (&data.lock);
+  gst_object_unref (agg);
+}
+
+GST_END_TEST;
+
+#ifndef GST_DISABLE_GST_DEBUG
+static gint fast_path_checks;
+
+static void
+count_fast_path_log_func (GstDebugCategory * category, GstDebugLevel level,
+    const gchar * file, const gchar * function, gint line, GObject * object,
+    GstDebugMessage * message, gpointer user_data)
+{
+  if (g_str_has_suffix (gst_debug_message_get (message),
+          " pads have no buffer and are not EOS yet"))
+    g_atomic_int_inc (&fast_path_checks);
+}
+
+GST_START_TEST (test_pads_ready_fast_path)
+{
+  ChainData data1 = { 0, };
+  ChainData data2 = { 0, };
+  TestData test = { 0, };
+  gint64 end_time;
+
+  g_atomic_int_set (&fast_path_checks, 0);
+  gst_debug_remove_log_function (gst_debug_log_default);
+  gst_debug_add_log_function (count_fast_path_log_func, NULL, NULL);
+  gst_debug_set_threshold_for_name ("aggregator", GST_LEVEL_LOG);
+
+  _test_data_init (&test, TRUE);
+  _chain_data_init (&data1, test.aggregator, NULL);
+  _chain_data_init (&data2, test.aggregator, NULL);
+
+  /* the src pad task handles the events, walking and counting all the
+   * pads. Once they are all counted, none of them has data and no events
+   * are left, it knows that it has to wait without walking them again. */
+  start_flow (&data1);
+  start_flow (&data2);
+
+  end_time = g_get_monotonic_time () + 5 * G_TIME_SPAN_SECOND;
+  while (g_atomic_int_get (&fast_path_checks) == 0
+      && g_get_monotonic_time () < end_time) {
+    /* makes the task check the pads again after handling it */
+    fail_unless (gst_pad_push_event (data1.srcpad,
+            gst_event_new_custom (GST_EVENT_CUSTOM_DOWNSTREAM,
+                gst_structure_new_empty ("test"))));
+    g_usleep (G_USEC_PER_SEC / 100);
+  }
+  fail_unless (g_atomic_int_get (&fast_path_checks) > 0);
+
+  g_source_remove (test.timeout_id);
+
+  gst_debug_unset_threshold_for_name ("aggregator");
+  gst_debug_add_log_function (gst_debug_log_default, NULL, NULL);
+  gst_debug_remove_log_function (count_fast_path_log_func);
+
+  _chain_data_clear (&data1);
+  _chain_data_clear (&data2);
+  _test_data_clear (&test);
+}
+
+GST_END_TEST;
+#endif /* !GST_DISABLE_GST_DEBUG */
+
 static Suite *
 gst_aggregator_suite (void)
 {
@@ -1411,6 +1573,10 @@ gst_aggregator_suite (void)
   tcase_add_test (general, test_flush_on_aggregate);
   tcase_add_test (general, test_remove_pad_on_aggregate);
   tcase_add_test (general, test_force_live);
+  tcase_add_test (general, test_foreach_sink_pad_parallel);
+#ifndef GST_DISABLE_GST_DEBUG
+  tcase_add_test (general, test_pads_ready_fast_path);
+#endif
 
   return suite;
 }
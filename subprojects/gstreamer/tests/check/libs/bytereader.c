@@ -608,6 +608,67 @@ GST_START_TEST (test_scan)
 
 GST_END_TEST;
 
+static const guint32 scan_masks[][2] = {
+  {0xffffff00, 0x00000100},
+  {0xffffffff, 0x000001b3},
+  {0xffff0000, 0x00010000},
+  {0x0000ffff, 0x00000001},
+  {0xff00ff00, 0x01000100},
+  {0x0f0f0f0f, 0x00000101},
+};
+
+static gint
+scan_bytes (const guint8 * data, guint size, guint32 mask, guint32 pattern)
+{
+  guint i;
+
+  for (i = 0; i + 4 <= size; i++) {
+    if ((GST_READ_UINT32_BE (data + i) & mask) == pattern)
+      return i;
+  }
+  return -1;
+}
+
+/* longer data takes the vectorized code paths */
+GST_START_TEST (test_scan_long)
+{
+  GstByteReader reader;
+  guint8 data[300];
+  guint i, j, offset, size;
+  GRand *rand;
+
+  rand = g_rand_new_with_seed (1);
+
+  for (i = 0; i < 2000; i++) {
+    /* mostly 0 and 1, so that there are many partial matches */
+    for (j = 0; j < sizeof (data); j++)
+      data[j] = g_rand_int_range (rand, 0, 4) ? g_rand_int_range (rand, 0,
+          2) : g_rand_int (rand);
+
+    offset = g_rand_int_range (rand, 0, 100);
+    size = g_rand_int_range (rand, 1, sizeof (data) - offset);
+    gst_byte_reader_init (&reader, data, sizeof (data));
+
+    for (j = 0; j < G_N_ELEMENTS (scan_masks); j++) {
+      gint expected = scan_bytes (data + offset, size, scan_masks[j][0],
+          scan_masks[j][1]);
+      guint32 val;
+
+      if (expected >= 0)
+        expected += offset;
+      fail_unless_equals_int (gst_byte_reader_masked_scan_uint32_peek (&reader,
+              scan_masks[j][0], scan_masks[j][1], offset, size, &val),
+          expected);
+      if (expected >= 0)
+        fail_unless_equals_int (val, GST_READ_UINT32_BE (data + expected));
+    }
+  }
+
+  g_rand_free (rand);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_string_funcs)
 {
   GstByteReader reader, backup;
@@ -836,6 +897,7 @@ gst_byte_reader_suite (void)
   tcase_add_test (tc_chain, test_get_float_be);
   tcase_add_test (tc_chain, test_position_tracking);
   tcase_add_test (tc_chain, test_scan);
+  tcase_add_test (tc_chain, test_scan_long);
   tcase_add_test (tc_chain, test_string_funcs);
   tcase_add_test (tc_chain, test_dup_string);
   tcase_add_test (tc_chain, test_sub_reader);
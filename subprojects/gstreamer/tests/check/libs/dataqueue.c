@@ -0,0 +1,176 @@
+/* GStreamer
+ *
+ * unit test for GstDataQueue
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/check/gstcheck.h>
+#include <gst/base/gstdataqueue.h>
+
+#define N_ITEMS 20000
+
+static gboolean
+check_one_item (GstDataQueue * queue, guint visible, guint bytes,
+    guint64 time, gpointer checkdata)
+{
+  return visible >= 1;
+}
+
+static void
+free_item (GstDataQueueItem * item)
+{
+  gst_mini_object_unref (item->object);
+  g_free (item);
+}
+
+static GstDataQueueItem *
+new_item (GstMiniObject * object)
+{
+  GstDataQueueItem *item = g_new0 (GstDataQueueItem, 1);
+
+  item->object = object;
+  item->size = 4;
+  item->visible = TRUE;
+  item->destroy = (GDestroyNotify) free_item;
+
+  return item;
+}
+
+static gpointer
+push_items (GstDataQueue * queue)
+{
+  GstDataQueueItem *item;
+  gint i;
+
+  for (i = 0; i < N_ITEMS; i++) {
+    item = new_item (GST_MINI_OBJECT_CAST (gst_buffer_new ()));
+    fail_unless (gst_data_queue_push (queue, item));
+  }
+
+  item = new_item (GST_MINI_OBJECT_CAST (gst_event_new_eos ()));
+  fail_unless (gst_data_queue_push (queue, item));
+
+  return NULL;
+}
+
+static gpointer
+push_until_flushing (GstDataQueue * queue)
+{
+  GstDataQueueItem *item;
+
+  for (;;) {
+    item = new_item (GST_MINI_OBJECT_CAST (gst_buffer_new ()));
+    if (!gst_data_queue_push (queue, item)) {
+      item->destroy (item);
+      break;
+    }
+  }
+
+  return NULL;
+}
+
+/* Both sides wait for each other all the time on a queue that only takes one
+ * item. A wakeup that is lost while a thread goes from spinning to waiting
+ * makes this hang. */
+static void
+check_spin_one_item (guint spin_time)
+{
+  GstDataQueue *queue;
+  GstDataQueueItem *item;
+  GThread *thread;
+  gboolean eos = FALSE;
+  gint n_buffers = 0;
+
+  queue = gst_data_queue_new (check_one_item, NULL, NULL, NULL);
+  gst_data_queue_set_spin_time (queue, spin_time);
+  fail_unless_equals_int (gst_data_queue_get_spin_time (queue), spin_time);
+
+  thread = g_thread_new ("push", (GThreadFunc) push_items, queue);
+
+  while (!eos) {
+    fail_unless (gst_data_queue_pop (queue, &item));
+    if (GST_IS_EVENT (item->object)) {
+      fail_unless_equals_int (GST_EVENT_TYPE (item->object), GST_EVENT_EOS);
+      eos = TRUE;
+    } else {
+      n_buffers++;
+    }
+    item->destroy (item);
+  }
+  g_thread_join (thread);
+
+  fail_unless_equals_int (n_buffers, N_ITEMS);
+  fail_unless (gst_data_queue_is_empty (queue));
+
+  g_object_unref (queue);
+}
+
+GST_START_TEST (test_spin_one_item)
+{
+  /* short enough that spinning often gives up just before the other side
+   * changes the queue */
+  check_spin_one_item (1);
+  check_spin_one_item (50);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_spin_flush)
+{
+  GstDataQueue *queue;
+  GstDataQueueItem *item;
+  GThread *thread;
+
+  queue = gst_data_queue_new (check_one_item, NULL, NULL, NULL);
+  gst_data_queue_set_spin_time (queue, 50);
+
+  /* the pushing thread must see the flushing while spinning or waiting */
+  thread = g_thread_new ("push", (GThreadFunc) push_until_flushing, queue);
+  fail_unless (gst_data_queue_pop (queue, &item));
+  item->destroy (item);
+  gst_data_queue_set_flushing (queue, TRUE);
+  g_thread_join (thread);
+
+  fail_if (gst_data_queue_pop (queue, &item));
+
+  gst_data_queue_flush (queue);
+  g_object_unref (queue);
+}
+
+GST_END_TEST;
+
+static Suite *
+gst_data_queue_suite (void)
+{
+  Suite *s = suite_create ("GstDataQueue");
+  TCase *tc_chain = tcase_create ("GstDataQueue tests");
+
+  tcase_set_timeout (tc_chain, 60);
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_spin_one_item);
+  tcase_add_test (tc_chain, test_spin_flush);
+
+  return s;
+}
+
+GST_CHECK_MAIN (gst_data_queue);
@@ -1774,7 +1774,7 @@ print_typefind_info (GstPluginFeature * feature, gboolean print_names)
       GST_OBJECT_NAME (factory), RESET_COLOR);
   caps = gst_type_find_factory_get_caps (factory);
   if (caps) {
-    gchar *caps_str = gst_caps_to_string (factory->caps);
+    gchar *caps_str = gst_caps_to_string (caps);
 
     n_print ("  %s%-25s%s%s%s\n", PROP_NAME_COLOR, "Caps", PROP_VALUE_COLOR,
         caps_str, RESET_COLOR);
@@ -46,6 +46,11 @@ static guint num_elements = 0, num_bins = 0, num_pads = 0, num_ghostpads = 0;
 static GstClockTime last_ts = G_GUINT64_CONSTANT (0);
 static guint total_cpuload = 0;
 static gboolean have_cpuload = FALSE;
+static guint64 slab_cached_allocs = 0, slab_system_allocs = 0;
+static guint64 slab_refills = 0, slab_flushes = 0;
+static gboolean have_slab = FALSE;
+static guint caps_cache_hits = 0, caps_cache_misses = 0;
+static gboolean have_caps_cache = FALSE;
 
 static GPtrArray *plugin_stats = NULL;
 
@@ -538,6 +543,32 @@ do_proc_rusage_stats (GstStructure * s)
   have_cpuload = TRUE;
 }
 
+static void
+do_slab_stats (GstStructure * s)
+{
+  guint64 ts;
+
+  gst_structure_get (s, "ts", G_TYPE_UINT64, &ts,
+      "cached-allocs", G_TYPE_UINT64, &slab_cached_allocs,
+      "system-allocs", G_TYPE_UINT64, &slab_system_allocs,
+      "refills", G_TYPE_UINT64, &slab_refills,
+      "flushes", G_TYPE_UINT64, &slab_flushes, NULL);
+  last_ts = MAX (last_ts, ts);
+  have_slab = TRUE;
+}
+
+static void
+do_caps_cache_stats (GstStructure * s)
+{
+  guint64 ts;
+
+  gst_structure_get (s, "ts", G_TYPE_UINT64, &ts,
+      "hits", G_TYPE_UINT, &caps_cache_hits,
+      "misses", G_TYPE_UINT, &caps_cache_misses, NULL);
+  last_ts = MAX (last_ts, ts);
+  have_caps_cache = TRUE;
+}
+
 static void
 update_latency_table (GHashTable * table, const gchar * key, guint64 time,
     GstClockTime ts)
@@ -1040,6 +1071,18 @@ print_stats (void)
   if (have_cpuload) {
     g_print ("Avg CPU load: %4.1f %%\n", (gfloat) total_cpuload / 10.0);
   }
+  if (have_slab) {
+    g_print ("Slab allocations: %" G_GUINT64_FORMAT " cached, %"
+        G_GUINT64_FORMAT " from system, %" G_GUINT64_FORMAT " refills, %"
+        G_GUINT64_FORMAT " flushes\n", slab_cached_allocs, slab_system_allocs,
+        slab_refills, slab_flushes);
+  }
+  if (have_caps_cache) {
+    g_print ("Caps cache: %u hits, %u misses (%4.1f %% hit rate)\n",
+        caps_cache_hits, caps_cache_misses,
+        100.0 * caps_cache_hits / MAX (caps_cache_hits + caps_cache_misses,
+            1));
+  }
   g_print ("\n");
 
   /* thread stats */
@@ -1215,6 +1258,10 @@ collect_stats (const gchar * filename)
                   do_thread_rusage_stats (s);
                 } else if (!strcmp (name, "proc-rusage")) {
                   do_proc_rusage_stats (s);
+                } else if (!strcmp (name, "slab")) {
+                  do_slab_stats (s);
+                } else if (!strcmp (name, "caps-cache")) {
+                  do_caps_cache_stats (s);
                 } else if (!strcmp (name, "latency")) {
                   do_latency_stats (s);
                 } else if (!strcmp (name, "element-latency")) {